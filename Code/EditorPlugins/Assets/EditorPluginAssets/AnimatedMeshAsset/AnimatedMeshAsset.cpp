@@ -9,7 +9,7 @@
 #include <RendererCore/Meshes/MeshResourceDescriptor.h>
 
 // clang-format off
-EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezAnimatedMeshAssetDocument, 5, ezRTTINoAllocator)
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezAnimatedMeshAssetDocument, 6, ezRTTINoAllocator)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
@@ -28,7 +28,7 @@ ezAnimatedMeshAssetDocument::ezAnimatedMeshAssetDocument(const char* szDocumentP
 ezStatus ezAnimatedMeshAssetDocument::InternalTransformAsset(ezStreamWriter& stream, const char* szOutputTag,
   const ezPlatformProfile* pAssetProfile, const ezAssetFileHeader& AssetHeader, ezBitflags<ezTransformFlags> transformFlags)
 {
-  ezProgressRange range("Transforming Asset", 2, false);
+  ezProgressRange range("Transforming Asset", 3, false);
 
   ezAnimatedMeshAssetProperties* pProp = GetProperties();
 
@@ -42,6 +42,9 @@ ezStatus ezAnimatedMeshAssetDocument::InternalTransformAsset(ezStreamWriter& str
 
   EZ_SUCCEED_OR_RETURN(CreateMeshFromFile(pProp, desc));
 
+  range.BeginNextStep("Optimizing Mesh");
+  ezMeshImportUtils::OptimizeMesh(desc, false);
+
   // the properties object can get invalidated by the CreateMeshFromFile() call
   pProp = GetProperties();
   range.BeginNextStep("Writing Result");
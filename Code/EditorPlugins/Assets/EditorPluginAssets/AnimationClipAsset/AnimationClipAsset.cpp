@@ -29,12 +29,14 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezAnimationClipAssetProperties, 2, ezRTTIDefault
     EZ_MEMBER_PROPERTY("RootMotionVelocity", m_vCustomRootMotion),
     EZ_MEMBER_PROPERTY("Joint1", m_sJoint1),
     EZ_MEMBER_PROPERTY("Joint2", m_sJoint2),
+    EZ_MEMBER_PROPERTY("Compress", m_bCompress),
+    EZ_MEMBER_PROPERTY("CompressionTolerance", m_fCompressionTolerance)->AddAttributes(new ezDefaultValueAttribute(0.001f), new ezClampValueAttribute(0.0f, 0.1f)),
   }
   EZ_END_PROPERTIES;
 }
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 
-EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezAnimationClipAssetDocument, 2, ezRTTINoAllocator)
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezAnimationClipAssetDocument, 3, ezRTTINoAllocator)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
@@ -132,6 +134,16 @@ ezStatus ezAnimationClipAssetDocument::InternalTransformAsset(ezStreamWriter& st
     }
   }
 
+  if (pProp->m_bCompress)
+  {
+    ezAnimationClipCompressionSettings settings;
+    settings.m_fTranslationTolerance = pProp->m_fCompressionTolerance;
+    settings.m_fScaleTolerance = pProp->m_fCompressionTolerance;
+    settings.m_fRotationTolerance = pProp->m_fCompressionTolerance * 0.5f;
+
+    anim.Compress(settings);
+  }
+
   anim.Save(stream);
 
   return ezStatus(EZ_SUCCESS);
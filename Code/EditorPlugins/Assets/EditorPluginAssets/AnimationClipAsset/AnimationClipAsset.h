@@ -37,6 +37,8 @@ public:
   ezVec3 m_vCustomRootMotion;
   ezString m_sJoint1;
   ezString m_sJoint2;
+  bool m_bCompress = false;
+  float m_fCompressionTolerance = 0.001f;
 };
 
 //////////////////////////////////////////////////////////////////////////
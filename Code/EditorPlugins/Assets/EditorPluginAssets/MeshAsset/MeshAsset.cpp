@@ -11,7 +11,7 @@
 #include <RendererCore/Meshes/MeshResourceDescriptor.h>
 
 // clang-format off
-EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMeshAssetDocument, 10, ezRTTINoAllocator)
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMeshAssetDocument, 11, ezRTTINoAllocator)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
@@ -33,7 +33,7 @@ ezMeshAssetDocument::ezMeshAssetDocument(const char* szDocumentPath)
 ezStatus ezMeshAssetDocument::InternalTransformAsset(ezStreamWriter& stream, const char* szOutputTag,
   const ezPlatformProfile* pAssetProfile, const ezAssetFileHeader& AssetHeader, ezBitflags<ezTransformFlags> transformFlags)
 {
-  ezProgressRange range("Transforming Asset", 2, false);
+  ezProgressRange range("Transforming Asset", 3, false);
 
   ezMeshAssetProperties* pProp = GetProperties();
 
@@ -51,6 +51,9 @@ ezStatus ezMeshAssetDocument::InternalTransformAsset(ezStreamWriter& stream, con
     CreateMeshFromGeom(pProp, desc);
   }
 
+  range.BeginNextStep("Optimizing Mesh");
+  ezMeshImportUtils::OptimizeMesh(desc, pProp->m_bGenerateClusters);
+
   range.BeginNextStep("Writing Result");
   desc.Save(stream);
 
@@ -32,6 +32,7 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMeshAssetProperties, 3, ezRTTIDefaultAllocator
     EZ_MEMBER_PROPERTY("Angle", m_Angle)->AddAttributes(new ezDefaultValueAttribute(ezAngle::Degree(360.0f)), new ezClampValueAttribute(ezAngle::Degree(0.0f), ezAngle::Degree(360.0f))),
     EZ_MEMBER_PROPERTY("ImportMaterials", m_bImportMaterials)->AddAttributes(new ezDefaultValueAttribute(true)),
     EZ_MEMBER_PROPERTY("UseSubfolderForMaterialImport", m_bUseSubFolderForImportedMaterials)->AddAttributes(new ezDefaultValueAttribute(true)),
+    EZ_MEMBER_PROPERTY("GenerateClusters", m_bGenerateClusters)->AddAttributes(new ezDefaultValueAttribute(false)),
     EZ_ARRAY_MEMBER_PROPERTY("Materials", m_Slots)->AddAttributes(new ezContainerAttribute(false, true, true)),
   }
   EZ_END_PROPERTIES;
@@ -96,6 +97,7 @@ ezMeshAssetProperties::ezMeshAssetProperties()
   m_bCap2 = true;
   m_Angle = ezAngle::Degree(360.0f);
   m_bImportMaterials = true;
+  m_bGenerateClusters = false;
 }
 
 
@@ -67,6 +67,7 @@ public:
 
   bool m_bImportMaterials;
   bool m_bUseSubFolderForImportedMaterials;
+  bool m_bGenerateClusters;
   ezHybridArray<ezMaterialResourceSlot, 8> m_Slots;
 
   ezUInt32 m_uiVertices;
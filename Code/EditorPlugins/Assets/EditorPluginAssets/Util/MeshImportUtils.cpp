@@ -12,6 +12,7 @@
 #include <ModelImporter/Mesh.h>
 #include <ModelImporter/ModelImporter.h>
 #include <ModelImporter/Scene.h>
+#include <RendererCore/Meshes/MeshOptimizer.h>
 #include <RendererCore/Meshes/MeshResourceDescriptor.h>
 
 namespace ezMeshImportUtils
@@ -855,4 +856,28 @@ namespace ezMeshImportUtils
 
     return ezMeshImportUtils::GenerateMeshBuffer(*out_pMesh, meshDescriptor, mMeshTransform, bInvertNormals, normalPrecision, texCoordPrecision, bSkinnedMesh);
   }
+
+  void OptimizeMesh(ezMeshResourceDescriptor& meshDescriptor, bool bGenerateClusters)
+  {
+    ezStopwatch timer;
+
+    const ezUInt32 uiNumVerticesBefore = meshDescriptor.MeshBufferDesc().GetVertexCount();
+
+    ezMeshOptimizer::Settings settings;
+    settings.m_bGenerateClusters = bGenerateClusters;
+
+    ezMeshVertexCacheStats before, after;
+    if (ezMeshOptimizer::Optimize(meshDescriptor, settings, &before, &after).Failed())
+      return;
+
+    ezLog::Success("Optimized mesh (time {0}s)", ezArgF(timer.GetRunningTotal().GetSeconds(), 2));
+    ezLog::Info("Vertex cache ACMR: {0} -> {1}, ATVR: {2} -> {3}", ezArgF(before.GetACMR(), 3), ezArgF(after.GetACMR(), 3),
+      ezArgF(before.GetATVR(), 3), ezArgF(after.GetATVR(), 3));
+    ezLog::Info("Number of Vertices: {0} -> {1}", uiNumVerticesBefore, meshDescriptor.MeshBufferDesc().GetVertexCount());
+
+    if (bGenerateClusters)
+    {
+      ezLog::Info("Number of Clusters: {0}", meshDescriptor.GetClusters().GetCount());
+    }
+  }
 } // namespace ezMeshImportUtils
@@ -45,4 +45,9 @@ namespace ezMeshImportUtils
     const char* szMeshFile, const char* szSubMeshName, const ezMat3& mMeshTransform, bool bRecalculateNormals, bool bInvertNormals,
     ezMeshNormalPrecision::Enum normalPrecision, ezMeshTexCoordPrecision::Enum texCoordPrecision, ezProgressRange& range,
     ezMeshResourceDescriptor& meshDescriptor, bool bSkinnedMesh);
+
+  /// \brief Reorders the triangles and vertices of the mesh for better vertex cache utilization, less overdraw and faster vertex fetching.
+  ///
+  /// If bGenerateClusters is set, the sub-meshes are additionally split into clusters that are culled per view at runtime.
+  EZ_EDITORPLUGINASSETS_DLL void OptimizeMesh(ezMeshResourceDescriptor& meshDescriptor, bool bGenerateClusters);
 } // namespace ezMeshImportUtils
@@ -38,6 +38,9 @@ public:
   /// \brief Returns the number of components managed by this manager.
   ezUInt32 GetComponentCount() const;
 
+  /// \brief Reserves storage for \a uiNumComponents additional components, so that creating many components at once does not reallocate.
+  void ReserveComponents(ezUInt32 uiNumComponents);
+
   /// \brief Create a new component instance and returns a handle to it.
   ezComponentHandle CreateComponent(ezGameObject* pOwnerObject);
 
@@ -77,6 +80,7 @@ protected:
 
   virtual ezComponent* CreateComponentStorage() = 0;
   virtual void DeleteComponentStorage(ezComponent* pComponent, ezComponent*& out_pMovedComponent) = 0;
+  virtual void ReserveComponentStorage(ezUInt32 uiCount) {}
 
   /// \endcond
 
@@ -117,6 +121,7 @@ protected:
 
   virtual ezComponent* CreateComponentStorage() override;
   virtual void DeleteComponentStorage(ezComponent* pComponent, ezComponent*& out_pMovedComponent) override;
+  virtual void ReserveComponentStorage(ezUInt32 uiCount) override;
 
   void RegisterUpdateFunction(UpdateFunctionDesc& desc);
 
@@ -434,6 +434,7 @@ public:
   void SetTeamID(ezUInt16 id);
 
 private:
+  friend class ezComponent;
   friend class ezComponentManagerBase;
   friend class ezGameObjectTest;
 
@@ -468,6 +469,13 @@ private:
   void RemoveComponent(ezComponent* pComponent);
   void FixComponentPointer(ezComponent* pOldPtr, ezComponent* pNewPtr);
 
+  static ezUInt64 GetMessageHandlerMaskBit(const ezMessage& msg);
+  static ezUInt64 GetMessageHandlerMask(const ezComponent* pComponent);
+
+  // Recomputes the message handler mask from all attached components and adds it to the sub-tree masks of this object and its parents.
+  void UpdateMessageHandlerMask();
+  void AddSubTreeMessageHandlerMask(ezUInt64 uiMask);
+
   // Updates the active state of this object and all children and attached components recursively, depending on the enabled states.
   void UpdateActiveState(bool bParentActive);
 
@@ -539,6 +547,14 @@ private:
 
   /// An int that will be passed on to objects spawned from this one, which allows to identify which team or player it belongs to.
   ezUInt16 m_uiTeamID = 0;
+
+  /// Bloom filter over the ids of all messages that the attached components have a handler for.
+  /// Messages whose bit is not set are not dispatched to the components at all.
+  ezUInt64 m_uiMessageHandlerMask = 0;
+
+  /// Combination of the message handler masks of this object and all its children, used to skip whole sub-trees in recursive sends.
+  /// Bits are only removed from this mask when the object is re-created, which is fine since false positives merely cost some time.
+  ezUInt64 m_uiSubTreeMessageHandlerMask = 0;
   
   TransformationData* m_pTransformationData = nullptr;
 
@@ -191,6 +191,11 @@ void ezComponent::OnSimulationStarted() {}
 void ezComponent::EnableUnhandledMessageHandler(bool enable)
 {
   m_ComponentFlags.AddOrRemove(ezObjectFlags::UnhandledMessageHandler, enable);
+
+  if (m_pOwner != nullptr)
+  {
+    m_pOwner->UpdateMessageHandlerMask();
+  }
 }
 
 bool ezComponent::OnUnhandledMessage(ezMessage& msg, bool bWasPostedMsg)
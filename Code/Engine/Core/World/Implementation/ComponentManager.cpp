@@ -15,6 +15,14 @@ ezComponentManagerBase::ezComponentManagerBase(ezWorld* pWorld)
 
 ezComponentManagerBase::~ezComponentManagerBase() {}
 
+void ezComponentManagerBase::ReserveComponents(ezUInt32 uiNumComponents)
+{
+  const ezUInt32 uiNewCount = m_Components.GetCount() + uiNumComponents;
+
+  m_Components.Reserve(uiNewCount);
+  ReserveComponentStorage(uiNewCount);
+}
+
 ezComponentHandle ezComponentManagerBase::CreateComponent(ezGameObject* pOwnerObject)
 {
   ezComponent* pDummy;
@@ -42,7 +50,7 @@ void ezComponentManagerBase::DeleteComponent(ezComponent* pComponent)
   pComponent->m_InternalId.Invalidate();
   pComponent->m_ComponentFlags.Remove(ezObjectFlags::ActiveFlag | ezObjectFlags::ActiveState);
 
-  GetWorld()->m_Data.m_DeadComponents.Insert(pComponent);
+  GetWorld()->m_Data.m_DeadComponents.PushBack(pComponent);
 }
 
 void ezComponentManagerBase::DeinitializeInternal()
@@ -148,6 +148,12 @@ EZ_FORCE_INLINE void ezComponentManager<T, StorageType>::DeleteComponentStorage(
   out_pMovedComponent = pMovedComponent;
 }
 
+template <typename T, ezBlockStorageType::Enum StorageType>
+void ezComponentManager<T, StorageType>::ReserveComponentStorage(ezUInt32 uiCount)
+{
+  m_ComponentStorage.Reserve(uiCount);
+}
+
 template <typename T, ezBlockStorageType::Enum StorageType>
 EZ_FORCE_INLINE void ezComponentManager<T, StorageType>::RegisterUpdateFunction(UpdateFunctionDesc& desc)
 {
@@ -261,6 +261,8 @@ void ezGameObject::operator=(const ezGameObject& other)
   m_ChildCount = other.m_ChildCount;
 
   m_uiTeamID = other.m_uiTeamID;
+  m_uiMessageHandlerMask = other.m_uiMessageHandlerMask;
+  m_uiSubTreeMessageHandlerMask = other.m_uiSubTreeMessageHandlerMask;
 
   m_uiHierarchyLevel = other.m_uiHierarchyLevel;
   m_pTransformationData = other.m_pTransformationData;
@@ -722,6 +724,9 @@ void ezGameObject::AddComponent(ezComponent* pComponent)
   pComponent->m_pOwner = this;
   m_Components.PushBack(pComponent);
 
+  m_uiMessageHandlerMask |= GetMessageHandlerMask(pComponent);
+  AddSubTreeMessageHandlerMask(m_uiMessageHandlerMask);
+
   pComponent->UpdateActiveState(IsActive());
 
   if (m_Flags.IsSet(ezObjectFlags::ComponentChangesNotifications))
@@ -743,6 +748,8 @@ void ezGameObject::RemoveComponent(ezComponent* pComponent)
   pComponent->m_pOwner = nullptr;
   m_Components.RemoveAtAndSwap(uiIndex);
 
+  UpdateMessageHandlerMask();
+
   if (m_Flags.IsSet(ezObjectFlags::ComponentChangesNotifications))
   {
     ezMsgComponentsChanged msg;
@@ -761,10 +768,13 @@ bool ezGameObject::SendMessageInternal(ezMessage& msg, bool bWasPostedMsg)
   const ezRTTI* pRtti = ezGetStaticRTTI<ezGameObject>();
   bSentToAny |= pRtti->DispatchMessage(this, msg);
 
-  for (ezUInt32 i = 0; i < m_Components.GetCount(); ++i)
+  if ((m_uiMessageHandlerMask & GetMessageHandlerMaskBit(msg)) != 0)
   {
-    ezComponent* pComponent = m_Components[i];
-    bSentToAny |= pComponent->SendMessageInternal(msg, bWasPostedMsg);
+    for (ezUInt32 i = 0; i < m_Components.GetCount(); ++i)
+    {
+      ezComponent* pComponent = m_Components[i];
+      bSentToAny |= pComponent->SendMessageInternal(msg, bWasPostedMsg);
+    }
   }
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
@@ -785,10 +795,13 @@ bool ezGameObject::SendMessageInternal(ezMessage& msg, bool bWasPostedMsg) const
   const ezRTTI* pRtti = ezGetStaticRTTI<ezGameObject>();
   bSentToAny |= pRtti->DispatchMessage(this, msg);
 
-  for (ezUInt32 i = 0; i < m_Components.GetCount(); ++i)
+  if ((m_uiMessageHandlerMask & GetMessageHandlerMaskBit(msg)) != 0)
   {
-    ezComponent* pComponent = m_Components[i];
-    bSentToAny |= pComponent->SendMessageInternal(msg, bWasPostedMsg);
+    for (ezUInt32 i = 0; i < m_Components.GetCount(); ++i)
+    {
+      ezComponent* pComponent = m_Components[i];
+      bSentToAny |= pComponent->SendMessageInternal(msg, bWasPostedMsg);
+    }
   }
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
@@ -804,15 +817,23 @@ bool ezGameObject::SendMessageInternal(ezMessage& msg, bool bWasPostedMsg) const
 
 bool ezGameObject::SendMessageRecursiveInternal(ezMessage& msg, bool bWasPostedMsg)
 {
-  bool bSentToAny = false;
-
   const ezRTTI* pRtti = ezGetStaticRTTI<ezGameObject>();
+  const ezUInt64 uiMessageBit = GetMessageHandlerMaskBit(msg);
+
+  // nothing in this sub-tree can handle the message
+  if ((m_uiSubTreeMessageHandlerMask & uiMessageBit) == 0 && !pRtti->CanHandleMessage(msg.GetId()))
+    return false;
+
+  bool bSentToAny = false;
   bSentToAny |= pRtti->DispatchMessage(this, msg);
 
-  for (ezUInt32 i = 0; i < m_Components.GetCount(); ++i)
+  if ((m_uiMessageHandlerMask & uiMessageBit) != 0)
   {
-    ezComponent* pComponent = m_Components[i];
-    bSentToAny |= pComponent->SendMessageInternal(msg, bWasPostedMsg);
+    for (ezUInt32 i = 0; i < m_Components.GetCount(); ++i)
+    {
+      ezComponent* pComponent = m_Components[i];
+      bSentToAny |= pComponent->SendMessageInternal(msg, bWasPostedMsg);
+    }
   }
 
   for (auto childIt = GetChildren(); childIt.IsValid(); ++childIt)
@@ -834,15 +855,23 @@ bool ezGameObject::SendMessageRecursiveInternal(ezMessage& msg, bool bWasPostedM
 
 bool ezGameObject::SendMessageRecursiveInternal(ezMessage& msg, bool bWasPostedMsg) const
 {
-  bool bSentToAny = false;
-
   const ezRTTI* pRtti = ezGetStaticRTTI<ezGameObject>();
+  const ezUInt64 uiMessageBit = GetMessageHandlerMaskBit(msg);
+
+  // nothing in this sub-tree can handle the message
+  if ((m_uiSubTreeMessageHandlerMask & uiMessageBit) == 0 && !pRtti->CanHandleMessage(msg.GetId()))
+    return false;
+
+  bool bSentToAny = false;
   bSentToAny |= pRtti->DispatchMessage(this, msg);
 
-  for (ezUInt32 i = 0; i < m_Components.GetCount(); ++i)
+  if ((m_uiMessageHandlerMask & uiMessageBit) != 0)
   {
-    ezComponent* pComponent = m_Components[i];
-    bSentToAny |= pComponent->SendMessageInternal(msg, bWasPostedMsg);
+    for (ezUInt32 i = 0; i < m_Components.GetCount(); ++i)
+    {
+      ezComponent* pComponent = m_Components[i];
+      bSentToAny |= pComponent->SendMessageInternal(msg, bWasPostedMsg);
+    }
   }
 
   for (auto childIt = GetChildren(); childIt.IsValid(); ++childIt)
@@ -862,6 +891,61 @@ bool ezGameObject::SendMessageRecursiveInternal(ezMessage& msg, bool bWasPostedM
   return bSentToAny;
 }
 
+// static
+ezUInt64 ezGameObject::GetMessageHandlerMaskBit(const ezMessage& msg)
+{
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+  // messages with debug routing enabled are passed to all components, so that each of them can report why it did not handle the message
+  if (msg.GetDebugMessageRouting())
+    return 0xFFFFFFFFFFFFFFFFull;
+#endif
+
+  return EZ_BIT(msg.GetId() & 63);
+}
+
+// static
+ezUInt64 ezGameObject::GetMessageHandlerMask(const ezComponent* pComponent)
+{
+  // the unhandled message handler may react to any message
+  if (pComponent->m_ComponentFlags.IsSet(ezObjectFlags::UnhandledMessageHandler))
+    return 0xFFFFFFFFFFFFFFFFull;
+
+  ezUInt64 uiMask = 0;
+
+  for (const ezRTTI* pRtti = pComponent->GetDynamicRTTI(); pRtti != nullptr; pRtti = pRtti->GetParentType())
+  {
+    for (const ezAbstractMessageHandler* pHandler : pRtti->GetMessageHandlers())
+    {
+      uiMask |= EZ_BIT(pHandler->GetMessageId() & 63);
+    }
+  }
+
+  return uiMask;
+}
+
+void ezGameObject::UpdateMessageHandlerMask()
+{
+  m_uiMessageHandlerMask = 0;
+
+  for (ezUInt32 i = 0; i < m_Components.GetCount(); ++i)
+  {
+    m_uiMessageHandlerMask |= GetMessageHandlerMask(m_Components[i]);
+  }
+
+  AddSubTreeMessageHandlerMask(m_uiMessageHandlerMask);
+}
+
+void ezGameObject::AddSubTreeMessageHandlerMask(ezUInt64 uiMask)
+{
+  // the mask of a parent always contains the masks of all its children, so we can stop at the first object that has all bits already
+  ezGameObject* pObject = this;
+  while (pObject != nullptr && (pObject->m_uiSubTreeMessageHandlerMask & uiMask) != uiMask)
+  {
+    pObject->m_uiSubTreeMessageHandlerMask |= uiMask;
+    pObject = pObject->GetParent();
+  }
+}
+
 void ezGameObject::PostMessage(const ezMessage& msg, ezObjectMsgQueueType::Enum queueType, ezTime delay) const
 {
   GetWorld()->PostMessage(GetHandle(), msg, queueType, delay);
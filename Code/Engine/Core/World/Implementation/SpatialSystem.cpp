@@ -182,7 +182,7 @@ void ezSpatialSystem::FindObjectsInBox(const ezBoundingBox& box, ezUInt32 uiCate
 }
 
 void ezSpatialSystem::FindVisibleObjects(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
-  QueryStats* pStats /*= nullptr*/) const
+  QueryStats* pStats /*= nullptr*/, IsOccludedFunc isOccluded /*= IsOccludedFunc()*/) const
 {
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   ezStopwatch timer;
@@ -195,7 +195,7 @@ void ezSpatialSystem::FindVisibleObjects(const ezFrustum& frustum, ezUInt32 uiCa
   }
 #endif
 
-  FindVisibleObjectsInternal(frustum, uiCategoryBitmask, out_Objects, pStats);
+  FindVisibleObjectsInternal(frustum, uiCategoryBitmask, out_Objects, pStats, isOccluded);
 
   for (auto pData : m_DataAlwaysVisible)
   {
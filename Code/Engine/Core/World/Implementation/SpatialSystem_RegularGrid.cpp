@@ -450,7 +450,7 @@ void ezSpatialSystem_RegularGrid::FindObjectsInBoxInternal(const ezBoundingBox&
 }
 
 void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
-  QueryStats* pStats) const
+  QueryStats* pStats, IsOccludedFunc isOccluded) const
 {
   ezVec3 cornerPoints[8];
   frustum.ComputeCornerPoints(cornerPoints);
@@ -493,13 +493,46 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(const ezFrustum& fr
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   ezUInt32 uiNumObjectsTested = 0;
   ezUInt32 uiNumObjectsPassed = 0;
+  ezUInt32 uiNumObjectsOccluded = 0;
 #endif
 
+  const bool bTestOcclusion = isOccluded.IsValid();
+
+  // returns true if the object should be skipped
+  auto IsObjectOccluded = [&](const ezSpatialData* pData) {
+    if (bTestOcclusion && isOccluded(pData->m_Bounds.GetBox()))
+    {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      uiNumObjectsOccluded++;
+#endif
+      return true;
+    }
+
+    return false;
+  };
+
   ForEachCellInBox(simdBox, uiCategoryBitmask, [&](const ezSimdVec4i& cellIndex, ezUInt64 cellKey, const Cell& cell, ezUInt32 uiFilteredCategoryBitmask) {
     ezSimdBSphere cellSphere = cell.m_Bounds.GetSphere();
     if (!SphereFrustumIntersect(cellSphere, planeData))
       return;
 
+    // reject the whole cell at once if it is hidden, its objects are counted as tested and occluded
+    if (bTestOcclusion && isOccluded(cell.m_Bounds.GetBox()))
+    {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      ezUInt32 filteredMask = uiFilteredCategoryBitmask;
+      while (filteredMask > 0)
+      {
+        ezUInt32 category = ezMath::FirstBitLow(filteredMask);
+        filteredMask &= filteredMask - 1;
+
+        uiNumObjectsTested += cell.m_BoundingSpheres[category].GetCount();
+        uiNumObjectsOccluded += cell.m_BoundingSpheres[category].GetCount();
+      }
+#endif
+      return;
+    }
+
     ezUInt32 filteredMask = uiFilteredCategoryBitmask;
     while (filteredMask > 0)
     {
@@ -536,6 +569,9 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(const ezFrustum& fr
             mask &= mask - 1;
 
             ezSpatialData* pData = dataPointers[currentIndex + i];
+            if (IsObjectOccluded(pData))
+              continue;
+
             out_Objects.PushBack(pData->m_pObject);
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
@@ -555,6 +591,9 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(const ezFrustum& fr
             continue;
 
           ezSpatialData* pData = dataPointers[i];
+          if (IsObjectOccluded(pData))
+            continue;
+
           out_Objects.PushBack(pData->m_pObject);
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
@@ -570,6 +609,7 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(const ezFrustum& fr
   {
     pStats->m_uiNumObjectsTested = uiNumObjectsTested;
     pStats->m_uiNumObjectsPassed = uiNumObjectsPassed;
+    pStats->m_uiNumObjectsOccluded = uiNumObjectsOccluded;
   }
 #endif
 }
@@ -195,6 +195,8 @@ ezGameObjectHandle ezWorld::CreateObject(const ezGameObjectDesc& desc, ezGameObj
   pNewObject->m_ParentIndex = uiParentIndex;
   pNewObject->m_Tags = desc.m_Tags;
   pNewObject->m_uiTeamID = desc.m_uiTeamID;
+  pNewObject->m_uiMessageHandlerMask = 0;
+  pNewObject->m_uiSubTreeMessageHandlerMask = 0;
 
   pNewObject->m_uiHierarchyLevel = uiHierarchyLevel;
 
@@ -239,6 +241,137 @@ ezGameObjectHandle ezWorld::CreateObject(const ezGameObjectDesc& desc, ezGameObj
   return ezGameObjectHandle(newId);
 }
 
+void ezWorld::CreateObjects(ezArrayPtr<const ezGameObjectDesc> descs, ezDynamicArray<ezGameObjectHandle>* out_Handles,
+  ezDynamicArray<ezGameObject*>* out_Objects /*= nullptr*/)
+{
+  CheckForWriteAccess();
+
+  const ezUInt32 uiNumObjects = descs.GetCount();
+  EZ_ASSERT_DEV(m_Data.m_Objects.GetCount() + uiNumObjects <= GetMaxNumGameObjects(), "Max number of game objects reached: {}", GetMaxNumGameObjects());
+
+  // reserve the transformation data for every hierarchy level that is spawned into
+  {
+    ezHybridArray<ezUInt32, 8> numObjectsPerLevel[ezInternal::WorldData::HierarchyType::COUNT];
+
+    for (const ezGameObjectDesc& desc : descs)
+    {
+      ezUInt32 uiHierarchyLevel = 0;
+      bool bDynamic = desc.m_bDynamic;
+
+      ezGameObject* pParentObject = nullptr;
+      if (TryGetObject(desc.m_hParent, pParentObject))
+      {
+        uiHierarchyLevel = pParentObject->m_uiHierarchyLevel + 1;
+        bDynamic |= pParentObject->IsDynamic();
+      }
+
+      auto& numObjects = numObjectsPerLevel[ezInternal::WorldData::GetHierarchyType(bDynamic)];
+      if (uiHierarchyLevel >= numObjects.GetCount())
+      {
+        numObjects.SetCount(uiHierarchyLevel + 1);
+      }
+
+      ++numObjects[uiHierarchyLevel];
+    }
+
+    ReserveObjectStorage(uiNumObjects, numObjectsPerLevel[ezInternal::WorldData::HierarchyType::Static],
+      numObjectsPerLevel[ezInternal::WorldData::HierarchyType::Dynamic]);
+  }
+
+  if (out_Handles != nullptr)
+  {
+    out_Handles->Reserve(out_Handles->GetCount() + uiNumObjects);
+  }
+
+  if (out_Objects != nullptr)
+  {
+    out_Objects->Reserve(out_Objects->GetCount() + uiNumObjects);
+  }
+
+  for (const ezGameObjectDesc& desc : descs)
+  {
+    ezGameObject* pObject = nullptr;
+    ezGameObjectHandle hObject = CreateObject(desc, pObject);
+
+    if (out_Handles != nullptr)
+    {
+      out_Handles->PushBack(hObject);
+    }
+
+    if (out_Objects != nullptr)
+    {
+      out_Objects->PushBack(pObject);
+    }
+  }
+}
+
+void ezWorld::ReserveObjects(const ezGameObjectHandle& hParent, ezArrayPtr<const ezUInt32> numStaticObjectsPerLevel,
+  ezArrayPtr<const ezUInt32> numDynamicObjectsPerLevel)
+{
+  CheckForWriteAccess();
+
+  ezUInt32 uiParentLevel = 0;
+  bool bParentDynamic = false;
+
+  ezGameObject* pParentObject = nullptr;
+  if (TryGetObject(hParent, pParentObject))
+  {
+    uiParentLevel = pParentObject->m_uiHierarchyLevel + 1;
+    bParentDynamic = pParentObject->IsDynamic();
+  }
+
+  // convert to absolute hierarchy levels, static objects below a dynamic parent end up in the dynamic hierarchy as well
+  ezHybridArray<ezUInt32, 8> numObjectsPerLevel[ezInternal::WorldData::HierarchyType::COUNT];
+  ezUInt32 uiNumObjects = 0;
+
+  auto AddObjects = [&](ezArrayPtr<const ezUInt32> numObjectsPerRelativeLevel, bool bDynamic) {
+    auto& numObjects = numObjectsPerLevel[ezInternal::WorldData::GetHierarchyType(bDynamic || bParentDynamic)];
+
+    for (ezUInt32 uiRelativeLevel = 0; uiRelativeLevel < numObjectsPerRelativeLevel.GetCount(); ++uiRelativeLevel)
+    {
+      const ezUInt32 uiHierarchyLevel = uiParentLevel + uiRelativeLevel;
+      if (uiHierarchyLevel >= numObjects.GetCount())
+      {
+        numObjects.SetCount(uiHierarchyLevel + 1);
+      }
+
+      numObjects[uiHierarchyLevel] += numObjectsPerRelativeLevel[uiRelativeLevel];
+      uiNumObjects += numObjectsPerRelativeLevel[uiRelativeLevel];
+    }
+  };
+
+  AddObjects(numStaticObjectsPerLevel, false);
+  AddObjects(numDynamicObjectsPerLevel, true);
+
+  ReserveObjectStorage(uiNumObjects, numObjectsPerLevel[ezInternal::WorldData::HierarchyType::Static],
+    numObjectsPerLevel[ezInternal::WorldData::HierarchyType::Dynamic]);
+}
+
+void ezWorld::ReserveObjectStorage(ezUInt32 uiNumObjects, ezArrayPtr<const ezUInt32> numStaticObjectsPerLevel,
+  ezArrayPtr<const ezUInt32> numDynamicObjectsPerLevel)
+{
+  const ezUInt32 uiNewCount = m_Data.m_Objects.GetCount() + uiNumObjects;
+
+  m_Data.m_Objects.Reserve(uiNewCount);
+  m_Data.m_ObjectStorage.Reserve(uiNewCount);
+
+  for (ezUInt32 uiHierarchyLevel = 0; uiHierarchyLevel < numStaticObjectsPerLevel.GetCount(); ++uiHierarchyLevel)
+  {
+    if (ezUInt32 uiCount = numStaticObjectsPerLevel[uiHierarchyLevel])
+    {
+      m_Data.ReserveTransformationData(false, uiHierarchyLevel, uiCount);
+    }
+  }
+
+  for (ezUInt32 uiHierarchyLevel = 0; uiHierarchyLevel < numDynamicObjectsPerLevel.GetCount(); ++uiHierarchyLevel)
+  {
+    if (ezUInt32 uiCount = numDynamicObjectsPerLevel[uiHierarchyLevel])
+    {
+      m_Data.ReserveTransformationData(true, uiHierarchyLevel, uiCount);
+    }
+  }
+}
+
 void ezWorld::DeleteObjectNow(const ezGameObjectHandle& hObject)
 {
   CheckForWriteAccess();
@@ -274,10 +407,22 @@ void ezWorld::DeleteObjectNow(const ezGameObjectHandle& hObject)
   pObject->m_InternalId.Invalidate();
   pObject->m_InternalId.m_WorldIndex = m_uiIndex;
 
-  m_Data.m_DeadObjects.Insert(pObject);
+  m_Data.m_DeadObjects.PushBack(pObject);
   EZ_VERIFY(m_Data.m_Objects.Remove(hObject), "Implementation error.");
 }
 
+void ezWorld::DeleteObjectsNow(ezArrayPtr<const ezGameObjectHandle> objects)
+{
+  CheckForWriteAccess();
+
+  m_Data.m_DeadObjects.Reserve(m_Data.m_DeadObjects.GetCount() + objects.GetCount());
+
+  for (const ezGameObjectHandle& hObject : objects)
+  {
+    DeleteObjectNow(hObject);
+  }
+}
+
 void ezWorld::DeleteObjectDelayed(const ezGameObjectHandle& hObject)
 {
   ezMsgDeleteGameObject msg;
@@ -653,6 +798,8 @@ void ezWorld::LinkToParent(ezGameObject* pObject)
 
     pObject->m_pTransformationData->m_pParentData = pParentObject->m_pTransformationData;
 
+    pParentObject->AddSubTreeMessageHandlerMask(pObject->m_uiSubTreeMessageHandlerMask);
+
     if (pParentObject->m_Flags.IsSet(ezObjectFlags::ChildChangesNotifications))
     {
       ezMsgChildrenChanged msg;
@@ -851,23 +998,22 @@ void ezWorld::ProcessQueuedMessages(ezObjectMsgQueueType::Enum queueType)
 
   // timed messages
   {
-    ezInternal::WorldData::MessageQueue& queue = m_Data.m_TimedMessageQueues[queueType];
-    queue.Sort(MessageComparer());
+    ezInternal::WorldData::TimedMessageScheduler& scheduler = m_Data.m_TimedMessageSchedulers[queueType];
+    scheduler.ScheduleMessages(m_Data.m_TimedMessageQueues[queueType]);
 
-    const ezTime now = m_Data.m_Clock.GetAccumulatedTime();
+    // only the due messages need to be sorted, messages that are posted while processing these are never due in this frame
+    auto& dueMessages = m_Data.m_DueTimedMessages;
+    scheduler.TakeDueMessages(m_Data.m_Clock.GetAccumulatedTime(), dueMessages);
+    dueMessages.Sort(MessageComparer());
 
-    while (!queue.IsEmpty())
+    for (ezUInt32 i = 0; i < dueMessages.GetCount(); ++i)
     {
-      auto& entry = queue.Peek();
-      if (entry.m_MetaData.m_Due > now)
-        break;
-
-      ProcessQueuedMessage(entry);
+      ProcessQueuedMessage(dueMessages[i]);
 
-      EZ_DELETE(&m_Data.m_Allocator, entry.m_pMessage);
-
-      queue.Dequeue();
+      EZ_DELETE(&m_Data.m_Allocator, dueMessages[i].m_pMessage);
     }
+
+    dueMessages.Clear();
   }
 }
 
@@ -1201,53 +1347,80 @@ ezResult ezWorld::RegisterUpdateFunctionInternal(const ezWorldModule::UpdateFunc
 
 void ezWorld::DeleteDeadObjects()
 {
-  while (!m_Data.m_DeadObjects.IsEmpty())
+  if (m_Data.m_DeadObjects.IsEmpty())
+    return;
+
+  // The compact storage fills the hole of a deleted object with the last object.
+  // Deleting in descending address order makes it unlikely that the last object is dead as well,
+  // which can only happen if the dead objects are spread across several storage blocks.
+  m_Data.m_DeadObjects.Sort();
+
+  for (ezUInt32 i = m_Data.m_DeadObjects.GetCount(); i-- > 0;)
   {
-    ezGameObject* pObject = m_Data.m_DeadObjects.GetIterator().Key();
+    ezGameObject* pObject = m_Data.m_DeadObjects[i];
+
+    // this entry is stale since the dead object has been moved to and deleted at another location already
+    if (!m_Data.m_MovedDeadObjects.IsEmpty() && m_Data.m_MovedDeadObjects.Remove(pObject))
+      continue;
 
-    if (!pObject->m_pTransformationData->m_hSpatialData.IsInvalidated())
+    while (true)
     {
-      m_Data.m_pSpatialSystem->DeleteSpatialData(pObject->m_pTransformationData->m_hSpatialData);
-    }
+      if (!pObject->m_pTransformationData->m_hSpatialData.IsInvalidated())
+      {
+        m_Data.m_pSpatialSystem->DeleteSpatialData(pObject->m_pTransformationData->m_hSpatialData);
+      }
 
-    m_Data.DeleteTransformationData(pObject->IsDynamic(), pObject->m_uiHierarchyLevel, pObject->m_pTransformationData);
+      m_Data.DeleteTransformationData(pObject->IsDynamic(), pObject->m_uiHierarchyLevel, pObject->m_pTransformationData);
 
-    ezGameObject* pMovedObject = nullptr;
-    m_Data.m_ObjectStorage.Delete(pObject, pMovedObject);
+      ezGameObject* pMovedObject = nullptr;
+      m_Data.m_ObjectStorage.Delete(pObject, pMovedObject);
+
+      if (pObject == pMovedObject)
+        break;
 
-    if (pObject != pMovedObject)
-    {
       // patch the id table: the last element in the storage has been moved to deleted object's location,
       // thus the pointer now points to another object
       ezGameObjectId id = pObject->m_InternalId;
       if (id.m_InstanceIndex != ezGameObjectId::INVALID_INSTANCE_INDEX)
-        m_Data.m_Objects[id] = pObject;
-
-      // The moved object might be deleted as well so we remove it from the dead objects set instead.
-      // If that is not the case we remove the original object from the set.
-      if (m_Data.m_DeadObjects.Remove(pMovedObject))
       {
-        continue;
+        m_Data.m_Objects[id] = pObject;
+        break;
       }
-    }
 
-    m_Data.m_DeadObjects.Remove(pObject);
+      // The moved object is dead as well. Delete it right away at its new location and remember to skip its old entry.
+      m_Data.m_MovedDeadObjects.Insert(pMovedObject);
+    }
   }
+
+  EZ_ASSERT_DEBUG(m_Data.m_MovedDeadObjects.IsEmpty(), "Implementation error.");
+  m_Data.m_DeadObjects.Clear();
 }
 
 void ezWorld::DeleteDeadComponents()
 {
-  while (!m_Data.m_DeadComponents.IsEmpty())
+  if (m_Data.m_DeadComponents.IsEmpty())
+    return;
+
+  // see DeleteDeadObjects, components in compact storages are moved the same way
+  m_Data.m_DeadComponents.Sort();
+
+  for (ezUInt32 i = m_Data.m_DeadComponents.GetCount(); i-- > 0;)
   {
-    ezComponent* pComponent = m_Data.m_DeadComponents.GetIterator().Key();
+    ezComponent* pComponent = m_Data.m_DeadComponents[i];
 
-    ezComponentManagerBase* pManager = pComponent->GetOwningManager();
-    ezComponent* pMovedComponent = nullptr;
-    pManager->DeleteComponentStorage(pComponent, pMovedComponent);
+    if (!m_Data.m_MovedDeadComponents.IsEmpty() && m_Data.m_MovedDeadComponents.Remove(pComponent))
+      continue;
 
-    // another component has been moved to the deleted component location
-    if (pComponent != pMovedComponent)
+    while (true)
     {
+      ezComponentManagerBase* pManager = pComponent->GetOwningManager();
+      ezComponent* pMovedComponent = nullptr;
+      pManager->DeleteComponentStorage(pComponent, pMovedComponent);
+
+      if (pComponent == pMovedComponent)
+        break;
+
+      // another component has been moved to the deleted component location
       pManager->PatchIdTable(pComponent);
 
       if (ezGameObject* pOwner = pComponent->GetOwner())
@@ -1255,16 +1428,15 @@ void ezWorld::DeleteDeadComponents()
         pOwner->FixComponentPointer(pMovedComponent, pComponent);
       }
 
-      // The moved component might be deleted as well so we remove it from the dead components set instead.
-      // If that is not the case we remove the original component from the set.
-      if (m_Data.m_DeadComponents.Remove(pMovedComponent))
-      {
-        continue;
-      }
-    }
+      if (pComponent->m_InternalId.m_InstanceIndex != ezComponentId::INVALID_INSTANCE_INDEX)
+        break;
 
-    m_Data.m_DeadComponents.Remove(pComponent);
+      m_Data.m_MovedDeadComponents.Insert(pMovedComponent);
+    }
   }
+
+  EZ_ASSERT_DEBUG(m_Data.m_MovedDeadComponents.IsEmpty(), "Implementation error.");
+  m_Data.m_DeadComponents.Clear();
 }
 
 void ezWorld::PatchHierarchyData(ezGameObject* pObject, ezGameObject::TransformPreservation preserve)
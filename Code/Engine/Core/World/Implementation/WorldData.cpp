@@ -73,7 +73,7 @@ namespace ezInternal
     EZ_CHECK_AT_COMPILETIME(sizeof(ezGameObject::TransformationData) == 192);
 #endif
 
-    EZ_CHECK_AT_COMPILETIME(sizeof(ezGameObject) == 168); /// \todo get game object size back to 128
+    EZ_CHECK_AT_COMPILETIME(sizeof(ezGameObject) == 184); /// \todo get game object size back to 128
     EZ_CHECK_AT_COMPILETIME(sizeof(QueuedMsgMetaData) == 16);
 
     EZ_CHECK_AT_COMPILETIME(sizeof(ezGameObjectId::m_WorldIndex) == sizeof(ezComponentId::m_WorldIndex));
@@ -151,10 +151,169 @@ namespace ezInternal
 
           queue.Dequeue();
         }
+
+        m_TimedMessageSchedulers[i].DeleteAllMessages(&m_Allocator);
+      }
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  void WorldData::TimedMessageScheduler::ScheduleMessages(MessageQueue& queue)
+  {
+    for (ezUInt32 i = 0; i < queue.GetCount(); ++i)
+    {
+      Insert(queue[i]);
+    }
+
+    queue.Clear();
+  }
+
+  void WorldData::TimedMessageScheduler::TakeDueMessages(ezTime now, ezDynamicArray<Entry, ezLocalAllocatorWrapper>& out_Messages)
+  {
+    const ezUInt32 uiPrevCount = out_Messages.GetCount();
+
+    // the clock may have been reset to an earlier time, in that case only the current slot can contain due messages
+    const ezUInt64 uiTargetTick = ezMath::Max(ComputeTick(now), m_uiCurrentTick);
+    const ezUInt64 uiNumTicks = ezMath::Min<ezUInt64>(uiTargetTick - m_uiCurrentTick + 1, NUM_SLOTS);
+
+    for (ezUInt64 uiTick = m_uiCurrentTick; uiTick < m_uiCurrentTick + uiNumTicks; ++uiTick)
+    {
+      auto& slot = m_Slots[uiTick & SLOT_MASK];
+
+      // only the slot of the target tick can contain messages that are not due yet
+      for (ezUInt32 i = 0; i < slot.GetCount();)
+      {
+        if (slot[i].m_MetaData.m_Due <= now)
+        {
+          out_Messages.PushBack(slot[i]);
+          slot.RemoveAtAndSwap(i);
+        }
+        else
+        {
+          ++i;
+        }
+      }
+    }
+
+    m_uiCurrentTick = uiTargetTick;
+
+    // move messages from the heap into the wheel once they are in range
+    while (!m_FarFutureHeap.IsEmpty())
+    {
+      const Entry entry = m_FarFutureHeap[0];
+      const ezUInt64 uiTick = ComputeTick(entry.m_MetaData.m_Due);
+      if (uiTick >= m_uiCurrentTick + NUM_SLOTS)
+        break;
+
+      PopFromHeap();
+
+      if (entry.m_MetaData.m_Due <= now)
+      {
+        out_Messages.PushBack(entry);
+      }
+      else
+      {
+        m_Slots[ezMath::Max(uiTick, m_uiCurrentTick) & SLOT_MASK].PushBack(entry);
+      }
+    }
+
+    m_uiCount -= out_Messages.GetCount() - uiPrevCount;
+  }
+
+  void WorldData::TimedMessageScheduler::DeleteAllMessages(ezAllocatorBase* pAllocator)
+  {
+    for (auto& slot : m_Slots)
+    {
+      for (Entry& entry : slot)
+      {
+        EZ_DELETE(pAllocator, entry.m_pMessage);
       }
+
+      slot.Clear();
+    }
+
+    for (Entry& entry : m_FarFutureHeap)
+    {
+      EZ_DELETE(pAllocator, entry.m_pMessage);
     }
+
+    m_FarFutureHeap.Clear();
+    m_uiCount = 0;
   }
 
+  // static
+  ezUInt64 WorldData::TimedMessageScheduler::ComputeTick(ezTime time)
+  {
+    return static_cast<ezUInt64>(ezMath::Max(time.GetSeconds(), 0.0) * TICKS_PER_SECOND);
+  }
+
+  void WorldData::TimedMessageScheduler::Insert(const Entry& entry)
+  {
+    // messages that are already due go into the current slot and are picked up by the next call to TakeDueMessages
+    const ezUInt64 uiTick = ezMath::Max(ComputeTick(entry.m_MetaData.m_Due), m_uiCurrentTick);
+
+    if (uiTick < m_uiCurrentTick + NUM_SLOTS)
+    {
+      m_Slots[uiTick & SLOT_MASK].PushBack(entry);
+    }
+    else
+    {
+      PushToHeap(entry);
+    }
+
+    ++m_uiCount;
+  }
+
+  void WorldData::TimedMessageScheduler::PushToHeap(const Entry& entry)
+  {
+    ezUInt32 uiIndex = m_FarFutureHeap.GetCount();
+    m_FarFutureHeap.PushBack(entry);
+
+    while (uiIndex > 0)
+    {
+      const ezUInt32 uiParent = (uiIndex - 1) / 2;
+      if (m_FarFutureHeap[uiParent].m_MetaData.m_Due <= entry.m_MetaData.m_Due)
+        break;
+
+      m_FarFutureHeap[uiIndex] = m_FarFutureHeap[uiParent];
+      uiIndex = uiParent;
+    }
+
+    m_FarFutureHeap[uiIndex] = entry;
+  }
+
+  void WorldData::TimedMessageScheduler::PopFromHeap()
+  {
+    const Entry last = m_FarFutureHeap.PeekBack();
+    m_FarFutureHeap.PopBack();
+
+    const ezUInt32 uiCount = m_FarFutureHeap.GetCount();
+    if (uiCount == 0)
+      return;
+
+    ezUInt32 uiIndex = 0;
+    while (true)
+    {
+      ezUInt32 uiChild = uiIndex * 2 + 1;
+      if (uiChild >= uiCount)
+        break;
+
+      if (uiChild + 1 < uiCount && m_FarFutureHeap[uiChild + 1].m_MetaData.m_Due < m_FarFutureHeap[uiChild].m_MetaData.m_Due)
+        ++uiChild;
+
+      if (last.m_MetaData.m_Due <= m_FarFutureHeap[uiChild].m_MetaData.m_Due)
+        break;
+
+      m_FarFutureHeap[uiIndex] = m_FarFutureHeap[uiChild];
+      uiIndex = uiChild;
+    }
+
+    m_FarFutureHeap[uiIndex] = last;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
   ezGameObject::TransformationData* WorldData::CreateTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel)
   {
     Hierarchy& hierarchy = m_Hierarchies[GetHierarchyType(bDynamic)];
@@ -181,6 +340,25 @@ namespace ezInternal
     return pBlock->ReserveBack();
   }
 
+  void WorldData::ReserveTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel, ezUInt32 uiCount)
+  {
+    Hierarchy& hierarchy = m_Hierarchies[GetHierarchyType(bDynamic)];
+
+    while (uiHierarchyLevel >= hierarchy.m_Data.GetCount())
+    {
+      hierarchy.m_Data.PushBack(EZ_NEW(&m_Allocator, Hierarchy::DataBlockArray, &m_Allocator));
+    }
+
+    // Only the block array is reserved, the blocks themselves are allocated on demand since all blocks but the last one need to be full.
+    Hierarchy::DataBlockArray& blocks = *hierarchy.m_Data[uiHierarchyLevel];
+    const ezUInt32 uiFreeInLastBlock = blocks.IsEmpty() ? 0 : TRANSFORMATION_DATA_PER_BLOCK - blocks.PeekBack().m_uiCount;
+    if (uiCount > uiFreeInLastBlock)
+    {
+      const ezUInt32 uiNumNewBlocks = (uiCount - uiFreeInLastBlock + TRANSFORMATION_DATA_PER_BLOCK - 1) / TRANSFORMATION_DATA_PER_BLOCK;
+      blocks.Reserve(blocks.GetCount() + uiNumNewBlocks);
+    }
+  }
+
   void WorldData::DeleteTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel, ezGameObject::TransformationData* pData)
   {
     Hierarchy& hierarchy = m_Hierarchies[GetHierarchyType(bDynamic)];
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Foundation/Communication/MessageQueue.h>
+#include <Foundation/Containers/HashSet.h>
 #include <Foundation/Containers/HashTable.h>
 #include <Foundation/Math/Random.h>
 #include <Foundation/Memory/FrameAllocator.h>
@@ -39,7 +40,9 @@ namespace ezInternal
     ezIdTable<ezGameObjectId, ezGameObject*, ezLocalAllocatorWrapper> m_Objects;
     ObjectStorage m_ObjectStorage;
 
-    ezSet<ezGameObject*, ezCompareHelper<ezGameObject*>, ezLocalAllocatorWrapper> m_DeadObjects;
+    // dead objects are only collected here and sorted once per frame when they are actually deleted
+    ezDynamicArray<ezGameObject*, ezLocalAllocatorWrapper> m_DeadObjects;
+    ezHashSet<ezGameObject*, ezHashHelper<ezGameObject*>, ezLocalAllocatorWrapper> m_MovedDeadObjects;
 
   public:
     class EZ_CORE_DLL ConstObjectIterator
@@ -117,6 +120,7 @@ namespace ezInternal
     static HierarchyType::Enum GetHierarchyType(bool bDynamic);
 
     ezGameObject::TransformationData* CreateTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel);
+    void ReserveTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel, ezUInt32 uiCount);
 
     void DeleteTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel, ezGameObject::TransformationData* pData);
 
@@ -147,7 +151,8 @@ namespace ezInternal
     ezDynamicArray<ezWorldModule*, ezLocalAllocatorWrapper> m_ModulesToStartSimulation;
 
     // component management
-    ezSet<ezComponent*, ezCompareHelper<ezComponent*>, ezLocalAllocatorWrapper> m_DeadComponents;
+    ezDynamicArray<ezComponent*, ezLocalAllocatorWrapper> m_DeadComponents;
+    ezHashSet<ezComponent*, ezHashHelper<ezComponent*>, ezLocalAllocatorWrapper> m_MovedDeadComponents;
 
     struct InitBatch
     {
@@ -226,8 +231,53 @@ namespace ezInternal
 
     typedef ezMessageQueue<QueuedMsgMetaData, ezLocalAllocatorWrapper> MessageQueue;
     mutable MessageQueue m_MessageQueues[ezObjectMsgQueueType::COUNT];
+
+    /// Timed messages are posted to these queues first and moved into the schedulers once per frame.
     mutable MessageQueue m_TimedMessageQueues[ezObjectMsgQueueType::COUNT];
 
+    /// \brief Sorts pending timed messages into buckets by their due time, so that each frame only touches the messages that are due.
+    ///
+    /// The wheel covers the next NUM_SLOTS ticks. Messages that are due later are kept in a min-heap and are moved into the wheel
+    /// once their tick comes into range. The messages that are returned by TakeDueMessages() are not sorted.
+    class TimedMessageScheduler
+    {
+    public:
+      typedef MessageQueue::Entry Entry;
+
+      /// \brief Moves all messages from the given queue into the scheduler. Not thread safe.
+      void ScheduleMessages(MessageQueue& queue);
+
+      /// \brief Removes all messages that are due at the given time and appends them to out_Messages.
+      void TakeDueMessages(ezTime now, ezDynamicArray<Entry, ezLocalAllocatorWrapper>& out_Messages);
+
+      /// \brief Deletes all pending messages with the given allocator.
+      void DeleteAllMessages(ezAllocatorBase* pAllocator);
+
+      ezUInt32 GetCount() const { return m_uiCount; }
+
+    private:
+      enum
+      {
+        NUM_SLOTS = 512,
+        SLOT_MASK = NUM_SLOTS - 1,
+        TICKS_PER_SECOND = 64
+      };
+
+      static ezUInt64 ComputeTick(ezTime time);
+
+      void Insert(const Entry& entry);
+      void PushToHeap(const Entry& entry);
+      void PopFromHeap();
+
+      ezUInt64 m_uiCurrentTick = 0;
+      ezUInt32 m_uiCount = 0;
+      ezDynamicArray<Entry, ezLocalAllocatorWrapper> m_Slots[NUM_SLOTS];
+      ezDynamicArray<Entry, ezLocalAllocatorWrapper> m_FarFutureHeap;
+    };
+
+    TimedMessageScheduler m_TimedMessageSchedulers[ezObjectMsgQueueType::COUNT];
+    ezDynamicArray<TimedMessageScheduler::Entry, ezLocalAllocatorWrapper> m_DueTimedMessages;
+
     ezThreadID m_WriteThreadID;
     ezInt32 m_iWriteCounter;
     mutable ezAtomicInteger32 m_iReadCounter;
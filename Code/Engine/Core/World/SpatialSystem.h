@@ -36,6 +36,7 @@ public:
     ezUInt32 m_uiTotalNumObjects;  ///< The total number of spatial objects in this system.
     ezUInt32 m_uiNumObjectsTested; ///< Number of objects tested for the query condition.
     ezUInt32 m_uiNumObjectsPassed; ///< Number of objects that passed the query condition.
+    ezUInt32 m_uiNumObjectsOccluded; ///< Number of objects rejected by the occlusion test. Includes objects outside of the query volume when a whole group, e.g. a grid cell, is rejected at once.
     ezTime m_TimeTaken;            ///< Time taken to execute the query
 
     EZ_ALWAYS_INLINE QueryStats()
@@ -43,9 +44,15 @@ public:
       m_uiTotalNumObjects = 0;
       m_uiNumObjectsTested = 0;
       m_uiNumObjectsPassed = 0;
+      m_uiNumObjectsOccluded = 0;
     }
   };
 
+  /// \brief Returns true if the given world space box is completely hidden, e.g. behind the occluders of a view.
+  ///
+  /// Must be conservative, i.e. only return true if nothing inside the box can be visible.
+  typedef ezDelegate<bool(const ezSimdBBox&)> IsOccludedFunc;
+
   void FindObjectsInSphere(const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, ezDynamicArray<ezGameObject*>& out_Objects, QueryStats* pStats = nullptr) const;
   void FindObjectsInSphere(const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats = nullptr) const;
 
@@ -56,14 +63,20 @@ public:
   /// \name Visibility Queries
   ///@{
 
-  void FindVisibleObjects(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats = nullptr) const;
+  /// \brief Finds all objects that are inside the frustum.
+  ///
+  /// If isOccluded is valid, objects inside the frustum are additionally tested with it and only returned if they are not occluded.
+  /// Spatial systems may also call it with larger boxes, to reject whole groups of objects at once.
+  void FindVisibleObjects(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats = nullptr,
+    IsOccludedFunc isOccluded = IsOccludedFunc()) const;
 
   ///@}
 
 protected:
   virtual void FindObjectsInSphereInternal(const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats) const = 0;
   virtual void FindObjectsInBoxInternal(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats) const = 0;
-  virtual void FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats) const = 0;
+  virtual void FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats,
+    IsOccludedFunc isOccluded) const = 0;
 
   virtual void SpatialDataAdded(ezSpatialData* pData) = 0;
   virtual void SpatialDataRemoved(ezSpatialData* pData) = 0;
@@ -43,12 +43,31 @@ public:
   /// \brief Create a new game object from the given description, writes a pointer to it to out_pObject and returns a handle to it.
   ezGameObjectHandle CreateObject(const ezGameObjectDesc& desc, ezGameObject*& out_pObject);
 
+  /// \brief Creates one game object for every given description and appends handles and pointers to the new objects to the given arrays.
+  ///
+  /// This gives the same result as calling CreateObject() for every description, but reserves all necessary internal storage up front.
+  /// Thus it is the preferred way to spawn many objects at once. Note that the descriptions can only reference parent objects that
+  /// already existed before this call.
+  void CreateObjects(ezArrayPtr<const ezGameObjectDesc> descs, ezDynamicArray<ezGameObjectHandle>* out_Handles,
+    ezDynamicArray<ezGameObject*>* out_Objects = nullptr);
+
+  /// \brief Reserves the internal storage for creating more game objects below the given parent.
+  ///
+  /// The arrays hold the number of static and dynamic objects per hierarchy level, relative to \a hParent. CreateObjects() does this
+  /// automatically, so this is only needed when many objects are created one by one, e.g. when instantiating a batch of prefabs.
+  void ReserveObjects(const ezGameObjectHandle& hParent, ezArrayPtr<const ezUInt32> numStaticObjectsPerLevel,
+    ezArrayPtr<const ezUInt32> numDynamicObjectsPerLevel);
+
   /// \brief Deletes the given object, its children and all components.
   /// \note This function deletes the object immediately! It is unsafe to use this during a game update loop, as other objects
   /// may rely on this object staying valid for the rest of the frame.
   /// Use DeleteObjectDelayed() instead for safe removal at the end of the frame.
   void DeleteObjectNow(const ezGameObjectHandle& object);
 
+  /// \brief Deletes all given objects, their children and all components. Invalid handles are ignored.
+  /// \note The same restrictions as for DeleteObjectNow() apply.
+  void DeleteObjectsNow(ezArrayPtr<const ezGameObjectHandle> objects);
+
   /// \brief Deletes the given object at the beginning of the next world update. The object and its components and children stay completely
   /// valid until then.
   void DeleteObjectDelayed(const ezGameObjectHandle& object);
@@ -336,6 +355,9 @@ private:
 
   ezGameObject* GetObjectUnchecked(ezUInt32 uiIndex) const;
 
+  void ReserveObjectStorage(ezUInt32 uiNumObjects, ezArrayPtr<const ezUInt32> numStaticObjectsPerLevel,
+    ezArrayPtr<const ezUInt32> numDynamicObjectsPerLevel);
+
   void SetParent(ezGameObject* pObject, ezGameObject* pNewParent, ezGameObject::TransformPreservation preserve = ezGameObject::TransformPreservation::PreserveGlobal);
   void LinkToParent(ezGameObject* pObject);
   void UnlinkFromParent(ezGameObject* pObject);
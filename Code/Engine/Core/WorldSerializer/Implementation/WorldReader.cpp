@@ -68,6 +68,7 @@ ezResult ezWorldReader::ReadWorldDescription(ezStreamReader& stream)
   }
 
   // read all component data
+  ReadComponentCreationData();
   ReadComponentDataToMemStream();
   m_pStringDedupReadContext->SetActive(false);
 
@@ -142,19 +143,22 @@ void ezWorldReader::ClearAndCompact()
   m_ComponentTypeVersions.Clear();
   m_ComponentTypeVersions.Compact();
 
-  m_ComponentCreationStream.Clear();
-  m_ComponentCreationStream.Compact();
-
   m_ComponentDataStream.Clear();
   m_ComponentDataStream.Compact();
 }
 
 ezUInt64 ezWorldReader::GetHeapMemoryUsage() const
 {
+  ezUInt64 uiComponentTypesMemoryUsage = m_ComponentTypes.GetHeapMemoryUsage();
+  for (const auto& compTypeInfo : m_ComponentTypes)
+  {
+    uiComponentTypesMemoryUsage += compTypeInfo.m_ComponentIndexToHandle.GetHeapMemoryUsage() + compTypeInfo.m_ComponentsToCreate.GetHeapMemoryUsage();
+  }
+
   return m_IndexToGameObjectHandle.GetHeapMemoryUsage() +
          m_RootObjectsToCreate.GetHeapMemoryUsage() + m_ChildObjectsToCreate.GetHeapMemoryUsage() +
-         m_ComponentTypes.GetHeapMemoryUsage() + m_ComponentTypeVersions.GetHeapMemoryUsage() +
-         m_ComponentCreationStream.GetHeapMemoryUsage() + m_ComponentDataStream.GetHeapMemoryUsage();
+         uiComponentTypesMemoryUsage + m_ComponentTypeVersions.GetHeapMemoryUsage() +
+         m_ComponentDataStream.GetHeapMemoryUsage();
 }
 
 ezUInt32 ezWorldReader::GetRootObjectCount() const
@@ -224,51 +228,66 @@ void ezWorldReader::ReadComponentTypeInfo(ezUInt32 uiComponentTypeIdx)
   m_ComponentTypeVersions[pRtti] = uiRttiVersion;
 }
 
-void ezWorldReader::ReadComponentDataToMemStream()
+void ezWorldReader::ReadComponentCreationData()
 {
-  auto WriteToMemStream = [&](ezMemoryStreamWriter& writer, bool bReadNumComponents) {
-    ezUInt8 Temp[4096];
-    for (auto& compTypeInfo : m_ComponentTypes)
+  for (auto& compTypeInfo : m_ComponentTypes)
+  {
+    ezUInt32 uiAllComponentsSize = 0;
+    *m_pStream >> uiAllComponentsSize;
+
+    if (compTypeInfo.m_pRtti == nullptr)
     {
-      ezUInt32 uiAllComponentsSize = 0;
-      *m_pStream >> uiAllComponentsSize;
+      ezLog::Warning("Skipping components of unknown type");
 
-      if (compTypeInfo.m_pRtti == nullptr)
-      {
-        ezLog::Warning("Skipping components of unknown type");
+      m_pStream->SkipBytes(uiAllComponentsSize);
+      continue;
+    }
 
-        m_pStream->SkipBytes(uiAllComponentsSize);
-      }
-      else
-      {
-        if (bReadNumComponents)
-        {
-          *m_pStream >> compTypeInfo.m_uiNumComponents;
-          uiAllComponentsSize -= sizeof(ezUInt32);
+    ezUInt32 uiNumComponents = 0;
+    *m_pStream >> uiNumComponents;
 
-          m_uiTotalNumComponents += compTypeInfo.m_uiNumComponents;
-        }
+    compTypeInfo.m_ComponentsToCreate.SetCountUninitialized(uiNumComponents);
+    m_uiTotalNumComponents += uiNumComponents;
 
-        while (uiAllComponentsSize > 0)
-        {
-          const ezUInt64 uiRead = m_pStream->ReadBytes(Temp, ezMath::Min<ezUInt32>(uiAllComponentsSize, EZ_ARRAY_SIZE(Temp)));
+    for (ezUInt32 i = 0; i < uiNumComponents; ++i)
+    {
+      ComponentToCreate& compDesc = compTypeInfo.m_ComponentsToCreate[i];
 
-          writer.WriteBytes(Temp, uiRead);
+      ezUInt32 uiComponentIdx = 0;
+      *m_pStream >> compDesc.m_uiOwnerIndex;
+      *m_pStream >> uiComponentIdx;
+      *m_pStream >> compDesc.m_bActive;
+      *m_pStream >> compDesc.m_uiUserFlags;
 
-          uiAllComponentsSize -= (ezUInt32)uiRead;
-        }
-      }
+      EZ_ASSERT_DEBUG(uiComponentIdx == i + 1, "Component index doesn't match");
     }
-  };
-
-  {
-    ezMemoryStreamWriter writer(&m_ComponentCreationStream);
-    WriteToMemStream(writer, true);
   }
+}
+
+void ezWorldReader::ReadComponentDataToMemStream()
+{
+  ezMemoryStreamWriter writer(&m_ComponentDataStream);
 
+  ezUInt8 Temp[4096];
+  for (auto& compTypeInfo : m_ComponentTypes)
   {
-    ezMemoryStreamWriter writer(&m_ComponentDataStream);
-    WriteToMemStream(writer, false);
+    ezUInt32 uiAllComponentsSize = 0;
+    *m_pStream >> uiAllComponentsSize;
+
+    if (compTypeInfo.m_pRtti == nullptr)
+    {
+      m_pStream->SkipBytes(uiAllComponentsSize);
+      continue;
+    }
+
+    while (uiAllComponentsSize > 0)
+    {
+      const ezUInt64 uiRead = m_pStream->ReadBytes(Temp, ezMath::Min<ezUInt32>(uiAllComponentsSize, EZ_ARRAY_SIZE(Temp)));
+
+      writer.WriteBytes(Temp, uiRead);
+
+      uiAllComponentsSize -= (ezUInt32)uiRead;
+    }
   }
 }
 
@@ -284,6 +303,215 @@ void ezWorldReader::ClearHandles()
   }
 }
 
+template <bool UseTransform>
+ezGameObject* ezWorldReader::CreateGameObject(const GameObjectToCreate& godesc, const ezTransform& rootTransform, ezGameObjectHandle hParent,
+  const ezUInt16* pOverrideTeamID, bool bForceDynamic)
+{
+  ezGameObjectDesc desc = godesc.m_Desc; // make a copy
+  desc.m_hParent = hParent.IsInvalidated() ? m_IndexToGameObjectHandle[godesc.m_uiParentHandleIdx] : hParent;
+  desc.m_bDynamic |= bForceDynamic;
+
+  if (pOverrideTeamID != nullptr)
+  {
+    desc.m_uiTeamID = *pOverrideTeamID;
+  }
+
+  if (UseTransform)
+  {
+    ezTransform tChild(desc.m_LocalPosition, desc.m_LocalRotation, desc.m_LocalScaling);
+    ezTransform tFinal;
+    tFinal.SetGlobalTransform(rootTransform, tChild);
+
+    desc.m_LocalPosition = tFinal.m_vPosition;
+    desc.m_LocalRotation = tFinal.m_qRotation;
+    desc.m_LocalScaling = tFinal.m_vScale;
+  }
+
+  ezGameObject* pObject = nullptr;
+  m_IndexToGameObjectHandle.PushBack(m_pWorld->CreateObject(desc, pObject));
+
+  if (!godesc.m_sGlobalKey.IsEmpty())
+  {
+    pObject->SetGlobalKey(godesc.m_sGlobalKey);
+  }
+
+  return pObject;
+}
+
+ezComponentHandle ezWorldReader::CreateComponent(ezComponentManagerBase* pManager, const ComponentToCreate& compDesc)
+{
+  ezGameObject* pOwnerObject = nullptr;
+  m_pWorld->TryGetObject(m_IndexToGameObjectHandle[compDesc.m_uiOwnerIndex], pOwnerObject);
+
+  EZ_ASSERT_DEBUG(pOwnerObject != nullptr, "Owner object must be not null");
+
+  ezComponent* pComponent = nullptr;
+  auto hComponent = pManager->CreateComponentNoInit(pOwnerObject, pComponent);
+
+  pComponent->SetActiveFlag(compDesc.m_bActive);
+
+  for (ezUInt8 j = 0; j < 8; ++j)
+  {
+    pComponent->SetUserFlag(j, (compDesc.m_uiUserFlags & EZ_BIT(j)) != 0);
+  }
+
+  return hComponent;
+}
+
+void ezWorldReader::InstantiatePrefabBatch(ezWorld& world, ezArrayPtr<const ezTransform> rootTransforms, ezGameObjectHandle hParent,
+  ezDynamicArray<ezGameObject*>* out_CreatedRootObjects, ezDynamicArray<ezGameObject*>* out_CreatedChildObjects,
+  const ezUInt16* pOverrideTeamID, bool bForceDynamic)
+{
+  EZ_PROFILE_SCOPE("ezWorldReader::InstantiatePrefabBatch");
+
+  EZ_LOCK(world.GetWriteMarker());
+
+  m_pWorld = &world;
+
+  const ezUInt32 uiNumInstances = rootTransforms.GetCount();
+
+  if (out_CreatedRootObjects != nullptr)
+  {
+    out_CreatedRootObjects->Reserve(out_CreatedRootObjects->GetCount() + uiNumInstances * m_RootObjectsToCreate.GetCount());
+  }
+
+  if (out_CreatedChildObjects != nullptr)
+  {
+    out_CreatedChildObjects->Reserve(out_CreatedChildObjects->GetCount() + uiNumInstances * m_ChildObjectsToCreate.GetCount());
+  }
+
+  // the managers are the same for all instances
+  ezHybridArray<ezComponentManagerBase*, 16> managers;
+  managers.SetCount(m_ComponentTypes.GetCount());
+
+  for (ezUInt32 uiTypeIndex = 0; uiTypeIndex < m_ComponentTypes.GetCount(); ++uiTypeIndex)
+  {
+    const auto& compTypeInfo = m_ComponentTypes[uiTypeIndex];
+    if (compTypeInfo.m_pRtti == nullptr || compTypeInfo.m_ComponentsToCreate.IsEmpty())
+      continue;
+
+    managers[uiTypeIndex] = world.GetOrCreateManagerForComponentType(compTypeInfo.m_pRtti);
+    EZ_ASSERT_DEV(managers[uiTypeIndex] != nullptr, "Cannot create components of type '{0}', manager is not available.", compTypeInfo.m_pRtti->GetTypeName());
+
+    managers[uiTypeIndex]->ReserveComponents(uiNumInstances * compTypeInfo.m_ComponentsToCreate.GetCount());
+  }
+
+  // reserve the object storage of the world for all instances up front
+  {
+    ezHybridArray<ezUInt32, 8> numObjectsPerLevel[2];
+
+    // hierarchy level relative to the instance root and the dynamic flag of every object, indexed like m_IndexToGameObjectHandle
+    ezHybridArray<ezUInt32, 64> objectLevels;
+    ezHybridArray<bool, 64> objectDynamic;
+    objectLevels.PushBack(0);
+    objectDynamic.PushBack(false);
+
+    auto AddObject = [&](ezUInt32 uiHierarchyLevel, bool bDynamic) {
+      objectLevels.PushBack(uiHierarchyLevel);
+      objectDynamic.PushBack(bDynamic);
+
+      auto& numObjects = numObjectsPerLevel[bDynamic ? 1 : 0];
+      if (uiHierarchyLevel >= numObjects.GetCount())
+      {
+        numObjects.SetCount(uiHierarchyLevel + 1);
+      }
+
+      numObjects[uiHierarchyLevel] += uiNumInstances;
+    };
+
+    for (const GameObjectToCreate& godesc : m_RootObjectsToCreate)
+    {
+      AddObject(0, godesc.m_Desc.m_bDynamic || bForceDynamic);
+    }
+
+    for (const GameObjectToCreate& godesc : m_ChildObjectsToCreate)
+    {
+      const ezUInt32 uiParentIdx = godesc.m_uiParentHandleIdx;
+      EZ_ASSERT_DEBUG(uiParentIdx > 0 && uiParentIdx < objectLevels.GetCount(), "Child objects must be stored after their parent");
+
+      AddObject(objectLevels[uiParentIdx] + 1, godesc.m_Desc.m_bDynamic || bForceDynamic || objectDynamic[uiParentIdx]);
+    }
+
+    world.ReserveObjects(hParent, numObjectsPerLevel[0], numObjectsPerLevel[1]);
+  }
+
+  ezDynamicArray<ezComponentHandle> createdComponents;
+  createdComponents.Reserve(static_cast<ezUInt32>(uiNumInstances * m_uiTotalNumComponents));
+
+  ezMemoryStreamReader dataReader;
+
+  m_pStringDedupReadContext->SetActive(true);
+
+  ezStreamReader* pPrevReader = m_pStream;
+  m_pStream = &dataReader;
+
+  EZ_SCOPE_EXIT(m_pStream = pPrevReader; m_pStringDedupReadContext->SetActive(false););
+
+  for (const ezTransform& rootTransform : rootTransforms)
+  {
+    ClearHandles();
+
+    for (const GameObjectToCreate& godesc : m_RootObjectsToCreate)
+    {
+      ezGameObject* pObject = CreateGameObject<true>(godesc, rootTransform, hParent, pOverrideTeamID, bForceDynamic);
+
+      if (out_CreatedRootObjects != nullptr)
+      {
+        out_CreatedRootObjects->PushBack(pObject);
+      }
+    }
+
+    for (const GameObjectToCreate& godesc : m_ChildObjectsToCreate)
+    {
+      ezGameObject* pObject = CreateGameObject<false>(godesc, rootTransform, ezGameObjectHandle(), pOverrideTeamID, bForceDynamic);
+
+      if (out_CreatedChildObjects != nullptr)
+      {
+        out_CreatedChildObjects->PushBack(pObject);
+      }
+    }
+
+    // all components need to exist before the first one is deserialized, since they may reference each other
+    for (ezUInt32 uiTypeIndex = 0; uiTypeIndex < m_ComponentTypes.GetCount(); ++uiTypeIndex)
+    {
+      auto& compTypeInfo = m_ComponentTypes[uiTypeIndex];
+
+      for (const ComponentToCreate& compDesc : compTypeInfo.m_ComponentsToCreate)
+      {
+        compTypeInfo.m_ComponentIndexToHandle.PushBack(CreateComponent(managers[uiTypeIndex], compDesc));
+      }
+    }
+
+    dataReader.SetStorage(&m_ComponentDataStream);
+
+    for (auto& compTypeInfo : m_ComponentTypes)
+    {
+      if (compTypeInfo.m_pRtti == nullptr)
+        continue;
+
+      // index 0 is the invalid handle
+      for (ezUInt32 i = 1; i < compTypeInfo.m_ComponentIndexToHandle.GetCount(); ++i)
+      {
+        ezComponent* pComponent = nullptr;
+        if (world.TryGetComponent(compTypeInfo.m_ComponentIndexToHandle[i], pComponent))
+        {
+          pComponent->DeserializeComponent(*this);
+          createdComponents.PushBack(compTypeInfo.m_ComponentIndexToHandle[i]);
+        }
+      }
+    }
+  }
+
+  for (const ezComponentHandle& hComponent : createdComponents)
+  {
+    ezComponent* pComponent = nullptr;
+    if (world.TryGetComponent(hComponent, pComponent))
+    {
+      pComponent->GetOwningManager()->InitializeComponent(pComponent);
+    }
+  }
+}
+
 ezUniquePtr<ezWorldReader::InstantiationContextBase> ezWorldReader::Instantiate(ezWorld& world, bool bUseTransform,
   const ezTransform& rootTransform, ezGameObjectHandle hParent,
   ezHybridArray<ezGameObject*, 8>* out_CreatedRootObjects, ezHybridArray<ezGameObject*, 8>* out_CreatedChildObjects,
@@ -383,25 +611,14 @@ bool ezWorldReader::InstantiationContext::Step()
     if (!CreateGameObjects<false>(m_WorldReader.m_ChildObjectsToCreate, ezGameObjectHandle(), m_pCreatedChildObjects, endTime))
       return false;
 
-    m_CurrentReader.SetStorage(&m_WorldReader.m_ComponentCreationStream);
     m_Phase = Phase::CreateComponents;
     BeginNextProgressStep("CreateComponents");
   }
 
   if (m_Phase == Phase::CreateComponents)
   {
-    if (m_WorldReader.m_ComponentCreationStream.GetStorageSize() > 0)
-    {
-      m_WorldReader.m_pStringDedupReadContext->SetActive(true);
-
-      ezStreamReader* pPrevReader = m_WorldReader.m_pStream;
-      m_WorldReader.m_pStream = &m_CurrentReader;
-
-      EZ_SCOPE_EXIT(m_WorldReader.m_pStream = pPrevReader; m_WorldReader.m_pStringDedupReadContext->SetActive(false););
-
-      if (!CreateComponents(endTime))
-        return false;
-    }
+    if (!CreateComponents(endTime))
+      return false;
 
     m_CurrentReader.SetStorage(&m_WorldReader.m_ComponentDataStream);
     m_Phase = Phase::DeserializeComponents;
@@ -465,35 +682,7 @@ bool ezWorldReader::InstantiationContext::CreateGameObjects(const ezDynamicArray
 
   while (m_uiCurrentIndex < objects.GetCount())
   {
-    auto& godesc = objects[m_uiCurrentIndex];
-
-    ezGameObjectDesc desc = godesc.m_Desc; // make a copy
-    desc.m_hParent = hParent.IsInvalidated() ? m_WorldReader.m_IndexToGameObjectHandle[godesc.m_uiParentHandleIdx] : hParent;
-    desc.m_bDynamic |= m_bForceDynamic;
-
-    if (m_pOverrideTeamID != nullptr)
-    {
-      desc.m_uiTeamID = *m_pOverrideTeamID;
-    }
-
-    if (UseTransform)
-    {
-      ezTransform tChild(desc.m_LocalPosition, desc.m_LocalRotation, desc.m_LocalScaling);
-      ezTransform tFinal;
-      tFinal.SetGlobalTransform(m_RootTransform, tChild);
-
-      desc.m_LocalPosition = tFinal.m_vPosition;
-      desc.m_LocalRotation = tFinal.m_qRotation;
-      desc.m_LocalScaling = tFinal.m_vScale;
-    }
-
-    ezGameObject* pObject = nullptr;
-    m_WorldReader.m_IndexToGameObjectHandle.PushBack(m_WorldReader.m_pWorld->CreateObject(desc, pObject));
-
-    if (!godesc.m_sGlobalKey.IsEmpty())
-    {
-      pObject->SetGlobalKey(godesc.m_sGlobalKey);
-    }
+    ezGameObject* pObject = m_WorldReader.CreateGameObject<UseTransform>(objects[m_uiCurrentIndex], m_RootTransform, hParent, m_pOverrideTeamID, m_bForceDynamic);
 
     if (out_CreatedObjects)
     {
@@ -519,49 +708,20 @@ bool ezWorldReader::InstantiationContext::CreateComponents(ezTime endTime)
 {
   EZ_PROFILE_SCOPE("ezWorldReader::CreateComponents");
 
-  ezStreamReader& s = *m_WorldReader.m_pStream;
-
   for (; m_uiCurrentComponentTypeIndex < m_WorldReader.m_ComponentTypes.GetCount(); ++m_uiCurrentComponentTypeIndex)
   {
     auto& compTypeInfo = m_WorldReader.m_ComponentTypes[m_uiCurrentComponentTypeIndex];
 
     // will be the case for all abstract component types
-    if (compTypeInfo.m_pRtti == nullptr || compTypeInfo.m_uiNumComponents == 0)
+    if (compTypeInfo.m_pRtti == nullptr || compTypeInfo.m_ComponentsToCreate.IsEmpty())
       continue;
 
     ezComponentManagerBase* pManager = m_WorldReader.m_pWorld->GetOrCreateManagerForComponentType(compTypeInfo.m_pRtti);
     EZ_ASSERT_DEV(pManager != nullptr, "Cannot create components of type '{0}', manager is not available.", compTypeInfo.m_pRtti->GetTypeName());
 
-    while (m_uiCurrentIndex < compTypeInfo.m_uiNumComponents)
+    while (m_uiCurrentIndex < compTypeInfo.m_ComponentsToCreate.GetCount())
     {
-      const ezGameObjectHandle hOwner = m_WorldReader.ReadGameObjectHandle();
-
-      ezUInt32 uiComponentIdx = 0;
-      s >> uiComponentIdx;
-
-      bool bActive = true;
-      s >> bActive;
-
-      ezUInt8 userFlags = 0;
-      s >> userFlags;
-
-      ezGameObject* pOwnerObject = nullptr;
-      m_WorldReader.m_pWorld->TryGetObject(hOwner, pOwnerObject);
-
-      EZ_ASSERT_DEBUG(pOwnerObject != nullptr, "Owner object must be not null");
-
-      ezComponent* pComponent = nullptr;
-      auto hComponent = pManager->CreateComponentNoInit(pOwnerObject, pComponent);
-
-      pComponent->SetActiveFlag(bActive);
-
-      for (ezUInt8 j = 0; j < 8; ++j)
-      {
-        pComponent->SetUserFlag(j, (userFlags & EZ_BIT(j)) != 0);
-      }
-
-      EZ_ASSERT_DEBUG(uiComponentIdx == compTypeInfo.m_ComponentIndexToHandle.GetCount(), "Component index doesn't match");
-      compTypeInfo.m_ComponentIndexToHandle.PushBack(hComponent);
+      compTypeInfo.m_ComponentIndexToHandle.PushBack(m_WorldReader.CreateComponent(pManager, compTypeInfo.m_ComponentsToCreate[m_uiCurrentIndex]));
 
       ++m_uiCurrentIndex;
       ++m_uiCurrentNumComponentsProcessed;
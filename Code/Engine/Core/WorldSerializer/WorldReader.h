@@ -76,6 +76,18 @@ public:
     ezHybridArray<ezGameObject*, 8>* out_CreatedRootObjects, ezHybridArray<ezGameObject*, 8>* out_CreatedChildObjects,
     const ezUInt16* pOverrideTeamID, bool bForceDynamic, ezTime maxStepTime = ezTime::Zero(), ezProgress* pProgress = nullptr);
 
+  /// \brief Creates one instance of the world for every given root transform.
+  ///
+  /// This gives the same result as calling InstantiatePrefab() once per transform, but everything that does not depend on the
+  /// instance, e.g. looking up the component managers, is only done once per batch. This is meant for spawning many copies of the same
+  /// prefab at once, like projectiles or debris. All created components are queued for initialization after all instances were created.
+  ///
+  /// The created root and child objects of all instances are appended to out_CreatedRootObjects and out_CreatedChildObjects, if these are
+  /// valid. Each instance adds GetRootObjectCount() root objects and GetChildObjectCount() child objects in the order of rootTransforms.
+  void InstantiatePrefabBatch(ezWorld& world, ezArrayPtr<const ezTransform> rootTransforms, ezGameObjectHandle hParent,
+    ezDynamicArray<ezGameObject*>* out_CreatedRootObjects, ezDynamicArray<ezGameObject*>* out_CreatedChildObjects,
+    const ezUInt16* pOverrideTeamID, bool bForceDynamic);
+
   /// \brief Gives access to the stream of data. Use this inside component deserialization functions to read data.
   ezStreamReader& GetStream() const { return *m_pStream; }
 
@@ -119,10 +131,26 @@ private:
     ezUInt32 m_uiParentHandleIdx;
   };
 
+  struct ComponentToCreate
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiOwnerIndex;
+    bool m_bActive;
+    ezUInt8 m_uiUserFlags;
+  };
+
   void ReadGameObjectDesc(GameObjectToCreate& godesc);
   void ReadComponentTypeInfo(ezUInt32 uiComponentTypeIdx);
+  void ReadComponentCreationData();
   void ReadComponentDataToMemStream();
   void ClearHandles();
+
+  template <bool UseTransform>
+  ezGameObject* CreateGameObject(const GameObjectToCreate& godesc, const ezTransform& rootTransform, ezGameObjectHandle hParent,
+    const ezUInt16* pOverrideTeamID, bool bForceDynamic);
+  ezComponentHandle CreateComponent(ezComponentManagerBase* pManager, const ComponentToCreate& compDesc);
+
   ezUniquePtr<InstantiationContextBase> Instantiate(ezWorld& world, bool bUseTransform, const ezTransform& rootTransform,
     ezGameObjectHandle hParent, ezHybridArray<ezGameObject*, 8>* out_CreatedRootObjects, ezHybridArray<ezGameObject*, 8>* out_CreatedChildObjects,
     const ezUInt16* pOverrideTeamID, bool bForceDynamic, ezTime maxStepTime, ezProgress* pProgress);
@@ -140,12 +168,13 @@ private:
   {
     const ezRTTI* m_pRtti = nullptr;
     ezDynamicArray<ezComponentHandle> m_ComponentIndexToHandle;
-    ezUInt32 m_uiNumComponents = 0;
+
+    /// The creation data is decoded once when the world description is read and used as a template for every instance.
+    ezDynamicArray<ComponentToCreate> m_ComponentsToCreate;
   };
 
   ezDynamicArray<ComponentTypeInfo> m_ComponentTypes;
   ezHashTable<const ezRTTI*, ezUInt32> m_ComponentTypeVersions;
-  ezMemoryStreamStorage m_ComponentCreationStream;
   ezMemoryStreamStorage m_ComponentDataStream;
   ezUInt64 m_uiTotalNumComponents = 0;
 
@@ -40,6 +40,11 @@ const ezTokenizer* ezTokenizedFileCache::Tokenize(const ezString& sFileName, ezA
 {
   EZ_LOCK(m_Mutex);
 
+  // another preprocessor that shares this cache has tokenized the file in the meantime, its tokens may be in use already
+  auto it = m_Cache.Find(sFileName);
+  if (it.IsValid())
+    return &it.Value().m_Tokens;
+
   auto& data = m_Cache[sFileName];
 
   data.m_Timestamp = FileTimeStamp;
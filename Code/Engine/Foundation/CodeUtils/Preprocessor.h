@@ -34,6 +34,9 @@ public:
   ///
   //// The file content is tokenized first and all #line directives are evaluated, to update the line number and file origin for each token.
   /// Any errors are written to the given log.
+  ///
+  /// The cache may be shared by preprocessors that run on different threads. If another thread has stored the same file in the meantime,
+  /// its tokenized data is returned instead, because other preprocessors may already read it. Use Remove() to get a file re-read.
   const ezTokenizer* Tokenize(const ezString& sFileName, ezArrayPtr<const ezUInt8> FileContent, const ezTimestamp& FileTimeStamp, ezLogInterface* pLog);
 
 private:
@@ -161,6 +164,9 @@ public:
   /// Files #included in "" will be appended as relative paths to the path of the file they appeared in.
   void SetFileLocatorFunction(FileLocatorCB LocateAbsFileCB);
 
+  /// \brief The file locator that is used when no other one is set. Custom file locators can forward to it.
+  static ezResult DefaultFileLocator(const char* szCurAbsoluteFile, const char* szIncludeFile, ezPreprocessor::IncludeType IncType, ezStringBuilder& out_sAbsoluteFilePath);
+
   /// \brief Adds a #define to the preprocessor, even before any file is processed.
   ///
   /// This allows to have global macros that are always defined for all processed files, such as the current platform etc.
@@ -249,7 +255,6 @@ private:
 
 private: // *** File Handling ***
   ezResult OpenFile(const char* szFile, const ezTokenizer** pTokenizer);
-  static ezResult DefaultFileLocator(const char* szCurAbsoluteFile, const char* szIncludeFile, ezPreprocessor::IncludeType IncType, ezStringBuilder& out_sAbsoluteFilePath);
   static ezResult DefaultFileOpen(const char* szAbsoluteFile, ezDynamicArray<ezUInt8>& FileContent, ezTimestamp& out_FileModification);
 
   FileOpenCB m_FileOpenCallback;
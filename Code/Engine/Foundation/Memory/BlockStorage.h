@@ -62,6 +62,8 @@ public:
   void Delete(T* pObject);
   void Delete(T* pObject, T*& out_pMovedObject);
 
+  void Reserve(ezUInt32 uiCount);
+
   ezUInt32 GetCount() const;
   Iterator GetIterator(ezUInt32 uiStartIndex = 0, ezUInt32 uiCount = ezInvalidIndex);
   ConstIterator GetIterator(ezUInt32 uiStartIndex = 0, ezUInt32 uiCount = ezInvalidIndex) const;
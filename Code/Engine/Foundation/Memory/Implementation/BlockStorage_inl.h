@@ -197,6 +197,14 @@ void ezBlockStorage<T, BlockSize, StorageType>::Delete(T* pObject, T*& out_pMove
   Delete(pObject, out_pMovedObject, ezTraitInt<StorageType>());
 }
 
+template <typename T, ezUInt32 BlockSize, ezBlockStorageType::Enum StorageType>
+void ezBlockStorage<T, BlockSize, StorageType>::Reserve(ezUInt32 uiCount)
+{
+  // only the block list is reserved, the blocks themselves are still allocated on demand
+  const ezUInt32 uiNumBlocks = (uiCount + ezDataBlock<T, BlockSize>::CAPACITY - 1) / ezDataBlock<T, BlockSize>::CAPACITY;
+  m_Blocks.Reserve(uiNumBlocks);
+}
+
 template <typename T, ezUInt32 BlockSize, ezBlockStorageType::Enum StorageType>
 EZ_ALWAYS_INLINE ezUInt32 ezBlockStorage<T, BlockSize, StorageType>::GetCount() const
 {
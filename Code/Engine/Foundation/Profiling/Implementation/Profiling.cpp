@@ -8,6 +8,7 @@
 #include <Foundation/IO/JSONWriter.h>
 #include <Foundation/Memory/CommonAllocators.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/AtomicInteger.h>
 #include <Foundation/Threading/ThreadUtils.h>
 
 #if EZ_ENABLED(EZ_USE_PROFILING)
@@ -70,6 +71,12 @@ namespace
     virtual ~CpuScopesBufferBase() = default;
 
     ezUInt64 m_uiThreadId = 0;
+
+    /// \brief Incremented by the owning thread right before and right after it adds a scope, so it is odd while the ring buffer is modified.
+    ///
+    /// Half of it is the number of scopes added so far, which allows CaptureIncremental() to determine which scopes are new.
+    ezAtomicInteger64 m_iAddSequence;
+
     bool IsMainThread() const
     {
       return m_uiThreadId == s_MainThreadId;
@@ -113,6 +120,7 @@ namespace
   static ezMutex s_AllCpuScopesMutex;
 
   static GPUScopesBuffer* s_GPUScopes;
+  static ezUInt64 s_uiNumGPUScopesAdded = 0;
 
   static ezEventSubscriptionID s_PluginEventSubscription = 0;
   void PluginEvent(const ezPluginEvent& e)
@@ -450,6 +458,114 @@ ezProfilingSystem::ProfilingData ezProfilingSystem::Capture()
   return profilingData;
 }
 
+// static
+ezProfilingSystem::ProfilingData ezProfilingSystem::CaptureIncremental(CaptureCursor& inout_Cursor)
+{
+  ezProfilingSystem::ProfilingData profilingData;
+
+  profilingData.m_uiFramesThreadID = 1;
+  profilingData.m_uiGPUThreadID = 0;
+#  if EZ_ENABLED(EZ_SUPPORTS_PROCESSES)
+  profilingData.m_uiProcessID = ezProcess::GetCurrentProcessID();
+#  else
+  profilingData.m_uiProcessID = 0;
+#  endif
+
+  {
+    EZ_LOCK(s_ThreadInfosMutex);
+    profilingData.m_ThreadInfos = s_ThreadInfos;
+  }
+
+  {
+    EZ_LOCK(s_AllCpuScopesMutex);
+
+    for (ezUInt32 i = 0; i < s_AllCpuScopes.GetCount(); ++i)
+    {
+      auto& sourceEventBuffer = s_AllCpuScopes[i];
+
+      ezUInt64& uiNumScopesCaptured = inout_Cursor.m_NumCPUScopesCaptured[sourceEventBuffer->m_uiThreadId];
+      CPUScopesBufferFlat targetEventBuffer;
+      targetEventBuffer.m_uiThreadId = sourceEventBuffer->m_uiThreadId;
+
+      // the owning thread keeps adding scopes while we copy, so retry until the copy was done without a concurrent modification,
+      // otherwise the number of added scopes and the buffer content could be off by some scopes, which would then be skipped or returned twice
+      ezUInt64 uiNumScopesAdded = 0;
+      while (true)
+      {
+        const ezInt64 iSequence = sourceEventBuffer->m_iAddSequence;
+        if ((iSequence & 1) != 0)
+          continue;
+
+        uiNumScopesAdded = (ezUInt64)iSequence / 2;
+
+        // the same thread ID might have been reused by a new thread with a new buffer
+        const ezUInt64 uiNumPreviouslyCaptured = (uiNumScopesCaptured > uiNumScopesAdded) ? 0 : uiNumScopesCaptured;
+
+        const ezUInt32 uiSourceCount = sourceEventBuffer->IsMainThread() ? CastToMainThreadEventBuffer(sourceEventBuffer)->m_Data.GetCount() : CastToOtherThreadEventBuffer(sourceEventBuffer)->m_Data.GetCount();
+        const ezUInt32 uiNumNewScopes = (ezUInt32)ezMath::Min<ezUInt64>(uiNumScopesAdded - uiNumPreviouslyCaptured, uiSourceCount);
+
+        targetEventBuffer.m_Data.SetCountUninitialized(uiNumNewScopes);
+
+        for (ezUInt32 j = 0; j < uiNumNewScopes; ++j)
+        {
+          const ezUInt32 uiSourceIndex = uiSourceCount - uiNumNewScopes + j;
+          const CPUScope& sourceEvent = sourceEventBuffer->IsMainThread() ? CastToMainThreadEventBuffer(sourceEventBuffer)->m_Data[uiSourceIndex] : CastToOtherThreadEventBuffer(sourceEventBuffer)->m_Data[uiSourceIndex];
+
+          CPUScope& copiedEvent = targetEventBuffer.m_Data[j];
+          copiedEvent.m_szFunctionName = sourceEvent.m_szFunctionName;
+          copiedEvent.m_BeginTime = sourceEvent.m_BeginTime;
+          copiedEvent.m_EndTime = sourceEvent.m_EndTime;
+          ezStringUtils::Copy(copiedEvent.m_szName, CPUScope::NAME_SIZE, sourceEvent.m_szName);
+        }
+
+        if (sourceEventBuffer->m_iAddSequence == iSequence)
+          break;
+      }
+
+      uiNumScopesCaptured = uiNumScopesAdded;
+
+      if (!targetEventBuffer.m_Data.IsEmpty())
+      {
+        profilingData.m_AllEventBuffers.PushBack(std::move(targetEventBuffer));
+      }
+    }
+  }
+
+  profilingData.m_uiFrameCount = s_uiFrameCount;
+
+  {
+    const ezUInt32 uiNumNewFrames = (ezUInt32)ezMath::Min<ezUInt64>(s_uiFrameCount - ezMath::Min(inout_Cursor.m_uiNumFramesCaptured, s_uiFrameCount), s_FrameStartTimes.GetCount());
+    inout_Cursor.m_uiNumFramesCaptured = s_uiFrameCount;
+
+    profilingData.m_FrameStartTimes.Reserve(uiNumNewFrames);
+    for (ezUInt32 i = s_FrameStartTimes.GetCount() - uiNumNewFrames; i < s_FrameStartTimes.GetCount(); ++i)
+    {
+      profilingData.m_FrameStartTimes.PushBack(s_FrameStartTimes[i]);
+    }
+  }
+
+  if (s_GPUScopes != nullptr)
+  {
+    const ezUInt32 uiNumNewScopes = (ezUInt32)ezMath::Min<ezUInt64>(s_uiNumGPUScopesAdded - ezMath::Min(inout_Cursor.m_uiNumGPUScopesCaptured, s_uiNumGPUScopesAdded), s_GPUScopes->GetCount());
+    inout_Cursor.m_uiNumGPUScopesCaptured = s_uiNumGPUScopesAdded;
+
+    profilingData.m_GPUScopes.Reserve(uiNumNewScopes);
+    for (ezUInt32 i = s_GPUScopes->GetCount() - uiNumNewScopes; i < s_GPUScopes->GetCount(); ++i)
+    {
+      const GPUScope& sourceGpuDat = (*s_GPUScopes)[i];
+
+      GPUScope copiedGpuData;
+      copiedGpuData.m_BeginTime = sourceGpuDat.m_BeginTime;
+      copiedGpuData.m_EndTime = sourceGpuDat.m_EndTime;
+      ezStringUtils::Copy(copiedGpuData.m_szName, GPUScope::NAME_SIZE, sourceGpuDat.m_szName);
+
+      profilingData.m_GPUScopes.PushBack(std::move(copiedGpuData));
+    }
+  }
+
+  return profilingData;
+}
+
 // static
 void ezProfilingSystem::SetDiscardThreshold(ezTime threshold)
 {
@@ -504,6 +620,8 @@ void ezProfilingSystem::AddCPUScope(const char* szName, const char* szFunctionNa
   scope.m_EndTime = endTime;
   ezStringUtils::Copy(scope.m_szName, EZ_ARRAY_SIZE(scope.m_szName), szName);
 
+  pScopes->m_iAddSequence.Increment();
+
   if (ezThreadUtils::IsMainThread())
   {
     auto pMainThreadBuffer = CastToMainThreadEventBuffer(pScopes);
@@ -524,6 +642,8 @@ void ezProfilingSystem::AddCPUScope(const char* szName, const char* szFunctionNa
 
     pOtherThreadBuffer->m_Data.PushBack(scope);
   }
+
+  pScopes->m_iAddSequence.Increment();
 }
 
 // static
@@ -615,6 +735,7 @@ void ezProfilingSystem::AddGPUScope(const char* szName, ezTime beginTime, ezTime
   ezStringUtils::Copy(scope.m_szName, EZ_ARRAY_SIZE(scope.m_szName), szName);
 
   s_GPUScopes->PushBack(scope);
+  ++s_uiNumGPUScopesAdded;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -681,6 +802,11 @@ ezProfilingSystem::ProfilingData ezProfilingSystem::Capture()
   return {};
 }
 
+ezProfilingSystem::ProfilingData ezProfilingSystem::CaptureIncremental(CaptureCursor& inout_Cursor)
+{
+  return {};
+}
+
 void ezProfilingSystem::SetDiscardThreshold(ezTime threshold) {}
 
 void ezProfilingSystem::StartNewFrame() {}
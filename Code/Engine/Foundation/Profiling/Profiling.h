@@ -2,6 +2,7 @@
 
 #include <Foundation/Basics.h>
 #include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Containers/HashTable.h>
 #include <Foundation/Containers/StaticRingBuffer.h>
 #include <Foundation/System/Process.h>
 #include <Foundation/Time/Time.h>
@@ -112,11 +113,29 @@ public:
     ezResult Write(ezStreamWriter& outputStream) const;
   };
 
+  /// \brief Remembers how much data CaptureIncremental() has already returned.
+  ///
+  /// Use one cursor per consumer, e.g. per telemetry stream. A default constructed cursor makes the next call return everything that is
+  /// currently buffered.
+  struct CaptureCursor
+  {
+    ezHashTable<ezUInt64, ezUInt64> m_NumCPUScopesCaptured; ///< Thread ID -> number of scopes that thread has recorded so far
+    ezUInt64 m_uiNumFramesCaptured = 0;
+    ezUInt64 m_uiNumGPUScopesCaptured = 0;
+  };
+
 public:
   static void Clear();
 
   static ProfilingData Capture();
 
+  /// \brief Like Capture(), but only returns the CPU scopes, GPU scopes and frame start times that were recorded since the previous call
+  /// with the same cursor.
+  ///
+  /// This is much cheaper than a full capture when it is done periodically, e.g. to stream profiling data live.
+  /// Data that was already overwritten in the internal ring buffers is skipped.
+  static ProfilingData CaptureIncremental(CaptureCursor& inout_Cursor);
+
   /// \brief Scopes are discarded if their duration is shorter than the specified threshold. Default is 0.1ms.
   static void SetDiscardThreshold(ezTime threshold);
 
@@ -1,8 +1,9 @@
 #pragma once
 
 #include <Foundation/Basics.h>
+#include <Foundation/Containers/DynamicArray.h>
 #include <Foundation/Containers/HybridArray.h>
-#include <Foundation/Math/Declarations.h>
+#include <Foundation/Math/Color.h>
 
 class ezStreamWriter;
 class ezStreamReader;
@@ -114,6 +115,28 @@ public:
   /// \brief Evaluates only the intensity curve.
   void EvaluateIntensity(double x, float& intensity) const;
 
+  /// \brief Samples the gradient at uniformly distributed positions and stores the linear RGBA colors and the intensities in float tables.
+  ///
+  /// The number of samples is doubled, starting at 17, until the tables reproduce the gradient within fMaxError at every control point,
+  /// or until uiMaxSamples would be exceeded. The error is measured per color channel, intensities are compared relative to their magnitude
+  /// once it exceeds 1. EvaluateBaked() and EvaluateBatch() use these tables. They are discarded by Clear() and SortControlPoints() and
+  /// are not serialized.
+  ///
+  /// \note The control points must be sorted.
+  void CreateBakedTable(float fMaxError = 0.002f, ezUInt32 uiMaxSamples = 1025); // [tested]
+
+  /// \brief Returns whether CreateBakedTable() has been called since the control points were last sorted.
+  bool HasBakedTable() const { return !m_BakedColors.IsEmpty(); } // [tested]
+
+  /// \brief Evaluates RGBA (in linear space) and intensity through the baked tables. Falls back to the regular evaluation without them.
+  void EvaluateBaked(float x, ezColor& rgba, float& intensity) const; // [tested]
+
+  /// \brief Evaluates the gradient at all positions. The output arrays must be at least as large as positions.
+  ///
+  /// out_Colors receives RGBA in linear space, the intensity is not applied. out_Intensities may be empty if the intensity is not needed.
+  /// With baked tables the positions are processed four at a time using SIMD, otherwise each position is evaluated individually.
+  void EvaluateBatch(ezArrayPtr<const float> positions, ezArrayPtr<ezColor> out_Colors, ezArrayPtr<float> out_Intensities) const; // [tested]
+
   /// \brief How much heap memory the curve uses.
   ezUInt64 GetHeapMemoryUsage() const;
 
@@ -129,5 +152,11 @@ private:
   ezHybridArray<ColorCP, 8> m_ColorCPs;
   ezHybridArray<AlphaCP, 8> m_AlphaCPs;
   ezHybridArray<IntensityCP, 8> m_IntensityCPs;
+
+  /// Uniform samples of the gradient. The last sample is stored twice, so that interpolation never needs a bounds check.
+  ezDynamicArray<ezColor> m_BakedColors;
+  ezDynamicArray<float> m_BakedIntensities;
+  float m_fBakedMinX = 0.0f;
+  float m_fBakedSamplesPerUnit = 0.0f;
 };
 
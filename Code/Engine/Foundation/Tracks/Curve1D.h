@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Foundation/Basics.h>
+#include <Foundation/Containers/DynamicArray.h>
 #include <Foundation/Containers/HybridArray.h>
 #include <Foundation/Math/Color.h>
 #include <Foundation/Math/Vec2.h>
@@ -130,6 +131,31 @@ public:
 
   const ezHybridArray<ezVec2d, 24>& GetLinearApproximation() const { return m_LinearApproximation; }
 
+  /// \brief Samples the linear approximation at uniformly distributed positions and stores the values in a float table.
+  ///
+  /// The number of samples is doubled, starting at 17, until the table reproduces the linear approximation within fMaxError
+  /// (relative to the value range of the curve), or until uiMaxSamples would be exceeded. Pass 0 as fMaxError to always
+  /// get the highest resolution.
+  /// EvaluateBaked() and EvaluateBatch() use this table, so that they don't need to search for the curve segment.
+  /// The table is discarded when CreateLinearApproximation() or Clear() is called and it is not serialized.
+  ///
+  /// \note CreateLinearApproximation() must have been called first.
+  void CreateBakedTable(double fMaxError = 0.001, ezUInt32 uiMaxSamples = 1025); // [tested]
+
+  /// \brief Returns whether CreateBakedTable() has been called since the last change to the linear approximation.
+  bool HasBakedTable() const { return !m_BakedValues.IsEmpty(); } // [tested]
+
+  /// \brief Returns the number of samples in the baked table.
+  ezUInt32 GetNumBakedSamples() const { return m_BakedValues.IsEmpty() ? 0 : m_BakedValues.GetCount() - 1; }
+
+  /// \brief Evaluates the curve through the baked table. Falls back to Evaluate() when no table has been created.
+  float EvaluateBaked(float position) const; // [tested]
+
+  /// \brief Evaluates the curve at all positions and writes the values to out_Values, which must be at least as large as positions.
+  ///
+  /// With a baked table four values are computed at once using SIMD, otherwise Evaluate() is called for every position.
+  void EvaluateBatch(ezArrayPtr<const float> positions, ezArrayPtr<float> out_Values) const; // [tested]
+
   /// \brief Adjusts the tangents such that the curve cannot make loopings
   void ClampTangents();
 
@@ -163,5 +189,10 @@ private:
   double m_fMinY, m_fMaxY;
   ezHybridArray<ControlPoint, 8> m_ControlPoints;
   ezHybridArray<ezVec2d, 24> m_LinearApproximation;
+
+  /// Uniform samples of the linear approximation. The last sample is stored twice, so that interpolation never needs a bounds check.
+  ezDynamicArray<float> m_BakedValues;
+  float m_fBakedMinX = 0.0f;
+  float m_fBakedSamplesPerUnit = 0.0f;
 };
 
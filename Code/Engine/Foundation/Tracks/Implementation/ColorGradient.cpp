@@ -1,6 +1,7 @@
 #include <FoundationPCH.h>
 
 #include <Foundation/IO/Stream.h>
+#include <Foundation/SimdMath/SimdVec4i.h>
 #include <Foundation/Tracks/ColorGradient.h>
 
 ezColorGradient::ezColorGradient()
@@ -14,6 +15,8 @@ void ezColorGradient::Clear()
   m_ColorCPs.Clear();
   m_AlphaCPs.Clear();
   m_IntensityCPs.Clear();
+  m_BakedColors.Clear();
+  m_BakedIntensities.Clear();
 }
 
 
@@ -84,6 +87,9 @@ void ezColorGradient::SortControlPoints()
   m_AlphaCPs.Sort();
   m_IntensityCPs.Sort();
 
+  m_BakedColors.Clear();
+  m_BakedIntensities.Clear();
+
   PrecomputeLerpNormalizer();
 }
 
@@ -318,9 +324,168 @@ void ezColorGradient::EvaluateIntensity(double x, float& intensity) const
   }
 }
 
+void ezColorGradient::CreateBakedTable(float fMaxError /*= 0.002f*/, ezUInt32 uiMaxSamples /*= 1025*/)
+{
+  m_BakedColors.Clear();
+  m_BakedIntensities.Clear();
+
+  double fMinX, fMaxX;
+  if (!GetExtents(fMinX, fMaxX))
+  {
+    fMinX = 0.0;
+    fMaxX = 0.0;
+  }
+
+  // the error can only be checked where any of the channels has a control point, in between all channels are linear
+  ezHybridArray<float, 24> checkPositions;
+  for (const auto& cp : m_ColorCPs)
+    checkPositions.PushBack((float)cp.m_PosX);
+  for (const auto& cp : m_AlphaCPs)
+    checkPositions.PushBack((float)cp.m_PosX);
+  for (const auto& cp : m_IntensityCPs)
+    checkPositions.PushBack((float)cp.m_PosX);
+
+  auto SampleAt = [this](double x, ezColor& out_Color, float& out_fIntensity) {
+    ezUInt8 alpha;
+    EvaluateColor(x, out_Color);
+    EvaluateAlpha(x, alpha);
+    EvaluateIntensity(x, out_fIntensity);
+    out_Color.a = ezMath::ColorByteToFloat(alpha);
+  };
+
+  ezUInt32 uiNumIntervals = fMaxX > fMinX ? 16 : 1;
+
+  while (true)
+  {
+    const double fStep = (fMaxX - fMinX) / uiNumIntervals;
+
+    m_BakedColors.SetCountUninitialized(uiNumIntervals + 2);
+    m_BakedIntensities.SetCountUninitialized(uiNumIntervals + 2);
+
+    for (ezUInt32 i = 0; i <= uiNumIntervals; ++i)
+    {
+      SampleAt(i < uiNumIntervals ? fMinX + i * fStep : fMaxX, m_BakedColors[i], m_BakedIntensities[i]);
+    }
+
+    m_BakedColors[uiNumIntervals + 1] = m_BakedColors[uiNumIntervals];
+    m_BakedIntensities[uiNumIntervals + 1] = m_BakedIntensities[uiNumIntervals];
+
+    m_fBakedMinX = (float)fMinX;
+    m_fBakedSamplesPerUnit = fMaxX > fMinX ? (float)(uiNumIntervals / (fMaxX - fMinX)) : 0.0f;
+
+    if (fMaxX <= fMinX || uiNumIntervals * 2 + 1 > uiMaxSamples)
+      break;
+
+    float fLargestError = 0.0f;
+    for (float x : checkPositions)
+    {
+      ezColor exactColor, bakedColor;
+      float fExactIntensity, fBakedIntensity;
+      SampleAt(x, exactColor, fExactIntensity);
+      EvaluateBaked(x, bakedColor, fBakedIntensity);
+
+      fLargestError = ezMath::Max(fLargestError, ezMath::Abs(exactColor.r - bakedColor.r), ezMath::Abs(exactColor.g - bakedColor.g));
+      fLargestError = ezMath::Max(fLargestError, ezMath::Abs(exactColor.b - bakedColor.b), ezMath::Abs(exactColor.a - bakedColor.a));
+      fLargestError = ezMath::Max(fLargestError, ezMath::Abs(fExactIntensity - fBakedIntensity) / ezMath::Max(1.0f, ezMath::Abs(fExactIntensity)));
+    }
+
+    if (fLargestError <= fMaxError)
+      break;
+
+    uiNumIntervals *= 2;
+  }
+}
+
+void ezColorGradient::EvaluateBaked(float x, ezColor& rgba, float& intensity) const
+{
+  if (m_BakedColors.IsEmpty())
+  {
+    ezUInt8 alpha;
+    EvaluateColor(x, rgba);
+    EvaluateAlpha(x, alpha);
+    EvaluateIntensity(x, intensity);
+    rgba.a = ezMath::ColorByteToFloat(alpha);
+    return;
+  }
+
+  const float fMaxPos = (float)(m_BakedColors.GetCount() - 2);
+  const float fPos = ezMath::Clamp((x - m_fBakedMinX) * m_fBakedSamplesPerUnit, 0.0f, fMaxPos);
+  const ezUInt32 uiIndex = (ezUInt32)fPos;
+  const float fLerp = fPos - uiIndex;
+
+  rgba = ezMath::Lerp(m_BakedColors[uiIndex], m_BakedColors[uiIndex + 1], fLerp);
+  intensity = ezMath::Lerp(m_BakedIntensities[uiIndex], m_BakedIntensities[uiIndex + 1], fLerp);
+}
+
+void ezColorGradient::EvaluateBatch(ezArrayPtr<const float> positions, ezArrayPtr<ezColor> out_Colors, ezArrayPtr<float> out_Intensities) const
+{
+  const ezUInt32 uiNumPositions = positions.GetCount();
+  const bool bIntensities = !out_Intensities.IsEmpty();
+
+  EZ_ASSERT_DEV(out_Colors.GetCount() >= uiNumPositions, "Output array is too small");
+  EZ_ASSERT_DEV(!bIntensities || out_Intensities.GetCount() >= uiNumPositions, "Output array is too small");
+
+  ezUInt32 i = 0;
+
+  if (!m_BakedColors.IsEmpty())
+  {
+    const ezColor* pColors = m_BakedColors.GetData();
+    const float* pIntensities = m_BakedIntensities.GetData();
+    const ezSimdVec4f vMinX(m_fBakedMinX);
+    const ezSimdVec4f vSamplesPerUnit(m_fBakedSamplesPerUnit);
+    const ezSimdVec4f vMaxPos((float)(m_BakedColors.GetCount() - 2));
+    const ezSimdVec4f vZero = ezSimdVec4f::ZeroVector();
+
+    for (; i + 4 <= uiNumPositions; i += 4)
+    {
+      ezSimdVec4f vPos;
+      vPos.Load<4>(positions.GetPtr() + i);
+      vPos = (vPos - vMinX).CompMul(vSamplesPerUnit).CompMax(vZero).CompMin(vMaxPos);
+
+      const ezSimdVec4i vIndex = ezSimdVec4i::Truncate(vPos);
+      const ezSimdVec4f vLerp = vPos - vIndex.ToFloat();
+
+      const ezUInt32 uiIndex[4] = {(ezUInt32)vIndex.x(), (ezUInt32)vIndex.y(), (ezUInt32)vIndex.z(), (ezUInt32)vIndex.w()};
+
+      float fLerp[4];
+      vLerp.Store<4>(fLerp);
+
+      for (ezUInt32 j = 0; j < 4; ++j)
+      {
+        ezSimdVec4f vLeft, vRight;
+        vLeft.Load<4>(&pColors[uiIndex[j]].r);
+        vRight.Load<4>(&pColors[uiIndex[j] + 1].r);
+
+        ezSimdVec4f::Lerp(vLeft, vRight, ezSimdVec4f(fLerp[j])).Store<4>(&out_Colors[i + j].r);
+      }
+
+      if (bIntensities)
+      {
+        const ezSimdVec4f vLeft(pIntensities[uiIndex[0]], pIntensities[uiIndex[1]], pIntensities[uiIndex[2]], pIntensities[uiIndex[3]]);
+        const ezSimdVec4f vRight(
+          pIntensities[uiIndex[0] + 1], pIntensities[uiIndex[1] + 1], pIntensities[uiIndex[2] + 1], pIntensities[uiIndex[3] + 1]);
+
+        ezSimdVec4f::Lerp(vLeft, vRight, vLerp).Store<4>(out_Intensities.GetPtr() + i);
+      }
+    }
+  }
+
+  for (; i < uiNumPositions; ++i)
+  {
+    float fIntensity;
+    EvaluateBaked(positions[i], out_Colors[i], fIntensity);
+
+    if (bIntensities)
+    {
+      out_Intensities[i] = fIntensity;
+    }
+  }
+}
+
 ezUInt64 ezColorGradient::GetHeapMemoryUsage() const
 {
-  return m_ColorCPs.GetHeapMemoryUsage() + m_AlphaCPs.GetHeapMemoryUsage() + m_IntensityCPs.GetHeapMemoryUsage();
+  return m_ColorCPs.GetHeapMemoryUsage() + m_AlphaCPs.GetHeapMemoryUsage() + m_IntensityCPs.GetHeapMemoryUsage() +
+         m_BakedColors.GetHeapMemoryUsage() + m_BakedIntensities.GetHeapMemoryUsage();
 }
 
 void ezColorGradient::Save(ezStreamWriter& stream) const
@@ -426,6 +591,9 @@ void ezColorGradient::Load(ezStreamReader& stream)
     }
   }
 
+  m_BakedColors.Clear();
+  m_BakedIntensities.Clear();
+
   PrecomputeLerpNormalizer();
 }
 
@@ -1,6 +1,7 @@
 #include <FoundationPCH.h>
 
 #include <Foundation/IO/Stream.h>
+#include <Foundation/SimdMath/SimdVec4i.h>
 #include <Foundation/Tracks/Curve1D.h>
 
 ezCurve1D::ControlPoint::ControlPoint()
@@ -24,6 +25,7 @@ void ezCurve1D::Clear()
   m_fMaxY = 0;
 
   m_ControlPoints.Clear();
+  m_BakedValues.Clear();
 }
 
 bool ezCurve1D::IsEmpty() const
@@ -165,9 +167,70 @@ double ezCurve1D::NormalizeValue(double value) const
   return (value - fMin) / (fMax - fMin);
 }
 
+float ezCurve1D::EvaluateBaked(float x) const
+{
+  if (m_BakedValues.IsEmpty())
+    return (float)Evaluate(x);
+
+  const float fMaxPos = (float)(m_BakedValues.GetCount() - 2);
+  const float fPos = ezMath::Clamp((x - m_fBakedMinX) * m_fBakedSamplesPerUnit, 0.0f, fMaxPos);
+  const ezUInt32 uiIndex = (ezUInt32)fPos;
+
+  return ezMath::Lerp(m_BakedValues[uiIndex], m_BakedValues[uiIndex + 1], fPos - uiIndex);
+}
+
+void ezCurve1D::EvaluateBatch(ezArrayPtr<const float> positions, ezArrayPtr<float> out_Values) const
+{
+  EZ_ASSERT_DEV(out_Values.GetCount() >= positions.GetCount(), "Output array is too small");
+
+  const ezUInt32 uiNumPositions = positions.GetCount();
+
+  if (m_BakedValues.IsEmpty())
+  {
+    for (ezUInt32 i = 0; i < uiNumPositions; ++i)
+    {
+      out_Values[i] = (float)Evaluate(positions[i]);
+    }
+
+    return;
+  }
+
+  const float* pBaked = m_BakedValues.GetData();
+  const ezSimdVec4f vMinX(m_fBakedMinX);
+  const ezSimdVec4f vSamplesPerUnit(m_fBakedSamplesPerUnit);
+  const ezSimdVec4f vMaxPos((float)(m_BakedValues.GetCount() - 2));
+  const ezSimdVec4f vZero = ezSimdVec4f::ZeroVector();
+
+  ezUInt32 i = 0;
+  for (; i + 4 <= uiNumPositions; i += 4)
+  {
+    ezSimdVec4f vPos;
+    vPos.Load<4>(positions.GetPtr() + i);
+    vPos = (vPos - vMinX).CompMul(vSamplesPerUnit).CompMax(vZero).CompMin(vMaxPos);
+
+    const ezSimdVec4i vIndex = ezSimdVec4i::Truncate(vPos);
+    const ezSimdVec4f vLerp = vPos - vIndex.ToFloat();
+
+    const ezUInt32 i0 = vIndex.x();
+    const ezUInt32 i1 = vIndex.y();
+    const ezUInt32 i2 = vIndex.z();
+    const ezUInt32 i3 = vIndex.w();
+
+    const ezSimdVec4f vLeft(pBaked[i0], pBaked[i1], pBaked[i2], pBaked[i3]);
+    const ezSimdVec4f vRight(pBaked[i0 + 1], pBaked[i1 + 1], pBaked[i2 + 1], pBaked[i3 + 1]);
+
+    ezSimdVec4f::Lerp(vLeft, vRight, vLerp).Store<4>(out_Values.GetPtr() + i);
+  }
+
+  for (; i < uiNumPositions; ++i)
+  {
+    out_Values[i] = EvaluateBaked(positions[i]);
+  }
+}
+
 ezUInt64 ezCurve1D::GetHeapMemoryUsage() const
 {
-  return m_ControlPoints.GetHeapMemoryUsage();
+  return m_ControlPoints.GetHeapMemoryUsage() + m_BakedValues.GetHeapMemoryUsage();
 }
 
 void ezCurve1D::Save(ezStreamWriter& stream) const
@@ -202,6 +265,7 @@ void ezCurve1D::Load(ezStreamReader& stream)
   stream >> numCp;
 
   m_ControlPoints.SetCountUninitialized(numCp);
+  m_BakedValues.Clear();
 
   if (uiVersion <= 2)
   {
@@ -238,6 +302,7 @@ void ezCurve1D::Load(ezStreamReader& stream)
 void ezCurve1D::CreateLinearApproximation(double fMaxError /*= 0.01f*/, ezUInt8 uiMaxSubDivs /*= 8*/)
 {
   m_LinearApproximation.Clear();
+  m_BakedValues.Clear();
 
   /// \todo Since we do this, we actually don't need the linear approximation anymore and could just evaluate the full curve
   ApplyTangentModes();
@@ -274,6 +339,64 @@ void ezCurve1D::CreateLinearApproximation(double fMaxError /*= 0.01f*/, ezUInt8
   RecomputeLinearApproxExtremes();
 }
 
+void ezCurve1D::CreateBakedTable(double fMaxError /*= 0.001*/, ezUInt32 uiMaxSamples /*= 1025*/)
+{
+  EZ_ASSERT_DEV(!m_LinearApproximation.IsEmpty(), "CreateLinearApproximation() must be called before CreateBakedTable()");
+
+  m_BakedValues.Clear();
+
+  const double fMinX = m_LinearApproximation[0].x;
+  const double fMaxX = m_LinearApproximation.PeekBack().x;
+
+  if (fMaxX <= fMinX)
+  {
+    // constant curve, a single interval is enough
+    const float fValue = (float)Evaluate(fMinX);
+    m_BakedValues.SetCount(3, fValue);
+    m_fBakedMinX = (float)fMinX;
+    m_fBakedSamplesPerUnit = 0.0f;
+    return;
+  }
+
+  const double fMaxErrorY = fMaxError * ezMath::Max(0.1, m_fMaxY - m_fMinY);
+
+  ezUInt32 uiNumIntervals = 16;
+
+  while (true)
+  {
+    const double fStep = (fMaxX - fMinX) / uiNumIntervals;
+
+    m_BakedValues.SetCountUninitialized(uiNumIntervals + 2);
+
+    for (ezUInt32 i = 0; i < uiNumIntervals; ++i)
+    {
+      m_BakedValues[i] = (float)Evaluate(fMinX + i * fStep);
+    }
+
+    m_BakedValues[uiNumIntervals] = (float)m_LinearApproximation.PeekBack().y;
+    m_BakedValues[uiNumIntervals + 1] = m_BakedValues[uiNumIntervals];
+
+    m_fBakedMinX = (float)fMinX;
+    m_fBakedSamplesPerUnit = (float)(uiNumIntervals / (fMaxX - fMinX));
+
+    if (uiNumIntervals * 2 + 1 > uiMaxSamples)
+      break;
+
+    // both the table and the linear approximation are piecewise linear and all samples lie on the approximation,
+    // so the largest difference can only occur at the points of the approximation
+    double fLargestError = 0.0;
+    for (const ezVec2d& point : m_LinearApproximation)
+    {
+      fLargestError = ezMath::Max(fLargestError, ezMath::Abs(EvaluateBaked((float)point.x) - point.y));
+    }
+
+    if (fLargestError <= fMaxErrorY)
+      break;
+
+    uiNumIntervals *= 2;
+  }
+}
+
 void ezCurve1D::RecomputeExtents()
 {
   m_fMinX = ezMath::MaxValue<float>();
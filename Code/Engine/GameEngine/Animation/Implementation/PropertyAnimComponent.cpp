@@ -140,6 +140,10 @@ void ezPropertyAnimComponent::CreatePropertyBindings()
   m_ColorBindings.Clear();
   m_ComponentFloatBindings.Clear();
   m_GoFloatBindings.Clear();
+  m_UsedFloatAnims.Clear();
+  m_UsedColorAnims.Clear();
+  m_FloatAnimValues.Clear();
+  m_ColorAnimValues.Clear();
 
   m_AnimDesc = nullptr;
 
@@ -153,58 +157,193 @@ void ezPropertyAnimComponent::CreatePropertyBindings()
 
   m_AnimDesc = pAnimation->GetDescriptor();
 
-  for (const ezFloatPropertyAnimEntry& anim : m_AnimDesc->m_FloatAnimations)
+  m_FloatAnimValues.SetCount(m_AnimDesc->m_FloatAnimations.GetCount());
+  m_ColorAnimValues.SetCount(m_AnimDesc->m_ColorAnimations.GetCount());
+
+  ezMap<BindingKey, ezUInt32> goBindingIndices;
+  ezMap<BindingKey, ezUInt32> componentBindingIndices;
+  ezHybridArray<ezGameObject*, 8> targets;
+
+  for (ezUInt32 uiAnim = 0; uiAnim < m_AnimDesc->m_FloatAnimations.GetCount(); ++uiAnim)
   {
-    ezHybridArray<ezGameObject*, 8> targets;
+    const ezFloatPropertyAnimEntry& anim = m_AnimDesc->m_FloatAnimations[uiAnim];
+
+    // an empty curve never changes the property
+    if (anim.m_Curve.IsEmpty())
+      continue;
+
+    targets.Clear();
     GetOwner()->SearchForChildrenByNameSequence(anim.m_sObjectSearchSequence, anim.m_pComponentRtti, targets);
 
+    PropertyLookup lookup;
+
     for (ezGameObject* pTargetObject : targets)
     {
       // allow to animate properties on the ezGameObject
       if (anim.m_pComponentRtti == nullptr)
       {
-        CreateGameObjectBinding(&anim, ezGetStaticRTTI<ezGameObject>(), pTargetObject, pTargetObject->GetHandle());
+        CreateGameObjectBinding(uiAnim, lookup, ezGetStaticRTTI<ezGameObject>(), pTargetObject, pTargetObject->GetHandle(), goBindingIndices);
       }
       else
       {
         ezComponent* pComp;
         if (pTargetObject->TryGetComponentOfBaseType(anim.m_pComponentRtti, pComp))
         {
-          CreateFloatPropertyBinding(&anim, pComp->GetDynamicRTTI(), pComp, pComp->GetHandle());
+          CreateFloatPropertyBinding(uiAnim, lookup, pComp->GetDynamicRTTI(), pComp, pComp->GetHandle(), componentBindingIndices);
         }
       }
     }
   }
 
-  for (const ezColorPropertyAnimEntry& anim : m_AnimDesc->m_ColorAnimations)
+  for (ezUInt32 uiAnim = 0; uiAnim < m_AnimDesc->m_ColorAnimations.GetCount(); ++uiAnim)
   {
-    ezHybridArray<ezGameObject*, 8> targets;
+    const ezColorPropertyAnimEntry& anim = m_AnimDesc->m_ColorAnimations[uiAnim];
+
+    targets.Clear();
     GetOwner()->SearchForChildrenByNameSequence(anim.m_sObjectSearchSequence, anim.m_pComponentRtti, targets);
 
+    PropertyLookup lookup;
+
     for (ezGameObject* pTargetObject : targets)
     {
       ezComponent* pComp;
       if (pTargetObject->TryGetComponentOfBaseType(anim.m_pComponentRtti, pComp))
       {
-        CreateColorPropertyBinding(&anim, pComp->GetDynamicRTTI(), pComp, pComp->GetHandle());
+        CreateColorPropertyBinding(uiAnim, lookup, pComp->GetDynamicRTTI(), pComp, pComp->GetHandle());
       }
     }
   }
+
+  // only evaluate the animations that ended up with a target
+  {
+    ezDynamicArray<bool> usedFloatAnims;
+    usedFloatAnims.SetCount(m_FloatAnimValues.GetCount());
+
+    for (const FloatBinding& binding : m_ComponentFloatBindings)
+    {
+      for (ezUInt32 uiAnim : binding.m_uiAnimation)
+      {
+        if (uiAnim != ezInvalidIndex)
+          usedFloatAnims[uiAnim] = true;
+      }
+    }
+
+    for (const FloatBinding& binding : m_GoFloatBindings)
+    {
+      for (ezUInt32 uiAnim : binding.m_uiAnimation)
+      {
+        if (uiAnim != ezInvalidIndex)
+          usedFloatAnims[uiAnim] = true;
+      }
+    }
+
+    for (ezUInt32 uiAnim = 0; uiAnim < usedFloatAnims.GetCount(); ++uiAnim)
+    {
+      if (usedFloatAnims[uiAnim])
+        m_UsedFloatAnims.PushBack(uiAnim);
+    }
+
+    ezDynamicArray<bool> usedColorAnims;
+    usedColorAnims.SetCount(m_ColorAnimValues.GetCount());
+
+    for (const ColorBinding& binding : m_ColorBindings)
+    {
+      usedColorAnims[binding.m_uiAnimation] = true;
+    }
+
+    for (ezUInt32 uiAnim = 0; uiAnim < usedColorAnims.GetCount(); ++uiAnim)
+    {
+      if (usedColorAnims[uiAnim])
+        m_UsedColorAnims.PushBack(uiAnim);
+    }
+  }
 }
 
-void ezPropertyAnimComponent::CreateGameObjectBinding(const ezFloatPropertyAnimEntry* pAnim, const ezRTTI* pOwnerRtti, void* pObject,
-  const ezGameObjectHandle& hGameObject)
+namespace
 {
-  if (pAnim->m_Target < ezPropertyAnimTarget::Number || pAnim->m_Target > ezPropertyAnimTarget::RotationZ)
-    return;
+  template <typename T>
+  void SetNumberProperty(ezAbstractMemberProperty* pProperty, void* pObject, double fValue)
+  {
+    static_cast<ezTypedMemberProperty<T>*>(pProperty)->SetValue(pObject, static_cast<T>(fValue));
+  }
 
-  ezAbstractProperty* pAbstract = pOwnerRtti->FindPropertyByName(pAnim->m_sPropertyPath);
+  void SetBoolProperty(ezAbstractMemberProperty* pProperty, void* pObject, double fValue)
+  {
+    static_cast<ezTypedMemberProperty<bool>*>(pProperty)->SetValue(pObject, fValue < 0.5);
+  }
+
+  void SetAngleProperty(ezAbstractMemberProperty* pProperty, void* pObject, double fValue)
+  {
+    static_cast<ezTypedMemberProperty<ezAngle>*>(pProperty)->SetValue(pObject, ezAngle::Degree((float)fValue));
+  }
+
+  void SetTimeProperty(ezAbstractMemberProperty* pProperty, void* pObject, double fValue)
+  {
+    static_cast<ezTypedMemberProperty<ezTime>*>(pProperty)->SetValue(pObject, ezTime::Seconds(fValue));
+  }
+} // namespace
+
+ezPropertyAnimNumberSetter::SetterFunc ezPropertyAnimNumberSetter::FindSetter(const ezRTTI* pPropertyType)
+{
+  if (pPropertyType == ezGetStaticRTTI<float>())
+    return &SetNumberProperty<float>;
+  if (pPropertyType == ezGetStaticRTTI<double>())
+    return &SetNumberProperty<double>;
+  if (pPropertyType == ezGetStaticRTTI<bool>())
+    return &SetBoolProperty;
+  if (pPropertyType == ezGetStaticRTTI<ezInt8>())
+    return &SetNumberProperty<ezInt8>;
+  if (pPropertyType == ezGetStaticRTTI<ezUInt8>())
+    return &SetNumberProperty<ezUInt8>;
+  if (pPropertyType == ezGetStaticRTTI<ezInt16>())
+    return &SetNumberProperty<ezInt16>;
+  if (pPropertyType == ezGetStaticRTTI<ezUInt16>())
+    return &SetNumberProperty<ezUInt16>;
+  if (pPropertyType == ezGetStaticRTTI<ezInt32>())
+    return &SetNumberProperty<ezInt32>;
+  if (pPropertyType == ezGetStaticRTTI<ezUInt32>())
+    return &SetNumberProperty<ezUInt32>;
+  if (pPropertyType == ezGetStaticRTTI<ezInt64>())
+    return &SetNumberProperty<ezInt64>;
+  if (pPropertyType == ezGetStaticRTTI<ezUInt64>())
+    return &SetNumberProperty<ezUInt64>;
+  if (pPropertyType == ezGetStaticRTTI<ezAngle>())
+    return &SetAngleProperty;
+  if (pPropertyType == ezGetStaticRTTI<ezTime>())
+    return &SetTimeProperty;
+
+  return nullptr;
+}
+
+ezAbstractMemberProperty* ezPropertyAnimComponent::FindMemberProperty(PropertyLookup& lookup, const ezRTTI* pOwnerRtti, const ezPropertyAnimEntry& anim)
+{
+  if (lookup.m_pOwnerRtti == pOwnerRtti)
+    return lookup.m_pMember;
+
+  lookup.m_pOwnerRtti = pOwnerRtti;
+  lookup.m_pMember = nullptr;
+
+  ezAbstractProperty* pAbstract = pOwnerRtti->FindPropertyByName(anim.m_sPropertyPath);
 
   // we only support direct member properties at this time, so no arrays or other complex structures
-  if (pAbstract == nullptr || pAbstract->GetCategory() != ezPropertyCategory::Member)
+  if (pAbstract == nullptr || pAbstract->GetCategory() != ezPropertyCategory::Member || pAbstract->GetFlags().IsSet(ezPropertyFlags::ReadOnly))
+    return nullptr;
+
+  lookup.m_pMember = static_cast<ezAbstractMemberProperty*>(pAbstract);
+  return lookup.m_pMember;
+}
+
+void ezPropertyAnimComponent::CreateGameObjectBinding(ezUInt32 uiAnim, PropertyLookup& lookup, const ezRTTI* pOwnerRtti, void* pObject,
+  const ezGameObjectHandle& hGameObject, ezMap<BindingKey, ezUInt32>& bindingIndices)
+{
+  const ezFloatPropertyAnimEntry* pAnim = &m_AnimDesc->m_FloatAnimations[uiAnim];
+
+  if (pAnim->m_Target < ezPropertyAnimTarget::Number || pAnim->m_Target > ezPropertyAnimTarget::RotationZ)
     return;
 
-  ezAbstractMemberProperty* pMember = static_cast<ezAbstractMemberProperty*>(pAbstract);
+  ezAbstractMemberProperty* pMember = FindMemberProperty(lookup, pOwnerRtti, *pAnim);
+  if (pMember == nullptr)
+    return;
 
   const ezRTTI* pPropRtti = pMember->GetSpecificType();
 
@@ -226,137 +365,101 @@ void ezPropertyAnimComponent::CreateGameObjectBinding(const ezFloatPropertyAnimE
       return;
   }
 
-  GameObjectBinding* binding = nullptr;
-  for (ezUInt32 i = 0; i < m_GoFloatBindings.GetCount(); ++i)
-  {
-    auto& b = m_GoFloatBindings[i];
-
-    if (b.m_hObject == hGameObject && b.m_pMemberProperty == pMember && b.m_pObject == pObject)
-    {
-      binding = &b;
-      break;
-    }
-  }
+  bool bExisted = false;
+  auto it = bindingIndices.FindOrAdd(BindingKey{pObject, pMember}, &bExisted);
 
-  if (binding == nullptr)
+  if (!bExisted)
   {
-    binding = &m_GoFloatBindings.ExpandAndGetRef();
+    it.Value() = m_GoFloatBindings.GetCount();
+    m_GoFloatBindings.ExpandAndGetRef();
   }
 
+  GameObjectBinding* binding = &m_GoFloatBindings[it.Value()];
   binding->m_hObject = hGameObject;
   binding->m_pObject = pObject;
   binding->m_pMemberProperty = pMember;
 
-  // we can store a direct pointer here, because our sharedptr keeps the descriptor alive
-
   if (pAnim->m_Target >= ezPropertyAnimTarget::VectorX && pAnim->m_Target <= ezPropertyAnimTarget::VectorW)
   {
-    binding->m_pAnimation[(int)pAnim->m_Target - (int)ezPropertyAnimTarget::VectorX] = pAnim;
+    binding->m_uiAnimation[(int)pAnim->m_Target - (int)ezPropertyAnimTarget::VectorX] = uiAnim;
   }
   else if (pAnim->m_Target >= ezPropertyAnimTarget::RotationX && pAnim->m_Target <= ezPropertyAnimTarget::RotationZ)
   {
-    binding->m_pAnimation[(int)pAnim->m_Target - (int)ezPropertyAnimTarget::RotationX] = pAnim;
-  }
-  else if (pAnim->m_Target >= ezPropertyAnimTarget::Number)
-  {
-    binding->m_pAnimation[0] = pAnim;
+    binding->m_uiAnimation[(int)pAnim->m_Target - (int)ezPropertyAnimTarget::RotationX] = uiAnim;
   }
   else
   {
-    EZ_REPORT_FAILURE("Invalid animation target type '{0}'", pAnim->m_Target.GetValue());
+    binding->m_uiAnimation[0] = uiAnim;
+    binding->m_NumberSetter = ezPropertyAnimNumberSetter::FindSetter(pPropRtti);
   }
 }
 
-void ezPropertyAnimComponent::CreateFloatPropertyBinding(const ezFloatPropertyAnimEntry* pAnim, const ezRTTI* pOwnerRtti, void* pObject,
-  const ezComponentHandle& hComponent)
+void ezPropertyAnimComponent::CreateFloatPropertyBinding(ezUInt32 uiAnim, PropertyLookup& lookup, const ezRTTI* pOwnerRtti, void* pObject,
+  const ezComponentHandle& hComponent, ezMap<BindingKey, ezUInt32>& bindingIndices)
 {
+  const ezFloatPropertyAnimEntry* pAnim = &m_AnimDesc->m_FloatAnimations[uiAnim];
+
   if (pAnim->m_Target < ezPropertyAnimTarget::Number || pAnim->m_Target > ezPropertyAnimTarget::VectorW)
     return;
 
-  ezAbstractProperty* pAbstract = pOwnerRtti->FindPropertyByName(pAnim->m_sPropertyPath);
-
-  // we only support direct member properties at this time, so no arrays or other complex structures
-  if (pAbstract == nullptr || pAbstract->GetCategory() != ezPropertyCategory::Member)
+  ezAbstractMemberProperty* pMember = FindMemberProperty(lookup, pOwnerRtti, *pAnim);
+  if (pMember == nullptr)
     return;
 
-  ezAbstractMemberProperty* pMember = static_cast<ezAbstractMemberProperty*>(pAbstract);
-
   const ezRTTI* pPropRtti = pMember->GetSpecificType();
+  ezPropertyAnimNumberSetter::SetterFunc numberSetter = nullptr;
 
   if (pAnim->m_Target == ezPropertyAnimTarget::Number)
   {
-    if (pPropRtti != ezGetStaticRTTI<float>() && pPropRtti != ezGetStaticRTTI<double>() && pPropRtti != ezGetStaticRTTI<bool>() &&
-        pPropRtti != ezGetStaticRTTI<ezInt64>() && pPropRtti != ezGetStaticRTTI<ezInt32>() && pPropRtti != ezGetStaticRTTI<ezInt16>() &&
-        pPropRtti != ezGetStaticRTTI<ezInt8>() && pPropRtti != ezGetStaticRTTI<ezUInt64>() && pPropRtti != ezGetStaticRTTI<ezUInt32>() &&
-        pPropRtti != ezGetStaticRTTI<ezUInt16>() && pPropRtti != ezGetStaticRTTI<ezUInt8>() && pPropRtti != ezGetStaticRTTI<ezAngle>() &&
-        pPropRtti != ezGetStaticRTTI<ezTime>())
-      return;
-  }
-  else if (pAnim->m_Target >= ezPropertyAnimTarget::VectorX && pAnim->m_Target <= ezPropertyAnimTarget::VectorW)
-  {
-    if (pPropRtti != ezGetStaticRTTI<ezVec2>() && pPropRtti != ezGetStaticRTTI<ezVec3>() && pPropRtti != ezGetStaticRTTI<ezVec4>())
+    numberSetter = ezPropertyAnimNumberSetter::FindSetter(pPropRtti);
+
+    if (numberSetter == nullptr)
       return;
   }
   else
   {
     // Quaternions are not supported for regular types
-    return;
+    if (pPropRtti != ezGetStaticRTTI<ezVec2>() && pPropRtti != ezGetStaticRTTI<ezVec3>() && pPropRtti != ezGetStaticRTTI<ezVec4>())
+      return;
   }
 
-  ComponentFloatBinding* binding = nullptr;
-  for (ezUInt32 i = 0; i < m_ComponentFloatBindings.GetCount(); ++i)
-  {
-    auto& b = m_ComponentFloatBindings[i];
-
-    if (b.m_hComponent == hComponent && b.m_pMemberProperty == pMember && b.m_pObject == pObject)
-    {
-      binding = &b;
-      break;
-    }
-  }
+  bool bExisted = false;
+  auto it = bindingIndices.FindOrAdd(BindingKey{pObject, pMember}, &bExisted);
 
-  if (binding == nullptr)
+  if (!bExisted)
   {
-    binding = &m_ComponentFloatBindings.ExpandAndGetRef();
+    it.Value() = m_ComponentFloatBindings.GetCount();
+    m_ComponentFloatBindings.ExpandAndGetRef();
   }
 
+  ComponentFloatBinding* binding = &m_ComponentFloatBindings[it.Value()];
   binding->m_hComponent = hComponent;
   binding->m_pObject = pObject;
   binding->m_pMemberProperty = pMember;
 
-  // we can store a direct pointer here, because our sharedptr keeps the descriptor alive
-  if (pAnim->m_Target >= ezPropertyAnimTarget::VectorX && pAnim->m_Target <= ezPropertyAnimTarget::VectorW)
+  if (numberSetter != nullptr)
   {
-    binding->m_pAnimation[(int)pAnim->m_Target - (int)ezPropertyAnimTarget::VectorX] = pAnim;
-  }
-  else if (pAnim->m_Target >= ezPropertyAnimTarget::RotationX && pAnim->m_Target <= ezPropertyAnimTarget::RotationZ)
-  {
-    binding->m_pAnimation[(int)pAnim->m_Target - (int)ezPropertyAnimTarget::RotationX] = pAnim;
-  }
-  else if (pAnim->m_Target >= ezPropertyAnimTarget::Number)
-  {
-    binding->m_pAnimation[0] = pAnim;
+    binding->m_uiAnimation[0] = uiAnim;
+    binding->m_NumberSetter = numberSetter;
   }
   else
   {
-    EZ_REPORT_FAILURE("Invalid animation target type '{0}'", pAnim->m_Target.GetValue());
+    binding->m_uiAnimation[(int)pAnim->m_Target - (int)ezPropertyAnimTarget::VectorX] = uiAnim;
   }
 }
 
-void ezPropertyAnimComponent::CreateColorPropertyBinding(const ezColorPropertyAnimEntry* pAnim, const ezRTTI* pOwnerRtti, void* pObject,
-  const ezComponentHandle& hComponent)
+void ezPropertyAnimComponent::CreateColorPropertyBinding(
+  ezUInt32 uiAnim, PropertyLookup& lookup, const ezRTTI* pOwnerRtti, void* pObject, const ezComponentHandle& hComponent)
 {
+  const ezColorPropertyAnimEntry* pAnim = &m_AnimDesc->m_ColorAnimations[uiAnim];
+
   if (pAnim->m_Target != ezPropertyAnimTarget::Color)
     return;
 
-  ezAbstractProperty* pAbstract = pOwnerRtti->FindPropertyByName(pAnim->m_sPropertyPath);
-
-  // we only support direct member properties at this time, so no arrays or other complex structures
-  if (pAbstract == nullptr || pAbstract->GetCategory() != ezPropertyCategory::Member)
+  ezAbstractMemberProperty* pMember = FindMemberProperty(lookup, pOwnerRtti, *pAnim);
+  if (pMember == nullptr)
     return;
 
-  ezAbstractMemberProperty* pMember = static_cast<ezAbstractMemberProperty*>(pAbstract);
-
   const ezRTTI* pPropRtti = pMember->GetSpecificType();
 
   if (pPropRtti != ezGetStaticRTTI<ezColor>() && pPropRtti != ezGetStaticRTTI<ezColorGammaUB>())
@@ -365,7 +468,7 @@ void ezPropertyAnimComponent::CreateColorPropertyBinding(const ezColorPropertyAn
   ColorBinding& binding = m_ColorBindings.ExpandAndGetRef();
   binding.m_hComponent = hComponent;
   binding.m_pObject = pObject;
-  binding.m_pAnimation = pAnim; // we can store a direct pointer here, because our SharedPtr keeps the descriptor alive
+  binding.m_uiAnimation = uiAnim;
   binding.m_pMemberProperty = pMember;
 }
 
@@ -376,6 +479,8 @@ void ezPropertyAnimComponent::ApplyAnimations(const ezTime& tDiff)
 
   const ezTime fLookupPos = ComputeAnimationLookup(tDiff);
 
+  EvaluateAnimations(fLookupPos);
+
   for (ezUInt32 i = 0; i < m_ComponentFloatBindings.GetCount();)
   {
     const auto& binding = m_ComponentFloatBindings[i];
@@ -394,7 +499,7 @@ void ezPropertyAnimComponent::ApplyAnimations(const ezTime& tDiff)
       binding.m_pObject = static_cast<void*>(pComponent);
     }
 
-    ApplyFloatAnimation(m_ComponentFloatBindings[i], fLookupPos);
+    ApplyFloatAnimation(m_ComponentFloatBindings[i]);
 
     ++i;
   }
@@ -418,7 +523,7 @@ void ezPropertyAnimComponent::ApplyAnimations(const ezTime& tDiff)
       binding.m_pObject = static_cast<void*>(pComponent);
     }
 
-    ApplyColorAnimation(m_ColorBindings[i], fLookupPos);
+    ApplyColorAnimation(m_ColorBindings[i]);
 
     ++i;
   }
@@ -441,12 +546,28 @@ void ezPropertyAnimComponent::ApplyAnimations(const ezTime& tDiff)
       binding.m_pObject = static_cast<void*>(pObject);
     }
 
-    ApplyFloatAnimation(m_GoFloatBindings[i], fLookupPos);
+    ApplyFloatAnimation(m_GoFloatBindings[i]);
 
     ++i;
   }
 }
 
+void ezPropertyAnimComponent::EvaluateAnimations(ezTime lookupTime)
+{
+  const float fLookupTime = lookupTime.AsFloatInSeconds();
+
+  for (ezUInt32 uiAnim : m_UsedFloatAnims)
+  {
+    m_FloatAnimValues[uiAnim] = m_AnimDesc->m_FloatAnimations[uiAnim].m_Curve.EvaluateBaked(fLookupTime);
+  }
+
+  for (ezUInt32 uiAnim : m_UsedColorAnims)
+  {
+    ColorValue& value = m_ColorAnimValues[uiAnim];
+    m_AnimDesc->m_ColorAnimations[uiAnim].m_Gradient.EvaluateBaked(fLookupTime, value.m_Color, value.m_fIntensity);
+  }
+}
+
 ezTime ezPropertyAnimComponent::ComputeAnimationLookup(ezTime tDiff)
 {
   const ezTime duration = m_AnimationRangeHigh - m_AnimationRangeLow;
@@ -618,55 +739,11 @@ void ezPropertyAnimComponent::StartPlayback()
   }
 }
 
-void ezPropertyAnimComponent::ApplySingleFloatAnimation(const FloatBinding& binding, ezTime lookupTime)
-{
-  const ezRTTI* pRtti = binding.m_pMemberProperty->GetSpecificType();
-
-  double fFinalValue = 0;
-  {
-    const ezCurve1D& curve = binding.m_pAnimation[0]->m_Curve;
-
-    if (curve.IsEmpty())
-      return;
-
-    fFinalValue = curve.Evaluate(lookupTime.GetSeconds());
-  }
-
-  if (pRtti == ezGetStaticRTTI<bool>())
-  {
-    ezTypedMemberProperty<bool>* pTyped = static_cast<ezTypedMemberProperty<bool>*>(binding.m_pMemberProperty);
-
-    pTyped->SetValue(binding.m_pObject, fFinalValue < 0.5);
-    return;
-  }
-  else if (pRtti == ezGetStaticRTTI<ezAngle>())
-  {
-    ezTypedMemberProperty<ezAngle>* pTyped = static_cast<ezTypedMemberProperty<ezAngle>*>(binding.m_pMemberProperty);
-
-    pTyped->SetValue(binding.m_pObject, ezAngle::Degree((float)fFinalValue));
-    return;
-  }
-  else if (pRtti == ezGetStaticRTTI<ezTime>())
-  {
-    ezTypedMemberProperty<ezTime>* pTyped = static_cast<ezTypedMemberProperty<ezTime>*>(binding.m_pMemberProperty);
-
-    pTyped->SetValue(binding.m_pObject, ezTime::Seconds(fFinalValue));
-    return;
-  }
-
-  // this handles float, double, all int types, etc.
-  ezVariant value = fFinalValue;
-  if (pRtti->GetVariantType() != ezVariantType::Invalid && value.CanConvertTo(pRtti->GetVariantType()))
-  {
-    ezReflectionUtils::SetMemberPropertyValue(binding.m_pMemberProperty, binding.m_pObject, value);
-  }
-}
-
-void ezPropertyAnimComponent::ApplyFloatAnimation(const FloatBinding& binding, ezTime lookupTime)
+void ezPropertyAnimComponent::ApplyFloatAnimation(const FloatBinding& binding)
 {
-  if (binding.m_pAnimation[0] != nullptr && binding.m_pAnimation[0]->m_Target == ezPropertyAnimTarget::Number)
+  if (binding.m_NumberSetter != nullptr)
   {
-    ApplySingleFloatAnimation(binding, lookupTime);
+    binding.m_NumberSetter(binding.m_pMemberProperty, binding.m_pObject, m_FloatAnimValues[binding.m_uiAnimation[0]]);
     return;
   }
 
@@ -713,17 +790,12 @@ void ezPropertyAnimComponent::ApplyFloatAnimation(const FloatBinding& binding, e
     fCurValue[2] = euler[2].GetDegree();
   }
 
-  // evaluate all available curves
+  // take the values of all animated components
   for (ezUInt32 i = 0; i < 4; ++i)
   {
-    if (binding.m_pAnimation[i] != nullptr)
+    if (binding.m_uiAnimation[i] != ezInvalidIndex)
     {
-      const ezCurve1D& curve = binding.m_pAnimation[i]->m_Curve;
-
-      if (!curve.IsEmpty())
-      {
-        fCurValue[i] = (float)curve.Evaluate(lookupTime.GetSeconds());
-      }
+      fCurValue[i] = m_FloatAnimValues[binding.m_uiAnimation[i]];
     }
   }
 
@@ -756,27 +828,22 @@ void ezPropertyAnimComponent::ApplyFloatAnimation(const FloatBinding& binding, e
   }
 }
 
-void ezPropertyAnimComponent::ApplyColorAnimation(const ColorBinding& binding, ezTime lookupTime)
+void ezPropertyAnimComponent::ApplyColorAnimation(const ColorBinding& binding)
 {
   const ezRTTI* pRtti = binding.m_pMemberProperty->GetSpecificType();
+  const ColorValue& value = m_ColorAnimValues[binding.m_uiAnimation];
 
   if (pRtti == ezGetStaticRTTI<ezColorGammaUB>())
   {
-    ezColorGammaUB gamma;
-    float intensity;
-    binding.m_pAnimation->m_Gradient.Evaluate(lookupTime.AsFloatInSeconds(), gamma, intensity);
+    ezColorGammaUB gamma = value.m_Color;
     binding.m_pMemberProperty->SetValuePtr(binding.m_pObject, &gamma);
     return;
   }
 
   if (pRtti == ezGetStaticRTTI<ezColor>())
   {
-    ezColorGammaUB gamma;
-    float intensity;
-    binding.m_pAnimation->m_Gradient.Evaluate(lookupTime.AsFloatInSeconds(), gamma, intensity);
-
-    ezColor finalColor = gamma;
-    finalColor.ScaleRGB(intensity);
+    ezColor finalColor = value.m_Color;
+    finalColor.ScaleRGB(value.m_fIntensity);
     binding.m_pMemberProperty->SetValuePtr(binding.m_pObject, &finalColor);
     return;
   }
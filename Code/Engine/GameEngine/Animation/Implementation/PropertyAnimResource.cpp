@@ -176,6 +176,7 @@ void ezPropertyAnimResourceDescriptor::Load(ezStreamReader& stream)
     anim.m_Curve.Load(stream);
     anim.m_Curve.SortControlPoints();
     anim.m_Curve.CreateLinearApproximation();
+    anim.m_Curve.CreateBakedTable();
 
     if (!anim.m_sComponentType.IsEmpty())
       anim.m_pComponentRtti = ezRTTI::FindTypeByName(anim.m_sComponentType);
@@ -193,6 +194,7 @@ void ezPropertyAnimResourceDescriptor::Load(ezStreamReader& stream)
     stream >> anim.m_sPropertyPath;
     stream >> anim.m_Target;
     anim.m_Gradient.Load(stream);
+    anim.m_Gradient.CreateBakedTable();
 
     if (!anim.m_sComponentType.IsEmpty())
       anim.m_pComponentRtti = ezRTTI::FindTypeByName(anim.m_sComponentType);
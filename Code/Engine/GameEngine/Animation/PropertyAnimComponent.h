@@ -1,8 +1,10 @@
 #pragma once
 
+#include <Core/Messages/CommonMessages.h>
 #include <Core/Messages/EventMessage.h>
 #include <Core/World/Component.h>
 #include <Core/World/World.h>
+#include <Foundation/Containers/Map.h>
 #include <Foundation/Types/SharedPtr.h>
 #include <GameEngine/Animation/PropertyAnimResource.h>
 #include <GameEngine/GameEngineDLL.h>
@@ -11,6 +13,20 @@ struct ezMsgSetPlaying;
 
 typedef ezComponentManagerSimple<class ezPropertyAnimComponent, ezComponentUpdateType::WhenSimulating> ezPropertyAnimComponentManager;
 
+/// \brief Typed setters that write an animated number into a reflected member property.
+///
+/// The setter is looked up once for the type of the property. Applying a value is then a single function call,
+/// without building an ezVariant and converting it to the property type every time.
+struct EZ_GAMEENGINE_DLL ezPropertyAnimNumberSetter
+{
+  typedef void (*SetterFunc)(ezAbstractMemberProperty* pProperty, void* pObject, double fValue);
+
+  /// \brief Returns the setter for properties of the given type or nullptr, if numbers cannot be assigned to that type.
+  ///
+  /// Supports float, double, bool, all integer types, ezAngle (in degree) and ezTime (in seconds).
+  static SetterFunc FindSetter(const ezRTTI* pPropertyType);
+};
+
 /// \brief Animates properties on other objects and components according to the property animation resource
 ///
 /// Notes:
@@ -67,7 +83,10 @@ protected:
 
   struct FloatBinding : public Binding
   {
-    const ezFloatPropertyAnimEntry* m_pAnimation[4] = {nullptr, nullptr, nullptr, nullptr};
+    /// Only set for number properties, vector and rotation properties are written component-wise.
+    ezPropertyAnimNumberSetter::SetterFunc m_NumberSetter = nullptr;
+    /// Index into m_FloatAnimValues for every component of the property.
+    ezUInt32 m_uiAnimation[4] = {ezInvalidIndex, ezInvalidIndex, ezInvalidIndex, ezInvalidIndex};
   };
 
   struct ComponentFloatBinding : public FloatBinding
@@ -83,18 +102,53 @@ protected:
   struct ColorBinding : public Binding
   {
     ezComponentHandle m_hComponent;
-    const ezColorPropertyAnimEntry* m_pAnimation = nullptr;
+    ezUInt32 m_uiAnimation = ezInvalidIndex; ///< Index into m_ColorAnimValues
+  };
+
+  struct ColorValue
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezColor m_Color;
+    float m_fIntensity;
+  };
+
+  /// \brief Caches the property lookup while creating the bindings, usually all targets of one animation have the same type.
+  struct PropertyLookup
+  {
+    const ezRTTI* m_pOwnerRtti = nullptr;
+    ezAbstractMemberProperty* m_pMember = nullptr;
+  };
+
+  /// \brief Identifies a bound property, such that all vector components of one property end up in the same binding.
+  struct BindingKey
+  {
+    const void* m_pObject;
+    const ezAbstractMemberProperty* m_pMember;
+
+    bool operator==(const BindingKey& rhs) const { return m_pObject == rhs.m_pObject && m_pMember == rhs.m_pMember; }
+
+    bool operator<(const BindingKey& rhs) const
+    {
+      if (m_pObject != rhs.m_pObject)
+        return m_pObject < rhs.m_pObject;
+
+      return m_pMember < rhs.m_pMember;
+    }
   };
 
   void Update();
   void CreatePropertyBindings();
-  void CreateGameObjectBinding(const ezFloatPropertyAnimEntry* pAnim, const ezRTTI* pRtti, void* pObject, const ezGameObjectHandle& hGameObject);
-  void CreateFloatPropertyBinding(const ezFloatPropertyAnimEntry* pAnim, const ezRTTI* pRtti, void* pObject, const ezComponentHandle& hComponent);
-  void CreateColorPropertyBinding(const ezColorPropertyAnimEntry* pAnim, const ezRTTI* pRtti, void* pObject, const ezComponentHandle& hComponent);
+  static ezAbstractMemberProperty* FindMemberProperty(PropertyLookup& lookup, const ezRTTI* pOwnerRtti, const ezPropertyAnimEntry& anim);
+  void CreateGameObjectBinding(ezUInt32 uiAnim, PropertyLookup& lookup, const ezRTTI* pRtti, void* pObject, const ezGameObjectHandle& hGameObject,
+    ezMap<BindingKey, ezUInt32>& bindingIndices);
+  void CreateFloatPropertyBinding(ezUInt32 uiAnim, PropertyLookup& lookup, const ezRTTI* pRtti, void* pObject, const ezComponentHandle& hComponent,
+    ezMap<BindingKey, ezUInt32>& bindingIndices);
+  void CreateColorPropertyBinding(ezUInt32 uiAnim, PropertyLookup& lookup, const ezRTTI* pRtti, void* pObject, const ezComponentHandle& hComponent);
   void ApplyAnimations(const ezTime& tDiff);
-  void ApplyFloatAnimation(const FloatBinding& binding, ezTime lookupTime);
-  void ApplySingleFloatAnimation(const FloatBinding& binding, ezTime lookupTime);
-  void ApplyColorAnimation(const ColorBinding& binding, ezTime lookupTime);
+  void EvaluateAnimations(ezTime lookupTime);
+  void ApplyFloatAnimation(const FloatBinding& binding);
+  void ApplyColorAnimation(const ColorBinding& binding);
   ezTime ComputeAnimationLookup(ezTime tDiff);
   void EvaluateEventTrack(ezTime startTime, ezTime endTime);
   void StartPlayback();
@@ -105,6 +159,12 @@ protected:
   ezHybridArray<GameObjectBinding, 4> m_GoFloatBindings;
   ezHybridArray<ComponentFloatBinding, 4> m_ComponentFloatBindings;
   ezHybridArray<ColorBinding, 4> m_ColorBindings;
+
+  // every animation is evaluated once per frame, no matter how many properties it is bound to
+  ezHybridArray<ezUInt32, 4> m_UsedFloatAnims;
+  ezHybridArray<ezUInt32, 4> m_UsedColorAnims;
+  ezHybridArray<float, 4> m_FloatAnimValues;
+  ezHybridArray<ColorValue, 4> m_ColorAnimValues;
   ezPropertyAnimResourceHandle m_hPropertyAnim;
 
   // we do not want to recreate the binding when the resource changes at runtime
@@ -116,4 +176,7 @@ protected:
   // instead we go with one animation state until this component is reset entirely
   // that means you need to restart a level to see the updated animation
   ezSharedPtr<ezPropertyAnimResourceDescriptor> m_AnimDesc;
+
+private:
+  friend class ezPropertyAnimSetterTest;
 };
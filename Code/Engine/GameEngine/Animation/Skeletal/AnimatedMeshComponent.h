@@ -1,15 +1,81 @@
 #pragma once
 
+#include <Foundation/Containers/HashTable.h>
 #include <GameEngine/GameEngineDLL.h>
 #include <RendererCore/AnimationSystem/AnimationGraph/AnimationClipSampler.h>
 #include <RendererCore/AnimationSystem/AnimationPose.h>
+#include <RendererCore/AnimationSystem/LocalAnimationPose.h>
 #include <RendererCore/Meshes/SkinnedMeshComponent.h>
 
 struct ezSkeletonResourceDescriptor;
 typedef ezTypedResourceHandle<class ezAnimationClipResource> ezAnimationClipResourceHandle;
 typedef ezTypedResourceHandle<class ezSkeletonResource> ezSkeletonResourceHandle;
 
-typedef ezComponentManagerSimple<class ezAnimatedMeshComponent, ezComponentUpdateType::WhenSimulating> ezAnimatedMeshComponentManager;
+/// \brief Updates all animated meshes of a world.
+///
+/// The animation time of all components is advanced in a synchronous step, which also decides which components need a new pose this frame.
+/// Components that are small on screen are only updated every few frames. Components that play the same clip on the same skeleton
+/// at exactly the same time share one pose. The poses are then sampled and converted to skinning matrices in parallel batches
+/// and finally the results are distributed and root motion is applied in another synchronous step.
+class EZ_GAMEENGINE_DLL ezAnimatedMeshComponentManager : public ezComponentManager<class ezAnimatedMeshComponent, ezBlockStorageType::FreeList>
+{
+  using SUPER = ezComponentManager<class ezAnimatedMeshComponent, ezBlockStorageType::FreeList>;
+
+public:
+  ezAnimatedMeshComponentManager(ezWorld* pWorld);
+  ~ezAnimatedMeshComponentManager();
+
+  virtual void Initialize() override;
+
+  /// \brief Components whose bounding sphere covers at least this fraction of the main view's height are updated every frame.
+  ///
+  /// Smaller components are updated less often, proportionally to their size on screen.
+  void SetFullUpdateScreenSize(float fScreenSize) { m_fFullUpdateScreenSize = fScreenSize; }
+  float GetFullUpdateScreenSize() const { return m_fFullUpdateScreenSize; }
+
+  /// \brief The maximum number of frames between two updates of the same component. Set to 1 to update all components every frame.
+  void SetMaxUpdateInterval(ezUInt8 uiInterval) { m_uiMaxUpdateInterval = ezMath::Max<ezUInt8>(uiInterval, 1); }
+  ezUInt8 GetMaxUpdateInterval() const { return m_uiMaxUpdateInterval; }
+
+private:
+  friend class ezAnimatedMeshComponent;
+  friend class ezAnimatedCrowdTest;
+
+  void PrepareUpdate(const ezWorldModule::UpdateContext& context);
+  void UpdatePoses(const ezWorldModule::UpdateContext& context);
+  void FinishUpdate(const ezWorldModule::UpdateContext& context);
+
+  ezUInt32 ComputeUpdateInterval(const ezAnimatedMeshComponent* pComponent) const;
+
+  struct SharedPoseKey
+  {
+    ezAnimationClipResourceHandle m_hAnimationClip;
+    ezSkeletonResourceHandle m_hSkeleton;
+    ezTime m_PrevSampleTime;
+    ezTime m_SampleTime;
+    bool m_bLoop;
+
+    bool operator==(const SharedPoseKey& other) const;
+  };
+
+  struct SharedPoseKeyHashHelper
+  {
+    static ezUInt32 Hash(const SharedPoseKey& key);
+    static bool Equal(const SharedPoseKey& a, const SharedPoseKey& b) { return a == b; }
+  };
+
+  ezHashTable<SharedPoseKey, ezAnimatedMeshComponent*, SharedPoseKeyHashHelper> m_SharedPoses;
+
+  float m_fFullUpdateScreenSize = 0.1f;
+  ezUInt8 m_uiMaxUpdateInterval = 4;
+
+  ezUInt32 m_uiFrameCounter = 0;
+  ezUInt32 m_uiNextUpdateOffset = 0;
+
+  bool m_bUseScreenSize = false;
+  ezVec3 m_vCameraPosition;
+  float m_fScreenSizeScale = 1.0f;
+};
 
 class EZ_GAMEENGINE_DLL ezAnimatedMeshComponent : public ezSkinnedMeshComponent
 {
@@ -48,7 +114,8 @@ public:
 
 
 protected:
-  void Update();
+  void UpdatePose();
+  void FinishUpdate();
   void CreatePhysicsShapes(const ezSkeletonResourceDescriptor& skeleton, const ezAnimationPose& pose);
 
   void* m_pRagdoll = nullptr;
@@ -56,6 +123,23 @@ protected:
   bool m_bApplyRootMotion = false;
   bool m_bVisualizeSkeleton = false;
   ezAnimationPose m_AnimationPose;
+  ezLocalAnimationPose m_LocalPose;
   ezSkeletonResourceHandle m_hSkeleton;
   ezAnimationClipSampler m_AnimationClipSampler;
+
+  enum class UpdateState : ezUInt8
+  {
+    None,       ///< Not updated this frame
+    SamplePose, ///< Samples its own pose this frame
+    SharePose,  ///< Copies the pose of m_pSharedPoseSource this frame
+  };
+
+  UpdateState m_UpdateState = UpdateState::None;
+  ezUInt8 m_uiUpdateOffset = 0;
+  ezTime m_AccumulatedTimeDiff;
+  ezTransform m_RootMotion;
+  const ezAnimatedMeshComponent* m_pSharedPoseSource = nullptr;
+
+private:
+  friend class ezAnimatedCrowdTest;
 };
@@ -7,8 +7,177 @@
 #include <RendererCore/AnimationSystem/AnimationClipResource.h>
 #include <RendererCore/AnimationSystem/SkeletonResource.h>
 #include <RendererCore/Debug/DebugRendererContext.h>
+#include <RendererCore/Pipeline/View.h>
+#include <RendererCore/RenderWorld/RenderWorld.h>
 #include <RendererFoundation/Device/Device.h>
 
+ezAnimatedMeshComponentManager::ezAnimatedMeshComponentManager(ezWorld* pWorld)
+  : SUPER(pWorld)
+{
+}
+
+ezAnimatedMeshComponentManager::~ezAnimatedMeshComponentManager() = default;
+
+void ezAnimatedMeshComponentManager::Initialize()
+{
+  {
+    auto desc = ezWorldModule::UpdateFunctionDesc(ezWorldModule::UpdateFunction(&ezAnimatedMeshComponentManager::PrepareUpdate, this), "ezAnimatedMeshComponentManager::PrepareUpdate");
+    desc.m_bOnlyUpdateWhenSimulating = true;
+    desc.m_Phase = UpdateFunctionDesc::Phase::PreAsync;
+
+    this->RegisterUpdateFunction(desc);
+  }
+
+  {
+    // sampling and skinning only touch the component itself, so this can run in parallel batches
+    auto desc = ezWorldModule::UpdateFunctionDesc(ezWorldModule::UpdateFunction(&ezAnimatedMeshComponentManager::UpdatePoses, this), "ezAnimatedMeshComponentManager::UpdatePoses");
+    desc.m_bOnlyUpdateWhenSimulating = true;
+    desc.m_Phase = UpdateFunctionDesc::Phase::Async;
+    desc.m_uiGranularity = 32;
+
+    this->RegisterUpdateFunction(desc);
+  }
+
+  {
+    // messages and root motion modify other objects, which is only allowed in a synchronous phase
+    auto desc = ezWorldModule::UpdateFunctionDesc(ezWorldModule::UpdateFunction(&ezAnimatedMeshComponentManager::FinishUpdate, this), "ezAnimatedMeshComponentManager::FinishUpdate");
+    desc.m_bOnlyUpdateWhenSimulating = true;
+    desc.m_Phase = UpdateFunctionDesc::Phase::PostAsync;
+
+    this->RegisterUpdateFunction(desc);
+  }
+}
+
+void ezAnimatedMeshComponentManager::PrepareUpdate(const ezWorldModule::UpdateContext& context)
+{
+  ++m_uiFrameCounter;
+  m_SharedPoses.Clear();
+
+  m_bUseScreenSize = false;
+  if (m_uiMaxUpdateInterval > 1)
+  {
+    const ezView* pView = ezRenderWorld::GetViewByUsageHint(ezCameraUsageHint::MainView, ezCameraUsageHint::EditorView);
+    if (pView != nullptr && pView->GetWorld() == GetWorld() && pView->GetCamera()->IsPerspective())
+    {
+      const ezRectFloat& viewport = pView->GetViewport();
+      const float fAspectRatio = viewport.height > 0.0f ? viewport.width / viewport.height : 1.0f;
+
+      m_bUseScreenSize = true;
+      m_vCameraPosition = pView->GetCamera()->GetCenterPosition();
+      m_fScreenSizeScale = 1.0f / ezMath::Tan(pView->GetCamera()->GetFovY(fAspectRatio) * 0.5f);
+    }
+  }
+
+  const ezTime tDiff = GetWorld()->GetClock().GetTimeDiff();
+
+  for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it)
+  {
+    ComponentType* pComponent = it;
+    pComponent->m_UpdateState = ezAnimatedMeshComponent::UpdateState::None;
+    pComponent->m_pSharedPoseSource = nullptr;
+
+    if (!pComponent->IsActiveAndInitialized() || !pComponent->m_AnimationClipSampler.GetAnimationClip().IsValid() || !pComponent->m_hSkeleton.IsValid())
+      continue;
+
+    pComponent->m_AccumulatedTimeDiff += tDiff;
+
+    const ezUInt32 uiInterval = ComputeUpdateInterval(pComponent);
+    if ((m_uiFrameCounter + pComponent->m_uiUpdateOffset) % uiInterval != 0)
+    {
+      // the GPU buffer still holds the previous pose, nothing needs to be uploaded
+      pComponent->m_SkinningMatrices = ezArrayPtr<const ezMat4>();
+      continue;
+    }
+
+    pComponent->m_AnimationClipSampler.Step(pComponent->m_AccumulatedTimeDiff);
+    pComponent->m_AccumulatedTimeDiff.SetZero();
+
+    SharedPoseKey key;
+    key.m_hAnimationClip = pComponent->m_AnimationClipSampler.GetAnimationClip();
+    key.m_hSkeleton = pComponent->m_hSkeleton;
+    key.m_PrevSampleTime = pComponent->m_AnimationClipSampler.GetPreviousSampleTime();
+    key.m_SampleTime = pComponent->m_AnimationClipSampler.GetSampleTime();
+    key.m_bLoop = pComponent->m_AnimationClipSampler.GetLooping();
+
+    // stopped or paused samplers may still be wrapped or stopped by Execute, so don't share them
+    ezAnimatedMeshComponent* pSource = nullptr;
+    if (pComponent->m_AnimationClipSampler.GetState() == ezAnimationClipSamplerState::Playing && m_SharedPoses.TryGetValue(key, pSource))
+    {
+      pComponent->m_UpdateState = ezAnimatedMeshComponent::UpdateState::SharePose;
+      pComponent->m_pSharedPoseSource = pSource;
+    }
+    else
+    {
+      pComponent->m_UpdateState = ezAnimatedMeshComponent::UpdateState::SamplePose;
+
+      if (pComponent->m_AnimationClipSampler.GetState() == ezAnimationClipSamplerState::Playing)
+      {
+        m_SharedPoses.Insert(key, pComponent);
+      }
+    }
+  }
+}
+
+void ezAnimatedMeshComponentManager::UpdatePoses(const ezWorldModule::UpdateContext& context)
+{
+  for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it)
+  {
+    ComponentType* pComponent = it;
+    if (pComponent->m_UpdateState == ezAnimatedMeshComponent::UpdateState::SamplePose)
+    {
+      pComponent->UpdatePose();
+    }
+  }
+}
+
+void ezAnimatedMeshComponentManager::FinishUpdate(const ezWorldModule::UpdateContext& context)
+{
+  for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it)
+  {
+    ComponentType* pComponent = it;
+    if (pComponent->m_UpdateState != ezAnimatedMeshComponent::UpdateState::None)
+    {
+      pComponent->FinishUpdate();
+    }
+  }
+}
+
+ezUInt32 ezAnimatedMeshComponentManager::ComputeUpdateInterval(const ezAnimatedMeshComponent* pComponent) const
+{
+  if (!m_bUseScreenSize)
+    return 1;
+
+  const ezBoundingBoxSphere bounds = pComponent->GetOwner()->GetGlobalBounds();
+  if (!bounds.IsValid())
+    return 1;
+
+  // approximately the fraction of the view's height that the bounding sphere covers
+  const float fDistance = ezMath::Max((bounds.m_vCenter - m_vCameraPosition).GetLength() - bounds.m_fSphereRadius, 0.001f);
+  const float fScreenSize = bounds.m_fSphereRadius * m_fScreenSizeScale / fDistance;
+
+  if (fScreenSize >= m_fFullUpdateScreenSize)
+    return 1;
+
+  const float fInterval = ezMath::Ceil(m_fFullUpdateScreenSize / ezMath::Max(fScreenSize, 0.0001f));
+  return ezMath::Min<ezUInt32>((ezUInt32)fInterval, m_uiMaxUpdateInterval);
+}
+
+bool ezAnimatedMeshComponentManager::SharedPoseKey::operator==(const SharedPoseKey& other) const
+{
+  return m_hAnimationClip == other.m_hAnimationClip && m_hSkeleton == other.m_hSkeleton && m_PrevSampleTime == other.m_PrevSampleTime &&
+         m_SampleTime == other.m_SampleTime && m_bLoop == other.m_bLoop;
+}
+
+ezUInt32 ezAnimatedMeshComponentManager::SharedPoseKeyHashHelper::Hash(const SharedPoseKey& key)
+{
+  const double fTime = key.m_SampleTime.GetSeconds();
+
+  ezUInt32 uiHash = ezHashHelper<ezAnimationClipResourceHandle>::Hash(key.m_hAnimationClip);
+  uiHash = uiHash * 31 + ezHashHelper<ezSkeletonResourceHandle>::Hash(key.m_hSkeleton);
+  uiHash = uiHash * 31 + ezHashingUtils::MurmurHash32(&fTime, sizeof(fTime));
+  return uiHash;
+}
+
 // clang-format off
 EZ_BEGIN_COMPONENT_TYPE(ezAnimatedMeshComponent, 10, ezComponentMode::Dynamic);
 {
@@ -79,6 +248,7 @@ void ezAnimatedMeshComponent::OnSimulationStarted()
     const ezSkeleton& skeleton = pSkeleton->GetDescriptor().m_Skeleton;
     m_AnimationPose.Configure(skeleton);
     m_AnimationPose.ConvertFromLocalSpaceToObjectSpace(skeleton);
+    m_LocalPose.Configure(skeleton);
 
     CreatePhysicsShapes(pSkeleton->GetDescriptor(), m_AnimationPose);
 
@@ -86,17 +256,24 @@ void ezAnimatedMeshComponent::OnSimulationStarted()
 
     // m_SkinningMatrices = m_AnimationPose.GetAllTransforms();
 
-    // Create the buffer for the skinning matrices
-    ezGALBufferCreationDescription BufferDesc;
-    BufferDesc.m_uiStructSize = sizeof(ezMat4);
-    BufferDesc.m_uiTotalSize = BufferDesc.m_uiStructSize * m_AnimationPose.GetTransformCount();
-    BufferDesc.m_bUseAsStructuredBuffer = true;
-    BufferDesc.m_bAllowShaderResourceView = true;
-    BufferDesc.m_ResourceAccess.m_bImmutable = false;
-
-    m_hSkinningTransformsBuffer = ezGALDevice::GetDefaultDevice()->CreateBuffer(
-      BufferDesc,
-      ezArrayPtr<const ezUInt8>(reinterpret_cast<const ezUInt8*>(m_AnimationPose.GetAllTransforms().GetPtr()), BufferDesc.m_uiTotalSize));
+    // distribute the components with reduced update rates evenly over the frames
+    m_uiUpdateOffset = static_cast<ezUInt8>(static_cast<ezAnimatedMeshComponentManager*>(GetOwningManager())->m_uiNextUpdateOffset++);
+    m_AccumulatedTimeDiff.SetZero();
+
+    // Create the buffer for the skinning matrices, worlds that are only simulated (e.g. on a server) have no device
+    if (ezGALDevice::HasDefaultDevice())
+    {
+      ezGALBufferCreationDescription BufferDesc;
+      BufferDesc.m_uiStructSize = sizeof(ezMat4);
+      BufferDesc.m_uiTotalSize = BufferDesc.m_uiStructSize * m_AnimationPose.GetTransformCount();
+      BufferDesc.m_bUseAsStructuredBuffer = true;
+      BufferDesc.m_bAllowShaderResourceView = true;
+      BufferDesc.m_ResourceAccess.m_bImmutable = false;
+
+      m_hSkinningTransformsBuffer = ezGALDevice::GetDefaultDevice()->CreateBuffer(
+        BufferDesc,
+        ezArrayPtr<const ezUInt8>(reinterpret_cast<const ezUInt8*>(m_AnimationPose.GetAllTransforms().GetPtr()), BufferDesc.m_uiTotalSize));
+    }
   }
 
   m_AnimationClipSampler.RestartAnimation();
@@ -153,22 +330,36 @@ void ezAnimatedMeshComponent::SetAnimationSpeed(float speed)
   m_AnimationClipSampler.SetPlaybackSpeed(speed);
 }
 
-void ezAnimatedMeshComponent::Update()
+void ezAnimatedMeshComponent::UpdatePose()
 {
-  if (!m_AnimationClipSampler.GetAnimationClip().IsValid() || !m_hSkeleton.IsValid())
-    return;
-
   ezResourceLock<ezSkeletonResource> pSkeleton(m_hSkeleton, ezResourceAcquireMode::AllowLoadingFallback);
   const ezSkeleton& skeleton = pSkeleton->GetDescriptor().m_Skeleton;
 
-  ezTransform rootMotion;
-  rootMotion.SetIdentity();
+  m_RootMotion.SetIdentity();
+
+  m_LocalPose.SetToBindPose(skeleton);
+  m_AnimationClipSampler.Execute(skeleton, m_LocalPose, &m_RootMotion);
 
-  m_AnimationPose.SetToBindPoseInLocalSpace(skeleton);
-  m_AnimationClipSampler.Step(GetWorld()->GetClock().GetTimeDiff());
-  m_AnimationClipSampler.Execute(skeleton, m_AnimationPose, &rootMotion);
+  // compute the object space pose and the skinning matrices in one pass over the skeleton
+  ezArrayPtr<ezMat4> pRenderMatrices = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), ezMat4, m_AnimationPose.GetTransformCount());
+  m_AnimationPose.SetFromLocalPose(skeleton, m_LocalPose, pRenderMatrices);
 
-  m_AnimationPose.ConvertFromLocalSpaceToObjectSpace(skeleton);
+  m_SkinningMatrices = pRenderMatrices;
+}
+
+void ezAnimatedMeshComponent::FinishUpdate()
+{
+  if (m_UpdateState == UpdateState::SharePose)
+  {
+    // the source played the same clip at the same time, so its sampler ended up in the state that ours would have
+    m_AnimationClipSampler = m_pSharedPoseSource->m_AnimationClipSampler;
+    m_AnimationPose = m_pSharedPoseSource->m_AnimationPose;
+    m_SkinningMatrices = m_pSharedPoseSource->m_SkinningMatrices;
+    m_RootMotion = m_pSharedPoseSource->m_RootMotion;
+  }
+
+  ezResourceLock<ezSkeletonResource> pSkeleton(m_hSkeleton, ezResourceAcquireMode::AllowLoadingFallback);
+  const ezSkeleton& skeleton = pSkeleton->GetDescriptor().m_Skeleton;
 
   if (m_bVisualizeSkeleton)
   {
@@ -176,7 +367,7 @@ void ezAnimatedMeshComponent::Update()
   }
 
   // inform child nodes/components that a new skinning pose is available
-  // do this before the pose is transformed into skinning space
+  // the pose stays in object space, the skinning matrices are stored separately
   {
     ezMsgAnimationPoseUpdated msg;
     msg.m_pSkeleton = &skeleton;
@@ -185,20 +376,13 @@ void ezAnimatedMeshComponent::Update()
     GetOwner()->SendMessageRecursive(msg);
   }
 
-  m_AnimationPose.ConvertFromObjectSpaceToSkinningSpace(skeleton);
-
-  ezArrayPtr<ezMat4> pRenderMatrices = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), ezMat4, m_AnimationPose.GetTransformCount());
-  ezMemoryUtils::Copy(pRenderMatrices.GetPtr(), m_AnimationPose.GetAllTransforms().GetPtr(), m_AnimationPose.GetTransformCount());
-
-  m_SkinningMatrices = pRenderMatrices;
-
   if (m_bApplyRootMotion)
   {
     auto* pOwner = GetOwner();
 
     const ezQuat qOldRot = pOwner->GetLocalRotation();
-    const ezVec3 vNewPos = qOldRot * (rootMotion.m_vPosition * pOwner->GetGlobalScaling().x) + pOwner->GetLocalPosition();
-    const ezQuat qNewRot = rootMotion.m_qRotation * qOldRot;
+    const ezVec3 vNewPos = qOldRot * (m_RootMotion.m_vPosition * pOwner->GetGlobalScaling().x) + pOwner->GetLocalPosition();
+    const ezQuat qNewRot = m_RootMotion.m_qRotation * qOldRot;
 
     pOwner->SetLocalPosition(vNewPos);
     pOwner->SetLocalRotation(qNewRot);
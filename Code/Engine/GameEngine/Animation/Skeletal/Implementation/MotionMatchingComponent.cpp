@@ -9,6 +9,58 @@
 #include <RendererCore/Debug/DebugRenderer.h>
 #include <RendererFoundation/Device/Device.h>
 
+ezMotionMatchingComponentManager::ezMotionMatchingComponentManager(ezWorld* pWorld)
+  : SUPER(pWorld)
+{
+}
+
+void ezMotionMatchingComponentManager::Initialize()
+{
+  auto desc = ezWorldModule::UpdateFunctionDesc(ezWorldModule::UpdateFunction(&ezMotionMatchingComponentManager::Update, this), "ezMotionMatchingComponentManager::Update");
+  desc.m_bOnlyUpdateWhenSimulating = true;
+
+  this->RegisterUpdateFunction(desc);
+}
+
+void ezMotionMatchingComponentManager::Update(const ezWorldModule::UpdateContext& context)
+{
+  m_ComponentsToUpdate.Clear();
+  m_QueryIndices.Clear();
+  m_QueryDatabases.Clear();
+  m_Queries.Clear();
+
+  for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it)
+  {
+    ComponentType* pComponent = it;
+    if (pComponent->IsActiveAndInitialized())
+    {
+      m_ComponentsToUpdate.PushBack(pComponent);
+
+      ezMotionMatchingDatabase::Query query;
+      if (pComponent->PrepareQuery(query))
+      {
+        m_QueryIndices.PushBack(m_Queries.GetCount());
+        m_QueryDatabases.PushBack(&pComponent->m_Database);
+        m_Queries.PushBack(query);
+      }
+      else
+      {
+        m_QueryIndices.PushBack(ezInvalidIndex);
+      }
+    }
+  }
+
+  // searching the databases is the expensive part, so do it for all components at once
+  m_QueryResults.SetCountUninitialized(m_Queries.GetCount());
+  ezMotionMatchingDatabase::FindBestFrames(m_QueryDatabases, m_Queries, m_QueryResults);
+
+  for (ezUInt32 i = 0; i < m_ComponentsToUpdate.GetCount(); ++i)
+  {
+    const ezUInt32 uiQuery = m_QueryIndices[i];
+    m_ComponentsToUpdate[i]->Update(uiQuery != ezInvalidIndex ? m_QueryResults[uiQuery] : ezInvalidIndex);
+  }
+}
+
 // clang-format off
 EZ_BEGIN_COMPONENT_TYPE(ezMotionMatchingComponent, 2, ezComponentMode::Dynamic);
 {
@@ -97,16 +149,38 @@ void ezMotionMatchingComponent::OnSimulationStarted()
   m_Keyframe1.m_uiAnimClip = 0;
   m_Keyframe1.m_uiKeyframe = 1;
 
+  ezDynamicArray<MotionData> motionData;
+
   for (ezUInt32 anim = 0; anim < m_Animations.GetCount(); ++anim)
   {
     ezResourceLock<ezAnimationClipResource> pClip(m_Animations[anim], ezResourceAcquireMode::BlockTillLoaded);
     ezResourceLock<ezSkeletonResource> pSkeleton(m_hSkeleton, ezResourceAcquireMode::AllowLoadingFallback);
 
-    PrecomputeMotion(m_MotionData, "Bip01_L_Foot", "Bip01_R_Foot", pClip->GetDescriptor(), anim, pSkeleton->GetDescriptor().m_Skeleton);
+    PrecomputeMotion(motionData, "Bip01_L_Foot", "Bip01_R_Foot", pClip->GetDescriptor(), anim, pSkeleton->GetDescriptor().m_Skeleton);
+  }
+
+  {
+    ezDynamicArray<ezMotionMatchingDatabase::Frame> frames;
+    frames.SetCount(motionData.GetCount());
+
+    for (ezUInt32 i = 0; i < motionData.GetCount(); ++i)
+    {
+      const MotionData& md = motionData[i];
+
+      ezMotionMatchingDatabase::Frame& frame = frames[i];
+      frame.m_uiAnimClip = md.m_uiAnimClipIndex;
+      frame.m_uiKeyframe = md.m_uiKeyframeIndex;
+      frame.m_vLeftFootPosition = md.m_vLeftFootPosition;
+      frame.m_vRightFootPosition = md.m_vRightFootPosition;
+      frame.m_vRootVelocity = md.m_vRootVelocity;
+    }
+
+    m_Database.Build(frames);
   }
 
   m_vLeftFootPos.SetZero();
   m_vRightFootPos.SetZero();
+  m_vTargetDir.SetZero();
 
   ConfigureInput();
 }
@@ -176,7 +250,25 @@ ezQuat ezMotionMatchingComponent::GetInputRotation() const
   return q;
 }
 
-void ezMotionMatchingComponent::Update()
+bool ezMotionMatchingComponent::PrepareQuery(ezMotionMatchingDatabase::Query& out_Query)
+{
+  if (!m_hSkeleton.IsValid() || m_Animations.IsEmpty())
+    return false;
+
+  const float fKeyframeFraction = (float)GetWorld()->GetClock().GetTimeDiff().GetSeconds() * 24.0f; // assuming 24 FPS in the animations
+
+  m_vTargetDir = GetInputDirection() / GetOwner()->GetGlobalScaling().x;
+
+  m_fKeyframeLerp += fKeyframeFraction;
+
+  if (m_fKeyframeLerp <= 1.0f || m_Database.IsEmpty())
+    return false;
+
+  out_Query = MakeQuery(m_Keyframe1);
+  return true;
+}
+
+void ezMotionMatchingComponent::Update(ezUInt32 uiBestFrame)
 {
   if (!m_hSkeleton.IsValid() || m_Animations.IsEmpty())
     return;
@@ -184,29 +276,21 @@ void ezMotionMatchingComponent::Update()
   ezResourceLock<ezSkeletonResource> pSkeleton(m_hSkeleton, ezResourceAcquireMode::AllowLoadingFallback);
   const ezSkeleton& skeleton = pSkeleton->GetDescriptor().m_Skeleton;
 
-  // ezTransform rootMotion;
-  // rootMotion.SetIdentity();
-
   const float fKeyframeFraction = (float)GetWorld()->GetClock().GetTimeDiff().GetSeconds() * 24.0f; // assuming 24 FPS in the animations
 
+  while (m_fKeyframeLerp > 1.0f)
   {
-    const ezVec3 vTargetDir = GetInputDirection() / GetOwner()->GetGlobalScaling().x;
-
-    ezStringBuilder tmp;
-    tmp.Format("Gamepad: {0} / {1}", ezArgF(vTargetDir.x, 1), ezArgF(vTargetDir.y, 1));
-    ezDebugRenderer::Draw2DText(GetWorld(), tmp, ezVec2I32(10, 10), ezColor::White);
-
-    m_fKeyframeLerp += fKeyframeFraction;
-    while (m_fKeyframeLerp > 1.0f)
+    // the first search result comes from the manager, in the rare case that several keyframes are skipped in one frame, search again
+    if (uiBestFrame == ezInvalidIndex && !m_Database.IsEmpty())
     {
+      uiBestFrame = m_Database.FindBestFrame(MakeQuery(m_Keyframe1));
+    }
 
-      m_Keyframe0 = m_Keyframe1;
-      m_Keyframe1 = FindNextKeyframe(m_Keyframe1, vTargetDir);
+    m_Keyframe0 = m_Keyframe1;
+    m_Keyframe1 = SelectNextKeyframe(m_Keyframe1, uiBestFrame);
+    m_fKeyframeLerp -= 1.0f;
 
-      // ezLog::Info("Old KF: {0} | {1} - {2}", m_Keyframe0.m_uiAnimClip, m_Keyframe0.m_uiKeyframe, m_fKeyframeLerp);
-      m_fKeyframeLerp -= 1.0f;
-      // ezLog::Info("New KF: {0} | {1} - {2}", m_Keyframe1.m_uiAnimClip, m_Keyframe1.m_uiKeyframe, m_fKeyframeLerp);
-    }
+    uiBestFrame = ezInvalidIndex;
   }
 
   m_AnimationPose.SetToBindPoseInLocalSpace(skeleton);
@@ -229,11 +313,8 @@ void ezMotionMatchingComponent::Update()
       const ezUInt16 uiSkeletonJointIdx = skeleton.FindJointByName(sJointName);
       if (uiSkeletonJointIdx != ezInvalidJointIndex)
       {
-        ezArrayPtr<const ezTransform> pTransforms0 = animDesc0.GetJointKeyframes(uiAnimJointIdx0);
-        ezArrayPtr<const ezTransform> pTransforms1 = animDesc1.GetJointKeyframes(uiAnimJointIdx1);
-
-        const ezTransform jointTransform1 = pTransforms0[m_Keyframe0.m_uiKeyframe];
-        const ezTransform jointTransform2 = pTransforms1[m_Keyframe1.m_uiKeyframe];
+        const ezTransform jointTransform1 = animDesc0.GetJointKeyframe(uiAnimJointIdx0, m_Keyframe0.m_uiKeyframe);
+        const ezTransform jointTransform2 = animDesc1.GetJointKeyframe(uiAnimJointIdx1, m_Keyframe1.m_uiKeyframe);
 
         ezTransform res;
         res.m_vPosition = ezMath::Lerp(jointTransform1.m_vPosition, jointTransform2.m_vPosition, m_fKeyframeLerp);
@@ -253,9 +334,9 @@ void ezMotionMatchingComponent::Update()
       vRootMotion1.SetZero();
 
       if (animDesc0.HasRootMotion())
-        vRootMotion0 = animDesc0.GetJointKeyframes(animDesc0.GetRootMotionJoint())[m_Keyframe0.m_uiKeyframe].m_vPosition;
+        vRootMotion0 = animDesc0.GetJointKeyframe(animDesc0.GetRootMotionJoint(), m_Keyframe0.m_uiKeyframe).m_vPosition;
       if (animDesc1.HasRootMotion())
-        vRootMotion1 = animDesc1.GetJointKeyframes(animDesc1.GetRootMotionJoint())[m_Keyframe1.m_uiKeyframe].m_vPosition;
+        vRootMotion1 = animDesc1.GetJointKeyframe(animDesc1.GetRootMotionJoint(), m_Keyframe1.m_uiKeyframe).m_vPosition;
 
       const ezVec3 vRootMotion =
         ezMath::Lerp(vRootMotion0, vRootMotion1, m_fKeyframeLerp) * fKeyframeFraction * pOwner->GetGlobalScaling().x;
@@ -359,28 +440,28 @@ void ezMotionMatchingComponent::Animations_Remove(ezUInt32 uiIndex)
   m_Animations.RemoveAtAndCopy(uiIndex);
 }
 
-ezMotionMatchingComponent::TargetKeyframe ezMotionMatchingComponent::FindNextKeyframe(const TargetKeyframe& current,
-  const ezVec3& vTargetDir) const
+ezMotionMatchingDatabase::Query ezMotionMatchingComponent::MakeQuery(const TargetKeyframe& current) const
+{
+  ezMotionMatchingDatabase::Query query;
+  query.m_uiCurrentAnimClip = current.m_uiAnimClip;
+  query.m_uiCurrentKeyframe = current.m_uiKeyframe;
+  query.m_vLeftFootPosition = m_vLeftFootPos;
+  query.m_vRightFootPosition = m_vRightFootPos;
+  query.m_vTargetVelocity = m_vTargetDir;
+  return query;
+}
+
+ezMotionMatchingComponent::TargetKeyframe ezMotionMatchingComponent::SelectNextKeyframe(const TargetKeyframe& current, ezUInt32 uiBestFrame) const
 {
   TargetKeyframe kf;
   kf.m_uiAnimClip = current.m_uiAnimClip;
   kf.m_uiKeyframe = current.m_uiKeyframe + 1;
 
+  if (uiBestFrame != ezInvalidIndex)
   {
-    // ezResourceLock<ezAnimationClipResource> pAnimClipCur(m_Animations[current.m_uiAnimClip], ezResourceAcquireMode::NoFallback);
-    // const auto& animClip = pAnimClipCur->GetDescriptor();
-
-    // const ezUInt32 uiLeftFootJoint = animClip.FindJointIndexByName("Bip01_L_Foot");
-    // const ezUInt32 uiRightFootJoint = animClip.FindJointIndexByName("Bip01_R_Foot");
-
-    const ezVec3 vLeftFootPos = m_vLeftFootPos;   // animClip.GetJointKeyframes(uiLeftFootJoint)[current.m_uiKeyframe].m_vPosition;
-    const ezVec3 vRightFootPos = m_vRightFootPos; // animClip.GetJointKeyframes(uiRightFootJoint)[current.m_uiKeyframe].m_vPosition;
-
-    const ezUInt32 uiBestMM = FindBestKeyframe(current, vLeftFootPos, vRightFootPos, vTargetDir);
-
     TargetKeyframe nkf;
-    nkf.m_uiAnimClip = m_MotionData[uiBestMM].m_uiAnimClipIndex;
-    nkf.m_uiKeyframe = m_MotionData[uiBestMM].m_uiKeyframeIndex;
+    nkf.m_uiAnimClip = m_Database.GetAnimClip(uiBestFrame);
+    nkf.m_uiKeyframe = m_Database.GetKeyframe(uiBestFrame);
 
     if ((nkf.m_uiAnimClip != kf.m_uiAnimClip) || (nkf.m_uiKeyframe != kf.m_uiKeyframe && nkf.m_uiKeyframe != current.m_uiKeyframe))
     {
@@ -431,7 +512,7 @@ void ezMotionMatchingComponent::PrecomputeMotion(ezDynamicArray<MotionData>& mot
       const ezUInt16 uiJointIndexInPose = skeleton.FindJointByName(jointNamesToIndices.GetKey(b));
       if (uiJointIndexInPose != ezInvalidJointIndex)
       {
-        const ezTransform jointTransform = animClip.GetJointKeyframes(jointNamesToIndices.GetValue(b))[uiFrameIdx];
+        const ezTransform jointTransform = animClip.GetJointKeyframe(jointNamesToIndices.GetValue(b), uiFrameIdx);
 
         pose.SetTransform(uiJointIndexInPose, jointTransform.GetAsMat4());
       }
@@ -446,7 +527,7 @@ void ezMotionMatchingComponent::PrecomputeMotion(ezDynamicArray<MotionData>& mot
     md.m_uiKeyframeIndex = uiFrameIdx;
     md.m_vLeftFootVelocity.SetZero();
     md.m_vRightFootVelocity.SetZero();
-    md.m_vRootVelocity = animClip.HasRootMotion() ? fRootMotionToVelocity * animClip.GetJointKeyframes(uiRootJoint)[uiFrameIdx].m_vPosition
+    md.m_vRootVelocity = animClip.HasRootMotion() ? fRootMotionToVelocity * animClip.GetJointKeyframe(uiRootJoint, uiFrameIdx).m_vPosition
                                                   : ezVec3::ZeroVector();
   }
 
@@ -472,52 +553,6 @@ void ezMotionMatchingComponent::PrecomputeMotion(ezDynamicArray<MotionData>& mot
   }
 }
 
-ezUInt32 ezMotionMatchingComponent::FindBestKeyframe(const TargetKeyframe& current, ezVec3 vLeftFootPosition, ezVec3 vRightFootPosition,
-  ezVec3 vTargetDir) const
-{
-  float fClosest = 1000000000.0f;
-  ezUInt32 uiClosest = 0xFFFFFFFFu;
-
-  const float fDirWeight = 3.0f;
-
-  for (ezUInt32 i = 0; i < m_MotionData.GetCount(); ++i)
-  {
-    const auto& md = m_MotionData[i];
-
-    float penaltyMul = 1.1f;
-    float penaltyAdd = 100;
-
-    if (md.m_uiAnimClipIndex == current.m_uiAnimClip)
-    {
-      // do NOT allow to transition backwards to a keyframe within a certain range
-      if (md.m_uiKeyframeIndex < current.m_uiKeyframe && md.m_uiKeyframeIndex + 10 > current.m_uiKeyframe)
-        continue;
-
-      penaltyMul = 1.0f;
-
-      if (md.m_uiKeyframeIndex == current.m_uiKeyframe)
-      {
-        penaltyAdd = 0;
-        penaltyMul = 0.9f;
-      }
-    }
-
-    const float dirDist = ezMath::Pow((md.m_vRootVelocity - vTargetDir).GetLength(), fDirWeight);
-    const float leftFootDist = (md.m_vLeftFootPosition - vLeftFootPosition).GetLengthSquared();
-    const float rightFootDist = (md.m_vRightFootPosition - vRightFootPosition).GetLengthSquared();
-
-    const float fScore = dirDist + (leftFootDist + rightFootDist) * penaltyMul + penaltyAdd;
-
-    if (fScore < fClosest)
-    {
-      fClosest = fScore;
-      uiClosest = i;
-    }
-  }
-
-  return uiClosest;
-}
-
 
 
 EZ_STATICLINK_FILE(GameEngine, GameEngine_Animation_Skeletal_Implementation_MotionMatchingComponent);
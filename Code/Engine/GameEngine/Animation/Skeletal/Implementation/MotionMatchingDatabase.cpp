@@ -0,0 +1,504 @@
+#include <GameEnginePCH.h>
+
+#include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <GameEngine/Animation/Skeletal/MotionMatchingDatabase.h>
+
+namespace
+{
+  constexpr ezUInt32 s_uiMaxFramesPerLeaf = 16;
+  constexpr ezUInt32 s_uiMaxTreeDepth = 64;
+
+  EZ_ALWAYS_INLINE ezUInt32 MakeClipAndKeyframeKey(ezUInt16 uiAnimClip, ezUInt16 uiKeyframe)
+  {
+    return (static_cast<ezUInt32>(uiAnimClip) << 16) | uiKeyframe;
+  }
+
+  /// \brief Reorders \a indices such that the element at position \a uiNth is the one that would be there if the array was sorted by \a pValues.
+  ///
+  /// Uses a three-way partition, so that many identical values (e.g. constant features) don't degrade performance.
+  void SelectNth(ezArrayPtr<ezUInt32> indices, const float* pValues, ezUInt32 uiNth)
+  {
+    ezUInt32 uiLow = 0;
+    ezUInt32 uiHigh = indices.GetCount();
+
+    while (uiHigh - uiLow > 1)
+    {
+      const float fPivot = pValues[indices[uiLow + (uiHigh - uiLow) / 2]];
+
+      ezUInt32 uiLess = uiLow;
+      ezUInt32 uiCur = uiLow;
+      ezUInt32 uiGreater = uiHigh;
+
+      while (uiCur < uiGreater)
+      {
+        const float fValue = pValues[indices[uiCur]];
+
+        if (fValue < fPivot)
+        {
+          ezMath::Swap(indices[uiLess], indices[uiCur]);
+          ++uiLess;
+          ++uiCur;
+        }
+        else if (fValue > fPivot)
+        {
+          --uiGreater;
+          ezMath::Swap(indices[uiCur], indices[uiGreater]);
+        }
+        else
+        {
+          ++uiCur;
+        }
+      }
+
+      if (uiNth < uiLess)
+        uiHigh = uiLess;
+      else if (uiNth >= uiGreater)
+        uiLow = uiGreater;
+      else
+        return;
+    }
+  }
+} // namespace
+
+struct ezMotionMatchingDatabase::SearchState
+{
+  const Query* m_pQuery = nullptr;
+  float m_Features[NumPaddedFeatures];
+
+  float m_fBestCost = ezMath::MaxValue<float>();
+  ezUInt32 m_uiBestFrame = ezInvalidIndex;
+
+  /// Every frame except the current one costs at least distance * m_fMinFactor + m_fMinCost.
+  float m_fMinFactor = 1.0f;
+  float m_fMinCost = 0.0f;
+};
+
+ezMotionMatchingDatabase::ezMotionMatchingDatabase() = default;
+ezMotionMatchingDatabase::~ezMotionMatchingDatabase() = default;
+
+void ezMotionMatchingDatabase::Clear()
+{
+  m_uiNumFrames = 0;
+
+  for (ezUInt32 d = 0; d < NumFeatures; ++d)
+  {
+    m_Features[d].Clear();
+  }
+
+  m_AnimClips.Clear();
+  m_Keyframes.Clear();
+  m_ClipAndKeyframeToFrame.Clear();
+  m_Nodes.Clear();
+}
+
+void ezMotionMatchingDatabase::Build(ezArrayPtr<const Frame> frames, const ezMotionMatchingSettings& settings /*= ezMotionMatchingSettings()*/)
+{
+  Clear();
+
+  m_Settings = settings;
+  m_uiNumFrames = frames.GetCount();
+
+  if (m_uiNumFrames == 0)
+    return;
+
+  const ezUInt32 uiNumFrames = m_uiNumFrames;
+
+  // gather the raw features, one array per dimension
+  ezDynamicArray<float> features;
+  features.SetCountUninitialized(uiNumFrames * NumFeatures);
+
+  for (ezUInt32 i = 0; i < uiNumFrames; ++i)
+  {
+    const Frame& frame = frames[i];
+    const ezVec3* pVecs[3] = {&frame.m_vLeftFootPosition, &frame.m_vRightFootPosition, &frame.m_vRootVelocity};
+
+    for (ezUInt32 d = 0; d < NumFeatures; ++d)
+    {
+      features[d * uiNumFrames + i] = pVecs[d / 3]->GetData()[d % 3];
+    }
+  }
+
+  // normalize every dimension to zero mean and unit standard deviation, then apply the weights
+  // the distance is squared, so the weights are applied as their square root
+  for (ezUInt32 d = 0; d < NumFeatures; ++d)
+  {
+    float* pValues = features.GetData() + d * uiNumFrames;
+
+    double fSum = 0.0;
+    double fSumSquared = 0.0;
+    for (ezUInt32 i = 0; i < uiNumFrames; ++i)
+    {
+      fSum += pValues[i];
+      fSumSquared += pValues[i] * (double)pValues[i];
+    }
+
+    const double fMean = fSum / uiNumFrames;
+    const double fVariance = ezMath::Max(0.0, fSumSquared / uiNumFrames - fMean * fMean);
+    const float fStdDev = (float)ezMath::Sqrt(fVariance);
+
+    const float fWeight = d < 6 ? m_Settings.m_fFootPositionWeight : m_Settings.m_fRootVelocityWeight;
+
+    m_fFeatureMean[d] = (float)fMean;
+    m_fFeatureScale[d] = ezMath::Sqrt(fWeight) / (fStdDev > ezMath::SmallEpsilon<float>() ? fStdDev : 1.0f);
+
+    for (ezUInt32 i = 0; i < uiNumFrames; ++i)
+    {
+      pValues[i] = (pValues[i] - m_fFeatureMean[d]) * m_fFeatureScale[d];
+    }
+  }
+
+  // build the tree, this reorders the frame indices such that every node references a contiguous range
+  ezDynamicArray<ezUInt32> frameIndices;
+  frameIndices.SetCountUninitialized(uiNumFrames);
+  for (ezUInt32 i = 0; i < uiNumFrames; ++i)
+  {
+    frameIndices[i] = i;
+  }
+
+  m_Nodes.Reserve(2 * (uiNumFrames / s_uiMaxFramesPerLeaf) + 1);
+  m_Nodes.ExpandAndGetRef();
+  BuildNode(0, frameIndices, 0, features);
+
+  // store everything in tree order
+  // ScanFrames() loads four frames at a time starting at any leaf, which may begin at any frame, so up to three frames after the end are read
+  const ezUInt32 uiPaddedFrames = uiNumFrames + 3;
+
+  for (ezUInt32 d = 0; d < NumFeatures; ++d)
+  {
+    m_Features[d].SetCountUninitialized(uiPaddedFrames);
+
+    const float* pValues = features.GetData() + d * uiNumFrames;
+    for (ezUInt32 i = 0; i < uiNumFrames; ++i)
+    {
+      m_Features[d][i] = pValues[frameIndices[i]];
+    }
+
+    for (ezUInt32 i = uiNumFrames; i < uiPaddedFrames; ++i)
+    {
+      m_Features[d][i] = 0.0f;
+    }
+  }
+
+  m_AnimClips.SetCountUninitialized(uiNumFrames);
+  m_Keyframes.SetCountUninitialized(uiNumFrames);
+  m_ClipAndKeyframeToFrame.Reserve(uiNumFrames);
+
+  for (ezUInt32 i = 0; i < uiNumFrames; ++i)
+  {
+    const Frame& frame = frames[frameIndices[i]];
+    m_AnimClips[i] = frame.m_uiAnimClip;
+    m_Keyframes[i] = frame.m_uiKeyframe;
+    m_ClipAndKeyframeToFrame.Insert(MakeClipAndKeyframeKey(frame.m_uiAnimClip, frame.m_uiKeyframe), i);
+  }
+}
+
+void ezMotionMatchingDatabase::BuildNode(ezUInt32 uiNode, ezArrayPtr<ezUInt32> frameIndices, ezUInt32 uiFirstFrame, ezArrayPtr<const float> features)
+{
+  const ezUInt32 uiNumFrames = m_uiNumFrames;
+
+  // compute the bounding box of all frames in this node
+  float boxMin[NumPaddedFeatures] = {};
+  float boxMax[NumPaddedFeatures] = {};
+  ezUInt32 uiSplitDim = 0;
+  float fLargestExtent = 0.0f;
+
+  for (ezUInt32 d = 0; d < NumFeatures; ++d)
+  {
+    const float* pValues = features.GetPtr() + d * uiNumFrames;
+
+    float fMin = pValues[frameIndices[0]];
+    float fMax = fMin;
+
+    for (ezUInt32 i = 1; i < frameIndices.GetCount(); ++i)
+    {
+      fMin = ezMath::Min(fMin, pValues[frameIndices[i]]);
+      fMax = ezMath::Max(fMax, pValues[frameIndices[i]]);
+    }
+
+    boxMin[d] = fMin;
+    boxMax[d] = fMax;
+
+    if (fMax - fMin > fLargestExtent)
+    {
+      fLargestExtent = fMax - fMin;
+      uiSplitDim = d;
+    }
+  }
+
+  {
+    Node& node = m_Nodes[uiNode];
+    ezMemoryUtils::Copy(node.m_BoxMin, boxMin, NumPaddedFeatures);
+    ezMemoryUtils::Copy(node.m_BoxMax, boxMax, NumPaddedFeatures);
+    node.m_uiFirstFrame = uiFirstFrame;
+    node.m_uiNumFrames = frameIndices.GetCount();
+    node.m_uiChild0 = 0;
+    node.m_uiChild1 = 0;
+  }
+
+  // identical frames can't be split any further
+  if (frameIndices.GetCount() <= s_uiMaxFramesPerLeaf || fLargestExtent <= 0.0f)
+    return;
+
+  const ezUInt32 uiHalf = frameIndices.GetCount() / 2;
+  SelectNth(frameIndices, features.GetPtr() + uiSplitDim * uiNumFrames, uiHalf);
+
+  // m_Nodes may be reallocated by the recursion, so don't keep any references
+  const ezUInt32 uiChild0 = m_Nodes.GetCount();
+  m_Nodes.ExpandAndGetRef();
+  const ezUInt32 uiChild1 = m_Nodes.GetCount();
+  m_Nodes.ExpandAndGetRef();
+
+  m_Nodes[uiNode].m_uiChild0 = uiChild0;
+  m_Nodes[uiNode].m_uiChild1 = uiChild1;
+
+  BuildNode(uiChild0, frameIndices.GetSubArray(0, uiHalf), uiFirstFrame, features);
+  BuildNode(uiChild1, frameIndices.GetSubArray(uiHalf), uiFirstFrame + uiHalf, features);
+}
+
+void ezMotionMatchingDatabase::NormalizeQuery(const Query& query, float* out_pFeatures) const
+{
+  const ezVec3* pVecs[3] = {&query.m_vLeftFootPosition, &query.m_vRightFootPosition, &query.m_vTargetVelocity};
+
+  for (ezUInt32 d = 0; d < NumFeatures; ++d)
+  {
+    out_pFeatures[d] = (pVecs[d / 3]->GetData()[d % 3] - m_fFeatureMean[d]) * m_fFeatureScale[d];
+  }
+
+  for (ezUInt32 d = NumFeatures; d < NumPaddedFeatures; ++d)
+  {
+    out_pFeatures[d] = 0.0f;
+  }
+}
+
+float ezMotionMatchingDatabase::ComputeCost(const Query& query, ezUInt32 uiFrame) const
+{
+  float features[NumPaddedFeatures];
+  NormalizeQuery(query, features);
+
+  float fDistance = 0.0f;
+  for (ezUInt32 d = 0; d < NumFeatures; ++d)
+  {
+    fDistance += ezMath::Square(m_Features[d][uiFrame] - features[d]);
+  }
+
+  const ezUInt16 uiAnimClip = m_AnimClips[uiFrame];
+  const ezUInt16 uiKeyframe = m_Keyframes[uiFrame];
+
+  if (uiAnimClip != query.m_uiCurrentAnimClip)
+    return fDistance * m_Settings.m_fClipChangeFactor + m_Settings.m_fTransitionCost;
+
+  if (uiKeyframe == query.m_uiCurrentKeyframe)
+    return fDistance * m_Settings.m_fCurrentFrameFactor;
+
+  // do NOT allow to transition backwards to a keyframe within a certain range
+  if (uiKeyframe < query.m_uiCurrentKeyframe && uiKeyframe + m_Settings.m_uiBackwardsExclusionRange > query.m_uiCurrentKeyframe)
+    return ezMath::MaxValue<float>();
+
+  return fDistance + m_Settings.m_fTransitionCost;
+}
+
+void ezMotionMatchingDatabase::BeginSearch(SearchState& state, const Query& query) const
+{
+  state.m_pQuery = &query;
+  NormalizeQuery(query, state.m_Features);
+
+  state.m_fMinFactor = ezMath::Min(1.0f, m_Settings.m_fClipChangeFactor);
+  state.m_fMinCost = m_Settings.m_fTransitionCost;
+
+  // the current frame is the only one that doesn't pay the transition cost, so evaluate it up front
+  // that usually gives a good bound for everything else
+  ezUInt32 uiCurrentFrame;
+  if (m_ClipAndKeyframeToFrame.TryGetValue(MakeClipAndKeyframeKey(query.m_uiCurrentAnimClip, query.m_uiCurrentKeyframe), uiCurrentFrame))
+  {
+    state.m_fBestCost = ComputeCost(query, uiCurrentFrame);
+    state.m_uiBestFrame = uiCurrentFrame;
+  }
+}
+
+void ezMotionMatchingDatabase::ScanFrames(SearchState& state, ezUInt32 uiFirstFrame, ezUInt32 uiEndFrame) const
+{
+  ezSimdVec4f query[NumFeatures];
+  for (ezUInt32 d = 0; d < NumFeatures; ++d)
+  {
+    query[d].Set(state.m_Features[d]);
+  }
+
+  const ezSimdVec4f minFactor(state.m_fMinFactor);
+  const ezSimdVec4f minCost(state.m_fMinCost);
+
+  for (ezUInt32 uiFrame = uiFirstFrame; uiFrame < uiEndFrame; uiFrame += 4)
+  {
+    ezSimdVec4f distance = ezSimdVec4f::ZeroVector();
+
+    for (ezUInt32 d = 0; d < NumFeatures; ++d)
+    {
+      ezSimdVec4f values;
+      values.Load<4>(m_Features[d].GetData() + uiFrame);
+
+      const ezSimdVec4f diff = values - query[d];
+      distance = ezSimdVec4f::MulAdd(diff, diff, distance);
+    }
+
+    // the lower bound rejects almost all frames without looking at their clip and keyframe
+    const ezSimdVec4f lowerBound = ezSimdVec4f::MulAdd(distance, minFactor, minCost);
+    if ((lowerBound < ezSimdVec4f(state.m_fBestCost)).NoneSet())
+      continue;
+
+    float fDistances[4];
+    distance.Store<4>(fDistances);
+
+    const ezUInt32 uiNumLanes = ezMath::Min(4u, uiEndFrame - uiFrame);
+    for (ezUInt32 uiLane = 0; uiLane < uiNumLanes; ++uiLane)
+    {
+      const ezUInt32 uiCandidate = uiFrame + uiLane;
+      const ezUInt16 uiAnimClip = m_AnimClips[uiCandidate];
+      const ezUInt16 uiKeyframe = m_Keyframes[uiCandidate];
+
+      float fCost;
+      if (uiAnimClip != state.m_pQuery->m_uiCurrentAnimClip)
+      {
+        fCost = fDistances[uiLane] * m_Settings.m_fClipChangeFactor + m_Settings.m_fTransitionCost;
+      }
+      else
+      {
+        // the current frame has been evaluated in BeginSearch() already
+        if (uiKeyframe == state.m_pQuery->m_uiCurrentKeyframe)
+          continue;
+
+        if (uiKeyframe < state.m_pQuery->m_uiCurrentKeyframe && uiKeyframe + m_Settings.m_uiBackwardsExclusionRange > state.m_pQuery->m_uiCurrentKeyframe)
+          continue;
+
+        fCost = fDistances[uiLane] + m_Settings.m_fTransitionCost;
+      }
+
+      if (fCost < state.m_fBestCost)
+      {
+        state.m_fBestCost = fCost;
+        state.m_uiBestFrame = uiCandidate;
+      }
+    }
+  }
+}
+
+ezUInt32 ezMotionMatchingDatabase::FindBestFrameBruteForce(const Query& query) const
+{
+  if (m_uiNumFrames == 0)
+    return ezInvalidIndex;
+
+  SearchState state;
+  BeginSearch(state, query);
+  ScanFrames(state, 0, m_uiNumFrames);
+
+  return state.m_uiBestFrame;
+}
+
+ezUInt32 ezMotionMatchingDatabase::FindBestFrame(const Query& query) const
+{
+  if (m_uiNumFrames == 0)
+    return ezInvalidIndex;
+
+  SearchState state;
+  BeginSearch(state, query);
+
+  ezSimdVec4f queryVecs[3];
+  for (ezUInt32 i = 0; i < 3; ++i)
+  {
+    queryVecs[i].Load<4>(state.m_Features + i * 4);
+  }
+
+  const ezSimdVec4f zero = ezSimdVec4f::ZeroVector();
+
+  auto GetLowerBound = [&](const Node& node) -> float {
+    ezSimdVec4f distance = zero;
+
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      ezSimdVec4f boxMin, boxMax;
+      boxMin.Load<4>(node.m_BoxMin + i * 4);
+      boxMax.Load<4>(node.m_BoxMax + i * 4);
+
+      const ezSimdVec4f diff = (boxMin - queryVecs[i]).CompMax(zero) + (queryVecs[i] - boxMax).CompMax(zero);
+      distance = ezSimdVec4f::MulAdd(diff, diff, distance);
+    }
+
+    return (float)distance.HorizontalSum<4>() * state.m_fMinFactor + state.m_fMinCost;
+  };
+
+  struct StackEntry
+  {
+    ezUInt32 m_uiNode;
+    float m_fLowerBound;
+  };
+
+  StackEntry stack[s_uiMaxTreeDepth * 2];
+  ezUInt32 uiStackSize = 0;
+
+  stack[uiStackSize++] = {0, GetLowerBound(m_Nodes[0])};
+
+  while (uiStackSize > 0)
+  {
+    const StackEntry entry = stack[--uiStackSize];
+
+    // the best cost may have improved since this node was pushed
+    if (entry.m_fLowerBound >= state.m_fBestCost)
+      continue;
+
+    const Node& node = m_Nodes[entry.m_uiNode];
+
+    if (node.m_uiChild0 == 0)
+    {
+      ScanFrames(state, node.m_uiFirstFrame, node.m_uiFirstFrame + node.m_uiNumFrames);
+      continue;
+    }
+
+    const float fBound0 = GetLowerBound(m_Nodes[node.m_uiChild0]);
+    const float fBound1 = GetLowerBound(m_Nodes[node.m_uiChild1]);
+
+    EZ_ASSERT_DEBUG(uiStackSize + 2 <= EZ_ARRAY_SIZE(stack), "Motion matching tree is too deep");
+
+    // push the farther child first, so that the closer one is visited next
+    if (fBound0 < fBound1)
+    {
+      stack[uiStackSize++] = {node.m_uiChild1, fBound1};
+      stack[uiStackSize++] = {node.m_uiChild0, fBound0};
+    }
+    else
+    {
+      stack[uiStackSize++] = {node.m_uiChild0, fBound0};
+      stack[uiStackSize++] = {node.m_uiChild1, fBound1};
+    }
+  }
+
+  return state.m_uiBestFrame;
+}
+
+// static
+void ezMotionMatchingDatabase::FindBestFrames(ezArrayPtr<const ezMotionMatchingDatabase* const> databases, ezArrayPtr<const Query> queries, ezArrayPtr<ezUInt32> out_Frames)
+{
+  EZ_ASSERT_DEV(databases.GetCount() == queries.GetCount() && queries.GetCount() == out_Frames.GetCount(), "Number of databases, queries and results must be the same");
+
+  ezTaskSystem::ParallelForIndexed(0, queries.GetCount(), [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+    for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+    {
+      out_Frames[i] = databases[i]->FindBestFrame(queries[i]);
+    }
+  },
+    "MotionMatchingQueries");
+}
+
+ezUInt64 ezMotionMatchingDatabase::GetHeapMemoryUsage() const
+{
+  ezUInt64 uiMemory = m_AnimClips.GetHeapMemoryUsage() + m_Keyframes.GetHeapMemoryUsage() + m_ClipAndKeyframeToFrame.GetHeapMemoryUsage() + m_Nodes.GetHeapMemoryUsage();
+
+  for (ezUInt32 d = 0; d < NumFeatures; ++d)
+  {
+    uiMemory += m_Features[d].GetHeapMemoryUsage();
+  }
+
+  return uiMemory;
+}
+
+
+
+EZ_STATICLINK_FILE(GameEngine, GameEngine_Animation_Skeletal_Implementation_MotionMatchingDatabase);
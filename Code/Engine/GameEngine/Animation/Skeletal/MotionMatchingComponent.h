@@ -1,5 +1,6 @@
 #pragma once
 
+#include <GameEngine/Animation/Skeletal/MotionMatchingDatabase.h>
 #include <GameEngine/GameEngineDLL.h>
 #include <RendererCore/AnimationSystem/AnimationGraph/AnimationClipSampler.h>
 #include <RendererCore/AnimationSystem/AnimationPose.h>
@@ -8,7 +9,25 @@
 typedef ezTypedResourceHandle<class ezAnimationClipResource> ezAnimationClipResourceHandle;
 typedef ezTypedResourceHandle<class ezSkeletonResource> ezSkeletonResourceHandle;
 
-typedef ezComponentManagerSimple<class ezMotionMatchingComponent, ezComponentUpdateType::WhenSimulating> ezMotionMatchingComponentManager;
+/// \brief Updates all motion matching components and answers the database queries of all of them in one parallel batch.
+class EZ_GAMEENGINE_DLL ezMotionMatchingComponentManager : public ezComponentManager<class ezMotionMatchingComponent, ezBlockStorageType::FreeList>
+{
+  using SUPER = ezComponentManager<class ezMotionMatchingComponent, ezBlockStorageType::FreeList>;
+
+public:
+  ezMotionMatchingComponentManager(ezWorld* pWorld);
+
+  virtual void Initialize() override;
+
+  void Update(const ezWorldModule::UpdateContext& context);
+
+private:
+  ezDynamicArray<ezMotionMatchingComponent*> m_ComponentsToUpdate;
+  ezDynamicArray<ezUInt32> m_QueryIndices;
+  ezDynamicArray<const ezMotionMatchingDatabase*> m_QueryDatabases;
+  ezDynamicArray<ezMotionMatchingDatabase::Query> m_Queries;
+  ezDynamicArray<ezUInt32> m_QueryResults;
+};
 
 class EZ_GAMEENGINE_DLL ezMotionMatchingComponent : public ezSkinnedMeshComponent
 {
@@ -36,7 +55,11 @@ public:
   ezAnimationClipResourceHandle GetAnimation(ezUInt32 uiIndex) const;
 
 protected:
-  void Update();
+  /// \brief Advances the keyframe interpolation. Returns true, if a new keyframe has to be picked, in which case \a out_Query is filled out.
+  bool PrepareQuery(ezMotionMatchingDatabase::Query& out_Query);
+
+  /// \brief Finishes the update. \a uiBestFrame is the database result for the query from PrepareQuery(), if there was one.
+  void Update(ezUInt32 uiBestFrame);
 
   ezUInt32 Animations_GetCount() const;                          // [ property ]
   const char* Animations_GetValue(ezUInt32 uiIndex) const;       // [ property ]
@@ -55,6 +78,7 @@ protected:
 
   ezVec3 m_vLeftFootPos;
   ezVec3 m_vRightFootPos;
+  ezVec3 m_vTargetDir;
 
   struct MotionData
   {
@@ -77,12 +101,11 @@ protected:
   TargetKeyframe m_Keyframe1;
   float m_fKeyframeLerp = 0.0f;
 
-  TargetKeyframe FindNextKeyframe(const TargetKeyframe& current, const ezVec3& vTargetDir) const;
+  ezMotionMatchingDatabase::Query MakeQuery(const TargetKeyframe& current) const;
+  TargetKeyframe SelectNextKeyframe(const TargetKeyframe& current, ezUInt32 uiBestFrame) const;
 
-  ezDynamicArray<MotionData> m_MotionData;
+  ezMotionMatchingDatabase m_Database;
 
   static void PrecomputeMotion(ezDynamicArray<MotionData>& motionData, ezTempHashedString jointName1, ezTempHashedString jointName2,
     const ezAnimationClipResourceDescriptor& animClip, ezUInt16 uiAnimClipIndex, const ezSkeleton& skeleton);
-
-  ezUInt32 FindBestKeyframe(const TargetKeyframe& current, ezVec3 vLeftFootPosition, ezVec3 vRightFootPosition, ezVec3 vTargetDir) const;
 };
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/Math/Vec3.h>
+#include <GameEngine/GameEngineDLL.h>
+
+/// \brief Weights and penalties that are used to pick the best frame in an ezMotionMatchingDatabase.
+///
+/// All distances are computed on normalized features, ie. every feature dimension is divided by its standard deviation across the database.
+struct EZ_GAMEENGINE_DLL ezMotionMatchingSettings
+{
+  float m_fFootPositionWeight = 1.0f;
+  float m_fRootVelocityWeight = 1.0f;
+
+  /// Cost that is added for every frame that is not the continuation of the current frame.
+  float m_fTransitionCost = 2.0f;
+  /// Factor for the distance of frames in a different animation clip.
+  float m_fClipChangeFactor = 1.1f;
+  /// Factor for the distance of the current frame, to prefer just continuing the current animation.
+  float m_fCurrentFrameFactor = 0.9f;
+  /// Frames that are up to this many keyframes before the current frame of the same clip are never picked.
+  ezUInt16 m_uiBackwardsExclusionRange = 10;
+};
+
+/// \brief Stores the pose and trajectory features of all frames of a set of animation clips and finds the frame that best matches a query.
+///
+/// The features are stored normalized in SoA layout. Queries are answered with a KD-tree over the features, whose leaves
+/// are scanned four frames at a time using SIMD. FindBestFrameBruteForce() scans all frames the same way and is mainly useful for
+/// small databases and for validation.
+class EZ_GAMEENGINE_DLL ezMotionMatchingDatabase
+{
+public:
+  enum
+  {
+    NumFeatures = 9,
+    NumPaddedFeatures = 12,
+  };
+
+  struct Frame
+  {
+    ezUInt16 m_uiAnimClip = 0;
+    ezUInt16 m_uiKeyframe = 0;
+    ezVec3 m_vLeftFootPosition;
+    ezVec3 m_vRightFootPosition;
+    ezVec3 m_vRootVelocity;
+  };
+
+  struct Query
+  {
+    ezUInt16 m_uiCurrentAnimClip = 0;
+    ezUInt16 m_uiCurrentKeyframe = 0;
+    ezVec3 m_vLeftFootPosition;
+    ezVec3 m_vRightFootPosition;
+    ezVec3 m_vTargetVelocity;
+  };
+
+  ezMotionMatchingDatabase();
+  ~ezMotionMatchingDatabase();
+
+  /// \brief Computes the normalization of all features and builds the search tree.
+  void Build(ezArrayPtr<const Frame> frames, const ezMotionMatchingSettings& settings = ezMotionMatchingSettings());
+
+  void Clear();
+
+  bool IsEmpty() const { return m_uiNumFrames == 0; }
+  ezUInt32 GetNumFrames() const { return m_uiNumFrames; }
+
+  /// \brief Returns the index of the frame with the lowest cost, or ezInvalidIndex if every frame is excluded.
+  ezUInt32 FindBestFrame(const Query& query) const;
+
+  /// \brief Same result as FindBestFrame(), but without using the search tree.
+  ezUInt32 FindBestFrameBruteForce(const Query& query) const;
+
+  /// \brief Answers many queries, possibly against different databases, in parallel. Typically used for all characters of a world at once.
+  static void FindBestFrames(ezArrayPtr<const ezMotionMatchingDatabase* const> databases, ezArrayPtr<const Query> queries, ezArrayPtr<ezUInt32> out_Frames);
+
+  ezUInt16 GetAnimClip(ezUInt32 uiFrame) const { return m_AnimClips[uiFrame]; }
+  ezUInt16 GetKeyframe(ezUInt32 uiFrame) const { return m_Keyframes[uiFrame]; }
+
+  /// \brief Returns the cost of a single frame for the given query, ezMath::MaxValue<float>() if the frame is excluded.
+  float ComputeCost(const Query& query, ezUInt32 uiFrame) const;
+
+  ezUInt64 GetHeapMemoryUsage() const;
+
+private:
+  struct Node
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    float m_BoxMin[NumPaddedFeatures];
+    float m_BoxMax[NumPaddedFeatures];
+    ezUInt32 m_uiFirstFrame;
+    ezUInt32 m_uiNumFrames;
+    ezUInt32 m_uiChild0; ///< 0 for leaf nodes, the root can never be a child
+    ezUInt32 m_uiChild1;
+  };
+
+  struct SearchState;
+
+  void NormalizeQuery(const Query& query, float* out_pFeatures) const;
+  void BuildNode(ezUInt32 uiNode, ezArrayPtr<ezUInt32> frameIndices, ezUInt32 uiFirstFrame, ezArrayPtr<const float> features);
+  void ScanFrames(SearchState& state, ezUInt32 uiFirstFrame, ezUInt32 uiEndFrame) const;
+  void BeginSearch(SearchState& state, const Query& query) const;
+
+  ezMotionMatchingSettings m_Settings;
+  ezUInt32 m_uiNumFrames = 0;
+
+  float m_fFeatureMean[NumFeatures];
+  float m_fFeatureScale[NumFeatures];
+
+  /// Normalized features, one array per dimension, sorted in tree order and padded to a multiple of four.
+  ezDynamicArray<float, ezAlignedAllocatorWrapper> m_Features[NumFeatures];
+  ezDynamicArray<ezUInt16> m_AnimClips;
+  ezDynamicArray<ezUInt16> m_Keyframes;
+  ezHashTable<ezUInt32, ezUInt32> m_ClipAndKeyframeToFrame;
+
+  ezDynamicArray<Node> m_Nodes;
+};
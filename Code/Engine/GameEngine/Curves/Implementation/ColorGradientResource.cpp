@@ -92,6 +92,7 @@ void ezColorGradientResourceDescriptor::Load(ezStreamReader& stream)
   EZ_ASSERT_DEV(uiVersion == 1, "Invalid file version {0}", uiVersion);
 
   m_Gradient.Load(stream);
+  m_Gradient.CreateBakedTable();
 }
 
 
@@ -114,6 +114,7 @@ void ezCurve1DResourceDescriptor::Load(ezStreamReader& stream)
     /// \todo We can do this on load, or somehow ensure this is always already correctly saved
     m_Curves[i].SortControlPoints();
     m_Curves[i].CreateLinearApproximation();
+    m_Curves[i].CreateBakedTable();
   }
 }
 
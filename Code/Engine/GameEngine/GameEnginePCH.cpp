@@ -23,6 +23,7 @@ EZ_STATICLINK_LIBRARY(GameEngine)
   EZ_STATICLINK_REFERENCE(GameEngine_Animation_Skeletal_Implementation_AnimatedMeshComponent);
   EZ_STATICLINK_REFERENCE(GameEngine_Animation_Skeletal_Implementation_JointAttachmentComponent);
   EZ_STATICLINK_REFERENCE(GameEngine_Animation_Skeletal_Implementation_MotionMatchingComponent);
+  EZ_STATICLINK_REFERENCE(GameEngine_Animation_Skeletal_Implementation_MotionMatchingDatabase);
   EZ_STATICLINK_REFERENCE(GameEngine_Configuration_Implementation_InputConfig);
   EZ_STATICLINK_REFERENCE(GameEngine_Configuration_Implementation_PlatformProfile);
   EZ_STATICLINK_REFERENCE(GameEngine_Configuration_Implementation_RendererProfileConfigs);
@@ -38,5 +38,98 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMsgBuildStaticMesh, 1, ezRTTIDefaultAllocator<
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
+ezUInt32 ezPhysicsWorldModuleInterface::RaycastBatch(ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsRaycastBatch& batch, ezPhysicsHitCollection collection /*= ezPhysicsHitCollection::Closest*/) const
+{
+  const ezUInt32 uiNumRays = batch.GetCount();
+  EZ_ASSERT_DEV(batch.m_Directions.GetCount() == uiNumRays, "Number of directions ({}) does not match number of rays ({})", batch.m_Directions.GetCount(), uiNumRays);
+  EZ_ASSERT_DEV(batch.m_Distances.GetCount() == 1 || batch.m_Distances.GetCount() == uiNumRays, "Number of distances ({}) must be 1 or the number of rays ({})", batch.m_Distances.GetCount(), uiNumRays);
+  EZ_ASSERT_DEV(batch.m_Params.GetCount() == 1 || batch.m_Params.GetCount() == uiNumRays, "Number of query parameters ({}) must be 1 or the number of rays ({})", batch.m_Params.GetCount(), uiNumRays);
+  EZ_ASSERT_DEV(out_Results.GetCount() >= uiNumRays && out_Hits.GetCount() >= uiNumRays, "Output arrays are too small");
+
+  ezUInt32 uiNumHits = 0;
+
+  for (ezUInt32 i = 0; i < uiNumRays; ++i)
+  {
+    out_Hits[i] = Raycast(out_Results[i], batch.m_Starts[i], batch.m_Directions[i], batch.GetDistance(i), batch.GetParams(i), collection);
+    uiNumHits += out_Hits[i] ? 1 : 0;
+  }
+
+  return uiNumHits;
+}
+
+ezUInt32 ezPhysicsWorldModuleInterface::SweepBatch(ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsSweepBatch& batch, ezPhysicsHitCollection collection /*= ezPhysicsHitCollection::Closest*/) const
+{
+  const ezUInt32 uiNumSweeps = batch.GetCount();
+  EZ_ASSERT_DEV(batch.m_Directions.GetCount() == uiNumSweeps, "Number of directions ({}) does not match number of sweeps ({})", batch.m_Directions.GetCount(), uiNumSweeps);
+  EZ_ASSERT_DEV(batch.m_Distances.GetCount() == 1 || batch.m_Distances.GetCount() == uiNumSweeps, "Number of distances ({}) must be 1 or the number of sweeps ({})", batch.m_Distances.GetCount(), uiNumSweeps);
+  EZ_ASSERT_DEV(batch.m_Params.GetCount() == 1 || batch.m_Params.GetCount() == uiNumSweeps, "Number of query parameters ({}) must be 1 or the number of sweeps ({})", batch.m_Params.GetCount(), uiNumSweeps);
+  EZ_ASSERT_DEV(out_Results.GetCount() >= uiNumSweeps && out_Hits.GetCount() >= uiNumSweeps, "Output arrays are too small");
+
+  const ezPhysicsBatchShape& shape = batch.m_Shape;
+  ezUInt32 uiNumHits = 0;
+
+  for (ezUInt32 i = 0; i < uiNumSweeps; ++i)
+  {
+    const ezTransform& transform = batch.m_Transforms[i];
+
+    switch (shape.m_Type)
+    {
+      case ezPhysicsBatchShape::Type::Sphere:
+        out_Hits[i] = SweepTestSphere(out_Results[i], shape.m_fRadius, transform.m_vPosition, batch.m_Directions[i], batch.GetDistance(i), batch.GetParams(i), collection);
+        break;
+
+      case ezPhysicsBatchShape::Type::Box:
+        out_Hits[i] = SweepTestBox(out_Results[i], shape.m_vBoxExtents, transform, batch.m_Directions[i], batch.GetDistance(i), batch.GetParams(i), collection);
+        break;
+
+      case ezPhysicsBatchShape::Type::Capsule:
+        out_Hits[i] = SweepTestCapsule(out_Results[i], shape.m_fRadius, shape.m_fHeight, transform, batch.m_Directions[i], batch.GetDistance(i), batch.GetParams(i), collection);
+        break;
+
+      default:
+        EZ_ASSERT_NOT_IMPLEMENTED;
+        out_Hits[i] = false;
+        break;
+    }
+
+    uiNumHits += out_Hits[i] ? 1 : 0;
+  }
+
+  return uiNumHits;
+}
+
+ezUInt32 ezPhysicsWorldModuleInterface::OverlapBatch(ezArrayPtr<bool> out_Overlaps, const ezPhysicsOverlapBatch& batch) const
+{
+  const ezUInt32 uiNumTests = batch.GetCount();
+  EZ_ASSERT_DEV(batch.m_Params.GetCount() == 1 || batch.m_Params.GetCount() == uiNumTests, "Number of query parameters ({}) must be 1 or the number of tests ({})", batch.m_Params.GetCount(), uiNumTests);
+  EZ_ASSERT_DEV(out_Overlaps.GetCount() >= uiNumTests, "Output array is too small");
+
+  const ezPhysicsBatchShape& shape = batch.m_Shape;
+  ezUInt32 uiNumOverlaps = 0;
+
+  for (ezUInt32 i = 0; i < uiNumTests; ++i)
+  {
+    switch (shape.m_Type)
+    {
+      case ezPhysicsBatchShape::Type::Sphere:
+        out_Overlaps[i] = OverlapTestSphere(shape.m_fRadius, batch.m_Transforms[i].m_vPosition, batch.GetParams(i));
+        break;
+
+      case ezPhysicsBatchShape::Type::Capsule:
+        out_Overlaps[i] = OverlapTestCapsule(shape.m_fRadius, shape.m_fHeight, batch.m_Transforms[i], batch.GetParams(i));
+        break;
+
+      default:
+        EZ_ASSERT_NOT_IMPLEMENTED;
+        out_Overlaps[i] = false;
+        break;
+    }
+
+    uiNumOverlaps += out_Overlaps[i] ? 1 : 0;
+  }
+
+  return uiNumOverlaps;
+}
+
 
 EZ_STATICLINK_FILE(GameEngine, GameEngine_Interfaces_PhysicsWorldModule);
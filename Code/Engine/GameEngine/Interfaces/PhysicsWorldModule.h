@@ -67,6 +67,69 @@ enum class ezPhysicsHitCollection
   Any
 };
 
+/// \brief Structure-of-arrays description of many raycasts that are executed together through ezPhysicsWorldModuleInterface::RaycastBatch().
+///
+/// m_Starts determines the number of rays. m_Directions must hold one normalized direction per ray.
+/// m_Distances and m_Params must either hold one entry per ray or a single entry that is used for all rays.
+struct ezPhysicsRaycastBatch
+{
+  ezArrayPtr<const ezVec3> m_Starts;
+  ezArrayPtr<const ezVec3> m_Directions;
+  ezArrayPtr<const float> m_Distances;
+  ezArrayPtr<const ezPhysicsQueryParameters> m_Params;
+
+  ezUInt32 GetCount() const { return m_Starts.GetCount(); }
+  float GetDistance(ezUInt32 i) const { return m_Distances.GetCount() == 1 ? m_Distances[0] : m_Distances[i]; }
+  const ezPhysicsQueryParameters& GetParams(ezUInt32 i) const { return m_Params.GetCount() == 1 ? m_Params[0] : m_Params[i]; }
+};
+
+/// \brief The shape that is used by all queries of an ezPhysicsSweepBatch or ezPhysicsOverlapBatch.
+struct ezPhysicsBatchShape
+{
+  enum class Type
+  {
+    Sphere,
+    Box,
+    Capsule,
+  };
+
+  Type m_Type = Type::Sphere;
+  float m_fRadius = 0.5f;               ///< Sphere and capsule radius.
+  float m_fHeight = 1.0f;               ///< Capsule height.
+  ezVec3 m_vBoxExtents = ezVec3(1.0f);  ///< Box extents.
+};
+
+/// \brief Structure-of-arrays description of many shape sweeps that are executed together through ezPhysicsWorldModuleInterface::SweepBatch().
+///
+/// m_Transforms determines the number of sweeps and holds the start pose of the shape (only the position is relevant for spheres).
+/// m_Distances and m_Params must either hold one entry per sweep or a single entry that is used for all sweeps.
+struct ezPhysicsSweepBatch
+{
+  ezPhysicsBatchShape m_Shape;
+  ezArrayPtr<const ezTransform> m_Transforms;
+  ezArrayPtr<const ezVec3> m_Directions;
+  ezArrayPtr<const float> m_Distances;
+  ezArrayPtr<const ezPhysicsQueryParameters> m_Params;
+
+  ezUInt32 GetCount() const { return m_Transforms.GetCount(); }
+  float GetDistance(ezUInt32 i) const { return m_Distances.GetCount() == 1 ? m_Distances[0] : m_Distances[i]; }
+  const ezPhysicsQueryParameters& GetParams(ezUInt32 i) const { return m_Params.GetCount() == 1 ? m_Params[0] : m_Params[i]; }
+};
+
+/// \brief Structure-of-arrays description of many overlap tests that are executed together through ezPhysicsWorldModuleInterface::OverlapBatch().
+///
+/// m_Transforms determines the number of tests. Only sphere and capsule shapes are supported.
+/// m_Params must either hold one entry per test or a single entry that is used for all tests.
+struct ezPhysicsOverlapBatch
+{
+  ezPhysicsBatchShape m_Shape;
+  ezArrayPtr<const ezTransform> m_Transforms;
+  ezArrayPtr<const ezPhysicsQueryParameters> m_Params;
+
+  ezUInt32 GetCount() const { return m_Transforms.GetCount(); }
+  const ezPhysicsQueryParameters& GetParams(ezUInt32 i) const { return m_Params.GetCount() == 1 ? m_Params[0] : m_Params[i]; }
+};
+
 class EZ_GAMEENGINE_DLL ezPhysicsWorldModuleInterface : public ezWorldModule
 {
   EZ_ADD_DYNAMIC_REFLECTION(ezPhysicsWorldModuleInterface, ezWorldModule);
@@ -94,6 +157,21 @@ public:
 
   virtual void QueryShapesInSphere(ezPhysicsOverlapResultArray& out_Results, float fSphereRadius, const ezVec3& vPosition, const ezPhysicsQueryParameters& params) const = 0;
 
+  /// \brief Executes all raycasts of the batch and writes one result per ray into \a out_Results.
+  ///
+  /// \a out_Results and \a out_Hits must have the same size as the batch. \a out_Hits tells which entries in \a out_Results are valid.
+  /// Returns the number of rays that hit something.
+  /// The default implementation calls Raycast() for every ray, implementations should override this to amortize locking and traversal costs.
+  virtual ezUInt32 RaycastBatch(ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsRaycastBatch& batch, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const;
+
+  /// \brief Executes all sweeps of the batch and writes one result per sweep into \a out_Results. See RaycastBatch().
+  virtual ezUInt32 SweepBatch(ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsSweepBatch& batch, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const;
+
+  /// \brief Executes all overlap tests of the batch and writes whether each shape overlaps anything into \a out_Overlaps.
+  ///
+  /// Returns the number of overlapping shapes.
+  virtual ezUInt32 OverlapBatch(ezArrayPtr<bool> out_Overlaps, const ezPhysicsOverlapBatch& batch) const;
+
   virtual ezVec3 GetGravity() const = 0;
 
   virtual void AddStaticCollisionBox(ezGameObject* pObject, ezVec3 boxSize) {}
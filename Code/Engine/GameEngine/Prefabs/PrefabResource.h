@@ -39,9 +39,17 @@ public:
                          ezHybridArray<ezGameObject*, 8>* out_CreatedRootObjects, const ezUInt16* pOverrideTeamID,
                          const ezArrayMap<ezHashedString, ezVariant>* pExposedParamValues, bool bForceDynamic);
 
+  /// \brief Creates one instance of this prefab for every given root transform.
+  ///
+  /// Much cheaper than calling InstantiatePrefab() in a loop, when many copies of the same prefab have to be spawned at once.
+  /// See ezWorldReader::InstantiatePrefabBatch() for details.
+  void InstantiatePrefabBatch(ezWorld& world, ezArrayPtr<const ezTransform> rootTransforms, ezGameObjectHandle hParent,
+                              ezDynamicArray<ezGameObject*>* out_CreatedRootObjects, const ezUInt16* pOverrideTeamID,
+                              const ezArrayMap<ezHashedString, ezVariant>* pExposedParamValues, bool bForceDynamic);
+
   void ApplyExposedParameterValues(const ezArrayMap<ezHashedString, ezVariant>* pExposedParamValues,
-                                   const ezHybridArray<ezGameObject*, 8>& createdChildObjects,
-                                   const ezHybridArray<ezGameObject*, 8>& createdRootObjects) const;
+                                   ezArrayPtr<ezGameObject* const> createdChildObjects,
+                                   ezArrayPtr<ezGameObject* const> createdRootObjects) const;
 
 private:
   virtual ezResourceLoadDesc UnloadData(Unload WhatToUnload) override;
@@ -100,49 +100,24 @@ void ezVisualScriptInstance::Clear()
 
   m_pWorld = nullptr;
   m_Nodes.Clear();
-  m_ExecutionConnections.Clear();
-  m_DataConnections.Clear();
+  m_pProgram = nullptr;
+  m_DataTargetPointers.Clear();
   m_LocalVariables.Clear();
   m_hScriptResource.Invalidate();
 }
 
 
-void ezVisualScriptInstance::ComputeNodeDependencies()
-{
-  m_NodeDependencies.SetCount(m_Nodes.GetCount());
-
-  for (auto it = m_DataConnections.GetIterator(); it.IsValid(); ++it)
-  {
-    const ezVisualScriptPinConnectionID src = it.Key();
-
-    const ezUInt16 uiSourceNode = (src >> 16) & 0xFFFF;
-
-    if (m_Nodes[uiSourceNode]->IsManuallyStepped())
-      continue;
-
-    const ezHybridArray<DataPinConnection, 2>& dst = it.Value();
-
-    for (const DataPinConnection& target : dst)
-    {
-      m_NodeDependencies[target.m_uiTargetNode].PushBack(uiSourceNode);
-    }
-  }
-}
-
-
 void ezVisualScriptInstance::ExecuteDependentNodes(ezUInt16 uiNode)
 {
-  const auto& dep = m_NodeDependencies[uiNode];
-  for (ezUInt32 i = 0; i < dep.GetCount(); ++i)
-  {
-    const ezUInt32 uiDependency = dep[i];
-    auto* pNode = m_Nodes[uiDependency];
+  const auto& nodeInfo = m_pProgram->m_Nodes[uiNode];
+  const ezUInt16* pDependencies = m_pProgram->m_Dependencies.GetData() + nodeInfo.m_uiFirstDependency;
 
-    // recurse to the most dependent nodes first
-    ExecuteDependentNodes(uiDependency);
+  // the list is already sorted such that the most dependent nodes come first
+  // and it only contains nodes that are not manually stepped, so we do not need to filter those out here
+  for (ezUInt32 i = 0; i < nodeInfo.m_uiNumDependencies; ++i)
+  {
+    auto* pNode = m_Nodes[pDependencies[i]];
 
-    // only nodes that are not manually stepped are in the dependency list
-    // so we do not need to filter those out here
     pNode->Execute(this, 0);
     pNode->m_bInputValuesChanged = false;
   }
@@ -197,21 +172,18 @@ void ezVisualScriptInstance::Configure(const ezVisualScriptResourceHandle& hScri
     }
   }
 
-  m_ExecutionConnections.Reserve(resource.m_ExecutionPaths.GetCount());
+  m_pProgram = &resource.m_ExecutionProgram;
+  EZ_ASSERT_DEV(m_pProgram->m_Nodes.GetCount() == m_Nodes.GetCount(), "The execution program of the visual script is out of date");
 
-  for (const auto& con : resource.m_ExecutionPaths)
-  {
-    ConnectExecutionPins(con.m_uiSourceNode, con.m_uiOutputPin, con.m_uiTargetNode, con.m_uiInputPin);
-  }
+  // the connections are shared, only the location of the pin values is different for every instance
+  m_DataTargetPointers.SetCountUninitialized(m_pProgram->m_DataTargets.GetCount());
 
-  for (const auto& con : resource.m_DataPaths)
+  for (ezUInt32 i = 0; i < m_DataTargetPointers.GetCount(); ++i)
   {
-    ConnectDataPins(con.m_uiSourceNode, con.m_uiOutputPin, (ezVisualScriptDataPinType::Enum)con.m_uiOutputPinType, con.m_uiTargetNode,
-      con.m_uiInputPin, (ezVisualScriptDataPinType::Enum)con.m_uiInputPinType);
+    const auto& target = m_pProgram->m_DataTargets[i];
+    m_DataTargetPointers[i] = m_Nodes[target.m_uiTargetNode]->GetInputPinDataPointer(target.m_uiTargetPin);
   }
 
-  ComputeNodeDependencies();
-
   // initialize local variables
   {
     for (const auto& p : resource.m_BoolParameters)
@@ -450,45 +422,33 @@ bool ezVisualScriptInstance::HandleMessage(ezMessage& msg)
   return bHandled;
 }
 
-void ezVisualScriptInstance::ConnectExecutionPins(ezUInt16 uiSourceNode, ezUInt8 uiOutputSlot, ezUInt16 uiTargetNode, ezUInt8 uiTargetPin)
-{
-  auto& con = m_ExecutionConnections[((ezUInt32)uiSourceNode << 16) | (ezUInt32)uiOutputSlot];
-  con.m_uiTargetNode = uiTargetNode;
-  con.m_uiTargetPin = uiTargetPin;
-}
-
-void ezVisualScriptInstance::ConnectDataPins(ezUInt16 uiSourceNode, ezUInt8 uiSourcePin, ezVisualScriptDataPinType::Enum sourcePinType,
-  ezUInt16 uiTargetNode, ezUInt8 uiTargetPin, ezVisualScriptDataPinType::Enum targetPinType)
-{
-  DataPinConnection& con = m_DataConnections[((ezUInt32)uiSourceNode << 16) | (ezUInt32)uiSourcePin].ExpandAndGetRef();
-  con.m_uiTargetNode = uiTargetNode;
-  con.m_uiTargetPin = uiTargetPin;
-  con.m_pTargetData = m_Nodes[uiTargetNode]->GetInputPinDataPointer(uiTargetPin);
-  con.m_AssignFunc = FindDataPinAssignFunction(sourcePinType, targetPinType);
-}
-
 void ezVisualScriptInstance::SetOutputPinValue(const ezVisualScriptNode* pNode, ezUInt8 uiPin, const void* pValue)
 {
-  const ezUInt32 uiConnectionID = ((ezUInt32)pNode->m_uiNodeID << 16) | (ezUInt32)uiPin;
+  const auto& nodeInfo = m_pProgram->m_Nodes[pNode->m_uiNodeID];
+  if (uiPin >= nodeInfo.m_uiNumOutputPins)
+    return;
 
-  ezHybridArray<DataPinConnection, 2>* TargetNodeAndPins;
-  if (!m_DataConnections.TryGetValue(uiConnectionID, TargetNodeAndPins))
+  const auto& outputPin = m_pProgram->m_OutputPins[nodeInfo.m_uiFirstOutputPin + uiPin];
+  if (outputPin.m_uiNumTargets == 0)
     return;
 
-  for (const DataPinConnection& TargetNodeAndPin : *TargetNodeAndPins)
+  const ezUInt32 uiEndTarget = outputPin.m_uiFirstTarget + outputPin.m_uiNumTargets;
+  for (ezUInt32 uiTarget = outputPin.m_uiFirstTarget; uiTarget < uiEndTarget; ++uiTarget)
   {
-    if (TargetNodeAndPin.m_AssignFunc)
+    const auto& target = m_pProgram->m_DataTargets[uiTarget];
+
+    if (target.m_AssignFunc)
     {
-      if (TargetNodeAndPin.m_AssignFunc(pValue, TargetNodeAndPin.m_pTargetData))
+      if (target.m_AssignFunc(pValue, m_DataTargetPointers[uiTarget]))
       {
-        m_Nodes[TargetNodeAndPin.m_uiTargetNode]->m_bInputValuesChanged = true;
+        m_Nodes[target.m_uiTargetNode]->m_bInputValuesChanged = true;
       }
     }
   }
 
   if (m_pActivity != nullptr)
   {
-    m_pActivity->m_ActiveDataConnections.PushBack(uiConnectionID);
+    m_pActivity->m_ActiveDataConnections.PushBack(((ezUInt32)pNode->m_uiNodeID << 16) | (ezUInt32)uiPin);
   }
 }
 
@@ -499,22 +459,24 @@ Otherwise visual script graph execution can end up in an endless recursion with
 Override ezVisualScriptNode::IsManuallyStepped() for type '{}' if necessary.",
     pNode->GetDynamicRTTI()->GetTypeName());
 
-  const ezUInt32 uiConnectionID = ((ezUInt32)pNode->m_uiNodeID << 16) | (ezUInt32)uiNthTarget;
+  const auto& nodeInfo = m_pProgram->m_Nodes[pNode->m_uiNodeID];
+  if (uiNthTarget >= nodeInfo.m_uiNumExecutionPins)
+    return;
 
-  ExecPinConnection TargetNode;
-  if (!m_ExecutionConnections.TryGetValue(uiConnectionID, TargetNode))
+  const auto& target = m_pProgram->m_ExecutionTargets[nodeInfo.m_uiFirstExecutionPin + uiNthTarget];
+  if (target.m_uiTargetNode == 0xFFFF)
     return;
 
-  auto* pTargetNode = m_Nodes[TargetNode.m_uiTargetNode];
+  auto* pTargetNode = m_Nodes[target.m_uiTargetNode];
 
-  ExecuteDependentNodes(TargetNode.m_uiTargetNode);
+  ExecuteDependentNodes(target.m_uiTargetNode);
 
-  pTargetNode->Execute(this, TargetNode.m_uiTargetPin);
+  pTargetNode->Execute(this, target.m_uiTargetPin);
   pTargetNode->m_bInputValuesChanged = false;
 
   if (m_pActivity != nullptr)
   {
-    m_pActivity->m_ActiveExecutionConnections.PushBack(uiConnectionID);
+    m_pActivity->m_ActiveExecutionConnections.PushBack(((ezUInt32)pNode->m_uiNodeID << 16) | (ezUInt32)uiNthTarget);
   }
 }
 
@@ -75,9 +75,14 @@ ezInt32 ezVisualScriptNode::HandlesMessagesWithID() const
 void ezVisualScriptNode::HandleMessage(ezMessage* pMsg) {}
 
 bool ezVisualScriptNode::IsManuallyStepped() const
+{
+  return HasExecutionPins(GetDynamicRTTI());
+}
+
+bool ezVisualScriptNode::HasExecutionPins(const ezRTTI* pNodeType)
 {
   ezHybridArray<ezAbstractProperty*, 32> properties;
-  GetDynamicRTTI()->GetAllProperties(properties);
+  pNodeType->GetAllProperties(properties);
 
   for (auto prop : properties)
   {
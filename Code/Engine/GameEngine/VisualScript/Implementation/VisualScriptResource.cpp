@@ -4,6 +4,7 @@
 #include <Core/Messages/EventMessage.h>
 #include <Core/WorldSerializer/WorldReader.h>
 #include <GameEngine/VisualScript/Nodes/VisualScriptMessageNodes.h>
+#include <GameEngine/VisualScript/VisualScriptInstance.h>
 #include <GameEngine/VisualScript/VisualScriptNode.h>
 #include <GameEngine/VisualScript/VisualScriptResource.h>
 
@@ -71,6 +72,7 @@ void ezVisualScriptResource::UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage)
 EZ_RESOURCE_IMPLEMENT_CREATEABLE(ezVisualScriptResource, ezVisualScriptResourceDescriptor)
 {
   m_Descriptor = descriptor;
+  m_Descriptor.PrecomputeExecutionProgram();
 
   ezResourceLoadDesc res;
   res.m_uiQualityLevelsDiscardable = 0;
@@ -206,6 +208,7 @@ void ezVisualScriptResourceDescriptor::Load(ezStreamReader& stream)
   }
 
   PrecomputeMessageHandlers();
+  PrecomputeExecutionProgram();
 }
 
 void ezVisualScriptResourceDescriptor::Save(ezStreamWriter& stream) const
@@ -333,6 +336,201 @@ void ezVisualScriptResourceDescriptor::PrecomputeMessageHandlers()
   }
 }
 
+namespace
+{
+  struct ProgramDependencies
+  {
+    ezDynamicArray<ezUInt32> m_FirstSource;
+    ezDynamicArray<ezUInt16> m_Sources;
+    ezDynamicArray<ezUInt32> m_VisitedStamp;
+  };
+
+  /// Appends the data sources of uiNode in post-order, such that each node is executed after all the nodes it depends on.
+  void AppendDependencies(ezUInt16 uiNode, ezUInt32 uiStamp, ProgramDependencies& deps, ezDynamicArray<ezUInt16>& out_Dependencies)
+  {
+    deps.m_VisitedStamp[uiNode] = uiStamp;
+
+    for (ezUInt32 i = deps.m_FirstSource[uiNode]; i < deps.m_FirstSource[uiNode + 1]; ++i)
+    {
+      const ezUInt16 uiSource = deps.m_Sources[i];
+
+      if (deps.m_VisitedStamp[uiSource] == uiStamp)
+        continue;
+
+      AppendDependencies(uiSource, uiStamp, deps, out_Dependencies);
+      out_Dependencies.PushBack(uiSource);
+    }
+  }
+} // namespace
+
+void ezVisualScriptResourceDescriptor::PrecomputeExecutionProgram()
+{
+  ezVisualScriptInstance::SetupPinDataTypeConversions();
+
+  ExecutionProgram& program = m_ExecutionProgram;
+  const ezUInt32 uiNumNodes = m_Nodes.GetCount();
+
+  program.m_Nodes.Clear();
+  program.m_OutputPins.Clear();
+  program.m_DataTargets.Clear();
+  program.m_ExecutionTargets.Clear();
+  program.m_Dependencies.Clear();
+
+  program.m_Nodes.SetCount(uiNumNodes);
+
+  // manually stepped nodes are only executed through execution pins, all others are executed on demand to compute their output values
+  ezDynamicArray<bool> manuallyStepped;
+  manuallyStepped.SetCount(uiNumNodes);
+
+  for (ezUInt32 uiNode = 0; uiNode < uiNumNodes; ++uiNode)
+  {
+    const auto& node = m_Nodes[uiNode];
+    const ezRTTI* pType = node.m_pType;
+
+    if (node.m_isFunctionCall || node.m_isMsgSender || pType == nullptr)
+    {
+      manuallyStepped[uiNode] = true;
+    }
+    else if (pType->IsDerivedFrom<ezMessage>())
+    {
+      manuallyStepped[uiNode] = ezVisualScriptNode::HasExecutionPins(ezGetStaticRTTI<ezVisualScriptNode_GenericEvent>());
+    }
+    else if (pType->IsDerivedFrom<ezVisualScriptNode_MessageSender>() || pType->IsDerivedFrom<ezVisualScriptNode_FunctionCall>())
+    {
+      manuallyStepped[uiNode] = true;
+    }
+    else if (pType->IsDerivedFrom<ezVisualScriptNode>())
+    {
+      manuallyStepped[uiNode] = ezVisualScriptNode::HasExecutionPins(pType);
+    }
+    else
+    {
+      manuallyStepped[uiNode] = true;
+    }
+  }
+
+  // one slot for every pin up to the highest connected one
+  for (const auto& con : m_DataPaths)
+  {
+    auto& info = program.m_Nodes[con.m_uiSourceNode];
+    const ezUInt32 uiNumPins = ezMath::Max<ezUInt32>(info.m_uiNumOutputPins, con.m_uiOutputPin + 1u);
+    EZ_ASSERT_DEV(uiNumPins <= 0xFF, "Visual script node {} uses output pin {}, only {} output pins are supported", con.m_uiSourceNode, con.m_uiOutputPin, 0xFF);
+    info.m_uiNumOutputPins = static_cast<ezUInt8>(uiNumPins);
+  }
+
+  for (const auto& con : m_ExecutionPaths)
+  {
+    auto& info = program.m_Nodes[con.m_uiSourceNode];
+    const ezUInt32 uiNumPins = ezMath::Max<ezUInt32>(info.m_uiNumExecutionPins, con.m_uiOutputPin + 1u);
+    EZ_ASSERT_DEV(uiNumPins <= 0xFF, "Visual script node {} uses execution pin {}, only {} execution pins are supported", con.m_uiSourceNode, con.m_uiOutputPin, 0xFF);
+    info.m_uiNumExecutionPins = static_cast<ezUInt8>(uiNumPins);
+  }
+
+  ezUInt32 uiNumOutputPins = 0;
+  ezUInt32 uiNumExecutionPins = 0;
+
+  for (auto& info : program.m_Nodes)
+  {
+    info.m_uiFirstOutputPin = uiNumOutputPins;
+    info.m_uiFirstExecutionPin = uiNumExecutionPins;
+
+    uiNumOutputPins += info.m_uiNumOutputPins;
+    uiNumExecutionPins += info.m_uiNumExecutionPins;
+  }
+
+  // execution pins only have a single target, later connections replace earlier ones
+  program.m_ExecutionTargets.SetCountUninitialized(uiNumExecutionPins);
 
+  for (auto& target : program.m_ExecutionTargets)
+  {
+    target.m_uiTargetNode = 0xFFFF;
+    target.m_uiTargetPin = 0;
+  }
+
+  for (const auto& con : m_ExecutionPaths)
+  {
+    auto& target = program.m_ExecutionTargets[program.m_Nodes[con.m_uiSourceNode].m_uiFirstExecutionPin + con.m_uiOutputPin];
+    target.m_uiTargetNode = con.m_uiTargetNode;
+    target.m_uiTargetPin = con.m_uiInputPin;
+  }
+
+  // the targets of all data pins are stored consecutively, in the order of the connections
+  program.m_OutputPins.SetCount(uiNumOutputPins);
+
+  for (const auto& con : m_DataPaths)
+  {
+    program.m_OutputPins[program.m_Nodes[con.m_uiSourceNode].m_uiFirstOutputPin + con.m_uiOutputPin].m_uiNumTargets++;
+  }
+
+  ezUInt32 uiNumDataTargets = 0;
+  for (auto& pin : program.m_OutputPins)
+  {
+    pin.m_uiFirstTarget = uiNumDataTargets;
+    uiNumDataTargets += pin.m_uiNumTargets;
+    pin.m_uiNumTargets = 0;
+  }
+
+  program.m_DataTargets.SetCountUninitialized(uiNumDataTargets);
+
+  for (const auto& con : m_DataPaths)
+  {
+    auto& pin = program.m_OutputPins[program.m_Nodes[con.m_uiSourceNode].m_uiFirstOutputPin + con.m_uiOutputPin];
+
+    auto& target = program.m_DataTargets[pin.m_uiFirstTarget + pin.m_uiNumTargets];
+    target.m_uiTargetNode = con.m_uiTargetNode;
+    target.m_uiTargetPin = con.m_uiInputPin;
+    target.m_AssignFunc = ezVisualScriptInstance::FindDataPinAssignFunction(
+      (ezVisualScriptDataPinType::Enum)con.m_uiOutputPinType, (ezVisualScriptDataPinType::Enum)con.m_uiInputPinType);
+
+    pin.m_uiNumTargets++;
+  }
+
+  // flatten the transitive data dependencies of every node
+  {
+    ProgramDependencies deps;
+    deps.m_FirstSource.SetCount(uiNumNodes + 1);
+    deps.m_VisitedStamp.SetCount(uiNumNodes);
+
+    for (const auto& con : m_DataPaths)
+    {
+      if (!manuallyStepped[con.m_uiSourceNode])
+      {
+        deps.m_FirstSource[con.m_uiTargetNode + 1]++;
+      }
+    }
+
+    for (ezUInt32 uiNode = 0; uiNode < uiNumNodes; ++uiNode)
+    {
+      deps.m_FirstSource[uiNode + 1] += deps.m_FirstSource[uiNode];
+    }
+
+    ezDynamicArray<ezUInt32> insertPos;
+    insertPos.SetCountUninitialized(uiNumNodes);
+    for (ezUInt32 uiNode = 0; uiNode < uiNumNodes; ++uiNode)
+    {
+      insertPos[uiNode] = deps.m_FirstSource[uiNode];
+    }
+
+    deps.m_Sources.SetCountUninitialized(deps.m_FirstSource[uiNumNodes]);
+
+    for (const auto& con : m_DataPaths)
+    {
+      if (!manuallyStepped[con.m_uiSourceNode])
+      {
+        deps.m_Sources[insertPos[con.m_uiTargetNode]++] = con.m_uiSourceNode;
+      }
+    }
+
+    for (ezUInt32 uiNode = 0; uiNode < uiNumNodes; ++uiNode)
+    {
+      auto& info = program.m_Nodes[uiNode];
+      info.m_uiFirstDependency = program.m_Dependencies.GetCount();
+
+      AppendDependencies((ezUInt16)uiNode, uiNode + 1, deps, program.m_Dependencies);
+
+      info.m_uiNumDependencies = static_cast<ezUInt16>(program.m_Dependencies.GetCount() - info.m_uiFirstDependency);
+    }
+  }
+}
 
 EZ_STATICLINK_FILE(GameEngine, GameEngine_VisualScript_Implementation_VisualScriptResource);
@@ -2,18 +2,17 @@
 
 #include <GameEngine/GameEngineDLL.h>
 #include <Foundation/Containers/DynamicArray.h>
-#include <Foundation/Containers/HashTable.h>
 #include <Foundation/Containers/HybridArray.h>
 #include <Foundation/Types/Variant.h>
 #include <Foundation/Containers/Map.h>
 #include <GameEngine/VisualScript/VisualScriptNode.h>
+#include <GameEngine/VisualScript/VisualScriptResource.h>
 #include <GameEngine/GameState/StateMap.h>
 #include <Foundation/Containers/ArrayMap.h>
 #include <Core/ResourceManager/ResourceHandle.h>
 
 class ezVisualScriptNode;
 class ezMessage;
-struct ezVisualScriptResourceDescriptor;
 class ezGameObject;
 class ezWorld;
 struct ezVisualScriptInstanceActivity;
@@ -23,9 +22,10 @@ typedef ezUInt32 ezVisualScriptNodeConnectionID;
 typedef ezUInt32 ezVisualScriptPinConnectionID;
 typedef ezTypedResourceHandle<class ezVisualScriptResource> ezVisualScriptResourceHandle;
 
-typedef bool(*ezVisualScriptDataPinAssignFunc)(const void* src, void* dst);
-
 /// \brief An instance of a visual script resource. Stores the current script state and executes nodes.
+///
+/// The connections between the nodes are not stored per instance. They are compiled once into the execution program of the resource,
+/// the instance only stores its nodes and where the values of each data connection have to be written to.
 class EZ_GAMEENGINE_DLL ezVisualScriptInstance
 {
 public:
@@ -72,43 +72,20 @@ private:
   friend class ezVisualScriptNode;
 
   void Clear();
-  void ComputeNodeDependencies();
   void ExecuteDependentNodes(ezUInt16 uiNode);
 
-  void ConnectExecutionPins(ezUInt16 uiSourceNode, ezUInt8 uiOutputSlot, ezUInt16 uiTargetNode, ezUInt8 uiTargetPin);
-  void ConnectDataPins(ezUInt16 uiSourceNode, ezUInt8 uiSourcePin, ezVisualScriptDataPinType::Enum sourcePinType, ezUInt16 uiTargetNode, ezUInt8 uiTargetPin, ezVisualScriptDataPinType::Enum targetPinType);
-
   void CreateVisualScriptNode(ezUInt32 uiNodeIdx, const ezVisualScriptResourceDescriptor& resource);
   void CreateFunctionMessageNode(ezUInt32 uiNodeIdx, const ezVisualScriptResourceDescriptor& resource);
   void CreateEventMessageNode(ezUInt32 uiNodeIdx, const ezVisualScriptResourceDescriptor& resource);
   void CreateFunctionCallNode(ezUInt32 uiNodeIdx, const ezVisualScriptResourceDescriptor& resource);
   ezAbstractFunctionProperty* SearchForScriptableFunctionOnType(const ezRTTI* pObjectType, ezStringView sFuncName, const ezScriptableFunctionAttribute*& out_pSfAttr) const;
 
-  struct DataPinConnection
-  {
-    EZ_DECLARE_POD_TYPE();
-
-    ezUInt16 m_uiTargetNode;
-    ezUInt8 m_uiTargetPin;
-    ezVisualScriptDataPinAssignFunc m_AssignFunc = nullptr;
-    void* m_pTargetData = nullptr;
-  };
-
-  struct ExecPinConnection
-  {
-    EZ_DECLARE_POD_TYPE();
-
-    ezUInt16 m_uiTargetNode;
-    ezUInt8 m_uiTargetPin;
-  };
-
   ezVisualScriptResourceHandle m_hScriptResource;
   ezGameObjectHandle m_hOwner;
   ezWorld* m_pWorld = nullptr;
   ezDynamicArray<ezVisualScriptNode*> m_Nodes;
-  ezDynamicArray<ezHybridArray<ezUInt16, 2>> m_NodeDependencies;
-  ezHashTable<ezVisualScriptNodeConnectionID, ExecPinConnection > m_ExecutionConnections;
-  ezHashTable<ezVisualScriptPinConnectionID, ezHybridArray<DataPinConnection, 2> > m_DataConnections;
+  const ezVisualScriptResourceDescriptor::ExecutionProgram* m_pProgram = nullptr;
+  ezDynamicArray<void*> m_DataTargetPointers; ///< The input pin data of the target node for every entry in ExecutionProgram::m_DataTargets
   ezStateMap m_LocalVariables;
   ezVisualScriptInstanceActivity* m_pActivity = nullptr;
   const ezArrayMap<ezMessageId, ezUInt16>* m_pMessageHandlers = nullptr;
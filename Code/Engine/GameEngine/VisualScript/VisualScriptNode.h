@@ -31,8 +31,15 @@ public:
   ///
   /// By default this is determined by checking the properties of the ezVisualScriptNode for attributes of type ezVisScriptExecPinOutAttribute
   /// and ezVisScriptExecPinInAttribute. If those exist, it is a manually stepped node. However, derived types can override this to use other criteria.
+  /// ezVisualScriptResourceDescriptor::PrecomputeExecutionProgram() does not create node instances, it only knows about the overrides of
+  /// ezVisualScriptNode_MessageSender and ezVisualScriptNode_FunctionCall and uses HasExecutionPins() for all other types.
   virtual bool IsManuallyStepped() const;
 
+  /// \brief Whether any property of the given node type has an ezVisScriptExecPinOutAttribute or ezVisScriptExecPinInAttribute.
+  ///
+  /// This is the default for IsManuallyStepped() and allows to check a node type without creating an instance of it.
+  static bool HasExecutionPins(const ezRTTI* pNodeType);
+
 protected:
 
   /// When this is set to true (e.g. in a message handler, the node will be stepped during the next script update)
@@ -7,6 +7,8 @@
 
 typedef ezTypedResourceHandle<class ezVisualScriptResource> ezVisualScriptResourceHandle;
 
+typedef bool (*ezVisualScriptDataPinAssignFunc)(const void* src, void* dst);
+
 /// \brief Describes a visual script graph (node types and connections)
 struct EZ_GAMEENGINE_DLL ezVisualScriptResourceDescriptor
 {
@@ -14,6 +16,9 @@ struct EZ_GAMEENGINE_DLL ezVisualScriptResourceDescriptor
   void Save(ezStreamWriter& stream) const;
   void PrecomputeMessageHandlers();
 
+  /// \brief Compiles the connections into m_ExecutionProgram. Called by Load(), needs to be called manually when the descriptor is filled out in code.
+  void PrecomputeExecutionProgram();
+
   struct Node
   {
     Node()
@@ -74,6 +79,59 @@ struct EZ_GAMEENGINE_DLL ezVisualScriptResourceDescriptor
     double m_Value = 0;
   };
 
+  /// \brief The graph connections in a flat layout, shared by all script instances.
+  ///
+  /// All pins of a node are stored consecutively, so an instance can go from a node and pin index directly to the connected
+  /// nodes, without any lookups. The assign functions for the data connections are resolved once here as well.
+  struct ExecutionProgram
+  {
+    struct NodeInfo
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      ezUInt32 m_uiFirstOutputPin;
+      ezUInt32 m_uiFirstExecutionPin;
+      ezUInt32 m_uiFirstDependency;
+      ezUInt16 m_uiNumDependencies;
+      ezUInt8 m_uiNumOutputPins;
+      ezUInt8 m_uiNumExecutionPins;
+    };
+
+    struct OutputPin
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      ezUInt32 m_uiFirstTarget;
+      ezUInt32 m_uiNumTargets;
+    };
+
+    struct DataTarget
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      ezVisualScriptDataPinAssignFunc m_AssignFunc;
+      ezUInt16 m_uiTargetNode;
+      ezUInt8 m_uiTargetPin;
+    };
+
+    struct ExecutionTarget
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      ezUInt16 m_uiTargetNode; ///< 0xFFFF if the pin is not connected
+      ezUInt8 m_uiTargetPin;
+    };
+
+    ezDynamicArray<NodeInfo> m_Nodes;
+    ezDynamicArray<OutputPin> m_OutputPins;
+    ezDynamicArray<DataTarget> m_DataTargets;
+    ezDynamicArray<ExecutionTarget> m_ExecutionTargets;
+
+    /// For every node all the nodes that are not manually stepped and that (indirectly) provide its input values.
+    /// Each list is sorted such that every node comes after all of its own dependencies and contains every node only once.
+    ezDynamicArray<ezUInt16> m_Dependencies;
+  };
+
   ezDynamicArray<Node> m_Nodes;
   ezDynamicArray<ExecutionConnection> m_ExecutionPaths;
   ezDynamicArray<DataConnection> m_DataPaths;
@@ -81,6 +139,7 @@ struct EZ_GAMEENGINE_DLL ezVisualScriptResourceDescriptor
   ezDeque<Property> m_Properties;
   ezDynamicArray<LocalParameterBool> m_BoolParameters;
   ezDynamicArray<LocalParameterNumber> m_NumberParameters;
+  ExecutionProgram m_ExecutionProgram;
 };
 
 class EZ_GAMEENGINE_DLL ezVisualScriptResource : public ezResource
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Math/Transform.h>
+#include <RendererCore/RendererCoreDLL.h>
+
+class ezStreamWriter;
+class ezStreamReader;
+
+/// \brief Error tolerances that are used when compressing an animation clip.
+///
+/// Keyframes are removed as long as linear interpolation between the remaining keyframes stays within these tolerances.
+struct EZ_RENDERERCORE_DLL ezAnimationClipCompressionSettings
+{
+  float m_fTranslationTolerance = 0.001f; ///< Maximum positional error in world units.
+  float m_fRotationTolerance = 0.0005f;   ///< Maximum error per quaternion component.
+  float m_fScaleTolerance = 0.001f;       ///< Maximum error per scale component.
+};
+
+/// \brief Stores the keyframes of an animation clip in a compressed format.
+///
+/// Every joint has one track for rotation, translation and scale. Tracks that do not change are stored with a single key,
+/// all other tracks only keep the keyframes that are needed to reproduce the original data within the given tolerances.
+/// Rotations are quantized with the 'smallest three' method, translations and scales are quantized to 16 bit per component
+/// relative to the range of their track. Each key therefore only takes 6 bytes plus 2 bytes for its frame index.
+/// Tracks that can't be quantized within the tolerance, e.g. translations that cover a very large range, store their keys as floats.
+///
+/// SamplePose() decompresses four joints at a time using SIMD.
+class EZ_RENDERERCORE_DLL ezCompressedAnimationClip
+{
+public:
+  /// \brief Compresses \a jointTransforms, which must contain uiNumFrames transforms for each joint, stored joint after joint.
+  void Compress(ezArrayPtr<const ezTransform> jointTransforms, ezUInt16 uiNumJoints, ezUInt16 uiNumFrames, const ezAnimationClipCompressionSettings& settings);
+
+  void Clear();
+
+  bool IsEmpty() const { return m_uiNumJoints == 0; }
+
+  ezUInt16 GetNumJoints() const { return m_uiNumJoints; }
+  ezUInt16 GetNumFrames() const { return m_uiNumFrames; }
+
+  /// \brief Returns the total number of keys that are stored for all tracks.
+  ezUInt32 GetNumStoredKeys() const;
+
+  /// \brief Decompresses the transform of a single joint at the given frame.
+  ezTransform GetJointKeyframe(ezUInt16 uiJoint, ezUInt16 uiFrame) const;
+
+  /// \brief Samples all joints at the position between \a uiFrame and the next frame and writes one transform per joint into \a out_Transforms.
+  void SamplePose(ezUInt16 uiFrame, float fLerpToNext, ezArrayPtr<ezTransform> out_Transforms) const;
+
+  void Save(ezStreamWriter& stream) const;
+  void Load(ezStreamReader& stream);
+
+  ezUInt64 GetHeapMemoryUsage() const;
+
+private:
+  struct QuantizedKey
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt16 m_Data[3];
+  };
+
+  struct Track
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezVec3 m_vMin;   ///< Dequantized value = m_vMin + key * m_vScale. Not used for rotations and raw tracks.
+    ezVec3 m_vScale;
+    ezUInt32 m_uiFirstKey;   ///< Index of the first frame index in m_KeyFrames.
+    ezUInt32 m_uiNumKeys;
+    ezUInt32 m_uiFirstValue; ///< Index of the first value in m_Keys, or in m_RawKeys for raw tracks.
+    ezUInt32 m_uiRaw;        ///< Non-zero if the values are stored as floats in m_RawKeys.
+  };
+
+  struct TrackSet
+  {
+    ezDynamicArray<Track> m_Tracks; ///< One track per joint.
+    ezDynamicArray<ezUInt16> m_KeyFrames;
+    ezDynamicArray<QuantizedKey> m_Keys;
+    ezDynamicArray<ezVec4> m_RawKeys;
+
+    void Clear();
+    void Save(ezStreamWriter& stream) const;
+    void Load(ezStreamReader& stream);
+    ezUInt64 GetHeapMemoryUsage() const;
+
+    /// \brief Returns the index of the first of the two keys to interpolate between and the interpolation factor.
+    ezUInt32 FindKey(const Track& track, float fFrame, float& out_fLerp) const;
+
+    /// \brief Returns the index into m_Keys or m_RawKeys of the key that FindKey() returned.
+    static ezUInt32 GetValueIndex(const Track& track, ezUInt32 uiKey) { return track.m_uiFirstValue + (uiKey - track.m_uiFirstKey); }
+
+    ezQuat SampleRotation(ezUInt32 uiTrack, float fFrame) const;
+    ezVec3 SampleVec3(ezUInt32 uiTrack, float fFrame) const;
+  };
+
+  static void CompressRotationTrack(TrackSet& trackSet, ezArrayPtr<const ezTransform> frames, float fTolerance);
+  static void CompressVec3Track(TrackSet& trackSet, ezArrayPtr<const ezTransform> frames, bool bScale, float fTolerance);
+
+  static QuantizedKey QuantizeRotation(const ezQuat& q);
+  static ezQuat DequantizeRotation(const QuantizedKey& key);
+
+  ezUInt16 m_uiNumJoints = 0;
+  ezUInt16 m_uiNumFrames = 0;
+
+  TrackSet m_Rotations;
+  TrackSet m_Translations;
+  TrackSet m_Scales;
+};
@@ -3,9 +3,11 @@
 #include <Core/ResourceManager/Resource.h>
 #include <Foundation/Containers/ArrayMap.h>
 #include <Foundation/Strings/HashedString.h>
+#include <RendererCore/AnimationSystem/AnimationClipCompression.h>
 #include <RendererCore/RendererCoreDLL.h>
 
 class ezAnimationPose;
+class ezLocalAnimationPose;
 class ezSkeleton;
 
 struct EZ_RENDERERCORE_DLL ezAnimationClipResourceDescriptor
@@ -25,9 +27,20 @@ public:
   /// \brief returns ezInvalidJointIndex if no joint with the given name is known
   ezUInt16 FindJointIndexByName(const ezTempHashedString& sJointName) const;
 
+  /// \brief Gives direct access to the uncompressed keyframes of a joint. Must not be called once the clip is compressed.
   ezArrayPtr<const ezTransform> GetJointKeyframes(ezUInt16 uiJoint) const;
   ezArrayPtr<ezTransform> GetJointKeyframes(ezUInt16 uiJoint);
 
+  /// \brief Returns the transform of a joint at the given keyframe. Works for compressed and uncompressed clips.
+  ezTransform GetJointKeyframe(ezUInt16 uiJoint, ezUInt16 uiKeyframe) const;
+
+  /// \brief Replaces the uncompressed keyframes with an ezCompressedAnimationClip.
+  ///
+  /// This should be done after all keyframes have been set up, e.g. as the last step of the asset transform.
+  void Compress(const ezAnimationClipCompressionSettings& settings);
+
+  bool IsCompressed() const { return !m_CompressedClip.IsEmpty(); }
+
   void Save(ezStreamWriter& stream) const;
   void Load(ezStreamReader& stream);
 
@@ -41,8 +54,12 @@ public:
 
   void SetPoseToKeyframe(ezAnimationPose& pose, const ezSkeleton& skeleton, ezUInt16 uiKeyframe) const;
   void SetPoseToBlendedKeyframe(ezAnimationPose& pose, const ezSkeleton& skeleton, ezUInt16 uiKeyframe0, float fBlendToKeyframe1) const;
+  void SetPoseToBlendedKeyframe(ezLocalAnimationPose& pose, const ezSkeleton& skeleton, ezUInt16 uiKeyframe0, float fBlendToKeyframe1) const;
 
 private:
+  template <typename Callback>
+  void SampleBlendedKeyframe(const ezSkeleton& skeleton, ezUInt16 uiKeyframe0, float fBlendToKeyframe1, Callback cb) const;
+
   ezUInt16 m_uiNumJoints = 0;
   ezUInt16 m_uiNumFrames = 0;
   ezUInt8 m_uiFramesPerSecond = 0;
@@ -50,6 +67,7 @@ private:
   ezTime m_Duration;
 
   ezDynamicArray<ezTransform> m_JointTransforms;
+  ezCompressedAnimationClip m_CompressedClip;
   ezArrayMap<ezHashedString, ezUInt16> m_JointNameToIndex;
 };
 
@@ -3,6 +3,7 @@
 #include <RendererCore/AnimationSystem/AnimationGraph/AnimationGraphNode.h>
 
 struct ezAnimationClipResourceDescriptor;
+class ezLocalAnimationPose;
 class ezStreamWriter;
 class ezStreamReader;
 
@@ -22,6 +23,9 @@ public:
   virtual void Step(ezTime tDiff) override;
   virtual bool Execute(const ezSkeleton& skeleton, ezAnimationPose& currentPose, ezTransform* pRootMotion) override;
 
+  /// \brief Same as above, but samples into the SIMD friendly ezLocalAnimationPose.
+  bool Execute(const ezSkeleton& skeleton, ezLocalAnimationPose& currentPose, ezTransform* pRootMotion);
+
   void Save(ezStreamWriter& stream) const;
   void Load(ezStreamReader& stream);
 
@@ -33,6 +37,10 @@ public:
   
   void JumpToSampleTime(ezTime time);
 
+  ezAnimationClipSamplerState GetState() const { return m_State; }
+  ezTime GetSampleTime() const { return m_SampleTime; }
+  ezTime GetPreviousSampleTime() const { return m_PrevSampleTime; }
+
   ezTime GetClipDuration() const { return m_ClipDuration; }
   // ezTime GetDurationAtCurrentSpeed() const
   // ezTime GetRemainingDurationAtCurrentSpeed() const
@@ -44,6 +52,9 @@ public:
   bool GetLooping() const { return m_bLoop; }
 
 private:
+  template <typename PoseType>
+  bool ExecuteInternal(const ezSkeleton& skeleton, PoseType& currentPose, ezTransform* pRootMotion);
+
   void AdjustSampleTime();
   ezTransform ComputeRootMotion(const ezAnimationClipResourceDescriptor& animDesc, ezTime tPrev, ezTime tNow) const;
 
@@ -5,6 +5,7 @@
 #include <Foundation/IO/Stream.h>
 #include <RendererCore/AnimationSystem/AnimationClipResource.h>
 #include <RendererCore/AnimationSystem/AnimationGraph/AnimationClipSampler.h>
+#include <RendererCore/AnimationSystem/LocalAnimationPose.h>
 #include <RendererCore/AnimationSystem/Skeleton.h>
 #include <RendererCore/AnimationSystem/SkeletonResource.h>
 
@@ -22,6 +23,17 @@ void ezAnimationClipSampler::Step(ezTime tDiff)
 }
 
 bool ezAnimationClipSampler::Execute(const ezSkeleton& skeleton, ezAnimationPose& currentPose, ezTransform* pRootMotion)
+{
+  return ExecuteInternal(skeleton, currentPose, pRootMotion);
+}
+
+bool ezAnimationClipSampler::Execute(const ezSkeleton& skeleton, ezLocalAnimationPose& currentPose, ezTransform* pRootMotion)
+{
+  return ExecuteInternal(skeleton, currentPose, pRootMotion);
+}
+
+template <typename PoseType>
+bool ezAnimationClipSampler::ExecuteInternal(const ezSkeleton& skeleton, PoseType& currentPose, ezTransform* pRootMotion)
 {
   // early out, when this is already known
   if (m_State == ezAnimationClipSamplerState::Stopped)
@@ -174,14 +186,12 @@ ezTransform ezAnimationClipSampler::ComputeRootMotion(const ezAnimationClipResou
   double fAnimLerpLast = 0;
   const ezUInt32 uiLastFrame = animDesc.GetFrameAt(tNow, fAnimLerpLast);
 
-  ezArrayPtr<const ezTransform> pKeyframes = animDesc.GetJointKeyframes(uiRootMotionJoint);
-
   ezTransform res;
   res.SetIdentity();
 
   if (uiFirstFrame == uiLastFrame)
   {
-    const ezTransform rm = pKeyframes[uiFirstFrame];
+    const ezTransform rm = animDesc.GetJointKeyframe(uiRootMotionJoint, static_cast<ezUInt16>(uiFirstFrame));
 
     const float fFraction = (float)(fAnimLerpLast - fAnimLerpFirst);
 
@@ -191,7 +201,7 @@ ezTransform ezAnimationClipSampler::ComputeRootMotion(const ezAnimationClipResou
   else
   {
     {
-      const ezTransform rm = pKeyframes[uiFirstFrame];
+      const ezTransform rm = animDesc.GetJointKeyframe(uiRootMotionJoint, static_cast<ezUInt16>(uiFirstFrame));
 
       const float fFraction = (float)(1.0 - fAnimLerpFirst);
 
@@ -201,7 +211,7 @@ ezTransform ezAnimationClipSampler::ComputeRootMotion(const ezAnimationClipResou
 
     for (ezUInt32 i = uiFirstFrame + 1; i < uiLastFrame; ++i)
     {
-      const ezTransform rm = pKeyframes[i];
+      const ezTransform rm = animDesc.GetJointKeyframe(uiRootMotionJoint, static_cast<ezUInt16>(i));
 
       res.m_vPosition += rm.m_vPosition;
       // rotation
@@ -209,7 +219,7 @@ ezTransform ezAnimationClipSampler::ComputeRootMotion(const ezAnimationClipResou
 
 
     {
-      const ezTransform rm = pKeyframes[uiLastFrame];
+      const ezTransform rm = animDesc.GetJointKeyframe(uiRootMotionJoint, static_cast<ezUInt16>(uiLastFrame));
 
       const float fFraction = (float)fAnimLerpLast;
 
@@ -8,6 +8,7 @@
 
 class ezSkeleton;
 class ezDebugRendererContext;
+class ezLocalAnimationPose;
 
 /// \brief The animation pose encapsulates the final transform matrices for each joint in a given skeleton.
 /// For each joint there is also a bit flag indicating whether the transform is valid or not. An IK system for example may only
@@ -36,6 +37,12 @@ public:
   /// This is typically the very last operation done on a pose before it is sent to the GPU for skinning.
   void ConvertFromObjectSpaceToSkinningSpace(const ezSkeleton& skeleton);
 
+  /// \brief Computes the object space transforms of all joints from \a localPose in a single pass and marks all transforms as valid.
+  ///
+  /// If \a out_SkinningTransforms is not empty, the skinning space transforms are written into it as well, which is cheaper than
+  /// calling ConvertFromObjectSpaceToSkinningSpace() afterwards and leaves this pose in object space.
+  void SetFromLocalPose(const ezSkeleton& skeleton, const ezLocalAnimationPose& localPose, ezArrayPtr<ezMat4> out_SkinningTransforms = ezArrayPtr<ezMat4>());
+
   const ezMat4& GetTransform(ezUInt16 uiJointIndex) const { return m_Transforms[uiJointIndex]; }
 
   ezArrayPtr<const ezMat4> GetAllTransforms() const { return m_Transforms.GetArrayPtr(); }
@@ -80,8 +87,6 @@ public:
   void VisualizePose(const ezDebugRendererContext& context, const ezSkeleton& skeleton, const ezTransform& objectTransform, float fJointSizeRatio = 1.0f / 6.0f, ezUInt16 uiStartJoint = ezInvalidJointIndex) const;
 
 private:
-  // TODO: would be nicer to use ezTransform or ezShaderTransform for this data
-
   // use an aligned allocator to make sure this can be uploaded to the GPU
   ezDynamicArray<ezMat4, ezAlignedAllocatorWrapper> m_Transforms;
   ezDynamicBitfield m_TransformsValid;
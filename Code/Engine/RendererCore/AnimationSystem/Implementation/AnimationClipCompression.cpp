@@ -0,0 +1,724 @@
+#include <RendererCorePCH.h>
+
+#include <Foundation/IO/Stream.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/SimdMath/SimdVec4i.h>
+#include <RendererCore/AnimationSystem/AnimationClipCompression.h>
+
+namespace
+{
+  // the three smallest components of a normalized quaternion are always within this range
+  constexpr float s_fSmallestThreeRange = 0.70710678f;
+  constexpr float s_fSmallestThreeMaxValue = 32767.0f;
+
+  // the largest error per quaternion component that the smallest-three quantization introduces
+  constexpr float s_fRotationQuantizationError = 0.0001f;
+
+  EZ_ALWAYS_INLINE float GetMaxComponentDiff(const ezVec4& a, const ezVec4& b)
+  {
+    const ezVec4 d = (a - b).Abs();
+    return ezMath::Max(ezMath::Max(d.x, d.y), ezMath::Max(d.z, d.w));
+  }
+
+  EZ_ALWAYS_INLINE float GetMaxRotationDiff(const ezVec4& a, const ezVec4& b)
+  {
+    // q and -q represent the same rotation
+    return ezMath::Min(GetMaxComponentDiff(a, b), GetMaxComponentDiff(a, -b));
+  }
+
+  /// Selects the keyframes that are needed to reproduce all values within fTolerance, when linearly interpolating between them.
+  /// With bNormalize the interpolated values are normalized, which is how quaternions are interpolated during sampling.
+  void ReduceKeyframes(ezArrayPtr<const ezVec4> values, float fTolerance, bool bNormalize, ezDynamicArray<ezUInt16>& out_KeyFrames)
+  {
+    const ezUInt32 uiNumFrames = values.GetCount();
+
+    out_KeyFrames.Clear();
+    out_KeyFrames.PushBack(0);
+
+    // a single frame is a constant track, the code below needs at least two
+    if (uiNumFrames < 2)
+      return;
+
+    bool bConstant = true;
+    for (ezUInt32 i = 1; i < uiNumFrames; ++i)
+    {
+      if (GetMaxComponentDiff(values[0], values[i]) > fTolerance)
+      {
+        bConstant = false;
+        break;
+      }
+    }
+
+    if (bConstant)
+      return;
+
+    auto CanInterpolate = [&](ezUInt32 uiStart, ezUInt32 uiEnd) {
+      const float fInvRange = 1.0f / (uiEnd - uiStart);
+
+      for (ezUInt32 i = uiStart + 1; i < uiEnd; ++i)
+      {
+        ezVec4 v = ezMath::Lerp(values[uiStart], values[uiEnd], (i - uiStart) * fInvRange);
+
+        if (bNormalize)
+          v.Normalize();
+
+        if (GetMaxComponentDiff(v, values[i]) > fTolerance)
+          return false;
+      }
+
+      return true;
+    };
+
+    ezUInt32 uiStart = 0;
+    for (ezUInt32 uiEnd = 2; uiEnd < uiNumFrames; ++uiEnd)
+    {
+      if (!CanInterpolate(uiStart, uiEnd))
+      {
+        uiStart = uiEnd - 1;
+        out_KeyFrames.PushBack(static_cast<ezUInt16>(uiStart));
+      }
+    }
+
+    out_KeyFrames.PushBack(static_cast<ezUInt16>(uiNumFrames - 1));
+  }
+
+  /// Reallocates the array with the smallest capacity for its elements.
+  /// ezDynamicArray::Compact() can't be used, it asserts when the element count already is a multiple of the capacity alignment.
+  template <typename T>
+  void ShrinkToFit(ezDynamicArray<T>& inout_Array)
+  {
+    ezDynamicArray<T> compact;
+    compact = inout_Array;
+    inout_Array.Swap(compact);
+  }
+
+  struct LaneData
+  {
+    EZ_ALIGN_16(float m_Values[4]);
+  };
+
+  EZ_ALWAYS_INLINE ezSimdVec4f LoadLanes(const LaneData& data)
+  {
+    ezSimdVec4f v;
+    v.Load<4>(data.m_Values);
+    return v;
+  }
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+void ezCompressedAnimationClip::TrackSet::Clear()
+{
+  m_Tracks.Clear();
+  m_KeyFrames.Clear();
+  m_Keys.Clear();
+  m_RawKeys.Clear();
+}
+
+void ezCompressedAnimationClip::TrackSet::Save(ezStreamWriter& stream) const
+{
+  stream << m_Tracks.GetCount();
+  stream << m_KeyFrames.GetCount();
+  stream << m_Keys.GetCount();
+  stream << m_RawKeys.GetCount();
+
+  stream.WriteBytes(m_Tracks.GetData(), m_Tracks.GetCount() * sizeof(Track));
+  stream.WriteBytes(m_KeyFrames.GetData(), m_KeyFrames.GetCount() * sizeof(ezUInt16));
+  stream.WriteBytes(m_Keys.GetData(), m_Keys.GetCount() * sizeof(QuantizedKey));
+  stream.WriteBytes(m_RawKeys.GetData(), m_RawKeys.GetCount() * sizeof(ezVec4));
+}
+
+void ezCompressedAnimationClip::TrackSet::Load(ezStreamReader& stream)
+{
+  Clear();
+
+  ezUInt32 uiNumTracks = 0;
+  ezUInt32 uiNumKeyFrames = 0;
+  stream >> uiNumTracks;
+  stream >> uiNumKeyFrames;
+
+  ezUInt32 uiNumKeys = 0;
+  ezUInt32 uiNumRawKeys = 0;
+  stream >> uiNumKeys;
+  stream >> uiNumRawKeys;
+
+  m_Tracks.SetCountUninitialized(uiNumTracks);
+  m_KeyFrames.SetCountUninitialized(uiNumKeyFrames);
+  m_Keys.SetCountUninitialized(uiNumKeys);
+  m_RawKeys.SetCountUninitialized(uiNumRawKeys);
+
+  stream.ReadBytes(m_Tracks.GetData(), uiNumTracks * sizeof(Track));
+  stream.ReadBytes(m_KeyFrames.GetData(), uiNumKeyFrames * sizeof(ezUInt16));
+  stream.ReadBytes(m_Keys.GetData(), uiNumKeys * sizeof(QuantizedKey));
+  stream.ReadBytes(m_RawKeys.GetData(), uiNumRawKeys * sizeof(ezVec4));
+}
+
+ezUInt64 ezCompressedAnimationClip::TrackSet::GetHeapMemoryUsage() const
+{
+  return m_Tracks.GetHeapMemoryUsage() + m_KeyFrames.GetHeapMemoryUsage() + m_Keys.GetHeapMemoryUsage() + m_RawKeys.GetHeapMemoryUsage();
+}
+
+ezUInt32 ezCompressedAnimationClip::TrackSet::FindKey(const Track& track, float fFrame, float& out_fLerp) const
+{
+  out_fLerp = 0.0f;
+
+  if (track.m_uiNumKeys == 1)
+    return track.m_uiFirstKey;
+
+  const ezUInt16* pKeyFrames = m_KeyFrames.GetData() + track.m_uiFirstKey;
+
+  // binary search for the last key that is not after fFrame, the last key itself is never returned
+  ezUInt32 uiLow = 0;
+  ezUInt32 uiHigh = track.m_uiNumKeys - 2;
+  while (uiLow < uiHigh)
+  {
+    const ezUInt32 uiMid = (uiLow + uiHigh + 1) / 2;
+
+    if (pKeyFrames[uiMid] <= fFrame)
+      uiLow = uiMid;
+    else
+      uiHigh = uiMid - 1;
+  }
+
+  const float fKey0 = pKeyFrames[uiLow];
+  const float fKey1 = pKeyFrames[uiLow + 1];
+  out_fLerp = ezMath::Clamp((fFrame - fKey0) / (fKey1 - fKey0), 0.0f, 1.0f);
+
+  return track.m_uiFirstKey + uiLow;
+}
+
+ezQuat ezCompressedAnimationClip::TrackSet::SampleRotation(ezUInt32 uiTrack, float fFrame) const
+{
+  const Track& track = m_Tracks[uiTrack];
+
+  float fLerp;
+  const ezUInt32 uiValue0 = GetValueIndex(track, FindKey(track, fFrame, fLerp));
+
+  auto GetValue = [&](ezUInt32 uiValue) {
+    if (track.m_uiRaw == 0)
+      return DequantizeRotation(m_Keys[uiValue]);
+
+    const ezVec4& v = m_RawKeys[uiValue];
+    ezQuat q;
+    q.SetElements(v.x, v.y, v.z, v.w);
+    return q;
+  };
+
+  ezQuat res = GetValue(uiValue0);
+
+  if (track.m_uiNumKeys > 1)
+  {
+    // same normalized lerp as in SamplePose()
+    const ezQuat q0 = res;
+    ezQuat q1 = GetValue(uiValue0 + 1);
+
+    if (q0.v.Dot(q1.v) + q0.w * q1.w < 0.0f)
+      q1 = -q1;
+
+    res.SetElements(ezMath::Lerp(q0.v.x, q1.v.x, fLerp), ezMath::Lerp(q0.v.y, q1.v.y, fLerp), ezMath::Lerp(q0.v.z, q1.v.z, fLerp), ezMath::Lerp(q0.w, q1.w, fLerp));
+    res.Normalize();
+  }
+
+  return res;
+}
+
+ezVec3 ezCompressedAnimationClip::TrackSet::SampleVec3(ezUInt32 uiTrack, float fFrame) const
+{
+  const Track& track = m_Tracks[uiTrack];
+
+  float fLerp;
+  const ezUInt32 uiValue0 = GetValueIndex(track, FindKey(track, fFrame, fLerp));
+  const ezUInt32 uiValue1 = track.m_uiNumKeys > 1 ? uiValue0 + 1 : uiValue0;
+
+  if (track.m_uiRaw != 0)
+  {
+    return ezMath::Lerp(m_RawKeys[uiValue0], m_RawKeys[uiValue1], fLerp).GetAsVec3();
+  }
+
+  ezVec3 v;
+  for (ezUInt32 c = 0; c < 3; ++c)
+  {
+    const float f0 = m_Keys[uiValue0].m_Data[c];
+    const float f1 = m_Keys[uiValue1].m_Data[c];
+    v.GetData()[c] = track.m_vMin.GetData()[c] + ezMath::Lerp(f0, f1, fLerp) * track.m_vScale.GetData()[c];
+  }
+
+  return v;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void ezCompressedAnimationClip::Compress(ezArrayPtr<const ezTransform> jointTransforms, ezUInt16 uiNumJoints, ezUInt16 uiNumFrames, const ezAnimationClipCompressionSettings& settings)
+{
+  EZ_ASSERT_DEV(jointTransforms.GetCount() == (ezUInt32)uiNumJoints * uiNumFrames, "Invalid number of joint transforms");
+
+  Clear();
+
+  // without frames there is nothing to sample, the clip stays empty
+  if (uiNumFrames == 0)
+    return;
+
+  m_uiNumJoints = uiNumJoints;
+  m_uiNumFrames = uiNumFrames;
+
+  for (ezUInt32 uiJoint = 0; uiJoint < uiNumJoints; ++uiJoint)
+  {
+    ezArrayPtr<const ezTransform> frames = jointTransforms.GetSubArray(uiJoint * uiNumFrames, uiNumFrames);
+
+    CompressRotationTrack(m_Rotations, frames, settings.m_fRotationTolerance);
+    CompressVec3Track(m_Translations, frames, false, settings.m_fTranslationTolerance);
+    CompressVec3Track(m_Scales, frames, true, settings.m_fScaleTolerance);
+  }
+
+  for (TrackSet* pTrackSet : {&m_Rotations, &m_Translations, &m_Scales})
+  {
+    ShrinkToFit(pTrackSet->m_Tracks);
+    ShrinkToFit(pTrackSet->m_KeyFrames);
+    ShrinkToFit(pTrackSet->m_Keys);
+    ShrinkToFit(pTrackSet->m_RawKeys);
+  }
+}
+
+void ezCompressedAnimationClip::CompressRotationTrack(TrackSet& trackSet, ezArrayPtr<const ezTransform> frames, float fTolerance)
+{
+  ezDynamicArray<ezVec4> values;
+  values.SetCountUninitialized(frames.GetCount());
+
+  for (ezUInt32 i = 0; i < frames.GetCount(); ++i)
+  {
+    ezQuat q = frames[i].m_qRotation;
+    q.Normalize();
+
+    values[i].Set(q.v.x, q.v.y, q.v.z, q.w);
+
+    // keep consecutive rotations in the same hemisphere, so that interpolation takes the short path
+    if (i > 0 && values[i].Dot(values[i - 1]) < 0.0f)
+    {
+      values[i] = -values[i];
+    }
+  }
+
+  const ezUInt32 uiTrack = trackSet.m_Tracks.GetCount();
+  ezDynamicArray<ezUInt16> keyFrames;
+
+  auto AddTrack = [&](bool bRaw) {
+    Track& track = trackSet.m_Tracks.ExpandAndGetRef();
+    track.m_vMin.SetZero();
+    track.m_vScale.SetZero();
+    track.m_uiFirstKey = trackSet.m_KeyFrames.GetCount();
+    track.m_uiNumKeys = keyFrames.GetCount();
+    track.m_uiFirstValue = bRaw ? trackSet.m_RawKeys.GetCount() : trackSet.m_Keys.GetCount();
+    track.m_uiRaw = bRaw ? 1 : 0;
+
+    for (ezUInt16 uiFrame : keyFrames)
+    {
+      trackSet.m_KeyFrames.PushBack(uiFrame);
+
+      if (bRaw)
+        trackSet.m_RawKeys.PushBack(values[uiFrame]);
+      else
+        trackSet.m_Keys.PushBack(QuantizeRotation(frames[uiFrame].m_qRotation));
+    }
+  };
+
+  // the keyframe reduction only gets what the quantization leaves of the tolerance
+  if (fTolerance > 2.0f * s_fRotationQuantizationError)
+  {
+    ReduceKeyframes(values, fTolerance - s_fRotationQuantizationError, true, keyFrames);
+    AddTrack(false);
+
+    bool bWithinTolerance = true;
+    for (ezUInt32 i = 0; i < values.GetCount() && bWithinTolerance; ++i)
+    {
+      const ezQuat q = trackSet.SampleRotation(uiTrack, static_cast<float>(i));
+      bWithinTolerance = GetMaxRotationDiff(ezVec4(q.v.x, q.v.y, q.v.z, q.w), values[i]) <= fTolerance;
+    }
+
+    if (bWithinTolerance)
+      return;
+
+    trackSet.m_KeyFrames.SetCount(trackSet.m_Tracks[uiTrack].m_uiFirstKey);
+    trackSet.m_Keys.SetCount(trackSet.m_Tracks[uiTrack].m_uiFirstValue);
+    trackSet.m_Tracks.PopBack();
+  }
+
+  // the tolerance is too small for quantized rotations
+  ReduceKeyframes(values, fTolerance, true, keyFrames);
+  AddTrack(true);
+}
+
+void ezCompressedAnimationClip::CompressVec3Track(TrackSet& trackSet, ezArrayPtr<const ezTransform> frames, bool bScale, float fTolerance)
+{
+  ezDynamicArray<ezVec4> values;
+  values.SetCountUninitialized(frames.GetCount());
+
+  ezVec3 vMin(ezMath::MaxValue<float>());
+  ezVec3 vMax(-ezMath::MaxValue<float>());
+
+  for (ezUInt32 i = 0; i < frames.GetCount(); ++i)
+  {
+    const ezVec3 v = bScale ? frames[i].m_vScale : frames[i].m_vPosition;
+    values[i] = v.GetAsVec4(0.0f);
+
+    vMin = vMin.CompMin(v);
+    vMax = vMax.CompMax(v);
+  }
+
+  ezVec3 vRange = vMax - vMin;
+
+  // Rounding to 16 bit is off by up to half a step. Interpolating between two keys doesn't make that worse, so the keyframe reduction
+  // gets the rest of the tolerance. Tracks that cover a range which is too large for that are stored as floats instead.
+  const float fQuantizationError = ezMath::Max(vRange.x, vRange.y, vRange.z) / 65535.0f * 0.5f;
+  bool bRaw = fQuantizationError > 0.5f * fTolerance;
+
+  ezDynamicArray<ezUInt16> keyFrames;
+  ReduceKeyframes(values, bRaw ? fTolerance : fTolerance - fQuantizationError, false, keyFrames);
+
+  if (keyFrames.GetCount() == 1)
+  {
+    // constant track, store the exact value
+    vMin = values[0].GetAsVec3();
+    vRange.SetZero();
+    bRaw = false;
+  }
+
+  Track& track = trackSet.m_Tracks.ExpandAndGetRef();
+  track.m_vMin = bRaw ? ezVec3::ZeroVector() : vMin;
+  track.m_vScale = bRaw ? ezVec3::ZeroVector() : vRange / 65535.0f;
+  track.m_uiFirstKey = trackSet.m_KeyFrames.GetCount();
+  track.m_uiNumKeys = keyFrames.GetCount();
+  track.m_uiFirstValue = bRaw ? trackSet.m_RawKeys.GetCount() : trackSet.m_Keys.GetCount();
+  track.m_uiRaw = bRaw ? 1 : 0;
+
+  for (ezUInt16 uiFrame : keyFrames)
+  {
+    trackSet.m_KeyFrames.PushBack(uiFrame);
+
+    if (bRaw)
+    {
+      trackSet.m_RawKeys.PushBack(values[uiFrame]);
+      continue;
+    }
+
+    const ezVec3 v = values[uiFrame].GetAsVec3();
+
+    QuantizedKey key;
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      const float fNormalized = vRange.GetData()[c] > 0.0f ? (v.GetData()[c] - vMin.GetData()[c]) / vRange.GetData()[c] : 0.0f;
+      key.m_Data[c] = static_cast<ezUInt16>(ezMath::Clamp(fNormalized * 65535.0f + 0.5f, 0.0f, 65535.0f));
+    }
+
+    trackSet.m_Keys.PushBack(key);
+  }
+}
+
+ezCompressedAnimationClip::QuantizedKey ezCompressedAnimationClip::QuantizeRotation(const ezQuat& rotation)
+{
+  ezQuat q = rotation;
+  q.Normalize();
+
+  float fComponents[4] = {q.v.x, q.v.y, q.v.z, q.w};
+
+  ezUInt32 uiLargest = 0;
+  for (ezUInt32 c = 1; c < 4; ++c)
+  {
+    if (ezMath::Abs(fComponents[c]) > ezMath::Abs(fComponents[uiLargest]))
+      uiLargest = c;
+  }
+
+  // q and -q represent the same rotation, make sure the dropped component is positive
+  const float fSign = fComponents[uiLargest] < 0.0f ? -1.0f : 1.0f;
+
+  QuantizedKey key;
+
+  ezUInt32 uiOut = 0;
+  for (ezUInt32 c = 0; c < 4; ++c)
+  {
+    if (c == uiLargest)
+      continue;
+
+    const float fNormalized = (fComponents[c] * fSign + s_fSmallestThreeRange) / (2.0f * s_fSmallestThreeRange);
+    key.m_Data[uiOut++] = static_cast<ezUInt16>(ezMath::Clamp(fNormalized * s_fSmallestThreeMaxValue + 0.5f, 0.0f, s_fSmallestThreeMaxValue));
+  }
+
+  // the index of the dropped component is stored in the top bits of the first two values
+  key.m_Data[0] |= (uiLargest & 1) << 15;
+  key.m_Data[1] |= (uiLargest >> 1) << 15;
+
+  return key;
+}
+
+ezQuat ezCompressedAnimationClip::DequantizeRotation(const QuantizedKey& key)
+{
+  const ezUInt32 uiLargest = (key.m_Data[0] >> 15) | ((key.m_Data[1] >> 15) << 1);
+
+  const float fScale = (2.0f * s_fSmallestThreeRange) / s_fSmallestThreeMaxValue;
+
+  float fSmallest[3];
+  float fSumSqr = 0.0f;
+  for (ezUInt32 c = 0; c < 3; ++c)
+  {
+    fSmallest[c] = (key.m_Data[c] & 0x7FFF) * fScale - s_fSmallestThreeRange;
+    fSumSqr += fSmallest[c] * fSmallest[c];
+  }
+
+  float fComponents[4];
+
+  ezUInt32 uiIn = 0;
+  for (ezUInt32 c = 0; c < 4; ++c)
+  {
+    fComponents[c] = (c == uiLargest) ? ezMath::Sqrt(ezMath::Max(0.0f, 1.0f - fSumSqr)) : fSmallest[uiIn++];
+  }
+
+  ezQuat q;
+  q.SetElements(fComponents[0], fComponents[1], fComponents[2], fComponents[3]);
+  q.Normalize();
+  return q;
+}
+
+void ezCompressedAnimationClip::Clear()
+{
+  m_uiNumJoints = 0;
+  m_uiNumFrames = 0;
+
+  m_Rotations.Clear();
+  m_Translations.Clear();
+  m_Scales.Clear();
+}
+
+ezUInt32 ezCompressedAnimationClip::GetNumStoredKeys() const
+{
+  return m_Rotations.m_Keys.GetCount() + m_Translations.m_Keys.GetCount() + m_Scales.m_Keys.GetCount();
+}
+
+ezTransform ezCompressedAnimationClip::GetJointKeyframe(ezUInt16 uiJoint, ezUInt16 uiFrame) const
+{
+  const float fFrame = uiFrame;
+
+  ezTransform res;
+  res.m_qRotation = m_Rotations.SampleRotation(uiJoint, fFrame);
+  res.m_vPosition = m_Translations.SampleVec3(uiJoint, fFrame);
+  res.m_vScale = m_Scales.SampleVec3(uiJoint, fFrame);
+  return res;
+}
+
+void ezCompressedAnimationClip::SamplePose(ezUInt16 uiFrame, float fLerpToNext, ezArrayPtr<ezTransform> out_Transforms) const
+{
+  const ezUInt32 uiNumJoints = ezMath::Min<ezUInt32>(m_uiNumJoints, out_Transforms.GetCount());
+  const float fFrame = uiFrame + fLerpToNext;
+
+  const ezSimdVec4f vQuatScale((2.0f * s_fSmallestThreeRange) / s_fSmallestThreeMaxValue);
+  const ezSimdVec4f vQuatOffset(-s_fSmallestThreeRange);
+  const ezSimdVec4f vZero = ezSimdVec4f::ZeroVector();
+  const ezSimdVec4f vOne(1.0f);
+  const ezSimdVec4i iIndex0(0);
+  const ezSimdVec4i iIndex1(1);
+  const ezSimdVec4i iIndex2(2);
+  const ezSimdVec4i iIndex3(3);
+
+  // decompresses the smallest-three encoded rotations of four lanes into SoA quaternion components
+  auto DecodeRotations = [&](const LaneData* pQuantized, const ezSimdVec4i& iLargest, ezSimdVec4f* out_pXYZW) {
+    const ezSimdVec4f c0 = ezSimdVec4f::MulAdd(LoadLanes(pQuantized[0]), vQuatScale, vQuatOffset);
+    const ezSimdVec4f c1 = ezSimdVec4f::MulAdd(LoadLanes(pQuantized[1]), vQuatScale, vQuatOffset);
+    const ezSimdVec4f c2 = ezSimdVec4f::MulAdd(LoadLanes(pQuantized[2]), vQuatScale, vQuatOffset);
+
+    const ezSimdVec4f sumSqr = c0.CompMul(c0) + c1.CompMul(c1) + c2.CompMul(c2);
+    const ezSimdVec4f largest = (vOne - sumSqr).CompMax(vZero).GetSqrt();
+
+    const ezSimdVec4b is0 = iLargest == iIndex0;
+    const ezSimdVec4b is1 = iLargest == iIndex1;
+    const ezSimdVec4b is2 = iLargest == iIndex2;
+    const ezSimdVec4b is3 = iLargest == iIndex3;
+
+    out_pXYZW[0] = ezSimdVec4f::Select(is0, largest, c0);
+    out_pXYZW[1] = ezSimdVec4f::Select(is0, c0, ezSimdVec4f::Select(is1, largest, c1));
+    out_pXYZW[2] = ezSimdVec4f::Select(is0 || is1, c1, ezSimdVec4f::Select(is2, largest, c2));
+    out_pXYZW[3] = ezSimdVec4f::Select(is3, largest, c2);
+  };
+
+  for (ezUInt32 uiFirstJoint = 0; uiFirstJoint < uiNumJoints; uiFirstJoint += 4)
+  {
+    const ezUInt32 uiNumLanes = ezMath::Min<ezUInt32>(4, uiNumJoints - uiFirstJoint);
+
+    // gather the keys of four joints into lanes, unused lanes repeat the last joint
+    LaneData rotKeys0[3], rotKeys1[3], rotLerp, rawRot0[4], rawRot1[4];
+    bool bRawRot[4] = {};
+    LaneData posKeys0[3], posKeys1[3], posLerp, posMin[3], posScale[3];
+    LaneData sclKeys0[3], sclKeys1[3], sclLerp, sclMin[3], sclScale[3];
+    ezInt32 iLargest0[4], iLargest1[4];
+
+    for (ezUInt32 uiLane = 0; uiLane < 4; ++uiLane)
+    {
+      const ezUInt32 uiJoint = uiFirstJoint + ezMath::Min(uiLane, uiNumLanes - 1);
+
+      {
+        const Track& track = m_Rotations.m_Tracks[uiJoint];
+        const ezUInt32 uiValue0 = TrackSet::GetValueIndex(track, m_Rotations.FindKey(track, fFrame, rotLerp.m_Values[uiLane]));
+        const ezUInt32 uiValue1 = track.m_uiNumKeys > 1 ? uiValue0 + 1 : uiValue0;
+
+        if (track.m_uiRaw != 0)
+        {
+          // decoded as an arbitrary valid rotation and replaced by the raw value afterwards
+          bRawRot[uiLane] = true;
+          for (ezUInt32 c = 0; c < 4; ++c)
+          {
+            rawRot0[c].m_Values[uiLane] = m_Rotations.m_RawKeys[uiValue0].GetData()[c];
+            rawRot1[c].m_Values[uiLane] = m_Rotations.m_RawKeys[uiValue1].GetData()[c];
+          }
+
+          for (ezUInt32 c = 0; c < 3; ++c)
+          {
+            rotKeys0[c].m_Values[uiLane] = 0.0f;
+            rotKeys1[c].m_Values[uiLane] = 0.0f;
+          }
+
+          iLargest0[uiLane] = 3;
+          iLargest1[uiLane] = 3;
+        }
+        else
+        {
+          const QuantizedKey& key0 = m_Rotations.m_Keys[uiValue0];
+          const QuantizedKey& key1 = m_Rotations.m_Keys[uiValue1];
+
+          for (ezUInt32 c = 0; c < 3; ++c)
+          {
+            rotKeys0[c].m_Values[uiLane] = key0.m_Data[c] & 0x7FFF;
+            rotKeys1[c].m_Values[uiLane] = key1.m_Data[c] & 0x7FFF;
+          }
+
+          iLargest0[uiLane] = (key0.m_Data[0] >> 15) | ((key0.m_Data[1] >> 15) << 1);
+          iLargest1[uiLane] = (key1.m_Data[0] >> 15) | ((key1.m_Data[1] >> 15) << 1);
+        }
+      }
+
+      auto GatherVec3 = [&](const TrackSet& trackSet, LaneData* pKeys0, LaneData* pKeys1, LaneData& lerp, LaneData* pMin, LaneData* pScale) {
+        const Track& track = trackSet.m_Tracks[uiJoint];
+        const ezUInt32 uiValue0 = TrackSet::GetValueIndex(track, trackSet.FindKey(track, fFrame, lerp.m_Values[uiLane]));
+        const ezUInt32 uiValue1 = track.m_uiNumKeys > 1 ? uiValue0 + 1 : uiValue0;
+
+        if (track.m_uiRaw != 0)
+        {
+          // raw values go through the same dequantization, with an offset of zero and a scale of one
+          for (ezUInt32 c = 0; c < 3; ++c)
+          {
+            pKeys0[c].m_Values[uiLane] = trackSet.m_RawKeys[uiValue0].GetData()[c];
+            pKeys1[c].m_Values[uiLane] = trackSet.m_RawKeys[uiValue1].GetData()[c];
+            pMin[c].m_Values[uiLane] = 0.0f;
+            pScale[c].m_Values[uiLane] = 1.0f;
+          }
+
+          return;
+        }
+
+        const QuantizedKey& key0 = trackSet.m_Keys[uiValue0];
+        const QuantizedKey& key1 = trackSet.m_Keys[uiValue1];
+
+        for (ezUInt32 c = 0; c < 3; ++c)
+        {
+          pKeys0[c].m_Values[uiLane] = key0.m_Data[c];
+          pKeys1[c].m_Values[uiLane] = key1.m_Data[c];
+          pMin[c].m_Values[uiLane] = track.m_vMin.GetData()[c];
+          pScale[c].m_Values[uiLane] = track.m_vScale.GetData()[c];
+        }
+      };
+
+      GatherVec3(m_Translations, posKeys0, posKeys1, posLerp, posMin, posScale);
+      GatherVec3(m_Scales, sclKeys0, sclKeys1, sclLerp, sclMin, sclScale);
+    }
+
+    // rotations: decode both keys, nlerp along the shorter arc
+    LaneData rotation[4];
+    {
+      ezSimdVec4f q0[4], q1[4];
+      DecodeRotations(rotKeys0, ezSimdVec4i(iLargest0[0], iLargest0[1], iLargest0[2], iLargest0[3]), q0);
+      DecodeRotations(rotKeys1, ezSimdVec4i(iLargest1[0], iLargest1[1], iLargest1[2], iLargest1[3]), q1);
+
+      const ezSimdVec4b raw(bRawRot[0], bRawRot[1], bRawRot[2], bRawRot[3]);
+      if (raw.AnySet())
+      {
+        for (ezUInt32 c = 0; c < 4; ++c)
+        {
+          q0[c] = ezSimdVec4f::Select(raw, LoadLanes(rawRot0[c]), q0[c]);
+          q1[c] = ezSimdVec4f::Select(raw, LoadLanes(rawRot1[c]), q1[c]);
+        }
+      }
+
+      const ezSimdVec4f dot = q0[0].CompMul(q1[0]) + q0[1].CompMul(q1[1]) + q0[2].CompMul(q1[2]) + q0[3].CompMul(q1[3]);
+      const ezSimdVec4b flip = dot < vZero;
+      const ezSimdVec4f t = LoadLanes(rotLerp);
+
+      ezSimdVec4f q[4];
+      for (ezUInt32 c = 0; c < 4; ++c)
+      {
+        q[c] = ezSimdVec4f::Lerp(q0[c], q1[c].FlipSign(flip), t);
+      }
+
+      const ezSimdVec4f invLength = (q[0].CompMul(q[0]) + q[1].CompMul(q[1]) + q[2].CompMul(q[2]) + q[3].CompMul(q[3])).GetInvSqrt();
+
+      for (ezUInt32 c = 0; c < 4; ++c)
+      {
+        q[c].CompMul(invLength).Store<4>(rotation[c].m_Values);
+      }
+    }
+
+    // translation and scale: dequantize the interpolated keys
+    LaneData position[3], scale[3];
+    {
+      const ezSimdVec4f tPos = LoadLanes(posLerp);
+      const ezSimdVec4f tScl = LoadLanes(sclLerp);
+
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        const ezSimdVec4f p = ezSimdVec4f::Lerp(LoadLanes(posKeys0[c]), LoadLanes(posKeys1[c]), tPos);
+        ezSimdVec4f::MulAdd(p, LoadLanes(posScale[c]), LoadLanes(posMin[c])).Store<4>(position[c].m_Values);
+
+        const ezSimdVec4f s = ezSimdVec4f::Lerp(LoadLanes(sclKeys0[c]), LoadLanes(sclKeys1[c]), tScl);
+        ezSimdVec4f::MulAdd(s, LoadLanes(sclScale[c]), LoadLanes(sclMin[c])).Store<4>(scale[c].m_Values);
+      }
+    }
+
+    for (ezUInt32 uiLane = 0; uiLane < uiNumLanes; ++uiLane)
+    {
+      ezTransform& res = out_Transforms[uiFirstJoint + uiLane];
+      res.m_vPosition.Set(position[0].m_Values[uiLane], position[1].m_Values[uiLane], position[2].m_Values[uiLane]);
+      res.m_qRotation.SetElements(rotation[0].m_Values[uiLane], rotation[1].m_Values[uiLane], rotation[2].m_Values[uiLane], rotation[3].m_Values[uiLane]);
+      res.m_vScale.Set(scale[0].m_Values[uiLane], scale[1].m_Values[uiLane], scale[2].m_Values[uiLane]);
+    }
+  }
+}
+
+void ezCompressedAnimationClip::Save(ezStreamWriter& stream) const
+{
+  const ezUInt8 uiVersion = 1;
+  stream << uiVersion;
+
+  stream << m_uiNumJoints;
+  stream << m_uiNumFrames;
+
+  m_Rotations.Save(stream);
+  m_Translations.Save(stream);
+  m_Scales.Save(stream);
+}
+
+void ezCompressedAnimationClip::Load(ezStreamReader& stream)
+{
+  ezUInt8 uiVersion = 0;
+  stream >> uiVersion;
+
+  EZ_ASSERT_DEV(uiVersion == 1, "Invalid compressed animation clip version {0}", uiVersion);
+
+  stream >> m_uiNumJoints;
+  stream >> m_uiNumFrames;
+
+  m_Rotations.Load(stream);
+  m_Translations.Load(stream);
+  m_Scales.Load(stream);
+}
+
+ezUInt64 ezCompressedAnimationClip::GetHeapMemoryUsage() const
+{
+  return m_Rotations.GetHeapMemoryUsage() + m_Translations.GetHeapMemoryUsage() + m_Scales.GetHeapMemoryUsage();
+}
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_AnimationSystem_Implementation_AnimationClipCompression);
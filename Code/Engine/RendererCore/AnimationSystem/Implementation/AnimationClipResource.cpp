@@ -4,6 +4,7 @@
 #include <RendererCore/AnimationSystem/AnimationClipResource.h>
 #include <RendererCore/AnimationSystem/Skeleton.h>
 #include <RendererCore/AnimationSystem/AnimationPose.h>
+#include <RendererCore/AnimationSystem/LocalAnimationPose.h>
 
 // clang-format off
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezAnimationClipResource, 1, ezRTTIDefaultAllocator<ezAnimationClipResource>)
@@ -107,6 +108,12 @@ ezUInt16 ezAnimationClipResourceDescriptor::GetFrameAt(ezTime time, double& out_
 
   const ezUInt16 uiLowerFrame = static_cast<ezUInt16>(ezMath::Trunc(fFrameIdx));
 
+  if (m_uiNumFrames < 2)
+  {
+    out_fLerpToNext = 0;
+    return 0;
+  }
+
   if (uiLowerFrame + 1 >= m_uiNumFrames)
   {
     out_fLerpToNext = 1;
@@ -137,24 +144,58 @@ ezUInt16 ezAnimationClipResourceDescriptor::FindJointIndexByName(const ezTempHas
 
 ezArrayPtr<const ezTransform> ezAnimationClipResourceDescriptor::GetJointKeyframes(ezUInt16 uiJoint) const
 {
+  EZ_ASSERT_DEV(!IsCompressed(), "Keyframes of compressed animation clips can't be accessed directly, use GetJointKeyframe() instead");
   return ezArrayPtr<const ezTransform>(&m_JointTransforms[uiJoint * m_uiNumFrames], m_uiNumFrames);
 }
 
 ezArrayPtr<ezTransform> ezAnimationClipResourceDescriptor::GetJointKeyframes(ezUInt16 uiJoint)
 {
+  EZ_ASSERT_DEV(!IsCompressed(), "Keyframes of compressed animation clips can't be accessed directly, use GetJointKeyframe() instead");
   return ezArrayPtr<ezTransform>(&m_JointTransforms[uiJoint * m_uiNumFrames], m_uiNumFrames);
 }
 
+ezTransform ezAnimationClipResourceDescriptor::GetJointKeyframe(ezUInt16 uiJoint, ezUInt16 uiKeyframe) const
+{
+  if (IsCompressed())
+  {
+    return m_CompressedClip.GetJointKeyframe(uiJoint, uiKeyframe);
+  }
+
+  return m_JointTransforms[uiJoint * m_uiNumFrames + uiKeyframe];
+}
+
+void ezAnimationClipResourceDescriptor::Compress(const ezAnimationClipCompressionSettings& settings)
+{
+  EZ_ASSERT_DEV(!IsCompressed(), "Animation clip is already compressed");
+
+  // an empty clip stays uncompressed, a clip with a single frame is compressed into constant tracks
+  if (m_uiNumFrames == 0)
+    return;
+
+  const ezUInt16 uiNumTracks = static_cast<ezUInt16>(m_JointTransforms.GetCount() / m_uiNumFrames);
+  m_CompressedClip.Compress(m_JointTransforms, uiNumTracks, m_uiNumFrames, settings);
+
+  m_JointTransforms.Clear();
+  m_JointTransforms.Compact();
+}
+
 void ezAnimationClipResourceDescriptor::Save(ezStreamWriter& stream) const
 {
-  const ezUInt8 uiVersion = 2;
+  const ezUInt8 uiVersion = 3;
   stream << uiVersion;
 
   stream << m_uiNumJoints;
   stream << m_uiNumFrames;
   stream << m_uiFramesPerSecond;
 
-  stream.WriteArray(m_JointTransforms);
+  // version 3
+  const bool bCompressed = IsCompressed();
+  stream << bCompressed;
+
+  if (bCompressed)
+    m_CompressedClip.Save(stream);
+  else
+    stream.WriteArray(m_JointTransforms);
 
   // version 2
   {
@@ -178,7 +219,19 @@ void ezAnimationClipResourceDescriptor::Load(ezStreamReader& stream)
   stream >> m_uiNumFrames;
   stream >> m_uiFramesPerSecond;
 
-  stream.ReadArray(m_JointTransforms);
+  bool bCompressed = false;
+  if (uiVersion >= 3)
+  {
+    stream >> bCompressed;
+  }
+
+  m_CompressedClip.Clear();
+  m_JointTransforms.Clear();
+
+  if (bCompressed)
+    m_CompressedClip.Load(stream);
+  else
+    stream.ReadArray(m_JointTransforms);
 
   m_Duration = ezTime::Seconds((double)(m_uiNumFrames-1) / (double)m_uiFramesPerSecond);
 
@@ -208,7 +261,7 @@ void ezAnimationClipResourceDescriptor::Load(ezStreamReader& stream)
 
 ezUInt64 ezAnimationClipResourceDescriptor::GetHeapMemoryUsage() const
 {
-  return m_JointTransforms.GetHeapMemoryUsage();
+  return m_JointTransforms.GetHeapMemoryUsage() + m_CompressedClip.GetHeapMemoryUsage();
 }
 
 bool ezAnimationClipResourceDescriptor::HasRootMotion() const
@@ -234,6 +287,13 @@ ezUInt16 ezAnimationClipResourceDescriptor::GetRootMotionJoint() const
 
 void ezAnimationClipResourceDescriptor::SetPoseToKeyframe(ezAnimationPose& pose, const ezSkeleton& skeleton, ezUInt16 uiKeyframe) const
 {
+  if (IsCompressed())
+  {
+    // sampling exactly at a keyframe is the same as blending with zero weight
+    SetPoseToBlendedKeyframe(pose, skeleton, uiKeyframe, 0.0f);
+    return;
+  }
+
   for (ezUInt32 b = 0; b < m_JointNameToIndex.GetCount(); ++b)
   {
     const ezHashedString& sJointName = m_JointNameToIndex.GetKey(b);
@@ -253,6 +313,41 @@ void ezAnimationClipResourceDescriptor::SetPoseToKeyframe(ezAnimationPose& pose,
 void ezAnimationClipResourceDescriptor::SetPoseToBlendedKeyframe(ezAnimationPose& pose, const ezSkeleton& skeleton, ezUInt16 uiKeyframe0,
                                                                  float fBlendToKeyframe1) const
 {
+  SampleBlendedKeyframe(skeleton, uiKeyframe0, fBlendToKeyframe1, [&](ezUInt16 uiSkeletonJointIdx, const ezTransform& transform) {
+    pose.SetTransform(uiSkeletonJointIdx, transform.GetAsMat4());
+  });
+}
+
+void ezAnimationClipResourceDescriptor::SetPoseToBlendedKeyframe(ezLocalAnimationPose& pose, const ezSkeleton& skeleton, ezUInt16 uiKeyframe0,
+                                                                 float fBlendToKeyframe1) const
+{
+  SampleBlendedKeyframe(skeleton, uiKeyframe0, fBlendToKeyframe1, [&](ezUInt16 uiSkeletonJointIdx, const ezTransform& transform) {
+    pose.SetJointTransform(uiSkeletonJointIdx, transform);
+  });
+}
+
+template <typename Callback>
+void ezAnimationClipResourceDescriptor::SampleBlendedKeyframe(const ezSkeleton& skeleton, ezUInt16 uiKeyframe0, float fBlendToKeyframe1, Callback cb) const
+{
+  if (IsCompressed())
+  {
+    // decompress all joints at once, this is done four joints at a time
+    ezHybridArray<ezTransform, 128> transforms;
+    transforms.SetCountUninitialized(m_CompressedClip.GetNumJoints());
+    m_CompressedClip.SamplePose(uiKeyframe0, fBlendToKeyframe1, transforms);
+
+    for (ezUInt32 b = 0; b < m_JointNameToIndex.GetCount(); ++b)
+    {
+      const ezUInt16 uiSkeletonJointIdx = skeleton.FindJointByName(m_JointNameToIndex.GetKey(b));
+      if (uiSkeletonJointIdx != ezInvalidJointIndex)
+      {
+        cb(uiSkeletonJointIdx, transforms[m_JointNameToIndex.GetValue(b)]);
+      }
+    }
+
+    return;
+  }
+
   for (ezUInt32 b = 0; b < m_JointNameToIndex.GetCount(); ++b)
   {
     const ezHashedString& sJointName = m_JointNameToIndex.GetKey(b);
@@ -270,7 +365,7 @@ void ezAnimationClipResourceDescriptor::SetPoseToBlendedKeyframe(ezAnimationPose
       res.m_qRotation.SetSlerp(jointTransform1.m_qRotation, jointTransform2.m_qRotation, fBlendToKeyframe1);
       res.m_vScale = ezMath::Lerp(jointTransform1.m_vScale, jointTransform2.m_vScale, fBlendToKeyframe1);
 
-      pose.SetTransform(uiSkeletonJointIdx, res.GetAsMat4());
+      cb(uiSkeletonJointIdx, res);
     }
   }
 }
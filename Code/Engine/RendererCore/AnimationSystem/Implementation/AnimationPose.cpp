@@ -1,6 +1,8 @@
 #include <RendererCorePCH.h>
 
+#include <Foundation/SimdMath/SimdConversion.h>
 #include <RendererCore/AnimationSystem/AnimationPose.h>
+#include <RendererCore/AnimationSystem/LocalAnimationPose.h>
 #include <RendererCore/AnimationSystem/Skeleton.h>
 #include <RendererCore/Debug/DebugRenderer.h>
 
@@ -59,7 +61,10 @@ void ezAnimationPose::ConvertFromLocalSpaceToObjectSpace(const ezSkeleton& skele
     if (!joint.IsRootJoint())
     {
       // else grab transform of parent joint and use it to make the final transform for this joint
-      m_Transforms[i] = m_Transforms[joint.GetParentIndex()] * m_Transforms[i];
+      const ezSimdMat4f parent = ezSimdConversion::ToMat4(m_Transforms[joint.GetParentIndex()]);
+      const ezSimdMat4f local = ezSimdConversion::ToMat4(m_Transforms[i]);
+
+      (parent * local).GetAsArray(m_Transforms[i].m_fElementsCM, ezMatrixLayout::ColumnMajor);
     }
   }
 }
@@ -71,14 +76,27 @@ void ezAnimationPose::ConvertFromObjectSpaceToSkinningSpace(const ezSkeleton& sk
   // STEP 2: multiply each joint's individual inverse-global-pose matrix into the result
 
   const ezUInt32 numTransforms = GetTransformCount();
+  ezArrayPtr<const ezSimdMat4f> inverseBindPose = skeleton.GetInverseBindPoseMatrices();
+
+  EZ_ASSERT_DEV(inverseBindPose.GetCount() == numTransforms, "Pose and skeleton have different joint count!");
 
   for (ezUInt32 i = 0; i < numTransforms; ++i)
   {
-    const ezSkeletonJoint& joint = skeleton.GetJointByIndex(i);
-    m_Transforms[i] = m_Transforms[i] * joint.GetInverseBindPoseGlobalTransform().GetAsMat4();
+    const ezSimdMat4f objectSpace = ezSimdConversion::ToMat4(m_Transforms[i]);
+
+    (objectSpace * inverseBindPose[i]).GetAsArray(m_Transforms[i].m_fElementsCM, ezMatrixLayout::ColumnMajor);
   }
 }
 
+void ezAnimationPose::SetFromLocalPose(const ezSkeleton& skeleton, const ezLocalAnimationPose& localPose, ezArrayPtr<ezMat4> out_SkinningTransforms /*= ezArrayPtr<ezMat4>()*/)
+{
+  EZ_ASSERT_DEV(localPose.GetJointCount() == GetTransformCount(), "Pose and local pose have different joint count!");
+
+  localPose.ComputeSkinningTransforms(skeleton, m_Transforms, out_SkinningTransforms);
+
+  m_TransformsValid.SetAllBits();
+}
+
 ezVec3 ezAnimationPose::SkinPositionWithSingleJoint(const ezVec3& Position, ezUInt32 uiIndex) const
 {
   return m_Transforms[uiIndex].TransformPosition(Position);
@@ -0,0 +1,432 @@
+#include <RendererCorePCH.h>
+
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <RendererCore/AnimationSystem/LocalAnimationPose.h>
+#include <RendererCore/AnimationSystem/Skeleton.h>
+#include <RendererCore/Shader/Types.h>
+
+namespace
+{
+  /// \brief The rotations of four joints, one component per lane.
+  struct QuatLanes
+  {
+    ezSimdVec4f x, y, z, w;
+
+    EZ_ALWAYS_INLINE void Load(const float (&data)[4][4])
+    {
+      x.Load<4>(data[0]);
+      y.Load<4>(data[1]);
+      z.Load<4>(data[2]);
+      w.Load<4>(data[3]);
+    }
+
+    EZ_ALWAYS_INLINE void Store(float (&data)[4][4]) const
+    {
+      x.Store<4>(data[0]);
+      y.Store<4>(data[1]);
+      z.Store<4>(data[2]);
+      w.Store<4>(data[3]);
+    }
+
+    EZ_ALWAYS_INLINE ezSimdVec4f Dot(const QuatLanes& rhs) const
+    {
+      return ezSimdVec4f::MulAdd(x, rhs.x, ezSimdVec4f::MulAdd(y, rhs.y, ezSimdVec4f::MulAdd(z, rhs.z, w.CompMul(rhs.w))));
+    }
+
+    EZ_ALWAYS_INLINE void Normalize()
+    {
+      const ezSimdVec4f invLen = Dot(*this).GetInvSqrt();
+      x = x.CompMul(invLen);
+      y = y.CompMul(invLen);
+      z = z.CompMul(invLen);
+      w = w.CompMul(invLen);
+    }
+
+    /// \brief Normalized lerp from this to \a to along the shortest path, with one weight per lane.
+    EZ_ALWAYS_INLINE void NLerp(const QuatLanes& to, const ezSimdVec4f& weight)
+    {
+      const ezSimdVec4b flip = Dot(to) < ezSimdVec4f::ZeroVector();
+
+      x = ezSimdVec4f::Lerp(x, to.x.FlipSign(flip), weight);
+      y = ezSimdVec4f::Lerp(y, to.y.FlipSign(flip), weight);
+      z = ezSimdVec4f::Lerp(z, to.z.FlipSign(flip), weight);
+      w = ezSimdVec4f::Lerp(w, to.w.FlipSign(flip), weight);
+
+      Normalize();
+    }
+
+    /// \brief Returns lhs * rhs, with the same convention as ezQuat.
+    static EZ_ALWAYS_INLINE QuatLanes Multiply(const QuatLanes& lhs, const QuatLanes& rhs)
+    {
+      QuatLanes res;
+      res.w = lhs.w.CompMul(rhs.w) - ezSimdVec4f::MulAdd(lhs.x, rhs.x, ezSimdVec4f::MulAdd(lhs.y, rhs.y, lhs.z.CompMul(rhs.z)));
+      res.x = ezSimdVec4f::MulAdd(lhs.w, rhs.x, ezSimdVec4f::MulAdd(lhs.x, rhs.w, lhs.y.CompMul(rhs.z))) - lhs.z.CompMul(rhs.y);
+      res.y = ezSimdVec4f::MulAdd(lhs.w, rhs.y, ezSimdVec4f::MulAdd(lhs.y, rhs.w, lhs.z.CompMul(rhs.x))) - lhs.x.CompMul(rhs.z);
+      res.z = ezSimdVec4f::MulAdd(lhs.w, rhs.z, ezSimdVec4f::MulAdd(lhs.z, rhs.w, lhs.x.CompMul(rhs.y))) - lhs.y.CompMul(rhs.x);
+      return res;
+    }
+  };
+
+  /// \brief Three component vectors of four joints, one component per lane.
+  struct Vec3Lanes
+  {
+    ezSimdVec4f x, y, z;
+
+    EZ_ALWAYS_INLINE void Load(const float (&data)[3][4])
+    {
+      x.Load<4>(data[0]);
+      y.Load<4>(data[1]);
+      z.Load<4>(data[2]);
+    }
+
+    EZ_ALWAYS_INLINE void Store(float (&data)[3][4]) const
+    {
+      x.Store<4>(data[0]);
+      y.Store<4>(data[1]);
+      z.Store<4>(data[2]);
+    }
+  };
+
+  EZ_ALWAYS_INLINE ezSimdVec4f GetGroupWeight(const ezSimdVec4f& weight, const ezAnimationJointMask* pMask, ezUInt32 uiGroup)
+  {
+    if (pMask == nullptr)
+      return weight;
+
+    ezSimdVec4f maskWeight;
+    maskWeight.Load<4>(pMask->GetWeights().GetPtr() + uiGroup * 4);
+    return weight.CompMul(maskWeight);
+  }
+
+  EZ_ALWAYS_INLINE void StoreSkinningTransform(ezMat4& out, const ezSimdMat4f& m) { out = ezSimdConversion::ToMat4(m); }
+  EZ_ALWAYS_INLINE void StoreSkinningTransform(ezShaderTransform& out, const ezSimdMat4f& m) { out = ezSimdConversion::ToMat4(m); }
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+void ezAnimationJointMask::Configure(const ezSkeleton& skeleton, float fWeight /*= 1.0f*/)
+{
+  m_uiNumJoints = skeleton.GetJointCount();
+
+  // padding joints get a weight of zero, they are identity transforms anyway
+  m_Weights.SetCountUninitialized(ezMemoryUtils::AlignSize<ezUInt32>(m_uiNumJoints, 4));
+  for (ezUInt32 i = 0; i < m_Weights.GetCount(); ++i)
+  {
+    m_Weights[i] = i < m_uiNumJoints ? fWeight : 0.0f;
+  }
+}
+
+void ezAnimationJointMask::SetHierarchyWeight(const ezSkeleton& skeleton, ezUInt16 uiRootJoint, float fWeight)
+{
+  EZ_ASSERT_DEV(skeleton.GetJointCount() == m_uiNumJoints, "Joint mask and skeleton have different joint count!");
+
+  // children always come after their parents, so nothing before the root joint can be affected
+  for (ezUInt16 i = uiRootJoint; i < m_uiNumJoints; ++i)
+  {
+    if (skeleton.IsJointDescendantOf(i, uiRootJoint))
+    {
+      m_Weights[i] = fWeight;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezLocalAnimationPose::ezLocalAnimationPose() = default;
+ezLocalAnimationPose::~ezLocalAnimationPose() = default;
+
+void ezLocalAnimationPose::Configure(const ezSkeleton& skeleton)
+{
+  EZ_ASSERT_DEV(skeleton.GetJointCount() > 0, "Animation pose needs a valid skeleton which also has at least one joint!");
+
+  m_uiNumJoints = skeleton.GetJointCount();
+  m_Groups.SetCountUninitialized((m_uiNumJoints + 3) / 4);
+
+  SetToIdentity();
+  SetToBindPose(skeleton);
+}
+
+void ezLocalAnimationPose::SetToBindPose(const ezSkeleton& skeleton)
+{
+  EZ_ASSERT_DEV(skeleton.GetJointCount() == m_uiNumJoints, "Pose and skeleton have different joint count!");
+
+  for (ezUInt16 i = 0; i < m_uiNumJoints; ++i)
+  {
+    SetJointTransform(i, skeleton.GetJointByIndex(i).GetBindPoseLocalTransform());
+  }
+}
+
+void ezLocalAnimationPose::SetToIdentity()
+{
+  const ezSimdVec4f zero = ezSimdVec4f::ZeroVector();
+  const ezSimdVec4f one(1.0f);
+
+  for (JointGroup& group : m_Groups)
+  {
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      zero.Store<4>(group.m_Rotation[c]);
+      zero.Store<4>(group.m_Translation[c]);
+      one.Store<4>(group.m_Scale[c]);
+    }
+
+    one.Store<4>(group.m_Rotation[3]);
+  }
+}
+
+void ezLocalAnimationPose::SetJointTransform(ezUInt16 uiJoint, const ezTransform& transform)
+{
+  JointGroup& group = m_Groups[uiJoint / 4];
+  const ezUInt32 uiLane = uiJoint % 4;
+
+  group.m_Rotation[0][uiLane] = transform.m_qRotation.v.x;
+  group.m_Rotation[1][uiLane] = transform.m_qRotation.v.y;
+  group.m_Rotation[2][uiLane] = transform.m_qRotation.v.z;
+  group.m_Rotation[3][uiLane] = transform.m_qRotation.w;
+
+  group.m_Translation[0][uiLane] = transform.m_vPosition.x;
+  group.m_Translation[1][uiLane] = transform.m_vPosition.y;
+  group.m_Translation[2][uiLane] = transform.m_vPosition.z;
+
+  group.m_Scale[0][uiLane] = transform.m_vScale.x;
+  group.m_Scale[1][uiLane] = transform.m_vScale.y;
+  group.m_Scale[2][uiLane] = transform.m_vScale.z;
+}
+
+ezTransform ezLocalAnimationPose::GetJointTransform(ezUInt16 uiJoint) const
+{
+  const JointGroup& group = m_Groups[uiJoint / 4];
+  const ezUInt32 uiLane = uiJoint % 4;
+
+  ezTransform res;
+  res.m_qRotation.v.Set(group.m_Rotation[0][uiLane], group.m_Rotation[1][uiLane], group.m_Rotation[2][uiLane]);
+  res.m_qRotation.w = group.m_Rotation[3][uiLane];
+  res.m_vPosition.Set(group.m_Translation[0][uiLane], group.m_Translation[1][uiLane], group.m_Translation[2][uiLane]);
+  res.m_vScale.Set(group.m_Scale[0][uiLane], group.m_Scale[1][uiLane], group.m_Scale[2][uiLane]);
+  return res;
+}
+
+void ezLocalAnimationPose::Blend(const ezLocalAnimationPose& other, float fWeight, const ezAnimationJointMask* pMask /*= nullptr*/)
+{
+  EZ_ASSERT_DEV(other.m_uiNumJoints == m_uiNumJoints, "Poses have different joint count!");
+  EZ_ASSERT_DEV(pMask == nullptr || pMask->GetJointCount() == m_uiNumJoints, "Joint mask has a different joint count!");
+
+  const ezSimdVec4f weight(fWeight);
+
+  for (ezUInt32 g = 0; g < m_Groups.GetCount(); ++g)
+  {
+    JointGroup& group = m_Groups[g];
+    const JointGroup& otherGroup = other.m_Groups[g];
+
+    const ezSimdVec4f w = GetGroupWeight(weight, pMask, g);
+
+    QuatLanes rot, otherRot;
+    rot.Load(group.m_Rotation);
+    otherRot.Load(otherGroup.m_Rotation);
+    rot.NLerp(otherRot, w);
+    rot.Store(group.m_Rotation);
+
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      ezSimdVec4f a, b;
+
+      a.Load<4>(group.m_Translation[c]);
+      b.Load<4>(otherGroup.m_Translation[c]);
+      ezSimdVec4f::Lerp(a, b, w).Store<4>(group.m_Translation[c]);
+
+      a.Load<4>(group.m_Scale[c]);
+      b.Load<4>(otherGroup.m_Scale[c]);
+      ezSimdVec4f::Lerp(a, b, w).Store<4>(group.m_Scale[c]);
+    }
+  }
+}
+
+void ezLocalAnimationPose::BlendAdditive(const ezLocalAnimationPose& additive, float fWeight, const ezAnimationJointMask* pMask /*= nullptr*/)
+{
+  EZ_ASSERT_DEV(additive.m_uiNumJoints == m_uiNumJoints, "Poses have different joint count!");
+  EZ_ASSERT_DEV(pMask == nullptr || pMask->GetJointCount() == m_uiNumJoints, "Joint mask has a different joint count!");
+
+  const ezSimdVec4f weight(fWeight);
+  const ezSimdVec4f zero = ezSimdVec4f::ZeroVector();
+  const ezSimdVec4f one(1.0f);
+
+  for (ezUInt32 g = 0; g < m_Groups.GetCount(); ++g)
+  {
+    JointGroup& group = m_Groups[g];
+    const JointGroup& addGroup = additive.m_Groups[g];
+
+    const ezSimdVec4f w = GetGroupWeight(weight, pMask, g);
+
+    // scale the additive rotation by blending it with identity, then apply it on top of the base rotation
+    QuatLanes delta, rot;
+    delta.Load(addGroup.m_Rotation);
+
+    QuatLanes weightedDelta;
+    weightedDelta.x = zero;
+    weightedDelta.y = zero;
+    weightedDelta.z = zero;
+    weightedDelta.w = one;
+    weightedDelta.NLerp(delta, w);
+
+    rot.Load(group.m_Rotation);
+    rot = QuatLanes::Multiply(weightedDelta, rot);
+    rot.Store(group.m_Rotation);
+
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      ezSimdVec4f a, b;
+
+      a.Load<4>(group.m_Translation[c]);
+      b.Load<4>(addGroup.m_Translation[c]);
+      ezSimdVec4f::MulAdd(b, w, a).Store<4>(group.m_Translation[c]);
+
+      a.Load<4>(group.m_Scale[c]);
+      b.Load<4>(addGroup.m_Scale[c]);
+      a.CompMul(ezSimdVec4f::Lerp(one, b, w)).Store<4>(group.m_Scale[c]);
+    }
+  }
+}
+
+void ezLocalAnimationPose::MakeAdditive(const ezLocalAnimationPose& reference)
+{
+  EZ_ASSERT_DEV(reference.m_uiNumJoints == m_uiNumJoints, "Poses have different joint count!");
+
+  for (ezUInt32 g = 0; g < m_Groups.GetCount(); ++g)
+  {
+    JointGroup& group = m_Groups[g];
+    const JointGroup& refGroup = reference.m_Groups[g];
+
+    // delta = this * inverse(reference), so that delta * reference == this
+    QuatLanes rot, refRot;
+    rot.Load(group.m_Rotation);
+    refRot.Load(refGroup.m_Rotation);
+    refRot.x = -refRot.x;
+    refRot.y = -refRot.y;
+    refRot.z = -refRot.z;
+
+    rot = QuatLanes::Multiply(rot, refRot);
+    rot.Store(group.m_Rotation);
+
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      ezSimdVec4f a, b;
+
+      a.Load<4>(group.m_Translation[c]);
+      b.Load<4>(refGroup.m_Translation[c]);
+      (a - b).Store<4>(group.m_Translation[c]);
+
+      a.Load<4>(group.m_Scale[c]);
+      b.Load<4>(refGroup.m_Scale[c]);
+      a.CompDiv(b).Store<4>(group.m_Scale[c]);
+    }
+  }
+}
+
+void ezLocalAnimationPose::ComputeModelSpaceTransforms(const ezSkeleton& skeleton, ezArrayPtr<ezMat4> out_ModelSpace) const
+{
+  ComputeTransforms<ezMat4>(skeleton, out_ModelSpace, ezArrayPtr<ezMat4>());
+}
+
+void ezLocalAnimationPose::ComputeSkinningTransforms(const ezSkeleton& skeleton, ezArrayPtr<ezMat4> out_ModelSpace, ezArrayPtr<ezMat4> out_Skinning) const
+{
+  ComputeTransforms<ezMat4>(skeleton, out_ModelSpace, out_Skinning);
+}
+
+void ezLocalAnimationPose::ComputeSkinningTransforms(const ezSkeleton& skeleton, ezArrayPtr<ezMat4> out_ModelSpace, ezArrayPtr<ezShaderTransform> out_Skinning) const
+{
+  ComputeTransforms<ezShaderTransform>(skeleton, out_ModelSpace, out_Skinning);
+}
+
+template <typename SkinningType>
+void ezLocalAnimationPose::ComputeTransforms(const ezSkeleton& skeleton, ezArrayPtr<ezMat4> out_ModelSpace, ezArrayPtr<SkinningType> out_Skinning) const
+{
+  const ezUInt32 uiNumJoints = m_uiNumJoints;
+
+  EZ_ASSERT_DEV(skeleton.GetJointCount() == uiNumJoints, "Pose and skeleton have different joint count!");
+  EZ_ASSERT_DEV(out_ModelSpace.IsEmpty() || out_ModelSpace.GetCount() >= uiNumJoints, "Model space output array is too small");
+  EZ_ASSERT_DEV(out_Skinning.IsEmpty() || out_Skinning.GetCount() >= uiNumJoints, "Skinning output array is too small");
+
+  // the model space transforms of the parents are needed while walking down the hierarchy
+  ezHybridArray<ezMat4, 128> tempModelSpace;
+  if (out_ModelSpace.IsEmpty())
+  {
+    tempModelSpace.SetCountUninitialized(uiNumJoints);
+    out_ModelSpace = tempModelSpace;
+  }
+
+  ezArrayPtr<const ezSimdMat4f> inverseBindPose = skeleton.GetInverseBindPoseMatrices();
+  const bool bSkinning = !out_Skinning.IsEmpty();
+
+  const ezSimdVec4f zero = ezSimdVec4f::ZeroVector();
+  const ezSimdVec4f one(1.0f);
+
+  for (ezUInt32 g = 0; g < m_Groups.GetCount(); ++g)
+  {
+    const JointGroup& group = m_Groups[g];
+
+    // convert four joints at once into the columns of their local matrices
+    QuatLanes q;
+    q.Load(group.m_Rotation);
+
+    Vec3Lanes t, s;
+    t.Load(group.m_Translation);
+    s.Load(group.m_Scale);
+
+    const ezSimdVec4f x2 = q.x + q.x;
+    const ezSimdVec4f y2 = q.y + q.y;
+    const ezSimdVec4f z2 = q.z + q.z;
+
+    const ezSimdVec4f xx = q.x.CompMul(x2);
+    const ezSimdVec4f yy = q.y.CompMul(y2);
+    const ezSimdVec4f zz = q.z.CompMul(z2);
+    const ezSimdVec4f xy = q.x.CompMul(y2);
+    const ezSimdVec4f xz = q.x.CompMul(z2);
+    const ezSimdVec4f yz = q.y.CompMul(z2);
+    const ezSimdVec4f wx = q.w.CompMul(x2);
+    const ezSimdVec4f wy = q.w.CompMul(y2);
+    const ezSimdVec4f wz = q.w.CompMul(z2);
+
+    // each matrix holds one column for all four joints, transposing it yields that column per joint
+    ezSimdMat4f col0((one - (yy + zz)).CompMul(s.x), (xy + wz).CompMul(s.x), (xz - wy).CompMul(s.x), zero);
+    ezSimdMat4f col1((xy - wz).CompMul(s.y), (one - (xx + zz)).CompMul(s.y), (yz + wx).CompMul(s.y), zero);
+    ezSimdMat4f col2((xz + wy).CompMul(s.z), (yz - wx).CompMul(s.z), (one - (xx + yy)).CompMul(s.z), zero);
+    ezSimdMat4f col3(t.x, t.y, t.z, one);
+    col0.Transpose();
+    col1.Transpose();
+    col2.Transpose();
+    col3.Transpose();
+
+    const ezSimdMat4f local[4] = {
+      ezSimdMat4f(col0.m_col0, col1.m_col0, col2.m_col0, col3.m_col0),
+      ezSimdMat4f(col0.m_col1, col1.m_col1, col2.m_col1, col3.m_col1),
+      ezSimdMat4f(col0.m_col2, col1.m_col2, col2.m_col2, col3.m_col2),
+      ezSimdMat4f(col0.m_col3, col1.m_col3, col2.m_col3, col3.m_col3),
+    };
+
+    // now concatenate with the parents, which have all been computed already since the joints are sorted
+    const ezUInt32 uiFirstJoint = g * 4;
+    const ezUInt32 uiEndJoint = ezMath::Min(uiFirstJoint + 4, uiNumJoints);
+
+    for (ezUInt32 i = uiFirstJoint; i < uiEndJoint; ++i)
+    {
+      const ezUInt16 uiParent = skeleton.GetJointByIndex(static_cast<ezUInt16>(i)).GetParentIndex();
+
+      ezSimdMat4f model = local[i - uiFirstJoint];
+
+      if (uiParent != ezInvalidJointIndex)
+      {
+        model = ezSimdConversion::ToMat4(out_ModelSpace[uiParent]) * model;
+      }
+
+      model.GetAsArray(out_ModelSpace[i].m_fElementsCM, ezMatrixLayout::ColumnMajor);
+
+      if (bSkinning)
+      {
+        StoreSkinningTransform(out_Skinning[i], model * inverseBindPose[i]);
+      }
+    }
+  }
+}
+
+
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_AnimationSystem_Implementation_LocalAnimationPose);
@@ -1,5 +1,6 @@
 #include <RendererCorePCH.h>
 
+#include <Foundation/SimdMath/SimdConversion.h>
 #include <RendererCore/AnimationSystem/Skeleton.h>
 
 ezSkeleton::ezSkeleton() = default;
@@ -108,6 +109,8 @@ void ezSkeleton::Load(ezStreamReader& stream)
       stream >> joint.m_InverseBindPoseGlobal;
     }
   }
+
+  ComputeInverseBindPoseMatrices();
 }
 
 bool ezSkeleton::IsJointDescendantOf(ezUInt16 uiJoint, ezUInt16 uiExpectedParent) const
@@ -126,6 +129,17 @@ bool ezSkeleton::IsJointDescendantOf(ezUInt16 uiJoint, ezUInt16 uiExpectedParent
   return false;
 }
 
+void ezSkeleton::ComputeInverseBindPoseMatrices()
+{
+  const ezUInt32 uiNumJoints = m_Joints.GetCount();
+  m_InverseBindPoseMatrices.SetCountUninitialized(uiNumJoints);
+
+  for (ezUInt32 i = 0; i < uiNumJoints; ++i)
+  {
+    m_InverseBindPoseMatrices[i] = ezSimdConversion::ToMat4(m_Joints[i].m_InverseBindPoseGlobal.GetAsMat4());
+  }
+}
+
 // void ezSkeleton::ApplyGlobalTransform(const ezMat3& transform)
 //{
 //  ezMat4 totalTransform(transform, ezVec3::ZeroVector());
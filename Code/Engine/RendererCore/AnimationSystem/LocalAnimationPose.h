@@ -0,0 +1,103 @@
+#pragma once
+
+#include <RendererCore/AnimationSystem/Declarations.h>
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Math/Transform.h>
+
+class ezSkeleton;
+class ezShaderTransform;
+
+/// \brief Stores one weight per joint, which is used to restrict blending operations of ezLocalAnimationPose to parts of a skeleton.
+///
+/// The weights are stored padded to a multiple of four joints, so that they can be applied four joints at a time.
+class EZ_RENDERERCORE_DLL ezAnimationJointMask
+{
+public:
+  /// \brief Allocates one weight for every joint in the skeleton and sets all of them to \a fWeight.
+  void Configure(const ezSkeleton& skeleton, float fWeight = 1.0f);
+
+  ezUInt16 GetJointCount() const { return m_uiNumJoints; }
+
+  void SetJointWeight(ezUInt16 uiJoint, float fWeight) { m_Weights[uiJoint] = fWeight; }
+  float GetJointWeight(ezUInt16 uiJoint) const { return m_Weights[uiJoint]; }
+
+  /// \brief Sets the weight of \a uiRootJoint and all joints below it.
+  void SetHierarchyWeight(const ezSkeleton& skeleton, ezUInt16 uiRootJoint, float fWeight);
+
+  /// \brief Returns the weights padded to a multiple of four.
+  ezArrayPtr<const float> GetWeights() const { return m_Weights; }
+
+private:
+  ezUInt16 m_uiNumJoints = 0;
+  ezDynamicArray<float, ezAlignedAllocatorWrapper> m_Weights;
+};
+
+/// \brief Stores the local (parent relative) transforms of all joints of a skeleton in a SIMD friendly layout.
+///
+/// Joints are stored in groups of four. Each group keeps the x, y, z and w components of the four rotations, translations and scales
+/// in separate lanes, so that blending operations process four joints with every SIMD instruction.
+/// The number of joints is padded to a multiple of four, the padding joints are always identity transforms.
+///
+/// Once all blending is done, the pose is converted to model space or skinning space in a single pass over the skeleton.
+/// This relies on the skeleton being sorted, ie. parent joints come before their child joints.
+class EZ_RENDERERCORE_DLL ezLocalAnimationPose
+{
+public:
+  ezLocalAnimationPose();
+  ~ezLocalAnimationPose();
+
+  /// \brief Allocates storage for all joints of the skeleton and sets the pose to the skeleton's bind pose.
+  void Configure(const ezSkeleton& skeleton);
+
+  ezUInt16 GetJointCount() const { return m_uiNumJoints; }
+
+  /// \brief Sets all transforms to the local bind pose of the skeleton.
+  void SetToBindPose(const ezSkeleton& skeleton);
+
+  /// \brief Sets all transforms to identity. Useful as the starting point for accumulating additive poses.
+  void SetToIdentity();
+
+  void SetJointTransform(ezUInt16 uiJoint, const ezTransform& transform);
+  ezTransform GetJointTransform(ezUInt16 uiJoint) const;
+
+  /// \brief Blends this pose towards \a other. A weight of zero keeps this pose, a weight of one copies \a other.
+  ///
+  /// If a mask is given, the weight of every joint is additionally multiplied by the joint's mask weight.
+  /// Rotations are interpolated with a normalized lerp along the shortest path.
+  void Blend(const ezLocalAnimationPose& other, float fWeight, const ezAnimationJointMask* pMask = nullptr);
+
+  /// \brief Applies an additive pose, as created by MakeAdditive(), on top of this pose.
+  void BlendAdditive(const ezLocalAnimationPose& additive, float fWeight, const ezAnimationJointMask* pMask = nullptr);
+
+  /// \brief Turns this pose into the difference to \a reference, such that applying it to \a reference with BlendAdditive() and a weight of
+  /// one results in the original pose again.
+  void MakeAdditive(const ezLocalAnimationPose& reference);
+
+  /// \brief Concatenates all joints with their parents and writes one model space matrix per joint.
+  void ComputeModelSpaceTransforms(const ezSkeleton& skeleton, ezArrayPtr<ezMat4> out_ModelSpace) const;
+
+  /// \brief Like ComputeModelSpaceTransforms() but additionally applies the inverse bind pose, so the result can be used directly for skinning.
+  ///
+  /// \a out_ModelSpace may be empty, if the model space transforms are not needed.
+  void ComputeSkinningTransforms(const ezSkeleton& skeleton, ezArrayPtr<ezMat4> out_ModelSpace, ezArrayPtr<ezMat4> out_Skinning) const;
+
+  /// \brief Same as above, but writes the skinning transforms in the layout that the shaders use.
+  void ComputeSkinningTransforms(const ezSkeleton& skeleton, ezArrayPtr<ezMat4> out_ModelSpace, ezArrayPtr<ezShaderTransform> out_Skinning) const;
+
+private:
+  template <typename SkinningType>
+  void ComputeTransforms(const ezSkeleton& skeleton, ezArrayPtr<ezMat4> out_ModelSpace, ezArrayPtr<SkinningType> out_Skinning) const;
+
+  struct JointGroup
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    float m_Rotation[4][4];    ///< [x, y, z, w][joint]
+    float m_Translation[3][4]; ///< [x, y, z][joint]
+    float m_Scale[3][4];       ///< [x, y, z][joint]
+  };
+
+  ezUInt16 m_uiNumJoints = 0;
+  ezDynamicArray<JointGroup, ezAlignedAllocatorWrapper> m_Groups;
+};
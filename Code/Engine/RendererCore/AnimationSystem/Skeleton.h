@@ -4,6 +4,7 @@
 
 #include <Foundation/Math/Mat3.h>
 #include <Foundation/Reflection/Reflection.h>
+#include <Foundation/SimdMath/SimdMat4f.h>
 #include <Foundation/Strings/HashedString.h>
 #include <Foundation/Types/UniquePtr.h>
 #include <RendererCore/AnimationSystem/Declarations.h>
@@ -66,12 +67,21 @@ public:
 
   bool IsJointDescendantOf(ezUInt16 uiJoint, ezUInt16 uiExpectedParent) const;
 
+  /// \brief Returns the inverse global bind pose of every joint as a matrix.
+  ///
+  /// This is the same data as ezSkeletonJoint::GetInverseBindPoseGlobalTransform(), but already converted, so that computing
+  /// skinning matrices doesn't need to convert it for every pose again.
+  ezArrayPtr<const ezSimdMat4f> GetInverseBindPoseMatrices() const { return m_InverseBindPoseMatrices; }
+
   /// \brief Applies a global transform to the skeleton (used by the importer to correct scale and up-axis)
   // void ApplyGlobalTransform(const ezMat3& transform);
 
 protected:
   friend ezSkeletonBuilder;
 
+  void ComputeInverseBindPoseMatrices();
+
   ezDynamicArray<ezSkeletonJoint> m_Joints;
+  ezDynamicArray<ezSimdMat4f, ezAlignedAllocatorWrapper> m_InverseBindPoseMatrices;
 };
 
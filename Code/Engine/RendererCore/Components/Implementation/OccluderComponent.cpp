@@ -0,0 +1,124 @@
+#include <RendererCorePCH.h>
+
+#include <Core/Messages/UpdateLocalBoundsMessage.h>
+#include <Core/WorldSerializer/WorldReader.h>
+#include <Core/WorldSerializer/WorldWriter.h>
+#include <RendererCore/Components/OccluderComponent.h>
+
+// clang-format off
+EZ_BEGIN_COMPONENT_TYPE(ezOccluderComponent, 1, ezComponentMode::Static)
+{
+  EZ_BEGIN_PROPERTIES
+  {
+    EZ_ACCESSOR_PROPERTY("Extents", GetExtents, SetExtents)->AddAttributes(new ezClampValueAttribute(ezVec3(0.0f), ezVariant()), new ezDefaultValueAttribute(ezVec3(5.0f))),
+    EZ_ACCESSOR_PROPERTY("Mesh", GetMeshFile, SetMeshFile)->AddAttributes(new ezAssetBrowserAttribute("Mesh")),
+  }
+  EZ_END_PROPERTIES;
+  EZ_BEGIN_MESSAGEHANDLERS
+  {
+    EZ_MESSAGE_HANDLER(ezMsgUpdateLocalBounds, OnUpdateLocalBounds),
+    EZ_MESSAGE_HANDLER(ezMsgExtractOccluderData, OnMsgExtractOccluderData),
+  }
+  EZ_END_MESSAGEHANDLERS;
+  EZ_BEGIN_ATTRIBUTES
+  {
+    new ezCategoryAttribute("Rendering"),
+    new ezBoxVisualizerAttribute("Extents"),
+  }
+  EZ_END_ATTRIBUTES;
+}
+EZ_END_COMPONENT_TYPE
+// clang-format on
+
+ezOccluderComponent::ezOccluderComponent() = default;
+ezOccluderComponent::~ezOccluderComponent() = default;
+
+void ezOccluderComponent::OnActivated()
+{
+  UpdateOccluder();
+}
+
+void ezOccluderComponent::OnDeactivated()
+{
+  m_pOccluderObject = nullptr;
+
+  GetOwner()->UpdateLocalBounds();
+}
+
+void ezOccluderComponent::SetExtents(const ezVec3& vExtents)
+{
+  m_vExtents = vExtents;
+
+  if (IsActiveAndInitialized())
+  {
+    UpdateOccluder();
+  }
+}
+
+void ezOccluderComponent::SetMeshFile(const char* szFile)
+{
+  m_sMeshFile = szFile;
+
+  if (IsActiveAndInitialized())
+  {
+    UpdateOccluder();
+  }
+}
+
+const char* ezOccluderComponent::GetMeshFile() const
+{
+  return m_sMeshFile;
+}
+
+void ezOccluderComponent::UpdateOccluder()
+{
+  if (!m_sMeshFile.IsEmpty())
+  {
+    m_pOccluderObject = ezRasterizerObject::GetObject(m_sMeshFile);
+  }
+  else
+  {
+    m_pOccluderObject = ezRasterizerObject::CreateBox(m_vExtents);
+  }
+
+  GetOwner()->UpdateLocalBounds();
+}
+
+void ezOccluderComponent::OnUpdateLocalBounds(ezMsgUpdateLocalBounds& msg)
+{
+  if (m_pOccluderObject == nullptr)
+    return;
+
+  const ezSpatialData::Category category = GetOwner()->IsDynamic() ? ezDefaultSpatialDataCategories::OcclusionDynamic : ezDefaultSpatialDataCategories::OcclusionStatic;
+  msg.AddBounds(ezBoundingBoxSphere(m_pOccluderObject->GetBounds()), category);
+}
+
+void ezOccluderComponent::OnMsgExtractOccluderData(ezMsgExtractOccluderData& msg) const
+{
+  if (m_pOccluderObject != nullptr)
+  {
+    msg.AddOccluder(m_pOccluderObject.Borrow(), GetOwner()->GetGlobalTransform());
+  }
+}
+
+void ezOccluderComponent::SerializeComponent(ezWorldWriter& stream) const
+{
+  SUPER::SerializeComponent(stream);
+
+  ezStreamWriter& s = stream.GetStream();
+
+  s << m_vExtents;
+  s << m_sMeshFile;
+}
+
+void ezOccluderComponent::DeserializeComponent(ezWorldReader& stream)
+{
+  SUPER::DeserializeComponent(stream);
+  // const ezUInt32 uiVersion = stream.GetComponentTypeVersion(GetStaticRTTI());
+  ezStreamReader& s = stream.GetStream();
+
+  s >> m_vExtents;
+  s >> m_sMeshFile;
+}
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_Components_Implementation_OccluderComponent);
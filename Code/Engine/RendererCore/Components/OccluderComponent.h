@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Core/World/World.h>
+#include <Foundation/Types/SharedPtr.h>
+#include <RendererCore/Pipeline/RenderData.h>
+#include <RendererCore/Rasterizer/RasterizerObject.h>
+
+struct ezMsgUpdateLocalBounds;
+
+typedef ezComponentManager<class ezOccluderComponent, ezBlockStorageType::Compact> ezOccluderComponentManager;
+
+/// \brief Marks the owner as an occluder for views that use CPU occlusion culling, see ezView::SetOcclusionCullingEnabled().
+///
+/// The occluder is either a box or a mesh, which is loaded as an ezCpuMeshResource. It is not rendered and must fit inside of the
+/// geometry that it stands for, e.g. a box that is slightly smaller than a building.
+class EZ_RENDERERCORE_DLL ezOccluderComponent : public ezComponent
+{
+  EZ_DECLARE_COMPONENT_TYPE(ezOccluderComponent, ezComponent, ezOccluderComponentManager);
+
+  //////////////////////////////////////////////////////////////////////////
+  // ezComponent
+
+public:
+  virtual void SerializeComponent(ezWorldWriter& stream) const override;
+  virtual void DeserializeComponent(ezWorldReader& stream) override;
+
+protected:
+  virtual void OnActivated() override;
+  virtual void OnDeactivated() override;
+
+  //////////////////////////////////////////////////////////////////////////
+  // ezOccluderComponent
+
+public:
+  ezOccluderComponent();
+  ~ezOccluderComponent();
+
+  /// \brief The full size of the box occluder. Only used if no mesh is set.
+  void SetExtents(const ezVec3& vExtents); // [ property ]
+  const ezVec3& GetExtents() const { return m_vExtents; } // [ property ]
+
+  void SetMeshFile(const char* szFile); // [ property ]
+  const char* GetMeshFile() const;      // [ property ]
+
+private:
+  void OnUpdateLocalBounds(ezMsgUpdateLocalBounds& msg);
+  void OnMsgExtractOccluderData(ezMsgExtractOccluderData& msg) const;
+
+  void UpdateOccluder();
+
+  ezVec3 m_vExtents = ezVec3(5.0f);
+  ezString m_sMeshFile;
+  ezSharedPtr<ezRasterizerObject> m_pOccluderObject;
+};
@@ -359,6 +359,67 @@ void ezMeshBufferResourceDescriptor::SetTriangleIndices(ezUInt32 uiTriangle, ezU
   }
 }
 
+void ezMeshBufferResourceDescriptor::GetIndices(ezDynamicArray<ezUInt32>& out_Indices) const
+{
+  if (Uses32BitIndices())
+  {
+    const ezUInt32 uiNumIndices = m_IndexBufferData.GetCount() / sizeof(ezUInt32);
+    out_Indices.SetCountUninitialized(uiNumIndices);
+    ezMemoryUtils::Copy(out_Indices.GetData(), reinterpret_cast<const ezUInt32*>(m_IndexBufferData.GetData()), uiNumIndices);
+  }
+  else
+  {
+    const ezUInt32 uiNumIndices = m_IndexBufferData.GetCount() / sizeof(ezUInt16);
+    out_Indices.SetCountUninitialized(uiNumIndices);
+
+    const ezUInt16* pIndices = reinterpret_cast<const ezUInt16*>(m_IndexBufferData.GetData());
+    for (ezUInt32 i = 0; i < uiNumIndices; ++i)
+    {
+      out_Indices[i] = pIndices[i];
+    }
+  }
+}
+
+void ezMeshBufferResourceDescriptor::RemapVertices(ezArrayPtr<const ezUInt32> oldToNew, ezUInt32 uiNewVertexCount, ezArrayPtr<const ezUInt32> indices)
+{
+  EZ_ASSERT_DEV(oldToNew.GetCount() == m_uiVertexCount, "The remap table must contain one entry per vertex");
+  EZ_ASSERT_DEV(uiNewVertexCount <= m_uiVertexCount, "Vertices can only be removed, not added");
+  EZ_ASSERT_DEV(indices.GetCount() == GetPrimitiveCount() * ezGALPrimitiveTopology::VerticesPerPrimitive(m_Topology), "The number of primitives must not change");
+
+  ezDynamicArray<ezUInt8> newVertexData;
+  newVertexData.SetCountUninitialized(uiNewVertexCount * m_uiVertexSize);
+
+  for (ezUInt32 v = 0; v < oldToNew.GetCount(); ++v)
+  {
+    const ezUInt32 uiNewIndex = oldToNew[v];
+    if (uiNewIndex == ezInvalidIndex)
+      continue;
+
+    EZ_ASSERT_DEBUG(uiNewIndex < uiNewVertexCount, "Invalid remap table entry");
+    ezMemoryUtils::Copy(&newVertexData[uiNewIndex * m_uiVertexSize], &m_VertexStreamData[v * m_uiVertexSize], m_uiVertexSize);
+  }
+
+  m_VertexStreamData.Swap(newVertexData);
+  m_uiVertexCount = uiNewVertexCount;
+
+  // the index format depends on the vertex count
+  if (Uses32BitIndices())
+  {
+    m_IndexBufferData.SetCountUninitialized(indices.GetCount() * sizeof(ezUInt32));
+    ezMemoryUtils::Copy(reinterpret_cast<ezUInt32*>(m_IndexBufferData.GetData()), indices.GetPtr(), indices.GetCount());
+  }
+  else
+  {
+    m_IndexBufferData.SetCountUninitialized(indices.GetCount() * sizeof(ezUInt16));
+
+    ezUInt16* pIndices = reinterpret_cast<ezUInt16*>(m_IndexBufferData.GetData());
+    for (ezUInt32 i = 0; i < indices.GetCount(); ++i)
+    {
+      pIndices[i] = static_cast<ezUInt16>(indices[i]);
+    }
+  }
+}
+
 ezUInt32 ezMeshBufferResourceDescriptor::GetPrimitiveCount() const
 {
   const ezUInt32 divider = m_Topology + 1;
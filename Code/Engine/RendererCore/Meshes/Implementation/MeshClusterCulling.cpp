@@ -0,0 +1,224 @@
+#include <RendererCorePCH.h>
+
+#include <Core/Graphics/Camera.h>
+#include <Foundation/Math/Frustum.h>
+#include <RendererCore/Meshes/MeshClusterCulling.h>
+
+ezMeshClusterCullingView::ezMeshClusterCullingView() = default;
+
+void ezMeshClusterCullingView::Setup(const ezFrustum& frustum, const ezTransform& objectTransform, const ezCamera* pCamera)
+{
+  m_bEnabled = false;
+  m_bCullBackfaces = false;
+
+  const ezMat4 mObjectToWorld = objectTransform.GetAsMat4();
+
+  ezMat4 mWorldToObject = mObjectToWorld;
+  if (mWorldToObject.Invert(0.0f).Failed())
+    return;
+
+  // a plane transforms with the transpose of the matrix that transforms points the other way
+  const ezMat4 mPlaneToObject = mObjectToWorld.GetTranspose();
+
+  for (ezUInt32 i = 0; i < 6; ++i)
+  {
+    const ezPlane& plane = frustum.GetPlane(static_cast<ezUInt8>(i));
+
+    ezVec4 vPlane = mPlaneToObject * ezVec4(plane.m_vNormal.x, plane.m_vNormal.y, plane.m_vNormal.z, plane.m_fNegDistance);
+
+    const float fLength = vPlane.GetAsVec3().GetLength();
+    if (fLength <= 0.0f)
+      return;
+
+    vPlane /= fLength;
+
+    m_PlaneX[i] = ezSimdVec4f(vPlane.x);
+    m_PlaneY[i] = ezSimdVec4f(vPlane.y);
+    m_PlaneZ[i] = ezSimdVec4f(vPlane.z);
+    m_PlaneW[i] = ezSimdVec4f(vPlane.w);
+  }
+
+  if (pCamera != nullptr)
+  {
+    ezVec3 vCamera;
+
+    if (pCamera->IsOrthographic())
+    {
+      vCamera = -mWorldToObject.TransformDirection(pCamera->GetCenterDirForwards());
+      m_CenterScale = ezSimdVec4f::ZeroVector();
+    }
+    else
+    {
+      vCamera = mWorldToObject.TransformPosition(pCamera->GetCenterPosition());
+      m_CenterScale = ezSimdVec4f(1.0f);
+    }
+
+    m_CameraX = ezSimdVec4f(vCamera.x);
+    m_CameraY = ezSimdVec4f(vCamera.y);
+    m_CameraZ = ezSimdVec4f(vCamera.z);
+    m_bCullBackfaces = true;
+  }
+
+  m_bEnabled = true;
+}
+
+void ezMeshClusterCullingData::Initialize(ezArrayPtr<const ezMeshResourceDescriptor::Cluster> clusters)
+{
+  Clear();
+
+  m_ClusterRanges.SetCountUninitialized(clusters.GetCount());
+  m_Blocks.SetCountUninitialized((clusters.GetCount() + 3) / 4);
+
+  float values[9][4];
+
+  for (ezUInt32 uiBlock = 0; uiBlock < m_Blocks.GetCount(); ++uiBlock)
+  {
+    for (ezUInt32 uiLane = 0; uiLane < 4; ++uiLane)
+    {
+      const ezUInt32 uiCluster = uiBlock * 4 + uiLane;
+
+      // unused lanes are never tested, they only need valid numbers
+      ezMeshResourceDescriptor::Cluster cluster;
+      ezMemoryUtils::ZeroFill(&cluster, 1);
+
+      if (uiCluster < clusters.GetCount())
+      {
+        cluster = clusters[uiCluster];
+
+        m_ClusterRanges[uiCluster].m_uiFirstPrimitive = cluster.m_uiFirstPrimitive;
+        m_ClusterRanges[uiCluster].m_uiPrimitiveCount = cluster.m_uiPrimitiveCount;
+      }
+
+      values[0][uiLane] = cluster.m_vCenter.x;
+      values[1][uiLane] = cluster.m_vCenter.y;
+      values[2][uiLane] = cluster.m_vCenter.z;
+      values[3][uiLane] = cluster.m_fRadius;
+      values[4][uiLane] = cluster.m_vConeAxis.x;
+      values[5][uiLane] = cluster.m_vConeAxis.y;
+      values[6][uiLane] = cluster.m_vConeAxis.z;
+      values[7][uiLane] = cluster.m_fConeCosAngle;
+      values[8][uiLane] = cluster.m_fConeSinAngle;
+    }
+
+    ClusterBlock& block = m_Blocks[uiBlock];
+    block.m_CenterX.Load<4>(values[0]);
+    block.m_CenterY.Load<4>(values[1]);
+    block.m_CenterZ.Load<4>(values[2]);
+    block.m_Radius.Load<4>(values[3]);
+    block.m_ConeAxisX.Load<4>(values[4]);
+    block.m_ConeAxisY.Load<4>(values[5]);
+    block.m_ConeAxisZ.Load<4>(values[6]);
+    block.m_ConeCosAngle.Load<4>(values[7]);
+    block.m_ConeSinAngle.Load<4>(values[8]);
+  }
+}
+
+void ezMeshClusterCullingData::Clear()
+{
+  m_Blocks.Clear();
+  m_ClusterRanges.Clear();
+}
+
+ezUInt64 ezMeshClusterCullingData::GetHeapMemoryUsage() const
+{
+  return m_Blocks.GetHeapMemoryUsage() + m_ClusterRanges.GetHeapMemoryUsage();
+}
+
+ezUInt32 ezMeshClusterCullingData::CullClusters(const ezMeshClusterCullingView& view, ezUInt32 uiFirstCluster, ezUInt32 uiClusterCount,
+  bool bCullBackfaces, ezDynamicArray<ezMeshClusterRange>& out_Ranges) const
+{
+  EZ_ASSERT_DEV(uiFirstCluster + uiClusterCount <= m_ClusterRanges.GetCount(), "Invalid cluster range");
+
+  const ezUInt32 uiEndCluster = uiFirstCluster + uiClusterCount;
+  ezUInt32 uiNumVisible = 0;
+
+  auto AddVisibleCluster = [&](ezUInt32 uiCluster) {
+    const ezMeshClusterRange& range = m_ClusterRanges[uiCluster];
+
+    if (!out_Ranges.IsEmpty() && out_Ranges.PeekBack().m_uiFirstPrimitive + out_Ranges.PeekBack().m_uiPrimitiveCount == range.m_uiFirstPrimitive)
+    {
+      out_Ranges.PeekBack().m_uiPrimitiveCount += range.m_uiPrimitiveCount;
+    }
+    else
+    {
+      out_Ranges.PushBack(range);
+    }
+
+    ++uiNumVisible;
+  };
+
+  if (!view.m_bEnabled)
+  {
+    for (ezUInt32 uiCluster = uiFirstCluster; uiCluster < uiEndCluster; ++uiCluster)
+    {
+      AddVisibleCluster(uiCluster);
+    }
+
+    return uiNumVisible;
+  }
+
+  const ezSimdVec4f zero = ezSimdVec4f::ZeroVector();
+  bCullBackfaces &= view.m_bCullBackfaces;
+
+  for (ezUInt32 uiBlock = uiFirstCluster / 4; uiBlock * 4 < uiEndCluster; ++uiBlock)
+  {
+    const ClusterBlock& block = m_Blocks[uiBlock];
+
+    // the frustum planes point outwards, a cluster is outside if it is completely in front of any plane
+    ezSimdVec4b outside(false);
+    for (ezUInt32 i = 0; i < 6; ++i)
+    {
+      ezSimdVec4f dist = ezSimdVec4f::MulAdd(block.m_CenterX, view.m_PlaneX[i], view.m_PlaneW[i]);
+      dist = ezSimdVec4f::MulAdd(block.m_CenterY, view.m_PlaneY[i], dist);
+      dist = ezSimdVec4f::MulAdd(block.m_CenterZ, view.m_PlaneZ[i], dist);
+
+      outside = outside || (dist > block.m_Radius);
+    }
+
+    if (bCullBackfaces)
+    {
+      // All triangles face away from the camera, if the angle between d and the cone axis is smaller than 90 degrees minus the cone
+      // angle, with enough margin for every point in the bounding sphere: |d| * cos(angle(d, axis) + cone angle) > radius
+      const ezSimdVec4f dx = ezSimdVec4f::MulSub(block.m_CenterX, view.m_CenterScale, view.m_CameraX);
+      const ezSimdVec4f dy = ezSimdVec4f::MulSub(block.m_CenterY, view.m_CenterScale, view.m_CameraY);
+      const ezSimdVec4f dz = ezSimdVec4f::MulSub(block.m_CenterZ, view.m_CenterScale, view.m_CameraZ);
+
+      ezSimdVec4f dDotAxis = dx.CompMul(block.m_ConeAxisX);
+      dDotAxis = ezSimdVec4f::MulAdd(dy, block.m_ConeAxisY, dDotAxis);
+      dDotAxis = ezSimdVec4f::MulAdd(dz, block.m_ConeAxisZ, dDotAxis);
+
+      ezSimdVec4f dLengthSquared = dx.CompMul(dx);
+      dLengthSquared = ezSimdVec4f::MulAdd(dy, dy, dLengthSquared);
+      dLengthSquared = ezSimdVec4f::MulAdd(dz, dz, dLengthSquared);
+
+      // |d| * sin(angle(d, axis))
+      const ezSimdVec4f dOrthogonal = (dLengthSquared - dDotAxis.CompMul(dDotAxis)).CompMax(zero).GetSqrt();
+
+      const ezSimdVec4f cosSum = ezSimdVec4f::MulSub(dDotAxis, block.m_ConeCosAngle, dOrthogonal.CompMul(block.m_ConeSinAngle));
+
+      outside = outside || (cosSum > block.m_Radius.CompMul(view.m_CenterScale));
+    }
+
+    if (outside.AllSet())
+      continue;
+
+    const bool bVisible[4] = {!outside.x(), !outside.y(), !outside.z(), !outside.w()};
+
+    const ezUInt32 uiBlockStart = ezMath::Max(uiBlock * 4, uiFirstCluster);
+    const ezUInt32 uiBlockEnd = ezMath::Min(uiBlock * 4 + 4, uiEndCluster);
+
+    for (ezUInt32 uiCluster = uiBlockStart; uiCluster < uiBlockEnd; ++uiCluster)
+    {
+      if (bVisible[uiCluster - uiBlock * 4])
+      {
+        AddVisibleCluster(uiCluster);
+      }
+    }
+  }
+
+  return uiNumVisible;
+}
+
+
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_Meshes_Implementation_MeshClusterCulling);
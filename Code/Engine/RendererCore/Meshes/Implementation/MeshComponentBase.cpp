@@ -1,12 +1,18 @@
 #include <RendererCorePCH.h>
 
+#include <Core/Graphics/Camera.h>
 #include <Core/WorldSerializer/WorldReader.h>
 #include <Core/WorldSerializer/WorldWriter.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Math/Frustum.h>
 #include <RendererCore/Meshes/MeshComponentBase.h>
 #include <RendererCore/Messages/SetColorMessage.h>
+#include <RendererCore/Pipeline/View.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 #include <RendererFoundation/Device/Device.h>
 
+ezCVarBool CVarClusterCulling("r_ClusterCulling", true, ezCVarFlags::Default, "Enables per-view culling of the clusters of large meshes");
+
 //////////////////////////////////////////////////////////////////////////
 
 // clang-format off
@@ -168,6 +174,25 @@ void ezMeshComponentBase::OnMsgExtractRenderData(ezMsgExtractRenderData& msg) co
   ezResourceLock<ezMeshResource> pMesh(m_hMesh, ezResourceAcquireMode::AllowLoadingFallback);
   ezArrayPtr<const ezMeshResourceDescriptor::SubMesh> parts = pMesh->GetSubMeshes();
 
+  // Large meshes can be split into clusters, which are culled per view. The result depends on the view, so it can't be cached.
+  const ezMeshClusterCullingData& clusterCullingData = pMesh->GetClusterCullingData();
+  const bool bCullClusters = CVarClusterCulling && clusterCullingData.GetClusterCount() > 0 && CanCullClusters();
+
+  ezMeshClusterCullingView clusterCullingView;
+  ezHybridArray<ezMeshClusterRange, 64> clusterRanges;
+
+  if (bCullClusters)
+  {
+    ezFrustum frustum;
+    msg.m_pView->ComputeCullingFrustum(frustum);
+
+    // back-facing clusters can only be culled if the view is rendered from the culling camera's position
+    const ezCamera* pCamera = msg.m_pView->GetCullingCamera();
+    const bool bCullBackfaces = !pCamera->IsStereoscopic() && msg.m_pView->GetCameraUsageHint() != ezCameraUsageHint::Shadow;
+
+    clusterCullingView.Setup(frustum, GetOwner()->GetGlobalTransform(), bCullBackfaces ? pCamera : nullptr);
+  }
+
   for (ezUInt32 uiPartIndex = 0; uiPartIndex < parts.GetCount(); ++uiPartIndex)
   {
     const ezUInt32 uiMaterialIndex = parts[uiPartIndex].m_uiMaterialIndex;
@@ -179,6 +204,27 @@ void ezMeshComponentBase::OnMsgExtractRenderData(ezMsgExtractRenderData& msg) co
     else
       hMaterial = pMesh->GetMaterials()[uiMaterialIndex];
 
+    ezArrayPtr<ezMeshClusterRange> visibleRanges;
+
+    if (bCullClusters && parts[uiPartIndex].m_uiClusterCount > 0)
+    {
+      const bool bCullBackfaces = !IsMaterialTwoSided(uiMaterialIndex, hMaterial);
+
+      clusterRanges.Clear();
+      const ezUInt32 uiNumVisibleClusters = clusterCullingData.CullClusters(
+        clusterCullingView, parts[uiPartIndex].m_uiFirstCluster, parts[uiPartIndex].m_uiClusterCount, bCullBackfaces, clusterRanges);
+
+      if (uiNumVisibleClusters == 0)
+        continue;
+
+      // if all clusters are visible, the sub-mesh is drawn as a whole and can be instanced as usual
+      if (uiNumVisibleClusters < parts[uiPartIndex].m_uiClusterCount)
+      {
+        visibleRanges = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), ezMeshClusterRange, clusterRanges.GetCount());
+        visibleRanges.CopyFrom(clusterRanges);
+      }
+    }
+
     ezMeshRenderData* pRenderData = CreateRenderData();
     {
       pRenderData->m_GlobalTransform = GetOwner()->GetGlobalTransform();
@@ -188,11 +234,12 @@ void ezMeshComponentBase::OnMsgExtractRenderData(ezMsgExtractRenderData& msg) co
       pRenderData->m_Color = m_Color;
       pRenderData->m_uiSubMeshIndex = uiPartIndex;
       pRenderData->m_uiUniqueID = GetUniqueIdForRendering(uiMaterialIndex);
+      pRenderData->m_ClusterRanges = visibleRanges;
 
       pRenderData->FillBatchIdAndSortingKey();
     }
 
-    bool bDontCacheYet = false;
+    bool bDontCacheYet = bCullClusters;
 
     // Determine render data category.
     ezRenderData::Category category = m_RenderDataCategory;
@@ -233,6 +280,10 @@ void ezMeshComponentBase::SetMesh(const ezMeshResourceHandle& hMesh)
 {
   m_hMesh = hMesh;
 
+  // the default materials come from the mesh
+  m_iMaterialsTwoSidedKnown = 0;
+  m_iMaterialsTwoSided = 0;
+
   TriggerLocalBoundsUpdate();
 }
 
@@ -242,12 +293,42 @@ void ezMeshComponentBase::SetMaterial(ezUInt32 uiIndex, const ezMaterialResource
 
   m_Materials[uiIndex] = hMaterial;
 
+  m_iMaterialsTwoSidedKnown = 0;
+  m_iMaterialsTwoSided = 0;
+
   if (IsActiveAndInitialized())
   {
     ezRenderWorld::DeleteCachedRenderData(GetOwner()->GetHandle(), GetHandle());
   }
 }
 
+bool ezMeshComponentBase::IsMaterialTwoSided(ezUInt32 uiMaterialIndex, const ezMaterialResourceHandle& hMaterial) const
+{
+  if (!hMaterial.IsValid())
+    return false;
+
+  const ezInt32 iBit = uiMaterialIndex < 32 ? static_cast<ezInt32>(1u << uiMaterialIndex) : 0;
+
+  if ((m_iMaterialsTwoSidedKnown & iBit) != 0)
+    return (m_iMaterialsTwoSided & iBit) != 0;
+
+  ezResourceLock<ezMaterialResource> pMaterial(hMaterial, ezResourceAcquireMode::AllowLoadingFallback);
+
+  ezTempHashedString twoSidedValue = pMaterial->GetPermutationValue("TWO_SIDED");
+  const bool bTwoSided = (twoSidedValue == "TRUE");
+
+  // the fallback material may differ from the actual one
+  if (iBit != 0 && pMaterial.GetAcquireResult() != ezResourceAcquireResult::LoadingFallback)
+  {
+    if (bTwoSided)
+      m_iMaterialsTwoSided.Or(iBit);
+
+    m_iMaterialsTwoSidedKnown.Or(iBit);
+  }
+
+  return bTwoSided;
+}
+
 ezMaterialResourceHandle ezMeshComponentBase::GetMaterial(ezUInt32 uiIndex) const
 {
   if (uiIndex >= m_Materials.GetCount())
@@ -338,12 +419,18 @@ void ezMeshComponentBase::Materials_Insert(ezUInt32 uiIndex, const char* value)
     hMat = ezResourceManager::LoadResource<ezMaterialResource>(value);
 
   m_Materials.Insert(hMat, uiIndex);
+
+  m_iMaterialsTwoSidedKnown = 0;
+  m_iMaterialsTwoSided = 0;
 }
 
 
 void ezMeshComponentBase::Materials_Remove(ezUInt32 uiIndex)
 {
   m_Materials.RemoveAtAndCopy(uiIndex);
+
+  m_iMaterialsTwoSidedKnown = 0;
+  m_iMaterialsTwoSided = 0;
 }
 
 
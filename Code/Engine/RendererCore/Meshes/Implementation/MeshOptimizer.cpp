@@ -0,0 +1,750 @@
+#include <RendererCorePCH.h>
+
+#include <RendererCore/Meshes/MeshOptimizer.h>
+#include <RendererCore/Meshes/MeshResourceDescriptor.h>
+
+float ezMeshVertexCacheStats::GetACMR() const
+{
+  return m_uiNumTriangles > 0 ? (float)m_uiNumTransformedVertices / (float)m_uiNumTriangles : 0.0f;
+}
+
+float ezMeshVertexCacheStats::GetATVR() const
+{
+  return m_uiNumVertices > 0 ? (float)m_uiNumTransformedVertices / (float)m_uiNumVertices : 0.0f;
+}
+
+namespace
+{
+  /// FIFO cache simulation. Every vertex remembers when it was put into the cache, it is still cached if fewer than 'cache size' other
+  /// vertices were added after it.
+  class VertexCacheSimulation
+  {
+  public:
+    VertexCacheSimulation(ezUInt32 uiNumVertices, ezUInt32 uiCacheSize)
+      : m_uiCacheSize(uiCacheSize)
+      , m_uiTimeStamp(uiCacheSize + 1)
+    {
+      m_TimeStamps.SetCount(uiNumVertices);
+    }
+
+    EZ_ALWAYS_INLINE bool IsCached(ezUInt32 uiVertex) const { return m_uiTimeStamp - m_TimeStamps[uiVertex] <= m_uiCacheSize; }
+
+    EZ_ALWAYS_INLINE ezUInt32 GetAge(ezUInt32 uiVertex) const { return m_uiTimeStamp - m_TimeStamps[uiVertex]; }
+
+    /// Returns true on a cache miss.
+    EZ_ALWAYS_INLINE bool Access(ezUInt32 uiVertex)
+    {
+      if (IsCached(uiVertex))
+        return false;
+
+      m_TimeStamps[uiVertex] = m_uiTimeStamp++;
+      return true;
+    }
+
+    void Flush() { m_uiTimeStamp += m_uiCacheSize + 1; }
+
+  private:
+    ezUInt32 m_uiCacheSize;
+    ezUInt32 m_uiTimeStamp;
+    ezDynamicArray<ezUInt32> m_TimeStamps;
+  };
+
+  /// Vertex -> triangle adjacency, stored as one array with per-vertex offsets. The triangles of vertex v are
+  /// adjacency[offsets[v]] to adjacency[offsets[v + 1] - 1].
+  void BuildVertexTriangleAdjacency(ezArrayPtr<const ezUInt32> indices, ezUInt32 uiNumVertices, ezDynamicArray<ezUInt32>& out_Offsets,
+    ezDynamicArray<ezUInt32>& out_Adjacency)
+  {
+    out_Offsets.Clear();
+    out_Offsets.SetCount(uiNumVertices + 1);
+
+    for (ezUInt32 uiIndex : indices)
+    {
+      EZ_ASSERT_DEBUG(uiIndex < uiNumVertices, "Invalid vertex index {0}", uiIndex);
+      ++out_Offsets[uiIndex + 1];
+    }
+
+    for (ezUInt32 v = 0; v < uiNumVertices; ++v)
+    {
+      out_Offsets[v + 1] += out_Offsets[v];
+    }
+
+    out_Adjacency.SetCountUninitialized(indices.GetCount());
+
+    ezDynamicArray<ezUInt32> fillOffsets(out_Offsets);
+    for (ezUInt32 i = 0; i < indices.GetCount(); ++i)
+    {
+      out_Adjacency[fillOffsets[indices[i]]++] = i / 3;
+    }
+  }
+
+  struct ClusterSortData
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiFirstTriangle;
+    ezUInt32 m_uiNumTriangles;
+    float m_fSortKey;
+  };
+} // namespace
+
+void ezMeshOptimizer::OptimizeVertexCache(ezArrayPtr<ezUInt32> inout_Indices, ezUInt32 uiNumVertices, ezUInt32 uiCacheSize,
+  ezDynamicArray<ezUInt32>* out_pClusterStarts)
+{
+  EZ_ASSERT_DEV(inout_Indices.GetCount() % 3 == 0, "Index count must be a multiple of 3");
+
+  const ezUInt32 uiNumIndices = inout_Indices.GetCount();
+  const ezUInt32 uiNumTriangles = uiNumIndices / 3;
+
+  if (out_pClusterStarts != nullptr)
+  {
+    out_pClusterStarts->Clear();
+    out_pClusterStarts->PushBack(0);
+  }
+
+  if (uiNumTriangles == 0)
+    return;
+
+  ezDynamicArray<ezUInt32> adjacencyOffsets;
+  ezDynamicArray<ezUInt32> adjacency;
+  BuildVertexTriangleAdjacency(inout_Indices, uiNumVertices, adjacencyOffsets, adjacency);
+
+  // number of not yet emitted triangles per vertex
+  ezDynamicArray<ezUInt32> liveTriangles;
+  liveTriangles.SetCountUninitialized(uiNumVertices);
+  for (ezUInt32 v = 0; v < uiNumVertices; ++v)
+  {
+    liveTriangles[v] = adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+  }
+
+  VertexCacheSimulation cache(uiNumVertices, uiCacheSize);
+
+  ezDynamicArray<ezUInt8> emitted;
+  emitted.SetCount(uiNumTriangles);
+
+  ezDynamicArray<ezUInt32> result;
+  result.SetCountUninitialized(uiNumIndices);
+  ezUInt32 uiNumEmitted = 0;
+
+  ezDynamicArray<ezUInt32> deadEndStack;
+  deadEndStack.Reserve(uiNumIndices);
+
+  ezHybridArray<ezUInt32, 64> candidates;
+
+  // finds the next vertex that still has triangles left, in input order
+  ezUInt32 uiInputCursor = 0;
+  auto SkipToNextLiveVertex = [&]() -> ezUInt32 {
+    while (uiInputCursor < uiNumIndices)
+    {
+      const ezUInt32 uiVertex = inout_Indices[uiInputCursor];
+      if (liveTriangles[uiVertex] > 0)
+        return uiVertex;
+
+      ++uiInputCursor;
+    }
+
+    return ezInvalidIndex;
+  };
+
+  ezUInt32 uiFanningVertex = SkipToNextLiveVertex();
+
+  while (uiFanningVertex != ezInvalidIndex)
+  {
+    candidates.Clear();
+
+    // emit all remaining triangles around the fanning vertex
+    for (ezUInt32 a = adjacencyOffsets[uiFanningVertex]; a < adjacencyOffsets[uiFanningVertex + 1]; ++a)
+    {
+      const ezUInt32 uiTriangle = adjacency[a];
+      if (emitted[uiTriangle])
+        continue;
+
+      emitted[uiTriangle] = 1;
+
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        const ezUInt32 uiVertex = inout_Indices[uiTriangle * 3 + c];
+
+        result[uiNumEmitted * 3 + c] = uiVertex;
+        deadEndStack.PushBack(uiVertex);
+        candidates.PushBack(uiVertex);
+        --liveTriangles[uiVertex];
+        cache.Access(uiVertex);
+      }
+
+      ++uiNumEmitted;
+    }
+
+    // prefer the candidate that is oldest in the cache, but will still be cached once all its triangles are emitted
+    ezUInt32 uiNextVertex = ezInvalidIndex;
+    ezInt32 iBestPriority = -1;
+
+    for (ezUInt32 uiVertex : candidates)
+    {
+      if (liveTriangles[uiVertex] == 0)
+        continue;
+
+      ezInt32 iPriority = 0;
+      if (cache.GetAge(uiVertex) + 2 * liveTriangles[uiVertex] <= uiCacheSize)
+      {
+        iPriority = (ezInt32)cache.GetAge(uiVertex);
+      }
+
+      if (iPriority > iBestPriority)
+      {
+        iBestPriority = iPriority;
+        uiNextVertex = uiVertex;
+      }
+    }
+
+    if (uiNextVertex == ezInvalidIndex)
+    {
+      // dead end, continue with a recently used vertex, or anywhere else in the mesh
+      while (!deadEndStack.IsEmpty())
+      {
+        const ezUInt32 uiVertex = deadEndStack.PeekBack();
+        deadEndStack.PopBack();
+
+        if (liveTriangles[uiVertex] > 0)
+        {
+          uiNextVertex = uiVertex;
+          break;
+        }
+      }
+
+      if (uiNextVertex == ezInvalidIndex)
+      {
+        uiNextVertex = SkipToNextLiveVertex();
+      }
+
+      if (uiNextVertex != ezInvalidIndex && out_pClusterStarts != nullptr)
+      {
+        out_pClusterStarts->PushBack(uiNumEmitted);
+      }
+    }
+
+    uiFanningVertex = uiNextVertex;
+  }
+
+  EZ_ASSERT_DEBUG(uiNumEmitted == uiNumTriangles, "Not all triangles were emitted");
+
+  ezMemoryUtils::Copy(inout_Indices.GetPtr(), result.GetData(), uiNumIndices);
+}
+
+void ezMeshOptimizer::OptimizeOverdraw(ezArrayPtr<ezUInt32> inout_Indices, ezArrayPtr<const ezVec3> positions,
+  ezArrayPtr<const ezUInt32> clusterStarts, ezUInt32 uiCacheSize, float fThreshold)
+{
+  EZ_ASSERT_DEV(inout_Indices.GetCount() % 3 == 0, "Index count must be a multiple of 3");
+
+  const ezUInt32 uiNumTriangles = inout_Indices.GetCount() / 3;
+  if (uiNumTriangles == 0)
+    return;
+
+  VertexCacheSimulation cache(positions.GetCount(), uiCacheSize);
+
+  auto ComputeClusterMisses = [&](ezUInt32 uiFirstTriangle, ezUInt32 uiEndTriangle) -> ezUInt32 {
+    cache.Flush();
+
+    ezUInt32 uiMisses = 0;
+    for (ezUInt32 i = uiFirstTriangle * 3; i < uiEndTriangle * 3; ++i)
+    {
+      uiMisses += cache.Access(inout_Indices[i]) ? 1 : 0;
+    }
+
+    return uiMisses;
+  };
+
+  // split the clusters of the vertex cache optimization further, wherever the cache efficiency up to that point is good enough
+  ezDynamicArray<ClusterSortData> clusters;
+  clusters.Reserve(clusterStarts.GetCount() * 2);
+
+  for (ezUInt32 c = 0; c < clusterStarts.GetCount(); ++c)
+  {
+    const ezUInt32 uiClusterStart = clusterStarts[c];
+    const ezUInt32 uiClusterEnd = (c + 1 < clusterStarts.GetCount()) ? clusterStarts[c + 1] : uiNumTriangles;
+
+    if (uiClusterStart >= uiClusterEnd)
+      continue;
+
+    const float fClusterACMR = (float)ComputeClusterMisses(uiClusterStart, uiClusterEnd) / (float)(uiClusterEnd - uiClusterStart);
+    const float fMaxACMR = fClusterACMR * fThreshold;
+
+    cache.Flush();
+
+    ezUInt32 uiStart = uiClusterStart;
+    ezUInt32 uiMisses = 0;
+
+    for (ezUInt32 t = uiClusterStart; t < uiClusterEnd; ++t)
+    {
+      for (ezUInt32 i = 0; i < 3; ++i)
+      {
+        uiMisses += cache.Access(inout_Indices[t * 3 + i]) ? 1 : 0;
+      }
+
+      const ezUInt32 uiNumInCluster = t + 1 - uiStart;
+
+      // the last triangle always closes the cluster
+      if (t + 1 == uiClusterEnd || (float)uiMisses / (float)uiNumInCluster <= fMaxACMR)
+      {
+        ClusterSortData& cluster = clusters.ExpandAndGetRef();
+        cluster.m_uiFirstTriangle = uiStart;
+        cluster.m_uiNumTriangles = uiNumInCluster;
+        cluster.m_fSortKey = 0.0f;
+
+        uiStart = t + 1;
+        uiMisses = 0;
+        cache.Flush();
+      }
+    }
+  }
+
+  if (clusters.GetCount() <= 1)
+    return;
+
+  // area weighted centroid of every cluster and the whole mesh
+  ezDynamicArray<ezVec3> clusterCentroids;
+  ezDynamicArray<ezVec3> clusterNormals;
+  clusterCentroids.SetCountUninitialized(clusters.GetCount());
+  clusterNormals.SetCountUninitialized(clusters.GetCount());
+
+  ezVec3 vMeshCentroid = ezVec3::ZeroVector();
+  float fMeshArea = 0.0f;
+
+  for (ezUInt32 c = 0; c < clusters.GetCount(); ++c)
+  {
+    ezVec3 vCentroid = ezVec3::ZeroVector();
+    ezVec3 vNormal = ezVec3::ZeroVector();
+    float fArea = 0.0f;
+
+    const ezUInt32 uiEnd = clusters[c].m_uiFirstTriangle + clusters[c].m_uiNumTriangles;
+    for (ezUInt32 t = clusters[c].m_uiFirstTriangle; t < uiEnd; ++t)
+    {
+      const ezVec3& p0 = positions[inout_Indices[t * 3 + 0]];
+      const ezVec3& p1 = positions[inout_Indices[t * 3 + 1]];
+      const ezVec3& p2 = positions[inout_Indices[t * 3 + 2]];
+
+      // the cross product's length is twice the triangle area, the factor doesn't matter for weighting
+      const ezVec3 vTriNormal = (p1 - p0).CrossRH(p2 - p0);
+      const float fTriArea = vTriNormal.GetLength();
+
+      vCentroid += (p0 + p1 + p2) * (fTriArea / 3.0f);
+      vNormal += vTriNormal;
+      fArea += fTriArea;
+    }
+
+    vMeshCentroid += vCentroid;
+    fMeshArea += fArea;
+
+    clusterCentroids[c] = fArea > 0.0f ? vCentroid / fArea : positions[inout_Indices[clusters[c].m_uiFirstTriangle * 3]];
+    clusterNormals[c] = vNormal;
+    clusterNormals[c].NormalizeIfNotZero(ezVec3::ZeroVector());
+  }
+
+  if (fMeshArea > 0.0f)
+  {
+    vMeshCentroid /= fMeshArea;
+  }
+
+  for (ezUInt32 c = 0; c < clusters.GetCount(); ++c)
+  {
+    clusters[c].m_fSortKey = (clusterCentroids[c] - vMeshCentroid).Dot(clusterNormals[c]);
+  }
+
+  // clusters on the outside, that face away from the center, are the most likely to occlude the others
+  clusters.Sort([](const ClusterSortData& a, const ClusterSortData& b) -> bool {
+    if (a.m_fSortKey != b.m_fSortKey)
+      return a.m_fSortKey > b.m_fSortKey;
+
+    return a.m_uiFirstTriangle < b.m_uiFirstTriangle;
+  });
+
+  ezDynamicArray<ezUInt32> result;
+  result.SetCountUninitialized(inout_Indices.GetCount());
+
+  ezUInt32 uiNextIndex = 0;
+  for (const ClusterSortData& cluster : clusters)
+  {
+    ezMemoryUtils::Copy(&result[uiNextIndex], &inout_Indices[cluster.m_uiFirstTriangle * 3], cluster.m_uiNumTriangles * 3);
+    uiNextIndex += cluster.m_uiNumTriangles * 3;
+  }
+
+  ezMemoryUtils::Copy(inout_Indices.GetPtr(), result.GetData(), result.GetCount());
+}
+
+ezUInt32 ezMeshOptimizer::OptimizeVertexFetch(ezArrayPtr<ezUInt32> inout_Indices, ezUInt32 uiNumVertices, ezDynamicArray<ezUInt32>& out_OldToNew)
+{
+  out_OldToNew.SetCountUninitialized(uiNumVertices);
+  for (ezUInt32& uiNewIndex : out_OldToNew)
+  {
+    uiNewIndex = ezInvalidIndex;
+  }
+
+  ezUInt32 uiNextVertex = 0;
+
+  for (ezUInt32& uiIndex : inout_Indices)
+  {
+    EZ_ASSERT_DEBUG(uiIndex < uiNumVertices, "Invalid vertex index {0}", uiIndex);
+
+    ezUInt32& uiNewIndex = out_OldToNew[uiIndex];
+    if (uiNewIndex == ezInvalidIndex)
+    {
+      uiNewIndex = uiNextVertex++;
+    }
+
+    uiIndex = uiNewIndex;
+  }
+
+  return uiNextVertex;
+}
+
+void ezMeshOptimizer::BuildClusters(ezArrayPtr<ezUInt32> inout_Indices, ezArrayPtr<const ezVec3> positions, ezUInt32 uiMaxTriangles,
+  ezUInt32 uiFirstPrimitive, ezDynamicArray<ezMeshResourceDescriptor::Cluster>& out_Clusters)
+{
+  EZ_ASSERT_DEV(inout_Indices.GetCount() % 3 == 0, "Index count must be a multiple of 3");
+  EZ_ASSERT_DEV(uiMaxTriangles > 0, "Invalid cluster size");
+
+  out_Clusters.Clear();
+
+  const ezUInt32 uiNumVertices = positions.GetCount();
+  const ezUInt32 uiNumTriangles = inout_Indices.GetCount() / 3;
+
+  if (uiNumTriangles == 0)
+    return;
+
+  ezDynamicArray<ezUInt32> adjacencyOffsets;
+  ezDynamicArray<ezUInt32> adjacency;
+  BuildVertexTriangleAdjacency(inout_Indices, uiNumVertices, adjacencyOffsets, adjacency);
+
+  // area weighted and unit length face normals
+  ezDynamicArray<ezVec3> areaNormals;
+  ezDynamicArray<ezVec3> unitNormals;
+  areaNormals.SetCountUninitialized(uiNumTriangles);
+  unitNormals.SetCountUninitialized(uiNumTriangles);
+
+  for (ezUInt32 t = 0; t < uiNumTriangles; ++t)
+  {
+    const ezVec3& v0 = positions[inout_Indices[t * 3 + 0]];
+    const ezVec3& v1 = positions[inout_Indices[t * 3 + 1]];
+    const ezVec3& v2 = positions[inout_Indices[t * 3 + 2]];
+
+    // same orientation as ezGeometry's face normals, which point to the front side
+    areaNormals[t] = (v1 - v0).CrossRH(v2 - v0);
+    unitNormals[t] = areaNormals[t];
+    unitNormals[t].NormalizeIfNotZero(ezVec3::ZeroVector());
+  }
+
+  // cluster index + 1 per triangle, vertex and candidate, so that nothing needs to be reset between clusters
+  ezDynamicArray<ezUInt32> triangleCluster;
+  ezDynamicArray<ezUInt32> vertexCluster;
+  ezDynamicArray<ezUInt32> candidateCluster;
+  triangleCluster.SetCount(uiNumTriangles);
+  vertexCluster.SetCount(uiNumVertices);
+  candidateCluster.SetCount(uiNumTriangles);
+
+  ezDynamicArray<ezUInt32> result;
+  result.SetCountUninitialized(inout_Indices.GetCount());
+  ezUInt32 uiNumEmitted = 0;
+
+  ezDynamicArray<ezUInt32> clusterTriangles;
+  ezDynamicArray<ezUInt32> candidates;
+  ezUInt32 uiSeed = 0;
+
+  while (uiNumEmitted < uiNumTriangles)
+  {
+    const ezUInt32 uiClusterId = out_Clusters.GetCount() + 1;
+
+    clusterTriangles.Clear();
+    candidates.Clear();
+
+    ezVec3 vNormalSum = ezVec3::ZeroVector();
+
+    auto AddTriangle = [&](ezUInt32 t) {
+      triangleCluster[t] = uiClusterId;
+      clusterTriangles.PushBack(t);
+      vNormalSum += areaNormals[t];
+
+      for (ezUInt32 i = 0; i < 3; ++i)
+      {
+        const ezUInt32 v = inout_Indices[t * 3 + i];
+        if (vertexCluster[v] == uiClusterId)
+          continue;
+
+        vertexCluster[v] = uiClusterId;
+
+        for (ezUInt32 a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; ++a)
+        {
+          const ezUInt32 uiNeighbor = adjacency[a];
+          if (triangleCluster[uiNeighbor] == 0 && candidateCluster[uiNeighbor] != uiClusterId)
+          {
+            candidateCluster[uiNeighbor] = uiClusterId;
+            candidates.PushBack(uiNeighbor);
+          }
+        }
+      }
+    };
+
+    // seed with the first remaining triangle in input order, which keeps clusters in about the order of the vertex cache optimization
+    while (triangleCluster[uiSeed] != 0)
+    {
+      ++uiSeed;
+    }
+
+    AddTriangle(uiSeed);
+
+    while (clusterTriangles.GetCount() < uiMaxTriangles)
+    {
+      ezVec3 vClusterNormal = vNormalSum;
+      vClusterNormal.NormalizeIfNotZero(ezVec3::ZeroVector());
+
+      // prefer triangles that add few new vertices, then those that face in the same direction as the cluster
+      float fBestScore = -ezMath::MaxValue<float>();
+      ezUInt32 uiBest = ezInvalidIndex;
+
+      for (ezUInt32 c = 0; c < candidates.GetCount();)
+      {
+        const ezUInt32 t = candidates[c];
+
+        if (triangleCluster[t] != 0)
+        {
+          candidates.RemoveAtAndSwap(c);
+          continue;
+        }
+
+        ezUInt32 uiSharedVertices = 0;
+        for (ezUInt32 i = 0; i < 3; ++i)
+        {
+          if (vertexCluster[inout_Indices[t * 3 + i]] == uiClusterId)
+            ++uiSharedVertices;
+        }
+
+        const float fScore = (float)uiSharedVertices + unitNormals[t].Dot(vClusterNormal);
+        if (fScore > fBestScore)
+        {
+          fBestScore = fScore;
+          uiBest = c;
+        }
+
+        ++c;
+      }
+
+      // the cluster can't grow any further, the rest of the mesh is not connected to it
+      if (uiBest == ezInvalidIndex)
+        break;
+
+      const ezUInt32 t = candidates[uiBest];
+      candidates.RemoveAtAndSwap(uiBest);
+      AddTriangle(t);
+    }
+
+    // keep the previous order within the cluster
+    clusterTriangles.Sort();
+
+    ezMeshResourceDescriptor::Cluster& cluster = out_Clusters.ExpandAndGetRef();
+    cluster.m_uiFirstPrimitive = uiFirstPrimitive + uiNumEmitted;
+    cluster.m_uiPrimitiveCount = clusterTriangles.GetCount();
+
+    ezBoundingBox box;
+    box.SetInvalid();
+
+    for (ezUInt32 t : clusterTriangles)
+    {
+      for (ezUInt32 i = 0; i < 3; ++i)
+      {
+        const ezUInt32 v = inout_Indices[t * 3 + i];
+        result[uiNumEmitted * 3 + i] = v;
+        box.ExpandToInclude(positions[v]);
+      }
+
+      ++uiNumEmitted;
+    }
+
+    cluster.m_vCenter = box.GetCenter();
+    cluster.m_fRadius = 0.0f;
+
+    for (ezUInt32 t : clusterTriangles)
+    {
+      for (ezUInt32 i = 0; i < 3; ++i)
+      {
+        cluster.m_fRadius = ezMath::Max(cluster.m_fRadius, (positions[inout_Indices[t * 3 + i]] - cluster.m_vCenter).GetLengthSquared());
+      }
+    }
+
+    cluster.m_fRadius = ezMath::Sqrt(cluster.m_fRadius);
+
+    // the cone has to contain all face normals, a cone of 90 degrees or more can never be completely back-facing
+    cluster.m_vConeAxis = vNormalSum;
+    cluster.m_fConeCosAngle = 0.0f;
+    cluster.m_fConeSinAngle = 1.0f;
+
+    if (cluster.m_vConeAxis.NormalizeIfNotZero(ezVec3::ZeroVector()).Succeeded())
+    {
+      float fMinDot = 1.0f;
+      for (ezUInt32 t : clusterTriangles)
+      {
+        if (!unitNormals[t].IsZero())
+        {
+          fMinDot = ezMath::Min(fMinDot, unitNormals[t].Dot(cluster.m_vConeAxis));
+        }
+      }
+
+      // a small safety margin against rounding errors
+      const ezAngle coneAngle = ezMath::ACos(ezMath::Clamp(fMinDot, -1.0f, 1.0f)) + ezAngle::Degree(0.5f);
+
+      if (coneAngle < ezAngle::Degree(90.0f))
+      {
+        cluster.m_fConeCosAngle = ezMath::Cos(coneAngle);
+        cluster.m_fConeSinAngle = ezMath::Sin(coneAngle);
+      }
+    }
+  }
+
+  inout_Indices.CopyFrom(result);
+}
+
+ezMeshVertexCacheStats ezMeshOptimizer::AnalyzeVertexCache(ezArrayPtr<const ezUInt32> indices, ezUInt32 uiNumVertices, ezUInt32 uiCacheSize)
+{
+  ezMeshVertexCacheStats stats;
+  stats.m_uiNumTriangles = indices.GetCount() / 3;
+
+  VertexCacheSimulation cache(uiNumVertices, uiCacheSize);
+
+  ezDynamicArray<ezUInt8> referenced;
+  referenced.SetCount(uiNumVertices);
+
+  for (ezUInt32 uiIndex : indices)
+  {
+    if (cache.Access(uiIndex))
+    {
+      ++stats.m_uiNumTransformedVertices;
+    }
+
+    if (referenced[uiIndex] == 0)
+    {
+      referenced[uiIndex] = 1;
+      ++stats.m_uiNumVertices;
+    }
+  }
+
+  return stats;
+}
+
+ezResult ezMeshOptimizer::Optimize(ezMeshResourceDescriptor& desc, const Settings& settings, ezMeshVertexCacheStats* out_pStatsBefore,
+  ezMeshVertexCacheStats* out_pStatsAfter)
+{
+  ezMeshBufferResourceDescriptor& meshBuffer = desc.MeshBufferDesc();
+
+  if (meshBuffer.GetTopology() != ezGALPrimitiveTopology::Triangles || !meshBuffer.HasIndexBuffer())
+    return EZ_FAILURE;
+
+  const ezUInt32 uiNumVertices = meshBuffer.GetVertexCount();
+
+  ezDynamicArray<ezUInt32> indices;
+  meshBuffer.GetIndices(indices);
+
+  if (out_pStatsBefore != nullptr)
+  {
+    *out_pStatsBefore = AnalyzeVertexCache(indices, uiNumVertices, settings.m_uiCacheSize);
+  }
+
+  // the sub-meshes reference triangle ranges, those have to stay the same
+  ezHybridArray<ezMeshResourceDescriptor::SubMesh, 8> subMeshes;
+  subMeshes = desc.GetSubMeshes();
+  subMeshes.Sort([](const ezMeshResourceDescriptor::SubMesh& a, const ezMeshResourceDescriptor::SubMesh& b) -> bool { return a.m_uiFirstPrimitive < b.m_uiFirstPrimitive; });
+
+  bool bCanReorderTriangles = true;
+  for (ezUInt32 i = 1; i < subMeshes.GetCount(); ++i)
+  {
+    // overlapping ranges would render different triangles after reordering one of them
+    if (subMeshes[i - 1].m_uiFirstPrimitive + subMeshes[i - 1].m_uiPrimitiveCount > subMeshes[i].m_uiFirstPrimitive)
+    {
+      bCanReorderTriangles = false;
+      break;
+    }
+  }
+
+  if (subMeshes.IsEmpty())
+  {
+    auto& subMesh = subMeshes.ExpandAndGetRef();
+    subMesh.m_uiFirstPrimitive = 0;
+    subMesh.m_uiPrimitiveCount = indices.GetCount() / 3;
+  }
+
+  ezDynamicArray<ezVec3> positions;
+
+  if (bCanReorderTriangles && ((settings.m_bOptimizeVertexCache && settings.m_bOptimizeOverdraw) || settings.m_bGenerateClusters))
+  {
+    for (const ezVertexStreamInfo& si : meshBuffer.GetVertexDeclaration().m_VertexStreams)
+    {
+      if (si.m_Semantic == ezGALVertexAttributeSemantic::Position && si.m_Format == ezGALResourceFormat::XYZFloat)
+      {
+        positions.SetCountUninitialized(uiNumVertices);
+
+        const ezUInt8* pVertexData = meshBuffer.GetVertexBufferData().GetData() + si.m_uiOffset;
+        for (ezUInt32 v = 0; v < uiNumVertices; ++v)
+        {
+          ezMemoryUtils::Copy(&positions[v], reinterpret_cast<const ezVec3*>(pVertexData + v * meshBuffer.GetVertexDataSize()), 1);
+        }
+
+        break;
+      }
+    }
+  }
+
+  if (bCanReorderTriangles && settings.m_bOptimizeVertexCache)
+  {
+    ezDynamicArray<ezUInt32> clusterStarts;
+
+    for (const auto& subMesh : subMeshes)
+    {
+      ezArrayPtr<ezUInt32> subMeshIndices = indices.GetArrayPtr().GetSubArray(subMesh.m_uiFirstPrimitive * 3, subMesh.m_uiPrimitiveCount * 3);
+
+      const bool bOverdraw = settings.m_bOptimizeOverdraw && !positions.IsEmpty();
+      OptimizeVertexCache(subMeshIndices, uiNumVertices, settings.m_uiCacheSize, bOverdraw ? &clusterStarts : nullptr);
+
+      if (bOverdraw)
+      {
+        OptimizeOverdraw(subMeshIndices, positions, clusterStarts, settings.m_uiCacheSize, settings.m_fOverdrawThreshold);
+      }
+    }
+  }
+
+  if (bCanReorderTriangles && settings.m_bGenerateClusters && !positions.IsEmpty())
+  {
+    ezDynamicArray<ezMeshResourceDescriptor::Cluster> clusters;
+
+    // the clusters are stored per sub-mesh, so this has to use the unsorted sub-meshes
+    for (ezUInt32 uiSubMesh = 0; uiSubMesh < desc.GetSubMeshes().GetCount(); ++uiSubMesh)
+    {
+      const auto& subMesh = desc.GetSubMeshes()[uiSubMesh];
+      ezArrayPtr<ezUInt32> subMeshIndices = indices.GetArrayPtr().GetSubArray(subMesh.m_uiFirstPrimitive * 3, subMesh.m_uiPrimitiveCount * 3);
+
+      BuildClusters(subMeshIndices, positions, settings.m_uiMaxClusterTriangles, subMesh.m_uiFirstPrimitive, clusters);
+      desc.SetClusters(uiSubMesh, clusters);
+    }
+  }
+
+  if (settings.m_bOptimizeVertexFetch)
+  {
+    ezDynamicArray<ezUInt32> oldToNew;
+    const ezUInt32 uiNewVertexCount = OptimizeVertexFetch(indices, uiNumVertices, oldToNew);
+
+    meshBuffer.RemapVertices(oldToNew, uiNewVertexCount, indices);
+  }
+  else
+  {
+    for (ezUInt32 t = 0; t < indices.GetCount(); t += 3)
+    {
+      meshBuffer.SetTriangleIndices(t / 3, indices[t + 0], indices[t + 1], indices[t + 2]);
+    }
+  }
+
+  if (out_pStatsAfter != nullptr)
+  {
+    *out_pStatsAfter = AnalyzeVertexCache(indices, meshBuffer.GetVertexCount(), settings.m_uiCacheSize);
+  }
+
+  return EZ_SUCCESS;
+}
+
+
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_Meshes_Implementation_MeshOptimizer);
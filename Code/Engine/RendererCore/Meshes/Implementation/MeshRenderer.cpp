@@ -85,7 +85,9 @@ void ezMeshRenderer::RenderBatch(
     ezUInt32 uiStartIndex = 0;
     while (uiStartIndex < batch.GetCount())
     {
-      const ezUInt32 uiRemainingInstances = batch.GetCount() - uiStartIndex;
+      // Render data with culled clusters draws its own ranges of the sub-mesh, so it can't be instanced with other render data.
+      const bool bHasClusterRanges = !pRenderData->m_ClusterRanges.IsEmpty();
+      const ezUInt32 uiRemainingInstances = bHasClusterRanges ? 1 : batch.GetCount() - uiStartIndex;
 
       ezUInt32 uiInstanceDataOffset = 0;
       ezArrayPtr<ezPerInstanceData> instanceData = pInstanceData->GetInstanceData(uiRemainingInstances, uiInstanceDataOffset);
@@ -103,7 +105,25 @@ void ezMeshRenderer::RenderBatch(
         if (renderViewContext.m_pCamera->IsStereoscopic())
           uiRenderedInstances *= 2;
 
-        if (pContext->DrawMeshBuffer(meshPart.m_uiPrimitiveCount, meshPart.m_uiFirstPrimitive, uiRenderedInstances).Failed())
+        ezResult drawResult = EZ_SUCCESS;
+        if (bHasClusterRanges)
+        {
+          const ezMeshRenderData* pClusteredRenderData = batch.GetIterator<ezMeshRenderData>(uiStartIndex, 1);
+          for (const ezMeshClusterRange& range : pClusteredRenderData->m_ClusterRanges)
+          {
+            if (pContext->DrawMeshBuffer(range.m_uiPrimitiveCount, range.m_uiFirstPrimitive, uiRenderedInstances).Failed())
+            {
+              drawResult = EZ_FAILURE;
+              break;
+            }
+          }
+        }
+        else
+        {
+          drawResult = pContext->DrawMeshBuffer(meshPart.m_uiPrimitiveCount, meshPart.m_uiFirstPrimitive, uiRenderedInstances);
+        }
+
+        if (drawResult.Failed())
         {
           for (auto it = batch.GetIterator<ezMeshRenderData>(uiStartIndex, instanceData.GetCount()); it.IsValid(); ++it)
           {
@@ -32,6 +32,7 @@ ezResourceLoadDesc ezMeshResource::UnloadData(Unload WhatToUnload)
     m_SubMeshes.Clear();
     m_hMeshBuffer.Invalidate();
     m_Materials.Clear();
+    m_ClusterCullingData.Clear();
 
     res.m_uiQualityLevelsDiscardable = 0;
     res.m_uiQualityLevelsLoadable = 0;
@@ -75,7 +76,8 @@ ezResourceLoadDesc ezMeshResource::UpdateContent(ezStreamReader* Stream)
 void ezMeshResource::UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage)
 {
   out_NewMemoryUsage.m_uiMemoryCPU =
-    sizeof(ezMeshResource) + (ezUInt32)m_SubMeshes.GetHeapMemoryUsage() + (ezUInt32)m_Materials.GetHeapMemoryUsage();
+    sizeof(ezMeshResource) + (ezUInt32)m_SubMeshes.GetHeapMemoryUsage() + (ezUInt32)m_Materials.GetHeapMemoryUsage() +
+    (ezUInt32)m_ClusterCullingData.GetHeapMemoryUsage();
   out_NewMemoryUsage.m_uiMemoryGPU = 0;
 }
 
@@ -98,6 +100,7 @@ EZ_RESOURCE_IMPLEMENT_CREATEABLE(ezMeshResource, ezMeshResourceDescriptor)
   }
 
   m_SubMeshes = descriptor.GetSubMeshes();
+  m_ClusterCullingData.Initialize(descriptor.GetClusters());
 
   m_Materials.Clear();
   m_Materials.Reserve(descriptor.GetMaterials().GetCount());
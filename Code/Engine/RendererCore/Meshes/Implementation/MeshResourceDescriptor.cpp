@@ -23,6 +23,7 @@ void ezMeshResourceDescriptor::Clear()
   m_Materials.Clear();
   m_MeshBufferDescriptor.Clear();
   m_SubMeshes.Clear();
+  m_Clusters.Clear();
 }
 
 ezMeshBufferResourceDescriptor& ezMeshResourceDescriptor::MeshBufferDesc()
@@ -77,6 +78,8 @@ void ezMeshResourceDescriptor::AddSubMesh(ezUInt32 uiPrimitiveCount, ezUInt32 ui
   p.m_uiPrimitiveCount = uiPrimitiveCount;
   p.m_uiMaterialIndex = uiMaterialIndex;
   p.m_Bounds.SetInvalid();
+  p.m_uiFirstCluster = 0;
+  p.m_uiClusterCount = 0;
 
   m_SubMeshes.PushBack(p);
 }
@@ -88,6 +91,31 @@ void ezMeshResourceDescriptor::SetMaterial(ezUInt32 uiMaterialIndex, const char*
   m_Materials[uiMaterialIndex].m_sPath = szPathToMaterial;
 }
 
+void ezMeshResourceDescriptor::SetClusters(ezUInt32 uiSubMesh, ezArrayPtr<const Cluster> clusters)
+{
+  SubMesh& subMesh = m_SubMeshes[uiSubMesh];
+
+  if (subMesh.m_uiClusterCount > 0)
+  {
+    m_Clusters.RemoveAtAndCopy(subMesh.m_uiFirstCluster, subMesh.m_uiClusterCount);
+
+    for (SubMesh& other : m_SubMeshes)
+    {
+      if (other.m_uiFirstCluster > subMesh.m_uiFirstCluster)
+        other.m_uiFirstCluster -= subMesh.m_uiClusterCount;
+    }
+  }
+
+  subMesh.m_uiFirstCluster = m_Clusters.GetCount();
+  subMesh.m_uiClusterCount = clusters.GetCount();
+  m_Clusters.PushBackRange(clusters);
+}
+
+ezArrayPtr<const ezMeshResourceDescriptor::Cluster> ezMeshResourceDescriptor::GetClusters() const
+{
+  return m_Clusters;
+}
+
 ezResult ezMeshResourceDescriptor::Save(const char* szFile)
 {
   EZ_LOG_BLOCK("ezMeshResourceDescriptor::Save", szFile);
@@ -156,6 +184,33 @@ void ezMeshResourceDescriptor::Save(ezStreamWriter& stream)
     chunk.EndChunk();
   }
 
+  if (!m_Clusters.IsEmpty())
+  {
+    chunk.BeginChunk("Clusters", 1);
+
+    for (ezUInt32 idx = 0; idx < m_SubMeshes.GetCount(); ++idx)
+    {
+      chunk << m_SubMeshes[idx].m_uiFirstCluster;
+      chunk << m_SubMeshes[idx].m_uiClusterCount;
+    }
+
+    // number of clusters
+    chunk << m_Clusters.GetCount();
+
+    for (const Cluster& cluster : m_Clusters)
+    {
+      chunk << cluster.m_vCenter;
+      chunk << cluster.m_fRadius;
+      chunk << cluster.m_vConeAxis;
+      chunk << cluster.m_fConeCosAngle;
+      chunk << cluster.m_fConeSinAngle;
+      chunk << cluster.m_uiFirstPrimitive;
+      chunk << cluster.m_uiPrimitiveCount;
+    }
+
+    chunk.EndChunk();
+  }
+
   {
     chunk.BeginChunk("MeshInfo", 3);
 
@@ -357,6 +412,40 @@ ezResult ezMeshResourceDescriptor::Load(ezStreamReader& stream)
 
         /// \todo load from file
         m_SubMeshes[idx].m_Bounds.SetInvalid();
+
+        m_SubMeshes[idx].m_uiFirstCluster = 0;
+        m_SubMeshes[idx].m_uiClusterCount = 0;
+      }
+    }
+
+    if (ci.m_sChunkName == "Clusters")
+    {
+      if (ci.m_uiChunkVersion != 1)
+      {
+        ezLog::Error("Version of chunk '{0}' is invalid ({1})", ci.m_sChunkName, ci.m_uiChunkVersion);
+        return EZ_FAILURE;
+      }
+
+      // the 'SubMeshes' chunk is always written before this one
+      for (ezUInt32 idx = 0; idx < m_SubMeshes.GetCount(); ++idx)
+      {
+        chunk >> m_SubMeshes[idx].m_uiFirstCluster;
+        chunk >> m_SubMeshes[idx].m_uiClusterCount;
+      }
+
+      // number of clusters
+      chunk >> count;
+      m_Clusters.SetCountUninitialized(count);
+
+      for (Cluster& cluster : m_Clusters)
+      {
+        chunk >> cluster.m_vCenter;
+        chunk >> cluster.m_fRadius;
+        chunk >> cluster.m_vConeAxis;
+        chunk >> cluster.m_fConeCosAngle;
+        chunk >> cluster.m_fConeSinAngle;
+        chunk >> cluster.m_uiFirstPrimitive;
+        chunk >> cluster.m_uiPrimitiveCount;
       }
     }
 
@@ -62,9 +62,11 @@ ezMeshRenderData* ezSkinnedMeshComponent::CreateRenderData() const
 {
   auto pRenderData = ezCreateRenderDataForThisFrame<ezSkinnedMeshRenderData>(GetOwner());
 
-  if (!m_SkinningMatrices.IsEmpty())
+  if (!m_hSkinningTransformsBuffer.IsInvalidated())
   {
     pRenderData->m_hSkinningMatrices = m_hSkinningTransformsBuffer;
+
+    // components that don't animate every frame leave this empty, the buffer then keeps the last uploaded pose
     pRenderData->m_pNewSkinningMatricesData = m_SkinningMatrices.ToByteArray();
   }
 
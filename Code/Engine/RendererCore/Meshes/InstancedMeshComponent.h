@@ -100,6 +100,7 @@ public:
 
 protected:
   virtual ezMeshRenderData* CreateRenderData() const override;
+  virtual bool CanCullClusters() const override { return false; }
 
 
   //////////////////////////////////////////////////////////////////////////
@@ -90,6 +90,16 @@ public:
   /// \brief Writes the three vertex indices for the given triangle into the index buffer.
   void SetTriangleIndices(ezUInt32 uiTriangle, ezUInt32 uiVertex0, ezUInt32 uiVertex1, ezUInt32 uiVertex2);
 
+  /// \brief Copies all indices into out_Indices, independent of whether 16 or 32 bit indices are used.
+  void GetIndices(ezDynamicArray<ezUInt32>& out_Indices) const;
+
+  /// \brief Reorders the vertex data and replaces the index buffer.
+  ///
+  /// oldToNew maps every current vertex to its new index, or to ezInvalidIndex if the vertex should be removed.
+  /// indices is the new index buffer, which has to reference the new vertex indices and have the same number of primitives as before.
+  /// If the new vertex count fits into 16 bit, the index buffer is converted to 16 bit indices.
+  void RemapVertices(ezArrayPtr<const ezUInt32> oldToNew, ezUInt32 uiNewVertexCount, ezArrayPtr<const ezUInt32> indices);
+
   /// \brief Allows to read the stream info of the descriptor, which is filled out by AddStream()
   const ezVertexDeclarationInfo& GetVertexDeclaration() const { return m_VertexDeclaration; }
 
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <Foundation/Memory/AllocatorWrapper.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
+#include <RendererCore/Meshes/MeshResourceDescriptor.h>
+
+class ezCamera;
+class ezFrustum;
+
+/// \brief A range of triangles of a mesh buffer, covering one or more visible clusters.
+struct ezMeshClusterRange
+{
+  EZ_DECLARE_POD_TYPE();
+
+  ezUInt32 m_uiFirstPrimitive;
+  ezUInt32 m_uiPrimitiveCount;
+};
+
+/// \brief The culling parameters of one view for one mesh instance, transformed into the object space of the mesh.
+///
+/// Testing the clusters in object space means that their bounds don't need to be transformed, and non-uniform scaling and
+/// mirroring are handled exactly.
+class EZ_RENDERERCORE_DLL ezMeshClusterCullingView
+{
+public:
+  ezMeshClusterCullingView();
+
+  /// \brief Sets up the culling against the given world space frustum, for a mesh instance with the given transform.
+  ///
+  /// If pCamera is given, clusters that only contain back-facing triangles can be culled as well. Only pass a camera, if the view is
+  /// rendered from the camera's position with back-face culling, i.e. not for stereo cameras or shadow views.
+  void Setup(const ezFrustum& frustum, const ezTransform& objectTransform, const ezCamera* pCamera);
+
+  /// \brief Returns false if culling is not possible, e.g. because the object is scaled to zero. All clusters are visible then.
+  bool IsEnabled() const { return m_bEnabled; }
+
+private:
+  friend class ezMeshClusterCullingData;
+
+  bool m_bEnabled = false;
+
+  ezSimdVec4f m_PlaneX[6];
+  ezSimdVec4f m_PlaneY[6];
+  ezSimdVec4f m_PlaneZ[6];
+  ezSimdVec4f m_PlaneW[6];
+
+  // The cone test uses d = center * m_CenterScale - m_CameraPos, which is the vector from the camera to the cluster for perspective
+  // cameras (scale 1) and the view direction for orthographic cameras (scale 0, camera pos = -direction).
+  ezSimdVec4f m_CameraX;
+  ezSimdVec4f m_CameraY;
+  ezSimdVec4f m_CameraZ;
+  ezSimdVec4f m_CenterScale;
+  bool m_bCullBackfaces = false;
+};
+
+/// \brief The clusters of a mesh in a SIMD friendly layout, four clusters at a time.
+///
+/// Created by ezMeshResource from the clusters that ezMeshOptimizer::BuildClusters() generated in the asset pipeline.
+class EZ_RENDERERCORE_DLL ezMeshClusterCullingData
+{
+public:
+  void Initialize(ezArrayPtr<const ezMeshResourceDescriptor::Cluster> clusters);
+  void Clear();
+
+  ezUInt32 GetClusterCount() const { return m_ClusterRanges.GetCount(); }
+  ezUInt64 GetHeapMemoryUsage() const;
+
+  /// \brief Culls the given range of clusters and appends the triangle ranges of the visible ones to out_Ranges.
+  ///
+  /// Back-facing clusters are only culled if bCullBackfaces is true and the view was set up with a camera.
+  /// Visible clusters that directly follow each other in the index buffer are merged into one range.
+  /// Returns the number of visible clusters.
+  ezUInt32 CullClusters(const ezMeshClusterCullingView& view, ezUInt32 uiFirstCluster, ezUInt32 uiClusterCount, bool bCullBackfaces,
+    ezDynamicArray<ezMeshClusterRange>& out_Ranges) const;
+
+private:
+  struct ClusterBlock
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezSimdVec4f m_CenterX;
+    ezSimdVec4f m_CenterY;
+    ezSimdVec4f m_CenterZ;
+    ezSimdVec4f m_Radius;
+    ezSimdVec4f m_ConeAxisX;
+    ezSimdVec4f m_ConeAxisY;
+    ezSimdVec4f m_ConeAxisZ;
+    ezSimdVec4f m_ConeCosAngle;
+    ezSimdVec4f m_ConeSinAngle;
+  };
+
+  ezDynamicArray<ClusterBlock, ezAlignedAllocatorWrapper> m_Blocks;
+  ezDynamicArray<ezMeshClusterRange> m_ClusterRanges;
+};
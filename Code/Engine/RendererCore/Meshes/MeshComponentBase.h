@@ -26,6 +26,9 @@ public:
 
   ezUInt32 m_uiUniqueID = 0;
 
+  /// \brief If not empty, only these triangle ranges of the sub-mesh are drawn, the other clusters of the sub-mesh were culled.
+  ezArrayPtr<const ezMeshClusterRange> m_ClusterRanges;
+
 protected:
   EZ_FORCE_INLINE void FillBatchIdAndSortingKeyInternal(ezUInt32 uiAdditionalBatchData)
   {
@@ -35,8 +38,9 @@ protected:
     const ezUInt32 uiMeshIDHash = m_hMesh.GetResourceIDHash();
     const ezUInt32 uiMaterialIDHash = m_hMaterial.IsValid() ? m_hMaterial.GetResourceIDHash() : 0;
 
-    // Generate batch id from mesh, material and part index.
-    ezUInt32 data[] = {uiMeshIDHash, uiMaterialIDHash, m_uiSubMeshIndex, m_uiFlipWinding, uiAdditionalBatchData};
+    // Generate batch id from mesh, material and part index. Render data with cluster ranges can't be instanced with the others.
+    const ezUInt32 uiHasClusterRanges = m_ClusterRanges.IsEmpty() ? 0 : 1;
+    ezUInt32 data[] = {uiMeshIDHash, uiMaterialIDHash, m_uiSubMeshIndex, m_uiFlipWinding, uiHasClusterRanges, uiAdditionalBatchData};
     m_uiBatchId = ezHashingUtils::xxHash32(data, sizeof(data));
 
     // Sort by material and then by mesh
@@ -102,6 +106,10 @@ public:
 protected:
   virtual ezMeshRenderData* CreateRenderData() const;
 
+  /// \brief Whether the clusters of the mesh can be culled with the owner's transform. Not the case if the vertices are moved or
+  /// the mesh is drawn at other places as well.
+  virtual bool CanCullClusters() const { return true; }
+
   ezUInt32 Materials_GetCount() const;                          // [ property ]
   const char* Materials_GetValue(ezUInt32 uiIndex) const;       // [ property ]
   void Materials_SetValue(ezUInt32 uiIndex, const char* value); // [ property ]
@@ -114,4 +122,12 @@ protected:
   ezMeshResourceHandle m_hMesh;
   ezDynamicArray<ezMaterialResourceHandle> m_Materials;
   ezColor m_Color = ezColor::White;
+
+private:
+  bool IsMaterialTwoSided(ezUInt32 uiMaterialIndex, const ezMaterialResourceHandle& hMaterial) const;
+
+  // Bitmasks for the first 32 material slots, so that cluster culling doesn't need to look at the materials every frame.
+  // Filled during extraction, which may run for several views in parallel, and reset when the mesh or a material changes.
+  mutable ezAtomicInteger32 m_iMaterialsTwoSidedKnown;
+  mutable ezAtomicInteger32 m_iMaterialsTwoSided;
 };
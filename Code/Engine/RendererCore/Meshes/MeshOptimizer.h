@@ -0,0 +1,95 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Math/Vec3.h>
+#include <RendererCore/Meshes/MeshResourceDescriptor.h>
+
+/// \brief Post-transform vertex cache statistics of a triangle list, as computed by ezMeshOptimizer::AnalyzeVertexCache().
+struct EZ_RENDERERCORE_DLL ezMeshVertexCacheStats
+{
+  ezUInt32 m_uiNumTriangles = 0;
+  ezUInt32 m_uiNumVertices = 0;            ///< The number of distinct vertices that are referenced by the triangles.
+  ezUInt32 m_uiNumTransformedVertices = 0; ///< How often a vertex had to be transformed, i.e. the number of cache misses.
+
+  /// \brief Average cache miss ratio, the number of transformed vertices per triangle.
+  ///
+  /// 3 is the worst case, for typical meshes around 0.6 to 0.7 is achievable and 0.5 is the limit for large regular grids.
+  float GetACMR() const;
+
+  /// \brief Average transformed vertex ratio, the number of transformed vertices per referenced vertex. 1 is optimal.
+  float GetATVR() const;
+};
+
+/// \brief Reorders the triangles and vertices of meshes for faster rendering.
+///
+/// These functions are meant to run in the asset pipeline. They never change what is rendered, only the order in which the
+/// triangles and vertices are stored:
+///   * OptimizeVertexCache() reorders triangles such that the GPU's post-transform cache can reuse more vertices (Tipsify).
+///   * OptimizeOverdraw() reorders clusters of triangles such that outward facing parts of the mesh are drawn first, which reduces overdraw
+///     without losing much of the vertex cache efficiency.
+///   * OptimizeVertexFetch() renumbers the vertices in the order in which they are used, which makes vertex fetching more cache
+///     friendly. Unreferenced vertices are removed, which can allow the use of 16 bit indices.
+///   * BuildClusters() groups the triangles into small clusters with bounds, which ezMeshClusterCullingData can cull per view.
+class EZ_RENDERERCORE_DLL ezMeshOptimizer
+{
+public:
+  struct Settings
+  {
+    /// The size of the FIFO cache that is optimized for. Does not need to match the hardware exactly, 16 works well on all GPUs.
+    ezUInt32 m_uiCacheSize = 16;
+
+    bool m_bOptimizeVertexCache = true;
+
+    /// Only has an effect, when the vertex cache is optimized as well.
+    bool m_bOptimizeOverdraw = true;
+
+    /// How much worse the ACMR of a cluster may get, to split it into more clusters for the overdraw optimization.
+    float m_fOverdrawThreshold = 1.05f;
+
+    /// Also removes vertices that are not referenced by any triangle. If that brings the vertex count below 65536, the mesh uses 16 bit indices.
+    bool m_bOptimizeVertexFetch = true;
+
+    /// Splits every sub-mesh into clusters that are culled individually per view. Only worth it for large meshes that are often only
+    /// partially visible, e.g. terrain or buildings.
+    bool m_bGenerateClusters = false;
+    ezUInt32 m_uiMaxClusterTriangles = 128;
+  };
+
+  /// \brief Reorders the triangles for better post-transform vertex cache utilization, using the Tipsify algorithm.
+  ///
+  /// If out_pClusterStarts is given, it receives the index of the first triangle of every cluster. A new cluster starts wherever the
+  /// algorithm runs into a dead end and continues in another part of the mesh. These clusters can then be passed to OptimizeOverdraw().
+  static void OptimizeVertexCache(ezArrayPtr<ezUInt32> inout_Indices, ezUInt32 uiNumVertices, ezUInt32 uiCacheSize,
+    ezDynamicArray<ezUInt32>* out_pClusterStarts = nullptr);
+
+  /// \brief Sorts the given clusters of triangles, such that clusters that face away from the center of the mesh are drawn first.
+  ///
+  /// Clusters are additionally split where that only raises their ACMR by less than fThreshold. The order of the triangles within each
+  /// cluster is kept, so the vertex cache optimization of OptimizeVertexCache() is mostly preserved.
+  static void OptimizeOverdraw(ezArrayPtr<ezUInt32> inout_Indices, ezArrayPtr<const ezVec3> positions, ezArrayPtr<const ezUInt32> clusterStarts,
+    ezUInt32 uiCacheSize, float fThreshold);
+
+  /// \brief Renumbers the vertices in the order in which they are first referenced.
+  ///
+  /// out_OldToNew receives the new index of every vertex, or ezInvalidIndex for vertices that are not referenced at all.
+  /// Returns the number of referenced vertices.
+  static ezUInt32 OptimizeVertexFetch(ezArrayPtr<ezUInt32> inout_Indices, ezUInt32 uiNumVertices, ezDynamicArray<ezUInt32>& out_OldToNew);
+
+  /// \brief Reorders the triangles into spatially compact clusters of up to uiMaxTriangles triangles and computes their bounds.
+  ///
+  /// Clusters grow along shared vertices and prefer triangles that face in the same direction, to keep their normal cones narrow.
+  /// The triangles of each cluster are stored contiguously in their previous relative order, so a vertex cache optimization mostly
+  /// survives. The primitive ranges of the clusters are offset by uiFirstPrimitive.
+  static void BuildClusters(ezArrayPtr<ezUInt32> inout_Indices, ezArrayPtr<const ezVec3> positions, ezUInt32 uiMaxTriangles,
+    ezUInt32 uiFirstPrimitive, ezDynamicArray<ezMeshResourceDescriptor::Cluster>& out_Clusters);
+
+  /// \brief Simulates a FIFO post-transform cache of the given size.
+  static ezMeshVertexCacheStats AnalyzeVertexCache(ezArrayPtr<const ezUInt32> indices, ezUInt32 uiNumVertices, ezUInt32 uiCacheSize);
+
+  /// \brief Applies all enabled optimizations to the mesh buffer of the given mesh.
+  ///
+  /// Every sub-mesh is optimized separately, so their triangle ranges stay the same.
+  /// Fails and leaves the mesh untouched, if it doesn't use an indexed triangle list.
+  static ezResult Optimize(ezMeshResourceDescriptor& desc, const Settings& settings, ezMeshVertexCacheStats* out_pStatsBefore = nullptr,
+    ezMeshVertexCacheStats* out_pStatsAfter = nullptr);
+};
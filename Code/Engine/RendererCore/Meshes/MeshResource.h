@@ -1,6 +1,7 @@
 #pragma once
 
 #include <RendererCore/Meshes/MeshBufferResource.h>
+#include <RendererCore/Meshes/MeshClusterCulling.h>
 #include <RendererCore/Meshes/MeshResourceDescriptor.h>
 
 typedef ezTypedResourceHandle<class ezMaterialResource> ezMaterialResourceHandle;
@@ -29,6 +30,9 @@ public:
   /// \brief Returns the skeleton for this mesh. Will be an invalid handle for static meshes.
   const ezSkeletonResourceHandle& GetSkeleton() const { return m_hSkeleton; }
 
+  /// \brief Returns the cluster bounds of all sub-meshes. Empty, if the mesh was not split into clusters.
+  const ezMeshClusterCullingData& GetClusterCullingData() const { return m_ClusterCullingData; }
+
 private:
   virtual ezResourceLoadDesc UnloadData(Unload WhatToUnload) override;
   virtual ezResourceLoadDesc UpdateContent(ezStreamReader* Stream) override;
@@ -38,6 +42,7 @@ private:
   ezMeshBufferResourceHandle m_hMeshBuffer;
   ezDynamicArray<ezMaterialResourceHandle> m_Materials;
   ezSkeletonResourceHandle m_hSkeleton;
+  ezMeshClusterCullingData m_ClusterCullingData;
 
   ezBoundingBoxSphere m_Bounds;
 
@@ -18,6 +18,27 @@ public:
     ezUInt32 m_uiMaterialIndex;
 
     ezBoundingBoxSphere m_Bounds;
+
+    ezUInt32 m_uiFirstCluster;
+    ezUInt32 m_uiClusterCount; ///< Zero, if the sub-mesh has no clusters and can only be rendered as a whole.
+  };
+
+  /// \brief A contiguous range of triangles of a sub-mesh, with conservative bounds for culling it per view.
+  ///
+  /// The normal cone contains the face normals of all triangles of the cluster. If the camera sees none of them from the front,
+  /// the whole cluster is back-facing. A cone angle of 90 degrees or more can never be back-facing and disables that test.
+  struct Cluster
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezVec3 m_vCenter;
+    float m_fRadius;
+    ezVec3 m_vConeAxis;
+    float m_fConeCosAngle;
+    float m_fConeSinAngle;
+
+    ezUInt32 m_uiFirstPrimitive;
+    ezUInt32 m_uiPrimitiveCount;
   };
 
   struct Material
@@ -39,6 +60,12 @@ public:
 
   void SetMaterial(ezUInt32 uiMaterialIndex, const char* szPathToMaterial);
 
+  /// \brief Sets the clusters of a sub-mesh. They have to cover exactly the triangle range of the sub-mesh.
+  void SetClusters(ezUInt32 uiSubMesh, ezArrayPtr<const Cluster> clusters);
+
+  /// \brief Returns the clusters of all sub-meshes. Use SubMesh::m_uiFirstCluster and m_uiClusterCount to find the clusters of a sub-mesh.
+  ezArrayPtr<const Cluster> GetClusters() const;
+
   void Save(ezStreamWriter& stream);
   ezResult Save(const char* szFile);
 
@@ -61,6 +88,7 @@ private:
 
   ezHybridArray<Material, 8> m_Materials;
   ezHybridArray<SubMesh, 8> m_SubMeshes;
+  ezDynamicArray<Cluster> m_Clusters;
   ezMeshBufferResourceDescriptor m_MeshBufferDescriptor;
   ezMeshBufferResourceHandle m_hMeshBuffer;
   ezSkeletonResourceHandle m_hSkeleton;
@@ -34,6 +34,7 @@ protected:
 
 protected:
   virtual ezMeshRenderData* CreateRenderData() const override;
+  virtual bool CanCullClusters() const override { return false; }
 
 
   //////////////////////////////////////////////////////////////////////////
@@ -38,6 +38,10 @@ EZ_END_DYNAMIC_REFLECTED_TYPE;
 EZ_IMPLEMENT_MESSAGE_TYPE(ezMsgExtractRenderData);
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMsgExtractRenderData, 1, ezRTTIDefaultAllocator<ezMsgExtractRenderData>)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+EZ_IMPLEMENT_MESSAGE_TYPE(ezMsgExtractOccluderData);
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMsgExtractOccluderData, 1, ezRTTIDefaultAllocator<ezMsgExtractOccluderData>)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
 ezHybridArray<ezRenderData::CategoryData, 32> ezRenderData::s_CategoryData;
@@ -191,4 +195,11 @@ void ezMsgExtractRenderData::AddRenderData(
   cached.m_uiCacheIfStatic = (cachingBehavior == ezRenderData::Caching::IfStatic);
 }
 
+void ezMsgExtractOccluderData::AddOccluder(const ezRasterizerObject* pObject, const ezTransform& transform)
+{
+  auto& occluder = m_Occluders.ExpandAndGetRef();
+  occluder.m_pObject = pObject;
+  occluder.m_Transform = transform;
+}
+
 EZ_STATICLINK_FILE(RendererCore, RendererCore_Pipeline_Implementation_RenderData);
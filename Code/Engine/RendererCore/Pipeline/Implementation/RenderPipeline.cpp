@@ -9,6 +9,7 @@
 #include <RendererCore/Pipeline/Passes/TargetPass.h>
 #include <RendererCore/Pipeline/RenderPipeline.h>
 #include <RendererCore/Pipeline/View.h>
+#include <RendererCore/Rasterizer/RasterizerView.h>
 #include <RendererCore/RenderContext/RenderContext.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 #include <RendererFoundation/Profiling/Profiling.h>
@@ -20,6 +21,8 @@ ezCVarBool ezRenderPipeline::s_DebugCulling("r_DebugCulling", false, ezCVarFlags
 ezCVarBool CVarCullingStats("r_CullingStats", false, ezCVarFlags::Default, "Display some stats of the visibility culling");
 #endif
 
+ezCVarBool CVarOcclusionCulling("r_OcclusionCulling", true, ezCVarFlags::Default, "Enables CPU occlusion culling for the views that use it");
+
 ezRenderPipeline::ezRenderPipeline()
   : m_PipelineState(PipelineState::Uninitialized)
 {
@@ -934,14 +937,37 @@ void ezRenderPipeline::FindVisibleObjects(const ezView& view)
 
   EZ_LOCK(view.GetWorld()->GetReadMarker());
 
+  ezSpatialSystem::IsOccludedFunc isOccluded;
+  const bool bOcclusionCulling = view.GetOcclusionCullingEnabled() && CVarOcclusionCulling;
+
+  if (bOcclusionCulling)
+  {
+    if (m_pRasterizerView == nullptr)
+    {
+      m_pRasterizerView = EZ_DEFAULT_NEW(ezRasterizerView);
+    }
+
+    ezMat4 viewProjection;
+    view.ComputeCullingViewProjection(viewProjection);
+
+    RasterizeOccluders(*view.GetWorld(), &view, frustum, viewProjection, *m_pRasterizerView, m_visibleOccluders);
+
+    if (m_pRasterizerView->GetNumTriangles() > 0)
+    {
+      const ezRasterizerView* pRasterizerView = m_pRasterizerView.Borrow();
+      isOccluded = [pRasterizerView](const ezSimdBBox& box) { return !pRasterizerView->IsVisible(box); };
+    }
+  }
+
+  const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   const bool bIsMainView =
     (view.GetCameraUsageHint() == ezCameraUsageHint::MainView || view.GetCameraUsageHint() == ezCameraUsageHint::EditorView);
   const bool bRecordStats = CVarCullingStats && bIsMainView;
   ezSpatialSystem::QueryStats stats;
 
-  ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
-  view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, m_visibleObjects, bRecordStats ? &stats : nullptr);
+  view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, m_visibleObjects, bRecordStats ? &stats : nullptr, isOccluded);
 
   ezViewHandle hView = view.GetHandle();
 
@@ -970,12 +996,53 @@ void ezRenderPipeline::FindVisibleObjects(const ezView& view)
 
     sb.Format("Time Taken: {0}ms", m_AverageCullingTime.GetMilliseconds());
     ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 280), ezColor::LimeGreen);
+
+    if (bOcclusionCulling)
+    {
+      sb.Format("Num Objects Occluded: {0}", stats.m_uiNumObjectsOccluded);
+      ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 300), ezColor::LimeGreen);
+
+      sb.Format("Num Occluders: {0} ({1} triangles)", m_pRasterizerView->GetNumOccluders(), m_pRasterizerView->GetNumTriangles());
+      ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 320), ezColor::LimeGreen);
+    }
   }
 #else
-  view.GetWorld()->GetSpatialSystem().FindVisibleObjects(frustum, m_visibleObjects, nullptr);
+  view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, m_visibleObjects, nullptr, isOccluded);
 #endif
 }
 
+// static
+void ezRenderPipeline::RasterizeOccluders(const ezWorld& world, const ezView* pView, const ezFrustum& frustum, const ezMat4& viewProjection,
+  ezRasterizerView& rasterizer, ezDynamicArray<const ezGameObject*>& out_VisibleOccluders)
+{
+  EZ_PROFILE_SCOPE("Rasterize Occluders");
+
+  rasterizer.BeginScene(viewProjection);
+
+  out_VisibleOccluders.Clear();
+
+  const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::OcclusionStatic.GetBitmask() | ezDefaultSpatialDataCategories::OcclusionDynamic.GetBitmask();
+  world.GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, out_VisibleOccluders);
+
+  if (out_VisibleOccluders.IsEmpty())
+    return;
+
+  ezMsgExtractOccluderData msg;
+  msg.m_pView = pView;
+
+  for (const ezGameObject* pObject : out_VisibleOccluders)
+  {
+    pObject->SendMessage(msg);
+  }
+
+  for (const auto& occluder : msg.m_Occluders)
+  {
+    rasterizer.AddObject(occluder.m_pObject, occluder.m_Transform);
+  }
+
+  rasterizer.EndScene();
+}
+
 void ezRenderPipeline::Render(ezRenderContext* pRenderContext)
 {
   EZ_PROFILE_AND_MARKER(pRenderContext->GetGALContext(), m_sName.GetData());
@@ -39,6 +39,7 @@ ezView::ezView()
   m_pWorld = nullptr;
   m_pCamera = nullptr;
   m_pCullingCamera = nullptr;
+  m_bOcclusionCullingEnabled = false;
 
   m_uiLastCameraSettingsModification = 0;
   m_uiLastCameraOrientationModification = 0;
@@ -137,6 +138,14 @@ void ezView::ExtractData()
 }
 
 void ezView::ComputeCullingFrustum(ezFrustum& out_Frustum) const
+{
+  ezMat4 viewProjection;
+  ComputeCullingViewProjection(viewProjection);
+
+  out_Frustum.SetFrustum(viewProjection);
+}
+
+void ezView::ComputeCullingViewProjection(ezMat4& out_ViewProjection) const
 {
   const ezCamera* pCamera = GetCullingCamera();
   const float fViewportAspectRatio = m_Data.m_ViewPortRect.width / m_Data.m_ViewPortRect.height;
@@ -146,7 +155,17 @@ void ezView::ComputeCullingFrustum(ezFrustum& out_Frustum) const
   ezMat4 projectionMatrix;
   pCamera->GetProjectionMatrix(fViewportAspectRatio, projectionMatrix);
 
-  out_Frustum.SetFrustum(projectionMatrix * viewMatrix);
+  out_ViewProjection = projectionMatrix * viewMatrix;
+}
+
+void ezView::SetOcclusionCullingEnabled(bool bEnabled)
+{
+  m_bOcclusionCullingEnabled = bEnabled;
+}
+
+bool ezView::GetOcclusionCullingEnabled() const
+{
+  return m_bOcclusionCullingEnabled;
 }
 
 void ezView::SetRenderPassProperty(const char* szPassName, const char* szPropertyName, const ezVariant& value)
@@ -7,6 +7,8 @@
 #include <Foundation/Strings/HashedString.h>
 #include <RendererCore/Pipeline/Declarations.h>
 
+class ezRasterizerObject;
+
 /// \brief Base class for all render data. Render data must contain all information that is needed to render the corresponding object.
 class EZ_RENDERERCORE_DLL ezRenderData : public ezReflectedClass
 {
@@ -121,4 +123,30 @@ private:
   ezHybridArray<ezInternal::RenderDataCacheEntry, 16> m_ExtractedRenderData;
 };
 
+/// \brief Sent to the objects in the occlusion categories of the spatial system, before the visible objects of a view are searched.
+///
+/// Components that act as occluders add their geometry, which is then rasterized into the view's ezRasterizerView.
+struct EZ_RENDERERCORE_DLL ezMsgExtractOccluderData : public ezMessage
+{
+  EZ_DECLARE_MESSAGE_TYPE(ezMsgExtractOccluderData, ezMessage);
+
+  const ezView* m_pView = nullptr;
+
+  /// \brief The object must stay alive until the end of the frame.
+  void AddOccluder(const ezRasterizerObject* pObject, const ezTransform& transform);
+
+private:
+  friend class ezRenderPipeline;
+
+  struct Occluder
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    const ezRasterizerObject* m_pObject;
+    ezTransform m_Transform;
+  };
+
+  ezHybridArray<Occluder, 16> m_Occluders;
+};
+
 #include <RendererCore/Pipeline/Implementation/RenderData_inl.h>
@@ -11,6 +11,8 @@ class ezProfilingId;
 class ezView;
 class ezRenderPipelinePass;
 class ezFrameDataProviderBase;
+class ezRasterizerView;
+class ezWorld;
 
 class EZ_RENDERERCORE_DLL ezRenderPipeline : public ezRefCounted
 {
@@ -50,6 +52,13 @@ public:
   const ezExtractedRenderData& GetRenderData() const;
   ezRenderDataBatchList GetRenderDataBatchesWithCategory(ezRenderData::Category category, ezRenderDataBatch::Filter filter = ezRenderDataBatch::Filter()) const;
 
+  /// \brief Rasterizes the occluders inside the frustum into the given depth buffer, which is then used for CPU occlusion culling.
+  ///
+  /// The occluders are found through the occlusion categories of the spatial system and add their shapes through ezMsgExtractOccluderData.
+  /// pView is passed on in that message and may be null. out_VisibleOccluders is only used as temporary storage.
+  static void RasterizeOccluders(const ezWorld& world, const ezView* pView, const ezFrustum& frustum, const ezMat4& viewProjection,
+    ezRasterizerView& rasterizer, ezDynamicArray<const ezGameObject*>& out_VisibleOccluders);
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   static ezCVarBool s_DebugCulling;
 #endif
@@ -91,6 +100,10 @@ private: // Member data
   ezExtractedRenderData m_Data[2];
   ezDynamicArray<const ezGameObject*> m_visibleObjects;
 
+  // CPU occlusion culling
+  ezDynamicArray<const ezGameObject*> m_visibleOccluders;
+  ezUniquePtr<ezRasterizerView> m_pRasterizerView;
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   ezTime m_AverageCullingTime;
 #endif
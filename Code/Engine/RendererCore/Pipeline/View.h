@@ -101,6 +101,16 @@ public:
   /// \brief Returns the frustum that should be used for determine visible objects for this view.
   void ComputeCullingFrustum(ezFrustum& out_Frustum) const;
 
+  /// \brief Returns the view projection matrix of the culling camera, which ComputeCullingFrustum() is based on.
+  void ComputeCullingViewProjection(ezMat4& out_ViewProjection) const;
+
+  /// \brief Enables culling of objects that are hidden behind occluders, see ezOccluderComponent. Disabled by default.
+  ///
+  /// The occluders are rasterized on the CPU before the visible objects are determined. This is only worth it for views that look at
+  /// many objects which are often hidden behind large occluders, e.g. in cities. The cvar r_OcclusionCulling disables it globally.
+  void SetOcclusionCullingEnabled(bool bEnabled);
+  bool GetOcclusionCullingEnabled() const;
+
   void SetRenderPassProperty(const char* szPassName, const char* szPropertyName, const ezVariant& value);
   void SetExtractorProperty(const char* szPassName, const char* szPropertyName, const ezVariant& value);
 
@@ -134,6 +144,7 @@ private:
   ezSharedPtr<ezRenderPipeline> m_pRenderPipeline;
   ezCamera* m_pCamera;
   ezCamera* m_pCullingCamera;
+  bool m_bOcclusionCullingEnabled;
 
 private:
   ezInputNodePin m_PinRenderTarget0;
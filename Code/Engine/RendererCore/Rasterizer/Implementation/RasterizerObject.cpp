@@ -0,0 +1,138 @@
+#include <RendererCorePCH.h>
+
+#include <Foundation/Configuration/Startup.h>
+#include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/Mutex.h>
+#include <RendererCore/Meshes/CpuMeshResource.h>
+#include <RendererCore/Rasterizer/RasterizerObject.h>
+
+// clang-format off
+EZ_BEGIN_SUBSYSTEM_DECLARATION(RendererCore, RasterizerObject)
+
+  BEGIN_SUBSYSTEM_DEPENDENCIES
+    "Foundation",
+    "Core"
+  END_SUBSYSTEM_DEPENDENCIES
+
+  ON_HIGHLEVELSYSTEMS_SHUTDOWN
+  {
+    ezRasterizerObject::ClearCache();
+  }
+
+EZ_END_SUBSYSTEM_DECLARATION;
+// clang-format on
+
+static ezMutex s_ObjectCacheMutex;
+static ezHashTable<ezString, ezSharedPtr<ezRasterizerObject>> s_ObjectCache;
+
+ezRasterizerObject::ezRasterizerObject() = default;
+ezRasterizerObject::~ezRasterizerObject() = default;
+
+ezSharedPtr<ezRasterizerObject> ezRasterizerObject::CreateBox(const ezVec3& vFullExtents)
+{
+  ezSharedPtr<ezRasterizerObject> pObject = EZ_DEFAULT_NEW(ezRasterizerObject);
+
+  const ezVec3 h = vFullExtents * 0.5f;
+  pObject->m_Bounds.SetCenterAndHalfExtents(ezVec3::ZeroVector(), h);
+
+  ezVec3 corners[8];
+  pObject->m_Bounds.GetCorners(corners);
+
+  // the rasterizer does not cull back faces, so the winding does not matter
+  static const ezUInt8 s_Indices[] = {
+    0, 1, 3, 0, 3, 2, // -x
+    4, 6, 7, 4, 7, 5, // +x
+    0, 4, 5, 0, 5, 1, // -y
+    2, 3, 7, 2, 7, 6, // +y
+    0, 2, 6, 0, 6, 4, // -z
+    1, 5, 7, 1, 7, 3, // +z
+  };
+
+  pObject->m_Triangles.SetCountUninitialized(EZ_ARRAY_SIZE(s_Indices));
+  for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(s_Indices); ++i)
+  {
+    pObject->m_Triangles[i] = corners[s_Indices[i]];
+  }
+
+  return pObject;
+}
+
+ezSharedPtr<ezRasterizerObject> ezRasterizerObject::CreateMesh(const ezMeshResourceDescriptor& desc)
+{
+  const ezMeshBufferResourceDescriptor& mb = desc.MeshBufferDesc();
+
+  if (mb.GetTopology() != ezGALPrimitiveTopology::Triangles || mb.GetPrimitiveCount() == 0 || !mb.HasIndexBuffer())
+    return nullptr;
+
+  const ezVertexDeclarationInfo& vdi = mb.GetVertexDeclaration();
+  const float* pPositions = nullptr;
+
+  for (ezUInt32 vs = 0; vs < vdi.m_VertexStreams.GetCount(); ++vs)
+  {
+    if (vdi.m_VertexStreams[vs].m_Semantic == ezGALVertexAttributeSemantic::Position &&
+        vdi.m_VertexStreams[vs].m_Format == ezGALResourceFormat::RGBFloat)
+    {
+      pPositions = reinterpret_cast<const float*>(mb.GetVertexBufferData().GetData() + vdi.m_VertexStreams[vs].m_uiOffset);
+    }
+  }
+
+  if (pPositions == nullptr)
+    return nullptr;
+
+  const ezUInt32 uiStride = mb.GetVertexDataSize();
+  const ezUInt32 uiNumIndices = mb.GetPrimitiveCount() * 3;
+  const ezUInt8* pIndices = mb.GetIndexBufferData().GetData();
+
+  ezSharedPtr<ezRasterizerObject> pObject = EZ_DEFAULT_NEW(ezRasterizerObject);
+  pObject->m_Triangles.SetCountUninitialized(uiNumIndices);
+
+  for (ezUInt32 i = 0; i < uiNumIndices; ++i)
+  {
+    const ezUInt32 uiIndex = mb.Uses32BitIndices() ? reinterpret_cast<const ezUInt32*>(pIndices)[i] : reinterpret_cast<const ezUInt16*>(pIndices)[i];
+    const float* pPos = ezMemoryUtils::AddByteOffset(pPositions, uiIndex * uiStride);
+
+    pObject->m_Triangles[i].Set(pPos[0], pPos[1], pPos[2]);
+  }
+
+  pObject->m_Bounds.SetFromPoints(pObject->m_Triangles.GetData(), pObject->m_Triangles.GetCount());
+
+  return pObject;
+}
+
+ezSharedPtr<ezRasterizerObject> ezRasterizerObject::GetObject(const char* szCpuMeshResource)
+{
+  EZ_LOCK(s_ObjectCacheMutex);
+
+  ezSharedPtr<ezRasterizerObject>* pCached = nullptr;
+  if (s_ObjectCache.TryGetValue(szCpuMeshResource, pCached))
+    return *pCached;
+
+  ezSharedPtr<ezRasterizerObject> pObject;
+
+  ezCpuMeshResourceHandle hCpuMesh = ezResourceManager::LoadResource<ezCpuMeshResource>(szCpuMeshResource);
+  ezResourceLock<ezCpuMeshResource> pCpuMesh(hCpuMesh, ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+
+  if (pCpuMesh.GetAcquireResult() == ezResourceAcquireResult::Final)
+  {
+    pObject = CreateMesh(pCpuMesh->GetDescriptor());
+  }
+
+  if (pObject == nullptr)
+  {
+    ezLog::Warning("Mesh '{}' can't be used as an occluder", szCpuMeshResource);
+  }
+
+  // failures are cached as well, to not load the mesh again for every component
+  s_ObjectCache.Insert(szCpuMeshResource, pObject);
+  return pObject;
+}
+
+void ezRasterizerObject::ClearCache()
+{
+  EZ_LOCK(s_ObjectCacheMutex);
+  s_ObjectCache.Clear();
+}
+
+
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_Rasterizer_Implementation_RasterizerObject);
@@ -0,0 +1,444 @@
+#include <RendererCorePCH.h>
+
+#include <Foundation/SimdMath/SimdVec4b.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <RendererCore/Rasterizer/RasterizerObject.h>
+#include <RendererCore/Rasterizer/RasterizerView.h>
+
+namespace
+{
+  constexpr ezUInt32 TileSize = 8;
+  constexpr ezUInt32 PixelsPerTile = TileSize * TileSize;
+} // namespace
+
+ezRasterizerView::ezRasterizerView()
+{
+  m_mViewProjection.SetIdentity();
+  SetResolution(256, 128);
+}
+
+ezRasterizerView::~ezRasterizerView() = default;
+
+void ezRasterizerView::SetResolution(ezUInt32 uiWidth, ezUInt32 uiHeight)
+{
+  m_uiNumTilesX = ezMath::Max((uiWidth + TileSize - 1) / TileSize, 1u);
+  m_uiNumTilesY = ezMath::Max((uiHeight + TileSize - 1) / TileSize, 1u);
+  m_uiResolutionX = m_uiNumTilesX * TileSize;
+  m_uiResolutionY = m_uiNumTilesY * TileSize;
+
+  m_Depth.SetCountUninitialized(m_uiNumTilesX * m_uiNumTilesY * PixelsPerTile);
+  m_TileMaxDepth.SetCountUninitialized(m_uiNumTilesX * m_uiNumTilesY);
+  m_TileRowTriangles.SetCount(m_uiNumTilesY);
+
+  BeginScene(m_mViewProjection);
+}
+
+void ezRasterizerView::BeginScene(const ezMat4& mViewProjection, ezClipSpaceDepthRange::Enum depthRange)
+{
+  m_mViewProjection = mViewProjection;
+
+  // same as the near plane of ezFrustum::SetFrustum()
+  if (depthRange == ezClipSpaceDepthRange::ZeroToOne)
+    m_vClipSpaceNearPlane.Set(0, 0, -1, 0);
+  else
+    m_vClipSpaceNearPlane.Set(0, 0, -1, -1);
+
+  for (ezUInt32 row = 0; row < 4; ++row)
+  {
+    for (ezUInt32 column = 0; column < 4; ++column)
+    {
+      m_ViewProjection[row][column] = ezSimdVec4f(mViewProjection.Element(column, row));
+    }
+
+    m_NearPlane[row] = ezSimdVec4f(m_vClipSpaceNearPlane.GetData()[row]);
+  }
+
+  const float fFar = ezMath::MaxValue<float>();
+  for (float& fDepth : m_Depth)
+  {
+    fDepth = fFar;
+  }
+
+  for (float& fDepth : m_TileMaxDepth)
+  {
+    fDepth = fFar;
+  }
+
+  for (auto& triangles : m_TileRowTriangles)
+  {
+    triangles.Clear();
+  }
+
+  m_Triangles.Clear();
+  m_uiNumOccluders = 0;
+}
+
+void ezRasterizerView::AddObject(const ezRasterizerObject* pObject, const ezTransform& transform)
+{
+  ++m_uiNumOccluders;
+
+  const ezMat4 mModelViewProjection = m_mViewProjection * transform.GetAsMat4();
+  const ezArrayPtr<const ezVec3> positions = pObject->GetTriangles();
+
+  for (ezUInt32 i = 0; i + 2 < positions.GetCount(); i += 3)
+  {
+    ezVec4 clipPositions[3];
+    for (ezUInt32 v = 0; v < 3; ++v)
+    {
+      clipPositions[v] = mModelViewProjection * positions[i + v].GetAsVec4(1.0f);
+    }
+
+    AddTriangle(clipPositions);
+  }
+}
+
+void ezRasterizerView::EndScene()
+{
+  if (m_Triangles.IsEmpty())
+    return;
+
+  // every task owns whole tile rows, so no synchronization is needed
+  ezTaskSystem::ParallelForIndexed(0, m_uiNumTilesY, [this](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+    for (ezUInt32 uiTileY = uiStartIndex; uiTileY < uiEndIndex; ++uiTileY)
+    {
+      RasterizeTileRow(uiTileY);
+    }
+  },
+    "RasterizeOccluders");
+}
+
+bool ezRasterizerView::IsVisible(const ezSimdBBox& box) const
+{
+  if (m_Triangles.IsEmpty())
+    return true;
+
+  float vMin[4];
+  float vMax[4];
+  box.m_Min.Store<4>(vMin);
+  box.m_Max.Store<4>(vMax);
+
+  // the eight corners, four at a time
+  const ezSimdVec4f cornerX(vMin[0], vMax[0], vMin[0], vMax[0]);
+  const ezSimdVec4f cornerY(vMin[1], vMin[1], vMax[1], vMax[1]);
+  const ezSimdVec4f cornerZ[2] = {ezSimdVec4f(vMin[2]), ezSimdVec4f(vMax[2])};
+
+  const ezSimdVec4f halfResX(m_uiResolutionX * 0.5f);
+  const ezSimdVec4f halfResY(m_uiResolutionY * 0.5f);
+
+  ezSimdVec4f screenMin(ezMath::MaxValue<float>());
+  ezSimdVec4f screenMax(-ezMath::MaxValue<float>());
+  ezSimdVec4f minDepth(ezMath::MaxValue<float>());
+  ezSimdVec4b allBeforeNear(true);
+  ezSimdVec4b anyBeforeNear(false);
+
+  for (ezUInt32 i = 0; i < 2; ++i)
+  {
+    ezSimdVec4f clip[4];
+    for (ezUInt32 row = 0; row < 4; ++row)
+    {
+      clip[row] = ezSimdVec4f::MulAdd(cornerX, m_ViewProjection[row][0], m_ViewProjection[row][3]);
+      clip[row] = ezSimdVec4f::MulAdd(cornerY, m_ViewProjection[row][1], clip[row]);
+      clip[row] = ezSimdVec4f::MulAdd(cornerZ[i], m_ViewProjection[row][2], clip[row]);
+    }
+
+    ezSimdVec4f nearDist = clip[0].CompMul(m_NearPlane[0]);
+    nearDist = ezSimdVec4f::MulAdd(clip[1], m_NearPlane[1], nearDist);
+    nearDist = ezSimdVec4f::MulAdd(clip[2], m_NearPlane[2], nearDist);
+    nearDist = ezSimdVec4f::MulAdd(clip[3], m_NearPlane[3], nearDist);
+
+    const ezSimdVec4b beforeNear = nearDist > ezSimdVec4f::ZeroVector();
+    allBeforeNear = allBeforeNear && beforeNear;
+    anyBeforeNear = anyBeforeNear || beforeNear;
+
+    const ezSimdVec4f invW = clip[3].GetReciprocal();
+    const ezSimdVec4f x = ezSimdVec4f::MulAdd(clip[0].CompMul(invW), halfResX, halfResX);
+    const ezSimdVec4f y = halfResY - clip[1].CompMul(invW).CompMul(halfResY);
+    const ezSimdVec4f z = clip[2].CompMul(invW);
+
+    screenMin = screenMin.CompMin(ezSimdVec4f(x.HorizontalMin<4>(), y.HorizontalMin<4>(), 0, 0));
+    screenMax = screenMax.CompMax(ezSimdVec4f(x.HorizontalMax<4>(), y.HorizontalMax<4>(), 0, 0));
+    minDepth = minDepth.CompMin(z);
+  }
+
+  // boxes that are completely in front of the near plane are not in view,
+  // boxes that reach past it can't be projected and are treated as visible
+  if (allBeforeNear.AllSet())
+    return false;
+
+  if (anyBeforeNear.AnySet())
+    return true;
+
+  const float fMinX = screenMin.x();
+  const float fMinY = screenMin.y();
+  const float fMaxX = screenMax.x();
+  const float fMaxY = screenMax.y();
+
+  if (fMaxX < 0.0f || fMaxY < 0.0f || fMinX >= m_uiResolutionX || fMinY >= m_uiResolutionY)
+    return false;
+
+  // all pixels that the rectangle touches
+  const ezUInt32 uiMinX = static_cast<ezUInt32>(ezMath::Max(fMinX, 0.0f));
+  const ezUInt32 uiMinY = static_cast<ezUInt32>(ezMath::Max(fMinY, 0.0f));
+  const ezUInt32 uiMaxX = static_cast<ezUInt32>(ezMath::Min(fMaxX, m_uiResolutionX - 1.0f));
+  const ezUInt32 uiMaxY = static_cast<ezUInt32>(ezMath::Min(fMaxY, m_uiResolutionY - 1.0f));
+
+  const float fMinDepth = minDepth.HorizontalMin<4>();
+  const ezSimdVec4f objectDepth(fMinDepth);
+
+  const ezSimdVec4f rangeMin(static_cast<float>(uiMinX));
+  const ezSimdVec4f rangeMax(static_cast<float>(uiMaxX));
+
+  for (ezUInt32 uiTileY = uiMinY / TileSize; uiTileY <= uiMaxY / TileSize; ++uiTileY)
+  {
+    const ezUInt32 uiTileMinY = uiTileY * TileSize;
+    const ezUInt32 uiFirstRow = ezMath::Max(uiMinY, uiTileMinY) - uiTileMinY;
+    const ezUInt32 uiLastRow = ezMath::Min(uiMaxY, uiTileMinY + TileSize - 1) - uiTileMinY;
+
+    for (ezUInt32 uiTileX = uiMinX / TileSize; uiTileX <= uiMaxX / TileSize; ++uiTileX)
+    {
+      const ezUInt32 uiTileIndex = uiTileY * m_uiNumTilesX + uiTileX;
+
+      // every pixel of the tile is closer than the box
+      if (m_TileMaxDepth[uiTileIndex] < fMinDepth)
+        continue;
+
+      const ezUInt32 uiTileMinX = uiTileX * TileSize;
+
+      // the farthest pixel of the tile is inside the rectangle and not closer than the box
+      if (uiMinX <= uiTileMinX && uiTileMinX + TileSize - 1 <= uiMaxX && uiFirstRow == 0 && uiLastRow == TileSize - 1)
+        return true;
+
+      const ezSimdVec4f column0 = ezSimdVec4f(static_cast<float>(uiTileMinX)) + ezSimdVec4f(0, 1, 2, 3);
+      const ezSimdVec4f column1 = column0 + ezSimdVec4f(4.0f);
+      const ezSimdVec4b inRange0 = (column0 >= rangeMin) && (column0 <= rangeMax);
+      const ezSimdVec4b inRange1 = (column1 >= rangeMin) && (column1 <= rangeMax);
+
+      const float* pDepth = m_Depth.GetData() + uiTileIndex * PixelsPerTile;
+
+      for (ezUInt32 uiRow = uiFirstRow; uiRow <= uiLastRow; ++uiRow)
+      {
+        ezSimdVec4f depth0, depth1;
+        depth0.Load<4>(pDepth + uiRow * TileSize);
+        depth1.Load<4>(pDepth + uiRow * TileSize + 4);
+
+        if ((inRange0 && (depth0 >= objectDepth)).AnySet() || (inRange1 && (depth1 >= objectDepth)).AnySet())
+          return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+float ezRasterizerView::GetDepth(ezUInt32 x, ezUInt32 y) const
+{
+  const ezUInt32 uiTileIndex = (y / TileSize) * m_uiNumTilesX + (x / TileSize);
+  return m_Depth[uiTileIndex * PixelsPerTile + (y % TileSize) * TileSize + (x % TileSize)];
+}
+
+void ezRasterizerView::AddTriangle(const ezVec4* pClipPositions)
+{
+  float fDist[3];
+  ezUInt32 uiNumOutside = 0;
+
+  for (ezUInt32 i = 0; i < 3; ++i)
+  {
+    fDist[i] = m_vClipSpaceNearPlane.Dot(pClipPositions[i]);
+    uiNumOutside += (fDist[i] > 0.0f) ? 1 : 0;
+  }
+
+  if (uiNumOutside == 3)
+    return;
+
+  if (uiNumOutside == 0)
+  {
+    SetupTriangle(pClipPositions[0], pClipPositions[1], pClipPositions[2]);
+    return;
+  }
+
+  // clipping against one plane turns the triangle into a triangle or a quad
+  ezVec4 polygon[4];
+  ezUInt32 uiNumVertices = 0;
+
+  for (ezUInt32 i = 0; i < 3; ++i)
+  {
+    const ezUInt32 j = (i + 1) % 3;
+
+    if (fDist[i] <= 0.0f)
+    {
+      polygon[uiNumVertices++] = pClipPositions[i];
+    }
+
+    if ((fDist[i] > 0.0f) != (fDist[j] > 0.0f))
+    {
+      const float t = fDist[i] / (fDist[i] - fDist[j]);
+      polygon[uiNumVertices++] = pClipPositions[i] + (pClipPositions[j] - pClipPositions[i]) * t;
+    }
+  }
+
+  SetupTriangle(polygon[0], polygon[1], polygon[2]);
+
+  if (uiNumVertices == 4)
+  {
+    SetupTriangle(polygon[0], polygon[2], polygon[3]);
+  }
+}
+
+void ezRasterizerView::SetupTriangle(const ezVec4& vClip0, const ezVec4& vClip1, const ezVec4& vClip2)
+{
+  const ezVec4* pClip[3] = {&vClip0, &vClip1, &vClip2};
+
+  // screen space, with the origin at the top left corner
+  float x[3], y[3], z[3];
+  for (ezUInt32 i = 0; i < 3; ++i)
+  {
+    const float fInvW = 1.0f / pClip[i]->w;
+    x[i] = (pClip[i]->x * fInvW * 0.5f + 0.5f) * m_uiResolutionX;
+    y[i] = (0.5f - pClip[i]->y * fInvW * 0.5f) * m_uiResolutionY;
+    z[i] = pClip[i]->z * fInvW;
+  }
+
+  const float fMinX = ezMath::Min(x[0], x[1], x[2]);
+  const float fMaxX = ezMath::Max(x[0], x[1], x[2]);
+  const float fMinY = ezMath::Min(y[0], y[1], y[2]);
+  const float fMaxY = ezMath::Max(y[0], y[1], y[2]);
+
+  if (fMaxX < 0.0f || fMaxY < 0.0f || fMinX >= m_uiResolutionX || fMinY >= m_uiResolutionY)
+    return;
+
+  float fArea = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+
+  // no pixel centers can be covered by degenerate triangles
+  if (ezMath::Abs(fArea) < 1e-6f)
+    return;
+
+  // double-sided: flip the edge functions of back-facing triangles, so that they are always positive inside
+  const float fSign = fArea < 0.0f ? -1.0f : 1.0f;
+
+  Triangle& tri = m_Triangles.ExpandAndGetRef();
+
+  for (ezUInt32 i = 0; i < 3; ++i)
+  {
+    const ezUInt32 j = (i + 1) % 3;
+    tri.m_EdgeA[i] = (y[i] - y[j]) * fSign;
+    tri.m_EdgeB[i] = (x[j] - x[i]) * fSign;
+    tri.m_EdgeC[i] = (x[i] * y[j] - x[j] * y[i]) * fSign;
+  }
+
+  // the depth is linear in screen space, store the farthest value within each pixel
+  const float fInvArea = 1.0f / fArea;
+  tri.m_DepthA = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) * fInvArea;
+  tri.m_DepthB = ((x[1] - x[0]) * (z[2] - z[0]) - (x[2] - x[0]) * (z[1] - z[0])) * fInvArea;
+  tri.m_DepthC = z[0] - tri.m_DepthA * x[0] - tri.m_DepthB * y[0] + 0.5f * (ezMath::Abs(tri.m_DepthA) + ezMath::Abs(tri.m_DepthB));
+  tri.m_fMinDepth = ezMath::Min(z[0], z[1], z[2]);
+
+  const ezUInt32 uiMaxTileX = m_uiNumTilesX - 1;
+  const ezUInt32 uiMaxTileY = m_uiNumTilesY - 1;
+  tri.m_uiMinTileX = static_cast<ezUInt16>(ezMath::Min(static_cast<ezUInt32>(ezMath::Max(fMinX, 0.0f)) / TileSize, uiMaxTileX));
+  tri.m_uiMaxTileX = static_cast<ezUInt16>(ezMath::Min(static_cast<ezUInt32>(ezMath::Min(fMaxX, m_uiResolutionX - 1.0f)) / TileSize, uiMaxTileX));
+
+  const ezUInt32 uiMinTileY = ezMath::Min(static_cast<ezUInt32>(ezMath::Max(fMinY, 0.0f)) / TileSize, uiMaxTileY);
+  const ezUInt32 uiLastTileY = ezMath::Min(static_cast<ezUInt32>(ezMath::Min(fMaxY, m_uiResolutionY - 1.0f)) / TileSize, uiMaxTileY);
+
+  const ezUInt32 uiTriangleIndex = m_Triangles.GetCount() - 1;
+  for (ezUInt32 uiTileY = uiMinTileY; uiTileY <= uiLastTileY; ++uiTileY)
+  {
+    m_TileRowTriangles[uiTileY].PushBack(uiTriangleIndex);
+  }
+}
+
+void ezRasterizerView::RasterizeTileRow(ezUInt32 uiTileY)
+{
+  ezDynamicArray<ezUInt32>& triangles = m_TileRowTriangles[uiTileY];
+
+  // front to back, so that hidden triangles are rejected per tile before any pixels are touched
+  triangles.Sort([this](ezUInt32 a, ezUInt32 b) { return m_Triangles[a].m_fMinDepth < m_Triangles[b].m_fMinDepth; });
+
+  for (ezUInt32 uiTriangleIndex : triangles)
+  {
+    const Triangle& tri = m_Triangles[uiTriangleIndex];
+
+    for (ezUInt32 uiTileX = tri.m_uiMinTileX; uiTileX <= tri.m_uiMaxTileX; ++uiTileX)
+    {
+      RasterizeTriangle(tri, uiTileX, uiTileY);
+    }
+  }
+}
+
+void ezRasterizerView::RasterizeTriangle(const Triangle& tri, ezUInt32 uiTileX, ezUInt32 uiTileY)
+{
+  const ezUInt32 uiTileIndex = uiTileY * m_uiNumTilesX + uiTileX;
+
+  // the triangle can't get any closer than what is already stored
+  if (tri.m_fMinDepth >= m_TileMaxDepth[uiTileIndex])
+    return;
+
+  // the triangle doesn't cover any pixel center of the tile, if one edge function is negative for all of them
+  const float fFirstX = uiTileX * TileSize + 0.5f;
+  const float fFirstY = uiTileY * TileSize + 0.5f;
+  const float fLastOffset = TileSize - 1.0f;
+  for (ezUInt32 i = 0; i < 3; ++i)
+  {
+    const float fMaxEdge = tri.m_EdgeA[i] * fFirstX + tri.m_EdgeB[i] * fFirstY + tri.m_EdgeC[i] +
+                           (ezMath::Max(tri.m_EdgeA[i], 0.0f) + ezMath::Max(tri.m_EdgeB[i], 0.0f)) * fLastOffset;
+
+    if (fMaxEdge <= 0.0f)
+      return;
+  }
+
+  const ezSimdVec4f zero = ezSimdVec4f::ZeroVector();
+
+  // pixel centers of the left and right half of a row
+  const ezSimdVec4f x0 = ezSimdVec4f(static_cast<float>(uiTileX * TileSize)) + ezSimdVec4f(0.5f, 1.5f, 2.5f, 3.5f);
+  const ezSimdVec4f x1 = x0 + ezSimdVec4f(4.0f);
+
+  ezSimdVec4f edgeX0[3], edgeX1[3], edgeB[3];
+  for (ezUInt32 i = 0; i < 3; ++i)
+  {
+    const ezSimdVec4f a(tri.m_EdgeA[i]);
+    const ezSimdVec4f c(tri.m_EdgeC[i]);
+    edgeX0[i] = ezSimdVec4f::MulAdd(x0, a, c);
+    edgeX1[i] = ezSimdVec4f::MulAdd(x1, a, c);
+    edgeB[i] = ezSimdVec4f(tri.m_EdgeB[i]);
+  }
+
+  const ezSimdVec4f depthA(tri.m_DepthA);
+  const ezSimdVec4f depthC(tri.m_DepthC);
+  const ezSimdVec4f depthX0 = ezSimdVec4f::MulAdd(x0, depthA, depthC);
+  const ezSimdVec4f depthX1 = ezSimdVec4f::MulAdd(x1, depthA, depthC);
+  const ezSimdVec4f depthB(tri.m_DepthB);
+
+  float* pDepth = m_Depth.GetData() + uiTileIndex * PixelsPerTile;
+  ezSimdVec4f maxDepth(-ezMath::MaxValue<float>());
+
+  for (ezUInt32 uiRow = 0; uiRow < TileSize; ++uiRow, pDepth += TileSize)
+  {
+    const ezSimdVec4f y(uiTileY * TileSize + uiRow + 0.5f);
+
+    ezSimdVec4b inside0(true);
+    ezSimdVec4b inside1(true);
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      inside0 = inside0 && (ezSimdVec4f::MulAdd(y, edgeB[i], edgeX0[i]) > zero);
+      inside1 = inside1 && (ezSimdVec4f::MulAdd(y, edgeB[i], edgeX1[i]) > zero);
+    }
+
+    ezSimdVec4f depth0, depth1;
+    depth0.Load<4>(pDepth);
+    depth1.Load<4>(pDepth + 4);
+
+    depth0 = ezSimdVec4f::Select(inside0, depth0.CompMin(ezSimdVec4f::MulAdd(y, depthB, depthX0)), depth0);
+    depth1 = ezSimdVec4f::Select(inside1, depth1.CompMin(ezSimdVec4f::MulAdd(y, depthB, depthX1)), depth1);
+
+    depth0.Store<4>(pDepth);
+    depth1.Store<4>(pDepth + 4);
+
+    maxDepth = maxDepth.CompMax(depth0.CompMax(depth1));
+  }
+
+  m_TileMaxDepth[uiTileIndex] = maxDepth.HorizontalMax<4>();
+}
+
+
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_Rasterizer_Implementation_RasterizerView);
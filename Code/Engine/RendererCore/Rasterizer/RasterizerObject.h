@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Math/BoundingBox.h>
+#include <Foundation/Types/RefCounted.h>
+#include <Foundation/Types/SharedPtr.h>
+#include <RendererCore/RendererCoreDLL.h>
+
+struct ezMeshResourceDescriptor;
+
+/// \brief The geometry of an occluder, which ezRasterizerView renders into its depth buffer.
+///
+/// Occluders should be simple and convex-ish, e.g. a box inside a building or a low-poly version of a wall.
+/// They must never be larger than the rendered geometry that they stand for, otherwise visible objects get culled.
+class EZ_RENDERERCORE_DLL ezRasterizerObject : public ezRefCounted
+{
+public:
+  ezRasterizerObject();
+  ~ezRasterizerObject();
+
+  /// \brief Returns a box occluder with the given full extents, centered around the origin.
+  static ezSharedPtr<ezRasterizerObject> CreateBox(const ezVec3& vFullExtents);
+
+  /// \brief Creates an occluder from the indexed triangle list of a CPU mesh. Returns nullptr if the mesh has no usable triangles.
+  static ezSharedPtr<ezRasterizerObject> CreateMesh(const ezMeshResourceDescriptor& desc);
+
+  /// \brief Returns the occluder for the given CPU mesh resource. Loads the mesh if necessary and caches the result by name.
+  ///
+  /// Returns nullptr if the mesh could not be loaded.
+  static ezSharedPtr<ezRasterizerObject> GetObject(const char* szCpuMeshResource);
+
+  /// \brief Drops all cached mesh occluders. Occluders that are still in use stay alive until they are released.
+  static void ClearCache();
+
+  /// \brief Three positions per triangle, in object space.
+  ezArrayPtr<const ezVec3> GetTriangles() const { return m_Triangles; }
+
+  ezUInt32 GetTriangleCount() const { return m_Triangles.GetCount() / 3; }
+  const ezBoundingBox& GetBounds() const { return m_Bounds; }
+
+private:
+  ezDynamicArray<ezVec3> m_Triangles;
+  ezBoundingBox m_Bounds;
+};
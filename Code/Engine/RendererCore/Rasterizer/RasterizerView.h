@@ -0,0 +1,95 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Math/Mat4.h>
+#include <Foundation/Memory/AllocatorWrapper.h>
+#include <Foundation/SimdMath/SimdBBox.h>
+#include <RendererCore/RendererCoreDLL.h>
+
+class ezRasterizerObject;
+
+/// \brief Rasterizes occluders into a small software depth buffer, against which bounding boxes can then be tested for visibility.
+///
+/// The depth buffer is split into tiles of 8x8 pixels. Every tile additionally stores the farthest depth of its pixels, so most boxes
+/// are accepted or rejected without looking at individual pixels. The tile rows are rasterized in parallel, using ezSimdVec4f for four
+/// pixels at a time.
+///
+/// The test is conservative at the resolution of the depth buffer: occluders only cover a pixel if they cover its center, and store the
+/// farthest depth they have inside of it, while a box is tested against all pixels that it touches. Gaps between occluders that are
+/// smaller than a pixel are treated as closed. Occluders are rendered double-sided.
+///
+/// Usage per frame: BeginScene(), AddObject() for every occluder, EndScene(), then IsVisible() from any number of threads.
+class EZ_RENDERERCORE_DLL ezRasterizerView
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezRasterizerView);
+
+public:
+  ezRasterizerView();
+  ~ezRasterizerView();
+
+  /// \brief Sets the size of the depth buffer. Both values are rounded up to multiples of 8. The default is 256x128.
+  void SetResolution(ezUInt32 uiWidth, ezUInt32 uiHeight);
+  ezUInt32 GetResolutionX() const { return m_uiResolutionX; }
+  ezUInt32 GetResolutionY() const { return m_uiResolutionY; }
+
+  /// \brief Clears the depth buffer and sets up the view. Perspective and orthographic projections are supported.
+  void BeginScene(const ezMat4& mViewProjection, ezClipSpaceDepthRange::Enum depthRange = ezClipSpaceDepthRange::Default);
+
+  /// \brief Clips the triangles of the occluder against the near plane and bins them into the tile rows that they overlap.
+  void AddObject(const ezRasterizerObject* pObject, const ezTransform& transform);
+
+  /// \brief Rasterizes all added occluders.
+  void EndScene();
+
+  /// \brief Returns false if the box is completely hidden behind the occluders, or outside of the view.
+  bool IsVisible(const ezSimdBBox& box) const;
+
+  /// \brief Returns the depth of one pixel, with 0 at the top left. Smaller values are closer to the camera. For tests and debugging.
+  float GetDepth(ezUInt32 x, ezUInt32 y) const;
+
+  /// \brief The number of occluders that were added since the last BeginScene().
+  ezUInt32 GetNumOccluders() const { return m_uiNumOccluders; }
+
+  /// \brief The number of triangles that were binned since the last BeginScene(), after clipping.
+  ezUInt32 GetNumTriangles() const { return m_Triangles.GetCount(); }
+
+private:
+  struct Triangle
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    // edge functions are positive inside, the depth plane already contains the conservative bias
+    float m_EdgeA[3];
+    float m_EdgeB[3];
+    float m_EdgeC[3];
+    float m_DepthA;
+    float m_DepthB;
+    float m_DepthC;
+    float m_fMinDepth;
+    ezUInt16 m_uiMinTileX;
+    ezUInt16 m_uiMaxTileX;
+  };
+
+  void AddTriangle(const ezVec4* pClipPositions);
+  void SetupTriangle(const ezVec4& vClip0, const ezVec4& vClip1, const ezVec4& vClip2);
+  void RasterizeTileRow(ezUInt32 uiTileY);
+  void RasterizeTriangle(const Triangle& tri, ezUInt32 uiTileX, ezUInt32 uiTileY);
+
+  ezUInt32 m_uiResolutionX = 0;
+  ezUInt32 m_uiResolutionY = 0;
+  ezUInt32 m_uiNumTilesX = 0;
+  ezUInt32 m_uiNumTilesY = 0;
+  ezUInt32 m_uiNumOccluders = 0;
+
+  ezMat4 m_mViewProjection;
+  ezVec4 m_vClipSpaceNearPlane; ///< Positive in front of the near plane, where nothing is rendered.
+
+  ezSimdVec4f m_ViewProjection[4][4]; ///< Every element of m_mViewProjection broadcast into a vector, for testing boxes.
+  ezSimdVec4f m_NearPlane[4];
+
+  ezDynamicArray<float, ezAlignedAllocatorWrapper> m_Depth; ///< 64 consecutive values per tile, row by row.
+  ezDynamicArray<float> m_TileMaxDepth;
+
+  ezDynamicArray<Triangle> m_Triangles;
+  ezDynamicArray<ezDynamicArray<ezUInt32>> m_TileRowTriangles;
+};
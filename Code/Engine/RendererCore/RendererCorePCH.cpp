@@ -7,10 +7,12 @@ EZ_STATICLINK_LIBRARY(RendererCore)
 
   EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_AnimationGraph_Implementation_AnimationClipSampler);
   EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_AnimationGraph_Implementation_AnimationGraphNode);
+  EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_Implementation_AnimationClipCompression);
   EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_Implementation_AnimationClipResource);
   EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_Implementation_AnimationPose);
   EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_Implementation_EditableSkeleton);
   EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_Implementation_JointMapping);
+  EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_Implementation_LocalAnimationPose);
   EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_Implementation_Skeleton);
   EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_Implementation_SkeletonBuilder);
   EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_Implementation_SkeletonResource);
@@ -18,6 +20,7 @@ EZ_STATICLINK_LIBRARY(RendererCore)
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_AlwaysVisibleComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_CameraComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_FogComponent);
+  EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_OccluderComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_RenderComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_RenderTargetActivatorComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_SkyBoxComponent);
@@ -46,8 +49,10 @@ EZ_STATICLINK_LIBRARY(RendererCore)
   EZ_STATICLINK_REFERENCE(RendererCore_Meshes_Implementation_CpuMeshResource);
   EZ_STATICLINK_REFERENCE(RendererCore_Meshes_Implementation_InstancedMeshComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Meshes_Implementation_MeshBufferResource);
+  EZ_STATICLINK_REFERENCE(RendererCore_Meshes_Implementation_MeshClusterCulling);
   EZ_STATICLINK_REFERENCE(RendererCore_Meshes_Implementation_MeshComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Meshes_Implementation_MeshComponentBase);
+  EZ_STATICLINK_REFERENCE(RendererCore_Meshes_Implementation_MeshOptimizer);
   EZ_STATICLINK_REFERENCE(RendererCore_Meshes_Implementation_MeshRenderer);
   EZ_STATICLINK_REFERENCE(RendererCore_Meshes_Implementation_MeshResource);
   EZ_STATICLINK_REFERENCE(RendererCore_Meshes_Implementation_MeshResourceDescriptor);
@@ -86,6 +91,8 @@ EZ_STATICLINK_LIBRARY(RendererCore)
   EZ_STATICLINK_REFERENCE(RendererCore_Pipeline_Implementation_SortingFunctions);
   EZ_STATICLINK_REFERENCE(RendererCore_Pipeline_Implementation_View);
   EZ_STATICLINK_REFERENCE(RendererCore_Pipeline_Implementation_ViewRenderMode);
+  EZ_STATICLINK_REFERENCE(RendererCore_Rasterizer_Implementation_RasterizerObject);
+  EZ_STATICLINK_REFERENCE(RendererCore_Rasterizer_Implementation_RasterizerView);
   EZ_STATICLINK_REFERENCE(RendererCore_RenderContext_Implementation_RenderContext);
   EZ_STATICLINK_REFERENCE(RendererCore_RenderWorld_Implementation_RenderWorld);
   EZ_STATICLINK_REFERENCE(RendererCore_ShaderCompiler_Implementation_PermutationGenerator);
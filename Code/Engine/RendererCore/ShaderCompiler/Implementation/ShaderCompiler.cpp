@@ -3,6 +3,8 @@
 #include <Foundation/IO/FileSystem/DeferredFileWriter.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/OSFile.h>
+#include <Foundation/Logging/LogEntry.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <RendererCore/ShaderCompiler/ShaderCompiler.h>
 #include <RendererCore/ShaderCompiler/ShaderManager.h>
 #include <RendererCore/ShaderCompiler/ShaderParser.h>
@@ -95,8 +97,57 @@ namespace
 
   static const char* s_szStageDefines[ezGALShaderStage::ENUM_COUNT] = {"VERTEX_SHADER", "HULL_SHADER", "DOMAIN_SHADER",
     "GEOMETRY_SHADER", "PIXEL_SHADER", "COMPUTE_SHADER"};
+
+  // the preprocessed sources of all permutations in flight are kept in memory, so only this many are processed at once
+  static constexpr ezUInt32 s_uiMaxPermutationsInFlight = 256;
+
+  static void ForwardLogEntries(ezDynamicArray<ezLogEntry>& entries, ezLogInterface* pLog)
+  {
+    if (pLog != nullptr)
+    {
+      ezStringBuilder sMsg;
+
+      for (const ezLogEntry& entry : entries)
+      {
+        // log blocks are not forwarded, all messages end up in the current block of pLog
+        const ezLogMsgType::Enum type = entry.m_Type;
+        if (type <= ezLogMsgType::None || type > pLog->GetLogLevel())
+          continue;
+
+        if (entry.m_sTag.IsEmpty())
+          sMsg = entry.m_sMsg;
+        else
+          sMsg.Set("[", entry.m_sTag, "]", entry.m_sMsg);
+
+        ezLog::BroadcastLoggingEvent(pLog, type, sMsg);
+      }
+    }
+
+    entries.Clear();
+  }
 } // namespace
 
+struct ezShaderCompiler::PermutationData
+{
+  ezHybridArray<ezPermutationVar, 16>* m_pPermutationVars = nullptr;
+  ezHybridArray<ezString, 32> m_Defines;
+
+  ezShaderProgramCompiler::ezShaderProgramData m_ProgramData;
+  ezShaderPermutationBinary m_PermutationBinary;
+
+  ezStringBuilder m_sStateSource;
+  ezStringBuilder m_sProcessed[ezGALShaderStage::ENUM_COUNT];
+  ezSet<ezString> m_IncludeFiles;
+
+  /// Stages whose source is identical to a stage of an earlier permutation, the binary of that one is used.
+  bool m_bDeduplicated[ezGALShaderStage::ENUM_COUNT] = {};
+  bool m_bCompile = false;
+  ezResult m_Result = EZ_SUCCESS;
+
+  /// Messages that were logged on a worker thread, these are forwarded in the order of the permutations.
+  ezDynamicArray<ezLogEntry> m_LogEntries;
+};
+
 ezResult ezShaderCompiler::FileOpen(const char* szAbsoluteFile, ezDynamicArray<ezUInt8>& FileContent, ezTimestamp& out_FileModification)
 {
   if (ezStringUtils::IsEqual(szAbsoluteFile, "ShaderRenderState"))
@@ -134,8 +185,6 @@ ezResult ezShaderCompiler::FileOpen(const char* szAbsoluteFile, ezDynamicArray<e
     }
   }
 
-  m_IncludeFiles.Insert(szAbsoluteFile);
-
   ezFileReader r;
   if (r.Open(szAbsoluteFile).Failed())
   {
@@ -164,6 +213,36 @@ ezResult ezShaderCompiler::FileOpen(const char* szAbsoluteFile, ezDynamicArray<e
 ezResult ezShaderCompiler::CompileShaderPermutationForPlatforms(const char* szFile,
   const ezArrayPtr<const ezPermutationVar>& permutationVars,
   ezLogInterface* pLog, const char* szPlatform)
+{
+  if (ReadShaderFile(szFile).Failed())
+    return EZ_FAILURE;
+
+  m_Permutations.SetCount(1);
+  SelectPermutationVars(permutationVars, m_Permutations[0]);
+
+  return RunShaderCompilers(szFile, szPlatform, pLog);
+}
+
+ezResult ezShaderCompiler::CompileShaderPermutationsForPlatforms(const char* szFile, const ezPermutationGenerator& permutations,
+  ezLogInterface* pLog, const char* szPlatform)
+{
+  if (ReadShaderFile(szFile).Failed())
+    return EZ_FAILURE;
+
+  const ezUInt32 uiNumPermutations = permutations.GetPermutationCount();
+  m_Permutations.SetCount(uiNumPermutations);
+
+  ezHybridArray<ezPermutationVar, 16> permutationVars;
+  for (ezUInt32 i = 0; i < uiNumPermutations; ++i)
+  {
+    permutations.GetPermutation(i, permutationVars);
+    SelectPermutationVars(permutationVars, m_Permutations[i]);
+  }
+
+  return RunShaderCompilers(szFile, szPlatform, pLog);
+}
+
+ezResult ezShaderCompiler::ReadShaderFile(const char* szFile)
 {
   ezStringBuilder sFileContent, sTemp;
 
@@ -184,35 +263,10 @@ ezResult ezShaderCompiler::CompileShaderPermutationForPlatforms(const char* szFi
 
   m_ShaderData.m_Platforms = sTemp;
 
-  ezHybridArray<ezHashedString, 16> usedPermutations;
+  m_ShaderData.m_UsedPermutationVars.Clear();
+  m_ShaderData.m_FixedPermVars.Clear();
   ezShaderParser::ParsePermutationSection(Sections.GetSectionContent(ezShaderHelper::ezShaderSections::PERMUTATIONS, uiFirstLine),
-    usedPermutations, m_ShaderData.m_FixedPermVars);
-
-  for (const ezHashedString& usedPermutationVar : usedPermutations)
-  {
-    ezUInt32 uiIndex = ezInvalidIndex;
-    for (ezUInt32 i = 0; i < permutationVars.GetCount(); ++i)
-    {
-      if (permutationVars[i].m_sName == usedPermutationVar)
-      {
-        uiIndex = i;
-        break;
-      }
-    }
-
-    if (uiIndex != ezInvalidIndex)
-    {
-      m_ShaderData.m_Permutations.PushBack(permutationVars[uiIndex]);
-    }
-    else
-    {
-      ezLog::Error("No value given for permutation var '{0}'. Assuming default value of zero.", usedPermutationVar);
-
-      ezPermutationVar& finalVar = m_ShaderData.m_Permutations.ExpandAndGetRef();
-      finalVar.m_sName = usedPermutationVar;
-      finalVar.m_sValue.Assign("0");
-    }
-  }
+    m_ShaderData.m_UsedPermutationVars, m_ShaderData.m_FixedPermVars);
 
   m_ShaderData.m_StateSource = Sections.GetSectionContent(ezShaderHelper::ezShaderSections::RENDERSTATE, uiFirstLine);
 
@@ -265,6 +319,43 @@ ezResult ezShaderCompiler::CompileShaderPermutationForPlatforms(const char* szFi
   m_StageSourceFile[ezGALShaderStage::ComputeShader] = tmp;
   m_StageSourceFile[ezGALShaderStage::ComputeShader].ChangeFileExtension("cs");
 
+  return EZ_SUCCESS;
+}
+
+void ezShaderCompiler::SelectPermutationVars(const ezArrayPtr<const ezPermutationVar>& permutationVars,
+  ezHybridArray<ezPermutationVar, 16>& out_PermutationVars)
+{
+  out_PermutationVars.Clear();
+
+  for (const ezHashedString& usedPermutationVar : m_ShaderData.m_UsedPermutationVars)
+  {
+    ezUInt32 uiIndex = ezInvalidIndex;
+    for (ezUInt32 i = 0; i < permutationVars.GetCount(); ++i)
+    {
+      if (permutationVars[i].m_sName == usedPermutationVar)
+      {
+        uiIndex = i;
+        break;
+      }
+    }
+
+    if (uiIndex != ezInvalidIndex)
+    {
+      out_PermutationVars.PushBack(permutationVars[uiIndex]);
+    }
+    else
+    {
+      ezLog::Error("No value given for permutation var '{0}'. Assuming default value of zero.", usedPermutationVar);
+
+      ezPermutationVar& finalVar = out_PermutationVars.ExpandAndGetRef();
+      finalVar.m_sName = usedPermutationVar;
+      finalVar.m_sValue.Assign("0");
+    }
+  }
+}
+
+ezResult ezShaderCompiler::RunShaderCompilers(const char* szFile, const char* szPlatform, ezLogInterface* pLog)
+{
   // try out every compiler that we can find
   ezRTTI* pRtti = ezRTTI::GetFirstInstance();
   while (pRtti)
@@ -292,8 +383,6 @@ ezResult ezShaderCompiler::RunShaderCompiler(const char* szFile, const char* szP
 {
   EZ_LOG_BLOCK(pLog, "Compiling Shader", szFile);
 
-  ezStringBuilder sProcessed[ezGALShaderStage::ENUM_COUNT];
-
   ezHybridArray<ezString, 4> Platforms;
   pCompiler->GetSupportedPlatforms(Platforms);
 
@@ -308,143 +397,143 @@ ezResult ezShaderCompiler::RunShaderCompiler(const char* szFile, const char* szP
 
     EZ_LOG_BLOCK(pLog, "Platform", Platforms[p].GetData());
 
-    ezShaderProgramCompiler::ezShaderProgramData spd;
-    spd.m_szSourceFile = szFile;
-    spd.m_szPlatform = Platforms[p].GetData();
-
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
     // 'DEBUG' is a platform tag that enables additional compiler flags
     if (PlatformEnabled(m_ShaderData.m_Platforms, "DEBUG"))
     {
       ezLog::Warning("Shader specifies the 'DEBUG' platform, which enables the debug shader compiler flag.");
-      spd.m_Flags.Add(ezShaderCompilerFlags::Debug);
     }
 #endif
 
-    m_IncludeFiles.Clear();
+    // all stage binaries that were compiled for this platform, permutations with the same stage source reuse them
+    ezMap<ezUInt32, ezShaderStageBinary> compiledStages[ezGALShaderStage::ENUM_COUNT];
+
+    for (ezUInt32 uiFirstPermutation = 0; uiFirstPermutation < m_Permutations.GetCount(); uiFirstPermutation += s_uiMaxPermutationsInFlight)
+    {
+      const ezUInt32 uiNumPermutations = ezMath::Min(m_Permutations.GetCount() - uiFirstPermutation, s_uiMaxPermutationsInFlight);
+
+      if (CompilePermutations(szFile, Platforms[p].GetData(), uiFirstPermutation, uiNumPermutations, pCompiler, compiledStages, pLog).Failed())
+        return EZ_FAILURE;
+    }
+  }
 
-    ezHybridArray<ezString, 32> defines;
-    GenerateDefines(Platforms[p].GetData(), m_ShaderData.m_Permutations, defines);
-    GenerateDefines(Platforms[p].GetData(), m_ShaderData.m_FixedPermVars, defines);
+  return EZ_SUCCESS;
+}
 
-    ezShaderPermutationBinary shaderPermutationBinary;
+ezResult ezShaderCompiler::CompilePermutations(const char* szFile, const char* szPlatform, ezUInt32 uiFirstPermutation,
+  ezUInt32 uiNumPermutations, ezShaderProgramCompiler* pCompiler, ezMap<ezUInt32, ezShaderStageBinary>* pCompiledStages,
+  ezLogInterface* pLog)
+{
+  ezDynamicArray<PermutationData> permutations;
+  permutations.SetCount(uiNumPermutations);
 
-    // Generate Shader State Source
+  // the defines are generated up front, ezShaderManager::GetPermutationEnumValues is not meant to be called from multiple threads
+  for (ezUInt32 i = 0; i < uiNumPermutations; ++i)
+  {
+    PermutationData& permutation = permutations[i];
+    permutation.m_pPermutationVars = &m_Permutations[uiFirstPermutation + i];
+
+    ezShaderProgramCompiler::ezShaderProgramData& spd = permutation.m_ProgramData;
+    spd.m_szSourceFile = szFile;
+    spd.m_szPlatform = szPlatform;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    if (PlatformEnabled(m_ShaderData.m_Platforms, "DEBUG"))
     {
-      EZ_LOG_BLOCK(pLog, "Preprocessing Shader State Source");
+      spd.m_Flags.Add(ezShaderCompilerFlags::Debug);
+    }
+#endif
 
-      ezPreprocessor pp;
-      pp.SetCustomFileCache(&m_FileCache);
-      pp.SetLogInterface(ezLog::GetThreadLocalLogSystem());
-      pp.SetFileOpenFunction(ezPreprocessor::FileOpenCB(&ezShaderCompiler::FileOpen, this));
-      pp.SetPassThroughPragma(false);
-      pp.SetPassThroughLine(false);
+    GenerateDefines(szPlatform, *permutation.m_pPermutationVars, permutation.m_Defines);
+    GenerateDefines(szPlatform, m_ShaderData.m_FixedPermVars, permutation.m_Defines);
+  }
 
-      for (auto& define : defines)
-      {
-        pp.AddCustomDefine(define);
-      }
+  ezTaskSystem::ParallelForSingle(permutations.GetArrayPtr(), [this](PermutationData& permutation) { PreprocessPermutation(permutation); },
+    "Preprocess Shader Permutations");
 
-      bool bFoundUndefinedVars = false;
-      pp.m_ProcessingEvents.AddEventHandler([&bFoundUndefinedVars](const ezPreprocessor::ProcessingEvent& e) {
-        if (e.m_Type == ezPreprocessor::ProcessingEvent::EvaluateUnknown)
-        {
-          bFoundUndefinedVars = true;
+  // Look up the stage binaries that exist already. Stage sources that are identical in several permutations are only compiled by the
+  // first one, the others get the compiled binary afterwards.
+  ezHashSet<ezUInt32> stagesToCompile[ezGALShaderStage::ENUM_COUNT];
+  ezDynamicArray<PermutationData*> permutationsToCompile;
 
-          ezLog::Error("Undefined variable is evaluated: '{0}' (File: '{1}', Line: {2}", e.m_pToken->m_DataView, e.m_pToken->m_File,
-            e.m_pToken->m_uiLine);
-        }
-      });
+  for (PermutationData& permutation : permutations)
+  {
+    ForwardLogEntries(permutation.m_LogEntries, pLog);
 
-      ezStringBuilder sOutput;
-      if (pp.Process("ShaderRenderState", sOutput, false).Failed() || bFoundUndefinedVars)
-      {
-        ezLog::Error(pLog, "Preprocessing the Shader State block failed");
-        return EZ_FAILURE;
-      }
-      else
-      {
-        if (shaderPermutationBinary.m_StateDescriptor.Load(sOutput).Failed())
-        {
-          ezLog::Error(pLog, "Failed to interpret the shader state block");
-          return EZ_FAILURE;
-        }
-      }
+    if (permutation.m_Result.Failed())
+      return EZ_FAILURE;
+
+    if (permutation.m_PermutationBinary.m_StateDescriptor.Load(permutation.m_sStateSource).Failed())
+    {
+      ezLog::Error(pLog, "Failed to interpret the shader state block");
+      return EZ_FAILURE;
     }
 
+    ezShaderProgramCompiler::ezShaderProgramData& spd = permutation.m_ProgramData;
+
     for (ezUInt32 stage = ezGALShaderStage::VertexShader; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
     {
-      spd.m_StageBinary[stage].m_Stage = (ezGALShaderStage::Enum)stage;
-      spd.m_StageBinary[stage].m_uiSourceHash = 0;
+      const ezUInt32 uiSourceHash = spd.m_StageBinary[stage].m_uiSourceHash;
 
-      if (m_ShaderData.m_ShaderStageSource[stage].IsEmpty())
+      if (uiSourceHash == 0)
         continue;
 
-      bool bFoundUndefinedVars = false;
-
-      ezPreprocessor pp;
-      pp.SetCustomFileCache(&m_FileCache);
-      pp.SetLogInterface(ezLog::GetThreadLocalLogSystem());
-      pp.SetFileOpenFunction(ezPreprocessor::FileOpenCB(&ezShaderCompiler::FileOpen, this));
-      pp.SetPassThroughPragma(true);
-      pp.SetPassThroughUnknownCmdsCB(ezMakeDelegate(&ezShaderCompiler::PassThroughUnknownCommandCB, this));
-      pp.SetPassThroughLine(false);
-      pp.m_ProcessingEvents.AddEventHandler([&bFoundUndefinedVars](const ezPreprocessor::ProcessingEvent& e) {
-        if (e.m_Type == ezPreprocessor::ProcessingEvent::EvaluateUnknown)
-        {
-          bFoundUndefinedVars = true;
-
-          ezLog::Error("Undefined variable is evaluated: '{0}' (File: '{1}', Line: {2}", e.m_pToken->m_DataView, e.m_pToken->m_File,
-            e.m_pToken->m_uiLine);
-        }
-      });
-
-      pp.AddCustomDefine(s_szStageDefines[stage]);
-      for (auto& define : defines)
+      auto itCompiled = pCompiledStages[stage].Find(uiSourceHash);
+      if (itCompiled.IsValid())
       {
-        pp.AddCustomDefine(define);
+        spd.m_StageBinary[stage] = itCompiled.Value();
+        spd.m_bWriteToDisk[stage] = false;
+        continue;
       }
 
-      ezUInt32 uiSourceStringLen = 0;
-      if (pp.Process(m_StageSourceFile[stage], sProcessed[stage], true, true, true).Failed() || bFoundUndefinedVars)
+      ezShaderStageBinary* pBinary = ezShaderStageBinary::LoadStageBinary((ezGALShaderStage::Enum)stage, uiSourceHash);
+
+      if (pBinary)
       {
-        sProcessed[stage].Clear();
-        spd.m_szShaderSource[stage] = m_StageSourceFile[stage];
-        uiSourceStringLen = m_StageSourceFile[stage].GetElementCount();
+        spd.m_StageBinary[stage] = *pBinary;
+        spd.m_bWriteToDisk[stage] = pBinary->GetByteCode().IsEmpty();
 
-        ezLog::Error(pLog, "Shader preprocessing failed");
-        return EZ_FAILURE;
+        if (!spd.m_bWriteToDisk[stage])
+          continue;
       }
-      else
+
+      if (stagesToCompile[stage].Insert(uiSourceHash))
       {
-        spd.m_szShaderSource[stage] = sProcessed[stage];
-        uiSourceStringLen = sProcessed[stage].GetElementCount();
+        // an earlier permutation compiles the same source, the compiler skips stages without a source
+        spd.m_szShaderSource[stage] = nullptr;
+        spd.m_bWriteToDisk[stage] = false;
+        permutation.m_bDeduplicated[stage] = true;
       }
-
-      spd.m_StageBinary[stage].m_uiSourceHash = ezHashingUtils::xxHash32(spd.m_szShaderSource[stage], uiSourceStringLen);
-
-      if (spd.m_StageBinary[stage].m_uiSourceHash != 0)
+      else
       {
-        ezShaderStageBinary* pBinary =
-          ezShaderStageBinary::LoadStageBinary((ezGALShaderStage::Enum)stage, spd.m_StageBinary[stage].m_uiSourceHash);
-
-        if (pBinary)
-        {
-          spd.m_StageBinary[stage] = *pBinary;
-          spd.m_bWriteToDisk[stage] = pBinary->GetByteCode().IsEmpty();
-        }
+        permutation.m_bCompile = true;
       }
     }
 
-    // copy the source hashes
-    for (ezUInt32 stage = ezGALShaderStage::VertexShader; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
+    if (permutation.m_bCompile)
     {
-      shaderPermutationBinary.m_uiShaderStageHashes[stage] = spd.m_StageBinary[stage].m_uiSourceHash;
+      permutationsToCompile.PushBack(&permutation);
     }
+  }
+
+  ezTaskSystem::ParallelForSingle(permutationsToCompile.GetArrayPtr(),
+    [pCompiler](PermutationData* pPermutation) {
+      ezLogEntryDelegate logger([pPermutation](ezLogEntry& entry) { pPermutation->m_LogEntries.PushBack(std::move(entry)); });
+      ezLogSystemScope logScope(&logger);
+
+      pPermutation->m_Result = pCompiler->Compile(pPermutation->m_ProgramData, &logger);
+    },
+    "Compile Shader Permutations");
+
+  for (PermutationData& permutation : permutations)
+  {
+    ForwardLogEntries(permutation.m_LogEntries, pLog);
+
+    ezShaderProgramCompiler::ezShaderProgramData& spd = permutation.m_ProgramData;
 
     // if compilation failed, the stage binary for the source hash will simply not exist and therefore cannot be loaded
     // the .ezPermutation file should be updated, however, to store the new source hash to the broken shader
-    if (pCompiler->Compile(spd, ezLog::GetThreadLocalLogSystem()).Failed())
+    if (permutation.m_Result.Failed())
     {
       WriteFailedShaderSource(spd, pLog);
       return EZ_FAILURE;
@@ -452,35 +541,55 @@ ezResult ezShaderCompiler::RunShaderCompiler(const char* szFile, const char* szP
 
     for (ezUInt32 stage = ezGALShaderStage::VertexShader; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
     {
-      if (spd.m_StageBinary[stage].m_uiSourceHash != 0 && spd.m_bWriteToDisk[stage])
+      const ezUInt32 uiSourceHash = spd.m_StageBinary[stage].m_uiSourceHash;
+
+      if (permutation.m_bDeduplicated[stage])
+      {
+        auto itCompiled = pCompiledStages[stage].Find(uiSourceHash);
+        EZ_ASSERT_DEV(itCompiled.IsValid(), "The stage binary should have been compiled by an earlier permutation");
+
+        spd.m_StageBinary[stage] = itCompiled.Value();
+        spd.m_szShaderSource[stage] = permutation.m_sProcessed[stage];
+      }
+      else if (uiSourceHash != 0 && spd.m_bWriteToDisk[stage])
       {
         if (spd.m_StageBinary[stage].WriteStageBinary(pLog).Failed())
         {
           ezLog::Error(pLog, "Writing stage {0} binary failed", stage);
           return EZ_FAILURE;
         }
+
+        pCompiledStages[stage].Insert(uiSourceHash, spd.m_StageBinary[stage]);
       }
     }
 
+    ezShaderPermutationBinary& shaderPermutationBinary = permutation.m_PermutationBinary;
+
+    // copy the source hashes
+    for (ezUInt32 stage = ezGALShaderStage::VertexShader; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
+    {
+      shaderPermutationBinary.m_uiShaderStageHashes[stage] = spd.m_StageBinary[stage].m_uiSourceHash;
+    }
+
     ezStringBuilder sTemp = ezShaderManager::GetCacheDirectory();
-    sTemp.AppendPath(Platforms[p].GetData());
+    sTemp.AppendPath(szPlatform);
     sTemp.AppendPath(szFile);
     sTemp.ChangeFileExtension("");
     if (sTemp.EndsWith("."))
       sTemp.Shrink(0, 1);
 
-    const ezUInt32 uiPermutationHash = ezShaderHelper::CalculateHash(m_ShaderData.m_Permutations);
+    const ezUInt32 uiPermutationHash = ezShaderHelper::CalculateHash(*permutation.m_pPermutationVars);
     sTemp.AppendFormat("_{0}.ezPermutation", ezArgU(uiPermutationHash, 8, true, 16, true));
 
     shaderPermutationBinary.m_DependencyFile.Clear();
     shaderPermutationBinary.m_DependencyFile.AddFileDependency(szFile);
 
-    for (auto it = m_IncludeFiles.GetIterator(); it.IsValid(); ++it)
+    for (auto it = permutation.m_IncludeFiles.GetIterator(); it.IsValid(); ++it)
     {
       shaderPermutationBinary.m_DependencyFile.AddFileDependency(it.Key());
     }
 
-    shaderPermutationBinary.m_PermutationVars = m_ShaderData.m_Permutations;
+    shaderPermutationBinary.m_PermutationVars = *permutation.m_pPermutationVars;
 
     ezDeferredFileWriter PermutationFileOut;
     PermutationFileOut.SetOutput(sTemp.GetData());
@@ -496,6 +605,100 @@ ezResult ezShaderCompiler::RunShaderCompiler(const char* szFile, const char* szP
   return EZ_SUCCESS;
 }
 
+void ezShaderCompiler::PreprocessPermutation(PermutationData& permutation)
+{
+  // this runs on a worker thread, the messages are collected and forwarded to the actual log afterwards
+  ezLogEntryDelegate logger([&permutation](ezLogEntry& entry) { permutation.m_LogEntries.PushBack(std::move(entry)); });
+  ezLogSystemScope logScope(&logger);
+
+  bool bFoundUndefinedVars = false;
+
+  auto SetupPreprocessor = [&](ezPreprocessor& pp) {
+    pp.SetCustomFileCache(&m_FileCache);
+    pp.SetLogInterface(&logger);
+    pp.SetFileOpenFunction(ezPreprocessor::FileOpenCB(&ezShaderCompiler::FileOpen, this));
+
+    // the file cache is shared between all permutations, so FileOpen is only called for the first one that includes a file,
+    // the include files of each permutation are recorded when they are located instead
+    pp.SetFileLocatorFunction([&permutation](const char* szCurAbsoluteFile, const char* szIncludeFile, ezPreprocessor::IncludeType IncType,
+                                ezStringBuilder& out_sAbsoluteFilePath) -> ezResult {
+      if (ezPreprocessor::DefaultFileLocator(szCurAbsoluteFile, szIncludeFile, IncType, out_sAbsoluteFilePath).Failed())
+        return EZ_FAILURE;
+
+      if (IncType != ezPreprocessor::MainFile)
+      {
+        permutation.m_IncludeFiles.Insert(out_sAbsoluteFilePath);
+      }
+
+      return EZ_SUCCESS;
+    });
+
+    pp.m_ProcessingEvents.AddEventHandler([&bFoundUndefinedVars](const ezPreprocessor::ProcessingEvent& e) {
+      if (e.m_Type == ezPreprocessor::ProcessingEvent::EvaluateUnknown)
+      {
+        bFoundUndefinedVars = true;
+
+        ezLog::Error("Undefined variable is evaluated: '{0}' (File: '{1}', Line: {2}", e.m_pToken->m_DataView, e.m_pToken->m_File,
+          e.m_pToken->m_uiLine);
+      }
+    });
+  };
+
+  // Generate Shader State Source
+  {
+    ezPreprocessor pp;
+    SetupPreprocessor(pp);
+    pp.SetPassThroughPragma(false);
+    pp.SetPassThroughLine(false);
+
+    for (auto& define : permutation.m_Defines)
+    {
+      pp.AddCustomDefine(define);
+    }
+
+    if (pp.Process("ShaderRenderState", permutation.m_sStateSource, false).Failed() || bFoundUndefinedVars)
+    {
+      ezLog::Error("Preprocessing the Shader State block failed");
+      permutation.m_Result = EZ_FAILURE;
+      return;
+    }
+  }
+
+  ezShaderProgramCompiler::ezShaderProgramData& spd = permutation.m_ProgramData;
+
+  for (ezUInt32 stage = ezGALShaderStage::VertexShader; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
+  {
+    spd.m_StageBinary[stage].m_Stage = (ezGALShaderStage::Enum)stage;
+    spd.m_StageBinary[stage].m_uiSourceHash = 0;
+
+    if (m_ShaderData.m_ShaderStageSource[stage].IsEmpty())
+      continue;
+
+    ezPreprocessor pp;
+    SetupPreprocessor(pp);
+    pp.SetPassThroughPragma(true);
+    pp.SetPassThroughUnknownCmdsCB(ezMakeDelegate(&ezShaderCompiler::PassThroughUnknownCommandCB, this));
+    pp.SetPassThroughLine(false);
+
+    pp.AddCustomDefine(s_szStageDefines[stage]);
+    for (auto& define : permutation.m_Defines)
+    {
+      pp.AddCustomDefine(define);
+    }
+
+    ezStringBuilder& sProcessed = permutation.m_sProcessed[stage];
+    if (pp.Process(m_StageSourceFile[stage], sProcessed, true, true, true).Failed() || bFoundUndefinedVars)
+    {
+      ezLog::Error("Shader preprocessing failed");
+      permutation.m_Result = EZ_FAILURE;
+      return;
+    }
+
+    spd.m_szShaderSource[stage] = sProcessed;
+    spd.m_StageBinary[stage].m_uiSourceHash = ezHashingUtils::xxHash32(sProcessed.GetData(), sProcessed.GetElementCount());
+  }
+}
+
 
 void ezShaderCompiler::WriteFailedShaderSource(ezShaderProgramCompiler::ezShaderProgramData& spd, ezLogInterface* pLog)
 {
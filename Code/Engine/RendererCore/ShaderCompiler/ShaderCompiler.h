@@ -58,6 +58,9 @@ public:
 
   virtual void GetSupportedPlatforms(ezHybridArray<ezString, 4>& Platforms) = 0;
 
+  /// \brief Compiles all stages that have a source and no byte code yet.
+  ///
+  /// ezShaderCompiler compiles several permutations in parallel, so this function may be called from multiple threads at the same time.
   virtual ezResult Compile(ezShaderProgramData& inout_Data, ezLogInterface* pLog) = 0;
 };
 
@@ -67,8 +70,25 @@ public:
   ezResult CompileShaderPermutationForPlatforms(const char* szFile, const ezArrayPtr<const ezPermutationVar>& permutationVars,
                                                 ezLogInterface* pLog, const char* szPlatform = "ALL");
 
+  /// \brief Compiles all permutations of the given shader that \a permutations generates.
+  ///
+  /// This is much faster than compiling every permutation on its own. The permutations are preprocessed and compiled in parallel,
+  /// all preprocessors share one tokenized file cache, so every include file is only read and tokenized once, and stage sources
+  /// that end up identical in several permutations are only compiled once.
+  ezResult CompileShaderPermutationsForPlatforms(const char* szFile, const ezPermutationGenerator& permutations, ezLogInterface* pLog,
+                                                 const char* szPlatform = "ALL");
+
 private:
+  struct PermutationData;
+
+  ezResult ReadShaderFile(const char* szFile);
+  void SelectPermutationVars(const ezArrayPtr<const ezPermutationVar>& permutationVars, ezHybridArray<ezPermutationVar, 16>& out_PermutationVars);
+  ezResult RunShaderCompilers(const char* szFile, const char* szPlatform, ezLogInterface* pLog);
+
   ezResult RunShaderCompiler(const char* szFile, const char* szPlatform, ezShaderProgramCompiler* pCompiler, ezLogInterface* pLog);
+  ezResult CompilePermutations(const char* szFile, const char* szPlatform, ezUInt32 uiFirstPermutation, ezUInt32 uiNumPermutations,
+                               ezShaderProgramCompiler* pCompiler, ezMap<ezUInt32, ezShaderStageBinary>* pCompiledStages, ezLogInterface* pLog);
+  void PreprocessPermutation(PermutationData& permutation);
 
   void WriteFailedShaderSource(ezShaderProgramCompiler::ezShaderProgramData& spd, ezLogInterface* pLog);
 
@@ -77,7 +97,7 @@ private:
   struct ezShaderData
   {
     ezString m_Platforms;
-    ezHybridArray<ezPermutationVar, 16> m_Permutations;
+    ezHybridArray<ezHashedString, 16> m_UsedPermutationVars;
     ezHybridArray<ezPermutationVar, 16> m_FixedPermVars;
     ezString m_StateSource;
     ezString m_ShaderStageSource[ezGALShaderStage::ENUM_COUNT];
@@ -90,6 +110,6 @@ private:
   ezTokenizedFileCache m_FileCache;
   ezShaderData m_ShaderData;
 
-  ezSet<ezString> m_IncludeFiles;
+  /// The permutations that are compiled by the current call, each one is stored as an array of permutation vars.
+  ezDynamicArray<ezHybridArray<ezPermutationVar, 16>> m_Permutations;
 };
-
@@ -0,0 +1,989 @@
+#include <TexturePCH.h>
+
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Texture/Image/Conversions/DXTConversions.h>
+#include <Texture/Image/Conversions/PixelConversions.h>
+#include <Texture/Image/ImageConversion.h>
+
+// SSE2 is part of every x86 target we build for, so no further feature checks are needed
+#if EZ_ENABLED(EZ_PLATFORM_ARCH_X86)
+#  define EZ_SUPPORTS_SSE_BLOCK_COMPRESSION
+
+#  include <emmintrin.h>
+#endif
+
+ezCVarBool cvar_FastBlockCompression("texture.FastBlockCompression", false, ezCVarFlags::Default, "Use the fast mode of the CPU block compressors instead of the high quality mode");
+
+ezBlockCompressionQuality::Enum ezGetBlockCompressionQuality()
+{
+  return cvar_FastBlockCompression ? ezBlockCompressionQuality::Fast : ezBlockCompressionQuality::High;
+}
+
+namespace
+{
+  // The pixels of a block (or of a BC7 subset) in structure-of-arrays layout, so that four pixels can be processed at once
+  struct BlockPixels
+  {
+    float m_Channels[4][16];
+    ezUInt32 m_uiNumPixels = 0;
+
+    void Add(const ezColorBaseUB& color)
+    {
+      m_Channels[0][m_uiNumPixels] = color.r;
+      m_Channels[1][m_uiNumPixels] = color.g;
+      m_Channels[2][m_uiNumPixels] = color.b;
+      m_Channels[3][m_uiNumPixels] = color.a;
+      ++m_uiNumPixels;
+    }
+
+    // Fills up the last group of four pixels with copies of the first pixel
+    void Pad()
+    {
+      for (ezUInt32 i = m_uiNumPixels; i < ezMath::RoundUp(m_uiNumPixels, 4); ++i)
+      {
+        for (ezUInt32 c = 0; c < 4; ++c)
+        {
+          m_Channels[c][i] = m_Channels[c][0];
+        }
+      }
+    }
+  };
+
+  // Finds the closest palette entry for every pixel and returns the sum of the squared errors
+  template <ezUInt32 NumChannels>
+  float findClosestPaletteEntries(const BlockPixels& pixels, const float (*palette)[4], ezUInt32 numEntries, ezUInt8* indices)
+  {
+    float errors[16];
+    const ezUInt32 numPaddedPixels = ezMath::RoundUp(pixels.m_uiNumPixels, 4);
+
+#if defined(EZ_SUPPORTS_SSE_BLOCK_COMPRESSION)
+    for (ezUInt32 i = 0; i < numPaddedPixels; i += 4)
+    {
+      __m128 channels[NumChannels];
+      for (ezUInt32 c = 0; c < NumChannels; ++c)
+      {
+        channels[c] = _mm_loadu_ps(&pixels.m_Channels[c][i]);
+      }
+
+      __m128 bestError = _mm_set1_ps(ezMath::MaxValue<float>());
+      __m128 bestIndex = _mm_setzero_ps();
+
+      for (ezUInt32 e = 0; e < numEntries; ++e)
+      {
+        __m128 error = _mm_setzero_ps();
+        for (ezUInt32 c = 0; c < NumChannels; ++c)
+        {
+          const __m128 diff = _mm_sub_ps(channels[c], _mm_set1_ps(palette[e][c]));
+          error = _mm_add_ps(error, _mm_mul_ps(diff, diff));
+        }
+
+        const __m128 isBetter = _mm_cmplt_ps(error, bestError);
+        bestError = _mm_min_ps(error, bestError);
+        bestIndex = _mm_or_ps(_mm_and_ps(isBetter, _mm_set1_ps(static_cast<float>(e))), _mm_andnot_ps(isBetter, bestIndex));
+      }
+
+      ezInt32 bestIndices[4];
+      _mm_storeu_ps(errors + i, bestError);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(bestIndices), _mm_cvttps_epi32(bestIndex));
+
+      for (ezUInt32 k = 0; k < 4; ++k)
+      {
+        indices[i + k] = static_cast<ezUInt8>(bestIndices[k]);
+      }
+    }
+#else
+    for (ezUInt32 i = 0; i < numPaddedPixels; ++i)
+    {
+      errors[i] = ezMath::MaxValue<float>();
+
+      for (ezUInt32 e = 0; e < numEntries; ++e)
+      {
+        float error = 0.0f;
+        for (ezUInt32 c = 0; c < NumChannels; ++c)
+        {
+          const float diff = pixels.m_Channels[c][i] - palette[e][c];
+          error += diff * diff;
+        }
+
+        if (error < errors[i])
+        {
+          errors[i] = error;
+          indices[i] = static_cast<ezUInt8>(e);
+        }
+      }
+    }
+#endif
+
+    float totalError = 0.0f;
+    for (ezUInt32 i = 0; i < pixels.m_uiNumPixels; ++i)
+    {
+      totalError += errors[i];
+    }
+
+    return totalError;
+  }
+
+  // Computes the mean of the pixels and the direction of largest variance, which is zero for blocks of a single color
+  template <ezUInt32 NumChannels>
+  void computePrincipalAxis(const BlockPixels& pixels, float* mean, float* axis)
+  {
+    const ezUInt32 numPixels = pixels.m_uiNumPixels;
+
+    for (ezUInt32 c = 0; c < NumChannels; ++c)
+    {
+      float sum = 0.0f;
+      for (ezUInt32 i = 0; i < numPixels; ++i)
+      {
+        sum += pixels.m_Channels[c][i];
+      }
+
+      mean[c] = sum / numPixels;
+    }
+
+    float covariance[NumChannels][NumChannels];
+    for (ezUInt32 c0 = 0; c0 < NumChannels; ++c0)
+    {
+      for (ezUInt32 c1 = c0; c1 < NumChannels; ++c1)
+      {
+        float sum = 0.0f;
+        for (ezUInt32 i = 0; i < numPixels; ++i)
+        {
+          sum += (pixels.m_Channels[c0][i] - mean[c0]) * (pixels.m_Channels[c1][i] - mean[c1]);
+        }
+
+        covariance[c0][c1] = sum;
+        covariance[c1][c0] = sum;
+      }
+    }
+
+    // Power iteration, starting with the column of the channel with the largest variance
+    ezUInt32 largestChannel = 0;
+    for (ezUInt32 c = 1; c < NumChannels; ++c)
+    {
+      if (covariance[c][c] > covariance[largestChannel][largestChannel])
+        largestChannel = c;
+    }
+
+    for (ezUInt32 c = 0; c < NumChannels; ++c)
+    {
+      axis[c] = covariance[c][largestChannel];
+    }
+
+    for (ezUInt32 iteration = 0; iteration < 8; ++iteration)
+    {
+      float product[NumChannels];
+      float maxComponent = 0.0f;
+
+      for (ezUInt32 c0 = 0; c0 < NumChannels; ++c0)
+      {
+        product[c0] = 0.0f;
+        for (ezUInt32 c1 = 0; c1 < NumChannels; ++c1)
+        {
+          product[c0] += covariance[c0][c1] * axis[c1];
+        }
+
+        maxComponent = ezMath::Max(maxComponent, ezMath::Abs(product[c0]));
+      }
+
+      if (maxComponent < 0.0001f)
+        break;
+
+      for (ezUInt32 c = 0; c < NumChannels; ++c)
+      {
+        axis[c] = product[c] / maxComponent;
+      }
+    }
+
+    float lengthSquared = 0.0f;
+    for (ezUInt32 c = 0; c < NumChannels; ++c)
+    {
+      lengthSquared += axis[c] * axis[c];
+    }
+
+    const float invLength = lengthSquared > 0.0001f ? 1.0f / ezMath::Sqrt(lengthSquared) : 0.0f;
+    for (ezUInt32 c = 0; c < NumChannels; ++c)
+    {
+      axis[c] *= invLength;
+    }
+  }
+
+  // Computes the endpoints of the line segment along the principal axis that covers all pixels
+  template <ezUInt32 NumChannels>
+  void computeAxisEndpoints(const BlockPixels& pixels, float* endpoint0, float* endpoint1)
+  {
+    float mean[NumChannels], axis[NumChannels];
+    computePrincipalAxis<NumChannels>(pixels, mean, axis);
+
+    float minT = 0.0f;
+    float maxT = 0.0f;
+    for (ezUInt32 i = 0; i < pixels.m_uiNumPixels; ++i)
+    {
+      float t = 0.0f;
+      for (ezUInt32 c = 0; c < NumChannels; ++c)
+      {
+        t += (pixels.m_Channels[c][i] - mean[c]) * axis[c];
+      }
+
+      minT = ezMath::Min(minT, t);
+      maxT = ezMath::Max(maxT, t);
+    }
+
+    for (ezUInt32 c = 0; c < NumChannels; ++c)
+    {
+      endpoint0[c] = ezMath::Clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+      endpoint1[c] = ezMath::Clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+    }
+  }
+
+  // Least squares fit of two endpoints, where pixel i is approximated by weights0[i] * endpoint0 + (1 - weights0[i]) * endpoint1
+  template <ezUInt32 NumChannels>
+  bool fitEndpoints(const BlockPixels& pixels, const float* weights0, float* endpoint0, float* endpoint1)
+  {
+    float w00 = 0.0f, w01 = 0.0f, w11 = 0.0f;
+    float x0[NumChannels] = {}, x1[NumChannels] = {};
+
+    for (ezUInt32 i = 0; i < pixels.m_uiNumPixels; ++i)
+    {
+      const float w0 = weights0[i];
+      const float w1 = 1.0f - w0;
+
+      w00 += w0 * w0;
+      w01 += w0 * w1;
+      w11 += w1 * w1;
+
+      for (ezUInt32 c = 0; c < NumChannels; ++c)
+      {
+        x0[c] += w0 * pixels.m_Channels[c][i];
+        x1[c] += w1 * pixels.m_Channels[c][i];
+      }
+    }
+
+    const float det = w00 * w11 - w01 * w01;
+    if (det < 0.001f)
+      return false;
+
+    const float invDet = 1.0f / det;
+    for (ezUInt32 c = 0; c < NumChannels; ++c)
+    {
+      endpoint0[c] = ezMath::Clamp((w11 * x0[c] - w01 * x1[c]) * invDet, 0.0f, 255.0f);
+      endpoint1[c] = ezMath::Clamp((w00 * x1[c] - w01 * x0[c]) * invDet, 0.0f, 255.0f);
+    }
+
+    return true;
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // BC1 / BC3 color blocks
+
+  struct ColorBlockFit
+  {
+    ezUInt16 m_uiColor0 = 0;
+    ezUInt16 m_uiColor1 = 0;
+    ezUInt8 m_Indices[16];
+    float m_fError = ezMath::MaxValue<float>();
+  };
+
+  ezUInt16 quantizeB5G6R5(const float* color)
+  {
+    const ezUInt32 r = static_cast<ezUInt32>(color[0] * (31.0f / 255.0f) + 0.5f);
+    const ezUInt32 g = static_cast<ezUInt32>(color[1] * (63.0f / 255.0f) + 0.5f);
+    const ezUInt32 b = static_cast<ezUInt32>(color[2] * (31.0f / 255.0f) + 0.5f);
+    return static_cast<ezUInt16>((r << 11) | (g << 5) | b);
+  }
+
+  // Computes the indices for the given endpoints and keeps the result if it is better than the current fit.
+  // The decoder picks the palette through the order of the endpoints, so they are swapped as needed.
+  void evaluateColorEndpoints(const BlockPixels& pixels, ezUInt16 color0, ezUInt16 color1, bool threeColorMode, bool forceFourColorMode, ColorBlockFit& bestFit)
+  {
+    if (threeColorMode ? color0 > color1 : (color0 < color1 && !forceFourColorMode))
+    {
+      ezMath::Swap(color0, color1);
+    }
+
+    // Equal endpoints select the three color palette, which only matters for the unused fourth entry
+    const bool fourColors = forceFourColorMode || color0 > color1;
+
+    const ezColorBaseUB c0 = ezDecompressB5G6R5(color0);
+    const ezColorBaseUB c1 = ezDecompressB5G6R5(color1);
+
+    float palette[4][4];
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      const ezUInt32 v0 = c0.GetData()[c];
+      const ezUInt32 v1 = c1.GetData()[c];
+
+      palette[0][c] = static_cast<float>(v0);
+      palette[1][c] = static_cast<float>(v1);
+
+      if (fourColors)
+      {
+        palette[2][c] = static_cast<float>((2 * v0 + v1 + 1) / 3);
+        palette[3][c] = static_cast<float>((v0 + 2 * v1 + 1) / 3);
+      }
+      else
+      {
+        palette[2][c] = static_cast<float>((v0 + v1) / 2);
+      }
+    }
+
+    ColorBlockFit fit;
+    fit.m_uiColor0 = color0;
+    fit.m_uiColor1 = color1;
+    fit.m_fError = findClosestPaletteEntries<3>(pixels, palette, fourColors ? 4 : 3, fit.m_Indices);
+
+    if (fit.m_fError < bestFit.m_fError)
+    {
+      bestFit = fit;
+    }
+  }
+
+  void fitColorEndpoints(const BlockPixels& pixels, const float* endpoint0, const float* endpoint1, bool threeColorMode, bool forceFourColorMode,
+    ezBlockCompressionQuality::Enum quality, ColorBlockFit& bestFit)
+  {
+    evaluateColorEndpoints(pixels, quantizeB5G6R5(endpoint0), quantizeB5G6R5(endpoint1), threeColorMode, forceFourColorMode, bestFit);
+
+    if (quality == ezBlockCompressionQuality::Fast)
+      return;
+
+    for (ezUInt32 iteration = 0; iteration < 2 && bestFit.m_fError > 0.0f; ++iteration)
+    {
+      const bool fourColors = forceFourColorMode || bestFit.m_uiColor0 > bestFit.m_uiColor1;
+      const float weightsFourColors[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+      const float weightsThreeColors[4] = {1.0f, 0.0f, 0.5f, 0.0f};
+      const float* weightTable = fourColors ? weightsFourColors : weightsThreeColors;
+
+      float weights0[16];
+      for (ezUInt32 i = 0; i < pixels.m_uiNumPixels; ++i)
+      {
+        weights0[i] = weightTable[bestFit.m_Indices[i]];
+      }
+
+      float refined0[3], refined1[3];
+      if (!fitEndpoints<3>(pixels, weights0, refined0, refined1))
+        break;
+
+      const float previousError = bestFit.m_fError;
+      evaluateColorEndpoints(pixels, quantizeB5G6R5(refined0), quantizeB5G6R5(refined1), threeColorMode, forceFourColorMode, bestFit);
+
+      if (bestFit.m_fError >= previousError)
+        break;
+    }
+  }
+
+  void compressColorBlock(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality, bool allowTransparency)
+  {
+    BlockPixels pixels;
+    ezUInt8 pixelSlots[16];
+
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      if (allowTransparency && pSource[i].a < 128)
+      {
+        pixelSlots[i] = 0xFF;
+      }
+      else
+      {
+        pixelSlots[i] = static_cast<ezUInt8>(pixels.m_uiNumPixels);
+        pixels.Add(pSource[i]);
+      }
+    }
+
+    if (pixels.m_uiNumPixels == 0)
+    {
+      // Three color mode with all pixels using the transparent palette entry
+      memset(pTarget, 0x00, 4);
+      memset(pTarget + 4, 0xFF, 4);
+      return;
+    }
+
+    pixels.Pad();
+
+    const bool hasTransparentPixels = pixels.m_uiNumPixels < 16;
+    const bool forceFourColorMode = !allowTransparency;
+
+    float endpoint0[3], endpoint1[3];
+    computeAxisEndpoints<3>(pixels, endpoint0, endpoint1);
+
+    ColorBlockFit bestFit;
+    fitColorEndpoints(pixels, endpoint0, endpoint1, hasTransparentPixels, forceFourColorMode, quality, bestFit);
+
+    // The three color palette has an exact midpoint, which fits some blocks better
+    if (quality == ezBlockCompressionQuality::High && !hasTransparentPixels && !forceFourColorMode && bestFit.m_fError > 0.0f)
+    {
+      fitColorEndpoints(pixels, endpoint0, endpoint1, true, forceFourColorMode, quality, bestFit);
+    }
+
+    pTarget[0] = static_cast<ezUInt8>(bestFit.m_uiColor0 & 0xFF);
+    pTarget[1] = static_cast<ezUInt8>(bestFit.m_uiColor0 >> 8);
+    pTarget[2] = static_cast<ezUInt8>(bestFit.m_uiColor1 & 0xFF);
+    pTarget[3] = static_cast<ezUInt8>(bestFit.m_uiColor1 >> 8);
+
+    for (ezUInt32 byteIdx = 0; byteIdx < 4; ++byteIdx)
+    {
+      ezUInt8 indices = 0;
+      for (ezUInt32 i = 0; i < 4; ++i)
+      {
+        const ezUInt8 slot = pixelSlots[4 * byteIdx + i];
+        indices |= (slot == 0xFF ? 3 : bestFit.m_Indices[slot]) << (2 * i);
+      }
+
+      pTarget[4 + byteIdx] = indices;
+    }
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // BC7
+
+  struct BC7ModeDesc
+  {
+    ezUInt32 m_uiMode;
+    ezUInt32 m_uiNumSubsets;
+    ezUInt32 m_uiNumChannels;
+    ezUInt32 m_uiEndpointBits; // per channel, without the p-bit
+    ezUInt32 m_uiIndexBits;
+    bool m_bSharedPBit; // one p-bit per subset instead of one per endpoint
+  };
+
+  // Mode 1: Color only, 2 Subsets, RGBP 6661 (shared P-bit), 3-bit indices, 64 partitions
+  static const BC7ModeDesc s_bc7Mode1 = {1, 2, 3, 6, 3, true};
+  // Mode 6: Color+Alpha, 1 Subset, RGBAP 77771 (unique P-bit), 16x4-bit indices
+  static const BC7ModeDesc s_bc7Mode6 = {6, 1, 4, 7, 4, false};
+
+  static const ezUInt32 s_bc7Weights3[] = {0, 9, 18, 27, 37, 46, 55, 64};
+  static const ezUInt32 s_bc7Weights4[] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+  struct BC7SubsetFit
+  {
+    ezUInt8 m_Endpoints[2][4]; // quantized, without the p-bit
+    ezUInt8 m_PBits[2];
+    ezUInt8 m_Indices[16];
+    float m_fError = ezMath::MaxValue<float>();
+  };
+
+  // Expands a quantized value (including its p-bit) to 8 bits the same way as the decoder
+  ezUInt32 unquantizeBC7(ezUInt32 value, ezUInt32 bits)
+  {
+    value <<= (8 - bits);
+    return (value | (value >> bits)) & 0xFF;
+  }
+
+  // Returns the quantized value (without the p-bit) that comes closest to the given value after unquantization
+  ezUInt32 quantizeBC7(float value, ezUInt32 bits, ezUInt32 pBit)
+  {
+    const ezInt32 maxValue = (1 << bits) - 1;
+    const ezInt32 guess = static_cast<ezInt32>((value * ((2 << bits) - 1) / 255.0f - pBit) * 0.5f + 0.5f);
+
+    ezUInt32 bestValue = 0;
+    float bestError = ezMath::MaxValue<float>();
+
+    for (ezInt32 candidate = ezMath::Max(guess - 1, 0); candidate <= ezMath::Min(guess + 1, maxValue); ++candidate)
+    {
+      const float error = ezMath::Abs(unquantizeBC7((candidate << 1) | pBit, bits + 1) - value);
+      if (error < bestError)
+      {
+        bestError = error;
+        bestValue = candidate;
+      }
+    }
+
+    return bestValue;
+  }
+
+  template <ezUInt32 NumChannels>
+  void evaluateEndpointsBC7(const BlockPixels& pixels, const BC7ModeDesc& mode, const BC7SubsetFit& candidate, BC7SubsetFit& bestFit)
+  {
+    const ezUInt32 numEntries = 1 << mode.m_uiIndexBits;
+    const ezUInt32* weights = mode.m_uiIndexBits == 3 ? s_bc7Weights3 : s_bc7Weights4;
+
+    ezUInt32 e0[NumChannels], e1[NumChannels];
+    for (ezUInt32 c = 0; c < NumChannels; ++c)
+    {
+      e0[c] = unquantizeBC7((candidate.m_Endpoints[0][c] << 1) | candidate.m_PBits[0], mode.m_uiEndpointBits + 1);
+      e1[c] = unquantizeBC7((candidate.m_Endpoints[1][c] << 1) | candidate.m_PBits[1], mode.m_uiEndpointBits + 1);
+    }
+
+    float palette[16][4];
+    for (ezUInt32 e = 0; e < numEntries; ++e)
+    {
+      for (ezUInt32 c = 0; c < NumChannels; ++c)
+      {
+        palette[e][c] = static_cast<float>((e0[c] * (64 - weights[e]) + e1[c] * weights[e] + 32) >> 6);
+      }
+    }
+
+    BC7SubsetFit fit = candidate;
+    fit.m_fError = findClosestPaletteEntries<NumChannels>(pixels, palette, numEntries, fit.m_Indices);
+
+    if (fit.m_fError < bestFit.m_fError)
+    {
+      bestFit = fit;
+    }
+  }
+
+  // Quantizes the endpoints with every p-bit combination (or only the one with the lowest quantization error) and keeps the best result
+  template <ezUInt32 NumChannels>
+  void quantizeEndpointsBC7(const BlockPixels& pixels, const BC7ModeDesc& mode, ezBlockCompressionQuality::Enum quality, const float (&endpoints)[2][4], BC7SubsetFit& bestFit)
+  {
+    const ezUInt32 numCombinations = mode.m_bSharedPBit ? 2 : 4;
+
+    BC7SubsetFit candidates[4];
+    float quantizationErrors[4];
+
+    for (ezUInt32 combination = 0; combination < numCombinations; ++combination)
+    {
+      BC7SubsetFit& candidate = candidates[combination];
+      candidate.m_PBits[0] = combination & 1;
+      candidate.m_PBits[1] = mode.m_bSharedPBit ? (combination & 1) : (combination >> 1);
+
+      quantizationErrors[combination] = 0.0f;
+      for (ezUInt32 e = 0; e < 2; ++e)
+      {
+        for (ezUInt32 c = 0; c < 4; ++c)
+        {
+          candidate.m_Endpoints[e][c] = 0;
+        }
+
+        for (ezUInt32 c = 0; c < NumChannels; ++c)
+        {
+          const ezUInt32 quantized = quantizeBC7(endpoints[e][c], mode.m_uiEndpointBits, candidate.m_PBits[e]);
+          const float diff = unquantizeBC7((quantized << 1) | candidate.m_PBits[e], mode.m_uiEndpointBits + 1) - endpoints[e][c];
+
+          candidate.m_Endpoints[e][c] = static_cast<ezUInt8>(quantized);
+          quantizationErrors[combination] += diff * diff;
+        }
+      }
+    }
+
+    if (quality == ezBlockCompressionQuality::High)
+    {
+      for (ezUInt32 combination = 0; combination < numCombinations; ++combination)
+      {
+        evaluateEndpointsBC7<NumChannels>(pixels, mode, candidates[combination], bestFit);
+      }
+    }
+    else
+    {
+      ezUInt32 bestCombination = 0;
+      for (ezUInt32 combination = 1; combination < numCombinations; ++combination)
+      {
+        if (quantizationErrors[combination] < quantizationErrors[bestCombination])
+          bestCombination = combination;
+      }
+
+      evaluateEndpointsBC7<NumChannels>(pixels, mode, candidates[bestCombination], bestFit);
+    }
+  }
+
+  template <ezUInt32 NumChannels>
+  void fitSubsetBC7(const BlockPixels& pixels, const BC7ModeDesc& mode, ezBlockCompressionQuality::Enum quality, BC7SubsetFit& bestFit)
+  {
+    float endpoints[2][4];
+    computeAxisEndpoints<NumChannels>(pixels, endpoints[1], endpoints[0]);
+
+    quantizeEndpointsBC7<NumChannels>(pixels, mode, quality, endpoints, bestFit);
+
+    const ezUInt32 numIterations = quality == ezBlockCompressionQuality::High ? 2 : 1;
+    const ezUInt32* weights = mode.m_uiIndexBits == 3 ? s_bc7Weights3 : s_bc7Weights4;
+
+    for (ezUInt32 iteration = 0; iteration < numIterations && bestFit.m_fError > 0.0f; ++iteration)
+    {
+      float weights0[16];
+      for (ezUInt32 i = 0; i < pixels.m_uiNumPixels; ++i)
+      {
+        weights0[i] = (64 - weights[bestFit.m_Indices[i]]) / 64.0f;
+      }
+
+      if (!fitEndpoints<NumChannels>(pixels, weights0, endpoints[0], endpoints[1]))
+        break;
+
+      const float previousError = bestFit.m_fError;
+      quantizeEndpointsBC7<NumChannels>(pixels, mode, quality, endpoints, bestFit);
+
+      if (bestFit.m_fError >= previousError)
+        break;
+    }
+  }
+
+  // Estimates the error of a line fit through each subset of every 2 subset partition and returns the most promising shapes
+  void findBestPartitionsBC7(const BlockPixels& pixels, ezUInt32* shapes, ezUInt32 numShapes)
+  {
+    float shapeErrors[64];
+
+    for (ezUInt32 shape = 0; shape < 64; ++shape)
+    {
+      const ezUInt8* partition = ezGetPartitionTableBC7(2, shape);
+      shapeErrors[shape] = 0.0f;
+
+      for (ezUInt32 subset = 0; subset < 2; ++subset)
+      {
+        float count = 0.0f;
+        float sum[3] = {};
+        float sumSquares[3][3] = {};
+
+        for (ezUInt32 i = 0; i < 16; ++i)
+        {
+          if (partition[i] != subset)
+            continue;
+
+          count += 1.0f;
+          for (ezUInt32 c0 = 0; c0 < 3; ++c0)
+          {
+            sum[c0] += pixels.m_Channels[c0][i];
+            for (ezUInt32 c1 = c0; c1 < 3; ++c1)
+            {
+              sumSquares[c0][c1] += pixels.m_Channels[c0][i] * pixels.m_Channels[c1][i];
+            }
+          }
+        }
+
+        float covariance[3][3];
+        for (ezUInt32 c0 = 0; c0 < 3; ++c0)
+        {
+          for (ezUInt32 c1 = c0; c1 < 3; ++c1)
+          {
+            covariance[c0][c1] = sumSquares[c0][c1] - sum[c0] * sum[c1] / count;
+            covariance[c1][c0] = covariance[c0][c1];
+          }
+        }
+
+        // The part of the variance that is not along the principal axis can't be represented by the endpoints
+        float axis[3] = {1.0f, 1.0f, 1.0f};
+        float eigenValue = 0.0f;
+        for (ezUInt32 iteration = 0; iteration < 4; ++iteration)
+        {
+          float product[3];
+          for (ezUInt32 c = 0; c < 3; ++c)
+          {
+            product[c] = covariance[c][0] * axis[0] + covariance[c][1] * axis[1] + covariance[c][2] * axis[2];
+          }
+
+          const float lengthSquared = product[0] * product[0] + product[1] * product[1] + product[2] * product[2];
+          if (lengthSquared < 0.0001f)
+            break;
+
+          const float invLength = 1.0f / ezMath::Sqrt(lengthSquared);
+          for (ezUInt32 c = 0; c < 3; ++c)
+          {
+            axis[c] = product[c] * invLength;
+          }
+
+          eigenValue = lengthSquared * invLength;
+        }
+
+        shapeErrors[shape] += ezMath::Max(covariance[0][0] + covariance[1][1] + covariance[2][2] - eigenValue, 0.0f);
+      }
+    }
+
+    for (ezUInt32 i = 0; i < numShapes; ++i)
+    {
+      ezUInt32 bestShape = 0;
+      for (ezUInt32 shape = 1; shape < 64; ++shape)
+      {
+        if (shapeErrors[shape] < shapeErrors[bestShape])
+          bestShape = shape;
+      }
+
+      shapes[i] = bestShape;
+      shapeErrors[bestShape] = ezMath::MaxValue<float>();
+    }
+  }
+
+  struct BC7BitWriter
+  {
+    ezUInt8* m_pData;
+    ezUInt32 m_uiBit = 0;
+
+    void Write(ezUInt32 value, ezUInt32 numBits)
+    {
+      for (ezUInt32 b = 0; b < numBits; ++b, ++m_uiBit)
+      {
+        m_pData[m_uiBit >> 3] |= ((value >> b) & 1) << (m_uiBit & 7);
+      }
+    }
+  };
+
+  void writeBlockBC7(const BC7ModeDesc& mode, ezUInt32 shape, BC7SubsetFit* fits, const ezUInt8* pixelSlots, ezUInt8* pTarget)
+  {
+    const ezUInt8* partition = ezGetPartitionTableBC7(mode.m_uiNumSubsets, shape);
+    const ezUInt32 maxIndex = (1 << mode.m_uiIndexBits) - 1;
+    const ezUInt32 anchorBit = 1 << (mode.m_uiIndexBits - 1);
+
+    // The most significant index bit of the anchor pixels is implicitly zero, which can be achieved by swapping the endpoints
+    for (ezUInt32 subset = 0; subset < mode.m_uiNumSubsets; ++subset)
+    {
+      BC7SubsetFit& fit = fits[subset];
+
+      if ((fit.m_Indices[pixelSlots[ezGetAnchorIndexBC7(mode.m_uiNumSubsets, shape, subset)]] & anchorBit) == 0)
+        continue;
+
+      for (ezUInt32 c = 0; c < 4; ++c)
+      {
+        ezMath::Swap(fit.m_Endpoints[0][c], fit.m_Endpoints[1][c]);
+      }
+
+      ezMath::Swap(fit.m_PBits[0], fit.m_PBits[1]);
+
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        fit.m_Indices[i] = static_cast<ezUInt8>(maxIndex - fit.m_Indices[i]);
+      }
+    }
+
+    memset(pTarget, 0, 16);
+
+    BC7BitWriter writer;
+    writer.m_pData = pTarget;
+    writer.Write(1 << mode.m_uiMode, mode.m_uiMode + 1);
+
+    if (mode.m_uiNumSubsets > 1)
+    {
+      writer.Write(shape, 6);
+    }
+
+    for (ezUInt32 c = 0; c < mode.m_uiNumChannels; ++c)
+    {
+      for (ezUInt32 subset = 0; subset < mode.m_uiNumSubsets; ++subset)
+      {
+        writer.Write(fits[subset].m_Endpoints[0][c], mode.m_uiEndpointBits);
+        writer.Write(fits[subset].m_Endpoints[1][c], mode.m_uiEndpointBits);
+      }
+    }
+
+    for (ezUInt32 subset = 0; subset < mode.m_uiNumSubsets; ++subset)
+    {
+      writer.Write(fits[subset].m_PBits[0], 1);
+
+      if (!mode.m_bSharedPBit)
+      {
+        writer.Write(fits[subset].m_PBits[1], 1);
+      }
+    }
+
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      const ezUInt32 subset = partition[i];
+      const bool isAnchor = ezGetAnchorIndexBC7(mode.m_uiNumSubsets, shape, subset) == i;
+
+      writer.Write(fits[subset].m_Indices[pixelSlots[i]], isAnchor ? mode.m_uiIndexBits - 1 : mode.m_uiIndexBits);
+    }
+
+    EZ_ASSERT_DEBUG(writer.m_uiBit == 128, "Invalid BC7 block size");
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // Conversion step
+
+  typedef void (*CompressBlockFunc)(const ezUInt8* pBlock, ezUInt32 uiPixelStride, ezUInt8 bias, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality);
+
+  void compressBlockBC1(const ezUInt8* pBlock, ezUInt32 uiPixelStride, ezUInt8 bias, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+  {
+    ezCompressBlockBC1(reinterpret_cast<const ezColorBaseUB*>(pBlock), pTarget, quality);
+  }
+
+  void compressBlockBC3(const ezUInt8* pBlock, ezUInt32 uiPixelStride, ezUInt8 bias, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+  {
+    ezCompressBlockBC3(reinterpret_cast<const ezColorBaseUB*>(pBlock), pTarget, quality);
+  }
+
+  void compressBlockBC4(const ezUInt8* pBlock, ezUInt32 uiPixelStride, ezUInt8 bias, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+  {
+    ezCompressBlockBC4(pBlock, uiPixelStride, pTarget, bias, quality);
+  }
+
+  void compressBlockBC5(const ezUInt8* pBlock, ezUInt32 uiPixelStride, ezUInt8 bias, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+  {
+    ezCompressBlockBC4(pBlock + 0, uiPixelStride, pTarget + 0, bias, quality);
+    ezCompressBlockBC4(pBlock + 1, uiPixelStride, pTarget + 8, bias, quality);
+  }
+
+  void compressBlockBC7(const ezUInt8* pBlock, ezUInt32 uiPixelStride, ezUInt8 bias, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+  {
+    ezCompressBlockBC7(reinterpret_cast<const ezColorBaseUB*>(pBlock), pTarget, quality);
+  }
+
+  ezImageConversionEntry makeEntry(ezImageFormat::Enum source, ezImageFormat::Enum target)
+  {
+    ezImageConversionEntry entry(source, target, ezImageConversionFlags::Default);
+
+    // A small penalty, so that the DirectXTex based compressors are preferred where they are available
+    entry.m_additionalPenalty = 1.0f;
+    return entry;
+  }
+} // namespace
+
+void ezCompressBlockBC1(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+{
+  compressColorBlock(pSource, pTarget, quality, true);
+}
+
+void ezCompressBlockBC3(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+{
+  ezCompressBlockBC4(&pSource[0].a, sizeof(ezColorBaseUB), pTarget, 0, quality);
+  compressColorBlock(pSource, pTarget + 8, quality, false);
+}
+
+void ezCompressBlockBC7(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+{
+  BlockPixels pixels;
+  bool isOpaque = true;
+
+  for (ezUInt32 i = 0; i < 16; ++i)
+  {
+    pixels.Add(pSource[i]);
+    isOpaque &= pSource[i].a == 255;
+  }
+
+  static const ezUInt8 s_identitySlots[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+
+  BC7SubsetFit mode6Fit;
+  fitSubsetBC7<4>(pixels, s_bc7Mode6, quality, mode6Fit);
+
+  // Opaque blocks can use two subsets, which represents edges much better than a single line through the color space
+  if (quality == ezBlockCompressionQuality::High && isOpaque && mode6Fit.m_fError > 0.0f)
+  {
+    ezUInt32 shapes[4];
+    findBestPartitionsBC7(pixels, shapes, EZ_ARRAY_SIZE(shapes));
+
+    BC7SubsetFit bestFits[2];
+    ezUInt8 bestSlots[16];
+    ezUInt32 bestShape = 0;
+    float bestError = mode6Fit.m_fError;
+
+    for (ezUInt32 shape : shapes)
+    {
+      const ezUInt8* partition = ezGetPartitionTableBC7(2, shape);
+
+      BlockPixels subsetPixels[2];
+      ezUInt8 slots[16];
+
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        slots[i] = static_cast<ezUInt8>(subsetPixels[partition[i]].m_uiNumPixels);
+        subsetPixels[partition[i]].Add(pSource[i]);
+      }
+
+      BC7SubsetFit fits[2];
+      for (ezUInt32 subset = 0; subset < 2; ++subset)
+      {
+        subsetPixels[subset].Pad();
+        fitSubsetBC7<3>(subsetPixels[subset], s_bc7Mode1, quality, fits[subset]);
+      }
+
+      if (fits[0].m_fError + fits[1].m_fError < bestError)
+      {
+        bestError = fits[0].m_fError + fits[1].m_fError;
+        bestShape = shape;
+        bestFits[0] = fits[0];
+        bestFits[1] = fits[1];
+        memcpy(bestSlots, slots, sizeof(slots));
+      }
+    }
+
+    if (bestError < mode6Fit.m_fError)
+    {
+      writeBlockBC7(s_bc7Mode1, bestShape, bestFits, bestSlots, pTarget);
+      return;
+    }
+  }
+
+  writeBlockBC7(s_bc7Mode6, 0, &mode6Fit, s_identitySlots, pTarget);
+}
+
+/// \brief Portable block compressors, which work on all platforms and process the block rows in parallel.
+class ezImageConversion_CompressBlocks : public ezImageConversionStepCompressBlocks
+{
+public:
+  virtual const char* GetName() const override { return "ezImageConversion_CompressBlocks"; }
+
+  virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
+  {
+    static ezImageConversionEntry supportedConversions[] = {
+      makeEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC1_UNORM),
+      makeEntry(ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::BC1_UNORM_SRGB),
+      makeEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC3_UNORM),
+      makeEntry(ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::BC3_UNORM_SRGB),
+      makeEntry(ezImageFormat::R8_UNORM, ezImageFormat::BC4_UNORM),
+      makeEntry(ezImageFormat::R8_SNORM, ezImageFormat::BC4_SNORM),
+      makeEntry(ezImageFormat::R8G8_UNORM, ezImageFormat::BC4_UNORM),
+      makeEntry(ezImageFormat::R8G8_SNORM, ezImageFormat::BC4_SNORM),
+      makeEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC4_UNORM),
+      makeEntry(ezImageFormat::R8G8B8A8_SNORM, ezImageFormat::BC4_SNORM),
+      makeEntry(ezImageFormat::R8G8_UNORM, ezImageFormat::BC5_UNORM),
+      makeEntry(ezImageFormat::R8G8_SNORM, ezImageFormat::BC5_SNORM),
+      makeEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC5_UNORM),
+      makeEntry(ezImageFormat::R8G8B8A8_SNORM, ezImageFormat::BC5_SNORM),
+      makeEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC7_UNORM),
+      makeEntry(ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::BC7_UNORM_SRGB),
+    };
+    return supportedConversions;
+  }
+
+  virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
+    ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) const override
+  {
+    CompressBlockFunc compressBlock = nullptr;
+
+    switch (targetFormat)
+    {
+      case ezImageFormat::BC1_UNORM:
+      case ezImageFormat::BC1_UNORM_SRGB:
+        compressBlock = &compressBlockBC1;
+        break;
+      case ezImageFormat::BC3_UNORM:
+      case ezImageFormat::BC3_UNORM_SRGB:
+        compressBlock = &compressBlockBC3;
+        break;
+      case ezImageFormat::BC4_UNORM:
+      case ezImageFormat::BC4_SNORM:
+        compressBlock = &compressBlockBC4;
+        break;
+      case ezImageFormat::BC5_UNORM:
+      case ezImageFormat::BC5_SNORM:
+        compressBlock = &compressBlockBC5;
+        break;
+      case ezImageFormat::BC7_UNORM:
+      case ezImageFormat::BC7_UNORM_SRGB:
+        compressBlock = &compressBlockBC7;
+        break;
+      default:
+        return EZ_FAILURE;
+    }
+
+    const ezUInt32 pixelStride = ezImageFormat::GetBitsPerPixel(sourceFormat) / 8;
+    const ezUInt64 rowPitch = ezImageFormat::GetRowPitch(sourceFormat, 4 * numBlocksX);
+    const ezUInt32 blockSize = ezImageFormat::GetBitsPerBlock(targetFormat) / 8;
+    const ezBlockCompressionQuality::Enum quality = ezGetBlockCompressionQuality();
+
+    // Bias to shift signed data into unsigned range so we can treat it the same as unsigned
+    const ezUInt8 bias = ezImageFormat::GetDataType(sourceFormat) == ezImageFormatDataType::SNORM ? 128 : 0;
+
+    const ezUInt8* sourcePointer = static_cast<const ezUInt8*>(source.GetPtr());
+    ezUInt8* targetPointer = static_cast<ezUInt8*>(target.GetPtr());
+
+    ezTaskSystem::ParallelForIndexed(0, numBlocksY, [&](ezUInt32 uiStartRow, ezUInt32 uiEndRow) {
+      ezUInt8 block[16 * 4];
+
+      for (ezUInt32 blockY = uiStartRow; blockY < uiEndRow; ++blockY)
+      {
+        for (ezUInt32 blockX = 0; blockX < numBlocksX; ++blockX)
+        {
+          // Gather the 4x4 pixels, so that the compressors can work on 16 consecutive pixels
+          for (ezUInt32 y = 0; y < 4; ++y)
+          {
+            memcpy(block + 4 * y * pixelStride, sourcePointer + (4 * blockY + y) * rowPitch + 4 * blockX * pixelStride, 4 * pixelStride);
+          }
+
+          compressBlock(block, pixelStride, bias, targetPointer + (blockY * numBlocksX + blockX) * blockSize, quality);
+        }
+      }
+    },
+      "CompressBlocks");
+
+    return EZ_SUCCESS;
+  }
+};
+
+static ezImageConversion_CompressBlocks s_conversion_compressBlocks;
+
+EZ_STATICLINK_FILE(Texture, Texture_Image_Conversions_BlockCompressionConversions);
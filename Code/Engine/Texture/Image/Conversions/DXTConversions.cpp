@@ -388,6 +388,145 @@ namespace
   }
 #endif
 
+  ezUInt32 findPaletteIndicesBC4(const ezUInt8* sourceData, ezUInt32 a0, ezUInt32 a1, ezUInt8* indices)
+  {
+    ezUInt32 palette[8];
+    ezUnpackPaletteBC4(a0, a1, palette);
+
+    ezUInt32 error = 0;
+    for (ezUInt32 idx = 0; idx < 16; ++idx)
+    {
+      ezUInt32 bestDistance = ezUInt32(-1);
+      for (ezUInt32 p = 0; p < 8; ++p)
+      {
+        const ezInt32 diff = ezInt32(sourceData[idx]) - ezInt32(palette[p]);
+        const ezUInt32 distance = diff * diff;
+
+        if (distance < bestDistance)
+        {
+          bestDistance = distance;
+          indices[idx] = ezUInt8(p);
+        }
+      }
+
+      error += bestDistance;
+    }
+
+    return error;
+  }
+
+  void writeBlockBC4(ezUInt32 a0, ezUInt32 a1, const ezUInt8* indices, ezUInt8* targetData)
+  {
+    targetData[0] = ezUInt8(a0);
+    targetData[1] = ezUInt8(a1);
+
+    ezUInt64 packedIndices = 0;
+    for (ezUInt32 idx = 0; idx < 16; ++idx)
+    {
+      packedIndices |= ezUInt64(indices[idx]) << (3 * idx);
+    }
+
+    memcpy(targetData + 2, &packedIndices, 6);
+  }
+
+  // Least squares fit of the endpoints of the 8 value palette (a0 > a1) to the given indices
+  bool refineEndpointsBC4(const ezUInt8* sourceData, const ezUInt8* indices, ezUInt32& a0, ezUInt32& a1)
+  {
+    static const float s_weightsA0[8] = {1.0f, 0.0f, 6.0f / 7.0f, 5.0f / 7.0f, 4.0f / 7.0f, 3.0f / 7.0f, 2.0f / 7.0f, 1.0f / 7.0f};
+
+    float w00 = 0.0f, w01 = 0.0f, w11 = 0.0f, x0 = 0.0f, x1 = 0.0f;
+    for (ezUInt32 idx = 0; idx < 16; ++idx)
+    {
+      const float w0 = s_weightsA0[indices[idx]];
+      const float w1 = 1.0f - w0;
+      const float value = sourceData[idx];
+
+      w00 += w0 * w0;
+      w01 += w0 * w1;
+      w11 += w1 * w1;
+      x0 += w0 * value;
+      x1 += w1 * value;
+    }
+
+    const float det = w00 * w11 - w01 * w01;
+    if (det < 0.001f)
+      return false;
+
+    const float e0 = ezMath::Clamp((w11 * x0 - w01 * x1) / det, 0.0f, 255.0f);
+    const float e1 = ezMath::Clamp((w00 * x1 - w01 * x0) / det, 0.0f, 255.0f);
+
+    a0 = static_cast<ezUInt32>(e0 + 0.5f);
+    a1 = static_cast<ezUInt32>(e1 + 0.5f);
+    return a0 > a1;
+  }
+
+  // Portable palette search, used where the exhaustive SSE search is not available or too slow
+  void findPaletteBC4(const ezUInt8* sourceData, ezBlockCompressionQuality::Enum quality, ezUInt32& bestA0, ezUInt32& bestA1, ezUInt8* bestIndices)
+  {
+    ezUInt32 minA = 255;
+    ezUInt32 maxA = 0;
+    ezUInt32 minA_greater0 = 255;
+    ezUInt32 maxA_less255 = 0;
+
+    for (ezUInt32 idx = 0; idx < 16; ++idx)
+    {
+      const ezUInt32 value = sourceData[idx];
+      minA = ezMath::Min(minA, value);
+      maxA = ezMath::Max(maxA, value);
+
+      if (value > 0 && value < 255)
+      {
+        minA_greater0 = ezMath::Min(minA_greater0, value);
+        maxA_less255 = ezMath::Max(maxA_less255, value);
+      }
+    }
+
+    bestA0 = maxA;
+    bestA1 = minA;
+    ezUInt32 bestError = findPaletteIndicesBC4(sourceData, bestA0, bestA1, bestIndices);
+
+    if (quality == ezBlockCompressionQuality::Fast || bestError == 0)
+      return;
+
+    ezUInt8 indices[16];
+    auto tryPalette = [&](ezUInt32 a0, ezUInt32 a1) {
+      const ezUInt32 error = findPaletteIndicesBC4(sourceData, a0, a1, indices);
+      if (error < bestError)
+      {
+        bestError = error;
+        bestA0 = a0;
+        bestA1 = a1;
+        memcpy(bestIndices, indices, 16);
+        return true;
+      }
+      return false;
+    };
+
+    for (ezUInt32 iteration = 0; iteration < 2; ++iteration)
+    {
+      ezUInt32 a0, a1;
+      if (!refineEndpointsBC4(sourceData, bestIndices, a0, a1) || !tryPalette(a0, a1))
+        break;
+    }
+
+    // Search the direct neighborhood of the best 8 value palette
+    const ezInt32 centerA0 = bestA0;
+    const ezInt32 centerA1 = bestA1;
+    for (ezInt32 a0 = ezMath::Max(centerA0 - 1, 1); a0 <= ezMath::Min(centerA0 + 1, 255); ++a0)
+    {
+      for (ezInt32 a1 = ezMath::Max(centerA1 - 1, 0); a1 <= ezMath::Min(centerA1 + 1, a0 - 1); ++a1)
+      {
+        tryPalette(a0, a1);
+      }
+    }
+
+    // The 6 value palette contains exact 0 and 255, which helps blocks that contain those values
+    if ((minA == 0 || maxA == 255) && minA_greater0 <= maxA_less255)
+    {
+      tryPalette(minA_greater0, maxA_less255);
+    }
+  }
+
 
   // The following BC6 + BC7 decompression implementations were adapted from
   // https://github.com/Microsoft/DirectXTex/blob/master/DirectXTex/BC6HBC7.cpp
@@ -1689,9 +1828,53 @@ EZ_TEXTURE_DLL void ezDecompressBlockBC7(const ezUInt8* pSource, ezColorBaseUB*
   }
 } // namespace
 
+void ezCompressBlockBC4(const ezUInt8* pSource, ezUInt32 uiStride, ezUInt8* pTarget, ezUInt8 bias, ezBlockCompressionQuality::Enum quality)
+{
+  // Bias to shift signed data into unsigned range so we can treat it the same as unsigned
+  ezUInt8 sourceBlock[16];
+  for (ezUInt32 idx = 0; idx < 16; ++idx)
+  {
+    sourceBlock[idx] = pSource[idx * uiStride] + bias;
+  }
+
+#if defined(EZ_SUPPORTS_BC4_COMPRESSOR)
+  if (quality == ezBlockCompressionQuality::High)
+  {
+    ezUInt32 a0, a1;
+    findBestPaletteBC4(sourceBlock, a0, a1);
+    packBlockBC4(sourceBlock, a0, a1, pTarget);
+  }
+  else
+#endif
+  {
+    ezUInt32 a0, a1;
+    ezUInt8 indices[16];
+    findPaletteBC4(sourceBlock, quality, a0, a1, indices);
+    writeBlockBC4(a0, a1, indices, pTarget);
+  }
+
+  // Undo biasing for signed formats by shifting palette upper and lower bound back into signed range
+  pTarget[0] -= bias;
+  pTarget[1] -= bias;
+}
+
+const ezUInt8* ezGetPartitionTableBC7(ezUInt32 uiNumSubsets, ezUInt32 uiShape)
+{
+  EZ_ASSERT_DEV(uiNumSubsets >= 1 && uiNumSubsets <= s_bc7MaxRegions && uiShape < s_bc7MaxShapes, "Invalid BC7 partition");
+  return s_bc67PartitionTable[uiNumSubsets - 1][uiShape];
+}
+
+ezUInt32 ezGetAnchorIndexBC7(ezUInt32 uiNumSubsets, ezUInt32 uiShape, ezUInt32 uiSubset)
+{
+  EZ_ASSERT_DEV(uiNumSubsets >= 1 && uiNumSubsets <= s_bc7MaxRegions && uiShape < s_bc7MaxShapes && uiSubset < uiNumSubsets, "Invalid BC7 partition");
+  return s_bc67FixUp[uiNumSubsets - 1][uiShape][uiSubset];
+}
+
 class ezImageConversion_BC1_RGBA : public ezImageConversionStepDecompressBlocks
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_BC1_RGBA"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -1727,6 +1910,8 @@ public:
 class ezImageConversion_BC2_RGBA : public ezImageConversionStepDecompressBlocks
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_BC2_RGBA"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -1775,6 +1960,8 @@ public:
 class ezImageConversion_BC3_RGBA : public ezImageConversionStepDecompressBlocks
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_BC3_RGBA"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -1816,6 +2003,8 @@ public:
 class ezImageConversion_BC4_R : public ezImageConversionStepDecompressBlocks
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_BC4_R"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -1863,6 +2052,8 @@ public:
 class ezImageConversion_BC5_RG : public ezImageConversionStepDecompressBlocks
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_BC5_RG"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -1912,6 +2103,8 @@ public:
 class ezImageConversion_BC6_RGB : public ezImageConversionStepDecompressBlocks
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_BC6_RGB"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -1951,6 +2144,8 @@ public:
 class ezImageConversion_BC7_RGBA : public ezImageConversionStepDecompressBlocks
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_BC7_RGBA"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -1980,143 +2175,6 @@ public:
   }
 };
 
-#if defined(EZ_SUPPORTS_BC4_COMPRESSOR)
-class ezImageConversion_CompressBC4 : public ezImageConversionStepCompressBlocks
-{
-  virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
-  {
-    static ezImageConversionEntry supportedConversions[] = {
-        ezImageConversionEntry(ezImageFormat::R8_UNORM, ezImageFormat::BC4_UNORM, ezImageConversionFlags::Default),
-        ezImageConversionEntry(ezImageFormat::R8_SNORM, ezImageFormat::BC4_SNORM, ezImageConversionFlags::Default),
-        ezImageConversionEntry(ezImageFormat::R8G8_UNORM, ezImageFormat::BC4_UNORM, ezImageConversionFlags::Default),
-        ezImageConversionEntry(ezImageFormat::R8G8_SNORM, ezImageFormat::BC4_SNORM, ezImageConversionFlags::Default),
-        ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC4_UNORM, ezImageConversionFlags::Default),
-        ezImageConversionEntry(ezImageFormat::R8G8B8A8_SNORM, ezImageFormat::BC4_SNORM, ezImageConversionFlags::Default),
-    };
-    return supportedConversions;
-  }
-
-  virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
-                                  ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) const override
-  {
-    ezUInt32 stride = ezImageFormat::GetBitsPerPixel(sourceFormat) / 8;
-    ezUInt64 rowPitch = ezImageFormat::GetRowPitch(sourceFormat, 4 * numBlocksX);
-
-    // Bias to shift signed data into unsigned range so we can treat it the same as unsigned
-    ezUInt8 bias = 0;
-    if (ezImageFormat::GetDataType(sourceFormat) == ezImageFormatDataType::SNORM)
-    {
-      bias = 128;
-    }
-
-    for (ezUInt32 blockY = 0; blockY < numBlocksY; ++blockY)
-    {
-      for (ezUInt32 blockX = 0; blockX < numBlocksX; ++blockX)
-      {
-        ezUInt8 sourceBlock[16];
-
-        for (ezUInt32 y = 0; y < 4; ++y)
-        {
-          const ezUInt8* sourcePointer = static_cast<const ezUInt8*>(source.GetPtr()) + (4 * blockY + y) * rowPitch;
-
-          for (ezUInt32 x = 0; x < 4; ++x)
-          {
-            sourceBlock[4 * y + x] = sourcePointer[(x + 4 * blockX) * stride] + bias;
-          }
-        }
-
-        ezUInt32 a0, a1;
-        findBestPaletteBC4(sourceBlock, a0, a1);
-
-        ezUInt8* targetPointer = static_cast<ezUInt8*>(target.GetPtr()) + (blockY * numBlocksX + blockX) * 8;
-        packBlockBC4(sourceBlock, a0, a1, targetPointer);
-
-        targetPointer[0] -= bias;
-        targetPointer[1] -= bias;
-      }
-    }
-
-    return EZ_SUCCESS;
-  }
-};
-
-class ezImageConversion_CompressBC5 : public ezImageConversionStepCompressBlocks
-{
-  virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
-  {
-    static ezImageConversionEntry supportedConversions[] = {
-        ezImageConversionEntry(ezImageFormat::R8G8_UNORM, ezImageFormat::BC5_UNORM, ezImageConversionFlags::Default),
-        ezImageConversionEntry(ezImageFormat::R8G8_SNORM, ezImageFormat::BC5_SNORM, ezImageConversionFlags::Default),
-        ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC5_UNORM, ezImageConversionFlags::Default),
-        ezImageConversionEntry(ezImageFormat::R8G8B8A8_SNORM, ezImageFormat::BC5_SNORM, ezImageConversionFlags::Default),
-    };
-    return supportedConversions;
-  }
-
-  virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
-                                  ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) const override
-  {
-    ezUInt32 stride = ezImageFormat::GetBitsPerPixel(sourceFormat) / 8;
-    ezUInt64 rowPitch = ezImageFormat::GetRowPitch(sourceFormat, 4 * numBlocksX);
-
-    // Bias to shift signed data into unsigned range so we can treat it the same as unsigned
-    ezUInt8 bias = 0;
-    if (ezImageFormat::GetDataType(sourceFormat) == ezImageFormatDataType::SNORM)
-    {
-      bias = 128;
-    }
-
-    for (ezUInt32 blockY = 0; blockY < numBlocksY; ++blockY)
-    {
-      for (ezUInt32 blockX = 0; blockX < numBlocksX; ++blockX)
-      {
-        ezUInt8 sourceBlockR[16];
-        ezUInt8 sourceBlockG[16];
-
-        for (ezUInt32 y = 0; y < 4; ++y)
-        {
-          const ezUInt8* sourcePointer = static_cast<const ezUInt8*>(source.GetPtr()) + (4 * blockY + y) * rowPitch;
-
-          for (ezUInt32 x = 0; x < 4; ++x)
-          {
-            sourceBlockR[4 * y + x] = sourcePointer[(x + 4 * blockX) * stride + 0] + bias;
-            sourceBlockG[4 * y + x] = sourcePointer[(x + 4 * blockX) * stride + 1] + bias;
-          }
-        }
-
-        ezUInt8* targetPointer = static_cast<ezUInt8*>(target.GetPtr()) + (blockY * numBlocksX + blockX) * 16;
-
-        {
-          ezUInt32 a0, a1;
-          findBestPaletteBC4(sourceBlockR, a0, a1);
-          packBlockBC4(sourceBlockR, a0, a1, targetPointer);
-
-          // Undo biasing for signed formats by shifting palette upper and lower bound back into signed range
-          targetPointer[0] -= bias;
-          targetPointer[1] -= bias;
-        }
-
-        {
-          ezUInt32 a0, a1;
-          findBestPaletteBC4(sourceBlockG, a0, a1);
-          packBlockBC4(sourceBlockG, a0, a1, targetPointer + 8);
-
-          // Undo biasing for signed formats by shifting palette upper and lower bound back into signed range
-          targetPointer[8] -= bias;
-          targetPointer[9] -= bias;
-        }
-      }
-    }
-
-    return EZ_SUCCESS;
-  }
-};
-
-static ezImageConversion_CompressBC4 s_conversion_compressBC4;
-static ezImageConversion_CompressBC5 s_conversion_compressBC5;
-
-#endif
-
 static ezImageConversion_BC1_RGBA s_conversion_BC1_RGBA;
 static ezImageConversion_BC2_RGBA s_conversion_BC2_RGBA;
 static ezImageConversion_BC3_RGBA s_conversion_BC3_RGBA;
@@ -4,6 +4,23 @@
 
 class ezColorLinear16f;
 
+/// \brief Trade-off between speed and quality for the CPU block compressors.
+struct ezBlockCompressionQuality
+{
+  typedef ezUInt8 StorageType;
+
+  enum Enum
+  {
+    Fast, ///< Derives the endpoints from the principal axis of each block and computes the indices once.
+    High, ///< Additionally refines the endpoints with least squares fits and, for BC7, searches more modes and partitions.
+
+    Default = High
+  };
+};
+
+/// \brief The quality that ezImageConversion uses for the CPU block compressors, selected with the 'texture.FastBlockCompression' cvar.
+EZ_TEXTURE_DLL ezBlockCompressionQuality::Enum ezGetBlockCompressionQuality();
+
 EZ_TEXTURE_DLL void ezDecompressBlockBC1(const ezUInt8* pSource, ezColorBaseUB* pTarget, bool bForceFourColorMode);
 EZ_TEXTURE_DLL void ezDecompressBlockBC4(const ezUInt8* pSource, ezUInt8* pTarget, ezUInt32 uiStride, ezUInt8 bias);
 EZ_TEXTURE_DLL void ezDecompressBlockBC6(const ezUInt8* pSource, ezColorLinear16f* pTarget, bool isSigned);
@@ -11,3 +28,20 @@ EZ_TEXTURE_DLL void ezDecompressBlockBC7(const ezUInt8* pSource, ezColorBaseUB*
 
 EZ_TEXTURE_DLL void ezUnpackPaletteBC4(ezUInt32 a0, ezUInt32 a1, ezUInt32* alphas);
 
+/// \brief Compresses 4x4 pixels into a BC1 block. Pixels with an alpha value below 128 are encoded as transparent.
+EZ_TEXTURE_DLL void ezCompressBlockBC1(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality);
+
+/// \brief Compresses 4x4 pixels into a BC3 block.
+EZ_TEXTURE_DLL void ezCompressBlockBC3(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality);
+
+/// \brief Compresses 16 values, which are uiStride bytes apart, into a BC4 block. A bias of 128 is used for signed data.
+EZ_TEXTURE_DLL void ezCompressBlockBC4(const ezUInt8* pSource, ezUInt32 uiStride, ezUInt8* pTarget, ezUInt8 bias, ezBlockCompressionQuality::Enum quality);
+
+/// \brief Compresses 4x4 pixels into a BC7 block.
+EZ_TEXTURE_DLL void ezCompressBlockBC7(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality);
+
+/// \brief Returns the subset of each pixel for the given BC7 partition shape. uiNumSubsets must be 1, 2 or 3.
+EZ_TEXTURE_DLL const ezUInt8* ezGetPartitionTableBC7(ezUInt32 uiNumSubsets, ezUInt32 uiShape);
+
+/// \brief Returns the index of the anchor pixel of the given subset, whose index is stored with one bit less.
+EZ_TEXTURE_DLL ezUInt32 ezGetAnchorIndexBC7(ezUInt32 uiNumSubsets, ezUInt32 uiShape, ezUInt32 uiSubset);
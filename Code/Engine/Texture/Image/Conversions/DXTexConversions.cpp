@@ -319,6 +319,8 @@ EZ_END_SUBSYSTEM_DECLARATION;
 class ezImageConversion_CompressDxTex : public ezImageConversionStepCompressBlocks
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_CompressDxTex"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     return DeviceAndConversionTable::getDeviceAndConversionTable()->getConvertors();
@@ -170,6 +170,9 @@ ezUInt16 ezCompressA1B5G5R5(ezColorBaseUB color)
 template <ezColorBaseUB (*decompressFunc)(ezUInt16), ezImageFormat::Enum templateSourceFormat>
 class ezImageConversionStep_Decompress16bpp : ezImageConversionStepLinear
 {
+  // all instances share the name, the formats tell them apart
+  virtual const char* GetName() const override { return "ezImageConversionStep_Decompress16bpp"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     ezImageFormat::Enum sourceFormatSrgb = ezImageFormat::AsSrgb(templateSourceFormat);
@@ -209,6 +212,9 @@ class ezImageConversionStep_Decompress16bpp : ezImageConversionStepLinear
 template <ezUInt16 (*compressFunc)(ezColorBaseUB), ezImageFormat::Enum templateTargetFormat>
 class ezImageConversionStep_Compress16bpp : ezImageConversionStepLinear
 {
+  // all instances share the name, the formats tell them apart
+  virtual const char* GetName() const override { return "ezImageConversionStep_Compress16bpp"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     ezImageFormat::Enum targetFormatSrgb = ezImageFormat::AsSrgb(templateTargetFormat);
@@ -256,6 +262,8 @@ static bool IsAligned(const void* pointer)
 
 struct ezImageSwizzleConversion32_2103 : public ezImageConversionStepLinear
 {
+  virtual const char* GetName() const override { return "ezImageSwizzleConversion32_2103"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -347,6 +355,8 @@ struct ezImageSwizzleConversion32_2103 : public ezImageConversionStepLinear
 
 struct ezImageConversion_BGRX_BGRA : public ezImageConversionStepLinear
 {
+  virtual const char* GetName() const override { return "ezImageConversion_BGRX_BGRA"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -410,6 +420,8 @@ struct ezImageConversion_BGRX_BGRA : public ezImageConversionStepLinear
 class ezImageConversion_F32_U8 : public ezImageConversionStepLinear
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_F32_U8"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -506,6 +518,8 @@ public:
 class ezImageConversion_F32_sRGB : public ezImageConversionStepLinear
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_F32_sRGB"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -539,6 +553,8 @@ public:
 class ezImageConversion_F32_U16 : public ezImageConversionStepLinear
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_F32_U16"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -579,6 +595,8 @@ public:
 class ezImageConversion_F32_F16 : public ezImageConversionStepLinear
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_F32_F16"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -619,6 +637,8 @@ class ezImageConversion_F32_S8 : public ezImageConversionStepLinear
 {
 public:
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_F32_S8"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -658,6 +678,8 @@ public:
 class ezImageConversion_U8_F32 : public ezImageConversionStepLinear
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_U8_F32"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -697,6 +719,8 @@ public:
 class ezImageConversion_sRGB_F32 : public ezImageConversionStepLinear
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_sRGB_F32"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -730,6 +754,8 @@ public:
 class ezImageConversion_U16_F32 : public ezImageConversionStepLinear
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_U16_F32"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -769,6 +795,8 @@ public:
 class ezImageConversion_F16_F32 : public ezImageConversionStepLinear
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_F16_F32"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -807,6 +835,8 @@ public:
 class ezImageConversion_S8_F32 : public ezImageConversionStepLinear
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_S8_F32"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -845,6 +875,8 @@ public:
 struct ezImageConversion_Pad_To_RGBA_U8 : public ezImageConversionStepLinear
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_Pad_To_RGBA_U8"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -922,6 +954,8 @@ public:
 struct ezImageConversion_Pad_To_RGBA_F32 : public ezImageConversionStepLinear
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_Pad_To_RGBA_F32"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -966,6 +1000,8 @@ public:
 struct ezImageConversion_DiscardChannels : public ezImageConversionStepLinear
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_DiscardChannels"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -1073,6 +1109,8 @@ public:
 class ezImageConversion_FLOAT_to_R11G11B10 : public ezImageConversionStepLinear
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_FLOAT_to_R11G11B10"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -1209,6 +1247,8 @@ public:
 class ezImageConversion_R11G11B10_to_FLOAT : public ezImageConversionStepLinear
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_R11G11B10_to_FLOAT"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -1355,6 +1395,8 @@ public:
 class ezImageConversion_R11G11B10_to_HALF : public ezImageConversionStepLinear
 {
 public:
+  virtual const char* GetName() const override { return "ezImageConversion_R11G11B10_to_HALF"; }
+
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
   {
     static ezImageConversionEntry supportedConversions[] = {
@@ -46,6 +46,11 @@ public:
   ///
   /// \note The returned array must have the same entries each time this method is called.
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const = 0;
+
+  /// \brief Returns a name that identifies the implementation of this step, e.g. to tell apart two encoders for the same formats.
+  ///
+  /// The name must stay the same across runs, since it is used to look up cached conversion results.
+  virtual const char* GetName() const = 0;
 };
 
 /// \brief Interface for a single image conversion step where both the source and target format are uncompressed.
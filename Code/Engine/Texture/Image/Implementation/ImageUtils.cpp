@@ -3,6 +3,7 @@
 #include <Texture/Image/ImageUtils.h>
 
 #include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Texture/Image/ImageConversion.h>
 #include <Texture/Image/ImageEnums.h>
 #include <Texture/Image/ImageFilter.h>
@@ -648,6 +649,68 @@ inline static void FilterLine(ezUInt32 numSourceElements, const ezSimdVec4f* __r
   }
 }
 
+// Filters a line of target pixels along the vertical or depth axis by summing up entire rows of the source image.
+// The accumulation order is the same as in FilterLine, but all memory accesses are linear.
+static void FilterRows(ezUInt32 numSourceRows, const ezSimdVec4f* __restrict sourceBegin, ezSimdVec4f* __restrict targetBegin,
+  ezUInt32 rowStride, ezUInt32 numElements, ezUInt32 targetRowIndex, const ezImageFilterWeights& weights, ezInt32 firstSourceIdx,
+  ezImageAddressMode::Enum addressMode, const ezSimdVec4f& borderColor)
+{
+  const ezUInt32 numWeights = weights.GetNumWeights();
+  const auto weightsView = weights.ViewWeights();
+  const ezUInt32 numTargetRowsReduced = static_cast<ezUInt32>(weightsView.GetCount()) / numWeights;
+  const float* __restrict rowWeights = weightsView.GetPtr() + (targetRowIndex % numTargetRowsReduced) * numWeights;
+
+  ezHybridArray<const ezSimdVec4f*, 32> sourceRows;
+  sourceRows.SetCountUninitialized(numWeights);
+  for (ezUInt32 weightIdx = 0; weightIdx < numWeights; ++weightIdx)
+  {
+    bool useBorderColor = false;
+    const ezUInt32 sourceIdx = ezImageUtils::GetSampleIndex(numSourceRows, firstSourceIdx + ezInt32(weightIdx), addressMode, useBorderColor);
+    sourceRows[weightIdx] = useBorderColor ? nullptr : sourceBegin + sourceIdx * rowStride;
+  }
+
+  // Work on chunks that stay in the L1 cache while all source rows are added
+  const ezUInt32 chunkSize = 256;
+  for (ezUInt32 chunkStart = 0; chunkStart < numElements; chunkStart += chunkSize)
+  {
+    const ezUInt32 chunkEnd = ezMath::Min(chunkStart + chunkSize, numElements);
+
+    for (ezUInt32 x = chunkStart; x < chunkEnd; ++x)
+    {
+      targetBegin[x].SetZero();
+    }
+
+    for (ezUInt32 weightIdx = 0; weightIdx < numWeights; ++weightIdx)
+    {
+      const ezSimdVec4f weight(rowWeights[weightIdx]);
+      const ezSimdVec4f* __restrict sourceRow = sourceRows[weightIdx];
+
+      if (sourceRow == nullptr)
+      {
+        for (ezUInt32 x = chunkStart; x < chunkEnd; ++x)
+        {
+          targetBegin[x] = ezSimdVec4f::MulAdd(borderColor, weight, targetBegin[x]);
+        }
+      }
+      else
+      {
+        for (ezUInt32 x = chunkStart; x < chunkEnd; ++x)
+        {
+          targetBegin[x] = ezSimdVec4f::MulAdd(sourceRow[x], weight, targetBegin[x]);
+        }
+      }
+    }
+  }
+}
+
+// Processes small images on a single thread, where the task overhead would dominate
+static ezParallelForParams GetScaleParallelForParams(ezUInt32 numPixelsPerItem)
+{
+  ezParallelForParams params;
+  params.uiBinSize = ezMath::Max(1u, 16384u / ezMath::Max(1u, numPixelsPerItem));
+  return params;
+}
+
 static void DownScaleFastLine(
   ezUInt32 pixelStride, const ezUInt8* src, ezUInt8* dest, ezUInt32 lengthIn, ezUInt32 strideIn, ezUInt32 lengthOut, ezUInt32 strideOut)
 {
@@ -938,22 +1001,25 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetWidth(width);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 z = 0; z < originalDepth; ++z)
+    const ezSimdVec4f borderColorSimd(borderColor.r, borderColor.g, borderColor.b, borderColor.a);
+    const ezUInt32 numRows = numArrayElements * numFaces * originalDepth * originalHeight;
+
+    ezTaskSystem::ParallelForIndexed(
+      0, numRows,
+      [&](ezUInt32 uiStartRow, ezUInt32 uiEndRow) {
+        for (ezUInt32 row = uiStartRow; row < uiEndRow; ++row)
         {
-          for (ezUInt32 y = 0; y < originalHeight; ++y)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
-            FilterLine(originalWidth, filterSource, filterTarget, 1, weights, firstSampleIndices, addressModeU,
-              ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
+          const ezUInt32 y = row % originalHeight;
+          const ezUInt32 z = (row / originalHeight) % originalDepth;
+          const ezUInt32 face = (row / (originalHeight * originalDepth)) % numFaces;
+          const ezUInt32 arrayIndex = row / (originalHeight * originalDepth * numFaces);
+
+          const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+          ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+          FilterLine(originalWidth, filterSource, filterTarget, 1, weights, firstSampleIndices, addressModeU, borderColorSimd);
         }
-      }
-    }
+      },
+      "ezImageUtils::Scale3D", GetScaleParallelForParams(originalWidth));
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -982,22 +1048,25 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetHeight(height);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 z = 0; z < originalDepth; ++z)
+    const ezSimdVec4f borderColorSimd(borderColor.r, borderColor.g, borderColor.b, borderColor.a);
+    const ezUInt32 numRows = numArrayElements * numFaces * originalDepth * height;
+
+    ezTaskSystem::ParallelForIndexed(
+      0, numRows,
+      [&](ezUInt32 uiStartRow, ezUInt32 uiEndRow) {
+        for (ezUInt32 row = uiStartRow; row < uiEndRow; ++row)
         {
-          for (ezUInt32 x = 0; x < width; ++x)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
-            FilterLine(originalHeight, filterSource, filterTarget, width, weights, firstSampleIndices, addressModeV,
-              ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
+          const ezUInt32 y = row % height;
+          const ezUInt32 z = (row / height) % originalDepth;
+          const ezUInt32 face = (row / (height * originalDepth)) % numFaces;
+          const ezUInt32 arrayIndex = row / (height * originalDepth * numFaces);
+
+          const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, 0, z);
+          ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+          FilterRows(originalHeight, filterSource, filterTarget, width, width, y, weights, firstSampleIndices[y], addressModeV, borderColorSimd);
         }
-      }
-    }
+      },
+      "ezImageUtils::Scale3D", GetScaleParallelForParams(width));
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -1026,22 +1095,25 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetDepth(depth);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 y = 0; y < height; ++y)
+    const ezSimdVec4f borderColorSimd(borderColor.r, borderColor.g, borderColor.b, borderColor.a);
+    const ezUInt32 numRows = numArrayElements * numFaces * depth * height;
+
+    ezTaskSystem::ParallelForIndexed(
+      0, numRows,
+      [&](ezUInt32 uiStartRow, ezUInt32 uiEndRow) {
+        for (ezUInt32 row = uiStartRow; row < uiEndRow; ++row)
         {
-          for (ezUInt32 x = 0; x < width; ++x)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
-            FilterLine(originalHeight, filterSource, filterTarget, width * height, weights, firstSampleIndices, addressModeW,
-              ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
+          const ezUInt32 y = row % height;
+          const ezUInt32 z = (row / height) % depth;
+          const ezUInt32 face = (row / (height * depth)) % numFaces;
+          const ezUInt32 arrayIndex = row / (height * depth * numFaces);
+
+          const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, 0);
+          ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+          FilterRows(originalDepth, filterSource, filterTarget, width * height, width, z, weights, firstSampleIndices[z], addressModeW, borderColorSimd);
         }
-      }
-    }
+      },
+      "ezImageUtils::Scale3D", GetScaleParallelForParams(width));
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -1168,22 +1240,31 @@ void ezImageUtils::RenormalizeNormalMap(ezImage& image)
 {
   EZ_ASSERT_DEV(image.GetImageFormat() == ezImageFormat::R32G32B32A32_FLOAT, "This algorithm currently expects a RGBA 32 Float as input");
 
-  ezSimdVec4f* start = image.GetBlobPtr<ezSimdVec4f>().GetPtr();
-  ezSimdVec4f* const end = image.GetBlobPtr<ezSimdVec4f>().GetEndPtr();
+  ezSimdVec4f* const pixels = image.GetBlobPtr<ezSimdVec4f>().GetPtr();
+  const ezUInt64 numPixels = image.GetBlobPtr<ezSimdVec4f>().GetCount();
 
-  ezSimdVec4f two(2.0f);
+  // Split into chunks of pixels, since the number of pixels may exceed the 32 bit range of the parallel for
+  const ezUInt32 chunkSize = 4096;
+  const ezUInt32 numChunks = static_cast<ezUInt32>((numPixels + chunkSize - 1) / chunkSize);
 
-  ezSimdVec4f minusOne(-1.0f);
+  ezTaskSystem::ParallelForIndexed(0, numChunks, [pixels, numPixels](ezUInt32 uiStartChunk, ezUInt32 uiEndChunk) {
+    ezSimdVec4f two(2.0f);
 
-  ezSimdVec4f half(0.5f);
+    ezSimdVec4f minusOne(-1.0f);
 
-  for (; start < end; start++)
-  {
-    ezSimdVec4f normal;
-    normal = ezSimdVec4f::MulAdd(*start, two, minusOne);
-    normal.Normalize<3>();
-    *start = ezSimdVec4f::MulAdd(half, normal, half);
-  }
+    ezSimdVec4f half(0.5f);
+
+    ezSimdVec4f* start = pixels + ezUInt64(uiStartChunk) * chunkSize;
+    ezSimdVec4f* const end = pixels + ezMath::Min(ezUInt64(uiEndChunk) * chunkSize, numPixels);
+
+    for (; start < end; start++)
+    {
+      ezSimdVec4f normal;
+      normal = ezSimdVec4f::MulAdd(*start, two, minusOne);
+      normal.Normalize<3>();
+      *start = ezSimdVec4f::MulAdd(half, normal, half);
+    }
+  }, "ezImageUtils::RenormalizeNormalMap");
 }
 
 void ezImageUtils::AdjustRoughness(ezImage& roughnessMap, const ezImageView& normalMap)
@@ -1,6 +1,11 @@
 #include <TexturePCH.h>
 
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Texture/Image/Formats/ImageFileFormat.h>
 #include <Texture/Image/ImageUtils.h>
+#include <Texture/TexConv/TexConvCache.h>
 #include <Texture/TexConv/TexConvProcessor.h>
 
 ezResult ezTexConvProcessor::LoadInputImages()
@@ -17,6 +22,8 @@ ezResult ezTexConvProcessor::LoadInputImages()
     return EZ_FAILURE;
   }
 
+  m_InputCacheKeys.Clear();
+
   if (!m_Descriptor.m_InputImages.IsEmpty())
   {
     // make sure the two arrays have the same size
@@ -27,6 +34,21 @@ ezResult ezTexConvProcessor::LoadInputImages()
     {
       tmp.Format("InputImage{}", ezArgI(i, 2, true));
       m_Descriptor.m_InputFiles[i] = tmp;
+
+      if (m_pCache != nullptr)
+      {
+        const ezImage& img = m_Descriptor.m_InputImages[i];
+
+        ezUInt64 uiKey = ezHashingUtils::xxHash64(img.GetByteBlobPtr().GetPtr(), img.GetByteBlobPtr().GetCount());
+        uiKey = ezTexConvCache::CombineKey(uiKey, img.GetImageFormat());
+        uiKey = ezTexConvCache::CombineKey(uiKey, img.GetWidth());
+        uiKey = ezTexConvCache::CombineKey(uiKey, img.GetHeight());
+        uiKey = ezTexConvCache::CombineKey(uiKey, img.GetDepth());
+        uiKey = ezTexConvCache::CombineKey(uiKey, img.GetNumMipLevels());
+        uiKey = ezTexConvCache::CombineKey(uiKey, img.GetNumFaces());
+        uiKey = ezTexConvCache::CombineKey(uiKey, img.GetNumArrayIndices());
+        m_InputCacheKeys.PushBack(uiKey);
+      }
     }
   }
   else
@@ -36,7 +58,7 @@ ezResult ezTexConvProcessor::LoadInputImages()
     for (const auto& file : m_Descriptor.m_InputFiles)
     {
       auto& img = m_Descriptor.m_InputImages.ExpandAndGetRef();
-      if (img.LoadFrom(file).Failed())
+      if (LoadInputImage(file, img, m_InputCacheKeys.ExpandAndGetRef()).Failed())
       {
         ezLog::Error("Could not load input file '{0}'.", file);
         return EZ_FAILURE;
@@ -58,6 +80,61 @@ ezResult ezTexConvProcessor::LoadInputImages()
   return EZ_SUCCESS;
 }
 
+ezResult ezTexConvProcessor::LoadInputImage(const char* szFile, ezImage& out_Image, ezUInt64& out_uiCacheKey)
+{
+  out_uiCacheKey = 0;
+
+  if (m_pCache == nullptr)
+    return out_Image.LoadFrom(szFile);
+
+  ezStopwatch sw;
+
+  // read the whole file once, to hash it and to decode it from memory on a cache miss
+  ezDynamicArray<ezUInt8> fileData;
+  {
+    ezFileReader file;
+    if (file.Open(szFile).Failed())
+    {
+      ezLog::Warning("Failed to open image file '{0}'", szFile);
+      return EZ_FAILURE;
+    }
+
+    fileData.SetCountUninitialized(static_cast<ezUInt32>(file.GetFileSize()));
+    if (file.ReadBytes(fileData.GetData(), fileData.GetCount()) != fileData.GetCount())
+    {
+      ezLog::Warning("Failed to read image file '{0}'", szFile);
+      return EZ_FAILURE;
+    }
+  }
+
+  // the extension decides which decoder is used
+  ezStringBuilder sExtension = ezPathUtils::GetFileExtension(szFile);
+  sExtension.ToLower();
+
+  out_uiCacheKey = ezHashingUtils::xxHash64(fileData.GetData(), fileData.GetCount());
+  out_uiCacheKey = ezHashingUtils::xxHash64(sExtension.GetData(), sExtension.GetElementCount(), out_uiCacheKey);
+
+  if (m_pCache->Retrieve(ezTexConvCacheStage::DecodedInput, out_uiCacheKey, out_Image))
+    return EZ_SUCCESS;
+
+  ezImageFileFormat* pFormat = ezImageFileFormat::GetReaderFormat(sExtension);
+  if (pFormat == nullptr)
+  {
+    ezLog::Warning("No known image file format for extension '{0}'", sExtension);
+    return EZ_FAILURE;
+  }
+
+  ezRawMemoryStreamReader reader(fileData.GetData(), fileData.GetCount());
+  if (pFormat->ReadImage(reader, out_Image, ezLog::GetThreadLocalLogSystem(), sExtension).Failed())
+  {
+    ezLog::Warning("Failed to read image file '{0}'", szFile);
+    return EZ_FAILURE;
+  }
+
+  m_pCache->Store(ezTexConvCacheStage::DecodedInput, out_uiCacheKey, out_Image, sw.GetRunningTotal());
+  return EZ_SUCCESS;
+}
+
 ezResult ezTexConvProcessor::ConvertAndScaleImage(const char* szImageName, ezImage& inout_Image, ezUInt32 uiResolutionX, ezUInt32 uiResolutionY)
 {
   if (inout_Image.Convert(ezImageFormat::R32G32B32A32_FLOAT).Failed())
@@ -1,7 +1,11 @@
 #include <TexturePCH.h>
 
 #include <Foundation/Reflection/ReflectionUtils.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Texture/Image/Conversions/DXTConversions.h>
+#include <Texture/Image/ImageConversion.h>
 #include <Texture/Image/ImageUtils.h>
+#include <Texture/TexConv/TexConvCache.h>
 #include <Texture/TexConv/TexConvProcessor.h>
 
 // clang=format off
@@ -58,49 +62,201 @@ ezResult ezTexConvProcessor::Process()
 
     ezLog::Info("Target resolution is '{} x {}'", uiTargetResolutionX, uiTargetResolutionY);
 
-    EZ_SUCCEED_OR_RETURN(ConvertAndScaleInputImages(uiTargetResolutionX, uiTargetResolutionY));
+    // the cached stages are checked from last to first, so that as much work as possible is skipped
+    ezUInt64 uiAssembledImageKey = 0;
+    ezUInt64 uiMipmapsKey = 0;
+    ezUInt64 uiOutputKey = 0;
 
-    EZ_SUCCEED_OR_RETURN(ClampInputValues(m_Descriptor.m_InputImages, m_Descriptor.m_fMaxValue));
-
-    if (m_Descriptor.m_Usage == ezTexConvUsage::BumpMap)
+    if (m_pCache != nullptr)
     {
-      EZ_SUCCEED_OR_RETURN(ConvertToNormalMap(m_Descriptor.m_InputImages));
-      m_Descriptor.m_Usage = ezTexConvUsage::NormalMap;
+      uiAssembledImageKey = ComputeAssembledImageKey(uiTargetResolutionX, uiTargetResolutionY, uiNumChannelsUsed);
+      uiMipmapsKey = ComputeMipmapsKey(uiAssembledImageKey);
+      uiOutputKey = ComputeOutputKey(uiMipmapsKey, OutputImageFormat);
     }
 
-    ezImage assembledImg;
-    if (m_Descriptor.m_OutputType == ezTexConvOutputType::Texture2D || m_Descriptor.m_OutputType == ezTexConvOutputType::None)
+    if (m_pCache == nullptr || !m_pCache->Retrieve(ezTexConvCacheStage::Output, uiOutputKey, m_OutputImage))
     {
-      EZ_SUCCEED_OR_RETURN(Assemble2DTexture(m_Descriptor.m_InputImages[0].GetHeader(), assembledImg));
+      ezStopwatch sw;
+      ezTime tPreviousStages;
 
-      EZ_SUCCEED_OR_RETURN(DilateColor2D(assembledImg));
-    }
-    else if (m_Descriptor.m_OutputType == ezTexConvOutputType::Cubemap)
-    {
-      EZ_SUCCEED_OR_RETURN(AssembleCubemap(assembledImg));
+      ezImage assembledImg;
+      if (m_pCache == nullptr || !m_pCache->Retrieve(ezTexConvCacheStage::Mipmaps, uiMipmapsKey, assembledImg))
+      {
+        if (m_pCache == nullptr || !m_pCache->Retrieve(ezTexConvCacheStage::AssembledImage, uiAssembledImageKey, assembledImg))
+        {
+          EZ_SUCCEED_OR_RETURN(AssembleImage(assembledImg, uiTargetResolutionX, uiTargetResolutionY));
+
+          if (m_pCache != nullptr)
+          {
+            m_pCache->Store(ezTexConvCacheStage::AssembledImage, uiAssembledImageKey, assembledImg, sw.GetRunningTotal());
+          }
+        }
+        else
+        {
+          tPreviousStages = m_pCache->GetProcessingTime(ezTexConvCacheStage::AssembledImage, uiAssembledImageKey);
+        }
+
+        EZ_SUCCEED_OR_RETURN(GenerateFinalMipmaps(assembledImg, uiNumChannelsUsed));
+
+        if (m_pCache != nullptr)
+        {
+          m_pCache->Store(ezTexConvCacheStage::Mipmaps, uiMipmapsKey, assembledImg, tPreviousStages + sw.GetRunningTotal());
+        }
+      }
+      else
+      {
+        tPreviousStages = m_pCache->GetProcessingTime(ezTexConvCacheStage::Mipmaps, uiMipmapsKey);
+      }
+
+      EZ_SUCCEED_OR_RETURN(GenerateOutput(std::move(assembledImg), m_OutputImage, OutputImageFormat));
+
+      if (m_pCache != nullptr)
+      {
+        m_pCache->Store(ezTexConvCacheStage::Output, uiOutputKey, m_OutputImage, tPreviousStages + sw.GetRunningTotal());
+      }
     }
-    else if (m_Descriptor.m_OutputType == ezTexConvOutputType::Volume)
+
+    if (m_Descriptor.m_Usage == ezTexConvUsage::BumpMap)
     {
-      EZ_SUCCEED_OR_RETURN(Assemble3DTexture(assembledImg));
+      // the input images have been converted to normal maps by AssembleImage(), or the cached result contains them
+      m_Descriptor.m_Usage = ezTexConvUsage::NormalMap;
     }
 
-    EZ_SUCCEED_OR_RETURN(AdjustHdrExposure(assembledImg));
+    EZ_SUCCEED_OR_RETURN(GenerateThumbnailOutput(m_OutputImage, m_ThumbnailOutputImage, m_Descriptor.m_uiThumbnailOutputResolution));
 
-    EZ_SUCCEED_OR_RETURN(GenerateMipmaps(assembledImg, 0,
-      uiNumChannelsUsed == 1 ? MipmapChannelMode::SingleChannel : MipmapChannelMode::AllChannels));
+    EZ_SUCCEED_OR_RETURN(GenerateLowResOutput(m_OutputImage, m_LowResOutputImage, m_Descriptor.m_uiLowResMipmaps));
+  }
 
-    EZ_SUCCEED_OR_RETURN(PremultiplyAlpha(assembledImg));
+  return EZ_SUCCESS;
+}
 
-    EZ_SUCCEED_OR_RETURN(GenerateOutput(std::move(assembledImg), m_OutputImage, OutputImageFormat));
+ezResult ezTexConvProcessor::AssembleImage(ezImage& out_Image, ezUInt32 uiResolutionX, ezUInt32 uiResolutionY)
+{
+  EZ_SUCCEED_OR_RETURN(ConvertAndScaleInputImages(uiResolutionX, uiResolutionY));
 
-    EZ_SUCCEED_OR_RETURN(GenerateThumbnailOutput(m_OutputImage, m_ThumbnailOutputImage, m_Descriptor.m_uiThumbnailOutputResolution));
+  EZ_SUCCEED_OR_RETURN(ClampInputValues(m_Descriptor.m_InputImages, m_Descriptor.m_fMaxValue));
 
-    EZ_SUCCEED_OR_RETURN(GenerateLowResOutput(m_OutputImage, m_LowResOutputImage, m_Descriptor.m_uiLowResMipmaps));
+  if (m_Descriptor.m_Usage == ezTexConvUsage::BumpMap)
+  {
+    EZ_SUCCEED_OR_RETURN(ConvertToNormalMap(m_Descriptor.m_InputImages));
+  }
+
+  if (m_Descriptor.m_OutputType == ezTexConvOutputType::Texture2D || m_Descriptor.m_OutputType == ezTexConvOutputType::None)
+  {
+    EZ_SUCCEED_OR_RETURN(Assemble2DTexture(m_Descriptor.m_InputImages[0].GetHeader(), out_Image));
+
+    EZ_SUCCEED_OR_RETURN(DilateColor2D(out_Image));
+  }
+  else if (m_Descriptor.m_OutputType == ezTexConvOutputType::Cubemap)
+  {
+    EZ_SUCCEED_OR_RETURN(AssembleCubemap(out_Image));
+  }
+  else if (m_Descriptor.m_OutputType == ezTexConvOutputType::Volume)
+  {
+    EZ_SUCCEED_OR_RETURN(Assemble3DTexture(out_Image));
   }
 
+  EZ_SUCCEED_OR_RETURN(AdjustHdrExposure(out_Image));
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezTexConvProcessor::GenerateFinalMipmaps(ezImage& inout_Image, ezUInt32 uiNumChannelsUsed) const
+{
+  EZ_SUCCEED_OR_RETURN(GenerateMipmaps(inout_Image, 0, uiNumChannelsUsed == 1 ? MipmapChannelMode::SingleChannel : MipmapChannelMode::AllChannels));
+
+  EZ_SUCCEED_OR_RETURN(PremultiplyAlpha(inout_Image));
+
   return EZ_SUCCESS;
 }
 
+ezUInt64 ezTexConvProcessor::ComputeAssembledImageKey(ezUInt32 uiResolutionX, ezUInt32 uiResolutionY, ezUInt32 uiNumChannelsUsed) const
+{
+  // increase this whenever the processing up to the assembled image changes its results
+  const ezUInt32 uiVersion = 1;
+
+  ezUInt64 uiKey = ezTexConvCache::CombineKey(0, uiVersion);
+
+  for (ezUInt32 i = 0; i < m_InputCacheKeys.GetCount(); ++i)
+  {
+    uiKey = ezTexConvCache::CombineKey(uiKey, m_InputCacheKeys[i]);
+
+    // ForceSRGBFormats() and DetectNumChannels() may have changed the format of the decoded image
+    uiKey = ezTexConvCache::CombineKey(uiKey, m_Descriptor.m_InputImages[i].GetImageFormat());
+  }
+
+  for (const ezTexConvSliceChannelMapping& mapping : m_Descriptor.m_ChannelMappings)
+  {
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      uiKey = ezTexConvCache::CombineKey(uiKey, mapping.m_Channel[i].m_iInputImageIndex);
+      uiKey = ezTexConvCache::CombineKey(uiKey, static_cast<ezInt32>(mapping.m_Channel[i].m_ChannelValue));
+    }
+  }
+
+  uiKey = ezTexConvCache::CombineKey(uiKey, m_Descriptor.m_OutputType);
+  uiKey = ezTexConvCache::CombineKey(uiKey, m_Descriptor.m_Usage);
+  uiKey = ezTexConvCache::CombineKey(uiKey, uiResolutionX);
+  uiKey = ezTexConvCache::CombineKey(uiKey, uiResolutionY);
+  uiKey = ezTexConvCache::CombineKey(uiKey, uiNumChannelsUsed);
+  uiKey = ezTexConvCache::CombineKey(uiKey, m_Descriptor.m_fMaxValue);
+  uiKey = ezTexConvCache::CombineKey(uiKey, m_Descriptor.m_BumpMapFilter);
+  uiKey = ezTexConvCache::CombineKey(uiKey, m_Descriptor.m_bFlipHorizontal);
+  uiKey = ezTexConvCache::CombineKey(uiKey, m_Descriptor.m_uiDilateColor);
+  uiKey = ezTexConvCache::CombineKey(uiKey, m_Descriptor.m_fHdrExposureBias);
+
+  return uiKey;
+}
+
+ezUInt64 ezTexConvProcessor::ComputeMipmapsKey(ezUInt64 uiAssembledImageKey) const
+{
+  // increase this whenever the mipmap generation changes its results
+  const ezUInt32 uiVersion = 1;
+
+  // the usage and the number of channels are already part of the assembled image key
+  ezUInt64 uiKey = ezTexConvCache::CombineKey(uiAssembledImageKey, uiVersion);
+  uiKey = ezTexConvCache::CombineKey(uiKey, m_Descriptor.m_MipmapMode);
+  uiKey = ezTexConvCache::CombineKey(uiKey, m_Descriptor.m_AddressModeU);
+  uiKey = ezTexConvCache::CombineKey(uiKey, m_Descriptor.m_AddressModeV);
+  uiKey = ezTexConvCache::CombineKey(uiKey, m_Descriptor.m_AddressModeW);
+  uiKey = ezTexConvCache::CombineKey(uiKey, m_Descriptor.m_bPreserveMipmapCoverage);
+  uiKey = ezTexConvCache::CombineKey(uiKey, m_Descriptor.m_fMipmapAlphaThreshold);
+  uiKey = ezTexConvCache::CombineKey(uiKey, m_Descriptor.m_bPremultiplyAlpha);
+
+  return uiKey;
+}
+
+ezUInt64 ezTexConvProcessor::ComputeOutputKey(ezUInt64 uiMipmapsKey, ezImageFormat::Enum outputFormat) const
+{
+  // increase this whenever the conversion to the output format changes its results
+  const ezUInt32 uiVersion = 1;
+
+  ezUInt64 uiKey = ezTexConvCache::CombineKey(uiMipmapsKey, uiVersion);
+  uiKey = ezTexConvCache::CombineKey(uiKey, outputFormat);
+  uiKey = ezTexConvCache::CombineKey(uiKey, ezGetBlockCompressionQuality());
+
+  // the output depends on which encoder does the conversion, e.g. the CPU block compressors or DirectXTex, which depends on the loaded plugins.
+  // GenerateOutput() always converts the float images that the earlier stages produce.
+  ezHybridArray<ezImageConversion::ConversionPathNode, 16> path;
+  ezUInt32 uiNumScratchBuffers = 0;
+  if (ezImageConversion::BuildPath(ezImageFormat::R32G32B32A32_FLOAT, outputFormat, true, path, uiNumScratchBuffers).Succeeded())
+  {
+    for (const auto& node : path)
+    {
+      // plain copies have no step
+      if (node.m_step != nullptr)
+      {
+        const char* szStepName = node.m_step->GetName();
+        uiKey = ezHashingUtils::xxHash64(szStepName, ezStringUtils::GetStringElementCount(szStepName), uiKey);
+      }
+
+      uiKey = ezTexConvCache::CombineKey(uiKey, node.m_targetFormat);
+    }
+  }
+
+  return uiKey;
+}
+
 ezResult ezTexConvProcessor::DetectNumChannels(ezArrayPtr<const ezTexConvSliceChannelMapping> channelMapping, ezUInt32& uiNumChannels)
 {
   uiNumChannels = 0;
@@ -0,0 +1,436 @@
+#include <TexturePCH.h>
+
+// TexturePCH.h maps DeleteFile to the Win32 function, which would break ezOSFile::DeleteFile
+#ifdef DeleteFile
+#  undef DeleteFile
+#endif
+
+#include <Foundation/Algorithm/Sorting.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Utilities/ConversionUtils.h>
+#include <Texture/TexConv/TexConvCache.h>
+
+namespace
+{
+  static const char* s_szIndexFile = "Index.ezTexConvCacheIndex";
+  static const char* s_szEntryExtension = "ezTexConvCache";
+
+  static const ezUInt8 s_uiIndexVersion = 1;
+  static const ezUInt8 s_uiEntryVersion = 1;
+
+  void WriteStats(ezStreamWriter& stream, const ezTexConvCacheStats& stats)
+  {
+    for (ezUInt32 stage = 0; stage < ezTexConvCacheStage::ENUM_COUNT; ++stage)
+    {
+      stream << stats.m_uiHits[stage];
+      stream << stats.m_uiMisses[stage];
+    }
+
+    stream << stats.m_uiEvictions;
+    stream << stats.m_TimeSaved;
+  }
+
+  void ReadStats(ezStreamReader& stream, ezTexConvCacheStats& stats)
+  {
+    for (ezUInt32 stage = 0; stage < ezTexConvCacheStage::ENUM_COUNT; ++stage)
+    {
+      stream >> stats.m_uiHits[stage];
+      stream >> stats.m_uiMisses[stage];
+    }
+
+    stream >> stats.m_uiEvictions;
+    stream >> stats.m_TimeSaved;
+  }
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+ezUInt32 ezTexConvCacheStats::GetNumHits() const
+{
+  ezUInt32 uiHits = 0;
+  for (ezUInt32 stage = 0; stage < ezTexConvCacheStage::ENUM_COUNT; ++stage)
+  {
+    uiHits += m_uiHits[stage];
+  }
+
+  return uiHits;
+}
+
+ezUInt32 ezTexConvCacheStats::GetNumLookups() const
+{
+  ezUInt32 uiLookups = GetNumHits();
+  for (ezUInt32 stage = 0; stage < ezTexConvCacheStage::ENUM_COUNT; ++stage)
+  {
+    uiLookups += m_uiMisses[stage];
+  }
+
+  return uiLookups;
+}
+
+float ezTexConvCacheStats::GetHitRate() const
+{
+  const ezUInt32 uiLookups = GetNumLookups();
+  return uiLookups > 0 ? static_cast<float>(GetNumHits()) / uiLookups : 0.0f;
+}
+
+void ezTexConvCacheStats::PrintReport(const char* szTitle) const
+{
+  EZ_LOG_BLOCK("TexConv Cache", szTitle);
+
+  const char* szStageNames[ezTexConvCacheStage::ENUM_COUNT] = {"Decoded inputs", "Assembled images", "Mipmaps", "Output"};
+
+  for (ezUInt32 stage = 0; stage < ezTexConvCacheStage::ENUM_COUNT; ++stage)
+  {
+    ezLog::Info("{}: {} hits, {} misses", szStageNames[stage], m_uiHits[stage], m_uiMisses[stage]);
+  }
+
+  ezLog::Info("Hit rate: {}%% of {} lookups", ezArgF(GetHitRate() * 100.0f, 1), GetNumLookups());
+  ezLog::Info("Time saved: {}", m_TimeSaved);
+  ezLog::Info("Evicted results: {}", m_uiEvictions);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezTexConvCache::ezTexConvCache() = default;
+
+ezTexConvCache::~ezTexConvCache()
+{
+  Close();
+}
+
+ezResult ezTexConvCache::Open(const char* szFolder, ezUInt64 uiMaxSizeInBytes)
+{
+  Close();
+
+  if (ezOSFile::CreateDirectoryStructure(szFolder).Failed())
+  {
+    ezLog::Error("Failed to create the TexConv cache folder '{}'", szFolder);
+    return EZ_FAILURE;
+  }
+
+  m_sFolder = szFolder;
+  m_uiMaxSize = uiMaxSizeInBytes;
+
+  LoadIndex();
+  AddUnindexedFiles();
+  EvictEntries(0);
+
+  return EZ_SUCCESS;
+}
+
+void ezTexConvCache::Close()
+{
+  if (!IsOpen())
+    return;
+
+  Save().IgnoreResult();
+
+  m_sFolder.Clear();
+  m_Entries.Clear();
+  m_uiCurrentSize = 0;
+  m_uiAccessCounter = 0;
+  m_SessionStats = ezTexConvCacheStats();
+  m_TotalStats = ezTexConvCacheStats();
+}
+
+ezResult ezTexConvCache::Save() const
+{
+  if (!IsOpen())
+    return EZ_FAILURE;
+
+  ezStringBuilder sPath = m_sFolder;
+  sPath.AppendPath(s_szIndexFile);
+
+  ezFileWriter file;
+  if (file.Open(sPath).Failed())
+  {
+    ezLog::Warning("Failed to write the TexConv cache index '{}'", sPath);
+    return EZ_FAILURE;
+  }
+
+  file << s_uiIndexVersion;
+  WriteStats(file, m_TotalStats);
+  file << m_uiAccessCounter;
+  file << m_Entries.GetCount();
+
+  for (auto it = m_Entries.GetIterator(); it.IsValid(); ++it)
+  {
+    file << it.Key();
+    file << it.Value().m_uiSize;
+    file << it.Value().m_uiLastAccess;
+    file << it.Value().m_ProcessingTime;
+  }
+
+  return EZ_SUCCESS;
+}
+
+void ezTexConvCache::ResetStats()
+{
+  m_SessionStats = ezTexConvCacheStats();
+  m_TotalStats = ezTexConvCacheStats();
+}
+
+bool ezTexConvCache::Retrieve(ezTexConvCacheStage::Enum stage, ezUInt64 uiKey, ezImage& out_Image)
+{
+  EZ_ASSERT_DEV(IsOpen(), "The cache has not been opened");
+
+  const ezUInt64 uiEntryKey = GetEntryKey(stage, uiKey);
+
+  auto it = m_Entries.Find(uiEntryKey);
+  if (!it.IsValid())
+  {
+    m_SessionStats.m_uiMisses[stage]++;
+    m_TotalStats.m_uiMisses[stage]++;
+    return false;
+  }
+
+  ezStringBuilder sPath;
+  GetEntryPath(uiEntryKey, sPath);
+
+  bool bValid = false;
+
+  ezFileReader file;
+  if (file.Open(sPath).Succeeded())
+  {
+    ezUInt8 uiVersion = 0;
+    ezUInt32 uiFormat = 0, uiWidth = 0, uiHeight = 0, uiDepth = 0, uiNumMipLevels = 0, uiNumFaces = 0, uiNumArrayIndices = 0;
+    ezUInt64 uiDataSize = 0;
+
+    file >> uiVersion;
+    file >> uiFormat;
+    file >> uiWidth;
+    file >> uiHeight;
+    file >> uiDepth;
+    file >> uiNumMipLevels;
+    file >> uiNumFaces;
+    file >> uiNumArrayIndices;
+    file >> uiDataSize;
+
+    if (uiVersion == s_uiEntryVersion && uiFormat < ezImageFormat::NUM_FORMATS)
+    {
+      ezImageHeader header;
+      header.SetImageFormat(static_cast<ezImageFormat::Enum>(uiFormat));
+      header.SetWidth(uiWidth);
+      header.SetHeight(uiHeight);
+      header.SetDepth(uiDepth);
+      header.SetNumMipLevels(uiNumMipLevels);
+      header.SetNumFaces(uiNumFaces);
+      header.SetNumArrayIndices(uiNumArrayIndices);
+
+      if (header.ComputeDataSize() == uiDataSize)
+      {
+        out_Image.ResetAndAlloc(header);
+        bValid = file.ReadBytes(out_Image.GetByteBlobPtr().GetPtr(), uiDataSize) == uiDataSize;
+      }
+    }
+  }
+
+  if (!bValid)
+  {
+    // deleted or corrupted by someone else, just treat it as a miss
+    RemoveEntry(uiEntryKey);
+
+    m_SessionStats.m_uiMisses[stage]++;
+    m_TotalStats.m_uiMisses[stage]++;
+    return false;
+  }
+
+  it.Value().m_uiLastAccess = ++m_uiAccessCounter;
+
+  m_SessionStats.m_uiHits[stage]++;
+  m_SessionStats.m_TimeSaved += it.Value().m_ProcessingTime;
+  m_TotalStats.m_uiHits[stage]++;
+  m_TotalStats.m_TimeSaved += it.Value().m_ProcessingTime;
+  return true;
+}
+
+void ezTexConvCache::Store(ezTexConvCacheStage::Enum stage, ezUInt64 uiKey, const ezImageView& image, ezTime processingTime)
+{
+  EZ_ASSERT_DEV(IsOpen(), "The cache has not been opened");
+
+  const ezUInt64 uiEntryKey = GetEntryKey(stage, uiKey);
+  RemoveEntry(uiEntryKey);
+
+  const ezUInt64 uiDataSize = image.GetByteBlobPtr().GetCount();
+  if (uiDataSize > m_uiMaxSize)
+    return;
+
+  EvictEntries(uiDataSize);
+
+  ezStringBuilder sPath;
+  GetEntryPath(uiEntryKey, sPath);
+
+  ezFileWriter file;
+  if (file.Open(sPath).Failed())
+  {
+    ezLog::Warning("Failed to write TexConv cache file '{}'", sPath);
+    return;
+  }
+
+  file << s_uiEntryVersion;
+  file << static_cast<ezUInt32>(image.GetImageFormat());
+  file << image.GetWidth();
+  file << image.GetHeight();
+  file << image.GetDepth();
+  file << image.GetNumMipLevels();
+  file << image.GetNumFaces();
+  file << image.GetNumArrayIndices();
+  file << uiDataSize;
+
+  if (file.WriteBytes(image.GetByteBlobPtr().GetPtr(), uiDataSize).Failed())
+  {
+    file.Close();
+    ezOSFile::DeleteFile(sPath).IgnoreResult();
+    return;
+  }
+
+  Entry& entry = m_Entries[uiEntryKey];
+  entry.m_uiSize = uiDataSize;
+  entry.m_uiLastAccess = ++m_uiAccessCounter;
+  entry.m_ProcessingTime = processingTime;
+
+  m_uiCurrentSize += uiDataSize;
+}
+
+ezTime ezTexConvCache::GetProcessingTime(ezTexConvCacheStage::Enum stage, ezUInt64 uiKey) const
+{
+  auto it = m_Entries.Find(GetEntryKey(stage, uiKey));
+  return it.IsValid() ? it.Value().m_ProcessingTime : ezTime::Zero();
+}
+
+ezUInt64 ezTexConvCache::GetEntryKey(ezTexConvCacheStage::Enum stage, ezUInt64 uiKey)
+{
+  return CombineKey(uiKey, static_cast<ezUInt8>(stage));
+}
+
+void ezTexConvCache::GetEntryPath(ezUInt64 uiEntryKey, ezStringBuilder& out_sPath) const
+{
+  out_sPath.Format("{}/{}.{}", m_sFolder, ezArgU(uiEntryKey, 16, true, 16, true), s_szEntryExtension);
+}
+
+void ezTexConvCache::LoadIndex()
+{
+  ezStringBuilder sPath = m_sFolder;
+  sPath.AppendPath(s_szIndexFile);
+
+  ezFileReader file;
+  if (file.Open(sPath).Failed())
+    return;
+
+  ezUInt8 uiVersion = 0;
+  file >> uiVersion;
+
+  if (uiVersion != s_uiIndexVersion)
+  {
+    ezLog::Warning("Ignoring TexConv cache index with unsupported version {}", uiVersion);
+    return;
+  }
+
+  ReadStats(file, m_TotalStats);
+  file >> m_uiAccessCounter;
+
+  ezUInt32 uiNumEntries = 0;
+  file >> uiNumEntries;
+
+  ezStringBuilder sEntryPath;
+  for (ezUInt32 i = 0; i < uiNumEntries; ++i)
+  {
+    ezUInt64 uiEntryKey = 0;
+    Entry entry;
+
+    file >> uiEntryKey;
+    file >> entry.m_uiSize;
+    file >> entry.m_uiLastAccess;
+    file >> entry.m_ProcessingTime;
+
+    // skip results that have been evicted by another process in the meantime
+    GetEntryPath(uiEntryKey, sEntryPath);
+    if (!ezOSFile::ExistsFile(sEntryPath))
+      continue;
+
+    m_Entries[uiEntryKey] = entry;
+    m_uiCurrentSize += entry.m_uiSize;
+  }
+}
+
+void ezTexConvCache::AddUnindexedFiles()
+{
+#if EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS) && EZ_ENABLED(EZ_SUPPORTS_FILE_STATS)
+  ezDynamicArray<ezFileStats> files;
+  ezOSFile::GatherAllItemsInFolder(files, m_sFolder, ezFileSystemIteratorFlags::ReportFiles);
+
+  for (const ezFileStats& stats : files)
+  {
+    ezStringView sName = stats.m_sName;
+    if (ezPathUtils::GetFileExtension(sName) != s_szEntryExtension)
+      continue;
+
+    ezUInt64 uiEntryKey = 0;
+    if (ezConversionUtils::ConvertHexStringToUInt64(ezPathUtils::GetFileName(sName), uiEntryKey).Failed())
+      continue;
+
+    if (m_Entries.Contains(uiEntryKey))
+      continue;
+
+    // the size on disk includes the small header, which doesn't matter for the size limit
+    Entry& entry = m_Entries[uiEntryKey];
+    entry.m_uiSize = stats.m_uiFileSize;
+    m_uiCurrentSize += entry.m_uiSize;
+  }
+#endif
+}
+
+void ezTexConvCache::RemoveEntry(ezUInt64 uiEntryKey)
+{
+  auto it = m_Entries.Find(uiEntryKey);
+  if (!it.IsValid())
+    return;
+
+  ezStringBuilder sPath;
+  GetEntryPath(uiEntryKey, sPath);
+  ezOSFile::DeleteFile(sPath).IgnoreResult();
+
+  m_uiCurrentSize -= it.Value().m_uiSize;
+  m_Entries.Remove(it);
+}
+
+void ezTexConvCache::EvictEntries(ezUInt64 uiRequiredSpace)
+{
+  if (m_uiCurrentSize + uiRequiredSpace <= m_uiMaxSize)
+    return;
+
+  struct EvictionCandidate
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt64 m_uiEntryKey;
+    ezUInt64 m_uiLastAccess;
+
+    bool operator<(const EvictionCandidate& other) const { return m_uiLastAccess < other.m_uiLastAccess; }
+  };
+
+  ezDynamicArray<EvictionCandidate> candidates;
+  candidates.Reserve(m_Entries.GetCount());
+
+  for (auto it = m_Entries.GetIterator(); it.IsValid(); ++it)
+  {
+    candidates.PushBack({it.Key(), it.Value().m_uiLastAccess});
+  }
+
+  candidates.Sort();
+
+  for (const EvictionCandidate& candidate : candidates)
+  {
+    if (m_uiCurrentSize + uiRequiredSpace <= m_uiMaxSize)
+      break;
+
+    RemoveEntry(candidate.m_uiEntryKey);
+
+    m_SessionStats.m_uiEvictions++;
+    m_TotalStats.m_uiEvictions++;
+  }
+}
+
+EZ_STATICLINK_FILE(Texture, Texture_TexConv_Implementation_TexConvCache);
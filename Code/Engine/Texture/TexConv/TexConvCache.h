@@ -0,0 +1,129 @@
+#pragma once
+
+#include <Texture/TextureDLL.h>
+
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Containers/Map.h>
+#include <Foundation/Strings/String.h>
+#include <Foundation/Time/Time.h>
+#include <Texture/Image/Image.h>
+
+/// \brief The stages of ezTexConvProcessor whose results can be cached.
+struct ezTexConvCacheStage
+{
+  enum Enum
+  {
+    DecodedInput,   ///< An input file decoded into an image.
+    AssembledImage, ///< The output channels assembled from the scaled and modified input images.
+    Mipmaps,        ///< The assembled image including all mipmaps.
+    Output,         ///< The image in the final output format.
+
+    ENUM_COUNT,
+    Default = DecodedInput
+  };
+
+  using StorageType = ezUInt8;
+};
+
+/// \brief Hit and miss counts of an ezTexConvCache.
+struct EZ_TEXTURE_DLL ezTexConvCacheStats
+{
+  ezUInt32 m_uiHits[ezTexConvCacheStage::ENUM_COUNT] = {};
+  ezUInt32 m_uiMisses[ezTexConvCacheStage::ENUM_COUNT] = {};
+  ezUInt32 m_uiEvictions = 0;
+
+  /// The processing time that was skipped thanks to cache hits, as measured when the results were stored.
+  ezTime m_TimeSaved;
+
+  ezUInt32 GetNumHits() const;
+  ezUInt32 GetNumLookups() const;
+
+  /// \brief Returns the fraction of lookups that were hits, in the range [0; 1].
+  float GetHitRate() const;
+
+  /// \brief Writes the hit rate per stage and the saved time to the log.
+  void PrintReport(const char* szTitle) const;
+};
+
+/// \brief A local on-disk cache for the intermediate and final results of ezTexConvProcessor.
+///
+/// Every result is stored under a key that combines a hash of the input bytes with all ezTexConvDesc settings that affect the stage.
+/// Re-exporting a texture with only some settings changed can thus skip all stages up to the first one that is affected.
+///
+/// The cache is limited in size, the least recently used results are deleted when a new result does not fit.
+/// The access order and the statistics are stored in an index file, which is written by Save() and when the cache is closed.
+/// Result files that are not part of the index, for example because another process wrote them in parallel, are added to the index
+/// as the least recently used entries when the cache is opened.
+class EZ_TEXTURE_DLL ezTexConvCache
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezTexConvCache);
+
+public:
+  ezTexConvCache();
+  ~ezTexConvCache();
+
+  /// \brief Opens or creates the cache in the given folder. Evicts results, if the cache is larger than uiMaxSizeInBytes.
+  ezResult Open(const char* szFolder, ezUInt64 uiMaxSizeInBytes);
+
+  /// \brief Writes the index and closes the cache.
+  void Close();
+
+  bool IsOpen() const { return !m_sFolder.IsEmpty(); }
+
+  /// \brief Writes the index file with the access order and the statistics.
+  ezResult Save() const;
+
+  /// \brief Reads the result of the given stage and key. Returns false, if it is not cached.
+  bool Retrieve(ezTexConvCacheStage::Enum stage, ezUInt64 uiKey, ezImage& out_Image);
+
+  /// \brief Stores the result of the given stage and key. processingTime is what a later hit will count as saved time.
+  ///
+  /// Results that are larger than the whole cache are not stored.
+  void Store(ezTexConvCacheStage::Enum stage, ezUInt64 uiKey, const ezImageView& image, ezTime processingTime);
+
+  /// \brief Returns the processing time that was stored with the given result, or zero if it is not cached.
+  ezTime GetProcessingTime(ezTexConvCacheStage::Enum stage, ezUInt64 uiKey) const;
+
+  /// \brief Statistics of all lookups since the cache was opened.
+  const ezTexConvCacheStats& GetSessionStats() const { return m_SessionStats; }
+
+  /// \brief Statistics of all lookups since the last call to ResetStats(), over all sessions that saved the index.
+  const ezTexConvCacheStats& GetTotalStats() const { return m_TotalStats; }
+
+  void ResetStats();
+
+  /// \brief Mixes the bytes of a plain value into a cache key.
+  template <typename T>
+  static ezUInt64 CombineKey(ezUInt64 uiKey, const T& value)
+  {
+    return ezHashingUtils::xxHash64(&value, sizeof(T), uiKey);
+  }
+
+  ezUInt32 GetNumEntries() const { return m_Entries.GetCount(); }
+  ezUInt64 GetCurrentSize() const { return m_uiCurrentSize; }
+  ezUInt64 GetMaxSize() const { return m_uiMaxSize; }
+
+private:
+  struct Entry
+  {
+    ezUInt64 m_uiSize = 0;
+    ezUInt64 m_uiLastAccess = 0;
+    ezTime m_ProcessingTime;
+  };
+
+  static ezUInt64 GetEntryKey(ezTexConvCacheStage::Enum stage, ezUInt64 uiKey);
+  void GetEntryPath(ezUInt64 uiEntryKey, ezStringBuilder& out_sPath) const;
+  void LoadIndex();
+  void AddUnindexedFiles();
+  void RemoveEntry(ezUInt64 uiEntryKey);
+  void EvictEntries(ezUInt64 uiRequiredSpace);
+
+  ezString m_sFolder;
+  ezUInt64 m_uiMaxSize = 0;
+  ezUInt64 m_uiCurrentSize = 0;
+  ezUInt64 m_uiAccessCounter = 0;
+  ezMap<ezUInt64, Entry> m_Entries;
+
+  ezTexConvCacheStats m_SessionStats;
+  ezTexConvCacheStats m_TotalStats;
+};
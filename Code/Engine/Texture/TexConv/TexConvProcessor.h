@@ -5,6 +5,7 @@
 #include <Texture/TexConv/TexConvDesc.h>
 
 struct ezTextureAtlasCreationDesc;
+class ezTexConvCache;
 
 class EZ_TEXTURE_DLL ezTexConvProcessor
 {
@@ -15,6 +16,9 @@ public:
 
   ezTexConvDesc m_Descriptor;
 
+  /// If set, decoded inputs, assembled images, mipmaps and the final output are looked up in and stored to this cache.
+  ezTexConvCache* m_pCache = nullptr;
+
   ezResult Process();
 
   ezImage m_OutputImage;
@@ -28,6 +32,7 @@ private:
   // Modifying the Descriptor
 
   ezResult LoadInputImages();
+  ezResult LoadInputImage(const char* szFile, ezImage& out_Image, ezUInt64& out_uiCacheKey);
   ezResult ForceSRGBFormats();
   ezResult ConvertAndScaleInputImages(ezUInt32 uiResolutionX, ezUInt32 uiResolutionY);
   ezResult ConvertToNormalMap(ezImage& bumpMap) const;
@@ -57,6 +62,18 @@ private:
 
   ezResult GenerateMipmaps(ezImage& img, ezUInt32 uiNumMips /*= 0*/, MipmapChannelMode channelMode = MipmapChannelMode::AllChannels) const;
 
+  //////////////////////////////////////////////////////////////////////////
+  // Pipeline stages that may be cached
+
+  ezResult AssembleImage(ezImage& out_Image, ezUInt32 uiResolutionX, ezUInt32 uiResolutionY);
+  ezResult GenerateFinalMipmaps(ezImage& inout_Image, ezUInt32 uiNumChannelsUsed) const;
+
+  ezUInt64 ComputeAssembledImageKey(ezUInt32 uiResolutionX, ezUInt32 uiResolutionY, ezUInt32 uiNumChannelsUsed) const;
+  ezUInt64 ComputeMipmapsKey(ezUInt64 uiAssembledImageKey) const;
+  ezUInt64 ComputeOutputKey(ezUInt64 uiMipmapsKey, ezImageFormat::Enum outputFormat) const;
+
+  ezHybridArray<ezUInt64, 4> m_InputCacheKeys;
+
   //////////////////////////////////////////////////////////////////////////
   // Purely functional
   static ezResult AdjustUsage(const char* szFilename, const ezImage& srcImg, ezEnum<ezTexConvUsage>& inout_Usage);
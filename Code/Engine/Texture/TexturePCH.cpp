@@ -26,6 +26,7 @@ EZ_STATICLINK_LIBRARY(Texture)
   EZ_STATICLINK_REFERENCE(Texture_DirectXTex_DirectXTexTGA);
   EZ_STATICLINK_REFERENCE(Texture_DirectXTex_DirectXTexUtil);
   EZ_STATICLINK_REFERENCE(Texture_DirectXTex_DirectXTexWIC);
+  EZ_STATICLINK_REFERENCE(Texture_Image_Conversions_BlockCompressionConversions);
   EZ_STATICLINK_REFERENCE(Texture_Image_Conversions_DXTConversions);
   EZ_STATICLINK_REFERENCE(Texture_Image_Conversions_DXTexConversions);
   EZ_STATICLINK_REFERENCE(Texture_Image_Conversions_PixelConversions);
@@ -47,6 +48,7 @@ EZ_STATICLINK_LIBRARY(Texture)
   EZ_STATICLINK_REFERENCE(Texture_TexConv_Implementation_InputFiles);
   EZ_STATICLINK_REFERENCE(Texture_TexConv_Implementation_OutputFormat);
   EZ_STATICLINK_REFERENCE(Texture_TexConv_Implementation_Processor);
+  EZ_STATICLINK_REFERENCE(Texture_TexConv_Implementation_TexConvCache);
   EZ_STATICLINK_REFERENCE(Texture_TexConv_Implementation_Texture2D);
   EZ_STATICLINK_REFERENCE(Texture_TexConv_Implementation_Texture3D);
   EZ_STATICLINK_REFERENCE(Texture_TexConv_Implementation_TextureAtlas);
@@ -0,0 +1,608 @@
+#include <UtilitiesPCH.h>
+
+#include <Foundation/Containers/HybridArray.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
+#include <Utilities/DataStructures/LooseOctree.h>
+
+namespace
+{
+  /// Marks stack entries whose node is entirely inside the query volume.
+  static constexpr ezUInt32 s_uiInsideFlag = 0x80000000;
+
+  /// The loose border is half the cell size, slightly enlarged so that rounding at cell borders can never put an object outside its node.
+  static constexpr float s_fLooseFactor = 0.5f * 1.001f;
+
+  /// Spreads the lower 10 bits of the value, such that there are two zero bits between each of them.
+  EZ_ALWAYS_INLINE ezUInt32 SpreadBits(ezUInt32 x)
+  {
+    x &= 0x000003FF;
+    x = (x | (x << 16)) & 0xFF0000FF;
+    x = (x | (x << 8)) & 0x0300F00F;
+    x = (x | (x << 4)) & 0x030C30C3;
+    x = (x | (x << 2)) & 0x09249249;
+    return x;
+  }
+
+  EZ_ALWAYS_INLINE ezUInt32 GetKeyLevel(ezUInt32 uiKey) { return ezMath::FirstBitHigh(uiKey) / 3; }
+
+  /// Nodes are culled against the bounding box of the query volume, objects against the exact volume.
+  struct BoxFilter
+  {
+    ezBoundingBox m_Bounds;
+    ezSimdVec4f m_MinX, m_MinY, m_MinZ, m_MaxX, m_MaxY, m_MaxZ;
+
+    BoxFilter(const ezBoundingBox& box)
+      : m_Bounds(box)
+      , m_MinX(box.m_vMin.x)
+      , m_MinY(box.m_vMin.y)
+      , m_MinZ(box.m_vMin.z)
+      , m_MaxX(box.m_vMax.x)
+      , m_MaxY(box.m_vMax.y)
+      , m_MaxZ(box.m_vMax.z)
+    {
+    }
+
+    EZ_ALWAYS_INLINE bool ContainsNode(const ezVec3& vMin, const ezVec3& vMax) const
+    {
+      return vMin.x >= m_Bounds.m_vMin.x && vMin.y >= m_Bounds.m_vMin.y && vMin.z >= m_Bounds.m_vMin.z && vMax.x <= m_Bounds.m_vMax.x &&
+             vMax.y <= m_Bounds.m_vMax.y && vMax.z <= m_Bounds.m_vMax.z;
+    }
+
+    EZ_ALWAYS_INLINE ezSimdVec4b OverlapsBlock(const float* pMinX, const float* pMinY, const float* pMinZ, const float* pMaxX,
+      const float* pMaxY, const float* pMaxZ) const
+    {
+      ezSimdVec4f minX, minY, minZ, maxX, maxY, maxZ;
+      minX.Load<4>(pMinX);
+      minY.Load<4>(pMinY);
+      minZ.Load<4>(pMinZ);
+      maxX.Load<4>(pMaxX);
+      maxY.Load<4>(pMaxY);
+      maxZ.Load<4>(pMaxZ);
+
+      return (minX <= m_MaxX) && (minY <= m_MaxY) && (minZ <= m_MaxZ) && (maxX >= m_MinX) && (maxY >= m_MinY) && (maxZ >= m_MinZ);
+    }
+  };
+
+  struct SphereFilter
+  {
+    ezBoundingBox m_Bounds;
+    ezVec3 m_vCenter;
+    float m_fRadiusSqr;
+    ezSimdVec4f m_CenterX, m_CenterY, m_CenterZ, m_RadiusSqr;
+
+    SphereFilter(const ezVec3& vCenter, float fRadius)
+      : m_vCenter(vCenter)
+      , m_fRadiusSqr(fRadius * fRadius)
+      , m_CenterX(vCenter.x)
+      , m_CenterY(vCenter.y)
+      , m_CenterZ(vCenter.z)
+      , m_RadiusSqr(fRadius * fRadius)
+    {
+      m_Bounds.SetCenterAndHalfExtents(vCenter, ezVec3(fRadius));
+    }
+
+    EZ_ALWAYS_INLINE bool ContainsNode(const ezVec3& vMin, const ezVec3& vMax) const
+    {
+      // the corner that is farthest away from the center
+      const ezVec3 vFarthest = (m_vCenter - vMin).Abs().CompMax((vMax - m_vCenter).Abs());
+      return vFarthest.GetLengthSquared() <= m_fRadiusSqr;
+    }
+
+    EZ_ALWAYS_INLINE ezSimdVec4b OverlapsBlock(const float* pMinX, const float* pMinY, const float* pMinZ, const float* pMaxX,
+      const float* pMaxY, const float* pMaxZ) const
+    {
+      ezSimdVec4f minX, minY, minZ, maxX, maxY, maxZ;
+      minX.Load<4>(pMinX);
+      minY.Load<4>(pMinY);
+      minZ.Load<4>(pMinZ);
+      maxX.Load<4>(pMaxX);
+      maxY.Load<4>(pMaxY);
+      maxZ.Load<4>(pMaxZ);
+
+      // distance from the center to the closest point of each box
+      const ezSimdVec4f dx = m_CenterX.CompMax(minX).CompMin(maxX) - m_CenterX;
+      const ezSimdVec4f dy = m_CenterY.CompMax(minY).CompMin(maxY) - m_CenterY;
+      const ezSimdVec4f dz = m_CenterZ.CompMax(minZ).CompMin(maxZ) - m_CenterZ;
+
+      // unused slots have inverted bounds, which end up infinitely far away
+      return dx.CompMul(dx) + dy.CompMul(dy) + dz.CompMul(dz) <= m_RadiusSqr;
+    }
+  };
+} // namespace
+
+ezLooseOctree::ezLooseOctree() = default;
+ezLooseOctree::~ezLooseOctree() = default;
+
+void ezLooseOctree::CreateTree(const ezVec3& vCenter, const ezVec3& vHalfExtents, float fMinNodeSize)
+{
+  const float fMax = ezMath::Max(vHalfExtents.x, ezMath::Max(vHalfExtents.y, vHalfExtents.z));
+  m_BBox.SetCenterAndHalfExtents(vCenter, ezVec3(fMax));
+
+  const float fLength = fMax * 2.0f;
+
+  m_uiMaxTreeDepth = 0;
+  while (m_uiMaxTreeDepth < s_uiMaxDepth && (fLength / (1u << m_uiMaxTreeDepth)) > fMinNodeSize)
+  {
+    ++m_uiMaxTreeDepth;
+  }
+
+  m_fCellsPerUnit = (1u << m_uiMaxTreeDepth) / fLength;
+
+  RemoveAllObjects();
+}
+
+ezUInt32 ezLooseOctree::InsertObject(const ezBoundingBox& bounds)
+{
+  EZ_ASSERT_DEV(!m_Nodes.IsEmpty(), "ezLooseOctree::InsertObject: You have to first create the tree.");
+
+  ezUInt32 uiObject;
+  if (!m_FreeObjects.IsEmpty())
+  {
+    uiObject = m_FreeObjects.PeekBack();
+    m_FreeObjects.PopBack();
+  }
+  else
+  {
+    uiObject = m_Objects.GetCount();
+    m_Objects.ExpandAndGetRef();
+  }
+
+  AddToNode(FindOrCreateNode(ComputeNodeKey(bounds), 1), uiObject, bounds);
+  ++m_uiNumObjects;
+
+  return uiObject;
+}
+
+void ezLooseOctree::RemoveObject(ezUInt32 uiObject)
+{
+  EZ_ASSERT_DEV(m_Objects[uiObject].m_uiNode != s_uiInvalidIndex, "Object {} has already been removed", uiObject);
+
+  RemoveFromNode(uiObject);
+  m_Objects[uiObject].m_uiNode = s_uiInvalidIndex;
+  m_FreeObjects.PushBack(uiObject);
+  --m_uiNumObjects;
+}
+
+void ezLooseOctree::RemoveAllObjects()
+{
+  m_Nodes.Clear();
+  m_FreeNodes.Clear();
+  m_Blocks.Clear();
+  m_FreeBlocks.Clear();
+  m_Objects.Clear();
+  m_FreeObjects.Clear();
+  m_uiNumObjects = 0;
+
+  // the tree has not been created yet
+  if (m_fCellsPerUnit == 0.0f)
+    return;
+
+  AllocateNode(s_uiInvalidIndex, 0);
+}
+
+void ezLooseOctree::MoveObject(ezUInt32 uiObject, const ezBoundingBox& newBounds)
+{
+  const ObjectData& data = m_Objects[uiObject];
+  EZ_ASSERT_DEV(data.m_uiNode != s_uiInvalidIndex, "Object {} has been removed", uiObject);
+
+  const ezUInt32 uiKey = ComputeNodeKey(newBounds);
+
+  if (m_Nodes[data.m_uiNode].m_uiKey == uiKey)
+  {
+    SetObjectBounds(data, newBounds);
+    return;
+  }
+
+  RemoveFromNode(uiObject);
+  AddToNode(FindOrCreateNode(uiKey, 1), uiObject, newBounds);
+}
+
+void ezLooseOctree::MoveObjects(ezArrayPtr<const ezUInt32> objects, ezArrayPtr<const ezBoundingBox> newBounds)
+{
+  EZ_ASSERT_DEV(objects.GetCount() == newBounds.GetCount(), "Every object needs new bounds");
+
+  m_Relocations.Clear();
+
+  for (ezUInt32 i = 0; i < objects.GetCount(); ++i)
+  {
+    const ezUInt32 uiObject = objects[i];
+    const ObjectData& data = m_Objects[uiObject];
+    EZ_ASSERT_DEV(data.m_uiNode != s_uiInvalidIndex, "Object {} has been removed", uiObject);
+
+    const ezUInt32 uiKey = ComputeNodeKey(newBounds[i]);
+
+    if (m_Nodes[data.m_uiNode].m_uiKey == uiKey)
+    {
+      SetObjectBounds(data, newBounds[i]);
+    }
+    else
+    {
+      m_Relocations.PushBack({uiKey, uiObject, i});
+    }
+  }
+
+  if (m_Relocations.IsEmpty())
+    return;
+
+  // take all objects out first, so that nodes which only lose objects are released and recycled right away
+  for (const Relocation& relocation : m_Relocations)
+  {
+    RemoveFromNode(relocation.m_uiObject);
+  }
+
+  m_Relocations.Sort();
+
+  // every node that receives objects is only looked up once
+  for (ezUInt32 uiFirst = 0; uiFirst < m_Relocations.GetCount();)
+  {
+    const ezUInt32 uiKey = m_Relocations[uiFirst].m_uiKey;
+
+    ezUInt32 uiEnd = uiFirst + 1;
+    while (uiEnd < m_Relocations.GetCount() && m_Relocations[uiEnd].m_uiKey == uiKey)
+    {
+      ++uiEnd;
+    }
+
+    const ezUInt32 uiNode = FindOrCreateNode(uiKey, uiEnd - uiFirst);
+
+    for (; uiFirst < uiEnd; ++uiFirst)
+    {
+      AddToNode(uiNode, m_Relocations[uiFirst].m_uiObject, newBounds[m_Relocations[uiFirst].m_uiBounds]);
+    }
+  }
+}
+
+ezBoundingBox ezLooseOctree::GetObjectBounds(ezUInt32 uiObject) const
+{
+  const ObjectData& data = m_Objects[uiObject];
+  EZ_ASSERT_DEV(data.m_uiNode != s_uiInvalidIndex, "Object {} has been removed", uiObject);
+
+  const ObjectBlock& block = m_Blocks[data.m_uiBlock];
+  const ezUInt32 uiLane = data.m_uiLane;
+
+  ezBoundingBox bounds;
+  bounds.m_vMin.Set(block.m_MinX[uiLane], block.m_MinY[uiLane], block.m_MinZ[uiLane]);
+  bounds.m_vMax.Set(block.m_MaxX[uiLane], block.m_MaxY[uiLane], block.m_MaxZ[uiLane]);
+  return bounds;
+}
+
+void ezLooseOctree::FindObjectsInBox(const ezBoundingBox& box, QueryCallback callback) const
+{
+  FindObjects(BoxFilter(box), callback);
+}
+
+void ezLooseOctree::FindObjectsInBox(const ezBoundingBox& box, ezDynamicArray<ezUInt32>& out_Objects) const
+{
+  FindObjects(BoxFilter(box), [&](ezUInt32 uiObject) {
+    out_Objects.PushBack(uiObject);
+    return true;
+  });
+}
+
+void ezLooseOctree::FindObjectsInSphere(const ezVec3& vCenter, float fRadius, QueryCallback callback) const
+{
+  FindObjects(SphereFilter(vCenter, fRadius), callback);
+}
+
+void ezLooseOctree::FindObjectsInSphere(const ezVec3& vCenter, float fRadius, ezDynamicArray<ezUInt32>& out_Objects) const
+{
+  FindObjects(SphereFilter(vCenter, fRadius), [&](ezUInt32 uiObject) {
+    out_Objects.PushBack(uiObject);
+    return true;
+  });
+}
+
+ezUInt32 ezLooseOctree::ComputeNodeKey(const ezBoundingBox& bounds) const
+{
+  if (!m_BBox.Contains(bounds))
+    return 1;
+
+  const ezVec3 vSize = bounds.GetExtents();
+  const float fSize = ezMath::Max(vSize.x, ezMath::Max(vSize.y, vSize.z));
+
+  // the finest level on which the object is not larger than the cells
+  ezUInt32 uiLevel = m_uiMaxTreeDepth;
+  const float fCellsAlongObject = fSize * m_fCellsPerUnit;
+  if (fCellsAlongObject > 1.0f)
+  {
+    const ezUInt32 uiShift = ezMath::FirstBitHigh(static_cast<ezUInt32>(ezMath::Ceil(fCellsAlongObject)) - 1) + 1;
+    uiLevel = (uiShift >= m_uiMaxTreeDepth) ? 0 : m_uiMaxTreeDepth - uiShift;
+  }
+
+  // the cell that contains the center, on the finest level
+  const ezUInt32 uiMaxCell = (1u << m_uiMaxTreeDepth) - 1;
+  const ezVec3 vCell = (bounds.GetCenter() - m_BBox.m_vMin) * m_fCellsPerUnit;
+  const ezUInt32 x = ezMath::Min(static_cast<ezUInt32>(ezMath::Max(vCell.x, 0.0f)), uiMaxCell);
+  const ezUInt32 y = ezMath::Min(static_cast<ezUInt32>(ezMath::Max(vCell.y, 0.0f)), uiMaxCell);
+  const ezUInt32 z = ezMath::Min(static_cast<ezUInt32>(ezMath::Max(vCell.z, 0.0f)), uiMaxCell);
+
+  const ezUInt32 uiMorton = SpreadBits(x) | (SpreadBits(y) << 1) | (SpreadBits(z) << 2);
+
+  // dropping three bits per level yields the cell on the coarser level, the leading one marks the level
+  return (1u << (uiLevel * 3)) | (uiMorton >> ((m_uiMaxTreeDepth - uiLevel) * 3));
+}
+
+ezUInt32 ezLooseOctree::FindOrCreateNode(ezUInt32 uiKey, ezUInt32 uiNumNewObjects)
+{
+  ezUInt32 uiNode = 0;
+  m_Nodes[0].m_uiSubTreeObjects += uiNumNewObjects;
+
+  for (ezUInt32 uiLevel = GetKeyLevel(uiKey); uiLevel > 0; --uiLevel)
+  {
+    const ezUInt32 uiChild = (uiKey >> ((uiLevel - 1) * 3)) & 7;
+
+    ezUInt32 uiChildNode = m_Nodes[uiNode].m_Children[uiChild];
+    if (uiChildNode == s_uiInvalidIndex)
+    {
+      uiChildNode = AllocateNode(uiNode, uiChild);
+    }
+
+    uiNode = uiChildNode;
+    m_Nodes[uiNode].m_uiSubTreeObjects += uiNumNewObjects;
+  }
+
+  return uiNode;
+}
+
+ezUInt32 ezLooseOctree::AllocateNode(ezUInt32 uiParent, ezUInt32 uiChild)
+{
+  ezUInt32 uiNode;
+  if (!m_FreeNodes.IsEmpty())
+  {
+    uiNode = m_FreeNodes.PeekBack();
+    m_FreeNodes.PopBack();
+  }
+  else
+  {
+    uiNode = m_Nodes.GetCount();
+    m_Nodes.ExpandAndGetRef();
+  }
+
+  Node& node = m_Nodes[uiNode];
+  node.m_uiKey = 1;
+  node.m_uiParent = uiParent;
+  node.m_uiSubTreeObjects = 0;
+  node.m_uiNumObjects = 0;
+  node.m_uiFirstBlock = s_uiInvalidIndex;
+
+  for (ezUInt32 i = 0; i < 8; ++i)
+  {
+    node.m_Children[i] = s_uiInvalidIndex;
+  }
+
+  if (uiParent == s_uiInvalidIndex)
+  {
+    node.m_vCellMin = m_BBox.m_vMin;
+    node.m_fCellSize = m_BBox.GetExtents().x;
+  }
+  else
+  {
+    Node& parent = m_Nodes[uiParent];
+    parent.m_Children[uiChild] = uiNode;
+
+    node.m_uiKey = (parent.m_uiKey << 3) | uiChild;
+    node.m_fCellSize = parent.m_fCellSize * 0.5f;
+    node.m_vCellMin = parent.m_vCellMin + ezVec3((uiChild & 1) ? node.m_fCellSize : 0.0f, (uiChild & 2) ? node.m_fCellSize : 0.0f,
+                                            (uiChild & 4) ? node.m_fCellSize : 0.0f);
+  }
+
+  return uiNode;
+}
+
+ezUInt32 ezLooseOctree::AllocateBlock()
+{
+  ezUInt32 uiBlock;
+  if (!m_FreeBlocks.IsEmpty())
+  {
+    uiBlock = m_FreeBlocks.PeekBack();
+    m_FreeBlocks.PopBack();
+  }
+  else
+  {
+    uiBlock = m_Blocks.GetCount();
+    m_Blocks.ExpandAndGetRef();
+  }
+
+  ObjectBlock& block = m_Blocks[uiBlock];
+  for (ezUInt32 i = 0; i < 4; ++i)
+  {
+    block.m_MinX[i] = block.m_MinY[i] = block.m_MinZ[i] = ezMath::MaxValue<float>();
+    block.m_MaxX[i] = block.m_MaxY[i] = block.m_MaxZ[i] = -ezMath::MaxValue<float>();
+    block.m_Objects[i] = s_uiInvalidIndex;
+  }
+
+  block.m_uiNextBlock = s_uiInvalidIndex;
+  return uiBlock;
+}
+
+void ezLooseOctree::AddToNode(ezUInt32 uiNode, ezUInt32 uiObject, const ezBoundingBox& bounds)
+{
+  const ezUInt32 uiLane = m_Nodes[uiNode].m_uiNumObjects % 4;
+
+  if (uiLane == 0)
+  {
+    // the first block is full, put a new one in front of it
+    const ezUInt32 uiBlock = AllocateBlock();
+    m_Blocks[uiBlock].m_uiNextBlock = m_Nodes[uiNode].m_uiFirstBlock;
+    m_Nodes[uiNode].m_uiFirstBlock = uiBlock;
+  }
+
+  Node& node = m_Nodes[uiNode];
+  ++node.m_uiNumObjects;
+
+  ObjectData& data = m_Objects[uiObject];
+  data.m_uiNode = uiNode;
+  data.m_uiBlock = node.m_uiFirstBlock;
+  data.m_uiLane = uiLane;
+
+  m_Blocks[data.m_uiBlock].m_Objects[uiLane] = uiObject;
+  SetObjectBounds(data, bounds);
+}
+
+void ezLooseOctree::RemoveFromNode(ezUInt32 uiObject)
+{
+  const ObjectData data = m_Objects[uiObject];
+  Node& node = m_Nodes[data.m_uiNode];
+
+  const ezUInt32 uiLastBlock = node.m_uiFirstBlock;
+  const ezUInt32 uiLastLane = (node.m_uiNumObjects - 1) % 4;
+  ObjectBlock& lastBlock = m_Blocks[uiLastBlock];
+
+  // move the last object into the free slot, to keep the blocks dense
+  if (data.m_uiBlock != uiLastBlock || data.m_uiLane != uiLastLane)
+  {
+    ObjectBlock& block = m_Blocks[data.m_uiBlock];
+    const ezUInt32 uiLane = data.m_uiLane;
+
+    block.m_MinX[uiLane] = lastBlock.m_MinX[uiLastLane];
+    block.m_MinY[uiLane] = lastBlock.m_MinY[uiLastLane];
+    block.m_MinZ[uiLane] = lastBlock.m_MinZ[uiLastLane];
+    block.m_MaxX[uiLane] = lastBlock.m_MaxX[uiLastLane];
+    block.m_MaxY[uiLane] = lastBlock.m_MaxY[uiLastLane];
+    block.m_MaxZ[uiLane] = lastBlock.m_MaxZ[uiLastLane];
+    block.m_Objects[uiLane] = lastBlock.m_Objects[uiLastLane];
+
+    ObjectData& movedData = m_Objects[block.m_Objects[uiLane]];
+    movedData.m_uiBlock = data.m_uiBlock;
+    movedData.m_uiLane = uiLane;
+  }
+
+  lastBlock.m_MinX[uiLastLane] = lastBlock.m_MinY[uiLastLane] = lastBlock.m_MinZ[uiLastLane] = ezMath::MaxValue<float>();
+  lastBlock.m_MaxX[uiLastLane] = lastBlock.m_MaxY[uiLastLane] = lastBlock.m_MaxZ[uiLastLane] = -ezMath::MaxValue<float>();
+  lastBlock.m_Objects[uiLastLane] = s_uiInvalidIndex;
+
+  --node.m_uiNumObjects;
+
+  if (uiLastLane == 0)
+  {
+    node.m_uiFirstBlock = lastBlock.m_uiNextBlock;
+    m_FreeBlocks.PushBack(uiLastBlock);
+  }
+
+  DecrementSubTreeCounts(data.m_uiNode);
+}
+
+void ezLooseOctree::SetObjectBounds(const ObjectData& data, const ezBoundingBox& bounds)
+{
+  ObjectBlock& block = m_Blocks[data.m_uiBlock];
+  const ezUInt32 uiLane = data.m_uiLane;
+
+  block.m_MinX[uiLane] = bounds.m_vMin.x;
+  block.m_MinY[uiLane] = bounds.m_vMin.y;
+  block.m_MinZ[uiLane] = bounds.m_vMin.z;
+  block.m_MaxX[uiLane] = bounds.m_vMax.x;
+  block.m_MaxY[uiLane] = bounds.m_vMax.y;
+  block.m_MaxZ[uiLane] = bounds.m_vMax.z;
+}
+
+void ezLooseOctree::DecrementSubTreeCounts(ezUInt32 uiNode)
+{
+  while (uiNode != s_uiInvalidIndex)
+  {
+    Node& node = m_Nodes[uiNode];
+    --node.m_uiSubTreeObjects;
+
+    const ezUInt32 uiParent = node.m_uiParent;
+
+    // the root always stays
+    if (node.m_uiSubTreeObjects == 0 && uiParent != s_uiInvalidIndex)
+    {
+      m_Nodes[uiParent].m_Children[node.m_uiKey & 7] = s_uiInvalidIndex;
+      m_FreeNodes.PushBack(uiNode);
+    }
+
+    uiNode = uiParent;
+  }
+}
+
+template <typename Filter>
+void ezLooseOctree::FindObjects(const Filter& filter, QueryCallback callback) const
+{
+  if (m_uiNumObjects == 0)
+    return;
+
+  // the root is always checked, because it also stores the objects that are outside the tree
+  ezHybridArray<ezUInt32, 128> stack;
+  stack.PushBack(0);
+
+  while (!stack.IsEmpty())
+  {
+    const ezUInt32 uiEntry = stack.PeekBack();
+    stack.PopBack();
+
+    const bool bInside = (uiEntry & s_uiInsideFlag) != 0;
+    const Node& node = m_Nodes[uiEntry & ~s_uiInsideFlag];
+
+    for (ezUInt32 uiBlock = node.m_uiFirstBlock; uiBlock != s_uiInvalidIndex;)
+    {
+      const ObjectBlock& block = m_Blocks[uiBlock];
+      uiBlock = block.m_uiNextBlock;
+
+      if (bInside)
+      {
+        // everything in this subtree is inside the loose bounds of the node
+        for (ezUInt32 uiLane = 0; uiLane < 4; ++uiLane)
+        {
+          if (block.m_Objects[uiLane] != s_uiInvalidIndex && !callback(block.m_Objects[uiLane]))
+            return;
+        }
+
+        continue;
+      }
+
+      const ezSimdVec4b overlap = filter.OverlapsBlock(block.m_MinX, block.m_MinY, block.m_MinZ, block.m_MaxX, block.m_MaxY, block.m_MaxZ);
+
+      if (overlap.NoneSet())
+        continue;
+
+      if (overlap.x() && !callback(block.m_Objects[0]))
+        return;
+      if (overlap.y() && !callback(block.m_Objects[1]))
+        return;
+      if (overlap.z() && !callback(block.m_Objects[2]))
+        return;
+      if (overlap.w() && !callback(block.m_Objects[3]))
+        return;
+    }
+
+    if (bInside)
+    {
+      for (ezUInt32 uiChild : node.m_Children)
+      {
+        if (uiChild != s_uiInvalidIndex)
+          stack.PushBack(uiChild | s_uiInsideFlag);
+      }
+
+      continue;
+    }
+
+    // the children are a regular grid, so the overlap can be determined per axis for the lower and upper half
+    const float fChildSize = node.m_fCellSize * 0.5f;
+    const float fLooseBorder = fChildSize * s_fLooseFactor;
+    const ezVec3 vLowerMin = node.m_vCellMin - ezVec3(fLooseBorder);
+    const ezVec3 vUpperMin = vLowerMin + ezVec3(fChildSize);
+    const ezVec3 vLowerMax = vUpperMin + ezVec3(2.0f * fLooseBorder);
+    const ezVec3 vUpperMax = vLowerMax + ezVec3(fChildSize);
+
+    const ezVec3& vQueryMin = filter.m_Bounds.m_vMin;
+    const ezVec3& vQueryMax = filter.m_Bounds.m_vMax;
+
+    const bool bOverlapX[2] = {vLowerMin.x <= vQueryMax.x && vLowerMax.x >= vQueryMin.x, vUpperMin.x <= vQueryMax.x && vUpperMax.x >= vQueryMin.x};
+    const bool bOverlapY[2] = {vLowerMin.y <= vQueryMax.y && vLowerMax.y >= vQueryMin.y, vUpperMin.y <= vQueryMax.y && vUpperMax.y >= vQueryMin.y};
+    const bool bOverlapZ[2] = {vLowerMin.z <= vQueryMax.z && vLowerMax.z >= vQueryMin.z, vUpperMin.z <= vQueryMax.z && vUpperMax.z >= vQueryMin.z};
+
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      const ezUInt32 uiChild = node.m_Children[i];
+      if (uiChild == s_uiInvalidIndex || !bOverlapX[i & 1] || !bOverlapY[(i >> 1) & 1] || !bOverlapZ[(i >> 2) & 1])
+        continue;
+
+      const ezVec3 vChildMin((i & 1) ? vUpperMin.x : vLowerMin.x, (i & 2) ? vUpperMin.y : vLowerMin.y, (i & 4) ? vUpperMin.z : vLowerMin.z);
+      const ezVec3 vChildMax = vChildMin + ezVec3(fChildSize + 2.0f * fLooseBorder);
+
+      stack.PushBack(filter.ContainsNode(vChildMin, vChildMax) ? (uiChild | s_uiInsideFlag) : uiChild);
+    }
+  }
+}
+
+EZ_STATICLINK_FILE(Utilities, Utilities_DataStructures_Implementation_LooseOctree);
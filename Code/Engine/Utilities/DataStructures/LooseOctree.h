@@ -0,0 +1,182 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Math/BoundingBox.h>
+#include <Foundation/Types/Delegate.h>
+#include <Utilities/UtilitiesDLL.h>
+
+/// \brief A loose octree for many small, frequently moving objects, e.g. for gameplay proximity queries.
+///
+/// In contrast to ezDynamicOctree, which stores all objects in one ezMap, this tree stores the objects of each node
+/// in blocks of four, which come from one shared pool. Inside a block the bounding boxes are stored per component
+/// (structure of arrays), such that a query can reject four objects at once with SIMD instructions.
+/// Nodes are only allocated while they have objects in their subtree, all allocations are recycled.\n
+/// \n
+/// The tree has a fixed size and depth. The cell in which an object is stored is identified through a Morton-coded key,
+/// which is computed from the object's center and size in O(1). The bits of the Morton code directly describe the
+/// path from the root to that cell. Since the tree is loose (every node's bounds are enlarged by half its size in all
+/// directions), an object is always stored in the cell that contains its center, on the finest level where the object
+/// is not larger than the cell.\n
+/// \n
+/// Objects are identified by an index that is returned on insertion and stays valid until the object is removed.
+/// Moving an object is cheap when it stays in the same cell, which is what usually happens. MoveObjects() updates
+/// many objects at once and bundles the ones that switch cells.\n
+/// \n
+/// Queries traverse the tree with an explicit stack and skip all subtrees that do not contain any objects.
+/// Subtrees whose bounds are entirely inside a query box are returned without further checks.
+/// In contrast to ezDynamicOctree, queries only return objects whose bounding box actually overlaps the query volume.
+class EZ_UTILITIES_DLL ezLooseOctree
+{
+public:
+  /// \brief Return false to abort the query.
+  typedef ezDelegate<bool(ezUInt32 uiObject)> QueryCallback;
+
+  ezLooseOctree();
+  ~ezLooseOctree();
+
+  /// \brief Initializes the tree with a fixed size and minimum node dimensions. Removes all objects.
+  ///
+  /// The tree is always a cube, its size is the largest extent of vHalfExtents. fMinNodeSize is the edge length of the
+  /// cells on the finest level. The depth of the tree is limited to 10 levels below the root.
+  /// Queries are fastest when the finest cells are about as large as the typical query volume, smaller cells
+  /// only add more nodes that have to be visited.
+  void CreateTree(const ezVec3& vCenter, const ezVec3& vHalfExtents, float fMinNodeSize); // [tested]
+
+  /// \brief Returns true when there are no objects stored inside the tree.
+  bool IsEmpty() const { return m_uiNumObjects == 0; } // [tested]
+
+  /// \brief Returns the number of objects that have been inserted into the tree.
+  ezUInt32 GetCount() const { return m_uiNumObjects; } // [tested]
+
+  /// \brief Returns the tree's adjusted (square) AABB.
+  const ezBoundingBox& GetBoundingBox() const { return m_BBox; } // [tested]
+
+  /// \brief Returns the number of levels below the root node.
+  ezUInt32 GetMaxTreeDepth() const { return m_uiMaxTreeDepth; }
+
+  /// \brief Adds an object with the given bounds and returns its index.
+  ///
+  /// Objects that are not entirely inside the tree are stored at the root node, they are still returned correctly by
+  /// all queries, but have to be checked by every query.
+  ezUInt32 InsertObject(const ezBoundingBox& bounds); // [tested]
+
+  /// \brief Removes the object. Its index may be returned by a later call to InsertObject().
+  void RemoveObject(ezUInt32 uiObject); // [tested]
+
+  /// \brief Removes all objects, but keeps the allocated memory.
+  void RemoveAllObjects(); // [tested]
+
+  /// \brief Updates the bounds of a single object.
+  void MoveObject(ezUInt32 uiObject, const ezBoundingBox& newBounds); // [tested]
+
+  /// \brief Updates the bounds of many objects at once. Objects[i] gets the new bounds NewBounds[i].
+  ///
+  /// Objects that stay in their cell are updated in place. Objects that switch cells are sorted by their new cell
+  /// first, so that every affected node is only looked up once.
+  void MoveObjects(ezArrayPtr<const ezUInt32> objects, ezArrayPtr<const ezBoundingBox> newBounds); // [tested]
+
+  /// \brief Returns the bounds of the object.
+  ezBoundingBox GetObjectBounds(ezUInt32 uiObject) const; // [tested]
+
+  /// \brief Calls the callback for every object whose bounds overlap the box.
+  void FindObjectsInBox(const ezBoundingBox& box, QueryCallback callback) const; // [tested]
+
+  /// \brief Appends all objects whose bounds overlap the box to out_Objects.
+  void FindObjectsInBox(const ezBoundingBox& box, ezDynamicArray<ezUInt32>& out_Objects) const; // [tested]
+
+  /// \brief Calls the callback for every object whose bounds overlap the sphere.
+  void FindObjectsInSphere(const ezVec3& vCenter, float fRadius, QueryCallback callback) const; // [tested]
+
+  /// \brief Appends all objects whose bounds overlap the sphere to out_Objects.
+  void FindObjectsInSphere(const ezVec3& vCenter, float fRadius, ezDynamicArray<ezUInt32>& out_Objects) const; // [tested]
+
+private:
+  static constexpr ezUInt32 s_uiMaxDepth = 10;
+  static constexpr ezUInt32 s_uiInvalidIndex = 0xFFFFFFFF;
+
+  /// \brief Four objects with their bounds stored per component. Unused slots have inverted bounds and never overlap anything.
+  struct ObjectBlock
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    float m_MinX[4];
+    float m_MinY[4];
+    float m_MinZ[4];
+    float m_MaxX[4];
+    float m_MaxY[4];
+    float m_MaxZ[4];
+    ezUInt32 m_Objects[4];
+    ezUInt32 m_uiNextBlock;
+  };
+
+  struct Node
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    /// Morton code of the cell with a leading 1 bit that marks the level.
+    ezUInt32 m_uiKey;
+    ezUInt32 m_uiParent;
+    /// Only children with objects in their subtree exist.
+    ezUInt32 m_Children[8];
+    /// Number of objects in this node and all nodes below.
+    ezUInt32 m_uiSubTreeObjects;
+    ezUInt32 m_uiNumObjects;
+    /// The only block that may be partially filled, it links to the full ones.
+    ezUInt32 m_uiFirstBlock;
+    /// The cell without the loose border.
+    ezVec3 m_vCellMin;
+    float m_fCellSize;
+  };
+
+  struct ObjectData
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiNode;
+    ezUInt32 m_uiBlock;
+    ezUInt32 m_uiLane;
+  };
+
+  struct Relocation
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiKey;
+    ezUInt32 m_uiObject;
+    ezUInt32 m_uiBounds;
+
+    bool operator<(const Relocation& rhs) const { return m_uiKey < rhs.m_uiKey; }
+  };
+
+  /// \brief Computes the key of the cell in which an object with these bounds belongs. Returns 1 (the root) for objects outside the tree.
+  ezUInt32 ComputeNodeKey(const ezBoundingBox& bounds) const;
+
+  /// \brief Walks down from the root along the bits of the key, creates the missing nodes and adds uiNumNewObjects to the object
+  /// counts of all nodes on the way.
+  ezUInt32 FindOrCreateNode(ezUInt32 uiKey, ezUInt32 uiNumNewObjects);
+
+  ezUInt32 AllocateNode(ezUInt32 uiParent, ezUInt32 uiChild);
+  ezUInt32 AllocateBlock();
+  void AddToNode(ezUInt32 uiNode, ezUInt32 uiObject, const ezBoundingBox& bounds);
+  void RemoveFromNode(ezUInt32 uiObject);
+  void SetObjectBounds(const ObjectData& data, const ezBoundingBox& bounds);
+
+  /// \brief Decrements the object counts of the node and all its parents. Nodes whose subtree became empty are released.
+  void DecrementSubTreeCounts(ezUInt32 uiNode);
+
+  template <typename Filter>
+  void FindObjects(const Filter& filter, QueryCallback callback) const;
+
+  ezUInt32 m_uiMaxTreeDepth = 0;
+  ezUInt32 m_uiNumObjects = 0;
+  ezBoundingBox m_BBox;
+  float m_fCellsPerUnit = 0.0f;
+
+  ezDynamicArray<Node> m_Nodes;
+  ezDynamicArray<ezUInt32> m_FreeNodes;
+  ezDynamicArray<ObjectBlock> m_Blocks;
+  ezDynamicArray<ezUInt32> m_FreeBlocks;
+  ezDynamicArray<ObjectData> m_Objects;
+  ezDynamicArray<ezUInt32> m_FreeObjects;
+  ezDynamicArray<Relocation> m_Relocations;
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Foundation/Containers/DynamicArray.h>
 #include <Foundation/Math/Math.h>
 #include <Utilities/UtilitiesDLL.h>
 #include <Utilities/PathFinding/PathState.h>
@@ -11,6 +12,10 @@
 ///
 /// PathStateType must be derived from ezPathState and can be used for keeping track of certain state along a path and to modify
 /// the path search dynamically.
+///
+/// The nodes that still need to be expanded are kept in a binary heap. All memory is kept between searches, so for many path queries
+/// it is best to keep one ezPathSearch object around (one per thread, if searches run in parallel) and reuse it.
+/// If the ezPathStateGenerator reports a node index range, visited nodes are looked up in a flat array instead of a hash table.
 template <typename PathStateType>
 class ezPathSearch
 {
@@ -57,15 +62,41 @@ public:
   void AddPathNode(ezInt64 iNodeIndex, const PathStateType& NewState);
 
 private:
+  struct NodeData
+  {
+    PathStateType m_State;
+    ezInt64 m_iNodeIndex;
+    ezUInt32 m_uiHeapIndex; ///< Position in m_OpenSet, ezInvalidIndex once the node has been expanded.
+  };
+
+  struct OpenSetEntry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    float m_fEstimatedCostToTarget;
+    ezUInt32 m_uiNode;
+  };
+
   void ClearPathStates();
-  ezInt64 FindBestNodeToExpand(PathStateType*& out_pPathState);
-  void FillOutPathResult(ezInt64 iEndNodeIndex, ezDeque<PathResultData>& out_Path);
+  ezUInt32 FindNode(ezInt64 iNodeIndex) const;
+  ezUInt32 AddNode(ezInt64 iNodeIndex, const PathStateType& State);
+  ezUInt32 FindBestNodeToExpand(PathStateType*& out_pPathState);
+  void UpdateOpenSet(ezUInt32 uiHeapIndex);
+  void FillOutPathResult(ezUInt32 uiEndNode, ezDeque<PathResultData>& out_Path);
+
+  ezPathStateGenerator<PathStateType>* m_pStateGenerator = nullptr;
+
+  /// All nodes that were reached during the current search.
+  ezDynamicArray<NodeData> m_Nodes;
 
-  ezPathStateGenerator<PathStateType>* m_pStateGenerator;
+  /// Maps node indices to m_Nodes, if the state generator has a bounded node index range.
+  ezDynamicArray<ezUInt32> m_NodeLookupDense;
 
-  ezHashTable<ezInt64, PathStateType> m_PathStates;
+  /// Maps node indices to m_Nodes otherwise.
+  ezHashTable<ezInt64, ezUInt32> m_NodeLookup;
 
-  ezDeque<ezInt64> m_StateQueue;
+  /// Binary min-heap of the nodes that still need to be expanded.
+  ezDynamicArray<OpenSetEntry> m_OpenSet;
 
   ezInt64 m_iCurNodeIndex;
   PathStateType m_CurState;
@@ -3,58 +3,148 @@
 template <typename PathStateType>
 void ezPathSearch<PathStateType>::ClearPathStates()
 {
-  m_PathStates.Clear();
-  m_StateQueue.Clear();
+  // only reset the lookup entries that were used by the previous search, the lookup itself is kept
+  if (!m_NodeLookupDense.IsEmpty())
+  {
+    for (const NodeData& node : m_Nodes)
+    {
+      m_NodeLookupDense[static_cast<ezUInt32>(node.m_iNodeIndex)] = ezInvalidIndex;
+    }
+  }
+
+  m_NodeLookup.Clear();
+  m_Nodes.Clear();
+  m_OpenSet.Clear();
+
+  m_NodeLookupDense.SetCount(m_pStateGenerator->GetNodeIndexRange(), ezInvalidIndex);
+}
+
+template <typename PathStateType>
+ezUInt32 ezPathSearch<PathStateType>::FindNode(ezInt64 iNodeIndex) const
+{
+  if (!m_NodeLookupDense.IsEmpty())
+  {
+    EZ_ASSERT_DEBUG(iNodeIndex >= 0 && iNodeIndex < (ezInt64)m_NodeLookupDense.GetCount(), "Node index {0} is outside the range reported by the state generator", iNodeIndex);
+    return m_NodeLookupDense[static_cast<ezUInt32>(iNodeIndex)];
+  }
+
+  ezUInt32 uiNode = ezInvalidIndex;
+  m_NodeLookup.TryGetValue(iNodeIndex, uiNode);
+  return uiNode;
 }
 
 template <typename PathStateType>
-ezInt64 ezPathSearch<PathStateType>::FindBestNodeToExpand(PathStateType*& out_pPathState)
+ezUInt32 ezPathSearch<PathStateType>::AddNode(ezInt64 iNodeIndex, const PathStateType& State)
 {
-  float fLowestEstimation = ezMath::Infinity<float>();
-  out_pPathState = nullptr;
-  ezUInt32 iBestInQueue = 0;
+  const ezUInt32 uiNode = m_Nodes.GetCount();
+
+  NodeData& node = m_Nodes.ExpandAndGetRef();
+  node.m_State = State;
+  node.m_iNodeIndex = iNodeIndex;
+  node.m_uiHeapIndex = m_OpenSet.GetCount();
+
+  // put it into the queue of states that still need to be expanded
+  OpenSetEntry& entry = m_OpenSet.ExpandAndGetRef();
+  entry.m_fEstimatedCostToTarget = State.m_fEstimatedCostToTarget;
+  entry.m_uiNode = uiNode;
 
-  for (ezUInt32 i = 0; i < m_StateQueue.GetCount(); ++i)
+  if (!m_NodeLookupDense.IsEmpty())
   {
-    const ezInt64 iNodeIndex = m_StateQueue[i];
+    EZ_ASSERT_DEBUG(iNodeIndex >= 0 && iNodeIndex < (ezInt64)m_NodeLookupDense.GetCount(), "Node index {0} is outside the range reported by the state generator", iNodeIndex);
+    m_NodeLookupDense[static_cast<ezUInt32>(iNodeIndex)] = uiNode;
+  }
+  else
+  {
+    m_NodeLookup.Insert(iNodeIndex, uiNode);
+  }
 
-    PathStateType* pState = &m_PathStates[iNodeIndex];
+  UpdateOpenSet(node.m_uiHeapIndex);
 
-    if (pState->m_fEstimatedCostToTarget < fLowestEstimation)
-    {
-      fLowestEstimation = pState->m_fEstimatedCostToTarget;
-      out_pPathState = pState;
-      iBestInQueue = i;
-    }
+  return uiNode;
+}
+
+template <typename PathStateType>
+void ezPathSearch<PathStateType>::UpdateOpenSet(ezUInt32 uiHeapIndex)
+{
+  const OpenSetEntry entry = m_OpenSet[uiHeapIndex];
+
+  // move up while the parent has a higher estimation
+  while (uiHeapIndex > 0)
+  {
+    const ezUInt32 uiParent = (uiHeapIndex - 1) / 2;
+
+    if (m_OpenSet[uiParent].m_fEstimatedCostToTarget <= entry.m_fEstimatedCostToTarget)
+      break;
+
+    m_OpenSet[uiHeapIndex] = m_OpenSet[uiParent];
+    m_Nodes[m_OpenSet[uiHeapIndex].m_uiNode].m_uiHeapIndex = uiHeapIndex;
+    uiHeapIndex = uiParent;
   }
 
-  EZ_ASSERT_DEV(out_pPathState != nullptr, "Implementation Error");
+  // move down while a child has a lower estimation
+  const ezUInt32 uiCount = m_OpenSet.GetCount();
+  while (true)
+  {
+    ezUInt32 uiChild = uiHeapIndex * 2 + 1;
+    if (uiChild >= uiCount)
+      break;
 
-  const ezInt64 iBestNodeIndex = m_StateQueue[iBestInQueue];
-  m_StateQueue.RemoveAtAndSwap(iBestInQueue);
+    if (uiChild + 1 < uiCount && m_OpenSet[uiChild + 1].m_fEstimatedCostToTarget < m_OpenSet[uiChild].m_fEstimatedCostToTarget)
+      ++uiChild;
 
-  return iBestNodeIndex;
+    if (entry.m_fEstimatedCostToTarget <= m_OpenSet[uiChild].m_fEstimatedCostToTarget)
+      break;
+
+    m_OpenSet[uiHeapIndex] = m_OpenSet[uiChild];
+    m_Nodes[m_OpenSet[uiHeapIndex].m_uiNode].m_uiHeapIndex = uiHeapIndex;
+    uiHeapIndex = uiChild;
+  }
+
+  m_OpenSet[uiHeapIndex] = entry;
+  m_Nodes[entry.m_uiNode].m_uiHeapIndex = uiHeapIndex;
 }
 
 template <typename PathStateType>
-void ezPathSearch<PathStateType>::FillOutPathResult(ezInt64 iEndNodeIndex, ezDeque<PathResultData>& out_Path)
+ezUInt32 ezPathSearch<PathStateType>::FindBestNodeToExpand(PathStateType*& out_pPathState)
+{
+  EZ_ASSERT_DEV(!m_OpenSet.IsEmpty(), "Implementation Error");
+
+  const ezUInt32 uiBestNode = m_OpenSet[0].m_uiNode;
+  m_Nodes[uiBestNode].m_uiHeapIndex = ezInvalidIndex;
+
+  // move the last entry to the top and let it sink down to its place
+  const OpenSetEntry last = m_OpenSet.PeekBack();
+  m_OpenSet.PopBack();
+
+  if (!m_OpenSet.IsEmpty())
+  {
+    m_OpenSet[0] = last;
+    UpdateOpenSet(0);
+  }
+
+  out_pPathState = &m_Nodes[uiBestNode].m_State;
+  return uiBestNode;
+}
+
+template <typename PathStateType>
+void ezPathSearch<PathStateType>::FillOutPathResult(ezUInt32 uiEndNode, ezDeque<PathResultData>& out_Path)
 {
   out_Path.Clear();
 
   while (true)
   {
-    const PathStateType* pCurState = &m_PathStates[iEndNodeIndex];
+    const NodeData& node = m_Nodes[uiEndNode];
 
     PathResultData r;
-    r.m_iNodeIndex = iEndNodeIndex;
-    r.m_pPathState = pCurState;
+    r.m_iNodeIndex = node.m_iNodeIndex;
+    r.m_pPathState = &node.m_State;
 
     out_Path.PushFront(r);
 
-    if (iEndNodeIndex == pCurState->m_iReachedThroughNode)
+    if (node.m_iNodeIndex == node.m_State.m_iReachedThroughNode)
       return;
 
-    iEndNodeIndex = pCurState->m_iReachedThroughNode;
+    uiEndNode = FindNode(node.m_State.m_iReachedThroughNode);
   }
 }
 
@@ -69,28 +159,33 @@ void ezPathSearch<PathStateType>::AddPathNode(ezInt64 iNodeIndex, const PathStat
   // ezArgF(m_pCurPathState->m_fEstimatedCostToTarget, 2), ezArgF(NewState.m_fEstimatedCostToTarget, 2));
   EZ_ASSERT_DEV(NewState.m_fEstimatedCostToTarget >= NewState.m_fCostToNode, "Unrealistic expectations will get you nowhere.");
 
-  PathStateType* pExistingState;
+  const ezUInt32 uiExistingNode = FindNode(iNodeIndex);
 
-  if (m_PathStates.TryGetValue(iNodeIndex, pExistingState))
+  if (uiExistingNode != ezInvalidIndex)
   {
-    // state already exists in the hash table, and has a lower cost -> ignore the new state
-    if (pExistingState->m_fCostToNode <= NewState.m_fCostToNode)
+    NodeData& existing = m_Nodes[uiExistingNode];
+
+    // state has been reached before, and has a lower cost -> ignore the new state
+    if (existing.m_State.m_fCostToNode <= NewState.m_fCostToNode)
       return;
 
     // incoming state is better than the existing state -> update existing state
-    *pExistingState = NewState;
-    pExistingState->m_iReachedThroughNode = m_iCurNodeIndex;
+    existing.m_State = NewState;
+    existing.m_State.m_iReachedThroughNode = m_iCurNodeIndex;
+
+    // if it still waits to be expanded, move it to its new place in the queue
+    if (existing.m_uiHeapIndex != ezInvalidIndex)
+    {
+      m_OpenSet[existing.m_uiHeapIndex].m_fEstimatedCostToTarget = NewState.m_fEstimatedCostToTarget;
+      UpdateOpenSet(existing.m_uiHeapIndex);
+    }
+
     return;
   }
 
   // the state has not been reached before -> insert it
-  pExistingState = &m_PathStates[iNodeIndex];
-
-  *pExistingState = NewState;
-  pExistingState->m_iReachedThroughNode = m_iCurNodeIndex;
-
-  // put it into the queue of states that still need to be expanded
-  m_StateQueue.PushBack(iNodeIndex);
+  const ezUInt32 uiNode = AddNode(iNodeIndex, NewState);
+  m_Nodes[uiNode].m_State.m_iReachedThroughNode = m_iCurNodeIndex;
 }
 
 template <typename PathStateType>
@@ -103,13 +198,11 @@ ezResult ezPathSearch<PathStateType>::FindPath(ezInt64 iStartNodeIndex, const Pa
 
   if (iStartNodeIndex == iTargetNodeIndex)
   {
-    m_PathStates.Reserve(1);
-
-    m_PathStates[iTargetNodeIndex] = StartState;
+    const ezUInt32 uiNode = AddNode(iTargetNodeIndex, StartState);
 
     PathResultData r;
     r.m_iNodeIndex = iTargetNodeIndex;
-    r.m_pPathState = &m_PathStates[iTargetNodeIndex];
+    r.m_pPathState = &m_Nodes[uiNode].m_State;
 
     out_Path.Clear();
     out_Path.PushBack(r);
@@ -117,9 +210,9 @@ ezResult ezPathSearch<PathStateType>::FindPath(ezInt64 iStartNodeIndex, const Pa
     return EZ_SUCCESS;
   }
 
-  m_PathStates.Reserve(10000);
-
-  PathStateType& FirstState = m_PathStates[iStartNodeIndex];
+  // put the start state into the to-be-expanded queue
+  const ezUInt32 uiFirstNode = AddNode(iStartNodeIndex, StartState);
+  PathStateType& FirstState = m_Nodes[uiFirstNode].m_State;
 
   m_pStateGenerator->StartSearch(iStartNodeIndex, &FirstState, iTargetNodeIndex);
 
@@ -127,19 +220,17 @@ ezResult ezPathSearch<PathStateType>::FindPath(ezInt64 iStartNodeIndex, const Pa
   FirstState = StartState;
   FirstState.m_iReachedThroughNode = iStartNodeIndex;
 
-  // put the start state into the to-be-expanded queue
-  m_StateQueue.PushBack(iStartNodeIndex);
-
   // while the queue is not empty, expand the next node and see where that gets us
-  while (!m_StateQueue.IsEmpty())
+  while (!m_OpenSet.IsEmpty())
   {
     PathStateType* pCurState;
-    m_iCurNodeIndex = FindBestNodeToExpand(pCurState);
+    const ezUInt32 uiCurNode = FindBestNodeToExpand(pCurState);
+    m_iCurNodeIndex = m_Nodes[uiCurNode].m_iNodeIndex;
 
     // we have reached the target node, generate the final path result
     if (m_iCurNodeIndex == iTargetNodeIndex)
     {
-      FillOutPathResult(m_iCurNodeIndex, out_Path);
+      FillOutPathResult(uiCurNode, out_Path);
       m_pStateGenerator->SearchFinished(EZ_SUCCESS);
       return EZ_SUCCESS;
     }
@@ -153,6 +244,7 @@ ezResult ezPathSearch<PathStateType>::FindPath(ezInt64 iStartNodeIndex, const Pa
       return EZ_FAILURE;
     }
 
+    // copy the state, pCurState is invalidated when new nodes are added
     m_CurState = *pCurState;
 
     // let the generate append all the nodes that we can reach from here
@@ -172,9 +264,9 @@ ezResult ezPathSearch<PathStateType>::FindClosest(ezInt64 iStartNodeIndex, const
 
   ClearPathStates();
 
-  m_PathStates.Reserve(10000);
-
-  PathStateType& FirstState = m_PathStates[iStartNodeIndex];
+  // put the start state into the to-be-expanded queue
+  const ezUInt32 uiFirstNode = AddNode(iStartNodeIndex, StartState);
+  PathStateType& FirstState = m_Nodes[uiFirstNode].m_State;
 
   m_pStateGenerator->StartSearchForClosest(iStartNodeIndex, &FirstState);
 
@@ -182,19 +274,17 @@ ezResult ezPathSearch<PathStateType>::FindClosest(ezInt64 iStartNodeIndex, const
   FirstState = StartState;
   FirstState.m_iReachedThroughNode = iStartNodeIndex;
 
-  // put the start state into the to-be-expanded queue
-  m_StateQueue.PushBack(iStartNodeIndex);
-
   // while the queue is not empty, expand the next node and see where that gets us
-  while (!m_StateQueue.IsEmpty())
+  while (!m_OpenSet.IsEmpty())
   {
     PathStateType* pCurState;
-    m_iCurNodeIndex = FindBestNodeToExpand(pCurState);
+    const ezUInt32 uiCurNode = FindBestNodeToExpand(pCurState);
+    m_iCurNodeIndex = m_Nodes[uiCurNode].m_iNodeIndex;
 
     // we have reached the target node, generate the final path result
     if (Callback(m_iCurNodeIndex, *pCurState))
     {
-      FillOutPathResult(m_iCurNodeIndex, out_Path);
+      FillOutPathResult(uiCurNode, out_Path);
       m_pStateGenerator->SearchFinished(EZ_SUCCESS);
       return EZ_SUCCESS;
     }
@@ -208,6 +298,7 @@ ezResult ezPathSearch<PathStateType>::FindClosest(ezInt64 iStartNodeIndex, const
       return EZ_FAILURE;
     }
 
+    // copy the state, pCurState is invalidated when new nodes are added
     m_CurState = *pCurState;
 
     // let the generate append all the nodes that we can reach from here
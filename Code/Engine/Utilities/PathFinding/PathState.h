@@ -68,5 +68,11 @@ public:
   /// \brief Automatically called by ezPathSearch objects when a path search was finished.
   /// Allows the generator to do some cleanup.
   virtual void SearchFinished(ezResult res) {}
+
+  /// \brief If all node indices are in the range [0; N), this may return N. Returns 0 if node indices are unbounded.
+  ///
+  /// With a known range ezPathSearch looks up visited nodes in a flat array instead of a hash table, which is considerably faster,
+  /// but needs four bytes of memory for every possible node. On a 2D grid this would typically be the number of cells.
+  virtual ezUInt32 GetNodeIndexRange() const { return 0; }
 };
 
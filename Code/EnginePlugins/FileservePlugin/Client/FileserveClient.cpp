@@ -2,10 +2,13 @@
 
 #include <FileservePlugin/Client/FileserveClient.h>
 #include <FileservePlugin/Fileserver/ClientContext.h>
+#include <Foundation/Application/Application.h>
 #include <Foundation/Communication/GlobalEvent.h>
 #include <Foundation/Communication/RemoteInterfaceEnet.h>
+#include <Foundation/IO/CompressedStreamZstd.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/IO/FileSystem/Implementation/DataDirType.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Types/ScopeExit.h>
 #include <Foundation/Utilities/CommandLineUtils.h>
@@ -48,6 +51,8 @@ ezFileserveClient::ezFileserveClient()
   if (ezCommandLineUtils::GetGlobalInstance()->GetBoolOption("-fs_off"))
     s_bEnableFileserve = false;
 
+  m_sFileserveDataFolder = ezOSFile::GetUserDataFolder("ezFileserve");
+
   m_CurrentTime = ezTime::Now();
 }
 
@@ -62,6 +67,8 @@ void ezFileserveClient::ShutdownConnection()
   {
     ezLog::Dev("Shutting down fileserve client");
 
+    SaveSessionManifest();
+
     m_Network->ShutdownConnection();
     m_Network = nullptr;
   }
@@ -70,10 +77,14 @@ void ezFileserveClient::ShutdownConnection()
 void ezFileserveClient::ClearState()
 {
   m_bDownloading = false;
+  m_bPrefetching = false;
+  m_bPrefetchTimedOut = false;
   m_bWaitingForUploadFinished = false;
   m_CurFileRequestGuid = ezUuid();
   m_sCurFileRequest.Clear();
   m_Download.Clear();
+  m_PrefetchGuid = ezUuid();
+  m_PrefetchFiles.Clear();
 }
 
 ezResult ezFileserveClient::EnsureConnected(ezTime timeout)
@@ -86,8 +97,13 @@ ezResult ezFileserveClient::EnsureConnected(ezTime timeout)
   {
     m_Network = ezRemoteInterfaceEnet::Make(); /// \todo Somehow abstract this away ?
 
-    m_sFileserveCacheFolder = ezOSFile::GetUserDataFolder("ezFileserve/Cache");
-    m_sFileserveCacheMetaFolder = ezOSFile::GetUserDataFolder("ezFileserve/Meta");
+    ezStringBuilder sFolder = m_sFileserveDataFolder;
+    sFolder.AppendPath("Cache");
+    m_sFileserveCacheFolder = sFolder;
+
+    sFolder = m_sFileserveDataFolder;
+    sFolder.AppendPath("Meta");
+    m_sFileserveCacheMetaFolder = sFolder;
 
     if (ezOSFile::CreateDirectoryStructure(m_sFileserveCacheFolder).Failed())
     {
@@ -100,6 +116,8 @@ ezResult ezFileserveClient::EnsureConnected(ezTime timeout)
       ezLog::Error("Could not create fileserve cache folder '{0}'", m_sFileserveCacheMetaFolder);
       return EZ_FAILURE;
     }
+
+    LoadPrefetchManifest();
   }
 
   if (!m_Network->IsConnectedToServer())
@@ -350,6 +368,30 @@ void ezFileserveClient::NetworkMsgHandler(ezRemoteMessage& msg)
     return;
   }
 
+  if (msg.GetMessageID() == 'PRFS')
+  {
+    HandlePrefetchStatusMsg(msg);
+    return;
+  }
+
+  if (msg.GetMessageID() == 'PRFH')
+  {
+    HandlePrefetchHeaderMsg(msg);
+    return;
+  }
+
+  if (msg.GetMessageID() == 'PRFD')
+  {
+    HandlePrefetchDataMsg(msg);
+    return;
+  }
+
+  if (msg.GetMessageID() == 'PRFF')
+  {
+    HandlePrefetchFinishedMsg(msg);
+    return;
+  }
+
   static bool s_bReloadResources = false;
 
   if (msg.GetMessageID() == 'RLDR')
@@ -404,6 +446,8 @@ ezUInt16 ezFileserveClient::MountDataDirectory(const char* szDataDirectory, cons
   dd.m_sMountPoint = sMountPoint;
   dd.m_bMounted = true;
 
+  PrefetchFiles(uiDataDirID);
+
   return uiDataDirID;
 }
 
@@ -502,13 +546,21 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
   ezUInt16 uiFoundInDataDir = 0;
   msg.GetReader() >> uiFoundInDataDir;
 
+  ApplyFileState(m_sCurFileRequest, fileState, iFileTimeStamp, uiFileHash, uiFoundInDataDir, m_Download);
+}
+
+void ezFileserveClient::ApplyFileState(const char* szFile, ezFileserveFileState fileState, ezInt64 iFileTimeStamp, ezUInt64 uiFileHash,
+                                       ezUInt16 uiFoundInDataDir, ezArrayPtr<const ezUInt8> content)
+{
+  EZ_LOCK(m_Mutex);
+
   if (uiFoundInDataDir == 0xffff) // file does not exist on server in any data dir
   {
-    m_FileDataDir[m_sCurFileRequest] = 0; // placeholder
+    m_FileDataDir[szFile] = 0; // placeholder
 
     for (ezUInt32 i = 0; i < m_MountedDataDirs.GetCount(); ++i)
     {
-      auto& ref = m_MountedDataDirs[i].m_CacheStatus[m_sCurFileRequest];
+      auto& ref = m_MountedDataDirs[i].m_CacheStatus[szFile];
       ref.m_FileHash = 0;
       ref.m_TimeStamp = 0;
       ref.m_LastCheck = m_CurrentTime;
@@ -518,9 +570,9 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
   }
   else
   {
-    m_FileDataDir[m_sCurFileRequest] = uiFoundInDataDir;
+    m_FileDataDir[szFile] = uiFoundInDataDir;
 
-    auto& ref = m_MountedDataDirs[uiFoundInDataDir].m_CacheStatus[m_sCurFileRequest];
+    auto& ref = m_MountedDataDirs[uiFoundInDataDir].m_CacheStatus[szFile];
     ref.m_FileHash = uiFileHash;
     ref.m_TimeStamp = iFileTimeStamp;
     ref.m_LastCheck = m_CurrentTime;
@@ -532,7 +584,7 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
 
   const ezString& sMountPoint = m_MountedDataDirs[uiFoundInDataDir].m_sMountPoint;
   ezStringBuilder sCachedFile, sCachedMetaFile;
-  BuildPathInCache(m_sCurFileRequest, sMountPoint, &sCachedFile, &sCachedMetaFile);
+  BuildPathInCache(szFile, sMountPoint, &sCachedFile, &sCachedMetaFile);
 
   if (fileState == ezFileserveFileState::NonExistant)
   {
@@ -550,7 +602,7 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
 
   if (fileState == ezFileserveFileState::Different)
   {
-    WriteDownloadToDisk(sCachedFile);
+    WriteDownloadToDisk(sCachedFile, content);
     WriteMetaFile(sCachedMetaFile, iFileTimeStamp, uiFileHash);
   }
 }
@@ -572,14 +624,13 @@ void ezFileserveClient::WriteMetaFile(ezStringBuilder sCachedMetaFile, ezInt64 i
   }
 }
 
-void ezFileserveClient::WriteDownloadToDisk(ezStringBuilder sCachedFile)
+void ezFileserveClient::WriteDownloadToDisk(ezStringBuilder sCachedFile, ezArrayPtr<const ezUInt8> content)
 {
-  EZ_LOCK(m_Mutex);
   ezOSFile file;
   if (file.Open(sCachedFile, ezFileOpenMode::Write).Succeeded())
   {
-    if (!m_Download.IsEmpty())
-      file.Write(m_Download.GetData(), m_Download.GetCount());
+    if (!content.IsEmpty())
+      file.Write(content.GetPtr(), content.GetCount());
 
     file.Close();
   }
@@ -624,6 +675,7 @@ ezResult ezFileserveClient::DownloadFile(ezUInt16 uiDataDirID, const char* szFil
     if (out_pFullPath)
       BuildPathInCache(szFile, m_MountedDataDirs[uiUseDataDirCache].m_sMountPoint, out_pFullPath, nullptr);
 
+    AddToSessionManifest(uiUseDataDirCache, szFile);
     return EZ_SUCCESS;
   }
 
@@ -656,6 +708,7 @@ ezResult ezFileserveClient::DownloadFile(ezUInt16 uiDataDirID, const char* szFil
     if (out_pFullPath)
       BuildPathInCache(szFile, m_MountedDataDirs[uiDataDirID].m_sMountPoint, out_pFullPath, nullptr);
 
+    AddToSessionManifest(uiDataDirID, szFile);
     return EZ_SUCCESS;
   }
   else
@@ -670,6 +723,7 @@ ezResult ezFileserveClient::DownloadFile(ezUInt16 uiDataDirID, const char* szFil
       if (out_pFullPath)
         BuildPathInCache(szFile, m_MountedDataDirs[uiBestDir].m_sMountPoint, out_pFullPath, nullptr);
 
+      AddToSessionManifest(uiBestDir, szFile);
       return EZ_SUCCESS;
     }
 
@@ -677,6 +731,250 @@ ezResult ezFileserveClient::DownloadFile(ezUInt16 uiDataDirID, const char* szFil
   }
 }
 
+void ezFileserveClient::PrefetchFiles(ezUInt16 uiDataDirID)
+{
+  EZ_LOCK(m_Mutex);
+
+  auto itManifest = m_PrefetchManifest.Find(m_MountedDataDirs[uiDataDirID].m_sMountPoint);
+  if (!itManifest.IsValid())
+    return;
+
+  ezDynamicArray<ezString> files;
+  files.Swap(itManifest.Value());
+  m_PrefetchManifest.Remove(itManifest);
+
+  // after a batch timed out, the server is not expected to answer any later one, the files are then requested one by one
+  if (m_bPrefetchTimedOut || m_bDownloading || files.IsEmpty() || !m_Network->IsConnectedToServer())
+    return;
+
+  const ezTime tStart = ezTime::Now();
+
+  m_PrefetchGuid.CreateNewUuid();
+  m_PrefetchFiles.Clear();
+  m_PrefetchFiles.SetCount(files.GetCount());
+  m_uiPrefetchedFiles = 0;
+  m_uiPrefetchedBytes = 0;
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  const bool bSupportsCompression = true;
+#else
+  const bool bSupportsCompression = false;
+#endif
+
+  const ezUInt32 uiNumFiles = files.GetCount();
+
+  // send the cache state of all files in one message, the server only has to stream the ones that changed
+  ezRemoteMessage msg('FSRV', 'PRFR');
+  msg.GetWriter() << m_PrefetchGuid;
+  msg.GetWriter() << uiDataDirID;
+  msg.GetWriter() << bSupportsCompression;
+  msg.GetWriter() << uiNumFiles;
+
+  for (ezUInt32 i = 0; i < uiNumFiles; ++i)
+  {
+    FileCacheStatus status;
+    DetermineCacheStatus(uiDataDirID, files[i], status);
+
+    msg.GetWriter() << files[i];
+    msg.GetWriter() << status.m_TimeStamp;
+    msg.GetWriter() << status.m_FileHash;
+
+    m_PrefetchFiles[i].m_sFile = files[i];
+  }
+
+  // prevents resource reloading and nested downloads while the batch is in flight
+  m_bDownloading = true;
+  m_bPrefetching = true;
+
+  m_Network->Send(ezRemoteTransmitMode::Reliable, msg);
+
+  // the server streams the batch without pauses, so if nothing arrives for a while, it most likely does not support prefetching
+  const ezTime timeout = ezTime::Seconds(ezCommandLineUtils::GetGlobalInstance()->GetFloatOption("-fs_prefetch_timeout", 5.0));
+  ezTime tLastMessage = ezTime::Now();
+
+  while (m_bPrefetching && m_Network->IsConnectedToServer())
+  {
+    m_Network->UpdateRemoteInterface();
+
+    if (m_Network->ExecuteAllMessageHandlers() > 0)
+    {
+      tLastMessage = ezTime::Now();
+    }
+    else if (ezTime::Now() - tLastMessage > timeout)
+    {
+      ezLog::Warning("Fileserve prefetch did not finish within {0} seconds, files are requested individually instead", ezArgF(timeout.GetSeconds(), 1));
+      m_bPrefetchTimedOut = true;
+      break;
+    }
+  }
+
+  // files whose state did not arrive keep their old cache status, so they are validated through DownloadFile() on first access
+  // late messages of this batch are ignored
+  m_PrefetchGuid = ezUuid();
+  m_bDownloading = false;
+  m_bPrefetching = false;
+  m_PrefetchFiles.Clear();
+
+  ezLog::Dev("Fileserve prefetched {0} files ({1} downloaded, {2} KB transferred) in {3} ms", uiNumFiles, m_uiPrefetchedFiles,
+    m_uiPrefetchedBytes / 1024, ezArgF((ezTime::Now() - tStart).GetMilliseconds(), 1));
+}
+
+ezFileserveClient::PrefetchFile* ezFileserveClient::GetPrefetchFile(ezRemoteMessage& msg)
+{
+  ezUuid prefetchGuid;
+  msg.GetReader() >> prefetchGuid;
+
+  if (!m_bPrefetching || prefetchGuid != m_PrefetchGuid)
+  {
+    // ezLog::Debug("Fileserver is answering someone else");
+    return nullptr;
+  }
+
+  ezUInt32 uiIndex = 0;
+  msg.GetReader() >> uiIndex;
+
+  if (uiIndex >= m_PrefetchFiles.GetCount())
+    return nullptr;
+
+  return &m_PrefetchFiles[uiIndex];
+}
+
+void ezFileserveClient::HandlePrefetchStatusMsg(ezRemoteMessage& msg)
+{
+  EZ_LOCK(m_Mutex);
+
+  ezUuid prefetchGuid;
+  msg.GetReader() >> prefetchGuid;
+
+  if (!m_bPrefetching || prefetchGuid != m_PrefetchGuid)
+    return;
+
+  ezUInt32 uiNumFiles = 0;
+  msg.GetReader() >> uiNumFiles;
+
+  EZ_ASSERT_DEV(uiNumFiles == m_PrefetchFiles.GetCount(), "Prefetch answer does not match the request");
+
+  for (ezUInt32 i = 0; i < uiNumFiles; ++i)
+  {
+    PrefetchFile& file = m_PrefetchFiles[i];
+
+    ezInt8 iFileStatus = 0;
+    msg.GetReader() >> iFileStatus;
+    file.m_FileState = (ezFileserveFileState)iFileStatus;
+
+    msg.GetReader() >> file.m_iTimestamp;
+    msg.GetReader() >> file.m_uiFileHash;
+    msg.GetReader() >> file.m_uiFoundInDataDir;
+
+    // changed files are applied once their content has arrived
+    if (file.m_FileState != ezFileserveFileState::Different)
+    {
+      ApplyFileState(file.m_sFile, file.m_FileState, file.m_iTimestamp, file.m_uiFileHash, file.m_uiFoundInDataDir, ezArrayPtr<const ezUInt8>());
+    }
+  }
+}
+
+void ezFileserveClient::HandlePrefetchHeaderMsg(ezRemoteMessage& msg)
+{
+  EZ_LOCK(m_Mutex);
+
+  PrefetchFile* pFile = GetPrefetchFile(msg);
+  if (pFile == nullptr)
+    return;
+
+  // the server reads the file only now, the state and hash describe the data that actually follows
+  ezInt8 iFileStatus = 0;
+  msg.GetReader() >> iFileStatus;
+  pFile->m_FileState = (ezFileserveFileState)iFileStatus;
+
+  msg.GetReader() >> pFile->m_iTimestamp;
+  msg.GetReader() >> pFile->m_uiFileHash;
+  msg.GetReader() >> pFile->m_bCompressed;
+  msg.GetReader() >> pFile->m_uiFileSize;
+  msg.GetReader() >> pFile->m_uiTransferSize;
+
+  pFile->m_Data.Clear();
+  pFile->m_Data.Reserve(pFile->m_uiTransferSize);
+
+  // empty files don't have any data messages
+  if (pFile->m_uiTransferSize == 0)
+  {
+    FinishPrefetchedFile(*pFile);
+  }
+}
+
+void ezFileserveClient::HandlePrefetchDataMsg(ezRemoteMessage& msg)
+{
+  EZ_LOCK(m_Mutex);
+
+  PrefetchFile* pFile = GetPrefetchFile(msg);
+  if (pFile == nullptr)
+    return;
+
+  ezUInt32 uiChunkSize = 0;
+  msg.GetReader() >> uiChunkSize;
+
+  if (uiChunkSize > 0)
+  {
+    const ezUInt32 uiStartPos = pFile->m_Data.GetCount();
+    pFile->m_Data.SetCountUninitialized(uiStartPos + uiChunkSize);
+    msg.GetReader().ReadBytes(&pFile->m_Data[uiStartPos], uiChunkSize);
+  }
+
+  if (pFile->m_Data.GetCount() == pFile->m_uiTransferSize)
+  {
+    FinishPrefetchedFile(*pFile);
+  }
+}
+
+void ezFileserveClient::HandlePrefetchFinishedMsg(ezRemoteMessage& msg)
+{
+  EZ_LOCK(m_Mutex);
+
+  ezUuid prefetchGuid;
+  msg.GetReader() >> prefetchGuid;
+
+  if (prefetchGuid == m_PrefetchGuid)
+  {
+    m_bPrefetching = false;
+  }
+}
+
+void ezFileserveClient::FinishPrefetchedFile(PrefetchFile& file)
+{
+  EZ_LOCK(m_Mutex);
+
+  m_uiPrefetchedBytes += file.m_uiTransferSize;
+  ++m_uiPrefetchedFiles;
+
+  if (file.m_bCompressed)
+  {
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    ezDynamicArray<ezUInt8> content;
+    content.SetCountUninitialized(file.m_uiFileSize);
+
+    ezRawMemoryStreamReader reader(file.m_Data);
+    ezCompressedStreamReaderZstd decompressor(&reader);
+
+    if (decompressor.ReadBytes(content.GetData(), content.GetCount()) != content.GetCount())
+    {
+      ezLog::Error("Failed to decompress prefetched file '{0}'", file.m_sFile);
+      file.m_Data.Clear();
+      return;
+    }
+
+    file.m_Data.Swap(content);
+#else
+    EZ_REPORT_FAILURE("Fileserver sent compressed data, although it was requested uncompressed");
+#endif
+  }
+
+  ApplyFileState(file.m_sFile, file.m_FileState, file.m_iTimestamp, file.m_uiFileHash, file.m_uiFoundInDataDir, file.m_Data);
+
+  file.m_Data.Clear();
+  file.m_Data.Compact();
+}
+
 void ezFileserveClient::DetermineCacheStatus(ezUInt16 uiDataDirID, const char* szFile, FileCacheStatus& out_Status) const
 {
   EZ_LOCK(m_Mutex);
@@ -702,6 +1000,87 @@ void ezFileserveClient::DetermineCacheStatus(ezUInt16 uiDataDirID, const char* s
   }
 }
 
+void ezFileserveClient::AddToSessionManifest(ezUInt16 uiDataDirID, const char* szFile)
+{
+  EZ_LOCK(m_Mutex);
+
+  ezStringBuilder sEntry = m_MountedDataDirs[uiDataDirID].m_sMountPoint;
+  sEntry.AppendPath(szFile);
+  m_SessionManifest.Insert(sEntry);
+}
+
+void ezFileserveClient::LoadPrefetchManifest()
+{
+  EZ_LOCK(m_Mutex);
+
+  // every application gets its own manifest, since different programs typically access very different files
+  ezStringBuilder sAppName = "Default";
+  if (ezApplication::GetApplicationInstance() != nullptr && !ezApplication::GetApplicationInstance()->GetApplicationName().IsEmpty())
+  {
+    sAppName = ezApplication::GetApplicationInstance()->GetApplicationName();
+  }
+
+  sAppName.Append(".txt");
+  ezStringBuilder sManifestFile = m_sFileserveDataFolder;
+  sManifestFile.AppendPath("Manifests");
+  ezOSFile::CreateDirectoryStructure(sManifestFile);
+
+  sManifestFile.AppendPath(sAppName);
+  m_sFileserveManifestFile = sManifestFile;
+
+  m_PrefetchManifest.Clear();
+
+  ezOSFile file;
+  if (file.Open(m_sFileserveManifestFile, ezFileOpenMode::Read).Failed())
+    return;
+
+  ezDynamicArray<ezUInt8> content;
+  file.ReadAll(content);
+  content.PushBack(0);
+
+  ezStringBuilder sContent = (const char*)content.GetData();
+
+  ezDynamicArray<ezStringView> lines;
+  sContent.Split(false, lines, "\n", "\r");
+
+  // each line is "mount point/file", see AddToSessionManifest()
+  ezStringBuilder sLine, sMountPoint;
+  for (const ezStringView& line : lines)
+  {
+    sLine = line;
+
+    const char* szSeparator = sLine.FindSubString("/");
+    if (szSeparator == nullptr)
+      continue;
+
+    sMountPoint.SetSubString_FromTo(sLine.GetData(), szSeparator);
+    m_PrefetchManifest[sMountPoint].PushBack(szSeparator + 1);
+  }
+}
+
+void ezFileserveClient::SaveSessionManifest() const
+{
+  EZ_LOCK(m_Mutex);
+
+  if (m_SessionManifest.IsEmpty() || m_sFileserveManifestFile.IsEmpty())
+    return;
+
+  ezStringBuilder sContent;
+  for (const ezString& sEntry : m_SessionManifest)
+  {
+    sContent.Append(sEntry, "\n");
+  }
+
+  ezOSFile file;
+  if (file.Open(m_sFileserveManifestFile, ezFileOpenMode::Write).Failed())
+  {
+    ezLog::Error("Failed to write fileserve manifest to '{0}'", m_sFileserveManifestFile);
+    return;
+  }
+
+  file.Write(sContent.GetData(), sContent.GetElementCount());
+}
+
 ezResult ezFileserveClient::TryReadFileserveConfig(const char* szFile, ezStringBuilder& out_Result)
 {
   ezOSFile file;
@@ -2,8 +2,10 @@
 
 #include <FileservePlugin/FileservePluginDLL.h>
 
+#include <FileservePlugin/Fileserver/ClientContext.h>
 #include <Foundation/Communication/RemoteInterface.h>
 #include <Foundation/Configuration/Singleton.h>
+#include <Foundation/Containers/Set.h>
 #include <Foundation/Types/UniquePtr.h>
 #include <Foundation/Types/Uuid.h>
 
@@ -24,6 +26,13 @@ namespace ezDataDirectory
 /// The timeout for connecting to the server can be configured through the command line option "-fs_timeout seconds"
 /// The server to connect to can be configured through command line option "-fs_server address".
 /// The default address is "localhost:1042".
+///
+/// The client records which files were accessed in which data directory during a session and stores that manifest in the user data
+/// folder when the connection is shut down. On the next start, whenever a data directory gets mounted, all files from the manifest for that
+/// data directory are requested in one batch. The server answers with the state of all those files at once and then streams the changed
+/// files, so that validating the cache and downloading the data does not require a full round-trip per file.
+/// If the server does not answer a batch within the timeout given through the command line option "-fs_prefetch_timeout seconds"
+/// (default 5), prefetching is disabled for the rest of the connection and all files are requested individually.
 class EZ_FILESERVEPLUGIN_DLL ezFileserveClient
 {
   EZ_DECLARE_SINGLETON(ezFileserveClient);
@@ -60,6 +69,11 @@ public:
   /// Also achieved through the command line argument "-fs_off"
   static void DisabledFileserveClient() { s_bEnableFileserve = false; }
 
+  /// \brief Enables the file serving functionality again, after DisabledFileserveClient() was called.
+  ///
+  /// Creating an ezFileserver disables the client, this allows to run both in the same process nonetheless, e.g. for testing.
+  static void EnableFileserveClient() { s_bEnableFileserve = true; }
+
   /// \brief Returns the address through which the Fileserve client tried to connect with the server last.
   const char* GetServerConnectionAddress() { return m_sServerConnectionAddress; }
 
@@ -79,6 +93,16 @@ public:
   /// \brief Adds an address that should be tried for connecting with the server.
   void AddServerAddressToTry(const char* szAddress);
 
+  /// \brief Changes the folder in which the cached files, their meta data and the prefetch manifests are stored.
+  ///
+  /// By default this is 'ezFileserve' in the user data folder. Has to be called before the connection is established, see EnsureConnected().
+  void SetFileserveDataFolder(const char* szFolder) { m_sFileserveDataFolder = szFolder; }
+
+  /// \brief Returns the folders in which the files and the meta data of the given data directory are cached.
+  ///
+  /// Only valid once a connection was established, see EnsureConnected().
+  void GetFullDataDirCachePath(const char* szDataDir, ezStringBuilder& out_sFullPath, ezStringBuilder& out_sFullPathMeta) const;
+
 private:
   friend class ezDataDirectory::FileserveType;
 
@@ -102,18 +126,39 @@ private:
     ezMap<ezString, FileCacheStatus> m_CacheStatus;
   };
 
+  struct PrefetchFile
+  {
+    ezString m_sFile;
+    ezFileserveFileState m_FileState = ezFileserveFileState::None;
+    ezInt64 m_iTimestamp = 0;
+    ezUInt64 m_uiFileHash = 0;
+    ezUInt16 m_uiFoundInDataDir = 0;
+    bool m_bCompressed = false;
+    ezUInt32 m_uiFileSize = 0;
+    ezUInt32 m_uiTransferSize = 0;
+    ezDynamicArray<ezUInt8> m_Data;
+  };
+
   void DeleteFile(ezUInt16 uiDataDir, const char* szFile);
   ezUInt16 MountDataDirectory(const char* szDataDir, const char* szRootName);
   void UnmountDataDirectory(ezUInt16 uiDataDir);
   static void ComputeDataDirMountPoint(const char* szDataDir, ezStringBuilder& out_sMountPoint);
   void BuildPathInCache(const char* szFile, const char* szMountPoint, ezStringBuilder* out_pAbsPath,
     ezStringBuilder* out_pFullPathMeta) const;
-  void GetFullDataDirCachePath(const char* szDataDir, ezStringBuilder& out_sFullPath, ezStringBuilder& out_sFullPathMeta) const;
   void NetworkMsgHandler(ezRemoteMessage& msg);
   void HandleFileTransferMsg(ezRemoteMessage& msg);
   void HandleFileTransferFinishedMsg(ezRemoteMessage& msg);
+  PrefetchFile* GetPrefetchFile(ezRemoteMessage& msg);
+  void HandlePrefetchStatusMsg(ezRemoteMessage& msg);
+  void HandlePrefetchHeaderMsg(ezRemoteMessage& msg);
+  void HandlePrefetchDataMsg(ezRemoteMessage& msg);
+  void HandlePrefetchFinishedMsg(ezRemoteMessage& msg);
+  void FinishPrefetchedFile(PrefetchFile& file);
+  void PrefetchFiles(ezUInt16 uiDataDirID);
+  void ApplyFileState(const char* szFile, ezFileserveFileState fileState, ezInt64 iFileTimeStamp, ezUInt64 uiFileHash,
+    ezUInt16 uiFoundInDataDir, ezArrayPtr<const ezUInt8> content);
   static void WriteMetaFile(ezStringBuilder sCachedMetaFile, ezInt64 iFileTimeStamp, ezUInt64 uiFileHash);
-  void WriteDownloadToDisk(ezStringBuilder sCachedFile);
+  static void WriteDownloadToDisk(ezStringBuilder sCachedFile, ezArrayPtr<const ezUInt8> content);
   ezResult DownloadFile(ezUInt16 uiDataDirID, const char* szFile, bool bForceThisDataDir, ezStringBuilder* out_pFullPath);
   void DetermineCacheStatus(ezUInt16 uiDataDirID, const char* szFile, FileCacheStatus& out_Status) const;
   void UploadFile(ezUInt16 uiDataDirID, const char* szFile, const ezDynamicArray<ezUInt8>& fileContent);
@@ -121,23 +166,37 @@ private:
   static ezResult TryReadFileserveConfig(const char* szFile, ezStringBuilder& out_Result);
   ezResult TryConnectWithFileserver(const char* szAddress, ezTime timeout) const;
   void FillFileStatusCache(const char* szFile);
+  void AddToSessionManifest(ezUInt16 uiDataDirID, const char* szFile);
+  void LoadPrefetchManifest();
+  void SaveSessionManifest() const;
   void ShutdownConnection();
   void ClearState();
 
   mutable ezMutex m_Mutex;
   mutable ezString m_sServerConnectionAddress;
+  ezString m_sFileserveDataFolder;
   ezString m_sFileserveCacheFolder;
   ezString m_sFileserveCacheMetaFolder;
+  ezString m_sFileserveManifestFile;
   bool m_bDownloading = false;
+  bool m_bPrefetching = false;
+  bool m_bPrefetchTimedOut = false;
   bool m_bFailedToConnect = false;
   bool m_bWaitingForUploadFinished = false;
   ezUuid m_CurFileRequestGuid;
   ezStringBuilder m_sCurFileRequest;
   ezUniquePtr<ezRemoteInterface> m_Network;
   ezDynamicArray<ezUInt8> m_Download;
+  ezUuid m_PrefetchGuid;
+  ezDynamicArray<PrefetchFile> m_PrefetchFiles;
+  ezUInt32 m_uiPrefetchedFiles = 0;
+  ezUInt64 m_uiPrefetchedBytes = 0;
   ezTime m_CurrentTime;
   ezHybridArray<ezString, 4> m_TryServerAddresses;
 
   ezMap<ezString, ezUInt16> m_FileDataDir;
   ezHybridArray<DataDir, 8> m_MountedDataDirs;
+
+  ezMap<ezString, ezDynamicArray<ezString>> m_PrefetchManifest; // mount point -> files accessed in the previous session
+  ezSet<ezString> m_SessionManifest;                            // "mount point/file" of every file accessed in this session
 };
@@ -1,7 +1,7 @@
 #include <FileservePluginPCH.h>
 
 #include <FileservePlugin/Fileserver/ClientContext.h>
-#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/OSFile.h>
 
 ezFileserveFileState ezFileserveClientContext::GetFileStatus(ezUInt16& inout_uiDataDirID, const char* szRequestedFile,
                                                              FileStatus& inout_Status, ezDynamicArray<ezUInt8>& out_FileContent,
@@ -39,9 +39,10 @@ ezFileserveFileState ezFileserveClientContext::GetFileStatus(ezUInt16& inout_uiD
     inout_Status.m_iTimestamp = iNewTimestamp;
 
     // read the entire file
+    // the path is absolute, ezOSFile avoids the file system lock, which a client in the same process may hold while it waits for us
     {
-      ezFileReader file;
-      if (file.Open(sAbsPath).Failed())
+      ezOSFile file;
+      if (file.Open(sAbsPath, ezFileOpenMode::Read).Failed())
         continue;
 
       ezUInt64 uiNewHash = 1;
@@ -49,7 +50,7 @@ ezFileserveFileState ezFileserveClientContext::GetFileStatus(ezUInt16& inout_uiD
 
       if (!out_FileContent.IsEmpty())
       {
-        file.ReadBytes(out_FileContent.GetData(), out_FileContent.GetCount());
+        file.Read(out_FileContent.GetData(), out_FileContent.GetCount());
         uiNewHash = ezHashingUtils::xxHash64(out_FileContent.GetData(), (size_t)out_FileContent.GetCount(), uiNewHash);
 
         // if the file is empty, the hash will be zero, which could lead to an incorrect assumption that the hash is the same
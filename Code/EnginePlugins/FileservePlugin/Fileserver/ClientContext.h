@@ -1,8 +1,10 @@
 #pragma once
 
 #include <FileservePlugin/FileservePluginDLL.h>
+#include <Foundation/Containers/Deque.h>
 #include <Foundation/Containers/HybridArray.h>
 #include <Foundation/Strings/String.h>
+#include <Foundation/Types/Uuid.h>
 
 enum class ezFileserveFileState
 {
@@ -34,10 +36,31 @@ public:
     ezUInt64 m_uiFileSize = 0;
   };
 
+  /// \brief A file of a prefetch batch whose content still has to be streamed to the client.
+  struct PrefetchTransfer
+  {
+    ezUInt32 m_uiIndex = 0; ///< Index of the file in the client's request
+    ezUInt16 m_uiDataDirID = 0;
+    ezString m_sFile;
+  };
+
+  /// \brief All files of one prefetch request, which are streamed to the client over multiple server updates.
+  struct PrefetchBatch
+  {
+    ezUuid m_BatchGuid;
+    bool m_bAllowCompression = false;
+    ezDynamicArray<PrefetchTransfer> m_Transfers;
+    ezUInt32 m_uiNextTransfer = 0;
+    bool m_bTransferStarted = false;
+    ezUInt32 m_uiTransferBytesSent = 0;
+    ezDynamicArray<ezUInt8> m_TransferData; ///< The (compressed) content of the file that is currently being sent, only this one file is buffered at a time
+  };
+
   ezFileserveFileState GetFileStatus(ezUInt16& inout_uiDataDirID, const char* szRequestedFile, FileStatus& inout_Status, ezDynamicArray<ezUInt8>& out_FileContent, bool bForceThisDataDir) const;
 
   bool m_bLostConnection = false;
   ezUInt32 m_uiApplicationID = 0;
   ezHybridArray<DataDir, 8> m_MountedDataDirs;
+  ezDeque<PrefetchBatch> m_PrefetchBatches;
 };
 
@@ -4,11 +4,22 @@
 #include <FileservePlugin/Fileserver/Fileserver.h>
 #include <Foundation/Algorithm/HashingUtils.h>
 #include <Foundation/Communication/RemoteInterfaceEnet.h>
+#include <Foundation/IO/CompressedStreamZstd.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <Foundation/Utilities/CommandLineUtils.h>
 
 EZ_IMPLEMENT_SINGLETON(ezFileserver);
 
+// prefetched files are sent in larger chunks than regular downloads, because there is no per-file round-trip to amortize
+static constexpr ezUInt32 s_uiPrefetchChunkSize = 1024 * 16;
+
+// how much prefetch data is queued per client and server update, so that a large batch does not block all other requests
+static constexpr ezUInt32 s_uiPrefetchBytesPerUpdate = 1024 * 1024;
+
+// tiny files are not worth compressing
+static constexpr ezUInt32 s_uiPrefetchMinCompressionSize = 256;
+
 ezFileserver::ezFileserver()
     : m_SingletonRegistrar(this)
 {
@@ -55,7 +66,15 @@ bool ezFileserver::UpdateServer()
     return false;
 
   m_Network->UpdateRemoteInterface();
-  return m_Network->ExecuteAllMessageHandlers() > 0;
+  bool bWorkDone = m_Network->ExecuteAllMessageHandlers() > 0;
+
+  for (auto it = m_Clients.GetIterator(); it.IsValid(); ++it)
+  {
+    if (SendPrefetchData(it.Value()))
+      bWorkDone = true;
+  }
+
+  return bWorkDone;
 }
 
 bool ezFileserver::IsServerRunning() const
@@ -102,6 +121,12 @@ void ezFileserver::NetworkMsgHandler(ezRemoteMessage& msg)
     return;
   }
 
+  if (msg.GetMessageID() == 'PRFR')
+  {
+    HandlePrefetchRequest(client, msg);
+    return;
+  }
+
   if (msg.GetMessageID() == 'UPLH')
   {
     HandleUploadFileHeader(client, msg);
@@ -157,6 +182,7 @@ void ezFileserver::NetworkEventHandler(const ezRemoteEvent& e)
         m_Events.Broadcast(se);
 
         m_Clients[e.m_uiOtherAppID].m_bLostConnection = true;
+        m_Clients[e.m_uiOtherAppID].m_PrefetchBatches.Clear();
       }
     }
     break;
@@ -334,6 +360,203 @@ void ezFileserver::HandleFileRequest(ezFileserveClientContext& client, ezRemoteM
   }
 }
 
+void ezFileserver::HandlePrefetchRequest(ezFileserveClientContext& client, ezRemoteMessage& msg)
+{
+  ezUuid batchGuid;
+  msg.GetReader() >> batchGuid;
+
+  ezUInt16 uiDataDirID = 0;
+  msg.GetReader() >> uiDataDirID;
+
+  bool bAllowCompression = false;
+  msg.GetReader() >> bAllowCompression;
+
+  ezUInt32 uiNumFiles = 0;
+  msg.GetReader() >> uiNumFiles;
+
+  auto& batch = client.m_PrefetchBatches.ExpandAndGetRef();
+  batch.m_BatchGuid = batchGuid;
+  batch.m_bAllowCompression = bAllowCompression;
+
+  // the state of all requested files is sent back in one message
+  // only the content of files that changed is streamed afterwards, see SendPrefetchData()
+  ezRemoteMessage ret('FSRV', 'PRFS');
+  ret.GetWriter() << batchGuid;
+  ret.GetWriter() << uiNumFiles;
+
+  ezStringBuilder sRequestedFile;
+
+  for (ezUInt32 i = 0; i < uiNumFiles; ++i)
+  {
+    msg.GetReader() >> sRequestedFile;
+
+    ezFileserveClientContext::FileStatus status;
+    msg.GetReader() >> status.m_iTimestamp;
+    msg.GetReader() >> status.m_uiHash;
+
+    // m_SendToClient only serves as scratch memory for hashing, the content of changed files is read again once it gets sent
+    ezUInt16 uiFoundInDataDir = uiDataDirID;
+    const ezFileserveFileState filestate = client.GetFileStatus(uiFoundInDataDir, sRequestedFile, status, m_SendToClient, true);
+
+    ret.GetWriter() << (ezInt8)filestate;
+    ret.GetWriter() << status.m_iTimestamp;
+    ret.GetWriter() << status.m_uiHash;
+    ret.GetWriter() << uiFoundInDataDir;
+
+    ezFileserverEvent e;
+    e.m_Type = ezFileserverEvent::Type::FileDownloadRequest;
+    e.m_uiClientID = client.m_uiApplicationID;
+    e.m_szPath = sRequestedFile;
+    e.m_uiSizeTotal = (ezUInt32)status.m_uiFileSize;
+    e.m_FileState = filestate;
+    m_Events.Broadcast(e);
+
+    if (filestate == ezFileserveFileState::Different)
+    {
+      auto& transfer = batch.m_Transfers.ExpandAndGetRef();
+      transfer.m_uiIndex = i;
+      transfer.m_uiDataDirID = uiFoundInDataDir;
+      transfer.m_sFile = sRequestedFile;
+    }
+    else
+    {
+      e.m_Type = ezFileserverEvent::Type::FileDownloadFinished;
+      m_Events.Broadcast(e);
+    }
+  }
+
+  m_Network->Send(ezRemoteTransmitMode::Reliable, ret);
+}
+
+void ezFileserver::StartPrefetchTransfer(const ezFileserveClientContext& client, ezFileserveClientContext::PrefetchBatch& batch)
+{
+  const auto& transfer = batch.m_Transfers[batch.m_uiNextTransfer];
+
+  batch.m_bTransferStarted = true;
+  batch.m_uiTransferBytesSent = 0;
+  batch.m_TransferData.Clear();
+
+  // the file is only read now, so that a batch never holds more than one file in memory
+  // it may have changed since the request was validated, therefore the state and hash of exactly these bytes are sent along
+  ezUInt16 uiDataDirID = transfer.m_uiDataDirID;
+  ezFileserveClientContext::FileStatus status;
+  ezFileserveFileState filestate = client.GetFileStatus(uiDataDirID, transfer.m_sFile, status, m_SendToClient, true);
+
+  if (filestate != ezFileserveFileState::Different)
+  {
+    // the file was removed in the meantime
+    filestate = ezFileserveFileState::NonExistant;
+    m_SendToClient.Clear();
+  }
+
+  const ezUInt32 uiFileSize = m_SendToClient.GetCount();
+  bool bCompressed = false;
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  if (batch.m_bAllowCompression && uiFileSize >= s_uiPrefetchMinCompressionSize)
+  {
+    ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> storage(&batch.m_TransferData);
+    ezMemoryStreamWriter writer(&storage);
+    ezCompressedStreamWriterZstd compressor(&writer);
+    compressor.WriteBytes(m_SendToClient.GetData(), uiFileSize);
+    compressor.FinishCompressedStream();
+
+    bCompressed = batch.m_TransferData.GetCount() < uiFileSize;
+  }
+#endif
+
+  if (!bCompressed)
+  {
+    batch.m_TransferData.Swap(m_SendToClient);
+  }
+
+  m_SendToClient.Clear();
+
+  const ezUInt32 uiTransferSize = batch.m_TransferData.GetCount();
+
+  ezRemoteMessage ret('FSRV', 'PRFH');
+  ret.GetWriter() << batch.m_BatchGuid;
+  ret.GetWriter() << transfer.m_uiIndex;
+  ret.GetWriter() << (ezInt8)filestate;
+  ret.GetWriter() << status.m_iTimestamp;
+  ret.GetWriter() << status.m_uiHash;
+  ret.GetWriter() << bCompressed;
+  ret.GetWriter() << uiFileSize;
+  ret.GetWriter() << uiTransferSize;
+
+  m_Network->Send(ezRemoteTransmitMode::Reliable, ret);
+}
+
+bool ezFileserver::SendPrefetchData(ezFileserveClientContext& client)
+{
+  if (client.m_PrefetchBatches.IsEmpty())
+    return false;
+
+  ezUInt32 uiBudget = s_uiPrefetchBytesPerUpdate;
+
+  while (!client.m_PrefetchBatches.IsEmpty() && uiBudget > 0)
+  {
+    auto& batch = client.m_PrefetchBatches.PeekFront();
+
+    if (batch.m_uiNextTransfer == batch.m_Transfers.GetCount())
+    {
+      // messages are delivered in order, so once the client sees this, it has received all data of the batch
+      ezRemoteMessage ret('FSRV', 'PRFF');
+      ret.GetWriter() << batch.m_BatchGuid;
+      m_Network->Send(ezRemoteTransmitMode::Reliable, ret);
+
+      client.m_PrefetchBatches.PopFront();
+      continue;
+    }
+
+    if (!batch.m_bTransferStarted)
+    {
+      StartPrefetchTransfer(client, batch);
+    }
+
+    const auto& transfer = batch.m_Transfers[batch.m_uiNextTransfer];
+    const ezUInt32 uiTransferSize = batch.m_TransferData.GetCount();
+
+    ezFileserverEvent e;
+    e.m_Type = ezFileserverEvent::Type::FileDownloading;
+    e.m_uiClientID = client.m_uiApplicationID;
+    e.m_szPath = transfer.m_sFile;
+    e.m_uiSizeTotal = uiTransferSize;
+
+    while (batch.m_uiTransferBytesSent < uiTransferSize && uiBudget > 0)
+    {
+      const ezUInt32 uiChunkSize = ezMath::Min<ezUInt32>(s_uiPrefetchChunkSize, uiTransferSize - batch.m_uiTransferBytesSent);
+
+      ezRemoteMessage ret;
+      ret.GetWriter() << batch.m_BatchGuid;
+      ret.GetWriter() << transfer.m_uiIndex;
+      ret.GetWriter() << uiChunkSize;
+      ret.GetWriter().WriteBytes(&batch.m_TransferData[batch.m_uiTransferBytesSent], uiChunkSize);
+
+      ret.SetMessageID('FSRV', 'PRFD');
+      m_Network->Send(ezRemoteTransmitMode::Reliable, ret);
+
+      batch.m_uiTransferBytesSent += uiChunkSize;
+      uiBudget -= ezMath::Min(uiBudget, uiChunkSize);
+
+      e.m_uiSentTotal = batch.m_uiTransferBytesSent;
+      m_Events.Broadcast(e);
+    }
+
+    if (batch.m_uiTransferBytesSent == uiTransferSize)
+    {
+      e.m_Type = ezFileserverEvent::Type::FileDownloadFinished;
+      m_Events.Broadcast(e);
+
+      ++batch.m_uiNextTransfer;
+      batch.m_bTransferStarted = false;
+      batch.m_TransferData.Clear();
+    }
+  }
+
+  return true;
+}
+
 void ezFileserver::HandleDeleteFileRequest(ezFileserveClientContext& client, ezRemoteMessage& msg)
 {
   ezUInt16 uiDataDirID = 0xffff;
@@ -53,6 +53,10 @@ struct ezFileserverEvent
 /// needs to know what local path to map them to (it uses the configuration on ezFileSystem).
 /// That means it cannot serve two clients that require different settings for the same special directory.
 ///
+/// Clients may request many files at once through a prefetch request (see ezFileserveClient). The server answers with the state of all
+/// those files in a single message and then streams the (compressed) content of all changed files over the next server updates,
+/// without waiting for the client to ask for the next file.
+///
 /// The port on which the server connects to clients can be configured through the command line option "-fs_port X"
 class EZ_FILESERVEPLUGIN_DLL ezFileserver
 {
@@ -94,6 +98,9 @@ private:
   void HandleMountRequest(ezFileserveClientContext& client, ezRemoteMessage &msg);
   void HandleUnmountRequest(ezFileserveClientContext& client, ezRemoteMessage &msg);
   void HandleFileRequest(ezFileserveClientContext& client, ezRemoteMessage &msg);
+  void HandlePrefetchRequest(ezFileserveClientContext& client, ezRemoteMessage &msg);
+  bool SendPrefetchData(ezFileserveClientContext& client);
+  void StartPrefetchTransfer(const ezFileserveClientContext& client, ezFileserveClientContext::PrefetchBatch& batch);
   void HandleDeleteFileRequest(ezFileserveClientContext& client, ezRemoteMessage &msg);
   void HandleUploadFileHeader(ezFileserveClientContext& client, ezRemoteMessage &msg);
   void HandleUploadFileTransfer(ezFileserveClientContext& client, ezRemoteMessage &msg);
@@ -47,6 +47,9 @@ void RemoveFileSystemEventHandler();
 void AddResourceManagerEventHandler();
 void RemoveResourceManagerEventHandler();
 
+void AddProfilingEventHandler();
+void RemoveProfilingEventHandler();
+
 void SetAppStats();
 
 // clang-format off
@@ -72,12 +75,14 @@ EZ_BEGIN_SUBSYSTEM_DECLARATION(InspectorPlugin, InspectorPluginMain)
     AddTimeEventHandler();
     AddFileSystemEventHandler();
     AddResourceManagerEventHandler();
+    AddProfilingEventHandler();
 
     SetAppStats();
   }
 
   ON_CORESYSTEMS_SHUTDOWN
   {
+    RemoveProfilingEventHandler();
     RemoveResourceManagerEventHandler();
     RemoveFileSystemEventHandler();
     RemoveTimeEventHandler();
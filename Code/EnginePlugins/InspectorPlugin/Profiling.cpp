@@ -0,0 +1,489 @@
+#include <InspectorPluginPCH.h>
+
+#include <Foundation/Communication/Telemetry.h>
+#include <Foundation/IO/CompressedStreamZstd.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Memory/MemoryTracker.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Utilities/Stats.h>
+
+#include <GameEngine/GameApplication/GameApplicationBase.h>
+
+// Streams the profiling scopes, frame times, task system utilization and allocator stats to the Inspector, while it shows the profiling
+// view. Each update only contains the data that was recorded since the last update. All names are sent once and referenced by index
+// afterwards, all integers are variable-length encoded and time stamps are stored as deltas. The packet is then compressed, if possible.
+//
+// Packet layout (see ezQtProfilingWidget for the decoder):
+//   varuint  base time in microseconds
+//   varuint  number of new strings, followed by that many strings (the string index continues from the previous packet)
+//   varuint  number of new threads, each: varuint name index
+//   varuint  number of frames, each: varint start time delta
+//   varuint  number of thread buffers, each: varuint thread index, varuint number of scopes,
+//            each scope: varuint name index, varint begin time delta, varuint duration
+//   varuint  number of GPU scopes, each like a CPU scope
+//   varuint  number of worker threads, each: uint8 worker type, uint8 utilization (0 - 255), varuint number of tasks
+//   varuint  number of changed allocators, each: varuint allocator id, varuint name index, varuint parent id + 1,
+//            varuint live allocations, varuint allocation size
+//
+// Time deltas are relative to the previous time stamp in the same list, starting with the base time.
+//
+// Every 'DATA' message starts with the session ID of the 'ENBL' message that started the stream, so that the Inspector can drop packets
+// that still refer to the string and thread tables of a previous stream.
+
+ezCVarBool CVarProfilingStream("Inspector.ProfilingStream", true, ezCVarFlags::Default, "Allows streaming live profiling data to the Inspector, when it requests it");
+ezCVarInt CVarProfilingStreamIntervalMs("Inspector.ProfilingStreamIntervalMs", 100, ezCVarFlags::Default, "How often profiling data is sent to the Inspector");
+ezCVarInt CVarProfilingStreamMaxKBps("Inspector.ProfilingStreamMaxKBps", 512, ezCVarFlags::Default, "Bandwidth limit for the profiling stream in KB per second");
+
+namespace ProfilingDetail
+{
+  class Encoder
+  {
+  public:
+    void Clear() { m_Data.Clear(); }
+
+    void UInt(ezUInt64 uiValue)
+    {
+      while (uiValue >= 0x80)
+      {
+        m_Data.PushBack(static_cast<ezUInt8>(uiValue | 0x80));
+        uiValue >>= 7;
+      }
+
+      m_Data.PushBack(static_cast<ezUInt8>(uiValue));
+    }
+
+    void Int(ezInt64 iValue) { UInt((static_cast<ezUInt64>(iValue) << 1) ^ static_cast<ezUInt64>(iValue >> 63)); }
+
+    void Byte(ezUInt8 uiValue) { m_Data.PushBack(uiValue); }
+
+    void String(const char* szString)
+    {
+      const ezUInt32 uiLength = ezStringUtils::GetStringElementCount(szString);
+      UInt(uiLength);
+      m_Data.PushBackRange(ezMakeArrayPtr(reinterpret_cast<const ezUInt8*>(szString), uiLength));
+    }
+
+    ezDynamicArray<ezUInt8> m_Data;
+  };
+
+  struct StreamState
+  {
+    bool m_bRequested = false;
+    bool m_bAllowCompression = false;
+    bool m_bActive = false;
+    ezUInt32 m_uiSessionID = 0;
+
+    ezProfilingSystem::CaptureCursor m_Cursor;
+    ezHashTable<ezString, ezUInt32> m_StringTable;
+    ezHashTable<ezUInt64, ezUInt32> m_ThreadIndices;
+    ezHashTable<ezUInt32, ezAllocatorBase::Stats> m_SentAllocatorStats;
+
+    ezDynamicArray<const char*> m_NewStrings;
+    ezUInt32 m_uiNumStrings = 0;
+
+    ezTime m_LastUpdate;
+    ezTime m_LastSend;
+    double m_fBandwidthBudget = 0.0;
+
+    Encoder m_Header;
+    Encoder m_Body;
+    Encoder m_Allocators;
+    ezDynamicArray<ezUInt8> m_Compressed;
+
+    // for the stats
+    ezTime m_StatsStart;
+    ezUInt64 m_uiStatsBytesSent = 0;
+    ezUInt64 m_uiStatsBytesUncompressed = 0;
+    ezUInt64 m_uiStatsScopesSent = 0;
+    ezTime m_StatsEncodeTime;
+  };
+
+  static StreamState s_State;
+
+  static void Reset()
+  {
+    s_State.m_bActive = false;
+    s_State.m_Cursor = ezProfilingSystem::CaptureCursor();
+    s_State.m_StringTable.Clear();
+    s_State.m_ThreadIndices.Clear();
+    s_State.m_SentAllocatorStats.Clear();
+    s_State.m_uiNumStrings = 0;
+    s_State.m_fBandwidthBudget = 0.0;
+  }
+
+  static ezUInt32 InternString(const char* szString)
+  {
+    ezUInt32 uiIndex = 0;
+    if (s_State.m_StringTable.TryGetValue(szString, uiIndex))
+      return uiIndex;
+
+    uiIndex = s_State.m_uiNumStrings++;
+    s_State.m_StringTable.Insert(szString, uiIndex);
+
+    // the captured data outlives the packet, so the pointer stays valid until the header is written
+    s_State.m_NewStrings.PushBack(szString);
+
+    return uiIndex;
+  }
+
+  static void EncodeScopes(const ezDynamicArray<ezProfilingSystem::CPUScope>& scopes, ezTime baseTime)
+  {
+    Encoder& body = s_State.m_Body;
+    ezInt64 iPrevBegin = (ezInt64)baseTime.GetMicroseconds();
+
+    body.UInt(scopes.GetCount());
+
+    for (const auto& scope : scopes)
+    {
+      const ezInt64 iBegin = (ezInt64)scope.m_BeginTime.GetMicroseconds();
+      const ezInt64 iEnd = (ezInt64)scope.m_EndTime.GetMicroseconds();
+
+      body.UInt(InternString(scope.m_szName));
+      body.Int(iBegin - iPrevBegin);
+      body.UInt((ezUInt64)ezMath::Max<ezInt64>(iEnd - iBegin, 0));
+
+      iPrevBegin = iBegin;
+    }
+  }
+
+  static void EncodePacket(const ezProfilingSystem::ProfilingData& data, ezTime baseTime)
+  {
+    Encoder& body = s_State.m_Body;
+    body.Clear();
+
+    s_State.m_NewStrings.Clear();
+
+    // threads
+    {
+      ezUInt32 uiNumNewThreads = 0;
+      for (const auto& info : data.m_ThreadInfos)
+      {
+        if (!s_State.m_ThreadIndices.Contains(info.m_uiThreadId))
+          ++uiNumNewThreads;
+      }
+
+      body.UInt(uiNumNewThreads);
+      for (const auto& info : data.m_ThreadInfos)
+      {
+        if (s_State.m_ThreadIndices.Contains(info.m_uiThreadId))
+          continue;
+
+        s_State.m_ThreadIndices.Insert(info.m_uiThreadId, s_State.m_ThreadIndices.GetCount());
+        body.UInt(InternString(info.m_sName));
+      }
+    }
+
+    // frames
+    {
+      ezInt64 iPrevTime = (ezInt64)baseTime.GetMicroseconds();
+
+      body.UInt(data.m_FrameStartTimes.GetCount());
+      for (ezTime frameStart : data.m_FrameStartTimes)
+      {
+        const ezInt64 iTime = (ezInt64)frameStart.GetMicroseconds();
+        body.Int(iTime - iPrevTime);
+        iPrevTime = iTime;
+      }
+    }
+
+    // CPU scopes
+    {
+      body.UInt(data.m_AllEventBuffers.GetCount());
+      for (const auto& eventBuffer : data.m_AllEventBuffers)
+      {
+        ezUInt32 uiThreadIndex = 0;
+        if (!s_State.m_ThreadIndices.TryGetValue(eventBuffer.m_uiThreadId, uiThreadIndex))
+        {
+          // threads without a name are not part of the thread infos, the Inspector shows them with a generic name
+          uiThreadIndex = s_State.m_ThreadIndices.GetCount();
+          s_State.m_ThreadIndices.Insert(eventBuffer.m_uiThreadId, uiThreadIndex);
+        }
+
+        body.UInt(uiThreadIndex);
+        EncodeScopes(eventBuffer.m_Data, baseTime);
+
+        s_State.m_uiStatsScopesSent += eventBuffer.m_Data.GetCount();
+      }
+    }
+
+    // GPU scopes
+    {
+      ezInt64 iPrevBegin = (ezInt64)baseTime.GetMicroseconds();
+
+      body.UInt(data.m_GPUScopes.GetCount());
+      for (const auto& scope : data.m_GPUScopes)
+      {
+        const ezInt64 iBegin = (ezInt64)scope.m_BeginTime.GetMicroseconds();
+        const ezInt64 iEnd = (ezInt64)scope.m_EndTime.GetMicroseconds();
+
+        body.UInt(InternString(scope.m_szName));
+        body.Int(iBegin - iPrevBegin);
+        body.UInt((ezUInt64)ezMath::Max<ezInt64>(iEnd - iBegin, 0));
+
+        iPrevBegin = iBegin;
+      }
+    }
+
+    // task system utilization
+    {
+      const ezWorkerThreadType::Enum types[] = {ezWorkerThreadType::ShortTasks, ezWorkerThreadType::LongTasks, ezWorkerThreadType::FileAccess};
+
+      ezUInt32 uiNumWorkers = 0;
+      for (auto type : types)
+      {
+        uiNumWorkers += ezTaskSystem::GetNumAllocatedWorkerThreads(type);
+      }
+
+      body.UInt(uiNumWorkers);
+      for (auto type : types)
+      {
+        for (ezUInt32 t = 0; t < ezTaskSystem::GetNumAllocatedWorkerThreads(type); ++t)
+        {
+          ezUInt32 uiNumTasks = 0;
+          const double fUtilization = ezTaskSystem::GetThreadUtilization(type, t, &uiNumTasks);
+
+          body.Byte(static_cast<ezUInt8>(type));
+          body.Byte(static_cast<ezUInt8>(ezMath::Clamp(fUtilization, 0.0, 1.0) * 255.0 + 0.5));
+          body.UInt(uiNumTasks);
+        }
+      }
+    }
+
+    // allocators, only the ones that changed since the last packet
+    {
+      Encoder& allocators = s_State.m_Allocators;
+      allocators.Clear();
+
+      ezUInt32 uiNumChanged = 0;
+
+      for (auto it = ezMemoryTracker::GetIterator(); it.IsValid(); ++it)
+      {
+        const ezAllocatorBase::Stats& stats = it.Stats();
+
+        ezAllocatorBase::Stats* pSentStats = nullptr;
+        if (s_State.m_SentAllocatorStats.TryGetValue(it.Id().m_Data, pSentStats))
+        {
+          if (pSentStats->m_uiNumAllocations == stats.m_uiNumAllocations && pSentStats->m_uiNumDeallocations == stats.m_uiNumDeallocations &&
+              pSentStats->m_uiAllocationSize == stats.m_uiAllocationSize)
+            continue;
+
+          *pSentStats = stats;
+        }
+        else
+        {
+          s_State.m_SentAllocatorStats.Insert(it.Id().m_Data, stats);
+        }
+
+        ++uiNumChanged;
+        allocators.UInt(it.Id().m_Data);
+        allocators.UInt(InternString(it.Name()));
+        allocators.UInt(it.ParentId().IsInvalidated() ? 0 : it.ParentId().m_Data + 1);
+        allocators.UInt(stats.m_uiNumAllocations - stats.m_uiNumDeallocations);
+        allocators.UInt(stats.m_uiAllocationSize);
+      }
+
+      body.UInt(uiNumChanged);
+      body.m_Data.PushBackRange(allocators.m_Data);
+    }
+
+    // the header contains the strings that were used for the first time in the body
+    Encoder& header = s_State.m_Header;
+    header.Clear();
+    header.UInt((ezUInt64)baseTime.GetMicroseconds());
+    header.UInt(s_State.m_NewStrings.GetCount());
+    for (const char* szString : s_State.m_NewStrings)
+    {
+      header.String(szString);
+    }
+  }
+
+  static void SendPacket()
+  {
+    const ezUInt32 uiUncompressedSize = s_State.m_Header.m_Data.GetCount() + s_State.m_Body.m_Data.GetCount();
+    ezUInt8 uiCompression = 0;
+
+    ezArrayPtr<const ezUInt8> payload;
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    if (s_State.m_bAllowCompression)
+    {
+      s_State.m_Compressed.Clear();
+
+      ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> storage(&s_State.m_Compressed);
+      ezMemoryStreamWriter writer(&storage);
+      ezCompressedStreamWriterZstd compressor(&writer);
+      compressor.WriteBytes(s_State.m_Header.m_Data.GetData(), s_State.m_Header.m_Data.GetCount());
+      compressor.WriteBytes(s_State.m_Body.m_Data.GetData(), s_State.m_Body.m_Data.GetCount());
+      compressor.FinishCompressedStream();
+
+      uiCompression = 1;
+      payload = s_State.m_Compressed;
+    }
+    else
+#endif
+    {
+      s_State.m_Compressed = s_State.m_Header.m_Data;
+      s_State.m_Compressed.PushBackRange(s_State.m_Body.m_Data);
+      payload = s_State.m_Compressed;
+    }
+
+    ezTelemetryMessage msg;
+    msg.SetMessageID('PROF', 'DATA');
+    msg.GetWriter() << s_State.m_uiSessionID;
+    msg.GetWriter() << uiCompression;
+    msg.GetWriter() << uiUncompressedSize;
+    msg.GetWriter() << payload.GetCount();
+    msg.GetWriter().WriteBytes(payload.GetPtr(), payload.GetCount());
+
+    ezTelemetry::Broadcast(ezTelemetry::Reliable, msg);
+
+    s_State.m_fBandwidthBudget -= payload.GetCount();
+    s_State.m_uiStatsBytesSent += payload.GetCount();
+    s_State.m_uiStatsBytesUncompressed += uiUncompressedSize;
+  }
+
+  static void UpdateStats(ezTime now)
+  {
+    const ezTime duration = now - s_State.m_StatsStart;
+    if (duration < ezTime::Seconds(1))
+      return;
+
+    const double fSeconds = duration.GetSeconds();
+
+    ezStats::SetStat("Profiling Stream/Bandwidth [KB per s]", (s_State.m_uiStatsBytesSent / 1024.0) / fSeconds);
+    ezStats::SetStat("Profiling Stream/Scopes per s", s_State.m_uiStatsScopesSent / fSeconds);
+    ezStats::SetStat("Profiling Stream/Encoding Overhead [ms per s]", s_State.m_StatsEncodeTime.GetMilliseconds() / fSeconds);
+    ezStats::SetStat("Profiling Stream/Compression Ratio",
+      s_State.m_uiStatsBytesSent > 0 ? (double)s_State.m_uiStatsBytesUncompressed / (double)s_State.m_uiStatsBytesSent : 1.0);
+
+    s_State.m_StatsStart = now;
+    s_State.m_uiStatsBytesSent = 0;
+    s_State.m_uiStatsBytesUncompressed = 0;
+    s_State.m_uiStatsScopesSent = 0;
+    s_State.m_StatsEncodeTime.SetZero();
+  }
+
+  static void StreamProfilingData()
+  {
+    if (!s_State.m_bRequested || !CVarProfilingStream)
+    {
+      s_State.m_bActive = false;
+      return;
+    }
+
+    const ezTime now = ezTime::Now();
+
+    if (!s_State.m_bActive)
+    {
+      Reset();
+      s_State.m_bActive = true;
+      s_State.m_LastUpdate = now;
+      s_State.m_LastSend = now;
+      s_State.m_StatsStart = now;
+
+      // only stream what happens from now on, the buffered history would be way too much data at once
+      ezProfilingSystem::CaptureIncremental(s_State.m_Cursor);
+      return;
+    }
+
+    // simple token bucket, allows short bursts of up to one second worth of data
+    const double fBytesPerSecond = ezMath::Max(CVarProfilingStreamMaxKBps.GetValue(), 1) * 1024.0;
+    s_State.m_fBandwidthBudget = ezMath::Min(s_State.m_fBandwidthBudget + (now - s_State.m_LastUpdate).GetSeconds() * fBytesPerSecond, fBytesPerSecond);
+    s_State.m_LastUpdate = now;
+
+    UpdateStats(now);
+
+    if (now - s_State.m_LastSend < ezTime::Milliseconds(CVarProfilingStreamIntervalMs.GetValue()))
+      return;
+
+    // over budget, wait until enough bandwidth is available again, the data stays in the profiling system's buffers in the mean time
+    if (s_State.m_fBandwidthBudget <= 0.0)
+      return;
+
+    s_State.m_LastSend = now;
+
+    const ezTime encodeStart = ezTime::Now();
+
+    const ezProfilingSystem::ProfilingData data = ezProfilingSystem::CaptureIncremental(s_State.m_Cursor);
+    EncodePacket(data, now);
+    SendPacket();
+
+    s_State.m_StatsEncodeTime += ezTime::Now() - encodeStart;
+  }
+
+  static void TelemetryMessage(void* pPassThrough)
+  {
+    ezTelemetryMessage Msg;
+
+    while (ezTelemetry::RetrieveMessage('PROF', Msg) == EZ_SUCCESS)
+    {
+      if (Msg.GetMessageID() == 'ENBL')
+      {
+        Msg.GetReader() >> s_State.m_bRequested;
+        Msg.GetReader() >> s_State.m_bAllowCompression;
+        Msg.GetReader() >> s_State.m_uiSessionID;
+
+        // the Inspector starts with an empty string table every time it (re-)enables the stream
+        s_State.m_bActive = false;
+      }
+    }
+  }
+
+  static void TelemetryEventsHandler(const ezTelemetry::TelemetryEventData& e)
+  {
+    switch (e.m_EventType)
+    {
+      case ezTelemetry::TelemetryEventData::DisconnectedFromClient:
+        s_State.m_bRequested = false;
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  static void PerframeUpdateHandler(const ezGameApplicationExecutionEvent& e)
+  {
+    if (!ezTelemetry::IsConnectedToClient())
+      return;
+
+    switch (e.m_Type)
+    {
+      case ezGameApplicationExecutionEvent::Type::AfterPresent:
+        StreamProfilingData();
+        break;
+
+      default:
+        break;
+    }
+  }
+} // namespace ProfilingDetail
+
+void AddProfilingEventHandler()
+{
+  ezTelemetry::AddEventHandler(ProfilingDetail::TelemetryEventsHandler);
+  ezTelemetry::AcceptMessagesForSystem('PROF', true, ProfilingDetail::TelemetryMessage, nullptr);
+
+  // see AddMemoryEventHandler() for why this is not done in the telemetry per-frame update
+  if (ezGameApplicationBase::GetGameApplicationBaseInstance() != nullptr)
+  {
+    ezGameApplicationBase::GetGameApplicationBaseInstance()->m_ExecutionEvents.AddEventHandler(ProfilingDetail::PerframeUpdateHandler);
+  }
+}
+
+void RemoveProfilingEventHandler()
+{
+  if (ezGameApplicationBase::GetGameApplicationBaseInstance() != nullptr)
+  {
+    ezGameApplicationBase::GetGameApplicationBaseInstance()->m_ExecutionEvents.RemoveEventHandler(ProfilingDetail::PerframeUpdateHandler);
+  }
+
+  ezTelemetry::AcceptMessagesForSystem('PROF', false);
+  ezTelemetry::RemoveEventHandler(ProfilingDetail::TelemetryEventsHandler);
+
+  ProfilingDetail::Reset();
+}
+
+
+
+EZ_STATICLINK_FILE(InspectorPlugin, InspectorPlugin_Profiling);
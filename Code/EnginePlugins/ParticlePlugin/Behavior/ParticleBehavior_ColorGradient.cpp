@@ -180,6 +180,20 @@ void ezParticleBehavior_ColorGradient::Process(ezUInt64 uiNumElements)
   // skip the first n particles
   itColor.Advance(m_uiFirstToUpdate);
 
+  constexpr ezUInt32 uiBatchSize = 256;
+  float positions[uiBatchSize];
+  ezColor colors[uiBatchSize];
+  ezColorLinear16f* targets[uiBatchSize];
+
+  auto EvaluateBatch = [&](ezUInt32 uiNumInBatch) {
+    gradient.EvaluateBatch(ezMakeArrayPtr(positions, uiNumInBatch), ezMakeArrayPtr(colors, uiNumInBatch), ezArrayPtr<float>());
+
+    for (ezUInt32 i = 0; i < uiNumInBatch; ++i)
+    {
+      *targets[i] = colors[i] * m_TintColor;
+    }
+  };
+
   if (m_GradientMode == ezParticleColorGradientMode::Age)
   {
     ezProcessingStreamIterator<ezFloat16Vec2> itLifeTime(m_pStreamLifeTime, uiNumElements, 0);
@@ -189,25 +203,22 @@ void ezParticleBehavior_ColorGradient::Process(ezUInt64 uiNumElements)
 
     while (!itLifeTime.HasReachedEnd())
     {
-      // if (itLifeTime.Current().y > 0)
+      ezUInt32 uiNumInBatch = 0;
+
+      for (; uiNumInBatch < uiBatchSize && !itLifeTime.HasReachedEnd(); ++uiNumInBatch)
       {
         const float fLifeTimeFraction = itLifeTime.Current().x * itLifeTime.Current().y;
-        const float posx = 1.0f - fLifeTimeFraction;
-
-        ezColor rgba;
-        ezUInt8 alpha;
-        gradient.EvaluateColor(posx, rgba);
-        gradient.EvaluateAlpha(posx, alpha);
-        rgba.a = ezMath::ColorByteToFloat(alpha);
-
-        itColor.Current() = rgba * m_TintColor;
+        positions[uiNumInBatch] = 1.0f - fLifeTimeFraction;
+        targets[uiNumInBatch] = &itColor.Current();
+
+        // skip the next n items
+        // this is to reduce the number of particles that need to be fully evaluated,
+        // since sampling the color gradient is pretty expensive
+        itLifeTime.Advance(m_uiCurrentUpdateInterval);
+        itColor.Advance(m_uiCurrentUpdateInterval);
       }
 
-      // skip the next n items
-      // this is to reduce the number of particles that need to be fully evaluated,
-      // since sampling the color gradient is pretty expensive
-      itLifeTime.Advance(m_uiCurrentUpdateInterval);
-      itColor.Advance(m_uiCurrentUpdateInterval);
+      EvaluateBatch(uiNumInBatch);
     }
   }
   else if (m_GradientMode == ezParticleColorGradientMode::Speed)
@@ -217,27 +228,26 @@ void ezParticleBehavior_ColorGradient::Process(ezUInt64 uiNumElements)
     // skip the first n particles
     itVelocity.Advance(m_uiFirstToUpdate);
 
+    const float fInvMaxSpeed = 1.0f / m_fMaxSpeed;
+
     while (!itVelocity.HasReachedEnd())
     {
-      // if (itLifeTime.Current().y > 0)
-      {
-        const float fSpeed = itVelocity.Current().GetLength();
-        const float posx = fSpeed / m_fMaxSpeed; // no need to clamp the range, the color lookup will already do that
-
-        ezColor rgba;
-        ezUInt8 alpha;
-        gradient.EvaluateColor(posx, rgba);
-        gradient.EvaluateAlpha(posx, alpha);
-        rgba.a = ezMath::ColorByteToFloat(alpha);
+      ezUInt32 uiNumInBatch = 0;
 
-        itColor.Current() = rgba * m_TintColor;
+      for (; uiNumInBatch < uiBatchSize && !itVelocity.HasReachedEnd(); ++uiNumInBatch)
+      {
+        // no need to clamp the range, the color lookup will already do that
+        positions[uiNumInBatch] = itVelocity.Current().GetLength() * fInvMaxSpeed;
+        targets[uiNumInBatch] = &itColor.Current();
+
+        // skip the next n items
+        // this is to reduce the number of particles that need to be fully evaluated,
+        // since sampling the color gradient is pretty expensive
+        itVelocity.Advance(m_uiCurrentUpdateInterval);
+        itColor.Advance(m_uiCurrentUpdateInterval);
       }
 
-      // skip the next n items
-      // this is to reduce the number of particles that need to be fully evaluated,
-      // since sampling the color gradient is pretty expensive
-      itVelocity.Advance(m_uiCurrentUpdateInterval);
-      itColor.Advance(m_uiCurrentUpdateInterval);
+      EvaluateBatch(uiNumInBatch);
     }
   }
 
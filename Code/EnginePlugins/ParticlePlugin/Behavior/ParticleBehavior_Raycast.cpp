@@ -131,68 +131,110 @@ void ezParticleBehavior_Raycast::Process(ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: Raycast");
 
-  const float tDiff = (float)m_TimeDiff.GetSeconds();
+  if (m_pPhysicsModule == nullptr)
+    return;
 
-  ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<const ezVec3> itLastPosition(m_pStreamLastPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  const float tDiff = (float)m_TimeDiff.GetSeconds();
 
-  ezPhysicsCastResult hitResult;
+  m_RayElements.Clear();
+  m_RayStarts.Clear();
+  m_RayDirs.Clear();
+  m_RayDistances.Clear();
 
-  ezUInt32 i = 0;
-  while (!itPosition.HasReachedEnd())
+  // gather all particles that moved this frame, so that the physics module can process them in one batch
   {
-    const ezVec3 vLastPos = itLastPosition.Current();
-    const ezVec3 vCurPos = itPosition.Current().GetAsVec3();
+    ezProcessingStreamIterator<const ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
+    ezProcessingStreamIterator<const ezVec3> itLastPosition(m_pStreamLastPosition, uiNumElements, 0);
 
-    if (!vLastPos.IsZero())
+    ezUInt32 i = 0;
+    while (!itPosition.HasReachedEnd())
     {
-      const ezVec3 vChange = vCurPos - vLastPos;
+      const ezVec3 vLastPos = itLastPosition.Current();
+      const ezVec3 vCurPos = itPosition.Current().GetAsVec3();
 
-      if (!vChange.IsZero(0.001f))
+      if (!vLastPos.IsZero())
       {
-        ezVec3 vDirection = vChange;
+        ezVec3 vDirection = vCurPos - vLastPos;
 
-        const float fMaxLen = vDirection.GetLengthAndNormalize();
-
-        if (m_pPhysicsModule != nullptr && m_pPhysicsModule->Raycast(hitResult, vLastPos, vDirection, fMaxLen, ezPhysicsQueryParameters(m_uiCollisionLayer)))
+        if (!vDirection.IsZero(0.001f))
         {
-          if (m_Reaction == ezParticleRaycastHitReaction::Bounce)
-          {
-            const ezVec3 vNewDir = vChange.GetReflectedVector(hitResult.m_vNormal) * m_fBounceFactor;
-
-            itPosition.Current() = ezVec3(hitResult.m_vPosition + hitResult.m_vNormal * 0.05f + vNewDir).GetAsVec4(0);
-            itVelocity.Current() = vNewDir / tDiff;
-          }
-          else if (m_Reaction == ezParticleRaycastHitReaction::Die)
-          {
-            /// \todo Get current element index from iterator ?
-            m_pStreamGroup->RemoveElement(i);
-          }
-          else if (m_Reaction == ezParticleRaycastHitReaction::Stop)
-          {
-            itVelocity.Current().SetZero();
-          }
-
-          if (m_sOnCollideEvent.GetHash() != 0)
-          {
-            ezParticleEvent e;
-            e.m_EventType = m_sOnCollideEvent;
-            e.m_vPosition = hitResult.m_vPosition;
-            e.m_vNormal = hitResult.m_vNormal;
-            e.m_vDirection = vDirection;
-
-            GetOwnerEffect()->AddParticleEvent(e);
-          }
+          const float fMaxLen = vDirection.GetLengthAndNormalize();
+
+          m_RayElements.PushBack(i);
+          m_RayStarts.PushBack(vLastPos);
+          m_RayDirs.PushBack(vDirection);
+          m_RayDistances.PushBack(fMaxLen);
         }
       }
+
+      itPosition.Advance();
+      itLastPosition.Advance();
+
+      ++i;
     }
+  }
 
-    itPosition.Advance();
-    itLastPosition.Advance();
-    itVelocity.Advance();
+  if (m_RayElements.IsEmpty())
+    return;
+
+  const ezUInt32 uiNumRays = m_RayElements.GetCount();
+  m_HitResults.SetCount(uiNumRays);
+  m_HitMask.SetCountUninitialized(uiNumRays);
+
+  const ezPhysicsQueryParameters queryParams(m_uiCollisionLayer);
+
+  ezPhysicsRaycastBatch batch;
+  batch.m_Starts = m_RayStarts;
+  batch.m_Directions = m_RayDirs;
+  batch.m_Distances = m_RayDistances;
+  batch.m_Params = ezMakeArrayPtr(&queryParams, 1);
+
+  if (m_pPhysicsModule->RaycastBatch(m_HitResults, m_HitMask, batch) == 0)
+    return;
+
+  ezVec4* pPosition = m_pStreamPosition->GetWritableData<ezVec4>();
+  ezVec3* pVelocity = m_pStreamVelocity->GetWritableData<ezVec3>();
+  const ezUInt64 uiPositionStride = m_pStreamPosition->GetElementStride();
+  const ezUInt64 uiVelocityStride = m_pStreamVelocity->GetElementStride();
+
+  for (ezUInt32 r = 0; r < uiNumRays; ++r)
+  {
+    if (!m_HitMask[r])
+      continue;
 
-    ++i;
+    const ezPhysicsCastResult& hitResult = m_HitResults[r];
+    const ezUInt32 i = m_RayElements[r];
+
+    ezVec4& vPosition = *ezMemoryUtils::AddByteOffset(pPosition, static_cast<ptrdiff_t>(i * uiPositionStride));
+    ezVec3& vVelocity = *ezMemoryUtils::AddByteOffset(pVelocity, static_cast<ptrdiff_t>(i * uiVelocityStride));
+
+    if (m_Reaction == ezParticleRaycastHitReaction::Bounce)
+    {
+      const ezVec3 vChange = m_RayDirs[r] * m_RayDistances[r];
+      const ezVec3 vNewDir = vChange.GetReflectedVector(hitResult.m_vNormal) * m_fBounceFactor;
+
+      vPosition = ezVec3(hitResult.m_vPosition + hitResult.m_vNormal * 0.05f + vNewDir).GetAsVec4(0);
+      vVelocity = vNewDir / tDiff;
+    }
+    else if (m_Reaction == ezParticleRaycastHitReaction::Die)
+    {
+      m_pStreamGroup->RemoveElement(i);
+    }
+    else if (m_Reaction == ezParticleRaycastHitReaction::Stop)
+    {
+      vVelocity.SetZero();
+    }
+
+    if (m_sOnCollideEvent.GetHash() != 0)
+    {
+      ezParticleEvent e;
+      e.m_EventType = m_sOnCollideEvent;
+      e.m_vPosition = hitResult.m_vPosition;
+      e.m_vNormal = hitResult.m_vNormal;
+      e.m_vDirection = m_RayDirs[r];
+
+      GetOwnerEffect()->AddParticleEvent(e);
+    }
   }
 }
 
@@ -1,10 +1,9 @@
 #pragma once
 
 #include <Foundation/Strings/String.h>
+#include <GameEngine/Interfaces/PhysicsWorldModule.h>
 #include <ParticlePlugin/Behavior/ParticleBehavior.h>
 
-class ezPhysicsWorldModuleInterface;
-
 struct EZ_PARTICLEPLUGIN_DLL ezParticleRaycastHitReaction
 {
   typedef ezUInt8 StorageType;
@@ -70,4 +69,11 @@ protected:
   ezProcessingStream* m_pStreamPosition = nullptr;
   ezProcessingStream* m_pStreamLastPosition = nullptr;
   ezProcessingStream* m_pStreamVelocity = nullptr;
+
+  ezDynamicArray<ezUInt32> m_RayElements;
+  ezDynamicArray<ezVec3> m_RayStarts;
+  ezDynamicArray<ezVec3> m_RayDirs;
+  ezDynamicArray<float> m_RayDistances;
+  ezDynamicArray<ezPhysicsCastResult> m_HitResults;
+  ezDynamicArray<bool> m_HitMask;
 };
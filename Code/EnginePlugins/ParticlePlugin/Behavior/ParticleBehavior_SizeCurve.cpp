@@ -129,39 +129,50 @@ void ezParticleBehavior_SizeCurve::Process(ezUInt64 uiNumElements)
   double fMinX, fMaxX;
   curve.QueryExtents(fMinX, fMaxX);
 
+  double fMinY, fMaxY;
+  curve.QueryExtremeValues(fMinY, fMaxY);
+
+  // same as NormalizeValue(), but precomputed for all particles
+  const float fValueOffset = (float)fMinY;
+  const float fValueScale = fMaxY > fMinY ? m_fCurveScale / (float)(fMaxY - fMinY) : 0.0f;
+
   // skip the first n particles
   {
-    for (ezUInt32 i = 0; i < m_uiFirstToUpdate; ++i)
-    {
-      itLifeTime.Advance();
-      itSize.Advance();
-    }
+    itLifeTime.Advance(m_uiFirstToUpdate);
+    itSize.Advance(m_uiFirstToUpdate);
 
     ++m_uiFirstToUpdate;
     if (m_uiFirstToUpdate >= m_uiCurrentUpdateInterval)
       m_uiFirstToUpdate = 0;
   }
 
+  constexpr ezUInt32 uiBatchSize = 256;
+  float positions[uiBatchSize];
+  float values[uiBatchSize];
+  ezFloat16* sizes[uiBatchSize];
+
   while (!itLifeTime.HasReachedEnd())
   {
-    // if (itLifeTime.Current().y > 0)
+    ezUInt32 uiNumInBatch = 0;
+
+    for (; uiNumInBatch < uiBatchSize && !itLifeTime.HasReachedEnd(); ++uiNumInBatch)
     {
       const float fLifeTimeFraction = 1.0f - (itLifeTime.Current().x * itLifeTime.Current().y);
-
-      const double evalPos = curve.ConvertNormalizedPos(fLifeTimeFraction);
-      double val = curve.Evaluate(evalPos);
-      val = curve.NormalizeValue(val);
-
-      itSize.Current() = m_fBaseSize + (float)val * m_fCurveScale;
+      positions[uiNumInBatch] = (float)ezMath::Lerp(fMinX, fMaxX, (double)fLifeTimeFraction);
+      sizes[uiNumInBatch] = &itSize.Current();
+
+      // skip the next n items
+      // this is to reduce the number of particles that need to be fully evaluated,
+      // since sampling the curve is expensive
+      itLifeTime.Advance(m_uiCurrentUpdateInterval);
+      itSize.Advance(m_uiCurrentUpdateInterval);
     }
 
-    // skip the next n items
-    // this is to reduce the number of particles that need to be fully evaluated,
-    // since sampling the curve is expensive
-    for (ezUInt32 i = 0; i < m_uiCurrentUpdateInterval; ++i)
+    curve.EvaluateBatch(ezMakeArrayPtr(positions, uiNumInBatch), ezMakeArrayPtr(values, uiNumInBatch));
+
+    for (ezUInt32 i = 0; i < uiNumInBatch; ++i)
     {
-      itLifeTime.Advance();
-      itSize.Advance();
+      *sizes[i] = m_fBaseSize + (values[i] - fValueOffset) * fValueScale;
     }
   }
 }
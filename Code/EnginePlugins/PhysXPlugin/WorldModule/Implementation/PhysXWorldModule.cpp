@@ -1153,6 +1153,29 @@ void ezPhysXWorldModule::QueryShapesInSphere(ezPhysicsOverlapResultArray& out_Re
 }
 
 
+ezUInt32 ezPhysXWorldModule::RaycastBatch(ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsRaycastBatch& batch, ezPhysicsHitCollection collection /*= ezPhysicsHitCollection::Closest*/) const
+{
+  // read locks are re-entrant, holding it for the whole batch means the individual queries never have to wait for the simulation
+  // the queries themselves still run one by one, PxBatchQuery is not used yet
+  EZ_PX_READ_LOCK(*m_pPxScene);
+
+  return SUPER::RaycastBatch(out_Results, out_Hits, batch, collection);
+}
+
+ezUInt32 ezPhysXWorldModule::SweepBatch(ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsSweepBatch& batch, ezPhysicsHitCollection collection /*= ezPhysicsHitCollection::Closest*/) const
+{
+  EZ_PX_READ_LOCK(*m_pPxScene);
+
+  return SUPER::SweepBatch(out_Results, out_Hits, batch, collection);
+}
+
+ezUInt32 ezPhysXWorldModule::OverlapBatch(ezArrayPtr<bool> out_Overlaps, const ezPhysicsOverlapBatch& batch) const
+{
+  EZ_PX_READ_LOCK(*m_pPxScene);
+
+  return SUPER::OverlapBatch(out_Overlaps, batch);
+}
+
 void ezPhysXWorldModule::AddStaticCollisionBox(ezGameObject* pObject, ezVec3 boxSize)
 {
   ezPxStaticActorComponent* pActor = nullptr;
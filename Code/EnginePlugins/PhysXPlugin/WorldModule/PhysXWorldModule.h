@@ -56,6 +56,12 @@ public:
 
   virtual void QueryShapesInSphere(ezPhysicsOverlapResultArray& out_Results, float fSphereRadius, const ezVec3& vPosition, const ezPhysicsQueryParameters& params) const override;
 
+  virtual ezUInt32 RaycastBatch(ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsRaycastBatch& batch, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const override;
+
+  virtual ezUInt32 SweepBatch(ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsSweepBatch& batch, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const override;
+
+  virtual ezUInt32 OverlapBatch(ezArrayPtr<bool> out_Overlaps, const ezPhysicsOverlapBatch& batch) const override;
+
   virtual void AddStaticCollisionBox(ezGameObject* pObject, ezVec3 boxSize) override;
 
   virtual void* CreateRagdoll(const ezSkeletonResourceDescriptor& skeleton, const ezTransform& transform, const ezAnimationPose& initPose) override;
@@ -32,6 +32,11 @@ void PlacementTask::Clear()
   m_OutputTransforms.Clear();
   m_TempData.Clear();
   m_ValidPoints.Clear();
+
+  m_RayStarts.Clear();
+  m_RayDirs.Clear();
+  m_HitResults.Clear();
+  m_HitMask.Clear();
 }
 
 void PlacementTask::Execute()
@@ -60,11 +65,16 @@ void PlacementTask::FindPlacementPoints()
   ezSimdVec4f vMaxOffset = ezSimdConversion::ToVec3(pOutput->m_vMaxOffset);
 
   ezVec3 rayDir = ezVec3(0, 0, -1);
-  ezUInt32 uiCollisionLayer = pOutput->m_uiCollisionLayer;
+  ezPhysicsQueryParameters queryParams(pOutput->m_uiCollisionLayer, ezPhysicsShapeType::Static);
 
   auto& patternPoints = pOutput->m_pPattern->m_Points;
+  const ezUInt32 uiNumPoints = patternPoints.GetCount();
+
+  m_RayStarts.SetCountUninitialized(uiNumPoints);
+  m_HitResults.SetCount(uiNumPoints);
+  m_HitMask.SetCountUninitialized(uiNumPoints);
 
-  for (ezUInt32 i = 0; i < patternPoints.GetCount(); ++i)
+  for (ezUInt32 i = 0; i < uiNumPoints; ++i)
   {
     auto& patternPoint = patternPoints[i];
     ezSimdVec4f patternCoords = ezSimdConversion::ToVec3(patternPoint.m_Coordinates.GetAsVec3(0.0f));
@@ -73,10 +83,27 @@ void PlacementTask::FindPlacementPoints()
     rayStart += ezSimdRandom::FloatMinMax(seed + ezSimdVec4u(i), vMinOffset, vMaxOffset);
     rayStart.SetZ(fZStart);
 
-    ezPhysicsCastResult hitResult;
-    if (!m_pData->m_pPhysicsModule->Raycast(hitResult, ezSimdConversion::ToVec3(rayStart), rayDir, fZRange, ezPhysicsQueryParameters(uiCollisionLayer, ezPhysicsShapeType::Static)))
+    m_RayStarts[i] = ezSimdConversion::ToVec3(rayStart);
+  }
+
+  m_RayDirs.SetCount(uiNumPoints, rayDir);
+
+  ezPhysicsRaycastBatch batch;
+  batch.m_Starts = m_RayStarts;
+  batch.m_Directions = m_RayDirs;
+  batch.m_Distances = ezMakeArrayPtr(&fZRange, 1);
+  batch.m_Params = ezMakeArrayPtr(&queryParams, 1);
+
+  if (m_pData->m_pPhysicsModule->RaycastBatch(m_HitResults, m_HitMask, batch) == 0)
+    return;
+
+  for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+  {
+    if (!m_HitMask[i])
       continue;
 
+    const ezPhysicsCastResult& hitResult = m_HitResults[i];
+
     if (pOutput->m_hSurface.IsValid())
     {
       if (!hitResult.m_hSurface.IsValid())
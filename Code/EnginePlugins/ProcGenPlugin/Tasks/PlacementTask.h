@@ -1,10 +1,10 @@
 #pragma once
 
 #include <Foundation/Threading/TaskSystem.h>
+#include <GameEngine/Interfaces/PhysicsWorldModule.h>
 #include <ProcGenPlugin/Declarations.h>
 #include <ProcGenPlugin/VM/ExpressionVM.h>
 
-class ezPhysicsWorldModuleInterface;
 class ezVolumeCollection;
 
 namespace ezProcGenInternal
@@ -33,6 +33,11 @@ namespace ezProcGenInternal
     ezDynamicArray<float> m_TempData;
     ezDynamicArray<ezUInt32> m_ValidPoints;
 
+    ezDynamicArray<ezVec3> m_RayStarts;
+    ezDynamicArray<ezVec3> m_RayDirs;
+    ezDynamicArray<ezPhysicsCastResult> m_HitResults;
+    ezDynamicArray<bool> m_HitMask;
+
     ezExpressionVM m_VM;
   };
 } // namespace ezPPInternal
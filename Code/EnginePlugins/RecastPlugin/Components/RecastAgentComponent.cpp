@@ -9,6 +9,7 @@
 #include <RecastPlugin/Components/RecastAgentComponent.h>
 #include <RecastPlugin/Resources/RecastNavMeshResource.h>
 #include <RecastPlugin/Utils/RcMath.h>
+#include <RecastPlugin/WorldModule/PathQueryWorldModule.h>
 #include <RecastPlugin/WorldModule/RecastWorldModule.h>
 #include <RendererCore/Debug/DebugRenderer.h>
 
@@ -22,6 +23,11 @@ EZ_BEGIN_COMPONENT_TYPE(ezRcAgentComponent, 2, ezComponentMode::Dynamic)
     EZ_MEMBER_PROPERTY("WalkSpeed",m_fWalkSpeed)->AddAttributes(new ezDefaultValueAttribute(4.0f)),
   }
   EZ_END_PROPERTIES;
+  EZ_BEGIN_MESSAGEHANDLERS
+  {
+    EZ_MESSAGE_HANDLER(ezMsgRcPathQueryResult, OnMsgPathQueryResult),
+  }
+  EZ_END_MESSAGEHANDLERS;
 }
 EZ_END_COMPONENT_TYPE
 // clang-format on
@@ -84,6 +90,8 @@ void ezRcAgentComponent::UninitializeRecast()
 
 void ezRcAgentComponent::ClearTargetPosition()
 {
+  CancelPathRequest();
+
   m_iNumNextSteps = 0;
   m_iFirstNextStep = 0;
   m_PathCorridor.Clear();
@@ -142,91 +150,80 @@ ezResult ezRcAgentComponent::FindNavMeshPolyAt(const ezVec3& vPosition, dtPolyRe
   return EZ_SUCCESS;
 }
 
-ezResult ezRcAgentComponent::ComputePathCorridor(dtPolyRef startPoly, dtPolyRef endPoly, bool& bFoundPartialPath)
+void ezRcAgentComponent::RequestPathToTarget()
 {
-  bFoundPartialPath = false;
-
-  ezRcPos rcStart = m_vCurrentPositionOnNavmesh;
-  ezRcPos rcEnd = m_vTargetPosition;
+  ezRcPathQueryDesc desc;
+  desc.m_vStart = GetOwner()->GetGlobalPosition();
+  desc.m_vTarget = m_vTargetPosition;
+  desc.m_hRequester = GetHandle();
 
-  ezInt32 iPathCorridorLength = 0;
-
-  // make enough room
-  m_PathCorridor.SetCountUninitialized(256);
-  if (dtStatusFailed(m_pQuery->findPath(startPoly, endPoly, rcStart, rcEnd, &m_QueryFilter, m_PathCorridor.GetData(), &iPathCorridorLength,
-        (int)m_PathCorridor.GetCount())) ||
-      iPathCorridorLength <= 0)
-  {
-    m_PathCorridor.Clear();
-    return EZ_FAILURE;
-  }
+  m_uiPathQueryId = GetWorld()->GetOrCreateModule<ezRcPathQueryWorldModule>()->RequestPath(desc);
+}
 
-  // reduce to actual length
-  m_PathCorridor.SetCountUninitialized(iPathCorridorLength);
+void ezRcAgentComponent::CancelPathRequest()
+{
+  if (m_uiPathQueryId == 0)
+    return;
 
-  if (m_PathCorridor[iPathCorridorLength - 1] != endPoly)
+  // the module may already be gone when the world is shut down, no need to create it just to cancel the request
+  if (ezRcPathQueryWorldModule* pPathQueryModule = GetWorld()->GetModule<ezRcPathQueryWorldModule>())
   {
-    // if this is the case, the target position cannot be reached, but we can walk close to it
-    bFoundPartialPath = true;
+    pPathQueryModule->CancelPath(m_uiPathQueryId);
   }
 
-  m_pCorridor->reset(startPoly, rcStart);
-  m_pCorridor->setCorridor(rcEnd, m_PathCorridor.GetData(), iPathCorridorLength);
-
-  return EZ_SUCCESS;
+  m_uiPathQueryId = 0;
 }
 
-ezResult ezRcAgentComponent::ComputePathToTarget()
+void ezRcAgentComponent::OnMsgPathQueryResult(ezMsgRcPathQueryResult& msg)
 {
-  const ezVec3 vStartPos = GetOwner()->GetGlobalPosition();
+  if (msg.m_uiQueryId != m_uiPathQueryId)
+    return;
 
-  dtPolyRef startPoly;
-  if (FindNavMeshPolyAt(vStartPos, startPoly, &m_vCurrentPositionOnNavmesh).Failed())
-  {
-    m_PathToTargetState = ezAgentPathFindingState::HasTargetPathFindingFailed;
+  m_uiPathQueryId = 0;
 
-    ezAgentSteeringEvent e;
-    e.m_pComponent = this;
-    e.m_Type = ezAgentSteeringEvent::ErrorOutsideNavArea;
-    m_SteeringEvents.Broadcast(e);
-    return EZ_FAILURE;
-  }
+  // the navmesh was unloaded in the meantime, the next update requests a new path
+  if (!m_bRecastInitialized || GetPathToTargetState() != ezAgentPathFindingState::HasTargetWaitingForPath)
+    return;
+
+  m_vCurrentPositionOnNavmesh = msg.m_vStartOnNavMesh;
+
+  ezAgentSteeringEvent e;
+  e.m_pComponent = this;
 
-  dtPolyRef endPoly;
-  if (FindNavMeshPolyAt(m_vTargetPosition, endPoly).Failed())
+  switch (msg.m_Status)
   {
-    m_PathToTargetState = ezAgentPathFindingState::HasTargetPathFindingFailed;
+    case ezRcPathQueryStatus::Success:
+      m_PathCorridor = msg.m_PathCorridor;
+      m_pCorridor->reset(m_PathCorridor[0], ezRcPos(m_vCurrentPositionOnNavmesh));
+      m_pCorridor->setCorridor(ezRcPos(m_vTargetPosition), m_PathCorridor.GetData(), (int)m_PathCorridor.GetCount());
 
-    ezAgentSteeringEvent e;
-    e.m_pComponent = this;
-    e.m_Type = ezAgentSteeringEvent::ErrorInvalidTargetPosition;
-    m_SteeringEvents.Broadcast(e);
-    return EZ_FAILURE;
-  }
+      m_PathToTargetState = ezAgentPathFindingState::HasTargetAndValidPath;
+      e.m_Type = ezAgentSteeringEvent::PathToTargetFound;
+      m_SteeringEvents.Broadcast(e);
 
-  /// \todo Optimize case when endPoly is same as previously ?
+      PlanNextSteps();
+      return;
 
-  bool bFoundPartialPath = false;
-  if (ComputePathCorridor(startPoly, endPoly, bFoundPartialPath).Failed() || bFoundPartialPath)
-  {
-    m_PathToTargetState = ezAgentPathFindingState::HasTargetPathFindingFailed;
+    case ezRcPathQueryStatus::StartOutsideNavArea:
+      e.m_Type = ezAgentSteeringEvent::ErrorOutsideNavArea;
+      break;
 
-    /// \todo For now a partial path is considered an error
+    case ezRcPathQueryStatus::TargetOutsideNavArea:
+      e.m_Type = ezAgentSteeringEvent::ErrorInvalidTargetPosition;
+      break;
 
-    ezAgentSteeringEvent e;
-    e.m_pComponent = this;
-    e.m_Type = bFoundPartialPath ? ezAgentSteeringEvent::WarningNoFullPathToTarget : ezAgentSteeringEvent::ErrorNoPathToTarget;
-    m_SteeringEvents.Broadcast(e);
-    return EZ_FAILURE;
-  }
+    case ezRcPathQueryStatus::PartialPath:
+      /// \todo For now a partial path is considered an error
+      e.m_Type = ezAgentSteeringEvent::WarningNoFullPathToTarget;
+      break;
 
-  m_PathToTargetState = ezAgentPathFindingState::HasTargetAndValidPath;
+    default:
+      e.m_Type = ezAgentSteeringEvent::ErrorNoPathToTarget;
+      break;
+  }
 
-  ezAgentSteeringEvent e;
-  e.m_pComponent = this;
-  e.m_Type = ezAgentSteeringEvent::PathToTargetFound;
+  m_PathToTargetState = ezAgentPathFindingState::HasTargetPathFindingFailed;
   m_SteeringEvents.Broadcast(e);
-  return EZ_SUCCESS;
 }
 
 bool ezRcAgentComponent::HasReachedPosition(const ezVec3& pos, float fMaxDistance) const
@@ -376,10 +373,13 @@ void ezRcAgentComponent::Update()
   // target is set, but no path is computed yet
   if (GetPathToTargetState() == ezAgentPathFindingState::HasTargetWaitingForPath)
   {
-    if (ComputePathToTarget().Failed())
-      return;
+    // the result is delivered with ezMsgRcPathQueryResult in one of the next frames
+    if (m_uiPathQueryId == 0)
+    {
+      RequestPathToTarget();
+    }
 
-    PlanNextSteps();
+    return;
   }
 
   // from here on down, everything has to do with following a valid path
@@ -575,8 +575,9 @@ void ezRcAgentComponentManager::Initialize()
 {
   SUPER::Initialize();
 
-  // make sure this world module exists
+  // make sure these world modules exist
   m_pWorldModule = GetWorld()->GetOrCreateModule<ezRecastWorldModule>();
+  GetWorld()->GetOrCreateModule<ezRcPathQueryWorldModule>();
 
   m_pPhysicsInterface = GetWorld()->GetOrCreateModule<ezPhysicsWorldModuleInterface>();
 
@@ -10,6 +10,7 @@
 #include <RecastPlugin/RecastPluginDLL.h>
 
 class ezRecastWorldModule;
+struct ezMsgRcPathQueryResult;
 class ezPhysicsWorldModuleInterface;
 struct ezResourceEvent;
 
@@ -84,8 +85,9 @@ private:
   // Path Finding and Steering
 
 private:
-  ezResult ComputePathToTarget();
-  ezResult ComputePathCorridor(dtPolyRef startPoly, dtPolyRef endPoly, bool& bFoundPartialPath);
+  void RequestPathToTarget();
+  void CancelPathRequest();
+  void OnMsgPathQueryResult(ezMsgRcPathQueryResult& msg); // [ msg handler ]
   void ComputeSteeringDirection(float fMaxDistance);
   void ApplySteering(const ezVec3& vDirection, float fSpeed);
   void SyncSteeringWithReality();
@@ -98,6 +100,7 @@ private:
   ezUniquePtr<dtPathCorridor> m_pCorridor; // careful, dtPathCorridor is not moveble
   dtQueryFilter m_QueryFilter;             /// \todo hard-coded filter
   ezDynamicArray<dtPolyRef> m_PathCorridor;
+  ezUInt32 m_uiPathQueryId = 0; ///< The path request that is currently computed by the ezRcPathQueryWorldModule, zero if none.
   // path following
   ezInt32 m_iFirstNextStep = 0;
   ezInt32 m_iNumNextSteps = 0;
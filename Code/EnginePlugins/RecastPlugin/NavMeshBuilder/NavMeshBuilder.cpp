@@ -2,6 +2,7 @@
 
 #include <Core/Utils/WorldGeoExtractionUtil.h>
 #include <Core/World/World.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Stopwatch.h>
 #include <Foundation/Types/ScopeExit.h>
 #include <Foundation/Utilities/Progress.h>
@@ -28,6 +29,7 @@ EZ_BEGIN_STATIC_REFLECTED_TYPE(ezRecastConfig, ezNoBase, 1, ezRTTIDefaultAllocat
     EZ_MEMBER_PROPERTY("SampleErrorFactor", m_fDetailMeshSampleErrorFactor)->AddAttributes(new ezDefaultValueAttribute(1.0f)),
     EZ_MEMBER_PROPERTY("MaxSimplification", m_fMaxSimplificationError)->AddAttributes(new ezDefaultValueAttribute(1.3f)),
     EZ_MEMBER_PROPERTY("MaxEdgeLength", m_fMaxEdgeLength)->AddAttributes(new ezDefaultValueAttribute(4.0f)),
+    EZ_MEMBER_PROPERTY("TileSize", m_fTileSize)->AddAttributes(new ezDefaultValueAttribute(32.0f), new ezClampValueAttribute(4.0f, ezVariant())),
   }
   EZ_END_PROPERTIES;
 }
@@ -61,6 +63,16 @@ protected:
   }
 };
 
+struct ezRecastNavMeshBuilder::TileToBuild
+{
+  ezInt32 m_iTileX = 0;
+  ezInt32 m_iTileY = 0;
+  ezDynamicArray<ezInt32> m_TriangleIndices; // three vertex indices per triangle
+  ezDynamicArray<ezUInt8> m_TriangleAreaIDs;
+  ezRecastNavMeshTile m_Result;
+  bool m_bFailed = false;
+};
+
 ezRecastNavMeshBuilder::ezRecastNavMeshBuilder() = default;
 ezRecastNavMeshBuilder::~ezRecastNavMeshBuilder() = default;
 
@@ -70,7 +82,6 @@ void ezRecastNavMeshBuilder::Clear()
   m_Vertices.Clear();
   m_Triangles.Clear();
   m_TriangleAreaIDs.Clear();
-  m_pRecastContext = nullptr;
 }
 
 ezResult ezRecastNavMeshBuilder::ExtractWorldGeometry(const ezWorld& world, ezWorldGeoExtractionUtil::Geometry& out_worldGeo)
@@ -87,16 +98,13 @@ ezResult ezRecastNavMeshBuilder::Build(const ezRecastConfig& config, const ezWor
 
   ezProgressRange pg("Generating NavMesh", 4, true, &progress);
   pg.SetStepWeighting(0, 0.1f);
-  pg.SetStepWeighting(1, 0.1f);
-  pg.SetStepWeighting(2, 0.6f);
-  pg.SetStepWeighting(3, 0.2f);
+  pg.SetStepWeighting(1, 0.05f);
+  pg.SetStepWeighting(2, 0.05f);
+  pg.SetStepWeighting(3, 0.8f);
 
   Clear();
   out_NavMeshDesc.Clear();
 
-  ezUniquePtr<ezRcBuildContext> recastContext = EZ_DEFAULT_NEW(ezRcBuildContext);
-  m_pRecastContext = recastContext.Borrow();
-
   if (!pg.BeginNextStep("Triangulate Mesh"))
     return EZ_FAILURE;
 
@@ -108,25 +116,123 @@ ezResult ezRecastNavMeshBuilder::Build(const ezRecastConfig& config, const ezWor
     return EZ_SUCCESS;
   }
 
+  MarkWalkableTriangles(config);
+
   if (!pg.BeginNextStep("Compute AABB"))
     return EZ_FAILURE;
 
   ComputeBoundingBox();
 
-  if (!pg.BeginNextStep("Build Poly Mesh"))
+  if (SetupTileGrid(config, out_NavMeshDesc).Failed())
     return EZ_FAILURE;
 
-  out_NavMeshDesc.m_pNavMeshPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+  if (!pg.BeginNextStep("Assign Triangles to Tiles"))
+    return EZ_FAILURE;
+
+  ezDynamicArray<TileToBuild> tiles;
+  AssignTrianglesToTiles(config, out_NavMeshDesc, 0, 0, out_NavMeshDesc.m_uiNumTilesX - 1, out_NavMeshDesc.m_uiNumTilesY - 1, tiles);
 
-  if (BuildRecastPolyMesh(config, *out_NavMeshDesc.m_pNavMeshPolygons, progress).Failed())
+  if (!pg.BeginNextStep("Build Tiles"))
     return EZ_FAILURE;
 
-  if (!pg.BeginNextStep("Build NavMesh"))
+  if (BuildTiles(config, out_NavMeshDesc, tiles, progress).Failed())
+    return EZ_FAILURE;
+
+  for (TileToBuild& tile : tiles)
+  {
+    if (!tile.m_Result.m_DetourTileData.IsEmpty())
+    {
+      out_NavMeshDesc.m_Tiles.PushBack(std::move(tile.m_Result));
+    }
+  }
+
+  ezLog::Debug("Built {} navmesh tiles ({} x {} grid)", out_NavMeshDesc.m_Tiles.GetCount(), out_NavMeshDesc.m_uiNumTilesX, out_NavMeshDesc.m_uiNumTilesY);
+  return EZ_SUCCESS;
+}
+
+ezResult ezRecastNavMeshBuilder::RebuildTiles(const ezRecastConfig& config, const ezWorldGeoExtractionUtil::Geometry& geo,
+  const ezBoundingBox& changedArea, ezRecastNavMeshResourceDescriptor& inout_NavMeshDesc, ezProgress& progress)
+{
+  EZ_LOG_BLOCK("ezRecastNavMeshBuilder::RebuildTiles");
+
+  if (inout_NavMeshDesc.m_uiNumTilesX == 0 || inout_NavMeshDesc.m_uiNumTilesY == 0 || inout_NavMeshDesc.m_Config != config ||
+      !ezMath::IsEqual(inout_NavMeshDesc.m_fTileSize, GetTileCells(config) * config.m_fCellSize, 0.001f))
+  {
+    ezLog::Error("The navmesh was built with a different config, it has to be rebuilt entirely");
     return EZ_FAILURE;
+  }
+
+  ezProgressRange pg("Rebuilding NavMesh Tiles", 3, true, &progress);
+  pg.SetStepWeighting(0, 0.1f);
+  pg.SetStepWeighting(1, 0.05f);
+  pg.SetStepWeighting(2, 0.85f);
+
+  Clear();
+
+  // the changed area in Recast coordinates, grown by the tile border, since that geometry also affects the neighboring tiles
+  const float fBorder = GetTileBorderSize(config);
+  const ezBoundingBox& grid = inout_NavMeshDesc.m_Bounds;
+  const float fTileSize = inout_NavMeshDesc.m_fTileSize;
+
+  const ezInt32 iMinTileX = ezMath::Max((ezInt32)ezMath::Floor((changedArea.m_vMin.x - fBorder - grid.m_vMin.x) / fTileSize), 0);
+  const ezInt32 iMinTileY = ezMath::Max((ezInt32)ezMath::Floor((changedArea.m_vMin.y - fBorder - grid.m_vMin.z) / fTileSize), 0);
+  const ezInt32 iMaxTileX = ezMath::Min((ezInt32)ezMath::Floor((changedArea.m_vMax.x + fBorder - grid.m_vMin.x) / fTileSize), (ezInt32)inout_NavMeshDesc.m_uiNumTilesX - 1);
+  const ezInt32 iMaxTileY = ezMath::Min((ezInt32)ezMath::Floor((changedArea.m_vMax.y + fBorder - grid.m_vMin.z) / fTileSize), (ezInt32)inout_NavMeshDesc.m_uiNumTilesY - 1);
+
+  if (iMinTileX > iMaxTileX || iMinTileY > iMaxTileY)
+  {
+    ezLog::Warning("The changed area is outside of the navmesh, a full rebuild is necessary to extend the navmesh");
+    return EZ_SUCCESS;
+  }
 
-  if (BuildDetourNavMeshData(config, *out_NavMeshDesc.m_pNavMeshPolygons, out_NavMeshDesc.m_DetourNavmeshData).Failed())
+  if (!pg.BeginNextStep("Triangulate Mesh"))
     return EZ_FAILURE;
 
+  GenerateTriangleMeshFromDescription(geo);
+  MarkWalkableTriangles(config);
+  ComputeBoundingBox();
+
+  // the tiles only rasterize geometry within the vertical range of the grid, so extend it to the new geometry.
+  // The minimum is moved by whole cells, so that the heights in the other tiles are quantized the same way as before.
+  if (!m_Vertices.IsEmpty())
+  {
+    ezBoundingBox& bounds = inout_NavMeshDesc.m_Bounds;
+
+    if (m_BoundingBox.m_vMin.y < bounds.m_vMin.y)
+    {
+      bounds.m_vMin.y -= ezMath::Ceil((bounds.m_vMin.y - m_BoundingBox.m_vMin.y) / config.m_fCellHeight) * config.m_fCellHeight;
+    }
+
+    bounds.m_vMax.y = ezMath::Max(bounds.m_vMax.y, m_BoundingBox.m_vMax.y);
+  }
+
+  if (!pg.BeginNextStep("Assign Triangles to Tiles"))
+    return EZ_FAILURE;
+
+  ezDynamicArray<TileToBuild> tiles;
+  AssignTrianglesToTiles(config, inout_NavMeshDesc, iMinTileX, iMinTileY, iMaxTileX, iMaxTileY, tiles);
+
+  if (!pg.BeginNextStep("Build Tiles"))
+    return EZ_FAILURE;
+
+  if (BuildTiles(config, inout_NavMeshDesc, tiles, progress).Failed())
+    return EZ_FAILURE;
+
+  for (TileToBuild& tile : tiles)
+  {
+    const ezUInt32 uiOldTile = inout_NavMeshDesc.FindTile(tile.m_iTileX, tile.m_iTileY);
+    if (uiOldTile != ezInvalidIndex)
+    {
+      inout_NavMeshDesc.m_Tiles.RemoveAtAndSwap(uiOldTile);
+    }
+
+    if (!tile.m_Result.m_DetourTileData.IsEmpty())
+    {
+      inout_NavMeshDesc.m_Tiles.PushBack(std::move(tile.m_Result));
+    }
+  }
+
+  ezLog::Debug("Rebuilt {} navmesh tiles", tiles.GetCount());
   return EZ_SUCCESS;
 }
 
@@ -235,6 +341,17 @@ void ezRecastNavMeshBuilder::ComputeBoundingBox()
   }
 }
 
+void ezRecastNavMeshBuilder::MarkWalkableTriangles(const ezRecastConfig& config)
+{
+  if (m_Triangles.IsEmpty())
+    return;
+
+  // TODO Instead of this, it should use area IDs and then clear the non-walkable triangles
+  ezRcBuildContext context;
+  rcMarkWalkableTriangles(&context, config.m_WalkableSlope.GetDegree(), &m_Vertices[0].x, m_Vertices.GetCount(), &m_Triangles[0].m_VertexIdx[0],
+    m_Triangles.GetCount(), m_TriangleAreaIDs.GetData());
+}
+
 void ezRecastNavMeshBuilder::FillOutConfig(rcConfig& cfg, const ezRecastConfig& config, const ezBoundingBox& bbox)
 {
   ezMemoryUtils::ZeroFill(&cfg, 1);
@@ -261,41 +378,190 @@ void ezRecastNavMeshBuilder::FillOutConfig(rcConfig& cfg, const ezRecastConfig&
   rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
 }
 
-ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& config, rcPolyMesh& out_PolyMesh, ezProgress& progress)
+ezInt32 ezRecastNavMeshBuilder::GetTileCells(const ezRecastConfig& config)
 {
-  ezProgressRange pgRange("Build Poly Mesh", 13, true, &progress);
+  return ezMath::Max((ezInt32)(config.m_fTileSize / config.m_fCellSize), 16);
+}
 
-  rcConfig cfg;
-  FillOutConfig(cfg, config, m_BoundingBox);
+float ezRecastNavMeshBuilder::GetTileBorderSize(const ezRecastConfig& config)
+{
+  // same as rcConfig::borderSize, see BuildTiles()
+  return ((ezInt32)ceilf(config.m_fAgentRadius / config.m_fCellSize) + 3) * config.m_fCellSize;
+}
 
-  ezRcBuildContext* pContext = m_pRecastContext;
-  const float* pVertices = &m_Vertices[0].x;
-  const ezInt32* pTriangles = &m_Triangles[0].m_VertexIdx[0];
+ezResult ezRecastNavMeshBuilder::SetupTileGrid(const ezRecastConfig& config, ezRecastNavMeshResourceDescriptor& out_NavMeshDesc) const
+{
+  out_NavMeshDesc.m_Config = config;
+  out_NavMeshDesc.m_Bounds = m_BoundingBox;
+  out_NavMeshDesc.m_fTileSize = GetTileCells(config) * config.m_fCellSize;
 
-  rcHeightfield* heightfield = rcAllocHeightfield();
-  EZ_SCOPE_EXIT(rcFreeHeightField(heightfield));
+  const ezVec3 vExtents = m_BoundingBox.GetExtents();
+  out_NavMeshDesc.m_uiNumTilesX = ezMath::Max((ezUInt32)ezMath::Ceil(vExtents.x / out_NavMeshDesc.m_fTileSize), 1u);
+  out_NavMeshDesc.m_uiNumTilesY = ezMath::Max((ezUInt32)ezMath::Ceil(vExtents.z / out_NavMeshDesc.m_fTileSize), 1u);
 
-  if (!pgRange.BeginNextStep("Creating Heightfield"))
-    return EZ_FAILURE;
+  // Detour encodes the tile and polygon index in 22 bits of a dtPolyRef
+  const ezUInt32 uiNumTiles = out_NavMeshDesc.m_uiNumTilesX * out_NavMeshDesc.m_uiNumTilesY;
+  const ezUInt32 uiTileBits = ezMath::Min(ezMath::Log2i(ezMath::PowerOfTwo_Ceil(uiNumTiles)), 14u);
+  out_NavMeshDesc.m_uiMaxTiles = 1u << uiTileBits;
+  out_NavMeshDesc.m_uiMaxPolysPerTile = 1u << (22 - uiTileBits);
 
-  if (!rcCreateHeightfield(pContext, *heightfield, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch))
+  if (uiNumTiles > out_NavMeshDesc.m_uiMaxTiles)
   {
-    pContext->log(RC_LOG_ERROR, "Could not create solid heightfield");
+    ezLog::Error("The navmesh needs {} tiles, but only {} are supported. Increase the tile size.", uiNumTiles, out_NavMeshDesc.m_uiMaxTiles);
     return EZ_FAILURE;
   }
 
-  if (!pgRange.BeginNextStep("Mark Walkable Area"))
-    return EZ_FAILURE;
+  return EZ_SUCCESS;
+}
 
-  // TODO Instead of this, it should use area IDs and then clear the non-walkable triangles
-  rcMarkWalkableTriangles(
-    pContext, cfg.walkableSlopeAngle, pVertices, m_Vertices.GetCount(), pTriangles, m_Triangles.GetCount(), m_TriangleAreaIDs.GetData());
+void ezRecastNavMeshBuilder::AssignTrianglesToTiles(const ezRecastConfig& config, const ezRecastNavMeshResourceDescriptor& navMeshDesc,
+  ezInt32 iMinTileX, ezInt32 iMinTileY, ezInt32 iMaxTileX, ezInt32 iMaxTileY, ezDynamicArray<TileToBuild>& out_Tiles) const
+{
+  EZ_LOG_BLOCK("ezRecastNavMeshBuilder::AssignTrianglesToTiles");
+
+  const ezInt32 iNumTilesX = iMaxTileX - iMinTileX + 1;
+  const ezInt32 iNumTilesY = iMaxTileY - iMinTileY + 1;
 
-  if (!pgRange.BeginNextStep("Rasterize Triangles"))
+  out_Tiles.SetCount(iNumTilesX * iNumTilesY);
+
+  for (ezInt32 y = 0; y < iNumTilesY; ++y)
+  {
+    for (ezInt32 x = 0; x < iNumTilesX; ++x)
+    {
+      out_Tiles[y * iNumTilesX + x].m_iTileX = iMinTileX + x;
+      out_Tiles[y * iNumTilesX + x].m_iTileY = iMinTileY + y;
+    }
+  }
+
+  // every tile rasterizes the triangles that overlap the tile including its border
+  const float fBorder = GetTileBorderSize(config);
+  const float fTileSize = navMeshDesc.m_fTileSize;
+  const ezVec3 vOrigin = navMeshDesc.m_Bounds.m_vMin;
+
+  for (ezUInt32 t = 0; t < m_Triangles.GetCount(); ++t)
+  {
+    const Triangle& tri = m_Triangles[t];
+    const ezVec3& v0 = m_Vertices[tri.m_VertexIdx[0]];
+    const ezVec3& v1 = m_Vertices[tri.m_VertexIdx[1]];
+    const ezVec3& v2 = m_Vertices[tri.m_VertexIdx[2]];
+
+    const float fMinX = ezMath::Min(v0.x, v1.x, v2.x) - fBorder - vOrigin.x;
+    const float fMaxX = ezMath::Max(v0.x, v1.x, v2.x) + fBorder - vOrigin.x;
+    const float fMinZ = ezMath::Min(v0.z, v1.z, v2.z) - fBorder - vOrigin.z;
+    const float fMaxZ = ezMath::Max(v0.z, v1.z, v2.z) + fBorder - vOrigin.z;
+
+    const ezInt32 iTileX0 = ezMath::Max((ezInt32)ezMath::Floor(fMinX / fTileSize), iMinTileX);
+    const ezInt32 iTileX1 = ezMath::Min((ezInt32)ezMath::Floor(fMaxX / fTileSize), iMaxTileX);
+    const ezInt32 iTileY0 = ezMath::Max((ezInt32)ezMath::Floor(fMinZ / fTileSize), iMinTileY);
+    const ezInt32 iTileY1 = ezMath::Min((ezInt32)ezMath::Floor(fMaxZ / fTileSize), iMaxTileY);
+
+    for (ezInt32 y = iTileY0; y <= iTileY1; ++y)
+    {
+      for (ezInt32 x = iTileX0; x <= iTileX1; ++x)
+      {
+        TileToBuild& tile = out_Tiles[(y - iMinTileY) * iNumTilesX + (x - iMinTileX)];
+        tile.m_TriangleIndices.PushBack(tri.m_VertexIdx[0]);
+        tile.m_TriangleIndices.PushBack(tri.m_VertexIdx[1]);
+        tile.m_TriangleIndices.PushBack(tri.m_VertexIdx[2]);
+        tile.m_TriangleAreaIDs.PushBack(m_TriangleAreaIDs[t]);
+      }
+    }
+  }
+}
+
+ezResult ezRecastNavMeshBuilder::BuildTiles(const ezRecastConfig& config, const ezRecastNavMeshResourceDescriptor& navMeshDesc,
+  ezDynamicArray<TileToBuild>& tiles, ezProgress& progress) const
+{
+  EZ_LOG_BLOCK("ezRecastNavMeshBuilder::BuildTiles");
+
+  rcConfig tileCfg;
+  FillOutConfig(tileCfg, config, navMeshDesc.m_Bounds);
+  tileCfg.tileSize = GetTileCells(config);
+  tileCfg.borderSize = tileCfg.walkableRadius + 3;
+  tileCfg.width = tileCfg.tileSize + tileCfg.borderSize * 2;
+  tileCfg.height = tileCfg.tileSize + tileCfg.borderSize * 2;
+
+  auto BuildTile = [&](TileToBuild& tile) {
+    if (tile.m_TriangleAreaIDs.IsEmpty())
+      return;
+
+    rcConfig cfg = tileCfg;
+    const float fBorder = cfg.borderSize * cfg.cs;
+    cfg.bmin[0] = navMeshDesc.m_Bounds.m_vMin.x + tile.m_iTileX * navMeshDesc.m_fTileSize - fBorder;
+    cfg.bmin[2] = navMeshDesc.m_Bounds.m_vMin.z + tile.m_iTileY * navMeshDesc.m_fTileSize - fBorder;
+    cfg.bmax[0] = navMeshDesc.m_Bounds.m_vMin.x + (tile.m_iTileX + 1) * navMeshDesc.m_fTileSize + fBorder;
+    cfg.bmax[2] = navMeshDesc.m_Bounds.m_vMin.z + (tile.m_iTileY + 1) * navMeshDesc.m_fTileSize + fBorder;
+
+    // rcContext is not thread-safe
+    ezRcBuildContext context;
+
+    ezUniquePtr<rcPolyMesh> pPolyMesh = EZ_DEFAULT_NEW(rcPolyMesh);
+    if (BuildRecastPolyMesh(&context, cfg, tile, *pPolyMesh).Failed())
+    {
+      tile.m_bFailed = true;
+      return;
+    }
+
+    if (pPolyMesh->npolys == 0)
+      return;
+
+    if (BuildDetourNavMeshData(config, *pPolyMesh, tile.m_iTileX, tile.m_iTileY, tile.m_Result.m_DetourTileData).Failed())
+    {
+      tile.m_bFailed = true;
+      return;
+    }
+
+    tile.m_Result.m_iTileX = tile.m_iTileX;
+    tile.m_Result.m_iTileY = tile.m_iTileY;
+    tile.m_Result.m_pPolygons = std::move(pPolyMesh);
+  };
+
+  // build the tiles in batches, to report progress and allow to cancel in between
+  const ezUInt32 uiBatchSize = ezMath::Max(ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks), 1u) * 4;
+  const ezUInt32 uiNumBatches = (tiles.GetCount() + uiBatchSize - 1) / uiBatchSize;
+
+  ezProgressRange pg("Build Tiles", uiNumBatches, true, &progress);
+
+  ezParallelForParams params;
+  params.uiBinSize = 1;
+  params.uiMaxTasksPerThread = 4; // the tiles take very different amounts of time
+
+  for (ezUInt32 uiFirstTile = 0; uiFirstTile < tiles.GetCount(); uiFirstTile += uiBatchSize)
+  {
+    if (!pg.BeginNextStep("Build Tiles"))
+      return EZ_FAILURE;
+
+    const ezUInt32 uiNumTiles = ezMath::Min(uiBatchSize, tiles.GetCount() - uiFirstTile);
+    ezTaskSystem::ParallelForSingle(tiles.GetArrayPtr().GetSubArray(uiFirstTile, uiNumTiles), BuildTile, "Build NavMesh Tiles", params);
+  }
+
+  for (const TileToBuild& tile : tiles)
+  {
+    if (tile.m_bFailed)
+    {
+      ezLog::Error("Failed to build navmesh tile {}/{}", tile.m_iTileX, tile.m_iTileY);
+      return EZ_FAILURE;
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(rcContext* pContext, const rcConfig& cfg, const TileToBuild& tile, rcPolyMesh& out_PolyMesh) const
+{
+  const float* pVertices = &m_Vertices[0].x;
+
+  rcHeightfield* heightfield = rcAllocHeightfield();
+  EZ_SCOPE_EXIT(rcFreeHeightField(heightfield));
+
+  if (!rcCreateHeightfield(pContext, *heightfield, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch))
+  {
+    pContext->log(RC_LOG_ERROR, "Could not create solid heightfield");
     return EZ_FAILURE;
+  }
 
-  if (!rcRasterizeTriangles(pContext, pVertices, m_Vertices.GetCount(), pTriangles, m_TriangleAreaIDs.GetData(), m_Triangles.GetCount(),
-        *heightfield, cfg.walkableClimb))
+  if (!rcRasterizeTriangles(pContext, pVertices, m_Vertices.GetCount(), tile.m_TriangleIndices.GetData(), tile.m_TriangleAreaIDs.GetData(),
+        tile.m_TriangleAreaIDs.GetCount(), *heightfield, cfg.walkableClimb))
   {
     pContext->log(RC_LOG_ERROR, "Could not rasterize triangles");
     return EZ_FAILURE;
@@ -303,28 +569,16 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
 
   // Optional stuff
   {
-    if (!pgRange.BeginNextStep("Filter Low Hanging Obstacles"))
-      return EZ_FAILURE;
-
     // if (m_filterLowHangingObstacles)
     rcFilterLowHangingWalkableObstacles(pContext, cfg.walkableClimb, *heightfield);
 
-    if (!pgRange.BeginNextStep("Filter Ledge Spans"))
-      return EZ_FAILURE;
-
     // if (m_filterLedgeSpans)
     rcFilterLedgeSpans(pContext, cfg.walkableHeight, cfg.walkableClimb, *heightfield);
 
-    if (!pgRange.BeginNextStep("Filter Low Height Spans"))
-      return EZ_FAILURE;
-
     // if (m_filterWalkableLowHeightSpans)
     rcFilterWalkableLowHeightSpans(pContext, cfg.walkableHeight, *heightfield);
   }
 
-  if (!pgRange.BeginNextStep("Build Compact Heightfield"))
-    return EZ_FAILURE;
-
   rcCompactHeightfield* compactHeightfield = rcAllocCompactHeightfield();
   EZ_SCOPE_EXIT(rcFreeCompactHeightfield(compactHeightfield));
 
@@ -334,9 +588,6 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     return EZ_FAILURE;
   }
 
-  if (!pgRange.BeginNextStep("Erode Walkable Area"))
-    return EZ_FAILURE;
-
   if (!rcErodeWalkableArea(pContext, cfg.walkableRadius, *compactHeightfield))
   {
     pContext->log(RC_LOG_ERROR, "Could not erode with character radius");
@@ -357,9 +608,6 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
   {
     // PARTITION_WATERSHED
     {
-      if (!pgRange.BeginNextStep("Build Distance Field"))
-        return EZ_FAILURE;
-
       // Prepare for region partitioning, by calculating distance field along the walkable surface.
       if (!rcBuildDistanceField(pContext, *compactHeightfield))
       {
@@ -367,42 +615,16 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
         return EZ_FAILURE;
       }
 
-      if (!pgRange.BeginNextStep("Build Regions"))
-        return EZ_FAILURE;
-
       // Partition the walkable surface into simple regions without holes.
-      if (!rcBuildRegions(pContext, *compactHeightfield, 0, cfg.minRegionArea, cfg.mergeRegionArea))
+      // The border of the tile gets its own regions, which are not turned into polygons.
+      if (!rcBuildRegions(pContext, *compactHeightfield, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
       {
         pContext->log(RC_LOG_ERROR, "Could not build watershed regions.");
         return EZ_FAILURE;
       }
     }
-
-    //// PARTITION_MONOTONE
-    //{
-    //  // Partition the walkable surface into simple regions without holes.
-    //  // Monotone partitioning does not need distance field.
-    //  if (!rcBuildRegionsMonotone(pContext, *compactHeightfield, 0, cfg.minRegionArea, cfg.mergeRegionArea))
-    //  {
-    //    pContext->log(RC_LOG_ERROR, "Could not build monotone regions.");
-    //    return EZ_FAILURE;
-    //  }
-    //}
-
-    //// PARTITION_LAYERS
-    //{
-    //  // Partition the walkable surface into simple regions without holes.
-    //  if (!rcBuildLayerRegions(pContext, *compactHeightfield, 0, cfg.minRegionArea))
-    //  {
-    //    pContext->log(RC_LOG_ERROR, "Could not build layer regions.");
-    //    return EZ_FAILURE;
-    //  }
-    //}
   }
 
-  if (!pgRange.BeginNextStep("Build Contours"))
-    return EZ_FAILURE;
-
   rcContourSet* contourSet = rcAllocContourSet();
   EZ_SCOPE_EXIT(rcFreeContourSet(contourSet));
 
@@ -412,9 +634,6 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     return EZ_FAILURE;
   }
 
-  if (!pgRange.BeginNextStep("Build Poly Mesh"))
-    return EZ_FAILURE;
-
   if (!rcBuildPolyMesh(pContext, *contourSet, cfg.maxVertsPerPoly, out_PolyMesh))
   {
     pContext->log(RC_LOG_ERROR, "Could not triangulate contours");
@@ -424,9 +643,6 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
   //////////////////////////////////////////////////////////////////////////
   // Detour Navmesh
 
-  if (!pgRange.BeginNextStep("Set Area Flags"))
-    return EZ_FAILURE;
-
   // TODO modify area IDs and flags
 
   for (int i = 0; i < out_PolyMesh.npolys; ++i)
@@ -440,7 +656,8 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
   return EZ_SUCCESS;
 }
 
-ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezDataBuffer& NavmeshData)
+ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(
+  const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezInt32 iTileX, ezInt32 iTileY, ezDataBuffer& NavmeshData)
 {
   dtNavMeshCreateParams params;
   ezMemoryUtils::ZeroFill(&params, 1);
@@ -455,6 +672,9 @@ ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& co
   params.walkableHeight = config.m_fAgentHeight;
   params.walkableRadius = config.m_fAgentRadius;
   params.walkableClimb = config.m_fAgentClimbHeight;
+  params.tileX = iTileX;
+  params.tileY = iTileY;
+  params.tileLayer = 0;
   rcVcopy(params.bmin, polyMesh.bmin);
   rcVcopy(params.bmax, polyMesh.bmax);
   params.cs = config.m_fCellSize;
@@ -479,7 +699,7 @@ ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& co
 
 ezResult ezRecastConfig::Serialize(ezStreamWriter& stream) const
 {
-  stream.WriteVersion(1);
+  stream.WriteVersion(2);
 
   stream << m_fAgentHeight;
   stream << m_fAgentRadius;
@@ -493,13 +713,14 @@ ezResult ezRecastConfig::Serialize(ezStreamWriter& stream) const
   stream << m_fRegionMergeSize;
   stream << m_fDetailMeshSampleDistanceFactor;
   stream << m_fDetailMeshSampleErrorFactor;
+  stream << m_fTileSize;
 
   return EZ_SUCCESS;
 }
 
 ezResult ezRecastConfig::Deserialize(ezStreamReader& stream)
 {
-  stream.ReadVersion(1);
+  const ezTypeVersion version = stream.ReadVersion(2);
 
   stream >> m_fAgentHeight;
   stream >> m_fAgentRadius;
@@ -514,5 +735,20 @@ ezResult ezRecastConfig::Deserialize(ezStreamReader& stream)
   stream >> m_fDetailMeshSampleDistanceFactor;
   stream >> m_fDetailMeshSampleErrorFactor;
 
+  if (version >= 2)
+  {
+    stream >> m_fTileSize;
+  }
+
   return EZ_SUCCESS;
 }
+
+bool ezRecastConfig::operator==(const ezRecastConfig& rhs) const
+{
+  return m_fAgentHeight == rhs.m_fAgentHeight && m_fAgentRadius == rhs.m_fAgentRadius && m_fAgentClimbHeight == rhs.m_fAgentClimbHeight &&
+         m_WalkableSlope == rhs.m_WalkableSlope && m_fCellSize == rhs.m_fCellSize && m_fCellHeight == rhs.m_fCellHeight &&
+         m_fMaxEdgeLength == rhs.m_fMaxEdgeLength && m_fMaxSimplificationError == rhs.m_fMaxSimplificationError &&
+         m_fMinRegionSize == rhs.m_fMinRegionSize && m_fRegionMergeSize == rhs.m_fRegionMergeSize &&
+         m_fDetailMeshSampleDistanceFactor == rhs.m_fDetailMeshSampleDistanceFactor &&
+         m_fDetailMeshSampleErrorFactor == rhs.m_fDetailMeshSampleErrorFactor && m_fTileSize == rhs.m_fTileSize;
+}
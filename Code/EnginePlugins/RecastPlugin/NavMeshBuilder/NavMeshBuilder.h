@@ -5,7 +5,7 @@
 #include <Foundation/Types/UniquePtr.h>
 #include <RecastPlugin/RecastPluginDLL.h>
 
-class ezRcBuildContext;
+class rcContext;
 struct rcPolyMesh;
 struct rcPolyMeshDetail;
 class ezWorld;
@@ -30,14 +30,25 @@ struct EZ_RECASTPLUGIN_DLL ezRecastConfig
   float m_fDetailMeshSampleDistanceFactor = 1.0f;
   float m_fDetailMeshSampleErrorFactor = 1.0f;
 
+  /// The navmesh is built in square tiles of this size, in parallel. Smaller tiles allow to rebuild smaller areas after a change.
+  float m_fTileSize = 32.0f;
+
   ezResult Serialize(ezStreamWriter& stream) const;
   ezResult Deserialize(ezStreamReader& stream);
+
+  bool operator==(const ezRecastConfig& rhs) const;
+  bool operator!=(const ezRecastConfig& rhs) const { return !(*this == rhs); }
 };
 
 EZ_DECLARE_REFLECTABLE_TYPE(EZ_RECASTPLUGIN_DLL, ezRecastConfig);
 
 
 
+/// \brief Builds tiled Detour navmeshes from world geometry.
+///
+/// The geometry is split into a grid of ezRecastConfig::m_fTileSize sized tiles. Every tile only rasterizes the triangles that overlap it
+/// (plus a border of the agent radius), so the tiles are independent of each other and are built in parallel on the ezTaskSystem.
+/// After a change to the geometry, RebuildTiles() only builds the tiles that overlap the changed area.
 class EZ_RECASTPLUGIN_DLL ezRecastNavMeshBuilder
 {
 public:
@@ -49,15 +60,33 @@ public:
   ezResult Build(const ezRecastConfig& config, const ezWorldGeoExtractionUtil::Geometry& worldGeo,
     ezRecastNavMeshResourceDescriptor& out_NavMeshDesc, ezProgress& progress);
 
+  /// \brief Rebuilds all tiles of a previously built navmesh that overlap \a changedArea (in world space) and replaces them in \a inout_NavMeshDesc.
+  ///
+  /// \a worldGeo has to be the complete, updated world geometry. The tile grid of the previous build is kept, geometry outside of it is
+  /// ignored. Fails if the navmesh was built with a different config, in that case everything has to be rebuilt with Build().
+  ezResult RebuildTiles(const ezRecastConfig& config, const ezWorldGeoExtractionUtil::Geometry& worldGeo, const ezBoundingBox& changedArea,
+    ezRecastNavMeshResourceDescriptor& inout_NavMeshDesc, ezProgress& progress);
+
 private:
+  struct TileToBuild;
+
   static void FillOutConfig(struct rcConfig& cfg, const ezRecastConfig& config, const ezBoundingBox& bbox);
+  static ezInt32 GetTileCells(const ezRecastConfig& config);
+  static float GetTileBorderSize(const ezRecastConfig& config);
 
   void Clear();
   void ReserveMemory(const ezWorldGeoExtractionUtil::Geometry& desc);
   void GenerateTriangleMeshFromDescription(const ezWorldGeoExtractionUtil::Geometry& desc);
+  void MarkWalkableTriangles(const ezRecastConfig& config);
   void ComputeBoundingBox();
-  ezResult BuildRecastPolyMesh(const ezRecastConfig& config, rcPolyMesh& out_PolyMesh, ezProgress& progress);
-  static ezResult BuildDetourNavMeshData(const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezDataBuffer& NavmeshData);
+  ezResult SetupTileGrid(const ezRecastConfig& config, ezRecastNavMeshResourceDescriptor& out_NavMeshDesc) const;
+  void AssignTrianglesToTiles(const ezRecastConfig& config, const ezRecastNavMeshResourceDescriptor& navMeshDesc, ezInt32 iMinTileX,
+    ezInt32 iMinTileY, ezInt32 iMaxTileX, ezInt32 iMaxTileY, ezDynamicArray<TileToBuild>& out_Tiles) const;
+  ezResult BuildTiles(const ezRecastConfig& config, const ezRecastNavMeshResourceDescriptor& navMeshDesc, ezDynamicArray<TileToBuild>& tiles,
+    ezProgress& progress) const;
+  ezResult BuildRecastPolyMesh(rcContext* pContext, const struct rcConfig& cfg, const TileToBuild& tile, rcPolyMesh& out_PolyMesh) const;
+  static ezResult BuildDetourNavMeshData(
+    const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezInt32 iTileX, ezInt32 iTileY, ezDataBuffer& NavmeshData);
 
   struct Triangle
   {
@@ -76,5 +105,4 @@ private:
   ezDynamicArray<ezVec3> m_Vertices;
   ezDynamicArray<Triangle> m_Triangles;
   ezDynamicArray<ezUInt8> m_TriangleAreaIDs;
-  ezRcBuildContext* m_pRecastContext = nullptr;
 };
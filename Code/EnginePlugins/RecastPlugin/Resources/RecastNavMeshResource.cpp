@@ -1,6 +1,7 @@
 #include <RecastPluginPCH.h>
 
 #include <Core/Assets/AssetFileHeader.h>
+#include <Foundation/Containers/HybridArray.h>
 #include <Foundation/IO/ChunkStream.h>
 #include <Recast/DetourNavMesh.h>
 #include <Recast/Recast.h>
@@ -14,49 +15,12 @@ EZ_END_DYNAMIC_REFLECTED_TYPE;
 EZ_RESOURCE_IMPLEMENT_COMMON_CODE(ezRecastNavMeshResource);
 // clang-format on
 
-//////////////////////////////////////////////////////////////////////////
-
-ezRecastNavMeshResourceDescriptor::ezRecastNavMeshResourceDescriptor() = default;
-ezRecastNavMeshResourceDescriptor::ezRecastNavMeshResourceDescriptor(ezRecastNavMeshResourceDescriptor&& rhs)
-{
-  *this = std::move(rhs);
-}
-
-ezRecastNavMeshResourceDescriptor::~ezRecastNavMeshResourceDescriptor()
-{
-  Clear();
-}
-
-void ezRecastNavMeshResourceDescriptor::operator=(ezRecastNavMeshResourceDescriptor&& rhs)
-{
-  m_DetourNavmeshData = std::move(rhs.m_DetourNavmeshData);
-
-  m_pNavMeshPolygons = rhs.m_pNavMeshPolygons;
-  rhs.m_pNavMeshPolygons = nullptr;
-}
-
-void ezRecastNavMeshResourceDescriptor::Clear()
+namespace
 {
-  m_DetourNavmeshData.Clear();
-  EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
-}
-
-//////////////////////////////////////////////////////////////////////////
-
-ezResult ezRecastNavMeshResourceDescriptor::Serialize(ezStreamWriter& stream) const
-{
-  stream.WriteVersion(1);
-  EZ_SUCCEED_OR_RETURN(stream.WriteArray(m_DetourNavmeshData));
-
-  const bool hasPolygons = m_pNavMeshPolygons != nullptr;
-  stream << hasPolygons;
-
-  if (hasPolygons)
+  ezResult SerializePolyMesh(ezStreamWriter& stream, const rcPolyMesh& mesh)
   {
     EZ_CHECK_AT_COMPILETIME_MSG(sizeof(rcPolyMesh) == sizeof(void*) * 5 + sizeof(int) * 14, "rcPolyMesh data structure has changed");
 
-    const auto& mesh = *m_pNavMeshPolygons;
-
     stream << (int)mesh.nverts;
     stream << (int)mesh.npolys;
     stream << (int)mesh.npolys; // do not use mesh.maxpolys
@@ -79,29 +43,14 @@ ezResult ezRecastNavMeshResourceDescriptor::Serialize(ezStreamWriter& stream) co
     EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.regs, sizeof(ezUInt16) * mesh.npolys));
     EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.flags, sizeof(ezUInt16) * mesh.npolys));
     EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.areas, sizeof(ezUInt8) * mesh.npolys));
-  }
-
-  return EZ_SUCCESS;
-}
 
-ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
-{
-  Clear();
-
-  const ezTypeVersion version = stream.ReadVersion(1);
-  EZ_SUCCEED_OR_RETURN(stream.ReadArray(m_DetourNavmeshData));
-
-  bool hasPolygons = false;
-  stream >> hasPolygons;
+    return EZ_SUCCESS;
+  }
 
-  if (hasPolygons)
+  void DeserializePolyMesh(ezStreamReader& stream, rcPolyMesh& mesh)
   {
     EZ_CHECK_AT_COMPILETIME_MSG(sizeof(rcPolyMesh) == sizeof(void*) * 5 + sizeof(int) * 14, "rcPolyMesh data structure has changed");
 
-    m_pNavMeshPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
-
-    auto& mesh = *m_pNavMeshPolygons;
-
     stream >> mesh.nverts;
     stream >> mesh.npolys;
     stream >> mesh.maxpolys;
@@ -122,6 +71,7 @@ ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
     mesh.verts = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.nverts * 3, RC_ALLOC_PERM);
     mesh.polys = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys * mesh.nvp * 2, RC_ALLOC_PERM);
     mesh.regs = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys, RC_ALLOC_PERM);
+    mesh.flags = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys, RC_ALLOC_PERM);
     mesh.areas = (ezUInt8*)rcAlloc(sizeof(ezUInt8) * mesh.maxpolys, RC_ALLOC_PERM);
 
     stream.ReadBytes(mesh.verts, sizeof(ezUInt16) * mesh.nverts * 3);
@@ -130,6 +80,227 @@ ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
     stream.ReadBytes(mesh.flags, sizeof(ezUInt16) * mesh.maxpolys);
     stream.ReadBytes(mesh.areas, sizeof(ezUInt8) * mesh.maxpolys);
   }
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+ezRecastNavMeshTile::ezRecastNavMeshTile() = default;
+ezRecastNavMeshTile::ezRecastNavMeshTile(ezRecastNavMeshTile&& rhs)
+{
+  *this = std::move(rhs);
+}
+
+ezRecastNavMeshTile::~ezRecastNavMeshTile() = default;
+
+void ezRecastNavMeshTile::operator=(ezRecastNavMeshTile&& rhs)
+{
+  m_iTileX = rhs.m_iTileX;
+  m_iTileY = rhs.m_iTileY;
+  m_DetourTileData = std::move(rhs.m_DetourTileData);
+  m_pPolygons = std::move(rhs.m_pPolygons);
+}
+
+ezResult ezRecastNavMeshTile::Serialize(ezStreamWriter& stream) const
+{
+  stream << m_iTileX;
+  stream << m_iTileY;
+  EZ_SUCCEED_OR_RETURN(stream.WriteArray(m_DetourTileData));
+
+  const bool hasPolygons = m_pPolygons != nullptr;
+  stream << hasPolygons;
+
+  if (hasPolygons)
+  {
+    EZ_SUCCEED_OR_RETURN(SerializePolyMesh(stream, *m_pPolygons));
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezRecastNavMeshTile::Deserialize(ezStreamReader& stream)
+{
+  stream >> m_iTileX;
+  stream >> m_iTileY;
+  EZ_SUCCEED_OR_RETURN(stream.ReadArray(m_DetourTileData));
+
+  bool hasPolygons = false;
+  stream >> hasPolygons;
+
+  m_pPolygons.Clear();
+
+  if (hasPolygons)
+  {
+    m_pPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+    DeserializePolyMesh(stream, *m_pPolygons);
+  }
+
+  return EZ_SUCCESS;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezRecastNavMeshResourceDescriptor::ezRecastNavMeshResourceDescriptor() = default;
+ezRecastNavMeshResourceDescriptor::ezRecastNavMeshResourceDescriptor(ezRecastNavMeshResourceDescriptor&& rhs)
+{
+  *this = std::move(rhs);
+}
+
+ezRecastNavMeshResourceDescriptor::~ezRecastNavMeshResourceDescriptor()
+{
+  Clear();
+}
+
+void ezRecastNavMeshResourceDescriptor::operator=(ezRecastNavMeshResourceDescriptor&& rhs)
+{
+  m_Config = rhs.m_Config;
+  m_Bounds = rhs.m_Bounds;
+  m_fTileSize = rhs.m_fTileSize;
+  m_uiNumTilesX = rhs.m_uiNumTilesX;
+  m_uiNumTilesY = rhs.m_uiNumTilesY;
+  m_uiMaxTiles = rhs.m_uiMaxTiles;
+  m_uiMaxPolysPerTile = rhs.m_uiMaxPolysPerTile;
+  m_Tiles = std::move(rhs.m_Tiles);
+}
+
+void ezRecastNavMeshResourceDescriptor::Clear()
+{
+  m_Config = ezRecastConfig();
+  m_Bounds.SetInvalid();
+  m_fTileSize = 0.0f;
+  m_uiNumTilesX = 0;
+  m_uiNumTilesY = 0;
+  m_uiMaxTiles = 0;
+  m_uiMaxPolysPerTile = 0;
+  m_Tiles.Clear();
+}
+
+ezUInt32 ezRecastNavMeshResourceDescriptor::FindTile(ezInt32 iTileX, ezInt32 iTileY) const
+{
+  for (ezUInt32 i = 0; i < m_Tiles.GetCount(); ++i)
+  {
+    if (m_Tiles[i].m_iTileX == iTileX && m_Tiles[i].m_iTileY == iTileY)
+      return i;
+  }
+
+  return ezInvalidIndex;
+}
+
+ezResult ezRecastNavMeshResourceDescriptor::InitializeNavMesh(dtNavMesh& out_NavMesh)
+{
+  dtNavMeshParams params;
+  params.orig[0] = m_Bounds.m_vMin.x;
+  params.orig[1] = m_Bounds.m_vMin.y;
+  params.orig[2] = m_Bounds.m_vMin.z;
+  params.tileWidth = m_fTileSize;
+  params.tileHeight = m_fTileSize;
+  params.maxTiles = m_uiMaxTiles;
+  params.maxPolys = m_uiMaxPolysPerTile;
+
+  if (dtStatusFailed(out_NavMesh.init(&params)))
+  {
+    ezLog::Error("Could not initialize Detour navmesh with {} tiles.", m_uiMaxTiles);
+    return EZ_FAILURE;
+  }
+
+  for (auto& tile : m_Tiles)
+  {
+    // the dtNavMesh does not need to free the data, the descriptor owns it
+    if (dtStatusFailed(out_NavMesh.addTile(tile.m_DetourTileData.GetData(), tile.m_DetourTileData.GetCount(), 0, 0, nullptr)))
+    {
+      ezLog::Error("Could not add navmesh tile {}/{}.", tile.m_iTileX, tile.m_iTileY);
+      return EZ_FAILURE;
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezResult ezRecastNavMeshResourceDescriptor::Serialize(ezStreamWriter& stream) const
+{
+  stream.WriteVersion(2);
+
+  EZ_SUCCEED_OR_RETURN(m_Config.Serialize(stream));
+  stream << m_Bounds.m_vMin;
+  stream << m_Bounds.m_vMax;
+  stream << m_fTileSize;
+  stream << m_uiNumTilesX;
+  stream << m_uiNumTilesY;
+  stream << m_uiMaxTiles;
+  stream << m_uiMaxPolysPerTile;
+
+  stream << m_Tiles.GetCount();
+
+  for (const auto& tile : m_Tiles)
+  {
+    EZ_SUCCEED_OR_RETURN(tile.Serialize(stream));
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
+{
+  Clear();
+
+  const ezTypeVersion version = stream.ReadVersion(2);
+
+  if (version < 2)
+  {
+    // a single tile navmesh, as created by dtNavMesh::init(data)
+    ezRecastNavMeshTile& tile = m_Tiles.ExpandAndGetRef();
+    EZ_SUCCEED_OR_RETURN(stream.ReadArray(tile.m_DetourTileData));
+
+    bool hasPolygons = false;
+    stream >> hasPolygons;
+
+    if (hasPolygons)
+    {
+      tile.m_pPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+      DeserializePolyMesh(stream, *tile.m_pPolygons);
+    }
+
+    if (tile.m_DetourTileData.GetCount() < sizeof(dtMeshHeader))
+    {
+      m_Tiles.Clear();
+      return EZ_SUCCESS;
+    }
+
+    const dtMeshHeader* pHeader = reinterpret_cast<const dtMeshHeader*>(tile.m_DetourTileData.GetData());
+    if (pHeader->magic != DT_NAVMESH_MAGIC || pHeader->version != DT_NAVMESH_VERSION)
+      return EZ_FAILURE;
+
+    m_Bounds.m_vMin.Set(pHeader->bmin[0], pHeader->bmin[1], pHeader->bmin[2]);
+    m_Bounds.m_vMax.Set(pHeader->bmax[0], pHeader->bmax[1], pHeader->bmax[2]);
+    m_fTileSize = ezMath::Max(m_Bounds.m_vMax.x - m_Bounds.m_vMin.x, m_Bounds.m_vMax.z - m_Bounds.m_vMin.z);
+    m_uiNumTilesX = 1;
+    m_uiNumTilesY = 1;
+    m_uiMaxTiles = 1;
+    m_uiMaxPolysPerTile = pHeader->polyCount;
+    tile.m_iTileX = pHeader->x;
+    tile.m_iTileY = pHeader->y;
+
+    return EZ_SUCCESS;
+  }
+
+  EZ_SUCCEED_OR_RETURN(m_Config.Deserialize(stream));
+  stream >> m_Bounds.m_vMin;
+  stream >> m_Bounds.m_vMax;
+  stream >> m_fTileSize;
+  stream >> m_uiNumTilesX;
+  stream >> m_uiNumTilesY;
+  stream >> m_uiMaxTiles;
+  stream >> m_uiMaxPolysPerTile;
+
+  ezUInt32 uiNumTiles = 0;
+  stream >> uiNumTiles;
+
+  m_Tiles.SetCount(uiNumTiles);
+  for (auto& tile : m_Tiles)
+  {
+    EZ_SUCCEED_OR_RETURN(tile.Deserialize(stream));
+  }
 
   return EZ_SUCCESS;
 }
@@ -148,6 +319,95 @@ ezRecastNavMeshResource::~ezRecastNavMeshResource()
   EZ_DEFAULT_DELETE(m_pNavMesh);
 }
 
+ezResult ezRecastNavMeshResource::SetTile(ezRecastNavMeshTile&& tile)
+{
+  if (m_pNavMesh == nullptr)
+    return EZ_FAILURE;
+
+  if (tile.m_iTileX < 0 || tile.m_iTileY < 0 || tile.m_iTileX >= (ezInt32)m_NavMeshData.m_uiNumTilesX ||
+      tile.m_iTileY >= (ezInt32)m_NavMeshData.m_uiNumTilesY)
+  {
+    ezLog::Error("Navmesh tile {}/{} is outside of the tile grid.", tile.m_iTileX, tile.m_iTileY);
+    return EZ_FAILURE;
+  }
+
+  RemoveTileFromNavMesh(tile.m_iTileX, tile.m_iTileY);
+
+  ezRecastNavMeshTile& newTile = m_NavMeshData.m_Tiles.ExpandAndGetRef();
+  newTile = std::move(tile);
+
+  if (dtStatusFailed(m_pNavMesh->addTile(newTile.m_DetourTileData.GetData(), newTile.m_DetourTileData.GetCount(), 0, 0, nullptr)))
+  {
+    ezLog::Error("Could not add navmesh tile {}/{}.", newTile.m_iTileX, newTile.m_iTileY);
+    m_NavMeshData.m_Tiles.PopBack();
+    MergeTilePolygons();
+    return EZ_FAILURE;
+  }
+
+  MergeTilePolygons();
+  return EZ_SUCCESS;
+}
+
+void ezRecastNavMeshResource::RemoveTile(ezInt32 iTileX, ezInt32 iTileY)
+{
+  if (RemoveTileFromNavMesh(iTileX, iTileY))
+  {
+    MergeTilePolygons();
+  }
+}
+
+bool ezRecastNavMeshResource::RemoveTileFromNavMesh(ezInt32 iTileX, ezInt32 iTileY)
+{
+  const ezUInt32 uiTileIndex = m_NavMeshData.FindTile(iTileX, iTileY);
+  if (uiTileIndex == ezInvalidIndex)
+    return false;
+
+  if (m_pNavMesh != nullptr)
+  {
+    // the navmesh does not own the data, so it is not returned here
+    m_pNavMesh->removeTile(m_pNavMesh->getTileRefAt(iTileX, iTileY, 0), nullptr, nullptr);
+  }
+
+  m_NavMeshData.m_Tiles.RemoveAtAndSwap(uiTileIndex);
+  return true;
+}
+
+void ezRecastNavMeshResource::MergeTilePolygons()
+{
+  EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
+
+  ezHybridArray<rcPolyMesh*, 64> meshes;
+  ezUInt32 uiNumVertices = 0;
+
+  for (auto& tile : m_NavMeshData.m_Tiles)
+  {
+    if (tile.m_pPolygons != nullptr)
+    {
+      meshes.PushBack(tile.m_pPolygons.Borrow());
+      uiNumVertices += tile.m_pPolygons->nverts;
+    }
+  }
+
+  if (meshes.IsEmpty())
+    return;
+
+  // rcPolyMesh uses 16 bit indices and coordinates
+  const ezVec3 vExtents = m_NavMeshData.m_Bounds.GetExtents();
+  if (uiNumVertices > 0xFFFF || ezMath::Max(vExtents.x, vExtents.z) / meshes[0]->cs >= 0xFFFF)
+  {
+    ezLog::Warning("The navmesh is too large to be visualized.");
+    return;
+  }
+
+  m_pNavMeshPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+
+  rcContext context(false);
+  if (!rcMergePolyMeshes(&context, meshes.GetData(), meshes.GetCount(), *m_pNavMeshPolygons))
+  {
+    EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
+  }
+}
+
 ezResourceLoadDesc ezRecastNavMeshResource::UnloadData(Unload WhatToUnload)
 {
   ezResourceLoadDesc res;
@@ -155,9 +415,9 @@ ezResourceLoadDesc ezRecastNavMeshResource::UnloadData(Unload WhatToUnload)
   res.m_uiQualityLevelsLoadable = 0;
   res.m_State = ezResourceState::Unloaded;
 
-  m_DetourNavmeshData.Clear();
   EZ_DEFAULT_DELETE(m_pNavMesh);
   EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
+  m_NavMeshData.Clear();
 
   return res;
 }
@@ -194,7 +454,12 @@ ezResourceLoadDesc ezRecastNavMeshResource::UpdateContent(ezStreamReader* Stream
 void ezRecastNavMeshResource::UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage)
 {
   out_NewMemoryUsage.m_uiMemoryCPU = sizeof(ezRecastNavMeshResource);
-  out_NewMemoryUsage.m_uiMemoryCPU += m_DetourNavmeshData.GetHeapMemoryUsage();
+  out_NewMemoryUsage.m_uiMemoryCPU += m_NavMeshData.m_Tiles.GetHeapMemoryUsage();
+  for (const auto& tile : m_NavMeshData.m_Tiles)
+  {
+    out_NewMemoryUsage.m_uiMemoryCPU += tile.m_DetourTileData.GetHeapMemoryUsage();
+    out_NewMemoryUsage.m_uiMemoryCPU += tile.m_pPolygons != nullptr ? sizeof(rcPolyMesh) : 0;
+  }
   out_NewMemoryUsage.m_uiMemoryCPU += m_pNavMesh != nullptr ? sizeof(dtNavMesh) : 0;
   out_NewMemoryUsage.m_uiMemoryCPU += m_pNavMeshPolygons != nullptr ? sizeof(rcPolyMesh) : 0;
   out_NewMemoryUsage.m_uiMemoryGPU = 0;
@@ -207,16 +472,20 @@ ezResourceLoadDesc ezRecastNavMeshResource::CreateResource(ezRecastNavMeshResour
   res.m_uiQualityLevelsLoadable = 0;
   res.m_State = ezResourceState::Loaded;
 
-  m_pNavMeshPolygons = descriptor.m_pNavMeshPolygons;
-  descriptor.m_pNavMeshPolygons = nullptr;
+  m_NavMeshData = std::move(descriptor);
 
-  m_DetourNavmeshData = std::move(descriptor.m_DetourNavmeshData);
+  // the tile grid may start out empty and be filled through SetTile()
+  if (m_NavMeshData.m_uiMaxTiles > 0)
+  {
+    m_pNavMesh = EZ_DEFAULT_NEW(dtNavMesh);
 
-  m_pNavMesh = EZ_DEFAULT_NEW(dtNavMesh);
+    if (m_NavMeshData.InitializeNavMesh(*m_pNavMesh).Failed())
+    {
+      EZ_DEFAULT_DELETE(m_pNavMesh);
+    }
+  }
 
-  // the dtNavMesh does not need to free the data, the resource owns it
-  const int dtMeshFlags = 0;
-  m_pNavMesh->init(m_DetourNavmeshData.GetData(), m_DetourNavmeshData.GetCount(), dtMeshFlags);
+  MergeTilePolygons();
 
   return res;
 }
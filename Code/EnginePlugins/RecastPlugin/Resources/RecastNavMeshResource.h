@@ -1,6 +1,9 @@
 #pragma once
 
 #include <Core/ResourceManager/Resource.h>
+#include <Foundation/Math/BoundingBox.h>
+#include <Foundation/Types/UniquePtr.h>
+#include <RecastPlugin/NavMeshBuilder/NavMeshBuilder.h>
 #include <RecastPlugin/RecastPluginDLL.h>
 
 struct rcPolyMesh;
@@ -8,6 +11,27 @@ class dtNavMesh;
 
 typedef ezTypedResourceHandle<class ezRecastNavMeshResource> ezRecastNavMeshResourceHandle;
 
+/// \brief One tile of a tiled navmesh, see ezRecastNavMeshResourceDescriptor.
+struct EZ_RECASTPLUGIN_DLL ezRecastNavMeshTile
+{
+  ezRecastNavMeshTile();
+  ezRecastNavMeshTile(ezRecastNavMeshTile&& rhs);
+  ~ezRecastNavMeshTile();
+  void operator=(ezRecastNavMeshTile&& rhs);
+
+  ezInt32 m_iTileX = 0;
+  ezInt32 m_iTileY = 0;
+
+  /// \brief Data that was created by dtCreateNavMeshData() and will be used for dtNavMesh::addTile()
+  ezDataBuffer m_DetourTileData;
+
+  /// \brief Optional, if available the tile can be visualized at runtime
+  ezUniquePtr<rcPolyMesh> m_pPolygons;
+
+  ezResult Serialize(ezStreamWriter& stream) const;
+  ezResult Deserialize(ezStreamReader& stream);
+};
+
 struct EZ_RECASTPLUGIN_DLL ezRecastNavMeshResourceDescriptor
 {
   ezRecastNavMeshResourceDescriptor();
@@ -17,14 +41,36 @@ struct EZ_RECASTPLUGIN_DLL ezRecastNavMeshResourceDescriptor
   void operator=(ezRecastNavMeshResourceDescriptor&& rhs);
   void operator=(const ezRecastNavMeshResourceDescriptor& rhs) = delete;
 
-  /// \brief Data that was created by dtCreateNavMeshData() and will be used for dtNavMesh::init()
-  ezDataBuffer m_DetourNavmeshData;
+  /// \brief The config that the navmesh was built with. Tiles can only be rebuilt with the same config.
+  ezRecastConfig m_Config;
 
-  /// \brief Optional, if available the navmesh can be visualized at runtime
-  rcPolyMesh* m_pNavMeshPolygons = nullptr;
+  /// \brief The area covered by the tile grid, in Recast coordinates (Y up). Tile (0, 0) starts at the minimum.
+  ezBoundingBox m_Bounds;
+
+  /// \brief Edge length of the square tiles.
+  float m_fTileSize = 0.0f;
+
+  ezUInt32 m_uiNumTilesX = 0;
+  ezUInt32 m_uiNumTilesY = 0;
+
+  /// \brief Passed to dtNavMeshParams, these determine how the bits of a dtPolyRef are split up.
+  ezUInt32 m_uiMaxTiles = 0;
+  ezUInt32 m_uiMaxPolysPerTile = 0;
+
+  /// \brief All tiles that contain any polygons, in no particular order.
+  ezDynamicArray<ezRecastNavMeshTile> m_Tiles;
 
   void Clear();
 
+  /// \brief Returns the index of the tile in m_Tiles, or ezInvalidIndex.
+  ezUInt32 FindTile(ezInt32 iTileX, ezInt32 iTileY) const;
+
+  /// \brief Initializes \a out_NavMesh for the tile grid and adds all tiles.
+  ///
+  /// The navmesh does not take ownership of the tile data, so this descriptor has to be kept alive and the tiles must not be modified
+  /// while the navmesh is in use. Note that Detour writes the links between the polygons into the tile data.
+  ezResult InitializeNavMesh(dtNavMesh& out_NavMesh);
+
   ezResult Serialize(ezStreamWriter& stream) const;
   ezResult Deserialize(ezStreamReader& stream);
 };
@@ -40,14 +86,28 @@ public:
   ~ezRecastNavMeshResource();
 
   const dtNavMesh* GetNavMesh() const { return m_pNavMesh; }
+
+  /// \brief The polygons of all tiles merged into one mesh, for visualization. May be null.
   const rcPolyMesh* GetNavMeshPolygons() const { return m_pNavMeshPolygons; }
 
+  /// \brief Adds the tile to the navmesh, or replaces the tile at the same coordinates. Tiles outside of the tile grid are rejected.
+  ///
+  /// This allows to stream in tiles or to swap in tiles that were rebuilt with ezRecastNavMeshBuilder::RebuildTiles().
+  /// Must not be called while anyone uses the navmesh, in a running world use ezRecastWorldModule::SetNavMeshTile() instead.
+  ezResult SetTile(ezRecastNavMeshTile&& tile);
+
+  /// \brief Removes the tile at the given coordinates from the navmesh, if it exists. Same restrictions as SetTile().
+  void RemoveTile(ezInt32 iTileX, ezInt32 iTileY);
+
 private:
   virtual ezResourceLoadDesc UnloadData(Unload WhatToUnload) override;
   virtual ezResourceLoadDesc UpdateContent(ezStreamReader* Stream) override;
   virtual void UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage) override;
 
-  ezDataBuffer m_DetourNavmeshData;
+  bool RemoveTileFromNavMesh(ezInt32 iTileX, ezInt32 iTileY);
+  void MergeTilePolygons();
+
+  ezRecastNavMeshResourceDescriptor m_NavMeshData;
   dtNavMesh* m_pNavMesh = nullptr;
   rcPolyMesh* m_pNavMeshPolygons = nullptr;
 };
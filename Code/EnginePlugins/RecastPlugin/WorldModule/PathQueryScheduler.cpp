@@ -0,0 +1,355 @@
+#include <RecastPluginPCH.h>
+
+#include <Foundation/Threading/Lock.h>
+#include <RecastPlugin/Utils/RcMath.h>
+#include <RecastPlugin/WorldModule/PathQueryScheduler.h>
+
+namespace
+{
+  /// \todo Hard-coded limit, same as ezRcAgentComponent
+  static constexpr ezUInt32 s_uiMaxPathCorridorLength = 256;
+
+  static ezResult FindNavMeshPolyAt(const dtNavMeshQuery& query, const dtQueryFilter& filter, const ezVec3& vPosition, float fPlaneEpsilon,
+    float fHeightEpsilon, dtPolyRef& out_PolyRef, ezVec3& out_vAdjustedPosition)
+  {
+    ezRcPos rcPos = vPosition;
+    ezVec3 vSize(fPlaneEpsilon, fHeightEpsilon, fPlaneEpsilon);
+
+    ezRcPos resultPos;
+    if (dtStatusFailed(query.findNearestPoly(rcPos, &vSize.x, &filter, &out_PolyRef, resultPos)) || out_PolyRef == 0)
+      return EZ_FAILURE;
+
+    if (!ezMath::IsEqual(vPosition.x, resultPos.m_Pos[0], fPlaneEpsilon) || !ezMath::IsEqual(vPosition.y, resultPos.m_Pos[2], fPlaneEpsilon) ||
+        !ezMath::IsEqual(vPosition.z, resultPos.m_Pos[1], fHeightEpsilon))
+      return EZ_FAILURE;
+
+    out_vAdjustedPosition = resultPos;
+    return EZ_SUCCESS;
+  }
+} // namespace
+
+ezRcPathQueryScheduler::ezRcPathQueryScheduler()
+{
+  m_UpdateTask.m_pScheduler = this;
+  m_UpdateTask.ConfigureTask("Path Queries", ezTaskNesting::Never);
+}
+
+ezRcPathQueryScheduler::~ezRcPathQueryScheduler()
+{
+  WaitForWorkers();
+}
+
+void ezRcPathQueryScheduler::SetNavMesh(const dtNavMesh* pNavMesh, ezUInt32 uiNumWorkers /*= 2*/, ezUInt32 uiMaxSearchNodes /*= 2048*/)
+{
+  WaitForWorkers();
+
+  {
+    EZ_LOCK(m_Mutex);
+
+    // searches that are in progress are bound to the old navmesh, start them again
+    for (Worker& worker : m_Workers)
+    {
+      if (worker.m_bHasCurrent)
+      {
+        InsertPending(worker.m_Current);
+      }
+    }
+
+    // results that were not delivered yet reference polygons of the old navmesh as well
+    for (const FinishedQuery& finished : m_FinishedQueries)
+    {
+      if (m_CancelledQueries.Remove(finished.m_Request.m_uiQueryId))
+        continue;
+
+      InsertPending(finished.m_Request);
+    }
+
+    m_FinishedQueries.Clear();
+  }
+
+  m_Workers.Clear();
+  m_pNavMesh = pNavMesh;
+
+  if (m_pNavMesh == nullptr)
+    return;
+
+  m_Workers.SetCount(ezMath::Max(uiNumWorkers, 1u));
+  for (Worker& worker : m_Workers)
+  {
+    worker.m_pQuery = EZ_DEFAULT_NEW(dtNavMeshQuery);
+    worker.m_pQuery->init(m_pNavMesh, uiMaxSearchNodes);
+  }
+}
+
+ezUInt32 ezRcPathQueryScheduler::RequestPath(const ezRcPathQueryDesc& desc)
+{
+  Request request;
+  request.m_uiQueryId = m_uiNextQueryId;
+  request.m_Desc = desc;
+  request.m_Deadline = ezTime::Now() + desc.m_Timeout;
+
+  // zero is never used as an ID, so that it can be used for 'no query'
+  m_uiNextQueryId = ezMath::Max(m_uiNextQueryId + 1, 1u);
+
+  m_ActiveQueries.Insert(request.m_uiQueryId, desc.m_hRequester);
+
+  EZ_LOCK(m_Mutex);
+  InsertPending(request);
+
+  return request.m_uiQueryId;
+}
+
+void ezRcPathQueryScheduler::CancelPath(ezUInt32 uiQueryId)
+{
+  if (!m_ActiveQueries.Remove(uiQueryId))
+    return;
+
+  // whoever comes across the request next drops it: a worker, or Update() if the result is already done
+  EZ_LOCK(m_Mutex);
+  m_CancelledQueries.Insert(uiQueryId);
+}
+
+void ezRcPathQueryScheduler::Update(ezDynamicArray<Result>& out_Results)
+{
+  if (!ezTaskSystem::IsTaskGroupFinished(m_UpdateTaskGroup))
+    return;
+
+  bool bHasWork = false;
+
+  {
+    EZ_LOCK(m_Mutex);
+
+    for (FinishedQuery& finished : m_FinishedQueries)
+    {
+      if (m_ActiveQueries.Remove(finished.m_Result.m_uiQueryId))
+      {
+        out_Results.PushBack(std::move(finished.m_Result));
+      }
+      else
+      {
+        m_CancelledQueries.Remove(finished.m_Result.m_uiQueryId);
+      }
+    }
+
+    m_FinishedQueries.Clear();
+
+    bHasWork = !m_PendingRequests.IsEmpty();
+  }
+
+  for (const Worker& worker : m_Workers)
+  {
+    bHasWork |= worker.m_bHasCurrent;
+  }
+
+  if (!bHasWork || m_Workers.IsEmpty())
+    return;
+
+  m_UpdateTask.SetMultiplicity(m_Workers.GetCount());
+  m_UpdateTaskGroup = ezTaskSystem::StartSingleTask(&m_UpdateTask, ezTaskPriority::LongRunning);
+}
+
+void ezRcPathQueryScheduler::WaitForWorkers()
+{
+  ezTaskSystem::WaitForGroup(m_UpdateTaskGroup);
+}
+
+bool ezRcPathQueryScheduler::IsMoreUrgent(const Request& a, const Request& b)
+{
+  if (a.m_Desc.m_fPriority != b.m_Desc.m_fPriority)
+    return a.m_Desc.m_fPriority > b.m_Desc.m_fPriority;
+
+  if (a.m_Deadline != b.m_Deadline)
+    return a.m_Deadline < b.m_Deadline;
+
+  return a.m_uiQueryId < b.m_uiQueryId;
+}
+
+void ezRcPathQueryScheduler::InsertPending(const Request& request)
+{
+  // binary search for the first request that is more urgent, so that the most urgent one ends up at the back
+  ezUInt32 uiLow = 0;
+  ezUInt32 uiHigh = m_PendingRequests.GetCount();
+
+  while (uiLow < uiHigh)
+  {
+    const ezUInt32 uiMid = (uiLow + uiHigh) / 2;
+
+    if (IsMoreUrgent(m_PendingRequests[uiMid], request))
+      uiHigh = uiMid;
+    else
+      uiLow = uiMid + 1;
+  }
+
+  m_PendingRequests.Insert(request, uiLow);
+}
+
+bool ezRcPathQueryScheduler::PopRequest(Request& out_Request)
+{
+  const ezTime tNow = ezTime::Now();
+
+  EZ_LOCK(m_Mutex);
+
+  while (!m_PendingRequests.IsEmpty())
+  {
+    out_Request = m_PendingRequests.PeekBack();
+    m_PendingRequests.PopBack();
+
+    if (m_CancelledQueries.Remove(out_Request.m_uiQueryId))
+      continue;
+
+    if (tNow > out_Request.m_Deadline)
+    {
+      Result& result = AddFinishedQuery(out_Request);
+      result.m_Status = ezRcPathQueryStatus::DeadlineExceeded;
+      result.m_vStartOnNavMesh = out_Request.m_Desc.m_vStart;
+      continue;
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+bool ezRcPathQueryScheduler::IsCancelled(ezUInt32 uiQueryId)
+{
+  EZ_LOCK(m_Mutex);
+  return m_CancelledQueries.Remove(uiQueryId);
+}
+
+void ezRcPathQueryScheduler::ProcessQueries(ezUInt32 uiWorker)
+{
+  Worker& worker = m_Workers[uiWorker];
+  const ezTime tNow = ezTime::Now();
+
+  if (worker.m_bHasCurrent && IsCancelled(worker.m_Current.m_uiQueryId))
+  {
+    worker.m_bHasCurrent = false;
+  }
+
+  ezInt32 iIterationsLeft = static_cast<ezInt32>(m_uiMaxIterationsPerUpdate);
+
+  while (iIterationsLeft > 0)
+  {
+    if (!worker.m_bHasCurrent)
+    {
+      if (!PopRequest(worker.m_Current))
+        return;
+
+      worker.m_bHasCurrent = true;
+      StartQuery(worker);
+
+      // looking up the start and end polygon is not free either
+      --iIterationsLeft;
+      continue;
+    }
+
+    if (tNow > worker.m_Current.m_Deadline)
+    {
+      AddResult(worker, ezRcPathQueryStatus::DeadlineExceeded);
+      continue;
+    }
+
+    int iDoneIterations = 0;
+    const dtStatus status = worker.m_pQuery->updateSlicedFindPath(iIterationsLeft, &iDoneIterations);
+    iIterationsLeft -= ezMath::Max(iDoneIterations, 1);
+
+    // the search continues in the next update
+    if (dtStatusInProgress(status))
+      continue;
+
+    FinishQuery(worker, status);
+  }
+}
+
+void ezRcPathQueryScheduler::StartQuery(Worker& worker)
+{
+  const ezRcPathQueryDesc& desc = worker.m_Current.m_Desc;
+
+  if (FindNavMeshPolyAt(*worker.m_pQuery, worker.m_QueryFilter, desc.m_vStart, desc.m_fPlaneEpsilon, desc.m_fHeightEpsilon, worker.m_StartPoly,
+        worker.m_vStartOnNavMesh)
+        .Failed())
+  {
+    worker.m_vStartOnNavMesh = desc.m_vStart;
+    AddResult(worker, ezRcPathQueryStatus::StartOutsideNavArea);
+    return;
+  }
+
+  ezVec3 vTargetOnNavMesh;
+  if (FindNavMeshPolyAt(*worker.m_pQuery, worker.m_QueryFilter, desc.m_vTarget, desc.m_fPlaneEpsilon, desc.m_fHeightEpsilon, worker.m_EndPoly,
+        vTargetOnNavMesh)
+        .Failed())
+  {
+    AddResult(worker, ezRcPathQueryStatus::TargetOutsideNavArea);
+    return;
+  }
+
+  const ezRcPos rcStart = worker.m_vStartOnNavMesh;
+  const ezRcPos rcEnd = desc.m_vTarget;
+
+  if (dtStatusFailed(worker.m_pQuery->initSlicedFindPath(worker.m_StartPoly, worker.m_EndPoly, rcStart, rcEnd, &worker.m_QueryFilter)))
+  {
+    AddResult(worker, ezRcPathQueryStatus::NoPath);
+  }
+}
+
+void ezRcPathQueryScheduler::FinishQuery(Worker& worker, dtStatus status)
+{
+  FinishedQuery finished;
+  finished.m_Request = worker.m_Current;
+
+  Result& result = finished.m_Result;
+  result.m_uiQueryId = worker.m_Current.m_uiQueryId;
+  result.m_hRequester = worker.m_Current.m_Desc.m_hRequester;
+  result.m_vStartOnNavMesh = worker.m_vStartOnNavMesh;
+  result.m_vTarget = worker.m_Current.m_Desc.m_vTarget;
+  result.m_Status = ezRcPathQueryStatus::NoPath;
+
+  worker.m_bHasCurrent = false;
+
+  if (dtStatusSucceed(status))
+  {
+    ezInt32 iPathCorridorLength = 0;
+    result.m_PathCorridor.SetCountUninitialized(s_uiMaxPathCorridorLength);
+
+    if (dtStatusSucceed(worker.m_pQuery->finalizeSlicedFindPath(
+          result.m_PathCorridor.GetData(), &iPathCorridorLength, (int)result.m_PathCorridor.GetCount())) &&
+        iPathCorridorLength > 0)
+    {
+      result.m_PathCorridor.SetCountUninitialized(iPathCorridorLength);
+
+      // if the path does not end at the target polygon, the target cannot be reached, but one can walk close to it
+      result.m_Status = (result.m_PathCorridor.PeekBack() == worker.m_EndPoly) ? ezRcPathQueryStatus::Success : ezRcPathQueryStatus::PartialPath;
+    }
+    else
+    {
+      result.m_PathCorridor.Clear();
+    }
+  }
+
+  EZ_LOCK(m_Mutex);
+  m_FinishedQueries.PushBack(std::move(finished));
+}
+
+void ezRcPathQueryScheduler::AddResult(Worker& worker, ezRcPathQueryStatus::Enum status)
+{
+  worker.m_bHasCurrent = false;
+
+  EZ_LOCK(m_Mutex);
+
+  Result& result = AddFinishedQuery(worker.m_Current);
+  result.m_Status = status;
+  result.m_vStartOnNavMesh = worker.m_vStartOnNavMesh;
+}
+
+ezRcPathQueryScheduler::Result& ezRcPathQueryScheduler::AddFinishedQuery(const Request& request)
+{
+  EZ_ASSERT_DEBUG(m_Mutex.IsLocked(), "The mutex has to be locked");
+
+  FinishedQuery& finished = m_FinishedQueries.ExpandAndGetRef();
+  finished.m_Request = request;
+  finished.m_Result.m_uiQueryId = request.m_uiQueryId;
+  finished.m_Result.m_hRequester = request.m_Desc.m_hRequester;
+  finished.m_Result.m_vTarget = request.m_Desc.m_vTarget;
+  return finished.m_Result;
+}
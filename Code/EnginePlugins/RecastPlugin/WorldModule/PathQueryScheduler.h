@@ -0,0 +1,169 @@
+#pragma once
+
+#include <RecastPlugin/RecastPluginDLL.h>
+
+#include <Core/World/Declarations.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Containers/HashSet.h>
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/Threading/Mutex.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Time.h>
+#include <Foundation/Types/UniquePtr.h>
+#include <Recast/DetourNavMeshQuery.h>
+
+struct ezRcPathQueryStatus
+{
+  typedef ezUInt8 StorageType;
+
+  enum Enum
+  {
+    Success,              ///< A path to the target was found.
+    PartialPath,          ///< The target cannot be reached, the path leads as close to it as possible.
+    StartOutsideNavArea,  ///< The start position is not on the navmesh.
+    TargetOutsideNavArea, ///< The target position is not on the navmesh.
+    NoPath,               ///< Path-finding failed.
+    DeadlineExceeded,     ///< The request was not finished before its deadline.
+
+    Default = NoPath
+  };
+};
+
+/// \brief Describes one path request for ezRcPathQueryScheduler::RequestPath().
+struct ezRcPathQueryDesc
+{
+  ezVec3 m_vStart;
+  ezVec3 m_vTarget;
+
+  /// The component that receives the result. The request is dropped when it does not exist anymore.
+  ezComponentHandle m_hRequester;
+
+  /// Requests with a higher priority are started first. Requests with the same priority are started in the order of their deadlines.
+  float m_fPriority = 0.0f;
+
+  /// If the request is not finished within this time, it fails with ezRcPathQueryStatus::DeadlineExceeded.
+  ezTime m_Timeout = ezTime::Seconds(2);
+
+  /// How far the start and target position may be away from the navmesh, see ezRcAgentComponent::FindNavMeshPolyAt().
+  float m_fPlaneEpsilon = 0.01f;
+  float m_fHeightEpsilon = 1.0f;
+};
+
+/// \brief Runs Detour path searches on long-running ezTaskSystem workers, sliced over multiple frames.
+///
+/// Every worker owns a dtNavMeshQuery and picks the most urgent pending request whenever it is idle. Per frame each worker only does
+/// a limited number of search iterations, very long searches are continued in the next frame. Results are collected on the main thread
+/// by Update(), which never waits for the workers.
+///
+/// This class does not know about worlds, ezRcPathQueryWorldModule uses it to serve the agents of a world.
+class EZ_RECASTPLUGIN_DLL ezRcPathQueryScheduler
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezRcPathQueryScheduler);
+
+public:
+  struct Result
+  {
+    ezUInt32 m_uiQueryId = 0;
+    ezComponentHandle m_hRequester;
+    ezEnum<ezRcPathQueryStatus> m_Status;
+    ezVec3 m_vStartOnNavMesh;
+    ezVec3 m_vTarget;
+    ezDynamicArray<dtPolyRef> m_PathCorridor;
+  };
+
+  ezRcPathQueryScheduler();
+  ~ezRcPathQueryScheduler();
+
+  /// \brief Creates \a uiNumWorkers query objects for the given navmesh. Requests that were already started or finished, but not yet
+  /// delivered, are restarted on the new navmesh.
+  void SetNavMesh(const dtNavMesh* pNavMesh, ezUInt32 uiNumWorkers = 2, ezUInt32 uiMaxSearchNodes = 2048);
+
+  const dtNavMesh* GetNavMesh() const { return m_pNavMesh; }
+
+  /// \brief How many search iterations each worker may do per Update(). Lower values make the workers finish faster, but long searches
+  /// take more frames.
+  void SetMaxIterationsPerUpdate(ezUInt32 uiIterations) { m_uiMaxIterationsPerUpdate = uiIterations; }
+
+  /// \brief Queues a path request and returns its ID. The result is returned by one of the next Update() calls.
+  ezUInt32 RequestPath(const ezRcPathQueryDesc& desc);
+
+  /// \brief The result of the request is never returned. Does nothing, if the request was already finished.
+  void CancelPath(ezUInt32 uiQueryId);
+
+  /// \brief Whether the request is still waiting for its result.
+  bool IsPathQueryActive(ezUInt32 uiQueryId) const { return m_ActiveQueries.Contains(uiQueryId); }
+
+  /// \brief Maps the IDs of all unfinished requests to their requester.
+  const ezHashTable<ezUInt32, ezComponentHandle>& GetActiveQueries() const { return m_ActiveQueries; }
+
+  /// \brief Appends all results that became available to \a out_Results and lets the workers continue. Has to be called once per frame.
+  ///
+  /// If the workers are still busy with the previous slice, nothing happens and the function returns immediately.
+  void Update(ezDynamicArray<Result>& out_Results);
+
+  /// \brief Blocks until the currently running slice is finished.
+  void WaitForWorkers();
+
+private:
+  struct Request
+  {
+    ezUInt32 m_uiQueryId;
+    ezRcPathQueryDesc m_Desc;
+    ezTime m_Deadline;
+  };
+
+  struct Worker
+  {
+    ezUniquePtr<dtNavMeshQuery> m_pQuery; // careful, dtNavMeshQuery is not moveable
+    dtQueryFilter m_QueryFilter;          /// \todo hard-coded filter
+    Request m_Current;
+    bool m_bHasCurrent = false;
+    dtPolyRef m_StartPoly = 0;
+    dtPolyRef m_EndPoly = 0;
+    ezVec3 m_vStartOnNavMesh;
+  };
+
+  struct FinishedQuery
+  {
+    Request m_Request; // kept to restart the search when the navmesh changes before the result was delivered
+    Result m_Result;
+  };
+
+  class UpdateTask final : public ezTask
+  {
+  public:
+    ezRcPathQueryScheduler* m_pScheduler = nullptr;
+
+  private:
+    virtual void ExecuteWithMultiplicity(ezUInt32 uiInvocation) const override { m_pScheduler->ProcessQueries(uiInvocation); }
+  };
+
+  static bool IsMoreUrgent(const Request& a, const Request& b);
+
+  void ProcessQueries(ezUInt32 uiWorker);
+  bool PopRequest(Request& out_Request);
+  bool IsCancelled(ezUInt32 uiQueryId);
+  void StartQuery(Worker& worker);
+  void FinishQuery(Worker& worker, dtStatus status);
+  void AddResult(Worker& worker, ezRcPathQueryStatus::Enum status);
+  Result& AddFinishedQuery(const Request& request);
+  void InsertPending(const Request& request);
+
+  const dtNavMesh* m_pNavMesh = nullptr;
+  ezUInt32 m_uiMaxIterationsPerUpdate = 1000;
+  ezUInt32 m_uiNextQueryId = 1;
+
+  // only accessed on the main thread
+  ezHashTable<ezUInt32, ezComponentHandle> m_ActiveQueries;
+
+  // written by the workers, read on the main thread when the workers are idle
+  ezDynamicArray<Worker> m_Workers;
+
+  ezMutex m_Mutex;
+  ezDynamicArray<Request> m_PendingRequests; // sorted, most urgent request at the end
+  ezHashSet<ezUInt32> m_CancelledQueries;
+  ezDynamicArray<FinishedQuery> m_FinishedQueries;
+
+  UpdateTask m_UpdateTask;
+  ezTaskGroupID m_UpdateTaskGroup;
+};
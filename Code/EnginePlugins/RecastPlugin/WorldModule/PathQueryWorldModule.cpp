@@ -0,0 +1,87 @@
+#include <RecastPluginPCH.h>
+
+#include <Core/World/World.h>
+#include <RecastPlugin/WorldModule/PathQueryWorldModule.h>
+#include <RecastPlugin/WorldModule/RecastWorldModule.h>
+
+// clang-format off
+EZ_IMPLEMENT_MESSAGE_TYPE(ezMsgRcPathQueryResult);
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMsgRcPathQueryResult, 1, ezRTTIDefaultAllocator<ezMsgRcPathQueryResult>)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+EZ_IMPLEMENT_WORLD_MODULE(ezRcPathQueryWorldModule);
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezRcPathQueryWorldModule, 1, ezRTTINoAllocator)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+// clang-format on
+
+ezRcPathQueryWorldModule::ezRcPathQueryWorldModule(ezWorld* pWorld)
+  : ezWorldModule(pWorld)
+{
+}
+
+ezRcPathQueryWorldModule::~ezRcPathQueryWorldModule() = default;
+
+void ezRcPathQueryWorldModule::Initialize()
+{
+  SUPER::Initialize();
+
+  m_pRecastModule = GetWorld()->GetOrCreateModule<ezRecastWorldModule>();
+
+  {
+    auto updateDesc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezRcPathQueryWorldModule::UpdateQueries, this);
+    updateDesc.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::PreAsync;
+    updateDesc.m_bOnlyUpdateWhenSimulating = true;
+    // deliver the results before the agents are updated
+    updateDesc.m_fPriority = 1000.0f;
+
+    RegisterUpdateFunction(updateDesc);
+  }
+}
+
+void ezRcPathQueryWorldModule::Deinitialize()
+{
+  m_Scheduler.SetNavMesh(nullptr);
+
+  SUPER::Deinitialize();
+}
+
+void ezRcPathQueryWorldModule::UpdateQueries(const UpdateContext& ctxt)
+{
+  if (m_pRecastModule->GetDetourNavMesh() != m_Scheduler.GetNavMesh())
+  {
+    m_Scheduler.SetNavMesh(m_pRecastModule->GetDetourNavMesh());
+  }
+
+  // don't waste time on requests whose agent is gone
+  {
+    m_DeadQueries.Clear();
+
+    for (auto it = m_Scheduler.GetActiveQueries().GetIterator(); it.IsValid(); ++it)
+    {
+      if (!GetWorld()->IsValidComponent(it.Value()))
+      {
+        m_DeadQueries.PushBack(it.Key());
+      }
+    }
+
+    for (ezUInt32 uiQueryId : m_DeadQueries)
+    {
+      m_Scheduler.CancelPath(uiQueryId);
+    }
+  }
+
+  m_Results.Clear();
+  m_Scheduler.Update(m_Results);
+
+  for (const auto& result : m_Results)
+  {
+    ezMsgRcPathQueryResult msg;
+    msg.m_uiQueryId = result.m_uiQueryId;
+    msg.m_Status = result.m_Status;
+    msg.m_vStartOnNavMesh = result.m_vStartOnNavMesh;
+    msg.m_vTarget = result.m_vTarget;
+    msg.m_PathCorridor = result.m_PathCorridor;
+
+    GetWorld()->SendMessage(result.m_hRequester, msg);
+  }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <RecastPlugin/RecastPluginDLL.h>
+
+#include <Core/World/WorldModule.h>
+#include <Foundation/Communication/Message.h>
+#include <RecastPlugin/WorldModule/PathQueryScheduler.h>
+
+class ezRecastWorldModule;
+
+/// \brief Sent by ezRcPathQueryWorldModule to the component that requested a path, once the result is available.
+struct EZ_RECASTPLUGIN_DLL ezMsgRcPathQueryResult : public ezMessage
+{
+  EZ_DECLARE_MESSAGE_TYPE(ezMsgRcPathQueryResult, ezMessage);
+
+  ezUInt32 m_uiQueryId = 0;
+  ezEnum<ezRcPathQueryStatus> m_Status;
+  ezVec3 m_vStartOnNavMesh;
+  ezVec3 m_vTarget;
+
+  /// Only valid during message handling.
+  ezArrayPtr<const dtPolyRef> m_PathCorridor;
+};
+
+/// \brief Answers path requests of all components in a world asynchronously, see ezRcPathQueryScheduler.
+///
+/// Results are delivered with ezMsgRcPathQueryResult at the beginning of a frame. Requests of components that were deleted in the meantime
+/// are cancelled.
+class EZ_RECASTPLUGIN_DLL ezRcPathQueryWorldModule : public ezWorldModule
+{
+  EZ_DECLARE_WORLD_MODULE();
+  EZ_ADD_DYNAMIC_REFLECTION(ezRcPathQueryWorldModule, ezWorldModule);
+
+public:
+  ezRcPathQueryWorldModule(ezWorld* pWorld);
+  ~ezRcPathQueryWorldModule();
+
+  virtual void Initialize() override;
+  virtual void Deinitialize() override;
+
+  /// \brief Queues a path request, the result is sent to desc.m_hRequester. Returns the ID of the request.
+  ezUInt32 RequestPath(const ezRcPathQueryDesc& desc) { return m_Scheduler.RequestPath(desc); }
+
+  /// \brief Makes sure that the result of the request is never sent.
+  void CancelPath(ezUInt32 uiQueryId) { m_Scheduler.CancelPath(uiQueryId); }
+
+  /// \brief See ezRcPathQueryScheduler::SetMaxIterationsPerUpdate().
+  void SetMaxIterationsPerFrame(ezUInt32 uiIterations) { m_Scheduler.SetMaxIterationsPerUpdate(uiIterations); }
+
+  /// \brief Waits for the searches in progress, they are started again in the next update.
+  ///
+  /// Called by ezRecastWorldModule before it modifies the navmesh.
+  void RestartQueries() { m_Scheduler.SetNavMesh(m_Scheduler.GetNavMesh()); }
+
+private:
+  void UpdateQueries(const UpdateContext& ctxt);
+
+  ezRecastWorldModule* m_pRecastModule = nullptr;
+  ezRcPathQueryScheduler m_Scheduler;
+  ezDynamicArray<ezRcPathQueryScheduler::Result> m_Results;
+  ezDynamicArray<ezUInt32> m_DeadQueries;
+};
@@ -3,6 +3,7 @@
 #include <Core/World/World.h>
 #include <Recast/DetourCrowd.h>
 #include <RecastPlugin/Resources/RecastNavMeshResource.h>
+#include <RecastPlugin/WorldModule/PathQueryWorldModule.h>
 #include <RecastPlugin/WorldModule/RecastWorldModule.h>
 
 // clang-format off
@@ -48,8 +49,25 @@ void ezRecastWorldModule::SetNavMeshResource(const ezRecastNavMeshResourceHandle
   m_pNavMeshPointsOfInterest.Clear();
 }
 
+void ezRecastWorldModule::SetNavMeshTile(ezRecastNavMeshTile&& tile)
+{
+  m_PendingTileChanges.PushBack(std::move(tile));
+}
+
+void ezRecastWorldModule::RemoveNavMeshTile(ezInt32 iTileX, ezInt32 iTileY)
+{
+  ezRecastNavMeshTile& tile = m_PendingTileChanges.ExpandAndGetRef();
+  tile.m_iTileX = iTileX;
+  tile.m_iTileY = iTileY;
+}
+
 void ezRecastWorldModule::UpdateNavMesh(const UpdateContext& ctxt)
 {
+  if (m_pDetourNavMesh != nullptr && !m_PendingTileChanges.IsEmpty())
+  {
+    ApplyTileChanges();
+  }
+
   if (m_pDetourNavMesh == nullptr && m_hNavMesh.IsValid())
   {
     ezResourceLock<ezRecastNavMeshResource> pNavMesh(m_hNavMesh, ezResourceAcquireMode::BlockTillLoaded_NeverFail);
@@ -60,7 +78,10 @@ void ezRecastWorldModule::UpdateNavMesh(const UpdateContext& ctxt)
     m_pDetourNavMesh = pNavMesh->GetNavMesh();
 
     m_pNavMeshPointsOfInterest = EZ_DEFAULT_NEW(ezNavMeshPointOfInterestGraph);
-    m_pNavMeshPointsOfInterest->ExtractInterestPointsFromMesh(*pNavMesh->GetNavMeshPolygons());
+    if (pNavMesh->GetNavMeshPolygons() != nullptr)
+    {
+      m_pNavMeshPointsOfInterest->ExtractInterestPointsFromMesh(*pNavMesh->GetNavMeshPolygons());
+    }
   }
 
   if (m_pNavMeshPointsOfInterest)
@@ -69,6 +90,38 @@ void ezRecastWorldModule::UpdateNavMesh(const UpdateContext& ctxt)
   }
 }
 
+void ezRecastWorldModule::ApplyTileChanges()
+{
+  // the path searches read the navmesh on other threads
+  if (ezRcPathQueryWorldModule* pPathQueries = GetWorld()->GetModule<ezRcPathQueryWorldModule>())
+  {
+    pPathQueries->RestartQueries();
+  }
+
+  ezResourceLock<ezRecastNavMeshResource> pNavMesh(m_hNavMesh, ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+
+  if (pNavMesh.GetAcquireResult() == ezResourceAcquireResult::Final)
+  {
+    for (ezRecastNavMeshTile& tile : m_PendingTileChanges)
+    {
+      if (tile.m_DetourTileData.IsEmpty())
+      {
+        pNavMesh->RemoveTile(tile.m_iTileX, tile.m_iTileY);
+      }
+      else
+      {
+        pNavMesh->SetTile(std::move(tile)).IgnoreResult();
+      }
+    }
+  }
+
+  m_PendingTileChanges.Clear();
+
+  // the navmesh pointer and the points of interest are fetched again from the modified resource
+  m_pDetourNavMesh = nullptr;
+  m_pNavMeshPointsOfInterest.Clear();
+}
+
 void ezRecastWorldModule::ResourceEventHandler(const ezResourceEvent& e)
 {
   if (e.m_Type == ezResourceEvent::Type::ResourceContentUnloading &&
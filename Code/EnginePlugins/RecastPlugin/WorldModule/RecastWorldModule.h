@@ -5,13 +5,12 @@
 #include <Core/ResourceManager/ResourceHandle.h>
 #include <Core/World/WorldModule.h>
 #include <NavMeshBuilder/NavMeshPointsOfInterest.h>
+#include <RecastPlugin/Resources/RecastNavMeshResource.h>
 
 class dtCrowd;
 class dtNavMesh;
 struct ezResourceEvent;
 
-typedef ezTypedResourceHandle<class ezRecastNavMeshResource> ezRecastNavMeshResourceHandle;
-
 class EZ_RECASTPLUGIN_DLL ezRecastWorldModule : public ezWorldModule
 {
   EZ_DECLARE_WORLD_MODULE();
@@ -27,6 +26,17 @@ public:
   void SetNavMeshResource(const ezRecastNavMeshResourceHandle& hNavMesh);
   const ezRecastNavMeshResourceHandle& GetNavMeshResource() { return m_hNavMesh; }
 
+  /// \brief Adds the tile to the navmesh or replaces the tile at the same coordinates, see ezRecastNavMeshResource::SetTile().
+  ///
+  /// This allows to stream in tiles or to swap in tiles that were rebuilt with ezRecastNavMeshBuilder::RebuildTiles() at runtime.
+  /// The change is applied at the end of the frame, after the path searches of the ezRcPathQueryWorldModule were stopped, they are
+  /// started again afterwards. Polygon references into a replaced tile become invalid.
+  /// Note that the navmesh resource is modified, so the change affects all worlds that use it.
+  void SetNavMeshTile(ezRecastNavMeshTile&& tile);
+
+  /// \brief Removes the tile at the given coordinates from the navmesh at the end of the frame, same as SetNavMeshTile().
+  void RemoveNavMeshTile(ezInt32 iTileX, ezInt32 iTileY);
+
   const dtNavMesh* GetDetourNavMesh() const { return m_pDetourNavMesh; }
   const ezNavMeshPointOfInterestGraph* GetNavMeshPointsOfInterestGraph() const { return m_pNavMeshPointsOfInterest.Borrow(); }
   ezNavMeshPointOfInterestGraph* AccessNavMeshPointsOfInterestGraph() const { return m_pNavMeshPointsOfInterest.Borrow(); }
@@ -34,8 +44,12 @@ public:
 private:
   void UpdateNavMesh(const UpdateContext& ctxt);
   void ResourceEventHandler(const ezResourceEvent& e);
+  void ApplyTileChanges();
 
   const dtNavMesh* m_pDetourNavMesh = nullptr;
   ezRecastNavMeshResourceHandle m_hNavMesh;
   ezUniquePtr<ezNavMeshPointOfInterestGraph> m_pNavMeshPointsOfInterest;
+
+  /// Tiles without Detour data remove the tile at their coordinates
+  ezDynamicArray<ezRecastNavMeshTile> m_PendingTileChanges;
 };
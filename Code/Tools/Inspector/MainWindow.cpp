@@ -10,6 +10,7 @@
 #include <Inspector/MainWindow.moc.h>
 #include <Inspector/MemoryWidget.moc.h>
 #include <Inspector/PluginsWidget.moc.h>
+#include <Inspector/ProfilingWidget.moc.h>
 #include <Inspector/ReflectionWidget.moc.h>
 #include <Inspector/ResourceWidget.moc.h>
 #include <Inspector/SubsystemsWidget.moc.h>
@@ -51,6 +52,7 @@ ezQtMainWindow::ezQtMainWindow()
   ezQtLogDockWidget* pLogWidget = new ezQtLogDockWidget();
   ezQtMemoryWidget* pMemoryWidget = new ezQtMemoryWidget();
   ezQtTimeWidget* pTimeWidget = new ezQtTimeWidget();
+  ezQtProfilingWidget* pProfilingWidget = new ezQtProfilingWidget();
   ezQtInputWidget* pInputWidget = new ezQtInputWidget();
   ezQtCVarsWidget* pCVarsWidget = new ezQtCVarsWidget();
   ezQtSubsystemsWidget* pSubsystemsWidget = new ezQtSubsystemsWidget();
@@ -65,6 +67,7 @@ ezQtMainWindow::ezQtMainWindow()
   EZ_VERIFY(nullptr != QWidget::connect(pLogWidget, &ads::CDockWidget::viewToggled, this, &ezQtMainWindow::DockWidgetVisibilityChanged), "");
   EZ_VERIFY(nullptr != QWidget::connect(pTimeWidget, &ads::CDockWidget::viewToggled, this, &ezQtMainWindow::DockWidgetVisibilityChanged), "");
   EZ_VERIFY(nullptr != QWidget::connect(pMemoryWidget, &ads::CDockWidget::viewToggled, this, &ezQtMainWindow::DockWidgetVisibilityChanged), "");
+  EZ_VERIFY(nullptr != QWidget::connect(pProfilingWidget, &ads::CDockWidget::viewToggled, this, &ezQtMainWindow::DockWidgetVisibilityChanged), "");
   EZ_VERIFY(nullptr != QWidget::connect(pInputWidget, &ads::CDockWidget::viewToggled, this, &ezQtMainWindow::DockWidgetVisibilityChanged), "");
   EZ_VERIFY(nullptr != QWidget::connect(pCVarsWidget, &ads::CDockWidget::viewToggled, this, &ezQtMainWindow::DockWidgetVisibilityChanged), "");
   EZ_VERIFY(nullptr != QWidget::connect(pReflectionWidget, &ads::CDockWidget::viewToggled, this, &ezQtMainWindow::DockWidgetVisibilityChanged), "");
@@ -121,6 +124,7 @@ ezQtMainWindow::ezQtMainWindow()
   m_DockManager->addDockWidget(ads::BottomDockWidgetArea, pFileWidget);
   m_DockManager->addDockWidgetTab(ads::BottomDockWidgetArea, pMemoryWidget);
   m_DockManager->addDockWidgetTab(ads::BottomDockWidgetArea, pTimeWidget);
+  m_DockManager->addDockWidgetTab(ads::BottomDockWidgetArea, pProfilingWidget);
 
 
   pLogWidget->raise();
@@ -261,6 +265,7 @@ void ezQtMainWindow::UpdateNetwork()
     ezQtLogDockWidget::s_pWidget->ResetStats();
     ezQtMemoryWidget::s_pWidget->ResetStats();
     ezQtTimeWidget::s_pWidget->ResetStats();
+    ezQtProfilingWidget::s_pWidget->ResetStats();
     ezQtInputWidget::s_pWidget->ResetStats();
     ezQtCVarsWidget::s_pWidget->ResetStats();
     ezQtReflectionWidget::s_pWidget->ResetStats();
@@ -279,6 +284,7 @@ void ezQtMainWindow::UpdateNetwork()
   ezQtSubsystemsWidget::s_pWidget->UpdateStats();
   ezQtMemoryWidget::s_pWidget->UpdateStats();
   ezQtTimeWidget::s_pWidget->UpdateStats();
+  ezQtProfilingWidget::s_pWidget->UpdateStats();
   ezQtFileWidget::s_pWidget->UpdateStats();
   ezQtResourceWidget::s_pWidget->UpdateStats();
   // ezQtDataWidget::s_pWidget->UpdateStats();
@@ -296,6 +302,7 @@ void ezQtMainWindow::DockWidgetVisibilityChanged(bool bVisible)
   ActionShowWindowLog->setChecked(!ezQtLogDockWidget::s_pWidget->isClosed());
   ActionShowWindowMemory->setChecked(!ezQtMemoryWidget::s_pWidget->isClosed());
   ActionShowWindowTime->setChecked(!ezQtTimeWidget::s_pWidget->isClosed());
+  ActionShowWindowProfiling->setChecked(!ezQtProfilingWidget::s_pWidget->isClosed());
   ActionShowWindowInput->setChecked(!ezQtInputWidget::s_pWidget->isClosed());
   ActionShowWindowCVar->setChecked(!ezQtCVarsWidget::s_pWidget->isClosed());
   ActionShowWindowReflection->setChecked(!ezQtReflectionWidget::s_pWidget->isClosed());
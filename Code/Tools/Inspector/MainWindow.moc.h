@@ -36,6 +36,7 @@ private Q_SLOTS:
   void on_ActionShowWindowLog_triggered();
   void on_ActionShowWindowMemory_triggered();
   void on_ActionShowWindowTime_triggered();
+  void on_ActionShowWindowProfiling_triggered();
   void on_ActionShowWindowInput_triggered();
   void on_ActionShowWindowCVar_triggered();
   void on_ActionShowWindowReflection_triggered();
@@ -10,6 +10,7 @@
 #include <Inspector/MainWindow.moc.h>
 #include <Inspector/MemoryWidget.moc.h>
 #include <Inspector/PluginsWidget.moc.h>
+#include <Inspector/ProfilingWidget.moc.h>
 #include <Inspector/ReflectionWidget.moc.h>
 #include <Inspector/ResourceWidget.moc.h>
 #include <Inspector/SubsystemsWidget.moc.h>
@@ -33,6 +34,12 @@ void ezQtMainWindow::on_ActionShowWindowTime_triggered()
   ezQtTimeWidget::s_pWidget->raise();
 }
 
+void ezQtMainWindow::on_ActionShowWindowProfiling_triggered()
+{
+  ezQtProfilingWidget::s_pWidget->toggleView(ActionShowWindowProfiling->isChecked());
+  ezQtProfilingWidget::s_pWidget->raise();
+}
+
 void ezQtMainWindow::on_ActionShowWindowInput_triggered()
 {
   ezQtInputWidget::s_pWidget->toggleView(ActionShowWindowInput->isChecked());
@@ -0,0 +1,585 @@
+#include <InspectorPCH.h>
+
+#include <Foundation/Communication/Telemetry.h>
+#include <Foundation/IO/CompressedStreamZstd.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <GuiFoundation/GuiFoundationDLL.h>
+#include <Inspector/ProfilingWidget.moc.h>
+#include <QGraphicsPathItem>
+#include <QGraphicsSimpleTextItem>
+#include <QGraphicsView>
+
+ezQtProfilingWidget* ezQtProfilingWidget::s_pWidget = nullptr;
+
+static QColor s_Colors[ezQtProfilingWidget::s_uiMaxColors] = {
+  QColor(255, 106, 0), // orange
+  QColor(182, 255, 0), // lime green
+  QColor(255, 0, 255), // pink
+  QColor(0, 148, 255), // light blue
+  QColor(255, 0, 0),   // red
+  QColor(0, 255, 255), // turquoise
+  QColor(178, 0, 255), // purple
+  QColor(0, 38, 255),  // dark blue
+  QColor(72, 0, 255),  // lilac
+};
+
+namespace
+{
+  // reads the variable-length encoded data written by the InspectorPlugin, see InspectorPlugin/Profiling.cpp for the layout
+  class Decoder
+  {
+  public:
+    Decoder(ezArrayPtr<const ezUInt8> data)
+      : m_Data(data)
+    {
+    }
+
+    bool IsValid() const { return !m_bError; }
+
+    ezUInt64 UInt()
+    {
+      ezUInt64 uiValue = 0;
+
+      for (ezUInt32 uiShift = 0; uiShift < 64; uiShift += 7)
+      {
+        if (m_uiPos >= m_Data.GetCount())
+        {
+          m_bError = true;
+          return 0;
+        }
+
+        const ezUInt8 uiByte = m_Data[m_uiPos++];
+        uiValue |= static_cast<ezUInt64>(uiByte & 0x7F) << uiShift;
+
+        if ((uiByte & 0x80) == 0)
+          break;
+      }
+
+      return uiValue;
+    }
+
+    ezInt64 Int()
+    {
+      const ezUInt64 uiValue = UInt();
+      return static_cast<ezInt64>(uiValue >> 1) ^ -static_cast<ezInt64>(uiValue & 1);
+    }
+
+    ezUInt8 Byte()
+    {
+      if (m_uiPos >= m_Data.GetCount())
+      {
+        m_bError = true;
+        return 0;
+      }
+
+      return m_Data[m_uiPos++];
+    }
+
+    void String(ezString& out_sString)
+    {
+      const ezUInt32 uiLength = static_cast<ezUInt32>(UInt());
+
+      if (m_uiPos + uiLength > m_Data.GetCount())
+      {
+        m_bError = true;
+        return;
+      }
+
+      ezStringBuilder sTemp;
+      sTemp.SetSubString_ElementCount(reinterpret_cast<const char*>(m_Data.GetPtr() + m_uiPos), uiLength);
+      out_sString = sTemp;
+      m_uiPos += uiLength;
+    }
+
+  private:
+    ezArrayPtr<const ezUInt8> m_Data;
+    ezUInt32 m_uiPos = 0;
+    bool m_bError = false;
+  };
+} // namespace
+
+ezQtProfilingWidget::ezQtProfilingWidget(QWidget* parent)
+  : ads::CDockWidget("Profiling Widget", parent)
+{
+  s_pWidget = this;
+
+  setupUi(this);
+  setWidget(ProfilingWidgetFrame);
+
+  {
+    ezQtScopedUpdatesDisabled _1(ComboTimeframe);
+
+    ComboTimeframe->addItem("Timeframe: 50 milliseconds");
+    ComboTimeframe->addItem("Timeframe: 100 milliseconds");
+    ComboTimeframe->addItem("Timeframe: 500 milliseconds");
+    ComboTimeframe->addItem("Timeframe: 1 second");
+    ComboTimeframe->addItem("Timeframe: 5 seconds");
+    ComboTimeframe->setCurrentIndex(1);
+  }
+
+  m_pPathFrames = m_Scene.addPath(QPainterPath(), QPen(QBrush(QColor(64, 64, 64)), 0));
+
+  for (ezUInt32 i = 0; i < s_uiMaxColors; ++i)
+    m_pPath[i] = m_Scene.addPath(QPainterPath(), QPen(Qt::NoPen), QBrush(s_Colors[i]));
+
+  ProfilingView->setScene(&m_Scene);
+
+  ProfilingView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+  ProfilingView->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+  ProfilingView->setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+
+  ResetStats();
+}
+
+void ezQtProfilingWidget::ResetStats()
+{
+  // the application forgets about the stream when the connection is lost, so request it again
+  m_bEnabled = false;
+  m_bDetailsChanged = true;
+
+  m_MaxTime.SetZero();
+
+  m_Strings.Clear();
+  m_Threads.Clear();
+  m_GPUThread = ThreadData();
+  m_FrameStartTimes.Clear();
+  m_Workers.Clear();
+  m_Allocators.Clear();
+
+  TreeDetails->clear();
+}
+
+void ezQtProfilingWidget::SendEnableState()
+{
+  const bool bEnable = isVisible() && !CheckPause->isChecked() && ezTelemetry::IsConnectedToServer();
+
+  if (bEnable == m_bEnabled)
+    return;
+
+  m_bEnabled = bEnable;
+
+  if (m_bEnabled)
+  {
+    // the application starts a new string and thread table for every stream, packets of an older stream are recognized by their session ID
+    ++m_uiSessionID;
+
+    m_Strings.Clear();
+    m_Threads.Clear();
+    m_Allocators.Clear();
+    m_bDetailsChanged = true;
+  }
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  const bool bSupportsCompression = true;
+#else
+  const bool bSupportsCompression = false;
+#endif
+
+  ezTelemetryMessage msg;
+  msg.SetMessageID('PROF', 'ENBL');
+  msg.GetWriter() << m_bEnabled;
+  msg.GetWriter() << bSupportsCompression;
+  msg.GetWriter() << m_uiSessionID;
+  ezTelemetry::SendToServer(msg);
+}
+
+const char* ezQtProfilingWidget::GetString(ezUInt32 uiIndex) const
+{
+  if (uiIndex < m_Strings.GetCount())
+    return m_Strings[uiIndex].GetData();
+
+  return "<unknown>";
+}
+
+void ezQtProfilingWidget::UpdateStats()
+{
+  SendEnableState();
+
+  if (!isVisible())
+    return;
+
+  if (!ezTelemetry::IsConnectedToServer())
+  {
+    TreeDetails->setEnabled(false);
+    return;
+  }
+
+  TreeDetails->setEnabled(true);
+
+  if (CheckPause->isChecked())
+    return;
+
+  RemoveOldData();
+
+  // timeline
+  {
+    QPainterPath pp[s_uiMaxColors];
+    QPainterPath ppFrames;
+
+    const ezTime minTime = m_MaxTime - m_DisplayInterval;
+    const double fLabelMinWidth = m_DisplayInterval.GetSeconds() * 0.1;
+
+    for (QGraphicsSimpleTextItem* pLabel : m_Labels)
+    {
+      m_Scene.removeItem(pLabel);
+      delete pLabel;
+    }
+    m_Labels.Clear();
+
+    auto AddLabel = [&](const char* szText, double x, double y) {
+      QGraphicsSimpleTextItem* pLabel = m_Scene.addSimpleText(szText);
+      pLabel->setBrush(QColor(255, 255, 255));
+      pLabel->setPos(x, y);
+      pLabel->setFlag(QGraphicsItem::ItemIgnoresTransformations);
+      m_Labels.PushBack(pLabel);
+    };
+
+    ezUInt32 uiRow = 0;
+    ezHybridArray<const Scope*, 256> visibleScopes;
+    ezHybridArray<ezTime, 16> openScopeEnds;
+
+    auto DrawThread = [&](const ThreadData& thread, const char* szName) {
+      visibleScopes.Clear();
+      for (const Scope& scope : thread.m_Scopes)
+      {
+        if (scope.m_BeginTime + scope.m_Duration >= minTime)
+          visibleScopes.PushBack(&scope);
+      }
+
+      if (visibleScopes.IsEmpty())
+        return;
+
+      // scopes are recorded when they end, sort them by start time to find out how deeply they are nested
+      visibleScopes.Sort([](const Scope* a, const Scope* b) {
+        if (a->m_BeginTime != b->m_BeginTime)
+          return a->m_BeginTime < b->m_BeginTime;
+        return a->m_Duration > b->m_Duration;
+      });
+
+      AddLabel(szName, -m_DisplayInterval.GetSeconds(), uiRow);
+      ++uiRow;
+
+      const ezUInt32 uiFirstRow = uiRow;
+      ezUInt32 uiMaxDepth = 0;
+      openScopeEnds.Clear();
+
+      for (const Scope* pScope : visibleScopes)
+      {
+        while (!openScopeEnds.IsEmpty() && openScopeEnds.PeekBack() <= pScope->m_BeginTime)
+          openScopeEnds.PopBack();
+
+        const ezUInt32 uiDepth = openScopeEnds.GetCount();
+        openScopeEnds.PushBack(pScope->m_BeginTime + pScope->m_Duration);
+        uiMaxDepth = ezMath::Max(uiMaxDepth, uiDepth);
+
+        const double x = (pScope->m_BeginTime - m_MaxTime).GetSeconds();
+        const double y = uiFirstRow + uiDepth;
+        const double fWidth = pScope->m_Duration.GetSeconds();
+
+        pp[pScope->m_uiName % s_uiMaxColors].addRect(QRectF(x, y + 0.05, fWidth, 0.9));
+
+        if (fWidth >= fLabelMinWidth)
+        {
+          AddLabel(GetString(pScope->m_uiName), ezMath::Max(x, -m_DisplayInterval.GetSeconds()), y);
+        }
+      }
+
+      uiRow += uiMaxDepth + 1;
+    };
+
+    for (const ThreadData& thread : m_Threads)
+    {
+      DrawThread(thread, thread.m_uiName < m_Strings.GetCount() ? m_Strings[thread.m_uiName].GetData() : "Unnamed Thread");
+    }
+
+    DrawThread(m_GPUThread, "GPU");
+
+    uiRow = ezMath::Max<ezUInt32>(uiRow, 1);
+
+    for (ezTime frameStart : m_FrameStartTimes)
+    {
+      if (frameStart < minTime)
+        continue;
+
+      const double x = (frameStart - m_MaxTime).GetSeconds();
+      ppFrames.moveTo(QPointF(x, 0));
+      ppFrames.lineTo(QPointF(x, uiRow));
+    }
+
+    for (ezUInt32 i = 0; i < s_uiMaxColors; ++i)
+      m_pPath[i]->setPath(pp[i]);
+
+    m_pPathFrames->setPath(ppFrames);
+
+    const QRectF rect(-m_DisplayInterval.GetSeconds(), 0, m_DisplayInterval.GetSeconds(), uiRow);
+    ProfilingView->setSceneRect(rect);
+    ProfilingView->fitInView(rect);
+  }
+
+  // once a second update the details and the bandwidth display
+  const ezTime tNow = ezTime::Now();
+  if (tNow - m_LastStatsUpdate > ezTime::Seconds(1))
+  {
+    ezStringBuilder s;
+    s.Format("Received: {0} KB/s", ezArgF(m_uiBytesReceived / 1024.0 / (tNow - m_LastStatsUpdate).GetSeconds(), 1));
+    LabelStats->setText(s.GetData());
+
+    m_LastStatsUpdate = tNow;
+    m_uiBytesReceived = 0;
+
+    if (m_bDetailsChanged)
+    {
+      m_bDetailsChanged = false;
+
+      ezQtScopedUpdatesDisabled _1(TreeDetails);
+
+      TreeDetails->clear();
+
+      const char* szWorkerTypes[] = {"Short Tasks", "Long Tasks", "File Access"};
+
+      QTreeWidgetItem* pWorkers = new QTreeWidgetItem(TreeDetails, QStringList("Worker Threads"));
+      ezUInt32 uiWorkerIndex = 0;
+      for (const WorkerData& worker : m_Workers)
+      {
+        s.Format("{0} {1}", worker.m_uiType < EZ_ARRAY_SIZE(szWorkerTypes) ? szWorkerTypes[worker.m_uiType] : "Worker", uiWorkerIndex++);
+
+        ezStringBuilder sValue;
+        sValue.Format("{0}% ({1} Tasks)", ezArgF(worker.m_fUtilization * 100.0f, 1), worker.m_uiNumTasks);
+
+        QStringList columns;
+        columns << s.GetData() << sValue.GetData();
+        new QTreeWidgetItem(pWorkers, columns);
+      }
+
+      QTreeWidgetItem* pAllocators = new QTreeWidgetItem(TreeDetails, QStringList("Allocators"));
+      for (auto it = m_Allocators.GetIterator(); it.IsValid(); ++it)
+      {
+        const AllocatorData& allocator = it.Value();
+
+        ezStringBuilder sValue;
+        sValue.Format("{0} ({1} Allocations)", ezArgFileSize(allocator.m_uiAllocationSize), allocator.m_uiLiveAllocations);
+
+        QStringList columns;
+        columns << GetString(allocator.m_uiName) << sValue.GetData();
+        new QTreeWidgetItem(pAllocators, columns);
+      }
+
+      TreeDetails->expandAll();
+      TreeDetails->resizeColumnToContents(0);
+    }
+  }
+}
+
+void ezQtProfilingWidget::RemoveOldData()
+{
+  // keep a bit more than the largest timeframe, so that switching the timeframe immediately shows data
+  const ezTime minTime = m_MaxTime - ezTime::Seconds(6);
+
+  auto RemoveOldScopes = [minTime](ezDeque<Scope>& scopes) {
+    ezUInt32 uiNumOld = 0;
+    while (uiNumOld < scopes.GetCount() && scopes[uiNumOld].m_BeginTime + scopes[uiNumOld].m_Duration < minTime)
+      ++uiNumOld;
+
+    if (uiNumOld > 0)
+      scopes.PopFront(uiNumOld);
+  };
+
+  for (ThreadData& thread : m_Threads)
+  {
+    RemoveOldScopes(thread.m_Scopes);
+  }
+
+  RemoveOldScopes(m_GPUThread.m_Scopes);
+
+  while (!m_FrameStartTimes.IsEmpty() && m_FrameStartTimes.PeekFront() < minTime)
+    m_FrameStartTimes.PopFront();
+}
+
+void ezQtProfilingWidget::DecodePacket(ezArrayPtr<const ezUInt8> data)
+{
+  Decoder d(data);
+
+  const ezTime baseTime = ezTime::Microseconds((double)d.UInt());
+
+  // strings
+  {
+    const ezUInt32 uiNumStrings = (ezUInt32)d.UInt();
+    for (ezUInt32 i = 0; i < uiNumStrings && d.IsValid(); ++i)
+    {
+      d.String(m_Strings.ExpandAndGetRef());
+    }
+  }
+
+  // threads
+  {
+    const ezUInt32 uiNumThreads = (ezUInt32)d.UInt();
+    for (ezUInt32 i = 0; i < uiNumThreads && d.IsValid(); ++i)
+    {
+      m_Threads.ExpandAndGetRef().m_uiName = (ezUInt32)d.UInt();
+    }
+  }
+
+  // frames
+  {
+    ezTime time = baseTime;
+
+    const ezUInt32 uiNumFrames = (ezUInt32)d.UInt();
+    for (ezUInt32 i = 0; i < uiNumFrames && d.IsValid(); ++i)
+    {
+      time += ezTime::Microseconds((double)d.Int());
+      m_FrameStartTimes.PushBack(time);
+    }
+  }
+
+  auto DecodeScopes = [&](ThreadData& thread) {
+    ezTime time = baseTime;
+
+    const ezUInt32 uiNumScopes = (ezUInt32)d.UInt();
+    for (ezUInt32 i = 0; i < uiNumScopes && d.IsValid(); ++i)
+    {
+      Scope& scope = thread.m_Scopes.ExpandAndGetRef();
+      scope.m_uiName = (ezUInt32)d.UInt();
+      time += ezTime::Microseconds((double)d.Int());
+      scope.m_BeginTime = time;
+      scope.m_Duration = ezTime::Microseconds((double)d.UInt());
+
+      m_MaxTime = ezMath::Max(m_MaxTime, scope.m_BeginTime + scope.m_Duration);
+    }
+  };
+
+  // CPU scopes
+  {
+    const ezUInt32 uiNumBuffers = (ezUInt32)d.UInt();
+    for (ezUInt32 i = 0; i < uiNumBuffers && d.IsValid(); ++i)
+    {
+      const ezUInt32 uiThreadIndex = (ezUInt32)d.UInt();
+
+      if (uiThreadIndex >= m_Threads.GetCount())
+        m_Threads.SetCount(uiThreadIndex + 1);
+
+      DecodeScopes(m_Threads[uiThreadIndex]);
+    }
+  }
+
+  // GPU scopes
+  DecodeScopes(m_GPUThread);
+
+  // task system utilization
+  {
+    m_Workers.Clear();
+
+    const ezUInt32 uiNumWorkers = (ezUInt32)d.UInt();
+    for (ezUInt32 i = 0; i < uiNumWorkers && d.IsValid(); ++i)
+    {
+      WorkerData& worker = m_Workers.ExpandAndGetRef();
+      worker.m_uiType = d.Byte();
+      worker.m_fUtilization = d.Byte() / 255.0f;
+      worker.m_uiNumTasks = (ezUInt32)d.UInt();
+    }
+  }
+
+  // allocators
+  {
+    const ezUInt32 uiNumAllocators = (ezUInt32)d.UInt();
+    for (ezUInt32 i = 0; i < uiNumAllocators && d.IsValid(); ++i)
+    {
+      AllocatorData& allocator = m_Allocators[(ezUInt32)d.UInt()];
+      allocator.m_uiName = (ezUInt32)d.UInt();
+      allocator.m_uiParentId = (ezUInt32)d.UInt();
+      allocator.m_uiLiveAllocations = d.UInt();
+      allocator.m_uiAllocationSize = d.UInt();
+    }
+  }
+
+  m_MaxTime = ezMath::Max(m_MaxTime, baseTime);
+  m_bDetailsChanged = true;
+
+  if (!d.IsValid())
+  {
+    ezLog::Error("Received a corrupted profiling packet.");
+  }
+}
+
+void ezQtProfilingWidget::ProcessTelemetry(void* pUnuseed)
+{
+  if (s_pWidget == nullptr)
+    return;
+
+  ezTelemetryMessage Msg;
+  ezDynamicArray<ezUInt8> payload;
+  ezDynamicArray<ezUInt8> uncompressed;
+
+  while (ezTelemetry::RetrieveMessage('PROF', Msg) == EZ_SUCCESS)
+  {
+    if (Msg.GetMessageID() != 'DATA')
+      continue;
+
+    ezUInt32 uiSessionID = 0;
+    ezUInt8 uiCompression = 0;
+    ezUInt32 uiUncompressedSize = 0;
+    ezUInt32 uiPayloadSize = 0;
+
+    // still in flight from a previous stream, its string and thread indices don't match the current tables
+    Msg.GetReader() >> uiSessionID;
+    if (uiSessionID != s_pWidget->m_uiSessionID)
+      continue;
+
+    Msg.GetReader() >> uiCompression;
+    Msg.GetReader() >> uiUncompressedSize;
+    Msg.GetReader() >> uiPayloadSize;
+
+    payload.SetCountUninitialized(uiPayloadSize);
+    Msg.GetReader().ReadBytes(payload.GetData(), uiPayloadSize);
+
+    s_pWidget->m_uiBytesReceived += uiPayloadSize;
+
+    // data that arrives after pausing is dropped, the display should not change anymore
+    if (s_pWidget->CheckPause->isChecked())
+      continue;
+
+    if (uiCompression == 0)
+    {
+      s_pWidget->DecodePacket(payload);
+    }
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    else if (uiCompression == 1)
+    {
+      uncompressed.SetCountUninitialized(uiUncompressedSize);
+
+      ezRawMemoryStreamReader reader(payload);
+      ezCompressedStreamReaderZstd decompressor(&reader);
+      if (decompressor.ReadBytes(uncompressed.GetData(), uiUncompressedSize) == uiUncompressedSize)
+      {
+        s_pWidget->DecodePacket(uncompressed);
+      }
+    }
+#endif
+  }
+}
+
+void ezQtProfilingWidget::on_ComboTimeframe_currentIndexChanged(int index)
+{
+  const ezUInt32 uiMilliseconds[] =
+    {
+      50,
+      100,
+      500,
+      1000,
+      5000,
+    };
+
+  m_DisplayInterval = ezTime::Milliseconds(uiMilliseconds[index]);
+}
+
+void ezQtProfilingWidget::on_CheckPause_toggled(bool checked)
+{
+  if (!checked)
+  {
+    // the application skips everything that happened while paused, so old and new data would not fit together anyway
+    const bool bEnabled = m_bEnabled;
+    ResetStats();
+    m_bEnabled = bEnabled;
+  }
+
+  SendEnableState();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <Foundation/Basics.h>
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Containers/Map.h>
+#include <Foundation/Strings/String.h>
+#include <Foundation/Time/Time.h>
+#include <Inspector/ui_ProfilingWidget.h>
+#include <QGraphicsView>
+#include <ads/DockWidget.h>
+
+class QGraphicsSimpleTextItem;
+class QTreeWidgetItem;
+
+/// \brief Shows the live profiling data that the InspectorPlugin streams while this widget is visible.
+///
+/// Displays the most recent CPU and GPU scopes of all threads on a timeline, together with the task system utilization and the
+/// allocators' memory usage. The data is only requested from the application while the widget is open and not paused.
+class ezQtProfilingWidget : public ads::CDockWidget, public Ui_ProfilingWidget
+{
+public:
+  Q_OBJECT
+
+public:
+  static const ezUInt8 s_uiMaxColors = 9;
+
+  ezQtProfilingWidget(QWidget* parent = 0);
+
+  static ezQtProfilingWidget* s_pWidget;
+
+private Q_SLOTS:
+
+  void on_ComboTimeframe_currentIndexChanged(int index);
+  void on_CheckPause_toggled(bool checked);
+
+public:
+  static void ProcessTelemetry(void* pUnuseed);
+
+  void ResetStats();
+  void UpdateStats();
+
+private:
+  struct Scope
+  {
+    ezUInt32 m_uiName;
+    ezTime m_BeginTime;
+    ezTime m_Duration;
+  };
+
+  struct ThreadData
+  {
+    ezUInt32 m_uiName = 0xFFFFFFFF;
+    ezDeque<Scope> m_Scopes;
+  };
+
+  struct WorkerData
+  {
+    ezUInt8 m_uiType;
+    float m_fUtilization;
+    ezUInt32 m_uiNumTasks;
+  };
+
+  struct AllocatorData
+  {
+    ezUInt32 m_uiName;
+    ezUInt32 m_uiParentId;
+    ezUInt64 m_uiLiveAllocations;
+    ezUInt64 m_uiAllocationSize;
+  };
+
+  void SendEnableState();
+  void DecodePacket(ezArrayPtr<const ezUInt8> data);
+  void RemoveOldData();
+  const char* GetString(ezUInt32 uiIndex) const;
+
+  QGraphicsPathItem* m_pPath[s_uiMaxColors];
+  QGraphicsPathItem* m_pPathFrames;
+  QGraphicsScene m_Scene;
+  ezDynamicArray<QGraphicsSimpleTextItem*> m_Labels;
+
+  bool m_bEnabled = false;
+  ezUInt32 m_uiSessionID = 0;
+  bool m_bDetailsChanged = false;
+
+  ezTime m_DisplayInterval = ezTime::Milliseconds(100);
+  ezTime m_MaxTime;
+
+  ezDynamicArray<ezString> m_Strings;
+  ezDynamicArray<ThreadData> m_Threads;
+  ThreadData m_GPUThread;
+  ezDeque<ezTime> m_FrameStartTimes;
+  ezDynamicArray<WorkerData> m_Workers;
+  ezMap<ezUInt32, AllocatorData> m_Allocators;
+
+  ezUInt64 m_uiBytesReceived = 0;
+  ezTime m_LastStatsUpdate;
+};
@@ -81,21 +81,13 @@ ezResult ezShaderCompilerApplication::CompileShader(const char* szShaderFile)
   if (ExtractPermutationVarValues(szShaderFile).Failed())
     return EZ_FAILURE;
 
-  ezHybridArray<ezPermutationVar, 16> PermVars;
-
   const ezUInt32 uiMaxPerms = m_PermutationGenerator.GetPermutationCount();
 
   ezLog::Info("Shader has {0} permutations", uiMaxPerms);
 
-  for (ezUInt32 perm = 0; perm < uiMaxPerms; ++perm)
-  {
-    EZ_LOG_BLOCK("Compiling Permutation");
-
-    m_PermutationGenerator.GetPermutation(perm, PermVars);
-    ezShaderCompiler sc;
-    if (sc.CompileShaderPermutationForPlatforms(szShaderFile, PermVars, ezLog::GetThreadLocalLogSystem(), m_sPlatforms).Failed())
-      return EZ_FAILURE;
-  }
+  ezShaderCompiler sc;
+  if (sc.CompileShaderPermutationsForPlatforms(szShaderFile, m_PermutationGenerator, ezLog::GetThreadLocalLogSystem(), m_sPlatforms).Failed())
+    return EZ_FAILURE;
 
   ezLog::Success("Compiled Shader '{0}'", szShaderFile);
   return EZ_SUCCESS;
@@ -85,6 +85,12 @@ ezResult ezTexConv::ParseCommandLine()
     ezLog::Info("    Input values will be clamped to [-value;+value] (default 64000).");
     PrintOptionValuesHelp("  -bumpMapFilter", m_AllowedBumpMapFilters);
     ezLog::Info("    Filter used to approximate the x/y bump map gradients.");
+    ezLog::Info("");
+    ezLog::Info("  -cacheDir \"Folder\"");
+    ezLog::Info("    Folder in which to cache decoded inputs and intermediate and final results across runs.");
+    ezLog::Info("    Re-exporting a texture with unchanged inputs then skips all stages that are not affected by changed options.");
+    ezLog::Info("  -cacheSize Number");
+    ezLog::Info("    Maximum size of the cache in megabytes (default 1024). The least recently used results are deleted first.");
 
     return EZ_FAILURE;
   }
@@ -105,6 +111,7 @@ ezResult ezTexConv::ParseCommandLine()
   EZ_SUCCEED_OR_RETURN(ParseInputFiles());
   EZ_SUCCEED_OR_RETURN(ParseChannelMappings());
   EZ_SUCCEED_OR_RETURN(ParseBumpMapFilter());
+  EZ_SUCCEED_OR_RETURN(ParseCache());
 
   return EZ_SUCCESS;
 }
@@ -419,6 +426,16 @@ ezResult ezTexConv::ParseMiscOptions()
   return EZ_SUCCESS;
 }
 
+ezResult ezTexConv::ParseCache()
+{
+  if (!ParseFile("-cacheDir", m_sCacheFolder))
+    return EZ_SUCCESS;
+
+  EZ_SUCCEED_OR_RETURN(ParseUIntOption("-cacheSize", 1, 1024 * 1024, m_uiCacheSizeMB));
+
+  return EZ_SUCCESS;
+}
+
 ezResult ezTexConv::ParseAssetHeader()
 {
   const ezStringView ext = ezPathUtils::GetFileExtension(m_sOutputFile);
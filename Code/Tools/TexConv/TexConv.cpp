@@ -244,7 +244,24 @@ ezApplication::ApplicationExecution ezTexConv::Run()
   if (ParseCommandLine().Failed())
     return ezApplication::ApplicationExecution::Quit;
 
-  if (m_Processor.Process().Failed())
+  if (!m_sCacheFolder.IsEmpty())
+  {
+    if (m_Cache.Open(m_sCacheFolder, static_cast<ezUInt64>(m_uiCacheSizeMB) * 1024 * 1024).Succeeded())
+    {
+      m_Processor.m_pCache = &m_Cache;
+    }
+  }
+
+  const ezResult processResult = m_Processor.Process();
+
+  if (m_Cache.IsOpen())
+  {
+    m_Cache.GetSessionStats().PrintReport("This Run");
+    m_Cache.GetTotalStats().PrintReport("All Runs");
+    m_Cache.Close();
+  }
+
+  if (processResult.Failed())
     return ezApplication::ApplicationExecution::Quit;
 
   if (m_Processor.m_Descriptor.m_OutputType == ezTexConvOutputType::Atlas)
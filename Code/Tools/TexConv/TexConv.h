@@ -47,6 +47,7 @@ public:
   ezResult ParseMiscOptions();
   ezResult ParseAssetHeader();
   ezResult ParseBumpMapFilter();
+  ezResult ParseCache();
 
   ezResult ParseUIntOption(const char* szOption, ezInt32 iMinValue, ezInt32 iMaxValue, ezUInt32& uiResult) const;
   ezResult ParseFloatOption(const char* szOption, float fMinValue, float fMaxValue, float& fResult) const;
@@ -75,6 +76,10 @@ private:
 
   ezTexConvProcessor m_Processor;
 
+  ezString m_sCacheFolder;
+  ezUInt32 m_uiCacheSizeMB = 1024;
+  ezTexConvCache m_Cache;
+
   ezDynamicArray<KeyEnumValuePair> m_AllowedOutputTypes;
   ezDynamicArray<KeyEnumValuePair> m_AllowedUsages;
   ezDynamicArray<KeyEnumValuePair> m_AllowedMimapModes;
@@ -8,4 +8,5 @@
 #include <Foundation/Logging/ConsoleWriter.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Logging/VisualStudioWriter.h>
+#include <Texture/TexConv/TexConvCache.h>
 #include <Texture/TexConv/TexConvProcessor.h>
@@ -0,0 +1,429 @@
+#include <CoreTestPCH.h>
+
+#include <Core/Graphics/Camera.h>
+#include <Core/Messages/UpdateLocalBoundsMessage.h>
+#include <Core/World/World.h>
+#include <Foundation/Containers/HashSet.h>
+#include <Foundation/Math/Frustum.h>
+#include <Foundation/Math/Random.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <RendererCore/Components/OccluderComponent.h>
+#include <RendererCore/Pipeline/RenderPipeline.h>
+#include <RendererCore/Rasterizer/RasterizerObject.h>
+#include <RendererCore/Rasterizer/RasterizerView.h>
+
+namespace
+{
+  typedef ezComponentManager<class CityObjectComponent, ezBlockStorageType::Compact> CityObjectComponentManager;
+
+  /// The rendered geometry of a building or a prop of the synthetic city. Buildings additionally get an ezOccluderComponent.
+  class CityObjectComponent : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(CityObjectComponent, ezComponent, CityObjectComponentManager);
+
+  public:
+    virtual void Initialize() override { GetOwner()->UpdateLocalBounds(); }
+
+    void OnUpdateLocalBounds(ezMsgUpdateLocalBounds& msg)
+    {
+      ezBoundingBox bounds;
+      bounds.SetCenterAndHalfExtents(ezVec3::ZeroVector(), m_vHalfExtents);
+
+      msg.AddBounds(bounds, ezDefaultSpatialDataCategories::RenderStatic);
+    }
+
+    ezVec3 m_vHalfExtents;
+    ezInt32 m_iBuilding = -1; ///< Index into City::m_Buildings, -1 for props.
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(CityObjectComponent, 1, ezComponentMode::Static)
+  {
+    EZ_BEGIN_MESSAGEHANDLERS
+    {
+      EZ_MESSAGE_HANDLER(ezMsgUpdateLocalBounds, OnUpdateLocalBounds)
+    }
+    EZ_END_MESSAGEHANDLERS;
+  }
+  EZ_END_COMPONENT_TYPE;
+  // clang-format on
+
+  ezMat4 GetViewProjection(const ezCamera& camera, const ezRasterizerView& view)
+  {
+    ezMat4 projectionMatrix;
+    camera.GetProjectionMatrix((float)view.GetResolutionX() / view.GetResolutionY(), projectionMatrix);
+
+    return projectionMatrix * camera.GetViewMatrix();
+  }
+
+  ezSimdBBox ToSimd(const ezVec3& vCenter, const ezVec3& vHalfExtents)
+  {
+    ezSimdBBox box;
+    box.SetCenterAndHalfExtents(ezSimdConversion::ToVec3(vCenter), ezSimdConversion::ToVec3(vHalfExtents));
+    return box;
+  }
+
+  /// Whether the segment from the start to the end point passes through the box, not counting the last bit before the end point.
+  bool SegmentHitsBox(const ezVec3& vStart, const ezVec3& vEnd, const ezBoundingBox& box)
+  {
+    const ezVec3 vDir = vEnd - vStart;
+    float tMin = 0.0f;
+    float tMax = 0.999f;
+
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      if (ezMath::Abs(vDir.GetData()[i]) < 1e-6f)
+      {
+        if (vStart.GetData()[i] < box.m_vMin.GetData()[i] || vStart.GetData()[i] > box.m_vMax.GetData()[i])
+          return false;
+
+        continue;
+      }
+
+      float t0 = (box.m_vMin.GetData()[i] - vStart.GetData()[i]) / vDir.GetData()[i];
+      float t1 = (box.m_vMax.GetData()[i] - vStart.GetData()[i]) / vDir.GetData()[i];
+      if (t0 > t1)
+        ezMath::Swap(t0, t1);
+
+      tMin = ezMath::Max(tMin, t0);
+      tMax = ezMath::Min(tMax, t1);
+
+      if (tMin > tMax)
+        return false;
+    }
+
+    return true;
+  }
+
+  struct City
+  {
+    ezDynamicArray<ezBoundingBox> m_Buildings;
+    ezDynamicArray<ezBoundingBox> m_Props;
+
+    static constexpr ezUInt32 NumBlocks = 16;
+    static constexpr float BlockSize = 30.0f;
+    static constexpr float StreetWidth = 10.0f;
+    static constexpr float Origin = -0.5f * NumBlocks * (BlockSize + StreetWidth);
+
+    /// The center of the street that runs after the given block.
+    static float GetStreetCenter(ezUInt32 uiBlock) { return Origin + uiBlock * (BlockSize + StreetWidth) + BlockSize + 0.5f * StreetWidth; }
+
+    void Create(ezUInt32 uiNumProps)
+    {
+      ezRandom rng;
+      rng.Initialize(42);
+
+      for (ezUInt32 y = 0; y < NumBlocks; ++y)
+      {
+        for (ezUInt32 x = 0; x < NumBlocks; ++x)
+        {
+          const ezVec3 vMin(Origin + x * (BlockSize + StreetWidth), Origin + y * (BlockSize + StreetWidth), 0.0f);
+          m_Buildings.ExpandAndGetRef().SetElements(vMin, vMin + ezVec3(BlockSize, BlockSize, rng.FloatMinMax(8.0f, 60.0f)));
+        }
+      }
+
+      for (ezUInt32 i = 0; i < uiNumProps; ++i)
+      {
+        const ezVec3 vHalfSize(rng.FloatMinMax(0.25f, 1.5f), rng.FloatMinMax(0.25f, 1.5f), rng.FloatMinMax(0.25f, 1.5f));
+
+        if (i % 5 < 3)
+        {
+          // on the streets, along x or along y
+          const float fAlong = rng.FloatMinMax(Origin, -Origin);
+          const float fAcross = GetStreetCenter(rng.UIntInRange(NumBlocks - 1)) + rng.FloatMinMax(-3.0f, 3.0f);
+          const ezVec3 vCenter = (i % 2) ? ezVec3(fAlong, fAcross, vHalfSize.z) : ezVec3(fAcross, fAlong, vHalfSize.z);
+          m_Props.ExpandAndGetRef().SetCenterAndHalfExtents(vCenter, vHalfSize);
+        }
+        else
+        {
+          // on the roofs
+          const ezBoundingBox& building = m_Buildings[rng.UIntInRange(m_Buildings.GetCount())];
+          const ezVec3 vCenter(rng.FloatMinMax(building.m_vMin.x + 2.0f, building.m_vMax.x - 2.0f),
+            rng.FloatMinMax(building.m_vMin.y + 2.0f, building.m_vMax.y - 2.0f), building.m_vMax.z + vHalfSize.z);
+          m_Props.ExpandAndGetRef().SetCenterAndHalfExtents(vCenter, vHalfSize);
+        }
+      }
+    }
+
+    void AddToWorld(ezWorld& world) const
+    {
+      auto AddObject = [&](const ezBoundingBox& box, ezInt32 iBuilding) {
+        ezGameObjectDesc desc;
+        desc.m_LocalPosition = box.GetCenter();
+
+        ezGameObject* pObject = nullptr;
+        world.CreateObject(desc, pObject);
+
+        CityObjectComponent* pComponent = nullptr;
+        CityObjectComponent::CreateComponent(pObject, pComponent);
+        pComponent->m_vHalfExtents = box.GetHalfExtents();
+        pComponent->m_iBuilding = iBuilding;
+
+        if (iBuilding >= 0)
+        {
+          ezOccluderComponent* pOccluder = nullptr;
+          ezOccluderComponent::CreateComponent(pObject, pOccluder);
+
+          // slightly smaller than the building, occluders must never stick out of the geometry that they stand for
+          pOccluder->SetExtents(box.GetExtents() - ezVec3(0.2f));
+        }
+      };
+
+      for (ezUInt32 i = 0; i < m_Buildings.GetCount(); ++i)
+      {
+        AddObject(m_Buildings[i], i);
+      }
+
+      for (const auto& prop : m_Props)
+      {
+        AddObject(prop, -1);
+      }
+    }
+  };
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Culling);
+
+EZ_CREATE_SIMPLE_TEST(Culling, OcclusionCulling)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Rasterize")
+  {
+    ezRasterizerView rasterizer;
+    EZ_TEST_INT(rasterizer.GetResolutionX(), 256);
+    EZ_TEST_INT(rasterizer.GetResolutionY(), 128);
+
+    rasterizer.SetResolution(250, 121);
+    EZ_TEST_INT(rasterizer.GetResolutionX(), 256);
+    EZ_TEST_INT(rasterizer.GetResolutionY(), 128);
+
+    ezSharedPtr<ezRasterizerObject> pWall = ezRasterizerObject::CreateBox(ezVec3(2.0f, 20.0f, 10.0f));
+    EZ_TEST_INT(pWall->GetTriangleCount(), 12);
+
+    // a floor below the camera, which reaches behind it and has to be clipped at the near plane
+    ezSharedPtr<ezRasterizerObject> pFloor = ezRasterizerObject::CreateBox(ezVec3(200.0f, 200.0f, 1.0f));
+
+    const ezVec3 vSmall(0.5f);
+
+    for (ezUInt32 uiProjection = 0; uiProjection < 2; ++uiProjection)
+    {
+      ezCamera camera;
+      if (uiProjection == 0)
+        camera.SetCameraMode(ezCameraMode::PerspectiveFixedFovX, 90.0f, 0.1f, 500.0f);
+      else
+        camera.SetCameraMode(ezCameraMode::OrthoFixedWidth, 100.0f, 0.1f, 500.0f);
+
+      camera.LookAt(ezVec3(0, 0, 0), ezVec3(1, 0, 0), ezVec3(0, 0, 1));
+
+      rasterizer.BeginScene(GetViewProjection(camera, rasterizer));
+
+      // nothing is occluded without occluders
+      EZ_TEST_BOOL(rasterizer.IsVisible(ToSimd(ezVec3(40, 0, 0), vSmall)));
+
+      rasterizer.AddObject(pWall.Borrow(), ezTransform(ezVec3(20, 0, 0)));
+      rasterizer.AddObject(pFloor.Borrow(), ezTransform(ezVec3(0, 0, -3.0f)));
+      rasterizer.EndScene();
+
+      EZ_TEST_INT(rasterizer.GetNumOccluders(), 2);
+
+      if (uiProjection == 0)
+      {
+        // in the orthographic view the faces that are seen edge-on are dropped
+        EZ_TEST_BOOL(rasterizer.GetNumTriangles() > 12);
+      }
+
+      // the wall covers the center, the corners see the sky
+      EZ_TEST_BOOL(rasterizer.GetDepth(128, 64) < 1.0f);
+      EZ_TEST_FLOAT(rasterizer.GetDepth(0, 0), ezMath::MaxValue<float>(), 0.0f);
+
+      EZ_TEST_BOOL(!rasterizer.IsVisible(ToSimd(ezVec3(40, 0, 0), vSmall)));   // behind the wall
+      EZ_TEST_BOOL(!rasterizer.IsVisible(ToSimd(ezVec3(40, 0, 3), vSmall)));   // behind the wall, close to its top
+      EZ_TEST_BOOL(rasterizer.IsVisible(ToSimd(ezVec3(10, 0, 0), vSmall)));    // in front of the wall
+      EZ_TEST_BOOL(rasterizer.IsVisible(ToSimd(ezVec3(40, 0, 14), vSmall)));   // peeks out over the wall
+      EZ_TEST_BOOL(rasterizer.IsVisible(ToSimd(ezVec3(40, 30, 0), vSmall)));   // next to the wall
+      EZ_TEST_BOOL(rasterizer.IsVisible(ToSimd(ezVec3(30, 0, 0), ezVec3(1, 30, 1)))); // partially hidden
+      EZ_TEST_BOOL(rasterizer.IsVisible(ToSimd(ezVec3(0, 0, 0), vSmall)));     // around the camera
+      EZ_TEST_BOOL(!rasterizer.IsVisible(ToSimd(ezVec3(-40, 0, 0), vSmall)));  // behind the camera
+
+      // the occluder is not hidden by itself
+      EZ_TEST_BOOL(rasterizer.IsVisible(ToSimd(ezVec3(20, 0, 0), ezVec3(1, 10, 5))));
+
+      if (uiProjection == 0)
+      {
+        // the floor only hides what is below it in the perspective view
+        EZ_TEST_BOOL(!rasterizer.IsVisible(ToSimd(ezVec3(40, 30, -10), vSmall)));
+      }
+    }
+  }
+
+  City city;
+  city.Create(30000);
+
+  ezWorldDesc worldDesc("City");
+  ezWorld world(worldDesc);
+  EZ_LOCK(world.GetWriteMarker());
+
+  city.AddToWorld(world);
+  world.Update();
+
+  const ezUInt32 uiRenderBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+
+  struct View
+  {
+    const char* m_szName;
+    ezVec3 m_vPosition;
+    ezVec3 m_vTarget;
+  };
+
+  const float fStreet = City::GetStreetCenter(7);
+  const View views[] = {
+    {"street level", ezVec3(fStreet, fStreet - 2.0f, 1.8f), ezVec3(fStreet + 100.0f, fStreet + 12.0f, 3.0f)},
+    {"street crossing", ezVec3(fStreet, fStreet, 1.8f), ezVec3(fStreet + 100.0f, fStreet + 100.0f, 1.8f)},
+    {"above the roofs", ezVec3(City::Origin, City::Origin, 100.0f), ezVec3(0, 0, 0)},
+  };
+
+  ezRasterizerView rasterizer;
+  ezDynamicArray<const ezGameObject*> occluders;
+  ezDynamicArray<const ezGameObject*> visibleObjects;
+  ezDynamicArray<const ezGameObject*> unoccludedObjects;
+
+  auto isOccluded = [&](const ezSimdBBox& box) { return !rasterizer.IsVisible(box); };
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Conservative")
+  {
+    for (const View& view : views)
+    {
+      ezCamera camera;
+      camera.SetCameraMode(ezCameraMode::PerspectiveFixedFovX, 90.0f, 0.1f, 1000.0f);
+      camera.LookAt(view.m_vPosition, view.m_vTarget, ezVec3(0, 0, 1));
+
+      const ezMat4 viewProjection = GetViewProjection(camera, rasterizer);
+      ezFrustum frustum;
+      frustum.SetFrustum(viewProjection);
+
+      ezRenderPipeline::RasterizeOccluders(world, nullptr, frustum, viewProjection, rasterizer, occluders);
+      EZ_TEST_INT(rasterizer.GetNumOccluders(), occluders.GetCount());
+
+      visibleObjects.Clear();
+      world.GetSpatialSystem()->FindVisibleObjects(frustum, uiRenderBitmask, visibleObjects);
+
+      unoccludedObjects.Clear();
+      world.GetSpatialSystem()->FindVisibleObjects(frustum, uiRenderBitmask, unoccludedObjects, nullptr, isOccluded);
+
+      EZ_TEST_BOOL(unoccludedObjects.GetCount() < visibleObjects.GetCount());
+
+      ezHashSet<const ezGameObject*> unoccluded;
+      for (auto pObject : unoccludedObjects)
+      {
+        unoccluded.Insert(pObject);
+      }
+
+      // Every point on a culled object that is inside the frustum must be hidden behind a building. The depth buffer can't represent
+      // anything smaller than a pixel, so rays are tested against the buildings grown by the size of a pixel at the distance of the point.
+      const float fPixelSize = 2.0f / rasterizer.GetResolutionX();
+      ezUInt32 uiNumCulled = 0;
+
+      for (auto pObject : visibleObjects)
+      {
+        if (unoccluded.Contains(pObject))
+          continue;
+
+        ++uiNumCulled;
+        const ezBoundingBox objectBox = pObject->GetGlobalBounds().GetBox();
+
+        const CityObjectComponent* pComponent = nullptr;
+        pObject->TryGetComponentOfBaseType(pComponent);
+        const ezInt32 iBuilding = pComponent != nullptr ? pComponent->m_iBuilding : -1;
+
+        bool bVisiblePointFound = false;
+        for (ezUInt32 s = 0; s < 27 && !bVisiblePointFound; ++s)
+        {
+          const ezVec3 vPoint = objectBox.m_vMin + objectBox.GetExtents().CompMul(ezVec3((s % 3) * 0.5f, ((s / 3) % 3) * 0.5f, (s / 9) * 0.5f));
+
+          if (frustum.GetObjectPosition(&vPoint, 1) != ezVolumePosition::Inside)
+            continue;
+
+          const float fMargin = (vPoint - view.m_vPosition).GetLength() * fPixelSize;
+
+          bool bHidden = false;
+          for (ezUInt32 i = 0; i < city.m_Buildings.GetCount(); ++i)
+          {
+            // the sample points of a building are on or inside of its own box
+            if ((ezInt32)i == iBuilding)
+              continue;
+
+            ezBoundingBox grown = city.m_Buildings[i];
+            grown.Grow(ezVec3(fMargin));
+
+            if (SegmentHitsBox(view.m_vPosition, vPoint, grown))
+            {
+              bHidden = true;
+              break;
+            }
+          }
+
+          bVisiblePointFound = !bHidden;
+        }
+
+        EZ_TEST_BOOL(!bVisiblePointFound);
+      }
+
+      EZ_TEST_INT(uiNumCulled + unoccludedObjects.GetCount(), visibleObjects.GetCount());
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Performance")
+  {
+    ezTestFramework::Output(ezTestOutput::Duration, "City with %u buildings and %u props, depth buffer %ux%u", city.m_Buildings.GetCount(),
+      city.m_Props.GetCount(), rasterizer.GetResolutionX(), rasterizer.GetResolutionY());
+
+    for (const View& view : views)
+    {
+      ezCamera camera;
+      camera.SetCameraMode(ezCameraMode::PerspectiveFixedFovX, 90.0f, 0.1f, 1000.0f);
+      camera.LookAt(view.m_vPosition, view.m_vTarget, ezVec3(0, 0, 1));
+
+      const ezMat4 viewProjection = GetViewProjection(camera, rasterizer);
+      ezFrustum frustum;
+      frustum.SetFrustum(viewProjection);
+
+      const ezUInt32 uiIterations = 50;
+      ezSpatialSystem::QueryStats frustumStats;
+      ezSpatialSystem::QueryStats occlusionStats;
+
+      ezStopwatch sw;
+      for (ezUInt32 i = 0; i < uiIterations; ++i)
+      {
+        visibleObjects.Clear();
+        world.GetSpatialSystem()->FindVisibleObjects(frustum, uiRenderBitmask, visibleObjects, &frustumStats);
+      }
+      const ezTime tFrustum = sw.Checkpoint() / uiIterations;
+
+      for (ezUInt32 i = 0; i < uiIterations; ++i)
+      {
+        ezRenderPipeline::RasterizeOccluders(world, nullptr, frustum, viewProjection, rasterizer, occluders);
+      }
+      const ezTime tRasterize = sw.Checkpoint() / uiIterations;
+
+      for (ezUInt32 i = 0; i < uiIterations; ++i)
+      {
+        unoccludedObjects.Clear();
+        world.GetSpatialSystem()->FindVisibleObjects(frustum, uiRenderBitmask, unoccludedObjects, &occlusionStats, isOccluded);
+      }
+      const ezTime tOcclusion = sw.Checkpoint() / uiIterations;
+
+      EZ_TEST_BOOL(unoccludedObjects.GetCount() <= visibleObjects.GetCount());
+
+      ezTestFramework::Output(ezTestOutput::Duration,
+        "%s: %u objects in the frustum (%.3f ms), %u after occlusion culling (%u occluders, %u triangles rasterized in %.3f ms, query %.3f ms), %.1f%% culled",
+        view.m_szName, visibleObjects.GetCount(), tFrustum.GetMilliseconds(), unoccludedObjects.GetCount(), rasterizer.GetNumOccluders(),
+        rasterizer.GetNumTriangles(), tRasterize.GetMilliseconds(), tOcclusion.GetMilliseconds(),
+        100.0 * (visibleObjects.GetCount() - unoccludedObjects.GetCount()) / ezMath::Max(visibleObjects.GetCount(), 1u));
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: %u objects tested, %u passed, %u occluded", view.m_szName,
+        occlusionStats.m_uiNumObjectsTested, occlusionStats.m_uiNumObjectsPassed, occlusionStats.m_uiNumObjectsOccluded);
+#endif
+    }
+  }
+}
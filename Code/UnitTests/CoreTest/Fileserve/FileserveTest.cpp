@@ -0,0 +1,275 @@
+#include <CoreTestPCH.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ENET_SUPPORT
+
+#  include <FileservePlugin/Client/FileserveClient.h>
+#  include <FileservePlugin/Fileserver/Fileserver.h>
+#  include <Foundation/Application/Application.h>
+#  include <Foundation/IO/FileSystem/FileReader.h>
+#  include <Foundation/IO/FileSystem/FileSystem.h>
+#  include <Foundation/IO/OSFile.h>
+#  include <Foundation/Threading/AtomicInteger.h>
+#  include <Foundation/Threading/Thread.h>
+#  include <Foundation/Time/Stopwatch.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Fileserve);
+
+namespace
+{
+  static constexpr ezUInt16 s_uiServerPort = 1043;
+  static constexpr ezUInt32 s_uiNumFiles = 200;
+  static const char* s_szDataDir = ">eztest/FileserveTest/";
+
+  /// \brief Runs a fileserver on its own thread, because the client blocks while it waits for answers.
+  class LoopbackServer : public ezThread
+  {
+  public:
+    LoopbackServer()
+      : ezThread("Loopback Fileserver")
+    {
+      m_Server.SetPort(s_uiServerPort);
+      m_Server.StartServer();
+      m_Server.m_Events.AddEventHandler(ezMakeDelegate(&LoopbackServer::ServerEventHandler, this));
+
+      // creating a server disables the client
+      ezFileserveClient::EnableFileserveClient();
+
+      Start();
+    }
+
+    ~LoopbackServer()
+    {
+      m_bRun = false;
+      Join();
+
+      m_Server.m_Events.RemoveEventHandler(ezMakeDelegate(&LoopbackServer::ServerEventHandler, this));
+      m_Server.StopServer();
+    }
+
+    /// \brief How many files were requested from the server, through single requests or prefetching.
+    ezAtomicInteger32 m_iNumFileRequests;
+
+  private:
+    virtual ezUInt32 Run() override
+    {
+      while (m_bRun)
+      {
+        if (!m_Server.UpdateServer())
+        {
+          ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+        }
+      }
+
+      return 0;
+    }
+
+    void ServerEventHandler(const ezFileserverEvent& e)
+    {
+      if (e.m_Type == ezFileserverEvent::Type::FileDownloadRequest)
+      {
+        m_iNumFileRequests.Increment();
+      }
+    }
+
+    ezFileserver m_Server;
+    ezAtomicBool m_bRun = true;
+  };
+
+  struct SessionResult
+  {
+    ezTime m_Duration;
+    ezUInt32 m_uiNumRequestsAfterMount = 0;
+    ezUInt32 m_uiNumMismatches = 0;
+  };
+
+  /// \brief Writes all test files, every version after the first one only changes every other file.
+  void WriteFiles(const char* szFolder, ezUInt32 uiVersion, ezDynamicArray<ezDynamicArray<ezUInt8>>& inout_Content)
+  {
+    ezStringBuilder sPath, sLine;
+
+    inout_Content.SetCount(s_uiNumFiles);
+
+    for (ezUInt32 i = 0; i < s_uiNumFiles; ++i)
+    {
+      auto& content = inout_Content[i];
+
+      if (uiVersion > 0 && (i % 2) != 0)
+        continue;
+
+      content.Clear();
+
+      // sizes between 0 and 64 KB, the content compresses reasonably well
+      const ezUInt32 uiNumLines = (i * 7919) % 2048;
+      for (ezUInt32 uiLine = 0; uiLine < uiNumLines; ++uiLine)
+      {
+        sLine.Format("File {0}, version {1}, line {2}\n", i, uiVersion, uiLine);
+        content.PushBackRange(ezArrayPtr<const ezUInt8>(reinterpret_cast<const ezUInt8*>(sLine.GetData()), sLine.GetElementCount()));
+      }
+
+      sPath.Format("{0}/File{1}.txt", szFolder, i);
+
+      ezOSFile file;
+      if (EZ_TEST_RESULT(file.Open(sPath, ezFileOpenMode::Write)).Succeeded() && !content.IsEmpty())
+      {
+        file.Write(content.GetData(), content.GetCount());
+      }
+    }
+  }
+
+  /// \brief The client stores its cache and manifests in the test output folder, so that the user's regular fileserve data stays untouched.
+  void GetClientDataFolder(ezStringBuilder& out_sFolder)
+  {
+    out_sFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+    out_sFolder.AppendPath("FileserveClientData");
+  }
+
+  void DeletePrefetchManifest()
+  {
+    // same location as in ezFileserveClient::LoadPrefetchManifest()
+    ezStringBuilder sAppName = "Default";
+    if (ezApplication::GetApplicationInstance() != nullptr && !ezApplication::GetApplicationInstance()->GetApplicationName().IsEmpty())
+    {
+      sAppName = ezApplication::GetApplicationInstance()->GetApplicationName();
+    }
+
+    sAppName.Append(".txt");
+
+    ezStringBuilder sManifestFile;
+    GetClientDataFolder(sManifestFile);
+    sManifestFile.AppendPath("Manifests", sAppName);
+
+    ezOSFile::DeleteFile(sManifestFile);
+  }
+
+  /// \brief Simulates one application run, that mounts the test data directory and reads all files through fileserve.
+  void RunSession(bool bColdCache, const ezDynamicArray<ezDynamicArray<ezUInt8>>& expectedContent, SessionResult& out_Result)
+  {
+    // a new server for every session, since the server identifies clients by an ID that is only unique across processes
+    LoopbackServer server;
+
+    ezFileserveClient* pClient = EZ_DEFAULT_NEW(ezFileserveClient);
+
+    ezStringBuilder sClientDataFolder;
+    GetClientDataFolder(sClientDataFolder);
+    pClient->SetFileserveDataFolder(sClientDataFolder);
+
+    // the client stores its session manifest when it shuts down
+    EZ_SCOPE_EXIT(EZ_DEFAULT_DELETE(pClient));
+
+    ezStringBuilder sAddress;
+    sAddress.Format("localhost:{0}", s_uiServerPort);
+    pClient->AddServerAddressToTry(sAddress);
+
+    if (EZ_TEST_RESULT(pClient->EnsureConnected(ezTime::Seconds(10))).Failed())
+      return;
+
+    if (bColdCache)
+    {
+      ezStringBuilder sCacheFolder, sCacheMetaFolder, sCachedFile;
+      pClient->GetFullDataDirCachePath(s_szDataDir, sCacheFolder, sCacheMetaFolder);
+
+      for (ezUInt32 i = 0; i < s_uiNumFiles; ++i)
+      {
+        sCachedFile.Format("{0}/File{1}.txt", sCacheFolder, i);
+        ezOSFile::DeleteFile(sCachedFile);
+
+        sCachedFile.Format("{0}/File{1}.txt", sCacheMetaFolder, i);
+        ezOSFile::DeleteFile(sCachedFile);
+      }
+    }
+
+    ezStopwatch sw;
+
+    // prefetching happens when the data directory is mounted
+    EZ_TEST_RESULT(ezFileSystem::AddDataDirectory(s_szDataDir, "FileserveTest", "fstest"));
+    EZ_SCOPE_EXIT(ezFileSystem::RemoveDataDirectoryGroup("FileserveTest"));
+
+    const ezInt32 iNumRequestsBeforeReading = server.m_iNumFileRequests;
+
+    ezStringBuilder sFile;
+    ezDynamicArray<ezUInt8> content;
+
+    for (ezUInt32 i = 0; i < s_uiNumFiles; ++i)
+    {
+      sFile.Format(":fstest/File{0}.txt", i);
+
+      ezFileReader file;
+      if (file.Open(sFile).Failed())
+      {
+        ++out_Result.m_uiNumMismatches;
+        continue;
+      }
+
+      content.SetCountUninitialized((ezUInt32)file.GetFileSize());
+      file.ReadBytes(content.GetData(), content.GetCount());
+
+      if (content != expectedContent[i])
+      {
+        ++out_Result.m_uiNumMismatches;
+      }
+    }
+
+    out_Result.m_Duration = sw.GetRunningTotal();
+    out_Result.m_uiNumRequestsAfterMount = server.m_iNumFileRequests - iNumRequestsBeforeReading;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Fileserve, Prefetch)
+{
+  // the test framework itself may run through fileserve, in which case there can't be a second client
+  if (ezFileserveClient::GetSingleton() != nullptr)
+    return;
+
+  ezStringBuilder sFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sFolder.AppendPath("FileserveTest");
+
+  if (EZ_TEST_RESULT(ezOSFile::CreateDirectoryStructure(sFolder)).Failed())
+    return;
+
+  ezDynamicArray<ezDynamicArray<ezUInt8>> content;
+  WriteFiles(sFolder, 0, content);
+
+  SessionResult coldPerFile, warmPerFile, coldPrefetch, warmPrefetch;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Per-file requests")
+  {
+    // without a manifest from a previous run, every file is requested when it is accessed for the first time
+    DeletePrefetchManifest();
+    RunSession(true, content, coldPerFile);
+    EZ_TEST_INT(coldPerFile.m_uiNumMismatches, 0);
+    EZ_TEST_BOOL(coldPerFile.m_uiNumRequestsAfterMount >= s_uiNumFiles);
+
+    DeletePrefetchManifest();
+    RunSession(false, content, warmPerFile);
+    EZ_TEST_INT(warmPerFile.m_uiNumMismatches, 0);
+    EZ_TEST_BOOL(warmPerFile.m_uiNumRequestsAfterMount >= s_uiNumFiles);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Prefetch")
+  {
+    // the previous session stored its manifest, so all files are validated and downloaded while mounting
+    RunSession(true, content, coldPrefetch);
+    EZ_TEST_INT(coldPrefetch.m_uiNumMismatches, 0);
+    EZ_TEST_INT(coldPrefetch.m_uiNumRequestsAfterMount, 0);
+
+    RunSession(false, content, warmPrefetch);
+    EZ_TEST_INT(warmPrefetch.m_uiNumMismatches, 0);
+    EZ_TEST_INT(warmPrefetch.m_uiNumRequestsAfterMount, 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Prefetch changed files")
+  {
+    WriteFiles(sFolder, 1, content);
+
+    SessionResult changed;
+    RunSession(false, content, changed);
+    EZ_TEST_INT(changed.m_uiNumMismatches, 0);
+    EZ_TEST_INT(changed.m_uiNumRequestsAfterMount, 0);
+  }
+
+  ezTestFramework::Output(ezTestOutput::Duration, "Fileserve loopback, %u files, per file: %.1fms cold / %.1fms warm, prefetch: %.1fms cold / %.1fms warm",
+    s_uiNumFiles, coldPerFile.m_Duration.GetMilliseconds(), warmPerFile.m_Duration.GetMilliseconds(), coldPrefetch.m_Duration.GetMilliseconds(),
+    warmPrefetch.m_Duration.GetMilliseconds());
+}
+
+#endif
@@ -0,0 +1,370 @@
+#include <CoreTestPCH.h>
+
+#include <Core/Graphics/Camera.h>
+#include <Core/Graphics/Geometry.h>
+#include <Foundation/Math/Frustum.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <RendererCore/Meshes/MeshClusterCulling.h>
+#include <RendererCore/Meshes/MeshOptimizer.h>
+
+namespace
+{
+  /// Creates a sphere around the origin and splits it into clusters the same way the asset pipeline does.
+  void CreateClusteredSphere(float fRadius, ezUInt16 uiSegments, ezUInt16 uiStacks, ezDynamicArray<ezUInt32>& out_Indices,
+    ezDynamicArray<ezVec3>& out_Positions, ezDynamicArray<ezMeshResourceDescriptor::Cluster>& out_Clusters)
+  {
+    ezGeometry geom;
+    geom.AddSphere(fRadius, uiSegments, uiStacks, ezColor::White);
+
+    out_Positions.Clear();
+    for (const auto& vertex : geom.GetVertices())
+    {
+      out_Positions.PushBack(vertex.m_vPosition);
+    }
+
+    out_Indices.Clear();
+    for (const auto& polygon : geom.GetPolygons())
+    {
+      for (ezUInt32 i = 2; i < polygon.m_Vertices.GetCount(); ++i)
+      {
+        out_Indices.PushBack(polygon.m_Vertices[0]);
+        out_Indices.PushBack(polygon.m_Vertices[i - 1]);
+        out_Indices.PushBack(polygon.m_Vertices[i]);
+      }
+    }
+
+    ezMeshOptimizer::OptimizeVertexCache(out_Indices, out_Positions.GetCount(), 16);
+    ezMeshOptimizer::BuildClusters(out_Indices, out_Positions, 128, 0, out_Clusters);
+  }
+
+  /// Brute force reference: whether any part of the triangle may be rasterized. Conservative like the cluster test, i.e. a triangle is only
+  /// outside if all its corners are outside of the same plane.
+  bool IsTriangleVisible(const ezVec3* pCorners, const ezFrustum& frustum, const ezCamera& camera, bool bFlipWinding)
+  {
+    for (ezUInt32 p = 0; p < 6; ++p)
+    {
+      const ezPlane& plane = frustum.GetPlane(static_cast<ezUInt8>(p));
+
+      if (plane.GetDistanceTo(pCorners[0]) > 0.0f && plane.GetDistanceTo(pCorners[1]) > 0.0f && plane.GetDistanceTo(pCorners[2]) > 0.0f)
+        return false;
+    }
+
+    ezVec3 vNormal = (pCorners[1] - pCorners[0]).CrossRH(pCorners[2] - pCorners[0]);
+    if (bFlipWinding)
+      vNormal = -vNormal;
+
+    const ezVec3 vViewDir = camera.IsOrthographic() ? camera.GetCenterDirForwards() : pCorners[0] - camera.GetCenterPosition();
+    return vNormal.Dot(vViewDir) < 0.0f;
+  }
+
+  void SetupFrustum(const ezCamera& camera, ezFrustum& out_Frustum)
+  {
+    ezMat4 projectionMatrix;
+    camera.GetProjectionMatrix(16.0f / 9.0f, projectionMatrix);
+
+    out_Frustum.SetFrustum(projectionMatrix * camera.GetViewMatrix());
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Meshes, MeshClusterCulling)
+{
+  ezDynamicArray<ezUInt32> indices;
+  ezDynamicArray<ezVec3> positions;
+  ezDynamicArray<ezMeshResourceDescriptor::Cluster> clusters;
+  CreateClusteredSphere(10.0f, 128, 64, indices, positions, clusters);
+
+  const ezUInt32 uiNumTriangles = indices.GetCount() / 3;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BuildClusters")
+  {
+    // the clusters cover all triangles without gaps
+    ezUInt32 uiNextPrimitive = 0;
+    for (const auto& cluster : clusters)
+    {
+      EZ_TEST_INT(cluster.m_uiFirstPrimitive, uiNextPrimitive);
+      EZ_TEST_BOOL(cluster.m_uiPrimitiveCount > 0 && cluster.m_uiPrimitiveCount <= 128);
+
+      uiNextPrimitive += cluster.m_uiPrimitiveCount;
+
+      for (ezUInt32 t = cluster.m_uiFirstPrimitive; t < cluster.m_uiFirstPrimitive + cluster.m_uiPrimitiveCount; ++t)
+      {
+        const ezVec3& v0 = positions[indices[t * 3 + 0]];
+        const ezVec3& v1 = positions[indices[t * 3 + 1]];
+        const ezVec3& v2 = positions[indices[t * 3 + 2]];
+
+        // the bounding sphere contains all corners
+        for (ezUInt32 i = 0; i < 3; ++i)
+        {
+          EZ_TEST_BOOL((positions[indices[t * 3 + i]] - cluster.m_vCenter).GetLength() <= cluster.m_fRadius * 1.001f);
+        }
+
+        // ezGeometry's front faces point outwards, and the normal cone contains all face normals
+        ezVec3 vNormal = (v1 - v0).CrossRH(v2 - v0);
+        if (vNormal.NormalizeIfNotZero(ezVec3::ZeroVector()).Succeeded())
+        {
+          EZ_TEST_BOOL(vNormal.Dot(v0 + v1 + v2) > 0.0f);
+          EZ_TEST_BOOL(vNormal.Dot(cluster.m_vConeAxis) >= cluster.m_fConeCosAngle - 0.001f);
+        }
+      }
+
+      // on a smooth sphere, the clusters are small enough to have a useful normal cone
+      EZ_TEST_BOOL(cluster.m_fConeCosAngle > 0.5f);
+    }
+
+    EZ_TEST_INT(uiNextPrimitive, uiNumTriangles);
+    EZ_TEST_BOOL(clusters.GetCount() <= uiNumTriangles / 64);
+
+    // only the order of the triangles may change, not their corners or winding
+    ezGeometry geom;
+    geom.AddSphere(10.0f, 128, 64, ezColor::White);
+
+    ezDynamicArray<ezUInt64> trianglesBefore;
+    for (const auto& polygon : geom.GetPolygons())
+    {
+      for (ezUInt32 i = 2; i < polygon.m_Vertices.GetCount(); ++i)
+      {
+        trianglesBefore.PushBack(((ezUInt64)polygon.m_Vertices[0] << 42) | ((ezUInt64)polygon.m_Vertices[i - 1] << 21) | polygon.m_Vertices[i]);
+      }
+    }
+
+    ezDynamicArray<ezUInt64> trianglesAfter;
+    for (ezUInt32 t = 0; t < uiNumTriangles; ++t)
+    {
+      trianglesAfter.PushBack(((ezUInt64)indices[t * 3 + 0] << 42) | ((ezUInt64)indices[t * 3 + 1] << 21) | indices[t * 3 + 2]);
+    }
+
+    trianglesBefore.Sort();
+    trianglesAfter.Sort();
+    EZ_TEST_BOOL(trianglesBefore == trianglesAfter);
+  }
+
+  ezMeshClusterCullingData cullingData;
+  cullingData.Initialize(clusters);
+
+  EZ_TEST_INT(cullingData.GetClusterCount(), clusters.GetCount());
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "CullClusters")
+  {
+    struct TestCase
+    {
+      ezTransform m_Transform;
+      ezVec3 m_vCameraPos;
+      ezVec3 m_vTarget;
+      bool m_bOrthographic;
+    };
+
+    ezQuat qRotation;
+    qRotation.SetFromAxisAndAngle(ezVec3(1, 2, 3).GetNormalized(), ezAngle::Degree(40.0f));
+
+    const TestCase testCases[] = {
+      {ezTransform(ezVec3(0, 0, 0)), ezVec3(30, 0, 0), ezVec3(0, 0, 0), false},
+      {ezTransform(ezVec3(0, 0, 0)), ezVec3(25, 5, 3), ezVec3(0, 12, 0), false},
+      {ezTransform(ezVec3(0, 0, 0)), ezVec3(3, 1, 2), ezVec3(-5, 1, 2), false},
+      {ezTransform(ezVec3(5, -3, 2), qRotation, ezVec3(1.0f, 3.0f, 0.5f)), ezVec3(40, 10, -5), ezVec3(5, 0, 2), false},
+      {ezTransform(ezVec3(5, -3, 2), qRotation, ezVec3(-1.0f, 2.0f, 1.0f)), ezVec3(-30, 5, 10), ezVec3(5, 5, 2), false},
+      {ezTransform(ezVec3(0, 0, 0), qRotation, ezVec3(2.0f)), ezVec3(50, 0, 0), ezVec3(0, 0, 0), true},
+    };
+
+    ezDynamicArray<ezMeshClusterRange> ranges;
+    ezDynamicArray<bool> triangleVisible;
+    ezDynamicArray<ezVec3> worldPositions;
+
+    for (const TestCase& testCase : testCases)
+    {
+      ezCamera camera;
+      camera.SetCameraMode(testCase.m_bOrthographic ? ezCameraMode::OrthoFixedWidth : ezCameraMode::PerspectiveFixedFovX,
+        testCase.m_bOrthographic ? 15.0f : 70.0f, 0.1f, 100.0f);
+      camera.LookAt(testCase.m_vCameraPos, testCase.m_vTarget, ezVec3(0, 0, 1));
+
+      ezFrustum frustum;
+      SetupFrustum(camera, frustum);
+
+      const bool bFlipWinding = testCase.m_Transform.ContainsNegativeScale();
+
+      worldPositions.SetCountUninitialized(positions.GetCount());
+      for (ezUInt32 v = 0; v < positions.GetCount(); ++v)
+      {
+        worldPositions[v] = testCase.m_Transform.TransformPosition(positions[v]);
+      }
+
+      for (bool bCullBackfaces : {false, true})
+      {
+        ezMeshClusterCullingView view;
+        view.Setup(frustum, testCase.m_Transform, bCullBackfaces ? &camera : nullptr);
+        EZ_TEST_BOOL(view.IsEnabled());
+
+        ranges.Clear();
+        const ezUInt32 uiNumVisible = cullingData.CullClusters(view, 0, clusters.GetCount(), true, ranges);
+
+        triangleVisible.Clear();
+        triangleVisible.SetCount(uiNumTriangles);
+
+        ezUInt32 uiNumVisibleTriangles = 0;
+        for (ezUInt32 r = 0; r < ranges.GetCount(); ++r)
+        {
+          // ranges are sorted and merged
+          if (r > 0)
+          {
+            EZ_TEST_BOOL(ranges[r - 1].m_uiFirstPrimitive + ranges[r - 1].m_uiPrimitiveCount < ranges[r].m_uiFirstPrimitive);
+          }
+
+          for (ezUInt32 t = ranges[r].m_uiFirstPrimitive; t < ranges[r].m_uiFirstPrimitive + ranges[r].m_uiPrimitiveCount; ++t)
+          {
+            triangleVisible[t] = true;
+          }
+
+          uiNumVisibleTriangles += ranges[r].m_uiPrimitiveCount;
+        }
+
+        // culling must be conservative, every triangle that can be seen has to be in a visible cluster
+        ezUInt32 uiNumMissingTriangles = 0;
+        ezUInt32 uiNumReferenceTriangles = 0;
+        for (ezUInt32 t = 0; t < uiNumTriangles; ++t)
+        {
+          const ezVec3 corners[3] = {worldPositions[indices[t * 3 + 0]], worldPositions[indices[t * 3 + 1]], worldPositions[indices[t * 3 + 2]]};
+
+          bool bReferenceVisible = IsTriangleVisible(corners, frustum, camera, bFlipWinding);
+          if (!bCullBackfaces)
+          {
+            bReferenceVisible |= IsTriangleVisible(corners, frustum, camera, !bFlipWinding);
+          }
+
+          if (bReferenceVisible)
+          {
+            ++uiNumReferenceTriangles;
+
+            if (!triangleVisible[t])
+              ++uiNumMissingTriangles;
+          }
+        }
+
+        EZ_TEST_INT(uiNumMissingTriangles, 0);
+        EZ_TEST_BOOL(uiNumVisible <= clusters.GetCount());
+        EZ_TEST_BOOL(uiNumVisibleTriangles >= uiNumReferenceTriangles);
+
+        // backface culling removes about half of a sphere
+        if (bCullBackfaces)
+        {
+          EZ_TEST_BOOL(uiNumVisibleTriangles < uiNumTriangles * 3 / 4);
+        }
+      }
+
+      // disabling back-face culling per call overrides the view
+      {
+        ezMeshClusterCullingView frustumOnlyView;
+        frustumOnlyView.Setup(frustum, testCase.m_Transform, nullptr);
+
+        ezMeshClusterCullingView view;
+        view.Setup(frustum, testCase.m_Transform, &camera);
+
+        ezDynamicArray<ezMeshClusterRange> frustumOnlyRanges;
+        ranges.Clear();
+
+        EZ_TEST_INT(cullingData.CullClusters(view, 0, clusters.GetCount(), false, ranges),
+          cullingData.CullClusters(frustumOnlyView, 0, clusters.GetCount(), true, frustumOnlyRanges));
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Sub-Ranges")
+  {
+    ezCamera camera;
+    camera.SetCameraMode(ezCameraMode::PerspectiveFixedFovX, 70.0f, 0.1f, 100.0f);
+    camera.LookAt(ezVec3(30, 0, 0), ezVec3(0, 0, 0), ezVec3(0, 0, 1));
+
+    ezFrustum frustum;
+    SetupFrustum(camera, frustum);
+
+    ezMeshClusterCullingView view;
+    view.Setup(frustum, ezTransform::IdentityTransform(), &camera);
+
+    ezDynamicArray<ezMeshClusterRange> allRanges;
+    const ezUInt32 uiNumVisible = cullingData.CullClusters(view, 0, clusters.GetCount(), true, allRanges);
+
+    // culling arbitrary sub-ranges, e.g. the clusters of one sub-mesh, gives the same result as culling everything at once
+    ezDynamicArray<ezMeshClusterRange> ranges;
+    ezUInt32 uiNumVisibleInParts = 0;
+    for (ezUInt32 uiFirst = 0; uiFirst < clusters.GetCount(); uiFirst += 7)
+    {
+      uiNumVisibleInParts += cullingData.CullClusters(view, uiFirst, ezMath::Min(7u, clusters.GetCount() - uiFirst), true, ranges);
+    }
+
+    EZ_TEST_INT(uiNumVisibleInParts, uiNumVisible);
+    EZ_TEST_BOOL(ranges == allRanges);
+
+    // a degenerate transform disables culling
+    ezMeshClusterCullingView degenerateView;
+    degenerateView.Setup(frustum, ezTransform(ezVec3::ZeroVector(), ezQuat::IdentityQuaternion(), ezVec3(0.0f)), &camera);
+    EZ_TEST_BOOL(!degenerateView.IsEnabled());
+
+    ranges.Clear();
+    EZ_TEST_INT(cullingData.CullClusters(degenerateView, 3, 10, true, ranges), 10);
+    EZ_TEST_INT(ranges.GetCount(), 1);
+    EZ_TEST_INT(ranges[0].m_uiFirstPrimitive, clusters[3].m_uiFirstPrimitive);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Performance")
+  {
+    ezDynamicArray<ezUInt32> bigIndices;
+    ezDynamicArray<ezVec3> bigPositions;
+    ezDynamicArray<ezMeshResourceDescriptor::Cluster> bigClusters;
+
+    ezStopwatch sw;
+    CreateClusteredSphere(10.0f, 512, 256, bigIndices, bigPositions, bigClusters);
+    const ezTime tBuild = sw.Checkpoint();
+
+    ezMeshClusterCullingData bigCullingData;
+    bigCullingData.Initialize(bigClusters);
+
+    const ezUInt32 uiBigTriangles = bigIndices.GetCount() / 3;
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%u triangles: %u clusters built in %.2f ms", uiBigTriangles, bigClusters.GetCount(),
+      tBuild.GetMilliseconds());
+
+    const ezVec3 targets[] = {ezVec3(0, 0, 0), ezVec3(0, 12, 0), ezVec3(-5, 0, 0)};
+    const char* szNames[] = {"whole mesh in view", "partially in view", "camera inside the sphere"};
+    const ezVec3 cameraPositions[] = {ezVec3(30, 0, 0), ezVec3(25, 5, 3), ezVec3(9, 0, 0)};
+
+    ezDynamicArray<ezMeshClusterRange> ranges;
+    ranges.Reserve(bigClusters.GetCount());
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(targets); ++i)
+    {
+      ezCamera camera;
+      camera.SetCameraMode(ezCameraMode::PerspectiveFixedFovX, 70.0f, 0.1f, 100.0f);
+      camera.LookAt(cameraPositions[i], targets[i], ezVec3(0, 0, 1));
+
+      ezFrustum frustum;
+      SetupFrustum(camera, frustum);
+
+      const ezUInt32 uiIterations = 1000;
+      ezUInt32 uiNumVisible = 0;
+
+      sw.Checkpoint();
+
+      for (ezUInt32 n = 0; n < uiIterations; ++n)
+      {
+        ezMeshClusterCullingView view;
+        view.Setup(frustum, ezTransform::IdentityTransform(), &camera);
+
+        ranges.Clear();
+        uiNumVisible = bigCullingData.CullClusters(view, 0, bigClusters.GetCount(), true, ranges);
+      }
+
+      const ezTime tCull = sw.Checkpoint();
+
+      ezUInt32 uiVisibleTriangles = 0;
+      for (const auto& range : ranges)
+      {
+        uiVisibleTriangles += range.m_uiPrimitiveCount;
+      }
+
+      EZ_TEST_BOOL(uiVisibleTriangles < uiBigTriangles);
+
+      const double fClustersPerMs = (double)bigClusters.GetCount() * uiIterations / tCull.GetMilliseconds();
+      ezTestFramework::Output(ezTestOutput::Duration,
+        "%s: %u of %u clusters visible in %u ranges, %.1f%% triangles saved, %.0f clusters culled per ms", szNames[i], uiNumVisible,
+        bigClusters.GetCount(), ranges.GetCount(), 100.0 * (uiBigTriangles - uiVisibleTriangles) / uiBigTriangles, fClustersPerMs);
+    }
+  }
+}
@@ -0,0 +1,332 @@
+#include <CoreTestPCH.h>
+
+#include <Core/Graphics/Geometry.h>
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <RendererCore/Meshes/MeshOptimizer.h>
+#include <RendererCore/Meshes/MeshResourceDescriptor.h>
+
+namespace
+{
+  /// Creates a regular grid of uiSize * uiSize quads with the triangles in random order, which is about the worst case for the vertex cache.
+  void CreateShuffledGrid(ezUInt32 uiSize, ezDynamicArray<ezUInt32>& out_Indices, ezDynamicArray<ezVec3>& out_Positions)
+  {
+    out_Positions.Clear();
+    for (ezUInt32 y = 0; y <= uiSize; ++y)
+    {
+      for (ezUInt32 x = 0; x <= uiSize; ++x)
+      {
+        out_Positions.PushBack(ezVec3((float)x, (float)y, 0.0f));
+      }
+    }
+
+    out_Indices.Clear();
+    for (ezUInt32 y = 0; y < uiSize; ++y)
+    {
+      for (ezUInt32 x = 0; x < uiSize; ++x)
+      {
+        const ezUInt32 v0 = y * (uiSize + 1) + x;
+        const ezUInt32 v1 = v0 + 1;
+        const ezUInt32 v2 = v0 + uiSize + 1;
+        const ezUInt32 v3 = v2 + 1;
+
+        out_Indices.PushBack(v0);
+        out_Indices.PushBack(v1);
+        out_Indices.PushBack(v2);
+
+        out_Indices.PushBack(v1);
+        out_Indices.PushBack(v3);
+        out_Indices.PushBack(v2);
+      }
+    }
+
+    ezRandom rng;
+    rng.Initialize(42);
+
+    const ezUInt32 uiNumTriangles = out_Indices.GetCount() / 3;
+    for (ezUInt32 t = uiNumTriangles - 1; t > 0; --t)
+    {
+      const ezUInt32 uiOther = rng.UIntInRange(t + 1);
+      for (ezUInt32 i = 0; i < 3; ++i)
+      {
+        ezMath::Swap(out_Indices[t * 3 + i], out_Indices[uiOther * 3 + i]);
+      }
+    }
+  }
+
+  struct Triangle
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezVec3 m_Corners[3];
+
+    bool operator<(const Triangle& rhs) const
+    {
+      for (ezUInt32 i = 0; i < 3; ++i)
+      {
+        for (ezUInt32 c = 0; c < 3; ++c)
+        {
+          if (m_Corners[i].GetData()[c] != rhs.m_Corners[i].GetData()[c])
+            return m_Corners[i].GetData()[c] < rhs.m_Corners[i].GetData()[c];
+        }
+      }
+
+      return false;
+    }
+
+    bool operator==(const Triangle& rhs) const { return !(*this < rhs) && !(rhs < *this); }
+  };
+
+  /// Returns the triangles in a canonical form, independent of the triangle order and the vertex numbering, but including the winding.
+  void GetSortedTriangles(ezArrayPtr<const ezUInt32> indices, ezArrayPtr<const ezVec3> positions, ezDynamicArray<Triangle>& out_Triangles)
+  {
+    out_Triangles.Clear();
+
+    for (ezUInt32 t = 0; t < indices.GetCount(); t += 3)
+    {
+      Triangle& tri = out_Triangles.ExpandAndGetRef();
+
+      // rotate the smallest corner to the front, which keeps the winding
+      ezUInt32 uiFirst = 0;
+      for (ezUInt32 i = 1; i < 3; ++i)
+      {
+        Triangle a, b;
+        a.m_Corners[0] = positions[indices[t + i]];
+        b.m_Corners[0] = positions[indices[t + uiFirst]];
+        a.m_Corners[1] = a.m_Corners[2] = b.m_Corners[1] = b.m_Corners[2] = ezVec3::ZeroVector();
+
+        if (a < b)
+          uiFirst = i;
+      }
+
+      for (ezUInt32 i = 0; i < 3; ++i)
+      {
+        tri.m_Corners[i] = positions[indices[t + (uiFirst + i) % 3]];
+      }
+    }
+
+    out_Triangles.Sort();
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Meshes);
+
+EZ_CREATE_SIMPLE_TEST(Meshes, MeshOptimizer)
+{
+  const ezUInt32 uiCacheSize = 16;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "OptimizeVertexCache")
+  {
+    ezDynamicArray<ezUInt32> indices;
+    ezDynamicArray<ezVec3> positions;
+    CreateShuffledGrid(64, indices, positions);
+
+    ezDynamicArray<Triangle> trianglesBefore;
+    GetSortedTriangles(indices, positions, trianglesBefore);
+
+    const ezMeshVertexCacheStats before = ezMeshOptimizer::AnalyzeVertexCache(indices, positions.GetCount(), uiCacheSize);
+
+    ezDynamicArray<ezUInt32> clusterStarts;
+    ezMeshOptimizer::OptimizeVertexCache(indices, positions.GetCount(), uiCacheSize, &clusterStarts);
+
+    const ezMeshVertexCacheStats after = ezMeshOptimizer::AnalyzeVertexCache(indices, positions.GetCount(), uiCacheSize);
+
+    EZ_TEST_INT(before.m_uiNumTriangles, 64 * 64 * 2);
+    EZ_TEST_INT(after.m_uiNumTriangles, 64 * 64 * 2);
+    EZ_TEST_INT(after.m_uiNumVertices, 65 * 65);
+    EZ_TEST_BOOL(before.GetACMR() > 2.0f);
+    EZ_TEST_BOOL(after.GetACMR() < 0.8f);
+    EZ_TEST_BOOL(after.GetATVR() < 1.6f);
+
+    EZ_TEST_BOOL(!clusterStarts.IsEmpty());
+    EZ_TEST_INT(clusterStarts[0], 0);
+
+    ezDynamicArray<Triangle> trianglesAfter;
+    GetSortedTriangles(indices, positions, trianglesAfter);
+    EZ_TEST_BOOL(trianglesBefore == trianglesAfter);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "OptimizeOverdraw")
+  {
+    ezGeometry geom;
+    geom.AddGeodesicSphere(1.0f, 3, ezColor::White);
+    geom.AddTorus(0.5f, 2.0f, 32, 16, ezColor::White);
+
+    ezDynamicArray<ezVec3> positions;
+    for (const auto& vertex : geom.GetVertices())
+    {
+      positions.PushBack(vertex.m_vPosition);
+    }
+
+    ezDynamicArray<ezUInt32> indices;
+    for (const auto& polygon : geom.GetPolygons())
+    {
+      for (ezUInt32 v = 0; v + 2 < polygon.m_Vertices.GetCount(); ++v)
+      {
+        indices.PushBack(polygon.m_Vertices[0]);
+        indices.PushBack(polygon.m_Vertices[v + 1]);
+        indices.PushBack(polygon.m_Vertices[v + 2]);
+      }
+    }
+
+    ezDynamicArray<Triangle> trianglesBefore;
+    GetSortedTriangles(indices, positions, trianglesBefore);
+
+    ezDynamicArray<ezUInt32> clusterStarts;
+    ezMeshOptimizer::OptimizeVertexCache(indices, positions.GetCount(), uiCacheSize, &clusterStarts);
+    const float fACMR = ezMeshOptimizer::AnalyzeVertexCache(indices, positions.GetCount(), uiCacheSize).GetACMR();
+
+    const float fThreshold = 1.05f;
+    ezMeshOptimizer::OptimizeOverdraw(indices, positions, clusterStarts, uiCacheSize, fThreshold);
+    const float fACMROverdraw = ezMeshOptimizer::AnalyzeVertexCache(indices, positions.GetCount(), uiCacheSize).GetACMR();
+
+    // every cluster keeps its ACMR within the threshold, but starting new clusters with an empty cache costs a bit more
+    EZ_TEST_BOOL(fACMROverdraw < fACMR * 1.5f);
+
+    ezDynamicArray<Triangle> trianglesAfter;
+    GetSortedTriangles(indices, positions, trianglesAfter);
+    EZ_TEST_BOOL(trianglesBefore == trianglesAfter);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "OptimizeVertexFetch")
+  {
+    ezUInt32 indices[] = {5, 3, 1, 1, 3, 0, 5, 1, 6};
+
+    ezDynamicArray<ezUInt32> oldToNew;
+    const ezUInt32 uiNumUsed = ezMeshOptimizer::OptimizeVertexFetch(ezMakeArrayPtr(indices), 8, oldToNew);
+
+    EZ_TEST_INT(uiNumUsed, 5);
+    EZ_TEST_INT(oldToNew.GetCount(), 8);
+
+    const ezUInt32 expectedIndices[] = {0, 1, 2, 2, 1, 3, 0, 2, 4};
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(indices); ++i)
+    {
+      EZ_TEST_INT(indices[i], expectedIndices[i]);
+    }
+
+    const ezUInt32 expectedRemap[] = {3, 2, ezInvalidIndex, 1, ezInvalidIndex, 0, 4, ezInvalidIndex};
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(expectedRemap); ++i)
+    {
+      EZ_TEST_INT(oldToNew[i], expectedRemap[i]);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Optimize Mesh Descriptor")
+  {
+    // 90000 vertices need 32 bit indices, but only 65 * 65 of them are used
+    const ezUInt32 uiGridSize = 64;
+    const ezUInt32 uiNumVertices = 90000;
+
+    ezDynamicArray<ezUInt32> gridIndices;
+    ezDynamicArray<ezVec3> gridPositions;
+    CreateShuffledGrid(uiGridSize, gridIndices, gridPositions);
+
+    ezMeshResourceDescriptor desc;
+    ezMeshBufferResourceDescriptor& meshBuffer = desc.MeshBufferDesc();
+    meshBuffer.AddStream(ezGALVertexAttributeSemantic::Position, ezGALResourceFormat::XYZFloat);
+    meshBuffer.AddStream(ezGALVertexAttributeSemantic::Color0, ezGALResourceFormat::RGBAUByteNormalized);
+    meshBuffer.AllocateStreams(uiNumVertices, ezGALPrimitiveTopology::Triangles, gridIndices.GetCount() / 3);
+
+    // spread the used vertices across the whole buffer
+    const ezUInt32 uiStride = uiNumVertices / gridPositions.GetCount();
+    for (ezUInt32 v = 0; v < uiNumVertices; ++v)
+    {
+      meshBuffer.SetVertexData(0, v, (v % uiStride == 0 && v / uiStride < gridPositions.GetCount()) ? gridPositions[v / uiStride] : ezVec3(-1.0f));
+      meshBuffer.SetVertexData(1, v, ezColorLinearUB(v & 0xFF, (v >> 8) & 0xFF, 0, 255));
+    }
+
+    for (ezUInt32 t = 0; t < gridIndices.GetCount(); t += 3)
+    {
+      meshBuffer.SetTriangleIndices(t / 3, gridIndices[t + 0] * uiStride, gridIndices[t + 1] * uiStride, gridIndices[t + 2] * uiStride);
+    }
+
+    // two sub-meshes, the triangles must not move from one to the other
+    const ezUInt32 uiNumTriangles = gridIndices.GetCount() / 3;
+    desc.AddSubMesh(uiNumTriangles / 4, 0, 0);
+    desc.AddSubMesh(uiNumTriangles - uiNumTriangles / 4, uiNumTriangles / 4, 1);
+
+    auto GetSubMeshTriangles = [&](ezUInt32 uiSubMesh, ezDynamicArray<Triangle>& out_Triangles) {
+      ezDynamicArray<ezUInt32> indices;
+      meshBuffer.GetIndices(indices);
+
+      ezDynamicArray<ezVec3> positions;
+      positions.SetCountUninitialized(meshBuffer.GetVertexCount());
+      for (ezUInt32 v = 0; v < meshBuffer.GetVertexCount(); ++v)
+      {
+        positions[v] = *reinterpret_cast<const ezVec3*>(meshBuffer.GetVertexData(0, v).GetPtr());
+      }
+
+      const auto& subMesh = desc.GetSubMeshes()[uiSubMesh];
+      GetSortedTriangles(indices.GetArrayPtr().GetSubArray(subMesh.m_uiFirstPrimitive * 3, subMesh.m_uiPrimitiveCount * 3), positions, out_Triangles);
+    };
+
+    ezDynamicArray<Triangle> subMesh0Before, subMesh1Before;
+    GetSubMeshTriangles(0, subMesh0Before);
+    GetSubMeshTriangles(1, subMesh1Before);
+
+    EZ_TEST_BOOL(meshBuffer.Uses32BitIndices());
+
+    ezMeshVertexCacheStats before, after;
+    EZ_TEST_BOOL(ezMeshOptimizer::Optimize(desc, ezMeshOptimizer::Settings(), &before, &after).Succeeded());
+
+    EZ_TEST_INT(meshBuffer.GetVertexCount(), gridPositions.GetCount());
+    EZ_TEST_BOOL(!meshBuffer.Uses32BitIndices());
+    EZ_TEST_INT(meshBuffer.GetPrimitiveCount(), uiNumTriangles);
+    EZ_TEST_INT(meshBuffer.GetIndexBufferData().GetCount(), uiNumTriangles * 3 * sizeof(ezUInt16));
+    EZ_TEST_BOOL(after.GetACMR() < before.GetACMR());
+    EZ_TEST_INT(after.m_uiNumVertices, gridPositions.GetCount());
+
+    ezDynamicArray<Triangle> subMesh0After, subMesh1After;
+    GetSubMeshTriangles(0, subMesh0After);
+    GetSubMeshTriangles(1, subMesh1After);
+    EZ_TEST_BOOL(subMesh0Before == subMesh0After);
+    EZ_TEST_BOOL(subMesh1Before == subMesh1After);
+
+    // the other vertex data must have moved along with the positions
+    for (ezUInt32 v = 0; v < meshBuffer.GetVertexCount(); ++v)
+    {
+      const ezVec3 vPos = *reinterpret_cast<const ezVec3*>(meshBuffer.GetVertexData(0, v).GetPtr());
+      const ezUInt32 uiOldIndex = ((ezUInt32)vPos.y * (uiGridSize + 1) + (ezUInt32)vPos.x) * uiStride;
+      const ezColorLinearUB color = *reinterpret_cast<const ezColorLinearUB*>(meshBuffer.GetVertexData(1, v).GetPtr());
+
+      EZ_TEST_BOOL(color == ezColorLinearUB(uiOldIndex & 0xFF, (uiOldIndex >> 8) & 0xFF, 0, 255));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Performance")
+  {
+    const ezUInt32 uiGridSizes[] = {23, 71, 224, 708}; // ~1k, 10k, 100k, 1M triangles
+
+    ezDynamicArray<ezUInt32> indices;
+    ezDynamicArray<ezVec3> positions;
+    ezDynamicArray<ezUInt32> clusterStarts;
+    ezDynamicArray<ezUInt32> oldToNew;
+
+    for (ezUInt32 uiGridSize : uiGridSizes)
+    {
+      CreateShuffledGrid(uiGridSize, indices, positions);
+
+      const ezMeshVertexCacheStats before = ezMeshOptimizer::AnalyzeVertexCache(indices, positions.GetCount(), uiCacheSize);
+
+      ezStopwatch sw;
+
+      ezMeshOptimizer::OptimizeVertexCache(indices, positions.GetCount(), uiCacheSize, &clusterStarts);
+      const ezTime tVertexCache = sw.Checkpoint();
+
+      ezMeshOptimizer::OptimizeOverdraw(indices, positions, clusterStarts, uiCacheSize, 1.05f);
+      const ezTime tOverdraw = sw.Checkpoint();
+
+      ezMeshOptimizer::OptimizeVertexFetch(indices, positions.GetCount(), oldToNew);
+      const ezTime tVertexFetch = sw.Checkpoint();
+
+      const ezMeshVertexCacheStats after = ezMeshOptimizer::AnalyzeVertexCache(indices, positions.GetCount(), uiCacheSize);
+
+      EZ_TEST_BOOL(after.GetACMR() < before.GetACMR());
+
+      ezTestFramework::Output(ezTestOutput::Duration,
+        "%u triangles: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, vertex cache %.2f ms, overdraw %.2f ms, vertex fetch %.2f ms", after.m_uiNumTriangles,
+        before.GetACMR(), after.GetACMR(), before.GetATVR(), after.GetATVR(), tVertexCache.GetMilliseconds(), tOverdraw.GetMilliseconds(),
+        tVertexFetch.GetMilliseconds());
+    }
+  }
+}
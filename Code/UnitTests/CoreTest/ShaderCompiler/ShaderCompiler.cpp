@@ -0,0 +1,297 @@
+#include <CoreTestPCH.h>
+
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <RendererCore/ShaderCompiler/ShaderCompiler.h>
+#include <RendererCore/ShaderCompiler/ShaderManager.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(ShaderCompiler);
+
+/// \brief Stand-in for a real shader compiler, so that the permutation handling can be tested without a GPU or a platform SDK.
+///
+/// The 'byte code' is the preprocessed source itself. Compiling burns some time, a real compiler is much slower than the preprocessor.
+class ezShaderCompilerTestStub : public ezShaderProgramCompiler
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezShaderCompilerTestStub, ezShaderProgramCompiler);
+
+public:
+  virtual void GetSupportedPlatforms(ezHybridArray<ezString, 4>& Platforms) override { Platforms.PushBack("TESTSTUB"); }
+
+  virtual ezResult Compile(ezShaderProgramData& inout_Data, ezLogInterface* pLog) override
+  {
+    for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
+    {
+      ezDynamicArray<ezUInt8>& byteCode = inout_Data.m_StageBinary[stage].GetByteCode();
+      if (!byteCode.IsEmpty())
+        continue;
+
+      const char* szSource = inout_Data.m_szShaderSource[stage];
+      const ezUInt32 uiLength = ezStringUtils::GetStringElementCount(szSource);
+
+      if (uiLength == 0)
+        continue;
+
+      ezUInt32 uiHash = 0;
+      for (ezUInt32 i = 0; i < s_uiWorkIterations; ++i)
+      {
+        uiHash = ezHashingUtils::xxHash32(szSource, uiLength, uiHash);
+      }
+
+      byteCode.SetCountUninitialized(uiLength);
+      ezMemoryUtils::Copy(byteCode.GetData(), reinterpret_cast<const ezUInt8*>(szSource), uiLength);
+
+      s_iNumCompiledStages.Increment();
+    }
+
+    return EZ_SUCCESS;
+  }
+
+  static ezAtomicInteger32 s_iNumCompiledStages;
+  static ezUInt32 s_uiWorkIterations;
+};
+
+ezAtomicInteger32 ezShaderCompilerTestStub::s_iNumCompiledStages;
+ezUInt32 ezShaderCompilerTestStub::s_uiWorkIterations = 1;
+
+// clang-format off
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezShaderCompilerTestStub, 1, ezRTTIDefaultAllocator<ezShaderCompilerTestStub>)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+// clang-format on
+
+namespace ShaderCompilerTestDetail
+{
+  void WriteTextFile(const char* szFile, const char* szText)
+  {
+    ezFileWriter file;
+    if (file.Open(szFile).Failed())
+    {
+      EZ_TEST_FAILURE("Could not write file", "'%s'", szFile);
+      return;
+    }
+
+    file.WriteBytes(szText, ezStringUtils::GetStringElementCount(szText));
+  }
+
+  /// The vertex shader only depends on the first permutation var, the pixel shader on all others,
+  /// so many permutations end up with identical stage sources.
+  void WriteShader(const char* szShaderFile, const char* szIncludeFile, ezUInt32 uiNumPermutationVars, ezUInt32 uiSalt)
+  {
+    ezStringBuilder sShader;
+    sShader.Append("[PLATFORMS]\nALL\n\n[PERMUTATIONS]\n");
+    for (ezUInt32 i = 0; i < uiNumPermutationVars; ++i)
+    {
+      sShader.AppendFormat("TEST_VAR_{0}\n", i);
+    }
+
+    sShader.Append("\n[RENDERSTATE]\n#if TEST_VAR_0\nCullMode = CullMode_Back\n#else\nCullMode = CullMode_None\n#endif\n");
+    sShader.AppendFormat("\n[SHADER]\n#include \"ShaderCompilerTestCommon.h\"\nstatic const int Salt = {0};\n", uiSalt);
+    sShader.Append("\n[VERTEXSHADER]\nfloat4 main() : SV_Position\n{\n#if TEST_VAR_0\n  return Function0(1);\n#else\n  return Function1(1);\n#endif\n}\n");
+    sShader.Append("\n[PIXELSHADER]\nfloat4 main() : SV_Target\n{\n  float4 result = 0;\n");
+    for (ezUInt32 i = 1; i < uiNumPermutationVars; ++i)
+    {
+      sShader.AppendFormat("#if TEST_VAR_{0}\n  result += Function{0}(result.x);\n#endif\n", i);
+    }
+    sShader.Append("  return result;\n}\n");
+
+    WriteTextFile(szShaderFile, sShader);
+
+    // a large include file, so that preprocessing costs something
+    ezStringBuilder sInclude;
+    for (ezUInt32 i = 0; i < 256; ++i)
+    {
+      sInclude.AppendFormat("#define CONSTANT_{0} {0}\n", i);
+      sInclude.AppendFormat("float4 Function{0}(float x)\n{\n  return float4(x, x * CONSTANT_{0}, x + CONSTANT_{0}, 1);\n}\n\n", i);
+    }
+
+    WriteTextFile(szIncludeFile, sInclude);
+  }
+
+  void CreatePermutations(ezUInt32 uiNumPermutationVars, ezPermutationGenerator& out_Generator)
+  {
+    ezHashedString sTrue, sFalse;
+    sTrue.Assign("TRUE");
+    sFalse.Assign("FALSE");
+
+    out_Generator.Clear();
+
+    ezStringBuilder sName;
+    for (ezUInt32 i = 0; i < uiNumPermutationVars; ++i)
+    {
+      sName.Format("TEST_VAR_{0}", i);
+
+      ezHashedString sHashedName;
+      sHashedName.Assign(sName.GetData());
+
+      out_Generator.AddPermutation(sHashedName, sFalse);
+      out_Generator.AddPermutation(sHashedName, sTrue);
+    }
+  }
+
+  /// Compiles every permutation with its own ezShaderCompiler, like the shader compiler tool used to do.
+  ezResult CompileOneByOne(const char* szShaderFile, const ezPermutationGenerator& permutations)
+  {
+    ezHybridArray<ezPermutationVar, 16> permutationVars;
+
+    for (ezUInt32 i = 0; i < permutations.GetPermutationCount(); ++i)
+    {
+      permutations.GetPermutation(i, permutationVars);
+
+      ezShaderCompiler sc;
+      EZ_SUCCEED_OR_RETURN(sc.CompileShaderPermutationForPlatforms(szShaderFile, permutationVars, ezLog::GetThreadLocalLogSystem(), "TESTSTUB"));
+    }
+
+    return EZ_SUCCESS;
+  }
+
+  void ReadPermutationFile(const char* szCacheDir, ezHybridArray<ezPermutationVar, 16>& permutationVars, ezDynamicArray<ezUInt8>& out_Content)
+  {
+    ezStringBuilder sFile;
+    sFile.Format("{0}/TESTSTUB/ShaderCompilerTest/Test_{1}.ezPermutation", szCacheDir,
+      ezArgU(ezShaderHelper::CalculateHash(permutationVars), 8, true, 16, true));
+
+    out_Content.Clear();
+
+    ezFileReader file;
+    if (file.Open(sFile).Failed())
+    {
+      EZ_TEST_FAILURE("Permutation file is missing", "'%s'", sFile.GetData());
+      return;
+    }
+
+    ezUInt8 temp[1024];
+    while (ezUInt64 uiRead = file.ReadBytes(temp, EZ_ARRAY_SIZE(temp)))
+    {
+      out_Content.PushBackRange(ezArrayPtr<ezUInt8>(temp, (ezUInt32)uiRead));
+    }
+  }
+} // namespace ShaderCompilerTestDetail
+
+EZ_CREATE_SIMPLE_TEST(ShaderCompiler, PermutationBatch)
+{
+  using namespace ShaderCompilerTestDetail;
+
+  ezStringBuilder sTestDir = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sTestDir.AppendPath("ShaderCompilerTest");
+#if EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS) && EZ_ENABLED(EZ_SUPPORTS_FILE_STATS)
+  // stage binaries of an earlier run would be loaded instead of compiled
+  ezOSFile::DeleteFolder(sTestDir).IgnoreResult();
+#endif
+
+  EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(ezTestFramework::GetInstance()->GetAbsOutputPath(), "ShaderCompilerTest", "shadertest",
+                 ezFileSystem::AllowWrites)
+                 .Succeeded());
+
+  const ezString sPrevPlatform = ezShaderManager::GetActivePlatform();
+  const ezString sPrevCacheDir = ezShaderManager::GetCacheDirectory();
+  const ezString sPrevPermVarDir = ezShaderManager::GetPermutationVarSubDirectory();
+  const bool bPrevRuntimeCompilation = ezShaderManager::IsRuntimeCompilationEnabled();
+
+  const char* szShaderFile = "ShaderCompilerTest/Test.ezShader";
+  const char* szCacheBatch = ":shadertest/ShaderCompilerTest/CacheBatch";
+  const char* szCacheSingle = ":shadertest/ShaderCompilerTest/CacheSingle";
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Batch matches single permutations")
+  {
+    const ezUInt32 uiNumPermutationVars = 3;
+    WriteShader(":shadertest/ShaderCompilerTest/Test.ezShader", ":shadertest/ShaderCompilerTest/ShaderCompilerTestCommon.h",
+      uiNumPermutationVars, 0);
+
+    ezPermutationGenerator permutations;
+    CreatePermutations(uiNumPermutationVars, permutations);
+    EZ_TEST_INT(permutations.GetPermutationCount(), 8);
+
+    // 2 different vertex shaders and 4 different pixel shaders
+    ezShaderManager::Configure("TESTSTUB", false, szCacheBatch, sPrevPermVarDir);
+    ezShaderCompilerTestStub::s_iNumCompiledStages = 0;
+    {
+      ezShaderCompiler sc;
+      EZ_TEST_BOOL(sc.CompileShaderPermutationsForPlatforms(szShaderFile, permutations, ezLog::GetThreadLocalLogSystem(), "TESTSTUB").Succeeded());
+    }
+    EZ_TEST_INT(ezShaderCompilerTestStub::s_iNumCompiledStages, 6);
+
+    ezShaderManager::Configure("TESTSTUB", false, szCacheSingle, sPrevPermVarDir);
+    EZ_TEST_BOOL(CompileOneByOne(szShaderFile, permutations).Succeeded());
+
+    ezHybridArray<ezPermutationVar, 16> permutationVars;
+    ezDynamicArray<ezUInt8> batchContent, singleContent;
+
+    for (ezUInt32 i = 0; i < permutations.GetPermutationCount(); ++i)
+    {
+      permutations.GetPermutation(i, permutationVars);
+
+      ReadPermutationFile(szCacheBatch, permutationVars, batchContent);
+      ReadPermutationFile(szCacheSingle, permutationVars, singleContent);
+
+      EZ_TEST_BOOL(!batchContent.IsEmpty());
+      EZ_TEST_BOOL(batchContent == singleContent);
+
+      // the include file must be tracked as a dependency, even though the shared file cache only opened it once
+      ezMemoryStreamStorage storage;
+      ezMemoryStreamWriter writer(&storage);
+      writer.WriteBytes(batchContent.GetData(), batchContent.GetCount());
+
+      ezMemoryStreamReader reader(&storage);
+      ezShaderPermutationBinary permutationBinary;
+      bool bOldVersion = false;
+      EZ_TEST_BOOL(permutationBinary.Read(reader, bOldVersion).Succeeded());
+
+      bool bFoundInclude = false;
+      for (const ezString& sDependency : permutationBinary.m_DependencyFile.GetFileDependencies())
+      {
+        bFoundInclude |= sDependency.EndsWith("ShaderCompilerTestCommon.h");
+      }
+      EZ_TEST_BOOL(bFoundInclude);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Compile permutations")
+  {
+    // every permutation has a different pixel shader
+    const ezUInt32 uiNumPermutationVars = 7;
+    ezShaderCompilerTestStub::s_uiWorkIterations = 200;
+
+    ezPermutationGenerator permutations;
+    CreatePermutations(uiNumPermutationVars, permutations);
+
+    // the salt makes the sources different from the previous run, otherwise the compiled stages would be found in the cache
+    WriteShader(":shadertest/ShaderCompilerTest/Test.ezShader", ":shadertest/ShaderCompilerTest/ShaderCompilerTestCommon.h",
+      uiNumPermutationVars, 1);
+
+    ezShaderManager::Configure("TESTSTUB", false, ":shadertest/ShaderCompilerTest/CacheOneByOne", sPrevPermVarDir);
+    ezShaderCompilerTestStub::s_iNumCompiledStages = 0;
+
+    ezStopwatch sw;
+    EZ_TEST_BOOL(CompileOneByOne(szShaderFile, permutations).Succeeded());
+    const ezTime tOneByOne = sw.GetRunningTotal();
+    const ezInt32 iNumCompiledOneByOne = ezShaderCompilerTestStub::s_iNumCompiledStages;
+
+    WriteShader(":shadertest/ShaderCompilerTest/Test.ezShader", ":shadertest/ShaderCompilerTest/ShaderCompilerTestCommon.h",
+      uiNumPermutationVars, 2);
+
+    ezShaderManager::Configure("TESTSTUB", false, ":shadertest/ShaderCompilerTest/CacheBatched", sPrevPermVarDir);
+    ezShaderCompilerTestStub::s_iNumCompiledStages = 0;
+
+    sw.StopAndReset();
+    sw.Resume();
+    {
+      ezShaderCompiler sc;
+      EZ_TEST_BOOL(sc.CompileShaderPermutationsForPlatforms(szShaderFile, permutations, ezLog::GetThreadLocalLogSystem(), "TESTSTUB").Succeeded());
+    }
+    const ezTime tBatched = sw.GetRunningTotal();
+    const ezInt32 iNumCompiledBatched = ezShaderCompilerTestStub::s_iNumCompiledStages;
+
+    EZ_TEST_INT(iNumCompiledOneByOne, iNumCompiledBatched);
+    EZ_TEST_INT(iNumCompiledBatched, 2 + permutations.GetPermutationCount() / 2);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%u permutations, %i stage compiles, one by one: %.1fms, batched: %.1fms",
+      permutations.GetPermutationCount(), iNumCompiledBatched, tOneByOne.GetMilliseconds(), tBatched.GetMilliseconds());
+
+    ezShaderCompilerTestStub::s_uiWorkIterations = 1;
+  }
+
+  ezShaderManager::Configure(sPrevPlatform, bPrevRuntimeCompilation, sPrevCacheDir, sPrevPermVarDir);
+  ezFileSystem::RemoveDataDirectoryGroup("ShaderCompilerTest");
+}
@@ -61,12 +61,21 @@ namespace
     virtual void SerializeComponent(ezWorldWriter& stream) const override {}
     virtual void DeserializeComponent(ezWorldReader& stream) override {}
 
-    void OnTestMessage(TestMessage1& msg) { m_iSomeData += msg.m_iValue; }
+    void OnTestMessage(TestMessage1& msg)
+    {
+      m_iSomeData += msg.m_iValue;
+      m_ReceivedValues.PushBack(msg.m_iValue);
+    }
 
-    void OnTestMessage2(TestMessage2& msg) { m_iSomeData2 += 2 * msg.m_iValue; }
+    void OnTestMessage2(TestMessage2& msg)
+    {
+      m_iSomeData2 += 2 * msg.m_iValue;
+      m_ReceivedValues.PushBack(msg.m_iValue);
+    }
 
     ezInt32 m_iSomeData;
     ezInt32 m_iSomeData2;
+    ezDynamicArray<ezInt32> m_ReceivedValues;
   };
 
   // clang-format off
@@ -82,6 +91,33 @@ namespace
   EZ_END_COMPONENT_TYPE;
   // clang-format on
 
+  class TestComponentUnhandledMsg;
+  typedef ezComponentManager<TestComponentUnhandledMsg, ezBlockStorageType::FreeList> TestComponentUnhandledMsgManager;
+
+  class TestComponentUnhandledMsg : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(TestComponentUnhandledMsg, ezComponent, TestComponentUnhandledMsgManager);
+
+  public:
+    virtual void SerializeComponent(ezWorldWriter& stream) const override {}
+    virtual void DeserializeComponent(ezWorldReader& stream) override {}
+
+    virtual void Initialize() override { EnableUnhandledMessageHandler(true); }
+
+    virtual bool OnUnhandledMessage(ezMessage& msg, bool bWasPostedMsg) override
+    {
+      ++m_uiNumUnhandledMessages;
+      return true;
+    }
+
+    ezUInt32 m_uiNumUnhandledMessages = 0;
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(TestComponentUnhandledMsg, 1, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE;
+  // clang-format on
+
   void ResetComponents(ezGameObject& object)
   {
     TestComponentMsg* pComponent = nullptr;
@@ -89,6 +125,7 @@ namespace
     {
       pComponent->m_iSomeData = 1;
       pComponent->m_iSomeData2 = 2;
+      pComponent->m_ReceivedValues.Clear();
     }
 
     for (auto it = object.GetChildren(); it.IsValid(); ++it)
@@ -175,6 +212,69 @@ EZ_CREATE_SIMPLE_TEST(World, Messaging)
     }
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Message Handler Masks")
+  {
+    // a chain of objects without any components
+    ezGameObjectDesc chainDesc;
+    ezGameObject* pChain[6];
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(pChain); ++i)
+    {
+      world.CreateObject(chainDesc, pChain[i]);
+      chainDesc.m_hParent = pChain[i]->GetHandle();
+    }
+
+    TestMessage1 msg;
+    msg.m_iValue = 3;
+    EZ_TEST_BOOL(!pChain[0]->SendMessageRecursive(msg));
+
+    // a component that is added to the leaf later on must be reached
+    TestComponentMsg* pLeafComponent = nullptr;
+    pManager->CreateComponent(pChain[5], pLeafComponent);
+    world.Update();
+
+    EZ_TEST_BOOL(pChain[0]->SendMessageRecursive(msg));
+    EZ_TEST_INT(pLeafComponent->m_iSomeData, 4);
+
+    // same for components that are moved into the chain with their owner
+    pParents[1]->SetParent(pChain[3]->GetHandle());
+    ResetComponents(*pRoot);
+    ResetComponents(*pChain[0]);
+
+    EZ_TEST_BOOL(pChain[0]->SendMessageRecursive(msg));
+    EZ_TEST_INT(pLeafComponent->m_iSomeData, 4);
+
+    TestComponentMsg* pComponent2 = nullptr;
+    pParents[1]->TryGetComponentOfBaseType(pComponent2);
+    EZ_TEST_INT(pComponent2->m_iSomeData, 4);
+    for (auto it = pParents[1]->GetChildren(); it.IsValid(); ++it)
+    {
+      it->TryGetComponentOfBaseType(pComponent2);
+      EZ_TEST_INT(pComponent2->m_iSomeData, 4);
+    }
+
+    pRoot->TryGetComponentOfBaseType(pComponent2);
+    EZ_TEST_INT(pComponent2->m_iSomeData, 1);
+
+    pParents[1]->SetParent(pRoot->GetHandle());
+
+    // removed components must not receive anything anymore
+    pManager->DeleteComponent(pLeafComponent->GetHandle());
+    EZ_TEST_BOOL(!pChain[5]->SendMessage(msg));
+    EZ_TEST_BOOL(!pChain[2]->SendMessageRecursive(msg));
+
+    // components that enable the unhandled message handler after they were added have to receive all messages
+    TestComponentUnhandledMsgManager* pUnhandledManager = world.GetOrCreateComponentManager<TestComponentUnhandledMsgManager>();
+    TestComponentUnhandledMsg* pUnhandledComponent = nullptr;
+    pUnhandledManager->CreateComponent(pChain[4], pUnhandledComponent);
+    world.Update();
+
+    EZ_TEST_BOOL(pChain[0]->SendMessageRecursive(msg));
+    EZ_TEST_BOOL(pChain[4]->SendMessage(msg));
+    EZ_TEST_INT(pUnhandledComponent->m_uiNumUnhandledMessages, 2);
+
+    world.DeleteObjectNow(pChain[0]->GetHandle());
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Queuing")
   {
     ResetComponents(*pRoot);
@@ -235,4 +335,68 @@ EZ_CREATE_SIMPLE_TEST(World, Messaging)
 
     ezFrameAllocator::Reset();
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Queuing with delay order")
+  {
+    ResetComponents(*pRoot);
+
+    TestComponentMsg* pComponent = nullptr;
+    pRoot->TryGetComponentOfBaseType(pComponent);
+
+    // Every delay is used by one TestMessage1 (values below uiNumDelays) and one TestMessage2 (values from uiNumDelays on).
+    // Delays of up to 20 seconds do not fit into the timing wheel of the world and are kept in its far future heap at first.
+    const ezUInt32 uiNumDelays = 500;
+    auto getDelay = [=](ezInt32 iValue) { return ezTime::Seconds(((iValue * 7919) % uiNumDelays) * 0.04 + 0.005); };
+    auto getSortingKey = [=](ezInt32 iValue) { return iValue < (ezInt32)uiNumDelays ? 0 : 2; };
+
+    const ezTime startTime = world.GetClock().GetAccumulatedTime();
+
+    // post in reverse, so that the sorting key and not the posting order decides about messages with equal due time
+    for (ezInt32 i = uiNumDelays * 2 - 1; i >= 0; --i)
+    {
+      if (i < (ezInt32)uiNumDelays)
+      {
+        TestMessage1 msg;
+        msg.m_iValue = i;
+        pRoot->PostMessage(msg, ezObjectMsgQueueType::NextFrame, getDelay(i));
+      }
+      else
+      {
+        TestMessage2 msg2;
+        msg2.m_iValue = i;
+        pRoot->PostMessage(msg2, ezObjectMsgQueueType::NextFrame, getDelay(i));
+      }
+    }
+
+    world.GetClock().SetFixedTimeStep(ezTime::Seconds(0.1));
+
+    for (ezUInt32 uiFrame = 0; uiFrame < 205; ++uiFrame)
+    {
+      world.Update();
+
+      const ezTime elapsed = world.GetClock().GetAccumulatedTime() - startTime;
+
+      ezUInt32 uiExpectedCount = 0;
+      for (ezInt32 i = 0; i < (ezInt32)uiNumDelays * 2; ++i)
+      {
+        if (getDelay(i) <= elapsed)
+          ++uiExpectedCount;
+      }
+
+      EZ_TEST_INT(pComponent->m_ReceivedValues.GetCount(), uiExpectedCount);
+    }
+
+    EZ_TEST_INT(pComponent->m_ReceivedValues.GetCount(), uiNumDelays * 2);
+
+    for (ezUInt32 i = 1; i < pComponent->m_ReceivedValues.GetCount(); ++i)
+    {
+      const ezInt32 iPrev = pComponent->m_ReceivedValues[i - 1];
+      const ezInt32 iCur = pComponent->m_ReceivedValues[i];
+
+      const bool bOrdered = getDelay(iPrev) < getDelay(iCur) || (getDelay(iPrev) == getDelay(iCur) && getSortingKey(iPrev) < getSortingKey(iCur));
+      EZ_TEST_BOOL(bOrdered);
+    }
+
+    ezFrameAllocator::Reset();
+  }
 }
@@ -207,6 +207,60 @@ EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
     }
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindVisibleObjects")
+  {
+    ezFrustum frustum;
+    frustum.SetFrustum(ezVec3(-5000.0f, 0.0f, 0.0f), ezVec3(1.0f, 0.0f, 0.0f), ezVec3(0.0f, 0.0f, 1.0f), ezAngle::Degree(90.0f), ezAngle::Degree(90.0f), 1.0f, 10000.0f);
+
+    ezDynamicArray<const ezGameObject*> visibleObjects;
+    ezSpatialSystem::QueryStats stats;
+    world.GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, visibleObjects, &stats);
+
+    EZ_TEST_BOOL(!visibleObjects.IsEmpty());
+    EZ_TEST_INT(stats.m_uiNumObjectsOccluded, 0);
+
+    // everything that is completely above the ground is hidden, this is true for whole cells as well
+    ezUInt32 uiNumOcclusionTests = 0;
+    auto isOccluded = [&](const ezSimdBBox& box) {
+      ++uiNumOcclusionTests;
+      return box.m_Min.y() > 0.0f;
+    };
+
+    ezDynamicArray<const ezGameObject*> unoccludedObjects;
+    ezSpatialSystem::QueryStats occlusionStats;
+    world.GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, unoccludedObjects, &occlusionStats, isOccluded);
+
+    EZ_TEST_BOOL(uiNumOcclusionTests > 0);
+
+    ezHashSet<const ezGameObject*> uniqueObjects;
+    for (auto pObject : unoccludedObjects)
+    {
+      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+      EZ_TEST_BOOL(pObject->GetGlobalBounds().GetBox().m_vMin.y <= 0.0f);
+    }
+
+    ezUInt32 uiNumOccluded = 0;
+    for (auto pObject : visibleObjects)
+    {
+      if (pObject->GetGlobalBounds().GetBox().m_vMin.y <= 0.0f)
+      {
+        EZ_TEST_BOOL(uniqueObjects.Contains(pObject));
+      }
+      else
+      {
+        ++uiNumOccluded;
+      }
+    }
+
+    EZ_TEST_INT(unoccludedObjects.GetCount() + uiNumOccluded, visibleObjects.GetCount());
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    // objects in hidden cells are counted as well, even if they are outside of the frustum
+    EZ_TEST_BOOL(occlusionStats.m_uiNumObjectsOccluded >= uiNumOccluded);
+    EZ_TEST_INT(occlusionStats.m_uiNumObjectsPassed, unoccludedObjects.GetCount());
+#endif
+  }
+
   if (false)
   {
     ezStringBuilder outputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
@@ -1,6 +1,10 @@
 #include <CoreTestPCH.h>
 
+#include <Core/Messages/UpdateLocalBoundsMessage.h>
 #include <Core/World/World.h>
+#include <Core/WorldSerializer/WorldReader.h>
+#include <Core/WorldSerializer/WorldWriter.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Time/Stopwatch.h>
 
@@ -56,6 +60,53 @@ namespace
   EZ_END_COMPONENT_TYPE;
   // clang-format on
 
+  class ezTestStaticComponent;
+  typedef ezComponentManager<ezTestStaticComponent, ezBlockStorageType::Compact> ezTestStaticComponentManager;
+
+  class ezTestStaticComponent : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ezTestStaticComponent, ezComponent, ezTestStaticComponentManager);
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(ezTestStaticComponent, 1, ezComponentMode::Static);
+  EZ_END_COMPONENT_TYPE;
+  // clang-format on
+
+  class ezTestBoundsComponent;
+  typedef ezComponentManager<ezTestBoundsComponent, ezBlockStorageType::FreeList> ezTestBoundsComponentManager;
+
+  class ezTestBoundsComponent : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ezTestBoundsComponent, ezComponent, ezTestBoundsComponentManager);
+
+  public:
+    void OnUpdateLocalBounds(ezMsgUpdateLocalBounds& msg) { msg.AddBounds(ezBoundingSphere(ezVec3::ZeroVector(), 1.0f), ezInvalidSpatialDataCategory); }
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(ezTestBoundsComponent, 1, ezComponentMode::Dynamic)
+  {
+    EZ_BEGIN_MESSAGEHANDLERS
+    {
+      EZ_MESSAGE_HANDLER(ezMsgUpdateLocalBounds, OnUpdateLocalBounds),
+    }
+    EZ_END_MESSAGEHANDLERS;
+  }
+  EZ_END_COMPONENT_TYPE;
+  // clang-format on
+
+  struct ezTestTimedMessage : public ezMessage
+  {
+    EZ_DECLARE_MESSAGE_TYPE(ezTestTimedMessage, ezMessage);
+  };
+
+  // clang-format off
+  EZ_IMPLEMENT_MESSAGE_TYPE(ezTestTimedMessage);
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezTestTimedMessage, 1, ezRTTIDefaultAllocator<ezTestTimedMessage>)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
+  // clang-format on
+
   void AddObjectsToWorld(ezWorld& world, bool bDynamic, ezUInt32 uiNumObjects, ezUInt32 uiTreeLevelNumNodeDiv, ezUInt32 uiTreeDepth, ezInt32 iAttachCompsDepth,
                        ezGameObjectHandle hParent = ezGameObjectHandle())
   {
@@ -114,18 +165,247 @@ namespace
     }
   }
 
-} // namespace
+  void AddBoundsComponentsRecursive(ezWorld& world, ezGameObject* pObject)
+  {
+    ezTestBoundsComponent* pComponent = nullptr;
+    world.GetOrCreateComponentManager<ezTestBoundsComponentManager>()->CreateComponent(pObject, pComponent);
+
+    for (auto it = pObject->GetChildren(); it.IsValid(); ++it)
+    {
+      AddBoundsComponentsRecursive(world, it);
+    }
+  }
+
+  void MeasureRecursiveMessage(ezUInt32 uiNumHandlingSubTrees)
+  {
+    ezWorldDesc worldDesc("Test");
+    ezWorld world(worldDesc);
+
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezGameObjectDesc gd;
+    gd.m_bDynamic = true;
+    ezGameObject* pRoot = nullptr;
+    world.CreateObject(gd, pRoot);
+
+    // every object has a component that does not handle the message
+    AddObjectsToWorld(world, true, 10, 1, 5, 5, pRoot->GetHandle());
+
+    ezUInt32 uiSubTree = 0;
+    for (auto it = pRoot->GetChildren(); it.IsValid() && uiSubTree < uiNumHandlingSubTrees; ++it, ++uiSubTree)
+    {
+      AddBoundsComponentsRecursive(world, it);
+    }
+
+    // initialize the components
+    world.Update();
+
+    ezStopwatch sw;
+
+    const ezUInt32 uiNumSends = 100;
+    for (ezUInt32 i = 0; i < uiNumSends; ++i)
+    {
+      ezMsgUpdateLocalBounds msg;
+      pRoot->SendMessageRecursive(msg);
+    }
+
+    const ezTime tDiff = sw.Checkpoint();
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Sending a message recursively to %u objects, %u of 10 sub-trees handle it: %.3fms",
+      world.GetObjectCount(), uiNumHandlingSubTrees, tDiff.GetMilliseconds() / uiNumSends);
+  }
+
+  void MeasureTimedMessageUpdate(ezUInt32 uiNumMessages)
+  {
+    ezWorldDesc worldDesc("Test");
+    ezWorld world(worldDesc);
+
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezGameObjectDesc gd;
+    ezGameObject* pObject = nullptr;
+    world.CreateObject(gd, pObject);
+
+    ezStopwatch sw;
+
+    // spread the messages over 100 seconds, so that every frame only a small fraction of them is due
+    ezTestTimedMessage msg;
+    for (ezUInt32 i = 0; i < uiNumMessages; ++i)
+    {
+      const ezUInt32 uiDelayInMs = (i * 7919) % 100000;
+      pObject->PostMessage(msg, ezObjectMsgQueueType::NextFrame, ezTime::Milliseconds(uiDelayInMs));
+    }
+
+    const ezTime tPost = sw.Checkpoint();
+
+    world.GetClock().SetFixedTimeStep(ezTime::Seconds(1.0 / 60.0));
+
+    // the first update moves all messages into the scheduler
+    world.Update();
+    const ezTime tFirstUpdate = sw.Checkpoint();
+
+    const ezUInt32 uiNumFrames = 60;
+    for (ezUInt32 i = 0; i < uiNumFrames; ++i)
+    {
+      world.Update();
+    }
+
+    const ezTime tUpdate = sw.Checkpoint();
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%u pending timed messages: posting %.2fms, first update %.2fms, update %.3fms per frame",
+      uiNumMessages, tPost.GetMilliseconds(), tFirstUpdate.GetMilliseconds(), tUpdate.GetMilliseconds() / uiNumFrames);
+  }
+
+
+  void ReadPrefab(ezWorldReader& worldReader)
+  {
+    ezMemoryStreamStorage storage;
+
+    {
+      ezWorldDesc worldDesc("Prefab");
+      ezWorld world(worldDesc);
+
+      EZ_LOCK(world.GetWriteMarker());
+
+      // a root with 8 children, each object with one component
+      ezGameObjectDesc gd;
+      gd.m_bDynamic = true;
+      ezGameObject* pRoot = nullptr;
+      world.CreateObject(gd, pRoot);
+
+      ezTestComponent* pComponent = nullptr;
+      world.GetOrCreateComponentManager<ezTestComponentManager>()->CreateComponent(pRoot, pComponent);
+
+      AddObjectsToWorld(world, true, 8, 1, 1, 1, pRoot->GetHandle());
 
+      ezMemoryStreamWriter writer(&storage);
+      ezWorldWriter worldWriter;
+      worldWriter.WriteWorld(writer, world);
+    }
+
+    ezMemoryStreamReader reader(&storage);
+    worldReader.ReadWorldDescription(reader).IgnoreResult();
+  }
+
+  void MeasurePrefabSpawning(ezWorldReader& worldReader, ezUInt32 uiNumSpawns, bool bBatch)
+  {
+    ezWorldDesc worldDesc("Test");
+    ezWorld world(worldDesc);
+
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezDynamicArray<ezTransform> rootTransforms;
+    rootTransforms.SetCountUninitialized(uiNumSpawns);
+    for (ezUInt32 i = 0; i < uiNumSpawns; ++i)
+    {
+      rootTransforms[i] = ezTransform(ezVec3((float)(i % 100), (float)(i / 100), 0));
+    }
+
+    ezStopwatch sw;
+
+    if (bBatch)
+    {
+      worldReader.InstantiatePrefabBatch(world, rootTransforms, ezGameObjectHandle(), nullptr, nullptr, nullptr, false);
+    }
+    else
+    {
+      for (const ezTransform& rootTransform : rootTransforms)
+      {
+        worldReader.InstantiatePrefab(world, rootTransform, ezGameObjectHandle(), nullptr, nullptr, nullptr, false);
+      }
+    }
+
+    // components are initialized in the update
+    world.Update();
+
+    const ezTime tDiff = sw.Checkpoint();
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Spawning %u prefabs with %u objects (%s): %.2fms, %.0f spawns/s", uiNumSpawns,
+      world.GetObjectCount(), bBatch ? "batch" : "single", tDiff.GetMilliseconds(), uiNumSpawns / tDiff.GetSeconds());
+  }
+
+
+  void MeasureCreateAndDelete(bool bBulk)
+  {
+    ezWorldDesc worldDesc("Test");
+    ezWorld world(worldDesc);
+
+    EZ_LOCK(world.GetWriteMarker());
+
+    // use static objects and components without update function, so that the update mostly consists of the dead object deletion
+    ezTestStaticComponentManager* pManager = world.GetOrCreateComponentManager<ezTestStaticComponentManager>();
+
+    // 100,000 objects per second at 60 fps, every object lives for one second
+    const ezUInt32 uiNumFrames = 120;
+    const ezUInt32 uiLifeTimeInFrames = 60;
+    const ezUInt32 uiObjectsPerFrame = 1667;
+
+    ezDynamicArray<ezGameObjectDesc> descs;
+    descs.SetCount(uiObjectsPerFrame);
+    for (ezUInt32 i = 0; i < uiObjectsPerFrame; ++i)
+    {
+      descs[i].m_LocalPosition.Set((float)i, 0, 0);
+    }
+
+    ezDynamicArray<ezGameObjectHandle> spawnedObjects[uiLifeTimeInFrames];
+    ezDynamicArray<ezGameObject*> objects;
+
+    ezTime tCreateDelete;
+    ezTime tUpdate;
+    ezStopwatch sw;
+
+    for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+    {
+      ezDynamicArray<ezGameObjectHandle>& handles = spawnedObjects[uiFrame % uiLifeTimeInFrames];
+
+      if (bBulk)
+      {
+        world.DeleteObjectsNow(handles);
+        handles.Clear();
+        objects.Clear();
+
+        world.CreateObjects(descs, &handles, &objects);
+      }
+      else
+      {
+        for (const ezGameObjectHandle& hObject : handles)
+        {
+          world.DeleteObjectNow(hObject);
+        }
+        handles.Clear();
+        objects.Clear();
+
+        for (const ezGameObjectDesc& desc : descs)
+        {
+          ezGameObject* pObject = nullptr;
+          handles.PushBack(world.CreateObject(desc, pObject));
+          objects.PushBack(pObject);
+        }
+      }
+
+      for (ezGameObject* pObject : objects)
+      {
+        ezTestStaticComponent* pComponent = nullptr;
+        pManager->CreateComponent(pObject, pComponent);
+      }
+
+      tCreateDelete += sw.Checkpoint();
+
+      world.Update();
+
+      tUpdate += sw.Checkpoint();
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Creating and deleting %u objects with components per frame (%s): %.3fms, update %.3fms per frame",
+      uiObjectsPerFrame, bBulk ? "bulk" : "single", tCreateDelete.GetMilliseconds() / uiNumFrames, tUpdate.GetMilliseconds() / uiNumFrames);
+  }
+
+} // namespace
 
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
-static const ezTestBlock::Enum EnableInRelease = ezTestBlock::DisabledNoWarning;
-#else
-static const ezTestBlock::Enum EnableInRelease = ezTestBlock::Enabled;
-#endif
 
 EZ_CREATE_SIMPLE_TEST(World, Profile_Creation)
 {
-  EZ_TEST_BLOCK(EnableInRelease, "Create many objects")
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Create many objects")
   {
     // it makes no difference whether we create static or dynamic objects
     static bool bDynamic = true;
@@ -145,7 +425,7 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Creation)
 
 EZ_CREATE_SIMPLE_TEST(World, Profile_Deletion)
 {
-  EZ_TEST_BLOCK(EnableInRelease, "Delete many objects")
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Delete many objects")
   {
     ezWorldDesc worldDesc("Test");
     ezWorld world(worldDesc);
@@ -164,9 +444,18 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Deletion)
   }
 }
 
+EZ_CREATE_SIMPLE_TEST(World, Profile_CreateDelete)
+{
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Create and delete 100,000 objects per second")
+  {
+    MeasureCreateAndDelete(false);
+    MeasureCreateAndDelete(true);
+  }
+}
+
 EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
 {
-  EZ_TEST_BLOCK(EnableInRelease, "Update 1,000,000 static objects")
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Update 1,000,000 static objects")
   {
     ezWorldDesc worldDesc("Test");
     ezWorld world(worldDesc);
@@ -186,7 +475,7 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 
-  EZ_TEST_BLOCK(EnableInRelease, "Update 100,000 dynamic objects")
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Update 100,000 dynamic objects")
   {
     ezWorldDesc worldDesc("Test");
     ezWorld world(worldDesc);
@@ -206,7 +495,7 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 
-  EZ_TEST_BLOCK(EnableInRelease, "Update 100,000 dynamic objects with components")
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Update 100,000 dynamic objects with components")
   {
     ezWorldDesc worldDesc("Test");
     ezWorld world(worldDesc);
@@ -226,7 +515,7 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 
-  EZ_TEST_BLOCK(EnableInRelease, "Update 250,000 dynamic objects")
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Update 250,000 dynamic objects")
   {
     ezWorldDesc worldDesc("Test");
     ezWorld world(worldDesc);
@@ -246,7 +535,7 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 
-  EZ_TEST_BLOCK(EnableInRelease, "MT Update 250,000 dynamic objects")
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "MT Update 250,000 dynamic objects")
   {
     ezWorldDesc worldDesc("Test");
     worldDesc.m_bAutoCreateSpatialSystem = false; // allows multi-threaded update
@@ -267,7 +556,7 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 
-  EZ_TEST_BLOCK(EnableInRelease, "MT Update 1,000,000 dynamic objects")
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "MT Update 1,000,000 dynamic objects")
   {
     ezWorldDesc worldDesc("Test");
     worldDesc.m_bAutoCreateSpatialSystem = false; // allows multi-threaded update
@@ -288,3 +577,38 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_TimedMessages)
+{
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Update with many pending timed messages")
+  {
+    MeasureTimedMessageUpdate(10000);
+    MeasureTimedMessageUpdate(100000);
+    MeasureTimedMessageUpdate(1000000);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_RecursiveMessages)
+{
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Send message recursively to 111,111 objects")
+  {
+    MeasureRecursiveMessage(0);
+    MeasureRecursiveMessage(1);
+    MeasureRecursiveMessage(10);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_PrefabSpawning)
+{
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Spawn prefabs")
+  {
+    ezWorldReader worldReader;
+    ReadPrefab(worldReader);
+
+    for (ezUInt32 uiNumSpawns : {1000, 10000})
+    {
+      MeasurePrefabSpawning(worldReader, uiNumSpawns, false);
+      MeasurePrefabSpawning(worldReader, uiNumSpawns, true);
+    }
+  }
+}
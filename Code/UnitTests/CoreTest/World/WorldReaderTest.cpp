@@ -0,0 +1,202 @@
+#include <CoreTestPCH.h>
+
+#include <Core/WorldSerializer/WorldReader.h>
+#include <Core/WorldSerializer/WorldWriter.h>
+#include <Foundation/IO/MemoryStream.h>
+
+namespace
+{
+  class TestComponentSerialized;
+  typedef ezComponentManager<TestComponentSerialized, ezBlockStorageType::FreeList> TestComponentSerializedManager;
+
+  class TestComponentSerialized : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(TestComponentSerialized, ezComponent, TestComponentSerializedManager);
+
+  public:
+    virtual void SerializeComponent(ezWorldWriter& stream) const override
+    {
+      stream.GetStream() << m_iValue;
+      stream.WriteGameObjectHandle(m_hTarget);
+    }
+
+    virtual void DeserializeComponent(ezWorldReader& stream) override
+    {
+      stream.GetStream() >> m_iValue;
+      m_hTarget = stream.ReadGameObjectHandle();
+    }
+
+    virtual void Initialize() override { ++m_uiNumInitialized; }
+
+    ezInt32 m_iValue = 0;
+    ezGameObjectHandle m_hTarget;
+    ezUInt32 m_uiNumInitialized = 0;
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(TestComponentSerialized, 1, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE;
+  // clang-format on
+
+  void CreatePrefabSource(ezWorld& world)
+  {
+    EZ_LOCK(world.GetWriteMarker());
+
+    TestComponentSerializedManager* pManager = world.GetOrCreateComponentManager<TestComponentSerializedManager>();
+
+    ezGameObjectDesc desc;
+    desc.m_sName.Assign("Root");
+    desc.m_LocalPosition.Set(1, 2, 3);
+    ezGameObject* pRoot = nullptr;
+    world.CreateObject(desc, pRoot);
+
+    desc.m_sName.Assign("Child");
+    desc.m_hParent = pRoot->GetHandle();
+    desc.m_LocalPosition.Set(0, 0, 5);
+    ezGameObject* pChild = nullptr;
+    world.CreateObject(desc, pChild);
+
+    TestComponentSerialized* pComponent = nullptr;
+    pManager->CreateComponent(pRoot, pComponent);
+    pComponent->m_iValue = 7;
+    pComponent->m_hTarget = pChild->GetHandle();
+
+    pManager->CreateComponent(pChild, pComponent);
+    pComponent->m_iValue = 11;
+    pComponent->m_hTarget = pRoot->GetHandle();
+  }
+
+  void CheckInstance(ezGameObject* pRoot, ezGameObject* pChild, const ezTransform& rootTransform)
+  {
+    EZ_TEST_STRING(pRoot->GetName(), "Root");
+    EZ_TEST_STRING(pChild->GetName(), "Child");
+    EZ_TEST_BOOL(pChild->GetParent() == pRoot);
+    EZ_TEST_VEC3(pRoot->GetGlobalPosition(), rootTransform.TransformPosition(ezVec3(1, 2, 3)), 0.0001f);
+    EZ_TEST_VEC3(pChild->GetGlobalPosition(), rootTransform.TransformPosition(ezVec3(1, 2, 8)), 0.0001f);
+
+    TestComponentSerialized* pRootComponent = nullptr;
+    TestComponentSerialized* pChildComponent = nullptr;
+    EZ_TEST_BOOL(pRoot->TryGetComponentOfBaseType(pRootComponent));
+    EZ_TEST_BOOL(pChild->TryGetComponentOfBaseType(pChildComponent));
+    if (pRootComponent == nullptr || pChildComponent == nullptr)
+      return;
+
+    EZ_TEST_INT(pRootComponent->m_iValue, 7);
+    EZ_TEST_INT(pChildComponent->m_iValue, 11);
+
+    // handles must be remapped to the objects of the same instance
+    EZ_TEST_BOOL(pRootComponent->m_hTarget == pChild->GetHandle());
+    EZ_TEST_BOOL(pChildComponent->m_hTarget == pRoot->GetHandle());
+
+    EZ_TEST_INT(pRootComponent->m_uiNumInitialized, 1);
+    EZ_TEST_INT(pChildComponent->m_uiNumInitialized, 1);
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(World, WorldReader)
+{
+  ezMemoryStreamStorage storage;
+
+  {
+    ezWorldDesc worldDesc("Source");
+    ezWorld world(worldDesc);
+    CreatePrefabSource(world);
+
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezMemoryStreamWriter writer(&storage);
+    ezWorldWriter worldWriter;
+    worldWriter.WriteWorld(writer, world);
+  }
+
+  ezWorldReader worldReader;
+  {
+    ezMemoryStreamReader reader(&storage);
+    EZ_TEST_BOOL(worldReader.ReadWorldDescription(reader).Succeeded());
+  }
+
+  EZ_TEST_INT(worldReader.GetRootObjectCount(), 1);
+  EZ_TEST_INT(worldReader.GetChildObjectCount(), 1);
+
+  ezWorldDesc worldDesc("Target");
+  ezWorld world(worldDesc);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "InstantiatePrefab")
+  {
+    const ezTransform rootTransform(ezVec3(10, 0, 0));
+
+    ezHybridArray<ezGameObject*, 8> roots;
+    ezHybridArray<ezGameObject*, 8> children;
+
+    EZ_LOCK(world.GetWriteMarker());
+    worldReader.InstantiatePrefab(world, rootTransform, ezGameObjectHandle(), &roots, &children, nullptr, false);
+    world.Update();
+
+    EZ_TEST_INT(roots.GetCount(), 1);
+    EZ_TEST_INT(children.GetCount(), 1);
+    if (roots.GetCount() == 1 && children.GetCount() == 1)
+    {
+      CheckInstance(roots[0], children[0], rootTransform);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "InstantiatePrefabBatch")
+  {
+    ezDynamicArray<ezTransform> rootTransforms;
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      rootTransforms.PushBack(ezTransform(ezVec3(0, (float)i, 0)));
+    }
+
+    ezDynamicArray<ezGameObject*> roots;
+    ezDynamicArray<ezGameObject*> children;
+
+    EZ_LOCK(world.GetWriteMarker());
+    const ezUInt32 uiNumObjectsBefore = world.GetObjectCount();
+
+    worldReader.InstantiatePrefabBatch(world, rootTransforms, ezGameObjectHandle(), &roots, &children, nullptr, false);
+    world.Update();
+
+    EZ_TEST_INT(world.GetObjectCount(), uiNumObjectsBefore + 32);
+
+    EZ_TEST_INT(roots.GetCount(), 16);
+    EZ_TEST_INT(children.GetCount(), 16);
+    if (roots.GetCount() == 16 && children.GetCount() == 16)
+    {
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        CheckInstance(roots[i], children[i], rootTransforms[i]);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "InstantiatePrefabBatch with parent and team")
+  {
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezGameObjectDesc desc;
+    desc.m_LocalPosition.Set(0, 0, 100);
+    ezGameObject* pParent = nullptr;
+    world.CreateObject(desc, pParent);
+
+    const ezTransform rootTransforms[] = {ezTransform(ezVec3(1, 0, 0)), ezTransform(ezVec3(2, 0, 0))};
+    const ezUInt16 uiTeamID = 5;
+
+    ezDynamicArray<ezGameObject*> roots;
+    worldReader.InstantiatePrefabBatch(world, ezMakeArrayPtr(rootTransforms), pParent->GetHandle(), &roots, nullptr, &uiTeamID, false);
+    world.Update();
+
+    EZ_TEST_INT(pParent->GetChildCount(), 2);
+
+    EZ_TEST_INT(roots.GetCount(), 2);
+    if (roots.GetCount() == 2)
+    {
+      for (ezUInt32 i = 0; i < 2; ++i)
+      {
+        EZ_TEST_BOOL(roots[i]->GetParent() == pParent);
+        EZ_TEST_INT(roots[i]->GetTeamID(), uiTeamID);
+        EZ_TEST_VEC3(roots[i]->GetGlobalPosition(), ezVec3(2.0f + i, 2, 103), 0.0001f);
+      }
+    }
+  }
+}
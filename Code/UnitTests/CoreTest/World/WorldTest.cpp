@@ -640,4 +640,170 @@ EZ_CREATE_SIMPLE_TEST(World, World)
       EZ_TEST_BOOL(pObjects[i]->IsActive() == (i < iTopDisabled));
     }
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Bulk create and delete")
+  {
+    ezWorldDesc worldDesc("Test");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    const ezUInt32 uiNumParents = 2000;
+
+    ezDynamicArray<ezGameObjectDesc> descs;
+    descs.SetCount(uiNumParents);
+    for (ezUInt32 i = 0; i < uiNumParents; ++i)
+    {
+      ezStringBuilder sName;
+      sName.Format("{}", i);
+      descs[i].m_sName.Assign(sName.GetData());
+      descs[i].m_bDynamic = (i % 3) == 0;
+      descs[i].m_LocalPosition.Set((float)i, 0, 0);
+    }
+
+    ezDynamicArray<ezGameObjectHandle> parents;
+    ezDynamicArray<ezGameObject*> parentObjects;
+    world.CreateObjects(descs, &parents, &parentObjects);
+
+    EZ_TEST_INT(parents.GetCount(), uiNumParents);
+    EZ_TEST_INT(parentObjects.GetCount(), uiNumParents);
+    EZ_TEST_INT(world.GetObjectCount(), uiNumParents);
+
+    // one child for every parent
+    for (ezUInt32 i = 0; i < uiNumParents; ++i)
+    {
+      descs[i].m_hParent = parents[i];
+      descs[i].m_LocalPosition.Set(0, 1, 0);
+    }
+
+    ezDynamicArray<ezGameObjectHandle> children;
+    world.CreateObjects(descs, &children);
+
+    EZ_TEST_INT(world.GetObjectCount(), uiNumParents * 2);
+
+    for (ezUInt32 i = 0; i < uiNumParents; ++i)
+    {
+      ezGameObject* pChild = nullptr;
+      EZ_TEST_BOOL(world.TryGetObject(children[i], pChild));
+      EZ_TEST_BOOL(pChild->GetParent() == parentObjects[i]);
+      EZ_TEST_VEC3(pChild->GetGlobalPosition(), ezVec3((float)i, 1, 0), 0);
+      ezGameObjectTest::TestInternals(pChild, parentObjects[i], 1);
+    }
+
+    // delete objects scattered over all storage blocks, so that the storage has to move dead objects during compaction
+    ezDynamicArray<ezGameObjectHandle> objectsToDelete;
+    for (ezUInt32 i = 0; i < uiNumParents; ++i)
+    {
+      if ((i * 7) % 5 < 2)
+        objectsToDelete.PushBack(parents[i]);
+      else if (i % 4 == 0)
+        objectsToDelete.PushBack(children[i]);
+    }
+
+    world.DeleteObjectsNow(objectsToDelete);
+    world.Update();
+
+    ezUInt32 uiNumRemaining = 0;
+    for (ezUInt32 i = 0; i < uiNumParents; ++i)
+    {
+      const bool bParentDeleted = (i * 7) % 5 < 2;
+      const bool bChildDeleted = bParentDeleted || i % 4 == 0;
+
+      ezGameObject* pParent = nullptr;
+      EZ_TEST_BOOL(world.TryGetObject(parents[i], pParent) == !bParentDeleted);
+
+      ezGameObject* pChild = nullptr;
+      EZ_TEST_BOOL(world.TryGetObject(children[i], pChild) == !bChildDeleted);
+
+      ezStringBuilder sName;
+      sName.Format("{}", i);
+
+      if (pParent != nullptr)
+      {
+        ++uiNumRemaining;
+        EZ_TEST_STRING(pParent->GetName(), sName);
+        EZ_TEST_VEC3(pParent->GetGlobalPosition(), ezVec3((float)i, 0, 0), 0);
+        ezGameObjectTest::TestInternals(pParent, nullptr, 0);
+      }
+
+      if (pChild != nullptr)
+      {
+        ++uiNumRemaining;
+        EZ_TEST_STRING(pChild->GetName(), sName);
+        EZ_TEST_VEC3(pChild->GetGlobalPosition(), ezVec3((float)i, 1, 0), 0);
+        ezGameObjectTest::TestInternals(pChild, pParent, 1);
+      }
+    }
+
+    EZ_TEST_INT(world.GetObjectCount(), uiNumRemaining);
+    SanityCheckWorld(world);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Random create and delete")
+  {
+    ezWorldDesc worldDesc("Test");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezRandom rng;
+    rng.Initialize(42);
+
+    // objects, transformation data and components share the same storage blocks, so the churn spreads the objects over blocks in random order
+    ezHashTable<ezGameObjectHandle, ezUInt32> liveObjects;
+    ezDynamicArray<ezGameObjectHandle> handles;
+    ezUInt32 uiNextName = 0;
+
+    for (ezUInt32 uiFrame = 0; uiFrame < 30; ++uiFrame)
+    {
+      const ezUInt32 uiNumToCreate = rng.UIntInRange(500);
+      for (ezUInt32 i = 0; i < uiNumToCreate; ++i)
+      {
+        ezStringBuilder sName;
+        sName.Format("{}", uiNextName);
+
+        ezGameObjectDesc desc;
+        desc.m_sName.Assign(sName.GetData());
+        desc.m_bDynamic = rng.Bool();
+
+        if (!handles.IsEmpty() && rng.Bool())
+        {
+          desc.m_hParent = handles[rng.UIntInRange(handles.GetCount())];
+        }
+
+        ezGameObjectHandle hObject = world.CreateObject(desc);
+        liveObjects.Insert(hObject, uiNextName);
+        handles.PushBack(hObject);
+        ++uiNextName;
+      }
+
+      ezDynamicArray<ezGameObjectHandle> objectsToDelete;
+      const ezUInt32 uiNumToDelete = rng.UIntInRange(handles.GetCount() / 2 + 1);
+      for (ezUInt32 i = 0; i < uiNumToDelete; ++i)
+      {
+        objectsToDelete.PushBack(handles[rng.UIntInRange(handles.GetCount())]);
+      }
+
+      world.DeleteObjectsNow(objectsToDelete);
+      world.Update();
+
+      // drop all handles that became invalid, including deleted children
+      for (ezUInt32 i = handles.GetCount(); i-- > 0;)
+      {
+        ezGameObject* pObject = nullptr;
+        if (!world.TryGetObject(handles[i], pObject))
+        {
+          liveObjects.Remove(handles[i]);
+          handles.RemoveAtAndSwap(i);
+          continue;
+        }
+
+        ezStringBuilder sName;
+        sName.Format("{}", liveObjects[handles[i]]);
+        EZ_TEST_STRING(pObject->GetName(), sName);
+        EZ_TEST_BOOL(pObject->GetHandle() == handles[i]);
+      }
+
+      EZ_TEST_INT(world.GetObjectCount(), handles.GetCount());
+      SanityCheckWorld(world);
+    }
+  }
 }
@@ -0,0 +1,278 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Texture/Image/Conversions/DXTConversions.h>
+#include <Texture/Image/Image.h>
+#include <Texture/Image/ImageConversion.h>
+
+namespace BlockCompressionTestDetail
+{
+  /// Smooth gradients, hard edges, noise and an alpha gradient, stored block by block (16 consecutive pixels per block).
+  static void CreateTestBlocks(ezUInt32 uiNumBlocksX, ezUInt32 uiNumBlocksY, ezDynamicArray<ezColorBaseUB>& out_Pixels)
+  {
+    ezRandom rng;
+    rng.Initialize(42);
+
+    out_Pixels.SetCountUninitialized(uiNumBlocksX * uiNumBlocksY * 16);
+
+    for (ezUInt32 uiBlockY = 0; uiBlockY < uiNumBlocksY; ++uiBlockY)
+    {
+      for (ezUInt32 uiBlockX = 0; uiBlockX < uiNumBlocksX; ++uiBlockX)
+      {
+        for (ezUInt32 i = 0; i < 16; ++i)
+        {
+          const ezUInt32 x = uiBlockX * 4 + i % 4;
+          const ezUInt32 y = uiBlockY * 4 + i / 4;
+          const ezInt32 iNoise = rng.IntMinMax(-6, 6);
+
+          ezColorBaseUB& pixel = out_Pixels[(uiBlockY * uiNumBlocksX + uiBlockX) * 16 + i];
+          pixel.r = static_cast<ezUInt8>(ezMath::Clamp<ezInt32>((x * 255) / (uiNumBlocksX * 4) + iNoise, 0, 255));
+          pixel.g = static_cast<ezUInt8>(ezMath::Clamp<ezInt32>((y * 255) / (uiNumBlocksY * 4) - iNoise, 0, 255));
+          pixel.b = ((x / 7 + y / 5) % 2) ? 220 : 30;
+          pixel.a = static_cast<ezUInt8>((x + y) * 255 / ((uiNumBlocksX + uiNumBlocksY) * 4));
+        }
+      }
+    }
+  }
+
+  static double ComputeSquaredError(const ezColorBaseUB* pOriginal, const ezColorBaseUB* pDecoded, ezUInt32 uiNumPixels, ezUInt32 uiNumChannels)
+  {
+    double fSquaredError = 0.0;
+    for (ezUInt32 i = 0; i < uiNumPixels; ++i)
+    {
+      for (ezUInt32 c = 0; c < uiNumChannels; ++c)
+      {
+        const double fDiff = double(pOriginal[i].GetData()[c]) - double(pDecoded[i].GetData()[c]);
+        fSquaredError += fDiff * fDiff;
+      }
+    }
+
+    return fSquaredError;
+  }
+
+  static double ComputePSNR(double fSquaredError, ezUInt32 uiNumValues)
+  {
+    const double fMSE = fSquaredError / uiNumValues;
+    return fMSE > 0.0 ? 10.0 * ezMath::Log10(float(255.0 * 255.0 / fMSE)) : 100.0;
+  }
+
+  struct FormatInfo
+  {
+    const char* m_szName;
+    ezUInt32 m_uiBlockSize;
+    ezUInt32 m_uiNumChannels;
+    bool m_bOpaque;
+    double m_fMinPSNR[2]; // fast, high quality
+  };
+
+  static const FormatInfo s_Formats[] = {
+    {"BC1", 8, 3, true, {37.0, 37.0}},
+    {"BC3", 16, 4, false, {38.0, 38.0}},
+    {"BC4", 8, 1, false, {51.5, 53.0}},
+    {"BC5", 16, 2, false, {51.5, 53.0}},
+    {"BC7", 16, 4, true, {40.0, 46.0}},
+    {"BC7 with alpha", 16, 4, false, {40.0, 40.0}},
+  };
+
+  static void CompressBlock(ezUInt32 uiFormat, const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+  {
+    switch (uiFormat)
+    {
+      case 0:
+        ezCompressBlockBC1(pSource, pTarget, quality);
+        break;
+      case 1:
+        ezCompressBlockBC3(pSource, pTarget, quality);
+        break;
+      case 2:
+        ezCompressBlockBC4(&pSource[0].r, 4, pTarget, 0, quality);
+        break;
+      case 3:
+        ezCompressBlockBC4(&pSource[0].r, 4, pTarget, 0, quality);
+        ezCompressBlockBC4(&pSource[0].g, 4, pTarget + 8, 0, quality);
+        break;
+      case 4:
+      case 5:
+        ezCompressBlockBC7(pSource, pTarget, quality);
+        break;
+    }
+  }
+
+  static void DecompressBlock(ezUInt32 uiFormat, const ezUInt8* pSource, ezColorBaseUB* pTarget)
+  {
+    switch (uiFormat)
+    {
+      case 0:
+        ezDecompressBlockBC1(pSource, pTarget, false);
+        break;
+      case 1:
+        ezDecompressBlockBC1(pSource + 8, pTarget, true);
+        ezDecompressBlockBC4(pSource, &pTarget[0].a, 4, 0);
+        break;
+      case 2:
+        ezDecompressBlockBC4(pSource, &pTarget[0].r, 4, 0);
+        break;
+      case 3:
+        ezDecompressBlockBC4(pSource, &pTarget[0].r, 4, 0);
+        ezDecompressBlockBC4(pSource + 8, &pTarget[0].g, 4, 0);
+        break;
+      case 4:
+      case 5:
+        ezDecompressBlockBC7(pSource, pTarget);
+        break;
+    }
+  }
+
+  static ezImage CreateTestImage(ezUInt32 uiWidth, ezUInt32 uiHeight)
+  {
+    ezImageHeader header;
+    header.SetWidth(uiWidth);
+    header.SetHeight(uiHeight);
+    header.SetImageFormat(ezImageFormat::R8G8B8A8_UNORM);
+
+    ezImage image;
+    image.ResetAndAlloc(header);
+
+    for (ezUInt32 y = 0; y < uiHeight; ++y)
+    {
+      for (ezUInt32 x = 0; x < uiWidth; ++x)
+      {
+        ezColorBaseUB* pPixel = image.GetPixelPointer<ezColorBaseUB>(0, 0, 0, x, y);
+        pPixel->r = static_cast<ezUInt8>(x * 255 / uiWidth);
+        pPixel->g = static_cast<ezUInt8>(y * 255 / uiHeight);
+        pPixel->b = (x / 9) % 2 ? 200 : 50;
+        pPixel->a = 255;
+      }
+    }
+
+    return image;
+  }
+} // namespace BlockCompressionTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Image, BlockCompression)
+{
+  using namespace BlockCompressionTestDetail;
+
+  const ezUInt32 uiNumBlocksX = 64;
+  const ezUInt32 uiNumBlocksY = 64;
+  const ezUInt32 uiNumBlocks = uiNumBlocksX * uiNumBlocksY;
+
+  ezDynamicArray<ezColorBaseUB> original;
+  CreateTestBlocks(uiNumBlocksX, uiNumBlocksY, original);
+
+  // BC1 decodes transparent pixels as black and BC7 only uses two subsets for opaque blocks
+  ezDynamicArray<ezColorBaseUB> opaque = original;
+  for (ezColorBaseUB& pixel : opaque)
+  {
+    pixel.a = 255;
+  }
+
+  ezDynamicArray<ezUInt8> compressed;
+  compressed.SetCountUninitialized(uiNumBlocks * 16);
+
+  ezDynamicArray<ezColorBaseUB> decoded;
+  decoded.SetCountUninitialized(original.GetCount());
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "PSNR and throughput")
+  {
+    for (ezUInt32 uiFormat = 0; uiFormat < EZ_ARRAY_SIZE(s_Formats); ++uiFormat)
+    {
+      const FormatInfo& format = s_Formats[uiFormat];
+      const ezDynamicArray<ezColorBaseUB>& source = format.m_bOpaque ? opaque : original;
+
+      for (ezUInt32 uiQuality = 0; uiQuality < 2; ++uiQuality)
+      {
+        const ezBlockCompressionQuality::Enum quality = uiQuality == 0 ? ezBlockCompressionQuality::Fast : ezBlockCompressionQuality::High;
+
+        ezStopwatch sw;
+        for (ezUInt32 uiBlock = 0; uiBlock < uiNumBlocks; ++uiBlock)
+        {
+          CompressBlock(uiFormat, &source[uiBlock * 16], &compressed[uiBlock * format.m_uiBlockSize], quality);
+        }
+        const ezTime tCompress = sw.Checkpoint();
+
+        decoded = source;
+        for (ezUInt32 uiBlock = 0; uiBlock < uiNumBlocks; ++uiBlock)
+        {
+          DecompressBlock(uiFormat, &compressed[uiBlock * format.m_uiBlockSize], &decoded[uiBlock * 16]);
+        }
+
+        const double fSquaredError = ComputeSquaredError(source.GetData(), decoded.GetData(), source.GetCount(), format.m_uiNumChannels);
+        const double fPSNR = ComputePSNR(fSquaredError, source.GetCount() * format.m_uiNumChannels);
+        EZ_TEST_BOOL_MSG(fPSNR >= format.m_fMinPSNR[uiQuality], "%s %s: PSNR %.2f dB is below %.2f dB", format.m_szName,
+          uiQuality == 0 ? "fast" : "high quality", fPSNR, format.m_fMinPSNR[uiQuality]);
+
+        ezTestFramework::Output(ezTestOutput::Duration, "%s %s: %.2f dB PSNR, %.1f MPixel/s on one core", format.m_szName,
+          uiQuality == 0 ? "fast" : "high quality", fPSNR, original.GetCount() / tCompress.GetMicroseconds());
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC1 transparency")
+  {
+    for (ezUInt32 uiBlock = 0; uiBlock < uiNumBlocks; ++uiBlock)
+    {
+      ezCompressBlockBC1(&original[uiBlock * 16], &compressed[uiBlock * 8], ezBlockCompressionQuality::High);
+      ezDecompressBlockBC1(&compressed[uiBlock * 8], &decoded[uiBlock * 16], false);
+    }
+
+    bool bAlphaCorrect = true;
+    for (ezUInt32 i = 0; i < original.GetCount(); ++i)
+    {
+      bAlphaCorrect &= (original[i].a < 128) == (decoded[i].a == 0);
+    }
+
+    EZ_TEST_BOOL(bAlphaCorrect);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Single color blocks")
+  {
+    ezColorBaseUB block[16];
+    ezColorBaseUB result[16];
+    ezUInt8 compressedBlock[16];
+
+    for (const ezColorBaseUB& color : {ezColorBaseUB(0, 0, 0, 255), ezColorBaseUB(255, 255, 255, 255), ezColorBaseUB(17, 130, 201, 255)})
+    {
+      for (ezColorBaseUB& pixel : block)
+      {
+        pixel = color;
+      }
+
+      ezCompressBlockBC7(block, compressedBlock, ezBlockCompressionQuality::Fast);
+      ezDecompressBlockBC7(compressedBlock, result);
+      EZ_TEST_BOOL(ComputePSNR(ComputeSquaredError(block, result, 16, 4), 16 * 4) >= 48.0);
+
+      ezCompressBlockBC1(block, compressedBlock, ezBlockCompressionQuality::High);
+      ezDecompressBlockBC1(compressedBlock, result, false);
+      EZ_TEST_BOOL(ComputePSNR(ComputeSquaredError(block, result, 16, 3), 16 * 3) >= 36.0);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ezImageConversion")
+  {
+    // not a multiple of the block size, to test the padding
+    const ezImage source = CreateTestImage(70, 37);
+
+    for (ezImageFormat::Enum format : {ezImageFormat::BC1_UNORM, ezImageFormat::BC3_UNORM, ezImageFormat::BC7_UNORM})
+    {
+      EZ_TEST_BOOL(ezImageConversion::IsConvertible(ezImageFormat::R8G8B8A8_UNORM, format));
+
+      ezImage compressedImage;
+      EZ_TEST_BOOL(ezImageConversion::Convert(source, compressedImage, format).Succeeded());
+
+      ezImage decodedImage;
+      EZ_TEST_BOOL(ezImageConversion::Convert(compressedImage, decodedImage, ezImageFormat::R8G8B8A8_UNORM).Succeeded());
+      EZ_TEST_INT(decodedImage.GetWidth(), 70);
+      EZ_TEST_INT(decodedImage.GetHeight(), 37);
+
+      double fSquaredError = 0.0;
+      for (ezUInt32 y = 0; y < 37; ++y)
+      {
+        fSquaredError += ComputeSquaredError(source.GetPixelPointer<ezColorBaseUB>(0, 0, 0, 0, y), decodedImage.GetPixelPointer<ezColorBaseUB>(0, 0, 0, 0, y), 70, 3);
+      }
+
+      EZ_TEST_BOOL(ComputePSNR(fSquaredError, 70 * 37 * 3) >= 35.0);
+    }
+  }
+}
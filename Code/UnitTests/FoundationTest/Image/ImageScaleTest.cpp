@@ -0,0 +1,226 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Texture/Image/ImageUtils.h>
+
+namespace ImageScaleTestDetail
+{
+  static ezImage CreateTestImage(ezUInt32 uiWidth, ezUInt32 uiHeight, ezUInt32 uiDepth = 1)
+  {
+    ezImageHeader header;
+    header.SetWidth(uiWidth);
+    header.SetHeight(uiHeight);
+    header.SetDepth(uiDepth);
+    header.SetImageFormat(ezImageFormat::R32G32B32A32_FLOAT);
+
+    ezImage image;
+    image.ResetAndAlloc(header);
+
+    ezRandom rng;
+    rng.Initialize(42);
+
+    for (ezColor& color : image.GetBlobPtr<ezColor>())
+    {
+      color.SetRGBA(rng.FloatZeroToOneInclusive(), rng.FloatZeroToOneInclusive(), rng.FloatZeroToOneInclusive(), rng.FloatZeroToOneInclusive());
+    }
+
+    return image;
+  }
+
+  /// Evaluates every target texel separately along one axis, the way ezImageUtils::Scale3D used to work.
+  static void FilterAxisReference(const ezImageView& source, ezImage& target, ezUInt32 uiAxis, const ezImageFilter& filter,
+    ezImageAddressMode::Enum addressMode, const ezColor& borderColor)
+  {
+    const ezUInt32 sourceSize[3] = {source.GetWidth(), source.GetHeight(), source.GetDepth()};
+    const ezUInt32 targetSize[3] = {target.GetWidth(), target.GetHeight(), target.GetDepth()};
+
+    ezImageFilterWeights weights(filter, sourceSize[uiAxis], targetSize[uiAxis]);
+
+    for (ezUInt32 z = 0; z < targetSize[2]; ++z)
+    {
+      for (ezUInt32 y = 0; y < targetSize[1]; ++y)
+      {
+        for (ezUInt32 x = 0; x < targetSize[0]; ++x)
+        {
+          ezUInt32 coords[3] = {x, y, z};
+          const ezUInt32 targetIdx = coords[uiAxis];
+          const ezInt32 firstSourceIdx = weights.GetFirstSourceSampleIndex(targetIdx);
+
+          ezColor total(0, 0, 0, 0);
+          for (ezUInt32 weightIdx = 0; weightIdx < weights.GetNumWeights(); ++weightIdx)
+          {
+            bool bUseBorderColor = false;
+            coords[uiAxis] = ezImageUtils::GetSampleIndex(sourceSize[uiAxis], firstSourceIdx + weightIdx, addressMode, bUseBorderColor);
+
+            const ezColor sample = bUseBorderColor ? borderColor : *source.GetPixelPointer<ezColor>(0, 0, 0, coords[0], coords[1], coords[2]);
+            total += sample * (float)weights.GetWeight(targetIdx, weightIdx);
+          }
+
+          *target.GetPixelPointer<ezColor>(0, 0, 0, x, y, z) = total;
+        }
+      }
+    }
+  }
+
+  static void ScaleReference(const ezImageView& source, ezImage& out_Target, ezUInt32 uiWidth, ezUInt32 uiHeight, ezUInt32 uiDepth,
+    const ezImageFilter& filter, ezImageAddressMode::Enum addressMode, const ezColor& borderColor)
+  {
+    ezImage current;
+    current.ResetAndCopy(source);
+
+    const ezUInt32 size[3] = {uiWidth, uiHeight, uiDepth};
+    for (ezUInt32 uiAxis = 0; uiAxis < 3; ++uiAxis)
+    {
+      ezImageHeader header = current.GetHeader();
+      header.SetWidth(uiAxis == 0 ? size[0] : current.GetWidth());
+      header.SetHeight(uiAxis == 1 ? size[1] : current.GetHeight());
+      header.SetDepth(uiAxis == 2 ? size[2] : current.GetDepth());
+
+      ezImage next;
+      next.ResetAndAlloc(header);
+      FilterAxisReference(current, next, uiAxis, filter, addressMode, borderColor);
+      current.ResetAndMove(std::move(next));
+    }
+
+    out_Target.ResetAndMove(std::move(current));
+  }
+
+  static float ComputeMaxDifference(const ezImageView& a, const ezImageView& b)
+  {
+    ezBlobPtr<const ezColor> colorsA = a.GetBlobPtr<ezColor>();
+    ezBlobPtr<const ezColor> colorsB = b.GetBlobPtr<ezColor>();
+
+    float fMaxDifference = 0.0f;
+    for (ezUInt64 i = 0; i < colorsA.GetCount(); ++i)
+    {
+      const ezColor diff = colorsA[i] - colorsB[i];
+      fMaxDifference = ezMath::Max(fMaxDifference, ezMath::Abs(diff.r), ezMath::Abs(diff.g), ezMath::Abs(diff.b), ezMath::Abs(diff.a));
+    }
+
+    return fMaxDifference;
+  }
+
+  static void RunBenchmark(ezUInt32 uiSize)
+  {
+    const ezImage source = CreateTestImage(uiSize, uiSize);
+
+    ezStopwatch sw;
+
+    ezImage scaled;
+    EZ_TEST_BOOL(ezImageUtils::Scale(source, scaled, uiSize / 2, uiSize / 2).Succeeded());
+    const ezTime tScale = sw.Checkpoint();
+
+    ezImageFilterSincWithKaiserWindow filter;
+    EZ_TEST_BOOL(ezImageUtils::Scale(source, scaled, uiSize * 3 / 4, uiSize * 3 / 4, &filter).Succeeded());
+    const ezTime tScaleKaiser = sw.Checkpoint();
+
+    ezImage mipMaps;
+    ezImageUtils::MipMapOptions options;
+    ezImageUtils::GenerateMipMaps(source, mipMaps, options);
+    const ezTime tMipMaps = sw.Checkpoint();
+
+    EZ_TEST_INT(mipMaps.GetNumMipLevels(), source.GetHeader().ComputeNumberOfMipMaps());
+
+    ezTestFramework::Output(ezTestOutput::Duration,
+      "%ux%u: Scale to half size %.1f ms, Kaiser filter to 3/4 size %.1f ms, GenerateMipMaps %.1f ms", uiSize, uiSize, tScale.GetMilliseconds(),
+      tScaleKaiser.GetMilliseconds(), tMipMaps.GetMilliseconds());
+  }
+} // namespace ImageScaleTestDetail
+
+// Enable when needed, the 8K images need more than 2 GB of memory
+#define EZ_LARGE_IMAGE_BENCHMARK_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(Image, ImageScale)
+{
+  using namespace ImageScaleTestDetail;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Scale matches reference")
+  {
+    const ezImage source = CreateTestImage(67, 45);
+
+    ezImageFilterTriangle triangle;
+    ezImageFilterSincWithKaiserWindow kaiser;
+    const ezImageFilter* filters[] = {&triangle, &kaiser};
+
+    const ezImageAddressMode::Enum addressModes[] = {
+      ezImageAddressMode::Clamp, ezImageAddressMode::Repeat, ezImageAddressMode::Mirror, ezImageAddressMode::ClampBorder};
+
+    const ezVec2U32 sizes[] = {ezVec2U32(33, 22), ezVec2U32(128, 90), ezVec2U32(20, 61)};
+
+    for (const ezImageFilter* pFilter : filters)
+    {
+      for (ezImageAddressMode::Enum addressMode : addressModes)
+      {
+        for (const ezVec2U32& size : sizes)
+        {
+          ezImage scaled;
+          EZ_TEST_BOOL(ezImageUtils::Scale(source, scaled, size.x, size.y, pFilter, addressMode, addressMode, ezColor::CornflowerBlue).Succeeded());
+
+          ezImage reference;
+          ScaleReference(source, reference, size.x, size.y, 1, *pFilter, addressMode, ezColor::CornflowerBlue);
+
+          EZ_TEST_FLOAT(ComputeMaxDifference(scaled, reference), 0.0f, 0.0001f);
+        }
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Scale3D matches reference")
+  {
+    const ezImage source = CreateTestImage(19, 12, 9);
+
+    ezImageFilterTriangle filter;
+
+    ezImage scaled;
+    EZ_TEST_BOOL(ezImageUtils::Scale3D(source, scaled, 9, 6, 4, &filter, ezImageAddressMode::Mirror, ezImageAddressMode::Mirror,
+                   ezImageAddressMode::Mirror)
+                   .Succeeded());
+
+    ezImage reference;
+    ScaleReference(source, reference, 9, 6, 4, filter, ezImageAddressMode::Mirror, ezColor::Black);
+
+    EZ_TEST_FLOAT(ComputeMaxDifference(scaled, reference), 0.0f, 0.0001f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "GenerateMipMaps matches reference")
+  {
+    const ezImage source = CreateTestImage(100, 37);
+
+    ezImage mipMaps;
+    ezImageUtils::MipMapOptions options;
+    ezImageUtils::GenerateMipMaps(source, mipMaps, options);
+
+    EZ_TEST_INT(mipMaps.GetNumMipLevels(), 7);
+
+    ezImageFilterTriangle filter;
+
+    ezImage reference;
+    reference.ResetAndCopy(source);
+
+    for (ezUInt32 uiMipLevel = 1; uiMipLevel < mipMaps.GetNumMipLevels(); ++uiMipLevel)
+    {
+      ezImage next;
+      ScaleReference(reference, next, ezMath::Max(1u, reference.GetWidth() / 2), ezMath::Max(1u, reference.GetHeight() / 2), 1, filter,
+        ezImageAddressMode::Clamp, ezColor::Black);
+
+      EZ_TEST_FLOAT(ComputeMaxDifference(mipMaps.GetSubImageView(uiMipLevel), next), 0.0f, 0.0001f);
+      reference.ResetAndMove(std::move(next));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Benchmark 2K")
+  {
+    RunBenchmark(2048);
+  }
+
+  EZ_TEST_BLOCK(EZ_LARGE_IMAGE_BENCHMARK_STATE, "Benchmark 4K")
+  {
+    RunBenchmark(4096);
+  }
+
+  EZ_TEST_BLOCK(EZ_LARGE_IMAGE_BENCHMARK_STATE, "Benchmark 8K")
+  {
+    RunBenchmark(8192);
+  }
+}
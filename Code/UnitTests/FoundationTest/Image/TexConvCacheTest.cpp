@@ -0,0 +1,234 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Texture/TexConv/TexConvCache.h>
+#include <Texture/TexConv/TexConvProcessor.h>
+
+namespace TexConvCacheTestDetail
+{
+  static ezImage CreateTestImage(ezUInt32 uiWidth, ezUInt32 uiHeight, ezUInt8 uiSeed)
+  {
+    ezImageHeader header;
+    header.SetWidth(uiWidth);
+    header.SetHeight(uiHeight);
+    header.SetImageFormat(ezImageFormat::R8G8B8A8_UNORM);
+
+    ezImage image;
+    image.ResetAndAlloc(header);
+
+    ezUInt8 uiValue = uiSeed;
+    for (ezUInt8& value : image.GetBlobPtr<ezUInt8>())
+    {
+      value = uiValue;
+      uiValue = static_cast<ezUInt8>(uiValue * 13 + 7);
+    }
+
+    return image;
+  }
+
+  static bool IsEqual(const ezImageView& a, const ezImageView& b)
+  {
+    if (a.GetImageFormat() != b.GetImageFormat() || a.GetWidth() != b.GetWidth() || a.GetHeight() != b.GetHeight() ||
+        a.GetNumMipLevels() != b.GetNumMipLevels() || a.GetByteBlobPtr().GetCount() != b.GetByteBlobPtr().GetCount())
+      return false;
+
+    return ezMemoryUtils::IsEqual(a.GetByteBlobPtr().GetPtr(), b.GetByteBlobPtr().GetPtr(), static_cast<size_t>(a.GetByteBlobPtr().GetCount()));
+  }
+
+  static ezResult Process(ezTexConvCache* pCache, const ezImage& input, ezEnum<ezTexConvMipmapMode> mipmapMode,
+    ezEnum<ezTexConvCompressionMode> compressionMode, ezImage& out_Result)
+  {
+    ezTexConvProcessor processor;
+    processor.m_pCache = pCache;
+    processor.m_Descriptor.m_InputImages.ExpandAndGetRef().ResetAndCopy(input);
+    processor.m_Descriptor.m_Usage = ezTexConvUsage::Color;
+    processor.m_Descriptor.m_MipmapMode = mipmapMode;
+    processor.m_Descriptor.m_CompressionMode = compressionMode;
+
+    ezTexConvSliceChannelMapping& mapping = processor.m_Descriptor.m_ChannelMappings.ExpandAndGetRef();
+    for (ezInt8 i = 0; i < 4; ++i)
+    {
+      mapping.m_Channel[i].m_iInputImageIndex = 0;
+    }
+
+    EZ_SUCCEED_OR_RETURN(processor.Process());
+
+    out_Result.ResetAndMove(std::move(processor.m_OutputImage));
+    return EZ_SUCCESS;
+  }
+} // namespace TexConvCacheTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Image, TexConvCache)
+{
+  using namespace TexConvCacheTestDetail;
+
+  // the cache reads and writes files with absolute paths
+  EZ_TEST_BOOL(ezFileSystem::AddDataDirectory("", "TexConvCacheTest", ":", ezFileSystem::AllowWrites) == EZ_SUCCESS);
+
+  ezStringBuilder sCacheDir;
+  ezFileSystem::ResolveSpecialDirectory(ezTestFramework::GetInstance()->GetAbsOutputPath(), sCacheDir).IgnoreResult();
+  sCacheDir.AppendPath("TexConvCache");
+
+  // a size limit of zero evicts everything that a previous run left behind
+  {
+    ezTexConvCache cache;
+    EZ_TEST_BOOL(cache.Open(sCacheDir, 0).Succeeded());
+    EZ_TEST_INT(cache.GetNumEntries(), 0);
+    cache.ResetStats();
+  }
+
+  const ezImage image0 = CreateTestImage(64, 64, 1);
+  const ezImage image1 = CreateTestImage(64, 64, 2);
+  const ezImage image2 = CreateTestImage(64, 64, 3);
+  const ezUInt64 uiImageSize = image0.GetByteBlobPtr().GetCount();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Store and Retrieve")
+  {
+    ezTexConvCache cache;
+    EZ_TEST_BOOL(cache.Open(sCacheDir, uiImageSize * 10).Succeeded());
+
+    ezImage result;
+    EZ_TEST_BOOL(!cache.Retrieve(ezTexConvCacheStage::Mipmaps, 1, result));
+
+    cache.Store(ezTexConvCacheStage::Mipmaps, 1, image0, ezTime::Milliseconds(100));
+    EZ_TEST_INT(cache.GetNumEntries(), 1);
+
+    // the stage is part of the key
+    EZ_TEST_BOOL(!cache.Retrieve(ezTexConvCacheStage::Output, 1, result));
+
+    EZ_TEST_BOOL(cache.Retrieve(ezTexConvCacheStage::Mipmaps, 1, result));
+    EZ_TEST_BOOL(IsEqual(result, image0));
+
+    const ezTexConvCacheStats& stats = cache.GetSessionStats();
+    EZ_TEST_INT(stats.m_uiHits[ezTexConvCacheStage::Mipmaps], 1);
+    EZ_TEST_INT(stats.m_uiMisses[ezTexConvCacheStage::Mipmaps], 1);
+    EZ_TEST_INT(stats.m_uiMisses[ezTexConvCacheStage::Output], 1);
+    EZ_TEST_INT(stats.GetNumLookups(), 3);
+    EZ_TEST_FLOAT(stats.GetHitRate(), 1.0f / 3.0f, 0.0001f);
+    EZ_TEST_FLOAT(stats.m_TimeSaved.GetMilliseconds(), 100.0, 0.0001);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Persistence")
+  {
+    ezTexConvCache cache;
+    EZ_TEST_BOOL(cache.Open(sCacheDir, uiImageSize * 10).Succeeded());
+
+    EZ_TEST_INT(cache.GetNumEntries(), 1);
+    EZ_TEST_INT(cache.GetTotalStats().GetNumLookups(), 3);
+    EZ_TEST_INT(cache.GetSessionStats().GetNumLookups(), 0);
+    EZ_TEST_FLOAT(cache.GetProcessingTime(ezTexConvCacheStage::Mipmaps, 1).GetMilliseconds(), 100.0, 0.0001);
+
+    ezImage result;
+    EZ_TEST_BOOL(cache.Retrieve(ezTexConvCacheStage::Mipmaps, 1, result));
+    EZ_TEST_BOOL(IsEqual(result, image0));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "LRU Eviction")
+  {
+    ezTexConvCache cache;
+
+    // room for two images
+    EZ_TEST_BOOL(cache.Open(sCacheDir, uiImageSize * 2).Succeeded());
+    cache.ResetStats();
+
+    cache.Store(ezTexConvCacheStage::Output, 2, image1, ezTime::Milliseconds(10));
+
+    // touch the oldest entry, so that the entry with key 2 becomes the least recently used one
+    ezImage result;
+    EZ_TEST_BOOL(cache.Retrieve(ezTexConvCacheStage::Mipmaps, 1, result));
+
+    cache.Store(ezTexConvCacheStage::Output, 3, image2, ezTime::Milliseconds(10));
+
+    EZ_TEST_INT(cache.GetNumEntries(), 2);
+    EZ_TEST_INT(cache.GetSessionStats().m_uiEvictions, 1);
+    EZ_TEST_BOOL(cache.GetCurrentSize() <= cache.GetMaxSize());
+
+    EZ_TEST_BOOL(cache.Retrieve(ezTexConvCacheStage::Mipmaps, 1, result));
+    EZ_TEST_BOOL(IsEqual(result, image0));
+    EZ_TEST_BOOL(!cache.Retrieve(ezTexConvCacheStage::Output, 2, result));
+    EZ_TEST_BOOL(cache.Retrieve(ezTexConvCacheStage::Output, 3, result));
+    EZ_TEST_BOOL(IsEqual(result, image2));
+
+    // results that would not fit at all are not stored
+    const ezImage largeImage = CreateTestImage(128, 128, 4);
+    cache.Store(ezTexConvCacheStage::Output, 4, largeImage, ezTime::Milliseconds(10));
+    EZ_TEST_INT(cache.GetNumEntries(), 2);
+    EZ_TEST_BOOL(!cache.Retrieve(ezTexConvCacheStage::Output, 4, result));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Shrink on Open")
+  {
+    ezTexConvCache cache;
+    EZ_TEST_BOOL(cache.Open(sCacheDir, uiImageSize).Succeeded());
+
+    EZ_TEST_INT(cache.GetNumEntries(), 1);
+    EZ_TEST_BOOL(cache.GetCurrentSize() <= uiImageSize);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Re-export")
+  {
+    ezImage uncached, first, second, otherMipmaps, otherMipmapsUncached, otherCompression, otherCompressionUncached;
+
+    EZ_TEST_BOOL(Process(nullptr, image0, ezTexConvMipmapMode::Linear, ezTexConvCompressionMode::High, uncached).Succeeded());
+    EZ_TEST_BOOL(Process(nullptr, image0, ezTexConvMipmapMode::Kaiser, ezTexConvCompressionMode::High, otherMipmapsUncached).Succeeded());
+    EZ_TEST_BOOL(Process(nullptr, image0, ezTexConvMipmapMode::Linear, ezTexConvCompressionMode::None, otherCompressionUncached).Succeeded());
+
+    ezTexConvCache cache;
+    EZ_TEST_BOOL(cache.Open(sCacheDir, 0).Succeeded());
+    cache.Close();
+    EZ_TEST_BOOL(cache.Open(sCacheDir, 64 * 1024 * 1024).Succeeded());
+
+    EZ_TEST_BOOL(Process(&cache, image0, ezTexConvMipmapMode::Linear, ezTexConvCompressionMode::High, first).Succeeded());
+    EZ_TEST_INT(cache.GetSessionStats().GetNumHits(), 0);
+    EZ_TEST_INT(cache.GetNumEntries(), 3);
+
+    // unchanged settings skip all processing
+    EZ_TEST_BOOL(Process(&cache, image0, ezTexConvMipmapMode::Linear, ezTexConvCompressionMode::High, second).Succeeded());
+    EZ_TEST_INT(cache.GetSessionStats().m_uiHits[ezTexConvCacheStage::Output], 1);
+    EZ_TEST_INT(cache.GetSessionStats().m_uiHits[ezTexConvCacheStage::Mipmaps], 0);
+
+    // other mipmap settings reuse the assembled image
+    EZ_TEST_BOOL(Process(&cache, image0, ezTexConvMipmapMode::Kaiser, ezTexConvCompressionMode::High, otherMipmaps).Succeeded());
+    EZ_TEST_INT(cache.GetSessionStats().m_uiHits[ezTexConvCacheStage::AssembledImage], 1);
+
+    // another output format reuses the mipmaps
+    EZ_TEST_BOOL(Process(&cache, image0, ezTexConvMipmapMode::Linear, ezTexConvCompressionMode::None, otherCompression).Succeeded());
+    EZ_TEST_INT(cache.GetSessionStats().m_uiHits[ezTexConvCacheStage::Mipmaps], 1);
+
+    EZ_TEST_BOOL(IsEqual(first, uncached));
+    EZ_TEST_BOOL(IsEqual(second, uncached));
+    EZ_TEST_BOOL(IsEqual(otherMipmaps, otherMipmapsUncached));
+    EZ_TEST_BOOL(IsEqual(otherCompression, otherCompressionUncached));
+
+    // the quality of the block compressors changes the output, but not the mipmaps
+    ezCVar* pCVar = ezCVar::FindCVarByName("texture.FastBlockCompression");
+    EZ_TEST_BOOL(pCVar != nullptr && pCVar->GetType() == ezCVarType::Bool);
+    if (pCVar != nullptr && pCVar->GetType() == ezCVarType::Bool)
+    {
+      ezCVarBool* pFastBlockCompression = static_cast<ezCVarBool*>(pCVar);
+      const bool bFastBlockCompression = *pFastBlockCompression;
+      const ezUInt32 uiOutputHits = cache.GetSessionStats().m_uiHits[ezTexConvCacheStage::Output];
+      const ezUInt32 uiMipmapsHits = cache.GetSessionStats().m_uiHits[ezTexConvCacheStage::Mipmaps];
+
+      ezImage otherQuality, otherQualityUncached;
+      *pFastBlockCompression = !bFastBlockCompression;
+      EZ_TEST_BOOL(Process(nullptr, image0, ezTexConvMipmapMode::Linear, ezTexConvCompressionMode::High, otherQualityUncached).Succeeded());
+      EZ_TEST_BOOL(Process(&cache, image0, ezTexConvMipmapMode::Linear, ezTexConvCompressionMode::High, otherQuality).Succeeded());
+      *pFastBlockCompression = bFastBlockCompression;
+
+      EZ_TEST_INT(cache.GetSessionStats().m_uiHits[ezTexConvCacheStage::Output], uiOutputHits);
+      EZ_TEST_INT(cache.GetSessionStats().m_uiHits[ezTexConvCacheStage::Mipmaps], uiMipmapsHits + 1);
+      EZ_TEST_BOOL(IsEqual(otherQuality, otherQualityUncached));
+    }
+
+    // other input data must not hit anything
+    const ezUInt32 uiHits = cache.GetSessionStats().GetNumHits();
+    EZ_TEST_BOOL(Process(&cache, image1, ezTexConvMipmapMode::Linear, ezTexConvCompressionMode::High, first).Succeeded());
+    EZ_TEST_INT(cache.GetSessionStats().GetNumHits(), uiHits);
+
+    cache.GetSessionStats().PrintReport("Re-export");
+  }
+
+  ezFileSystem::RemoveDataDirectoryGroup("TexConvCacheTest");
+}
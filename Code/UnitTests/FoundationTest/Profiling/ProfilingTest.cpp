@@ -20,6 +20,22 @@ namespace
       ezLog::Info("Profiling capture saved to '{0}'.", fileWriter.GetFilePathAbsolute().GetData());
     }
   }
+
+  ezUInt32 CountScopes(const ezProfilingSystem::ProfilingData& data, const char* szName)
+  {
+    ezUInt32 uiCount = 0;
+
+    for (const auto& eventBuffer : data.m_AllEventBuffers)
+    {
+      for (const auto& scope : eventBuffer.m_Data)
+      {
+        if (ezStringUtils::IsEqual(scope.m_szName, szName))
+          ++uiCount;
+      }
+    }
+
+    return uiCount;
+  }
 }
 
 EZ_CREATE_SIMPLE_TEST_GROUP(Profiling);
@@ -51,4 +67,39 @@ EZ_CREATE_SIMPLE_TEST(Profiling, Profiling)
 
     WriteOutProfilingCapture(":output/profilingScopes.json");
   }
+
+#if EZ_ENABLED(EZ_USE_PROFILING)
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Incremental capture")
+  {
+    ezProfilingSystem::CaptureCursor cursor;
+
+    // skip everything that was recorded before
+    ezProfilingSystem::CaptureIncremental(cursor);
+
+    ezProfilingSystem::AddCPUScope("Incremental 1", nullptr, ezTime::Seconds(1), ezTime::Seconds(2));
+    ezProfilingSystem::AddCPUScope("Incremental 2", nullptr, ezTime::Seconds(1), ezTime::Seconds(3));
+    ezProfilingSystem::StartNewFrame();
+
+    ezProfilingSystem::ProfilingData data = ezProfilingSystem::CaptureIncremental(cursor);
+    EZ_TEST_INT(CountScopes(data, "Incremental 1"), 1);
+    EZ_TEST_INT(CountScopes(data, "Incremental 2"), 1);
+    EZ_TEST_INT(data.m_FrameStartTimes.GetCount(), 1);
+
+    data = ezProfilingSystem::CaptureIncremental(cursor);
+    EZ_TEST_INT(CountScopes(data, "Incremental 1"), 0);
+    EZ_TEST_INT(CountScopes(data, "Incremental 2"), 0);
+    EZ_TEST_INT(data.m_FrameStartTimes.GetCount(), 0);
+
+    ezProfilingSystem::AddCPUScope("Incremental 3", nullptr, ezTime::Seconds(2), ezTime::Seconds(3));
+
+    data = ezProfilingSystem::CaptureIncremental(cursor);
+    EZ_TEST_INT(CountScopes(data, "Incremental 1"), 0);
+    EZ_TEST_INT(CountScopes(data, "Incremental 3"), 1);
+
+    // a full capture still returns everything
+    data = ezProfilingSystem::Capture();
+    EZ_TEST_INT(CountScopes(data, "Incremental 1"), 1);
+    EZ_TEST_INT(CountScopes(data, "Incremental 3"), 1);
+  }
+#endif
 }
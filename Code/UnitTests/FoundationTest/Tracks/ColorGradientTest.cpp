@@ -0,0 +1,211 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Foundation/Tracks/ColorGradient.h>
+
+namespace ColorGradientTestDetail
+{
+  static void CreateGradient(ezColorGradient& gradient)
+  {
+    gradient.Clear();
+    gradient.AddColorControlPoint(0.0, ezColorGammaUB(255, 0, 0));
+    gradient.AddColorControlPoint(0.3, ezColorGammaUB(0, 255, 0));
+    gradient.AddColorControlPoint(0.35, ezColorGammaUB(0, 0, 255));
+    gradient.AddColorControlPoint(1.0, ezColorGammaUB(255, 255, 255));
+    gradient.AddAlphaControlPoint(0.1, 0);
+    gradient.AddAlphaControlPoint(0.9, 255);
+    gradient.AddIntensityControlPoint(0.0, 1.0f);
+    gradient.AddIntensityControlPoint(0.5, 4.0f);
+    gradient.SortControlPoints();
+  }
+
+  static bool IsEqual(const ezColor& a, const ezColor& b, float fEpsilon)
+  {
+    return ezMath::IsEqual(a.r, b.r, fEpsilon) && ezMath::IsEqual(a.g, b.g, fEpsilon) && ezMath::IsEqual(a.b, b.b, fEpsilon) &&
+           ezMath::IsEqual(a.a, b.a, fEpsilon);
+  }
+
+  static void EvaluateExact(const ezColorGradient& gradient, float x, ezColor& out_Color, float& out_fIntensity)
+  {
+    ezUInt8 alpha;
+    gradient.EvaluateColor(x, out_Color);
+    gradient.EvaluateAlpha(x, alpha);
+    gradient.EvaluateIntensity(x, out_fIntensity);
+    out_Color.a = ezMath::ColorByteToFloat(alpha);
+  }
+} // namespace ColorGradientTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Tracks, ColorGradient)
+{
+  using namespace ColorGradientTestDetail;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "CreateBakedTable")
+  {
+    ezColorGradient gradient;
+    CreateGradient(gradient);
+
+    EZ_TEST_BOOL(!gradient.HasBakedTable());
+
+    gradient.CreateBakedTable(0.002f);
+    EZ_TEST_BOOL(gradient.HasBakedTable());
+
+    // the alpha values are quantized to bytes in the exact evaluation
+    const float fMaxError = 0.002f + 1.0f / 255.0f;
+
+    for (ezUInt32 i = 0; i <= 1000; ++i)
+    {
+      const float x = -0.2f + i * 0.0014f;
+
+      ezColor exact, baked;
+      float fExactIntensity, fBakedIntensity;
+      EvaluateExact(gradient, x, exact, fExactIntensity);
+      gradient.EvaluateBaked(x, baked, fBakedIntensity);
+
+      EZ_TEST_BOOL(IsEqual(exact, baked, fMaxError));
+      EZ_TEST_FLOAT(fBakedIntensity, fExactIntensity, 0.002f * fExactIntensity);
+    }
+
+    // the table has to be recreated after modifications
+    gradient.SortControlPoints();
+    EZ_TEST_BOOL(!gradient.HasBakedTable());
+
+    ezColor color;
+    float fIntensity;
+    gradient.EvaluateBaked(0.5f, color, fIntensity);
+    EZ_TEST_FLOAT(fIntensity, 4.0f, 0.0f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Empty gradient")
+  {
+    ezColorGradient gradient;
+    gradient.CreateBakedTable();
+    EZ_TEST_BOOL(gradient.HasBakedTable());
+
+    ezColor color;
+    float fIntensity;
+    gradient.EvaluateBaked(0.5f, color, fIntensity);
+    EZ_TEST_BOOL(IsEqual(color, ezColor::White, 0.0f));
+    EZ_TEST_FLOAT(fIntensity, 1.0f, 0.0f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "EvaluateBatch")
+  {
+    ezColorGradient gradient;
+    CreateGradient(gradient);
+
+    ezDynamicArray<float> positions;
+    ezDynamicArray<ezColor> colors;
+    ezDynamicArray<float> intensities;
+    positions.SetCountUninitialized(1003);
+    colors.SetCount(1003);
+    intensities.SetCountUninitialized(1003);
+
+    ezRandom rng;
+    rng.Initialize(42);
+
+    for (float& x : positions)
+    {
+      x = (float)rng.DoubleMinMax(-0.5, 1.5);
+    }
+
+    for (ezUInt32 iBaked = 0; iBaked < 2; ++iBaked)
+    {
+      if (iBaked == 1)
+      {
+        gradient.CreateBakedTable();
+      }
+
+      gradient.EvaluateBatch(positions, colors, intensities);
+
+      for (ezUInt32 i = 0; i < positions.GetCount(); ++i)
+      {
+        ezColor color;
+        float fIntensity;
+        gradient.EvaluateBaked(positions[i], color, fIntensity);
+
+        EZ_TEST_BOOL(IsEqual(colors[i], color, 0.00001f));
+        EZ_TEST_FLOAT(intensities[i], fIntensity, 0.00001f);
+      }
+    }
+
+    // the intensities are optional
+    colors.Clear();
+    colors.SetCount(positions.GetCount());
+    gradient.EvaluateBatch(positions, colors, ezArrayPtr<float>());
+
+    for (ezUInt32 i = 0; i < positions.GetCount(); ++i)
+    {
+      ezColor color;
+      float fIntensity;
+      gradient.EvaluateBaked(positions[i], color, fIntensity);
+
+      EZ_TEST_BOOL(IsEqual(colors[i], color, 0.00001f));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Benchmark")
+  {
+    ezColorGradient gradient;
+    CreateGradient(gradient);
+    gradient.CreateBakedTable();
+
+    const ezUInt32 uiNumValues = 1024;
+    const ezUInt32 uiNumRepetitions = 500;
+    const double fNumEvaluations = (double)uiNumValues * uiNumRepetitions;
+
+    ezDynamicArray<float> positions;
+    ezDynamicArray<ezColor> colors;
+    ezDynamicArray<float> intensities;
+    positions.SetCountUninitialized(uiNumValues);
+    colors.SetCount(uiNumValues);
+    intensities.SetCountUninitialized(uiNumValues);
+
+    for (ezUInt32 i = 0; i < uiNumValues; ++i)
+    {
+      positions[i] = (float)i / uiNumValues;
+    }
+
+    float fSum = 0.0f;
+
+    ezStopwatch sw;
+    for (ezUInt32 r = 0; r < uiNumRepetitions; ++r)
+    {
+      for (ezUInt32 i = 0; i < uiNumValues; ++i)
+      {
+        EvaluateExact(gradient, positions[i], colors[i], intensities[i]);
+      }
+
+      fSum += colors[r % uiNumValues].r;
+    }
+    const ezTime tScalar = sw.Checkpoint();
+
+    for (ezUInt32 r = 0; r < uiNumRepetitions; ++r)
+    {
+      for (ezUInt32 i = 0; i < uiNumValues; ++i)
+      {
+        gradient.EvaluateBaked(positions[i], colors[i], intensities[i]);
+      }
+
+      fSum += colors[r % uiNumValues].r;
+    }
+    const ezTime tBaked = sw.Checkpoint();
+
+    for (ezUInt32 r = 0; r < uiNumRepetitions; ++r)
+    {
+      gradient.EvaluateBatch(positions, colors, intensities);
+
+      fSum += colors[r % uiNumValues].r;
+    }
+    const ezTime tBatch = sw.Checkpoint();
+
+    EZ_TEST_BOOL(ezMath::IsFinite(fSum));
+
+    ezTestFramework::Output(
+      ezTestOutput::Duration, "ColorGradient Evaluate: %.1f million evaluations per second", fNumEvaluations / tScalar.GetMicroseconds());
+    ezTestFramework::Output(
+      ezTestOutput::Duration, "ColorGradient EvaluateBaked: %.1f million evaluations per second", fNumEvaluations / tBaked.GetMicroseconds());
+    ezTestFramework::Output(
+      ezTestOutput::Duration, "ColorGradient EvaluateBatch: %.1f million evaluations per second", fNumEvaluations / tBatch.GetMicroseconds());
+  }
+}
@@ -0,0 +1,176 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Foundation/Tracks/Curve1D.h>
+
+namespace Curve1DTestDetail
+{
+  static void CreateCurve(ezCurve1D& curve)
+  {
+    curve.Clear();
+    curve.AddControlPoint(0.0).m_Position.y = 0.0;
+    curve.AddControlPoint(1.0).m_Position.y = 2.0;
+    curve.AddControlPoint(1.5).m_Position.y = -1.0;
+    curve.AddControlPoint(3.0).m_Position.y = 0.5;
+    curve.SortControlPoints();
+    curve.CreateLinearApproximation();
+  }
+} // namespace Curve1DTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Tracks, Curve1D)
+{
+  using namespace Curve1DTestDetail;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "CreateBakedTable")
+  {
+    ezCurve1D curve;
+    CreateCurve(curve);
+
+    EZ_TEST_BOOL(!curve.HasBakedTable());
+
+    curve.CreateBakedTable(0.001);
+    EZ_TEST_BOOL(curve.HasBakedTable());
+    EZ_TEST_BOOL(curve.GetNumBakedSamples() >= 17 && curve.GetNumBakedSamples() <= 1025);
+
+    double fMinY, fMaxY;
+    curve.QueryExtremeValues(fMinY, fMaxY);
+    const double fMaxError = 0.001 * (fMaxY - fMinY) + 0.00001;
+
+    // including positions outside of the curve, which must be clamped
+    for (ezUInt32 i = 0; i <= 1000; ++i)
+    {
+      const float x = -0.5f + i * 0.004f;
+      EZ_TEST_FLOAT(curve.EvaluateBaked(x), curve.Evaluate(x), fMaxError);
+    }
+
+    // a larger error bound needs fewer samples
+    const ezUInt32 uiPrecise = curve.GetNumBakedSamples();
+    curve.CreateBakedTable(0.05);
+    EZ_TEST_BOOL(curve.GetNumBakedSamples() < uiPrecise);
+
+    // no error allowed means the highest resolution
+    curve.CreateBakedTable(0.0, 65);
+    EZ_TEST_INT(curve.GetNumBakedSamples(), 65);
+
+    // the table is derived from the linear approximation
+    curve.CreateLinearApproximation();
+    EZ_TEST_BOOL(!curve.HasBakedTable());
+    EZ_TEST_FLOAT(curve.EvaluateBaked(1.25f), curve.Evaluate(1.25f), 0.00001);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Constant curves")
+  {
+    ezCurve1D curve;
+    curve.CreateLinearApproximation();
+    curve.CreateBakedTable();
+    EZ_TEST_FLOAT(curve.EvaluateBaked(5.0f), 0.0f, 0.0f);
+
+    curve.AddControlPoint(2.0).m_Position.y = 3.0;
+    curve.SortControlPoints();
+    curve.CreateLinearApproximation();
+    curve.CreateBakedTable();
+    EZ_TEST_FLOAT(curve.EvaluateBaked(-1.0f), 3.0f, 0.0f);
+    EZ_TEST_FLOAT(curve.EvaluateBaked(2.0f), 3.0f, 0.0f);
+    EZ_TEST_FLOAT(curve.EvaluateBaked(7.0f), 3.0f, 0.0f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "EvaluateBatch")
+  {
+    ezCurve1D curve;
+    CreateCurve(curve);
+
+    // not a multiple of four, to test the remainder
+    ezDynamicArray<float> positions;
+    ezDynamicArray<float> values;
+    positions.SetCountUninitialized(1003);
+    values.SetCountUninitialized(1003);
+
+    ezRandom rng;
+    rng.Initialize(42);
+
+    for (float& x : positions)
+    {
+      x = (float)rng.DoubleMinMax(-1.0, 4.0);
+    }
+
+    // without a table every position is evaluated individually
+    curve.EvaluateBatch(positions, values);
+
+    for (ezUInt32 i = 0; i < positions.GetCount(); ++i)
+    {
+      EZ_TEST_FLOAT(values[i], curve.Evaluate(positions[i]), 0.00001);
+    }
+
+    curve.CreateBakedTable();
+    curve.EvaluateBatch(positions, values);
+
+    for (ezUInt32 i = 0; i < positions.GetCount(); ++i)
+    {
+      EZ_TEST_FLOAT(values[i], curve.EvaluateBaked(positions[i]), 0.00001);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Benchmark")
+  {
+    ezCurve1D curve;
+    CreateCurve(curve);
+    curve.CreateBakedTable();
+
+    const ezUInt32 uiNumValues = 1024;
+    const ezUInt32 uiNumRepetitions = 1000;
+    const double fNumEvaluations = (double)uiNumValues * uiNumRepetitions;
+
+    ezDynamicArray<float> positions;
+    ezDynamicArray<float> values;
+    positions.SetCountUninitialized(uiNumValues);
+    values.SetCountUninitialized(uiNumValues);
+
+    for (ezUInt32 i = 0; i < uiNumValues; ++i)
+    {
+      positions[i] = 3.0f * i / uiNumValues;
+    }
+
+    float fSum = 0.0f;
+
+    ezStopwatch sw;
+    for (ezUInt32 r = 0; r < uiNumRepetitions; ++r)
+    {
+      for (ezUInt32 i = 0; i < uiNumValues; ++i)
+      {
+        values[i] = (float)curve.Evaluate(positions[i]);
+      }
+
+      fSum += values[r % uiNumValues];
+    }
+    const ezTime tScalar = sw.Checkpoint();
+
+    for (ezUInt32 r = 0; r < uiNumRepetitions; ++r)
+    {
+      for (ezUInt32 i = 0; i < uiNumValues; ++i)
+      {
+        values[i] = curve.EvaluateBaked(positions[i]);
+      }
+
+      fSum += values[r % uiNumValues];
+    }
+    const ezTime tBaked = sw.Checkpoint();
+
+    for (ezUInt32 r = 0; r < uiNumRepetitions; ++r)
+    {
+      curve.EvaluateBatch(positions, values);
+
+      fSum += values[r % uiNumValues];
+    }
+    const ezTime tBatch = sw.Checkpoint();
+
+    EZ_TEST_BOOL(ezMath::IsFinite(fSum));
+
+    ezTestFramework::Output(
+      ezTestOutput::Duration, "Curve1D Evaluate: %.1f million evaluations per second", fNumEvaluations / tScalar.GetMicroseconds());
+    ezTestFramework::Output(
+      ezTestOutput::Duration, "Curve1D EvaluateBaked: %.1f million evaluations per second", fNumEvaluations / tBaked.GetMicroseconds());
+    ezTestFramework::Output(
+      ezTestOutput::Duration, "Curve1D EvaluateBatch: %.1f million evaluations per second", fNumEvaluations / tBatch.GetMicroseconds());
+  }
+}
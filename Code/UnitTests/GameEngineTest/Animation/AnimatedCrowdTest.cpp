@@ -0,0 +1,328 @@
+#include <GameEngineTestPCH.h>
+
+#include <Core/Graphics/Geometry.h>
+#include <Core/World/World.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <GameEngine/Animation/Skeletal/AnimatedMeshComponent.h>
+#include <RendererCore/AnimationSystem/AnimationClipResource.h>
+#include <RendererCore/AnimationSystem/SkeletonBuilder.h>
+#include <RendererCore/AnimationSystem/SkeletonResource.h>
+#include <RendererCore/Meshes/MeshResource.h>
+
+/// \brief Gives the test access to the update state that ezAnimatedMeshComponentManager stores in its components.
+class ezAnimatedCrowdTest
+{
+public:
+  using UpdateState = ezAnimatedMeshComponent::UpdateState;
+  using SharedPoseKey = ezAnimatedMeshComponentManager::SharedPoseKey;
+  using SharedPoseKeyHashHelper = ezAnimatedMeshComponentManager::SharedPoseKeyHashHelper;
+
+  static UpdateState GetUpdateState(const ezAnimatedMeshComponent* pComponent) { return pComponent->m_UpdateState; }
+  static const ezAnimatedMeshComponent* GetSharedPoseSource(const ezAnimatedMeshComponent* pComponent) { return pComponent->m_pSharedPoseSource; }
+  static const ezAnimationPose& GetPose(const ezAnimatedMeshComponent* pComponent) { return pComponent->m_AnimationPose; }
+  static ezArrayPtr<const ezMat4> GetSkinningMatrices(const ezAnimatedMeshComponent* pComponent) { return pComponent->m_SkinningMatrices; }
+
+  static SharedPoseKey CreateSharedPoseKey(const ezAnimatedMeshComponent* pComponent)
+  {
+    SharedPoseKey key;
+    key.m_hAnimationClip = pComponent->m_AnimationClipSampler.GetAnimationClip();
+    key.m_hSkeleton = pComponent->m_hSkeleton;
+    key.m_PrevSampleTime = pComponent->m_AnimationClipSampler.GetPreviousSampleTime();
+    key.m_SampleTime = pComponent->m_AnimationClipSampler.GetSampleTime();
+    key.m_bLoop = pComponent->m_AnimationClipSampler.GetLooping();
+    return key;
+  }
+
+  /// \brief Computes the update interval as PrepareUpdate does when the main view of the world uses the given camera.
+  static ezUInt32 ComputeUpdateInterval(ezAnimatedMeshComponentManager* pManager, const ezAnimatedMeshComponent* pComponent, const ezVec3& vCameraPosition, ezAngle fovY)
+  {
+    pManager->m_bUseScreenSize = true;
+    pManager->m_vCameraPosition = vCameraPosition;
+    pManager->m_fScreenSizeScale = 1.0f / ezMath::Tan(fovY * 0.5f);
+    return pManager->ComputeUpdateInterval(pComponent);
+  }
+};
+
+namespace AnimatedCrowdTestDetail
+{
+  static ezTransform GetJointTransform(ezUInt32 uiJoint, float fTime)
+  {
+    ezVec3 vAxis(ezMath::Sin(ezAngle::Radian(uiJoint * 0.9f)), ezMath::Cos(ezAngle::Radian(uiJoint * 0.4f)), 0.5f);
+    vAxis.Normalize();
+
+    ezTransform t;
+    t.m_vPosition.Set(0.1f, 0.05f * (uiJoint % 4), 0.2f);
+    t.m_qRotation.SetFromAxisAndAngle(vAxis, ezAngle::Radian(ezMath::Sin(ezAngle::Radian(fTime * 2.0f + uiJoint)) * 1.2f));
+    t.m_vScale.Set(1.0f);
+    return t;
+  }
+
+  static ezMeshResourceHandle CreateAnimatedMesh(ezAnimationClipResourceHandle& out_hClip, ezUInt16 uiNumJoints, ezUInt16 uiNumFrames)
+  {
+    ezSkeletonBuilder builder;
+    ezAnimationClipResourceDescriptor clip;
+    clip.Configure(uiNumJoints, uiNumFrames, 30, false);
+
+    ezStringBuilder sName;
+    for (ezUInt16 uiJoint = 0; uiJoint < uiNumJoints; ++uiJoint)
+    {
+      sName.Format("Joint{0}", uiJoint);
+
+      const ezUInt32 uiParent = (uiJoint == 0) ? 0xFFFFFFFFu : ((uiJoint % 6 == 0) ? uiJoint / 2 : uiJoint - 1);
+      builder.AddJoint(sName.GetData(), GetJointTransform(uiJoint, 0.0f), uiParent);
+
+      ezHashedString hs;
+      hs.Assign(sName.GetData());
+      clip.AddJointName(hs);
+
+      ezArrayPtr<ezTransform> keyframes = clip.GetJointKeyframes(uiJoint);
+      for (ezUInt16 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+      {
+        keyframes[uiFrame] = GetJointTransform(uiJoint, uiFrame / 30.0f);
+      }
+    }
+
+    ezSkeletonResourceDescriptor skeleton;
+    builder.BuildSkeleton(skeleton.m_Skeleton);
+
+    out_hClip = ezResourceManager::CreateResource<ezAnimationClipResource>("AnimatedCrowdTestClip", std::move(clip));
+
+    ezMeshResourceDescriptor mesh;
+    mesh.SetSkeleton(ezResourceManager::CreateResource<ezSkeletonResource>("AnimatedCrowdTestSkeleton", std::move(skeleton)));
+
+    // only the bounds of the geometry are needed, the components are never rendered, so the mesh buffer is never loaded
+    ezGeometry geom;
+    geom.AddBox(ezVec3(1.0f), ezColor::White);
+    mesh.MeshBufferDesc().AddCommonStreams();
+    mesh.MeshBufferDesc().AllocateStreamsFromGeometry(geom);
+    mesh.ComputeBounds();
+    mesh.UseExistingMeshBuffer(ezResourceManager::LoadResource<ezMeshBufferResource>("AnimatedCrowdTestMeshBuffer"));
+
+    return ezResourceManager::CreateResource<ezMeshResource>("AnimatedCrowdTestMesh", std::move(mesh));
+  }
+
+  /// \brief All components in the same group play the clip with the same speed and looping, so they end up at the same sample times.
+  static void CreateCrowd(ezWorld& world, const ezMeshResourceHandle& hMesh, const ezAnimationClipResourceHandle& hClip, ezUInt32 uiNumComponents, ezUInt32 uiNumGroups, ezDynamicArray<ezAnimatedMeshComponent*>& out_Components)
+  {
+    world.GetClock().SetFixedTimeStep(ezTime::Seconds(1.0 / 30.0));
+
+    for (ezUInt32 i = 0; i < uiNumComponents; ++i)
+    {
+      const ezUInt32 uiGroup = i % uiNumGroups;
+
+      ezGameObjectDesc desc;
+      desc.m_bDynamic = true;
+      desc.m_LocalPosition.Set((float)(i % 50), (float)(i / 50), 0.0f);
+
+      ezGameObject* pObject;
+      world.CreateObject(desc, pObject);
+
+      ezAnimatedMeshComponent* pComponent;
+      ezAnimatedMeshComponent::CreateComponent(pObject, pComponent);
+      pComponent->SetMesh(hMesh);
+      pComponent->SetAnimationClip(hClip);
+      pComponent->SetAnimationSpeed(0.5f + 0.01f * (uiGroup / 2));
+      pComponent->SetLoopAnimation(uiGroup % 2 == 0);
+
+      out_Components.PushBack(pComponent);
+    }
+  }
+
+  static bool PosesMatch(const ezAnimatedMeshComponent* pComponent, const ezAnimatedMeshComponent* pReference)
+  {
+    ezArrayPtr<const ezMat4> pose = ezAnimatedCrowdTest::GetPose(pComponent).GetAllTransforms();
+    ezArrayPtr<const ezMat4> refPose = ezAnimatedCrowdTest::GetPose(pReference).GetAllTransforms();
+    ezArrayPtr<const ezMat4> skinning = ezAnimatedCrowdTest::GetSkinningMatrices(pComponent);
+    ezArrayPtr<const ezMat4> refSkinning = ezAnimatedCrowdTest::GetSkinningMatrices(pReference);
+
+    if (pose.GetCount() != refPose.GetCount() || skinning.GetCount() != refSkinning.GetCount())
+      return false;
+
+    return ezMemoryUtils::Compare(pose.GetPtr(), refPose.GetPtr(), pose.GetCount()) == 0 &&
+           ezMemoryUtils::Compare(skinning.GetPtr(), refSkinning.GetPtr(), skinning.GetCount()) == 0;
+  }
+} // namespace AnimatedCrowdTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Animation, AnimatedCrowd)
+{
+  using namespace AnimatedCrowdTestDetail;
+
+  const ezUInt32 uiNumGroups = 16;
+
+  ezAnimationClipResourceHandle hClip;
+  ezMeshResourceHandle hMesh = CreateAnimatedMesh(hClip, 60, 90);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Shared poses")
+  {
+    const ezUInt32 uiNumCharacters = 200;
+
+    // every component samples its own pose in the reference world
+    ezWorldDesc referenceDesc("AnimatedCrowdReference");
+    ezWorld referenceWorld(referenceDesc);
+    EZ_LOCK(referenceWorld.GetWriteMarker());
+
+    ezDynamicArray<ezAnimatedMeshComponent*> reference;
+    CreateCrowd(referenceWorld, hMesh, hClip, uiNumGroups, uiNumGroups, reference);
+
+    ezWorldDesc crowdDesc("AnimatedCrowd");
+    ezWorld crowdWorld(crowdDesc);
+    EZ_LOCK(crowdWorld.GetWriteMarker());
+
+    ezDynamicArray<ezAnimatedMeshComponent*> crowd;
+    CreateCrowd(crowdWorld, hMesh, hClip, uiNumCharacters, uiNumGroups, crowd);
+
+    for (ezUInt32 uiFrame = 0; uiFrame < 10; ++uiFrame)
+    {
+      referenceWorld.Update();
+      crowdWorld.Update();
+
+      for (const ezAnimatedMeshComponent* pComponent : reference)
+      {
+        EZ_TEST_BOOL(ezAnimatedCrowdTest::GetUpdateState(pComponent) == ezAnimatedCrowdTest::UpdateState::SamplePose);
+      }
+
+      ezUInt32 uiNumSampled = 0;
+      ezUInt32 uiNumShared = 0;
+      ezUInt32 uiNumMismatches = 0;
+
+      for (ezUInt32 i = 0; i < uiNumCharacters; ++i)
+      {
+        const ezAnimatedMeshComponent* pComponent = crowd[i];
+
+        if (ezAnimatedCrowdTest::GetUpdateState(pComponent) == ezAnimatedCrowdTest::UpdateState::SamplePose)
+        {
+          ++uiNumSampled;
+        }
+        else if (ezAnimatedCrowdTest::GetUpdateState(pComponent) == ezAnimatedCrowdTest::UpdateState::SharePose)
+        {
+          ++uiNumShared;
+
+          // the first component of every group samples the pose for all others
+          const ezAnimatedMeshComponent* pSource = ezAnimatedCrowdTest::GetSharedPoseSource(pComponent);
+          EZ_TEST_BOOL(pSource == crowd[i % uiNumGroups]);
+        }
+
+        if (!PosesMatch(pComponent, reference[i % uiNumGroups]))
+          ++uiNumMismatches;
+      }
+
+      EZ_TEST_INT(uiNumSampled, uiNumGroups);
+      EZ_TEST_INT(uiNumShared, uiNumCharacters - uiNumGroups);
+      EZ_TEST_INT(uiNumMismatches, 0);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "SharedPoseKey")
+  {
+    ezWorldDesc worldDesc("AnimatedCrowdKeys");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezDynamicArray<ezAnimatedMeshComponent*> components;
+    CreateCrowd(world, hMesh, hClip, 4, 4, components);
+    world.Update();
+
+    using Key = ezAnimatedCrowdTest::SharedPoseKey;
+    using Helper = ezAnimatedCrowdTest::SharedPoseKeyHashHelper;
+
+    const Key key = ezAnimatedCrowdTest::CreateSharedPoseKey(components[0]);
+
+    Key same = key;
+    EZ_TEST_BOOL(Helper::Equal(key, same));
+    EZ_TEST_INT(Helper::Hash(key), Helper::Hash(same));
+
+    // components 0 and 1 only differ in looping, 0 and 2 in speed
+    EZ_TEST_BOOL(!Helper::Equal(key, ezAnimatedCrowdTest::CreateSharedPoseKey(components[1])));
+    EZ_TEST_BOOL(!Helper::Equal(key, ezAnimatedCrowdTest::CreateSharedPoseKey(components[2])));
+
+    // a different previous sample time results in different root motion
+    Key prevTime = key;
+    prevTime.m_PrevSampleTime += ezTime::Milliseconds(1);
+    EZ_TEST_BOOL(!Helper::Equal(key, prevTime));
+
+    Key otherClip = key;
+    otherClip.m_hAnimationClip.Invalidate();
+    EZ_TEST_BOOL(!Helper::Equal(key, otherClip));
+
+    Key otherSkeleton = key;
+    otherSkeleton.m_hSkeleton.Invalidate();
+    EZ_TEST_BOOL(!Helper::Equal(key, otherSkeleton));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ComputeUpdateInterval")
+  {
+    ezWorldDesc worldDesc("AnimatedCrowdUpdateInterval");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezDynamicArray<ezAnimatedMeshComponent*> components;
+    CreateCrowd(world, hMesh, hClip, 1, 1, components);
+    world.Update();
+
+    ezAnimatedMeshComponent* pComponent = components[0];
+    ezAnimatedMeshComponentManager* pManager = pComponent->GetWorld()->GetOrCreateComponentManager<ezAnimatedMeshComponentManager>();
+    pManager->SetFullUpdateScreenSize(0.1f);
+    pManager->SetMaxUpdateInterval(4);
+
+    const ezBoundingBoxSphere bounds = pComponent->GetOwner()->GetGlobalBounds();
+    EZ_TEST_BOOL(bounds.IsValid());
+
+    // with a 90 degree field of view, the screen size is the sphere radius divided by the distance to the sphere
+    auto ComputeInterval = [&](float fScreenSize) {
+      const ezVec3 vCameraPosition = bounds.m_vCenter - ezVec3(bounds.m_fSphereRadius + bounds.m_fSphereRadius / fScreenSize, 0, 0);
+      return ezAnimatedCrowdTest::ComputeUpdateInterval(pManager, pComponent, vCameraPosition, ezAngle::Degree(90.0f));
+    };
+
+    EZ_TEST_INT(ComputeInterval(0.5f), 1);
+    EZ_TEST_INT(ComputeInterval(0.11f), 1);
+    EZ_TEST_INT(ComputeInterval(0.04f), 3);
+    EZ_TEST_INT(ComputeInterval(0.001f), 4);
+
+    pManager->SetMaxUpdateInterval(8);
+    EZ_TEST_INT(ComputeInterval(0.001f), 8);
+    EZ_TEST_INT(ComputeInterval(0.04f), 3);
+
+    pManager->SetFullUpdateScreenSize(0.01f);
+    EZ_TEST_INT(ComputeInterval(0.04f), 1);
+
+    // inside the bounding sphere
+    EZ_TEST_INT(ezAnimatedCrowdTest::ComputeUpdateInterval(pManager, pComponent, bounds.m_vCenter, ezAngle::Degree(90.0f)), 1);
+
+    // without a main view of this world all components are updated every frame
+    world.Update();
+    EZ_TEST_BOOL(ezAnimatedCrowdTest::GetUpdateState(pComponent) == ezAnimatedCrowdTest::UpdateState::SamplePose);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Benchmark")
+  {
+    const ezUInt32 uiNumCharacters = 2000;
+    const ezUInt32 uiNumFrames = 10;
+
+    auto MeasureUpdate = [&](const char* szName, ezUInt32 uiNumDistinctGroups) {
+      ezWorldDesc worldDesc(szName);
+      ezWorld world(worldDesc);
+      EZ_LOCK(world.GetWriteMarker());
+
+      ezDynamicArray<ezAnimatedMeshComponent*> components;
+      CreateCrowd(world, hMesh, hClip, uiNumCharacters, uiNumDistinctGroups, components);
+
+      // initializes the components
+      world.Update();
+
+      ezStopwatch sw;
+
+      for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+      {
+        world.Update();
+      }
+
+      return sw.GetRunningTotal() / uiNumFrames;
+    };
+
+    const ezTime tDistinct = MeasureUpdate("AnimatedCrowdDistinct", uiNumCharacters);
+    const ezTime tShared = MeasureUpdate("AnimatedCrowdShared", uiNumGroups);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%u characters, world update: %.2fms with distinct poses, %.2fms with %u shared poses", uiNumCharacters,
+      tDistinct.GetMilliseconds(), tShared.GetMilliseconds(), uiNumGroups);
+  }
+}
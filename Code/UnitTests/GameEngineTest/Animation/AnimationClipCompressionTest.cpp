@@ -0,0 +1,275 @@
+#include <GameEngineTestPCH.h>
+
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <RendererCore/AnimationSystem/AnimationClipCompression.h>
+#include <RendererCore/AnimationSystem/AnimationClipResource.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Animation);
+
+namespace AnimationClipCompressionTestDetail
+{
+  /// Fills a clip with a mix of constant, slowly and quickly changing tracks, similar to what mocap data looks like.
+  static void CreateBenchmarkClip(ezAnimationClipResourceDescriptor& desc, ezUInt16 uiNumJoints, ezUInt16 uiNumFrames)
+  {
+    desc.Configure(uiNumJoints, uiNumFrames, 30, false);
+
+    ezStringBuilder sName;
+    for (ezUInt16 uiJoint = 0; uiJoint < uiNumJoints; ++uiJoint)
+    {
+      sName.Format("Joint{0}", uiJoint);
+      ezHashedString hs;
+      hs.Assign(sName.GetData());
+      desc.AddJointName(hs);
+
+      ezVec3 vAxis(ezMath::Sin(ezAngle::Radian(uiJoint * 1.0f)), ezMath::Cos(ezAngle::Radian(uiJoint * 1.0f)), 0.5f);
+      vAxis.Normalize();
+
+      const float fSpeed = 0.01f + (uiJoint % 7) * 0.02f;
+      const bool bConstantTranslation = (uiJoint % 3) != 0;
+
+      ezArrayPtr<ezTransform> keyframes = desc.GetJointKeyframes(uiJoint);
+      for (ezUInt16 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+      {
+        ezTransform& t = keyframes[uiFrame];
+        t.m_vPosition.Set(0.1f * uiJoint, 0, 0.2f);
+        if (!bConstantTranslation)
+          t.m_vPosition.z += ezMath::Sin(ezAngle::Radian(uiFrame * fSpeed)) * 0.5f;
+
+        t.m_qRotation.SetFromAxisAndAngle(vAxis, ezAngle::Radian(ezMath::Sin(ezAngle::Radian(uiFrame * fSpeed)) * 1.5f));
+        t.m_vScale.Set(1.0f);
+      }
+    }
+  }
+
+  static bool IsSameRotation(const ezQuat& q0, const ezQuat& q1, float fEpsilon)
+  {
+    // q and -q represent the same rotation
+    return ezMath::Abs(q0.v.Dot(q1.v) + q0.w * q1.w) >= 1.0f - fEpsilon;
+  }
+} // namespace AnimationClipCompressionTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Animation, AnimationClipCompression)
+{
+  using namespace AnimationClipCompressionTestDetail;
+
+  const ezUInt16 uiNumJoints = 60;
+  const ezUInt16 uiNumFrames = 300;
+
+  ezAnimationClipResourceDescriptor raw;
+  CreateBenchmarkClip(raw, uiNumJoints, uiNumFrames);
+
+  ezAnimationClipCompressionSettings settings;
+
+  ezAnimationClipResourceDescriptor compressed;
+  CreateBenchmarkClip(compressed, uiNumJoints, uiNumFrames);
+  compressed.Compress(settings);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Accuracy")
+  {
+    EZ_TEST_BOOL(compressed.IsCompressed());
+    EZ_TEST_BOOL(!raw.IsCompressed());
+
+    for (ezUInt16 uiJoint = 0; uiJoint < uiNumJoints; ++uiJoint)
+    {
+      for (ezUInt16 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+      {
+        const ezTransform t0 = raw.GetJointKeyframe(uiJoint, uiFrame);
+        const ezTransform t1 = compressed.GetJointKeyframe(uiJoint, uiFrame);
+
+        EZ_TEST_VEC3(t0.m_vPosition, t1.m_vPosition, 0.002f);
+        EZ_TEST_VEC3(t0.m_vScale, t1.m_vScale, 0.002f);
+        EZ_TEST_BOOL(IsSameRotation(t0.m_qRotation, t1.m_qRotation, 0.0001f));
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "SIMD sampling matches single joint decompression")
+  {
+    ezCompressedAnimationClip clip;
+    // the keyframes of all joints are stored consecutively
+    clip.Compress(ezArrayPtr<const ezTransform>(raw.GetJointKeyframes(0).GetPtr(), uiNumJoints * uiNumFrames), uiNumJoints, uiNumFrames, settings);
+
+    ezDynamicArray<ezTransform> pose;
+    pose.SetCountUninitialized(uiNumJoints);
+
+    for (ezUInt16 uiFrame = 0; uiFrame < uiNumFrames; uiFrame += 7)
+    {
+      clip.SamplePose(uiFrame, 0.0f, pose);
+
+      for (ezUInt16 uiJoint = 0; uiJoint < uiNumJoints; ++uiJoint)
+      {
+        const ezTransform t = clip.GetJointKeyframe(uiJoint, uiFrame);
+
+        EZ_TEST_VEC3(pose[uiJoint].m_vPosition, t.m_vPosition, 0.0001f);
+        EZ_TEST_VEC3(pose[uiJoint].m_vScale, t.m_vScale, 0.0001f);
+        EZ_TEST_BOOL(IsSameRotation(pose[uiJoint].m_qRotation, t.m_qRotation, 0.00001f));
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Save / Load")
+  {
+    ezMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    ezMemoryStreamReader reader(&storage);
+
+    compressed.Save(writer);
+
+    ezAnimationClipResourceDescriptor loaded;
+    loaded.Load(reader);
+
+    EZ_TEST_BOOL(loaded.IsCompressed());
+    EZ_TEST_INT(loaded.GetNumFrames(), uiNumFrames);
+    EZ_TEST_INT(loaded.GetHeapMemoryUsage(), compressed.GetHeapMemoryUsage());
+
+    for (ezUInt16 uiJoint = 0; uiJoint < uiNumJoints; uiJoint += 5)
+    {
+      const ezTransform t0 = compressed.GetJointKeyframe(uiJoint, 42);
+      const ezTransform t1 = loaded.GetJointKeyframe(uiJoint, 42);
+
+      EZ_TEST_VEC3(t0.m_vPosition, t1.m_vPosition, 0.00001f);
+      EZ_TEST_VEC3(t0.m_vScale, t1.m_vScale, 0.00001f);
+      EZ_TEST_BOOL(IsSameRotation(t0.m_qRotation, t1.m_qRotation, 0.00001f));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Large ranges and small tolerances")
+  {
+    // a root joint that travels far, quantizing its translation to 16 bit over the whole range would exceed the tolerance
+    const ezUInt16 uiNumLargeFrames = 200;
+
+    ezDynamicArray<ezTransform> transforms;
+    transforms.SetCount(uiNumJoints * uiNumLargeFrames);
+
+    for (ezUInt16 uiJoint = 0; uiJoint < uiNumJoints; ++uiJoint)
+    {
+      for (ezUInt16 uiFrame = 0; uiFrame < uiNumLargeFrames; ++uiFrame)
+      {
+        ezTransform& t = transforms[uiJoint * uiNumLargeFrames + uiFrame];
+        t.SetIdentity();
+        t.m_vPosition.Set(uiFrame * 25.0f * uiJoint, ezMath::Sin(ezAngle::Radian(uiFrame * 0.3f)), 0.0f);
+        t.m_qRotation.SetFromAxisAndAngle(ezVec3(0, 0, 1), ezAngle::Radian(ezMath::Sin(ezAngle::Radian(uiFrame * 0.05f + uiJoint))));
+      }
+    }
+
+    for (float fTolerance : {0.001f, 0.00005f})
+    {
+      ezAnimationClipCompressionSettings tightSettings;
+      tightSettings.m_fTranslationTolerance = fTolerance;
+      tightSettings.m_fRotationTolerance = fTolerance;
+
+      ezCompressedAnimationClip clip;
+      clip.Compress(transforms, uiNumJoints, uiNumLargeFrames, tightSettings);
+
+      ezDynamicArray<ezTransform> pose;
+      pose.SetCountUninitialized(uiNumJoints);
+
+      for (ezUInt16 uiFrame = 0; uiFrame < uiNumLargeFrames; ++uiFrame)
+      {
+        clip.SamplePose(uiFrame, 0.0f, pose);
+
+        for (ezUInt16 uiJoint = 0; uiJoint < uiNumJoints; ++uiJoint)
+        {
+          const ezTransform& t0 = transforms[uiJoint * uiNumLargeFrames + uiFrame];
+          const ezTransform t1 = clip.GetJointKeyframe(uiJoint, uiFrame);
+
+          // positions of up to 300000 units can't be represented more exactly than this by floats
+          const float fPositionEpsilon = fTolerance + t0.m_vPosition.GetLength() * 1e-7f;
+
+          EZ_TEST_VEC3(t0.m_vPosition, t1.m_vPosition, fPositionEpsilon);
+          EZ_TEST_VEC3(pose[uiJoint].m_vPosition, t1.m_vPosition, fPositionEpsilon);
+
+          const ezVec4 q0(t0.m_qRotation.v.x, t0.m_qRotation.v.y, t0.m_qRotation.v.z, t0.m_qRotation.w);
+          const ezVec4 q1(t1.m_qRotation.v.x, t1.m_qRotation.v.y, t1.m_qRotation.v.z, t1.m_qRotation.w);
+          EZ_TEST_BOOL(q0.IsEqual(q1, fTolerance * 1.01f) || q0.IsEqual(-q1, fTolerance * 1.01f));
+          EZ_TEST_BOOL(IsSameRotation(pose[uiJoint].m_qRotation, t1.m_qRotation, 0.00001f));
+        }
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "No frames and a single frame")
+  {
+    ezCompressedAnimationClip clip;
+    clip.Compress(ezArrayPtr<const ezTransform>(), uiNumJoints, 0, settings);
+    EZ_TEST_BOOL(clip.IsEmpty());
+
+    ezDynamicArray<ezTransform> frame;
+    frame.SetCountUninitialized(uiNumJoints);
+    for (ezUInt16 uiJoint = 0; uiJoint < uiNumJoints; ++uiJoint)
+    {
+      frame[uiJoint] = raw.GetJointKeyframe(uiJoint, 100);
+    }
+
+    clip.Compress(frame, uiNumJoints, 1, settings);
+    EZ_TEST_BOOL(!clip.IsEmpty());
+
+    ezDynamicArray<ezTransform> pose;
+    pose.SetCountUninitialized(uiNumJoints);
+
+    // sampling beyond the only frame returns that frame
+    for (float fLerp : {0.0f, 0.5f, 1.0f})
+    {
+      clip.SamplePose(0, fLerp, pose);
+
+      for (ezUInt16 uiJoint = 0; uiJoint < uiNumJoints; ++uiJoint)
+      {
+        EZ_TEST_VEC3(pose[uiJoint].m_vPosition, frame[uiJoint].m_vPosition, 0.002f);
+        EZ_TEST_VEC3(pose[uiJoint].m_vScale, frame[uiJoint].m_vScale, 0.002f);
+        EZ_TEST_BOOL(IsSameRotation(pose[uiJoint].m_qRotation, frame[uiJoint].m_qRotation, 0.0001f));
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Memory and sampling throughput")
+  {
+    const ezUInt64 uiRawMemory = raw.GetHeapMemoryUsage();
+    const ezUInt64 uiCompressedMemory = compressed.GetHeapMemoryUsage();
+
+    EZ_TEST_BOOL(uiCompressedMemory < uiRawMemory / 2);
+
+    ezTestFramework::Output(ezTestOutput::Details, "Clip with %u joints, %u frames: raw %llu bytes, compressed %llu bytes (%.1f%%)", uiNumJoints, uiNumFrames, uiRawMemory, uiCompressedMemory, 100.0 * uiCompressedMemory / uiRawMemory);
+
+    ezCompressedAnimationClip clip;
+    clip.Compress(ezArrayPtr<const ezTransform>(raw.GetJointKeyframes(0).GetPtr(), uiNumJoints * uiNumFrames), uiNumJoints, uiNumFrames, settings);
+
+    ezDynamicArray<ezTransform> pose;
+    pose.SetCountUninitialized(uiNumJoints);
+
+    const ezUInt32 uiNumSamples = 2000;
+
+    ezStopwatch sw;
+
+    for (ezUInt32 s = 0; s < uiNumSamples; ++s)
+    {
+      const ezUInt16 uiFrame = s % (uiNumFrames - 1);
+      const float fLerp = (s % 10) * 0.1f;
+
+      for (ezUInt16 uiJoint = 0; uiJoint < uiNumJoints; ++uiJoint)
+      {
+        ezArrayPtr<const ezTransform> keyframes = raw.GetJointKeyframes(uiJoint);
+        const ezTransform& t0 = keyframes[uiFrame];
+        const ezTransform& t1 = keyframes[uiFrame + 1];
+
+        ezTransform& res = pose[uiJoint];
+        res.m_vPosition = ezMath::Lerp(t0.m_vPosition, t1.m_vPosition, fLerp);
+        res.m_qRotation.SetSlerp(t0.m_qRotation, t1.m_qRotation, fLerp);
+        res.m_vScale = ezMath::Lerp(t0.m_vScale, t1.m_vScale, fLerp);
+      }
+    }
+
+    const ezTime tRaw = sw.Checkpoint();
+
+    for (ezUInt32 s = 0; s < uiNumSamples; ++s)
+    {
+      clip.SamplePose(s % (uiNumFrames - 1), (s % 10) * 0.1f, pose);
+    }
+
+    const ezTime tCompressed = sw.Checkpoint();
+
+    const double fNumJointSamples = (double)uiNumSamples * uiNumJoints;
+    ezTestFramework::Output(ezTestOutput::Duration, "Raw sampling: %.2fms (%.1f M joints/s)", tRaw.GetMilliseconds(), fNumJointSamples / tRaw.GetSeconds() / 1000000.0);
+    ezTestFramework::Output(ezTestOutput::Duration, "Compressed sampling: %.2fms (%.1f M joints/s)", tCompressed.GetMilliseconds(), fNumJointSamples / tCompressed.GetSeconds() / 1000000.0);
+  }
+}
@@ -0,0 +1,257 @@
+#include <GameEngineTestPCH.h>
+
+#include <Foundation/Time/Stopwatch.h>
+#include <RendererCore/AnimationSystem/AnimationPose.h>
+#include <RendererCore/AnimationSystem/LocalAnimationPose.h>
+#include <RendererCore/AnimationSystem/Skeleton.h>
+#include <RendererCore/AnimationSystem/SkeletonBuilder.h>
+
+namespace AnimationPoseTestDetail
+{
+  static ezTransform GetJointTransform(ezUInt32 uiJoint, float fTime)
+  {
+    ezVec3 vAxis(ezMath::Sin(ezAngle::Radian(uiJoint * 1.3f)), ezMath::Cos(ezAngle::Radian(uiJoint * 0.7f)), 0.5f);
+    vAxis.Normalize();
+
+    ezTransform t;
+    t.m_vPosition.Set(0.1f, 0.05f * (uiJoint % 5), 0.2f);
+    t.m_qRotation.SetFromAxisAndAngle(vAxis, ezAngle::Radian(ezMath::Sin(ezAngle::Radian(fTime + uiJoint)) * 1.5f));
+    t.m_vScale.Set(1.0f + 0.1f * (uiJoint % 3), 1.0f, 1.0f - 0.05f * (uiJoint % 2));
+    return t;
+  }
+
+  /// Builds a skeleton with several chains branching off from earlier joints, similar to a humanoid with fingers.
+  static void CreateSkeleton(ezSkeleton& skeleton, ezUInt16 uiNumJoints)
+  {
+    ezSkeletonBuilder builder;
+
+    ezStringBuilder sName;
+    for (ezUInt32 i = 0; i < uiNumJoints; ++i)
+    {
+      sName.Format("Joint{0}", i);
+
+      const ezUInt32 uiParent = (i == 0) ? 0xFFFFFFFFu : ((i % 7 == 0) ? i / 3 : i - 1);
+      builder.AddJoint(sName.GetData(), GetJointTransform(i, 0.0f), uiParent);
+    }
+
+    builder.BuildSkeleton(skeleton);
+  }
+
+  static bool IsEqual(const ezMat4& m0, const ezMat4& m1, float fEpsilon)
+  {
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      if (!ezMath::IsEqual(m0.m_fElementsCM[i], m1.m_fElementsCM[i], fEpsilon))
+        return false;
+    }
+
+    return true;
+  }
+
+  static bool IsEqual(const ezTransform& t0, const ezTransform& t1, float fEpsilon)
+  {
+    // the blended rotation may end up as -q, which is the same rotation
+    const float fDot = t0.m_qRotation.v.Dot(t1.m_qRotation.v) + t0.m_qRotation.w * t1.m_qRotation.w;
+
+    return t0.m_vPosition.IsEqual(t1.m_vPosition, fEpsilon) && t0.m_vScale.IsEqual(t1.m_vScale, fEpsilon) && ezMath::Abs(fDot) >= 1.0f - fEpsilon;
+  }
+} // namespace AnimationPoseTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Animation, LocalAnimationPose)
+{
+  using namespace AnimationPoseTestDetail;
+
+  ezSkeleton skeleton;
+  CreateSkeleton(skeleton, 61);
+  const ezUInt16 uiNumJoints = skeleton.GetJointCount();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Model and skinning space")
+  {
+    ezLocalAnimationPose localPose;
+    localPose.Configure(skeleton);
+
+    ezAnimationPose reference;
+    reference.Configure(skeleton);
+
+    for (ezUInt16 i = 0; i < uiNumJoints; ++i)
+    {
+      const ezTransform t = GetJointTransform(i, 2.0f);
+      localPose.SetJointTransform(i, t);
+      reference.SetTransform(i, t.GetAsMat4());
+    }
+
+    reference.ConvertFromLocalSpaceToObjectSpace(skeleton);
+
+    ezAnimationPose pose;
+    pose.Configure(skeleton);
+
+    ezDynamicArray<ezMat4> skinning;
+    skinning.SetCountUninitialized(uiNumJoints);
+    pose.SetFromLocalPose(skeleton, localPose, skinning);
+
+    for (ezUInt16 i = 0; i < uiNumJoints; ++i)
+    {
+      EZ_TEST_BOOL(IsEqual(pose.GetTransform(i), reference.GetTransform(i), 0.0001f));
+      EZ_TEST_BOOL(pose.IsTransformValid(i));
+    }
+
+    reference.ConvertFromObjectSpaceToSkinningSpace(skeleton);
+
+    for (ezUInt16 i = 0; i < uiNumJoints; ++i)
+    {
+      EZ_TEST_BOOL(IsEqual(skinning[i], reference.GetTransform(i), 0.0001f));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Blend")
+  {
+    ezLocalAnimationPose pose0, pose1;
+    pose0.Configure(skeleton);
+    pose1.Configure(skeleton);
+
+    for (ezUInt16 i = 0; i < uiNumJoints; ++i)
+    {
+      pose1.SetJointTransform(i, GetJointTransform(i, 1.0f));
+    }
+
+    ezLocalAnimationPose res = pose0;
+    res.Blend(pose1, 0.0f);
+
+    for (ezUInt16 i = 0; i < uiNumJoints; ++i)
+    {
+      EZ_TEST_BOOL(IsEqual(res.GetJointTransform(i), pose0.GetJointTransform(i), 0.0001f));
+    }
+
+    res.Blend(pose1, 1.0f);
+
+    for (ezUInt16 i = 0; i < uiNumJoints; ++i)
+    {
+      EZ_TEST_BOOL(IsEqual(res.GetJointTransform(i), pose1.GetJointTransform(i), 0.0001f));
+    }
+
+    // only blend the hierarchy below joint 10
+    ezAnimationJointMask mask;
+    mask.Configure(skeleton, 0.0f);
+    mask.SetHierarchyWeight(skeleton, 10, 1.0f);
+
+    res = pose0;
+    res.Blend(pose1, 1.0f, &mask);
+
+    for (ezUInt16 i = 0; i < uiNumJoints; ++i)
+    {
+      const ezLocalAnimationPose& expected = skeleton.IsJointDescendantOf(i, 10) ? pose1 : pose0;
+      EZ_TEST_BOOL(IsEqual(res.GetJointTransform(i), expected.GetJointTransform(i), 0.0001f));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Additive")
+  {
+    ezLocalAnimationPose base, target;
+    base.Configure(skeleton);
+    target.Configure(skeleton);
+
+    for (ezUInt16 i = 0; i < uiNumJoints; ++i)
+    {
+      target.SetJointTransform(i, GetJointTransform(i, 3.0f));
+    }
+
+    ezLocalAnimationPose additive = target;
+    additive.MakeAdditive(base);
+
+    ezLocalAnimationPose res = base;
+    res.BlendAdditive(additive, 1.0f);
+
+    for (ezUInt16 i = 0; i < uiNumJoints; ++i)
+    {
+      EZ_TEST_BOOL(IsEqual(res.GetJointTransform(i), target.GetJointTransform(i), 0.0001f));
+    }
+
+    res = base;
+    res.BlendAdditive(additive, 0.0f);
+
+    for (ezUInt16 i = 0; i < uiNumJoints; ++i)
+    {
+      EZ_TEST_BOOL(IsEqual(res.GetJointTransform(i), base.GetJointTransform(i), 0.0001f));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Benchmark")
+  {
+    const ezUInt16 jointCounts[] = {60, 200};
+    const ezUInt32 skeletonCounts[] = {100, 1000};
+
+    for (ezUInt16 uiJoints : jointCounts)
+    {
+      ezSkeleton benchSkeleton;
+      CreateSkeleton(benchSkeleton, uiJoints);
+
+      ezLocalAnimationPose blendTarget;
+      blendTarget.Configure(benchSkeleton);
+      for (ezUInt16 i = 0; i < uiJoints; ++i)
+      {
+        blendTarget.SetJointTransform(i, GetJointTransform(i, 1.0f));
+      }
+
+      for (ezUInt32 uiSkeletons : skeletonCounts)
+      {
+        ezDynamicArray<ezAnimationPose> poses;
+        ezDynamicArray<ezLocalAnimationPose> localPoses;
+        poses.SetCount(uiSkeletons);
+        localPoses.SetCount(uiSkeletons);
+
+        for (ezUInt32 s = 0; s < uiSkeletons; ++s)
+        {
+          poses[s].Configure(benchSkeleton);
+          localPoses[s].Configure(benchSkeleton);
+        }
+
+        ezDynamicArray<ezMat4> skinning;
+        skinning.SetCountUninitialized(uiJoints);
+
+        ezDynamicArray<ezTransform> blendTransforms;
+        blendTransforms.SetCountUninitialized(uiJoints);
+        for (ezUInt16 i = 0; i < uiJoints; ++i)
+        {
+          blendTransforms[i] = blendTarget.GetJointTransform(i);
+        }
+
+        // previous pipeline: blend per joint, concatenate matrices, transform into skinning space in place
+        ezStopwatch sw;
+        for (ezUInt32 s = 0; s < uiSkeletons; ++s)
+        {
+          ezAnimationPose& pose = poses[s];
+
+          for (ezUInt16 i = 0; i < uiJoints; ++i)
+          {
+            const ezTransform& t0 = benchSkeleton.GetJointByIndex(i).GetBindPoseLocalTransform();
+            const ezTransform& t1 = blendTransforms[i];
+
+            ezTransform res;
+            res.m_vPosition = ezMath::Lerp(t0.m_vPosition, t1.m_vPosition, 0.5f);
+            res.m_qRotation.SetSlerp(t0.m_qRotation, t1.m_qRotation, 0.5f);
+            res.m_vScale = ezMath::Lerp(t0.m_vScale, t1.m_vScale, 0.5f);
+
+            pose.SetTransform(i, res.GetAsMat4());
+          }
+
+          pose.ConvertFromLocalSpaceToObjectSpace(benchSkeleton);
+          pose.ConvertFromObjectSpaceToSkinningSpace(benchSkeleton);
+        }
+        const ezTime tScalar = sw.Checkpoint();
+
+        // SoA pipeline: blend four joints at a time, object and skinning space in one pass
+        for (ezUInt32 s = 0; s < uiSkeletons; ++s)
+        {
+          ezLocalAnimationPose& localPose = localPoses[s];
+          localPose.SetToBindPose(benchSkeleton);
+          localPose.Blend(blendTarget, 0.5f);
+
+          poses[s].SetFromLocalPose(benchSkeleton, localPose, skinning);
+        }
+        const ezTime tSoA = sw.Checkpoint();
+
+        ezTestFramework::Output(ezTestOutput::Duration, "%u skeletons with %u joints: per joint %.2fms, SoA %.2fms", uiSkeletons, uiJoints, tScalar.GetMilliseconds(), tSoA.GetMilliseconds());
+      }
+    }
+  }
+}
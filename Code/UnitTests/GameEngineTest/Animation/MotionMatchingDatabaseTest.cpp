@@ -0,0 +1,220 @@
+#include <GameEngineTestPCH.h>
+
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <GameEngine/Animation/Skeletal/MotionMatchingDatabase.h>
+
+namespace MotionMatchingDatabaseTestDetail
+{
+  static const ezUInt16 s_uiFramesPerClip = 2000;
+
+  /// Creates frames that resemble a set of looping locomotion clips, each moving into a different direction.
+  static void CreateFrames(ezDynamicArray<ezMotionMatchingDatabase::Frame>& frames, ezUInt32 uiNumFrames, ezRandom& rng)
+  {
+    frames.SetCount(uiNumFrames);
+
+    for (ezUInt32 i = 0; i < uiNumFrames; ++i)
+    {
+      ezMotionMatchingDatabase::Frame& frame = frames[i];
+      frame.m_uiAnimClip = static_cast<ezUInt16>(i / s_uiFramesPerClip);
+      frame.m_uiKeyframe = static_cast<ezUInt16>(i % s_uiFramesPerClip);
+
+      const float fPhase = ezMath::Sin(ezAngle::Radian(frame.m_uiKeyframe * 0.1f + frame.m_uiAnimClip));
+      const ezAngle clipDir = ezAngle::Radian(frame.m_uiAnimClip * 0.7f);
+
+      frame.m_vLeftFootPosition.Set(fPhase * 0.3f, 0.1f, 0.05f + (float)rng.DoubleInRange(0.0, 0.01));
+      frame.m_vRightFootPosition.Set(-fPhase * 0.3f, -0.1f, 0.05f);
+      frame.m_vRootVelocity.Set(ezMath::Cos(clipDir) * 3.0f + (float)rng.DoubleMinMax(-0.2, 0.2), ezMath::Sin(clipDir) * 3.0f, 0.0f);
+    }
+  }
+
+  static ezMotionMatchingDatabase::Query CreateQuery(const ezDynamicArray<ezMotionMatchingDatabase::Frame>& frames, ezRandom& rng)
+  {
+    const ezMotionMatchingDatabase::Frame& current = frames[rng.UIntInRange(frames.GetCount())];
+
+    ezMotionMatchingDatabase::Query query;
+    query.m_uiCurrentAnimClip = current.m_uiAnimClip;
+    query.m_uiCurrentKeyframe = current.m_uiKeyframe;
+    query.m_vLeftFootPosition = current.m_vLeftFootPosition + ezVec3((float)rng.DoubleMinMax(-0.1, 0.1), 0, 0);
+    query.m_vRightFootPosition = current.m_vRightFootPosition;
+    query.m_vTargetVelocity.Set((float)rng.DoubleMinMax(-3.0, 3.0), (float)rng.DoubleMinMax(-3.0, 3.0), 0.0f);
+    return query;
+  }
+} // namespace MotionMatchingDatabaseTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Animation, MotionMatchingDatabase)
+{
+  using namespace MotionMatchingDatabaseTestDetail;
+
+  ezRandom rng;
+  rng.Initialize(42);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Tree vs. brute force")
+  {
+    ezDynamicArray<ezMotionMatchingDatabase::Frame> frames;
+    CreateFrames(frames, 20000, rng);
+
+    ezMotionMatchingDatabase db;
+    db.Build(frames);
+    EZ_TEST_INT(db.GetNumFrames(), 20000);
+
+    for (ezUInt32 q = 0; q < 500; ++q)
+    {
+      const ezMotionMatchingDatabase::Query query = CreateQuery(frames, rng);
+
+      const ezUInt32 uiTree = db.FindBestFrame(query);
+      const ezUInt32 uiBrute = db.FindBestFrameBruteForce(query);
+
+      // ties may be resolved differently, but the cost has to be the same
+      EZ_TEST_FLOAT(db.ComputeCost(query, uiTree), db.ComputeCost(query, uiBrute), 0.0f);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Penalties")
+  {
+    // two clips with identical frames, so only the penalties decide
+    ezDynamicArray<ezMotionMatchingDatabase::Frame> frames;
+    for (ezUInt16 clip = 0; clip < 2; ++clip)
+    {
+      for (ezUInt16 kf = 0; kf < 30; ++kf)
+      {
+        ezMotionMatchingDatabase::Frame& frame = frames.ExpandAndGetRef();
+        frame.m_uiAnimClip = clip;
+        frame.m_uiKeyframe = kf;
+        frame.m_vLeftFootPosition.Set(0, 0.1f * (kf % 10), 0);
+        frame.m_vRightFootPosition.Set(0, -0.1f * (kf % 10), 0);
+        frame.m_vRootVelocity.Set(1, 0, 0);
+      }
+    }
+
+    ezMotionMatchingSettings settings;
+    settings.m_fTransitionCost = 0.1f;
+    settings.m_uiBackwardsExclusionRange = 10;
+
+    ezMotionMatchingDatabase db;
+    db.Build(frames, settings);
+
+    ezMotionMatchingDatabase::Query query;
+    query.m_uiCurrentAnimClip = 1;
+    query.m_uiCurrentKeyframe = 15;
+    query.m_vTargetVelocity.Set(1, 0, 0);
+
+    // exactly matches keyframes 5, 15 and 25 of both clips, the current frame wins
+    query.m_vLeftFootPosition.Set(0, 0.5f, 0);
+    query.m_vRightFootPosition.Set(0, -0.5f, 0);
+
+    ezUInt32 uiBest = db.FindBestFrame(query);
+    EZ_TEST_INT(db.GetAnimClip(uiBest), 1);
+    EZ_TEST_INT(db.GetKeyframe(uiBest), 15);
+    EZ_TEST_INT(db.FindBestFrameBruteForce(query), uiBest);
+
+    // matches keyframe 4, 14 and 24 of both clips, which are all better than the current frame, except for the excluded keyframe 14 of the current clip
+    query.m_vLeftFootPosition.Set(0, 0.4f, 0);
+    query.m_vRightFootPosition.Set(0, -0.4f, 0);
+
+    uiBest = db.FindBestFrame(query);
+    EZ_TEST_INT(db.GetKeyframe(uiBest) % 10, 4);
+    EZ_TEST_BOOL(db.GetAnimClip(uiBest) != 1 || db.GetKeyframe(uiBest) != 14);
+    EZ_TEST_FLOAT(db.ComputeCost(query, db.FindBestFrameBruteForce(query)), db.ComputeCost(query, uiBest), 0.0f);
+
+    for (ezUInt32 i = 0; i < db.GetNumFrames(); ++i)
+    {
+      if (db.GetAnimClip(i) == 1 && db.GetKeyframe(i) >= 6 && db.GetKeyframe(i) < 15)
+      {
+        EZ_TEST_BOOL(db.ComputeCost(query, i) == ezMath::MaxValue<float>());
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Frame counts that are not a multiple of four")
+  {
+    // e.g. 36 frames are split into leaves of 9 frames, the SIMD scan of the last leaf starts at frame 27 and reads up to frame 38
+    for (ezUInt32 uiNumFrames = 33; uiNumFrames <= 47; ++uiNumFrames)
+    {
+      ezDynamicArray<ezMotionMatchingDatabase::Frame> frames;
+      CreateFrames(frames, uiNumFrames, rng);
+
+      ezMotionMatchingDatabase db;
+      db.Build(frames);
+      EZ_TEST_INT(db.GetNumFrames(), uiNumFrames);
+
+      for (ezUInt32 q = 0; q < 20; ++q)
+      {
+        const ezMotionMatchingDatabase::Query query = CreateQuery(frames, rng);
+
+        const ezUInt32 uiTree = db.FindBestFrame(query);
+        const ezUInt32 uiBrute = db.FindBestFrameBruteForce(query);
+        EZ_TEST_FLOAT(db.ComputeCost(query, uiTree), db.ComputeCost(query, uiBrute), 0.0f);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Batched queries")
+  {
+    ezDynamicArray<ezMotionMatchingDatabase::Frame> frames;
+    CreateFrames(frames, 10000, rng);
+
+    ezMotionMatchingDatabase db;
+    db.Build(frames);
+
+    ezDynamicArray<const ezMotionMatchingDatabase*> databases;
+    ezDynamicArray<ezMotionMatchingDatabase::Query> queries;
+    ezDynamicArray<ezUInt32> results;
+
+    for (ezUInt32 q = 0; q < 256; ++q)
+    {
+      databases.PushBack(&db);
+      queries.PushBack(CreateQuery(frames, rng));
+    }
+
+    results.SetCountUninitialized(queries.GetCount());
+    ezMotionMatchingDatabase::FindBestFrames(databases, queries, results);
+
+    for (ezUInt32 q = 0; q < queries.GetCount(); ++q)
+    {
+      EZ_TEST_INT(results[q], db.FindBestFrame(queries[q]));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Benchmark")
+  {
+    const ezUInt32 frameCounts[] = {10000, 100000, 1000000};
+    const ezUInt32 uiNumQueries = 200;
+
+    for (ezUInt32 uiFrames : frameCounts)
+    {
+      ezDynamicArray<ezMotionMatchingDatabase::Frame> frames;
+      CreateFrames(frames, uiFrames, rng);
+
+      ezMotionMatchingDatabase db;
+
+      ezStopwatch sw;
+      db.Build(frames);
+      const ezTime tBuild = sw.Checkpoint();
+
+      ezDynamicArray<ezMotionMatchingDatabase::Query> queries;
+      for (ezUInt32 q = 0; q < uiNumQueries; ++q)
+      {
+        queries.PushBack(CreateQuery(frames, rng));
+      }
+
+      sw.Checkpoint();
+
+      ezUInt32 uiChecksum = 0;
+      for (const auto& query : queries)
+      {
+        uiChecksum += db.FindBestFrameBruteForce(query);
+      }
+      const ezTime tBrute = sw.Checkpoint();
+
+      for (const auto& query : queries)
+      {
+        uiChecksum -= db.FindBestFrame(query);
+      }
+      const ezTime tTree = sw.Checkpoint();
+
+      ezTestFramework::Output(ezTestOutput::Duration, "%u frames: build %.1fms, per query brute force %.1fus, tree %.1fus (%u)", uiFrames,
+        tBuild.GetMilliseconds(), tBrute.GetMicroseconds() / uiNumQueries, tTree.GetMicroseconds() / uiNumQueries, uiChecksum);
+    }
+  }
+}
@@ -0,0 +1,337 @@
+#include <GameEngineTestPCH.h>
+
+#include <Core/World/World.h>
+#include <Foundation/Reflection/ReflectionUtils.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <GameEngine/Animation/PropertyAnimComponent.h>
+
+struct ezPropertyAnimTestObject
+{
+  float m_fFloat = 0.0f;
+  double m_fDouble = 0.0;
+  bool m_bBool = false;
+  ezInt32 m_iInt = 0;
+  ezUInt8 m_uiByte = 0;
+  ezAngle m_Angle;
+  ezTime m_Time;
+  ezVec3 m_vVector = ezVec3::ZeroVector();
+
+  float GetAccessor() const { return m_fAccessor; }
+  void SetAccessor(float f) { m_fAccessor = f; }
+
+  float m_fAccessor = 0.0f;
+};
+
+EZ_DECLARE_REFLECTABLE_TYPE(EZ_NO_LINKAGE, ezPropertyAnimTestObject);
+
+// clang-format off
+EZ_BEGIN_STATIC_REFLECTED_TYPE(ezPropertyAnimTestObject, ezNoBase, 1, ezRTTIDefaultAllocator<ezPropertyAnimTestObject>)
+{
+  EZ_BEGIN_PROPERTIES
+  {
+    EZ_MEMBER_PROPERTY("Float", m_fFloat),
+    EZ_MEMBER_PROPERTY("Double", m_fDouble),
+    EZ_MEMBER_PROPERTY("Bool", m_bBool),
+    EZ_MEMBER_PROPERTY("Int", m_iInt),
+    EZ_MEMBER_PROPERTY("Byte", m_uiByte),
+    EZ_MEMBER_PROPERTY("Angle", m_Angle),
+    EZ_MEMBER_PROPERTY("Time", m_Time),
+    EZ_MEMBER_PROPERTY("Vector", m_vVector),
+    EZ_ACCESSOR_PROPERTY("Accessor", GetAccessor, SetAccessor),
+  }
+  EZ_END_PROPERTIES;
+}
+EZ_END_STATIC_REFLECTED_TYPE;
+// clang-format on
+
+typedef ezComponentManager<class ezPropertyAnimTestComponent, ezBlockStorageType::Compact> ezPropertyAnimTestComponentManager;
+
+class ezPropertyAnimTestComponent : public ezComponent
+{
+  EZ_DECLARE_COMPONENT_TYPE(ezPropertyAnimTestComponent, ezComponent, ezPropertyAnimTestComponentManager);
+
+public:
+  float GetReadOnly() const { return m_fReadOnly; }
+
+  float m_fFloat = 0.0f;
+  ezInt32 m_iInt = 0;
+  ezVec3 m_vVector = ezVec3::ZeroVector();
+  float m_fReadOnly = 0.0f;
+};
+
+// clang-format off
+EZ_BEGIN_COMPONENT_TYPE(ezPropertyAnimTestComponent, 1, ezComponentMode::Static)
+{
+  EZ_BEGIN_PROPERTIES
+  {
+    EZ_MEMBER_PROPERTY("Float", m_fFloat),
+    EZ_MEMBER_PROPERTY("Int", m_iInt),
+    EZ_MEMBER_PROPERTY("Vector", m_vVector),
+    EZ_ACCESSOR_PROPERTY_READ_ONLY("ReadOnly", GetReadOnly),
+  }
+  EZ_END_PROPERTIES;
+}
+EZ_END_COMPONENT_TYPE;
+// clang-format on
+
+/// \brief Gives the test access to the bindings that ezPropertyAnimComponent creates.
+class ezPropertyAnimSetterTest
+{
+public:
+  using ComponentFloatBinding = ezPropertyAnimComponent::ComponentFloatBinding;
+  using GameObjectBinding = ezPropertyAnimComponent::GameObjectBinding;
+
+  static ezArrayPtr<const ComponentFloatBinding> GetComponentFloatBindings(const ezPropertyAnimComponent* pComponent) { return pComponent->m_ComponentFloatBindings; }
+  static ezArrayPtr<const GameObjectBinding> GetGameObjectBindings(const ezPropertyAnimComponent* pComponent) { return pComponent->m_GoFloatBindings; }
+  static ezArrayPtr<const ezUInt32> GetUsedFloatAnims(const ezPropertyAnimComponent* pComponent) { return pComponent->m_UsedFloatAnims; }
+  static ezArrayPtr<const float> GetFloatAnimValues(const ezPropertyAnimComponent* pComponent) { return pComponent->m_FloatAnimValues; }
+};
+
+namespace PropertyAnimSetterTestDetail
+{
+  static void AddFloatAnimation(ezPropertyAnimResourceDescriptor& desc, const char* szObjects, const ezRTTI* pComponentRtti, const char* szProperty,
+    ezPropertyAnimTarget::Enum target, double fEndValue)
+  {
+    ezFloatPropertyAnimEntry& anim = desc.m_FloatAnimations.ExpandAndGetRef();
+    anim.m_sObjectSearchSequence = szObjects;
+    anim.m_pComponentRtti = pComponentRtti;
+    anim.m_sComponentType = pComponentRtti != nullptr ? pComponentRtti->GetTypeName() : "";
+    anim.m_sPropertyPath = szProperty;
+    anim.m_Target = target;
+
+    // a NaN end value leaves the curve empty
+    if (ezMath::IsNaN(fEndValue))
+      return;
+
+    anim.m_Curve.AddControlPoint(0.0).m_Position.y = 0.0;
+    anim.m_Curve.AddControlPoint(1.0).m_Position.y = fEndValue;
+
+    // same as ezPropertyAnimResourceDescriptor::Load()
+    anim.m_Curve.SortControlPoints();
+    anim.m_Curve.CreateLinearApproximation();
+    anim.m_Curve.CreateBakedTable();
+  }
+
+  /// All animations go from 0 at the start to the given value at the end, after one second.
+  static ezPropertyAnimResourceHandle CreatePropertyAnimation()
+  {
+    ezPropertyAnimResourceHandle hAnim = ezResourceManager::GetExistingResource<ezPropertyAnimResource>("PropertyAnimSetterTest");
+    if (hAnim.IsValid())
+      return hAnim;
+
+    const ezRTTI* pTestComponent = ezGetStaticRTTI<ezPropertyAnimTestComponent>();
+
+    ezPropertyAnimResourceDescriptor desc;
+    desc.m_AnimationDuration = ezTime::Seconds(1.0);
+
+    AddFloatAnimation(desc, "Target", pTestComponent, "Float", ezPropertyAnimTarget::Number, 10.0);                  // 0
+    AddFloatAnimation(desc, "Target", pTestComponent, "Int", ezPropertyAnimTarget::Number, 10.0);                    // 1
+    AddFloatAnimation(desc, "Target", pTestComponent, "Vector", ezPropertyAnimTarget::VectorX, 1.0);                 // 2
+    AddFloatAnimation(desc, "Target", pTestComponent, "Vector", ezPropertyAnimTarget::VectorZ, 3.0);                 // 3
+    AddFloatAnimation(desc, "Target", pTestComponent, "ReadOnly", ezPropertyAnimTarget::Number, 10.0);               // 4
+    AddFloatAnimation(desc, "Missing", pTestComponent, "Float", ezPropertyAnimTarget::Number, 10.0);                 // 5
+    AddFloatAnimation(desc, "Target", pTestComponent, "Float", ezPropertyAnimTarget::Number, ezMath::NaN<double>()); // 6
+    AddFloatAnimation(desc, "Target", nullptr, "LocalPosition", ezPropertyAnimTarget::VectorY, 5.0);                 // 7
+
+    return ezResourceManager::CreateResource<ezPropertyAnimResource>("PropertyAnimSetterTest", std::move(desc));
+  }
+
+  static ezAbstractMemberProperty* GetMember(const char* szName)
+  {
+    return static_cast<ezAbstractMemberProperty*>(ezGetStaticRTTI<ezPropertyAnimTestObject>()->FindPropertyByName(szName));
+  }
+
+  /// How ezPropertyAnimComponent used to apply number animations to generic property types.
+  static void SetThroughVariant(ezAbstractMemberProperty* pMember, void* pObject, double fValue)
+  {
+    const ezRTTI* pRtti = pMember->GetSpecificType();
+
+    ezVariant value = fValue;
+    if (pRtti->GetVariantType() != ezVariantType::Invalid && value.CanConvertTo(pRtti->GetVariantType()))
+    {
+      ezReflectionUtils::SetMemberPropertyValue(pMember, pObject, value);
+    }
+  }
+} // namespace PropertyAnimSetterTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Animation, PropertyAnimSetter)
+{
+  using namespace PropertyAnimSetterTestDetail;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindSetter")
+  {
+    const char* szNumberProperties[] = {"Float", "Double", "Int", "Byte", "Accessor"};
+
+    for (const char* szName : szNumberProperties)
+    {
+      ezAbstractMemberProperty* pMember = GetMember(szName);
+      ezPropertyAnimNumberSetter::SetterFunc setter = ezPropertyAnimNumberSetter::FindSetter(pMember->GetSpecificType());
+      EZ_TEST_BOOL(setter != nullptr);
+
+      // both paths have to produce the same value
+      for (double fValue : {0.0, 2.75, -1.5, 200.25})
+      {
+        // converting a negative value to an unsigned type is undefined behavior
+        if (fValue < 0.0 && pMember->GetSpecificType() == ezGetStaticRTTI<ezUInt8>())
+          continue;
+
+        ezPropertyAnimTestObject objVariant, objSetter;
+        SetThroughVariant(pMember, &objVariant, fValue);
+        setter(pMember, &objSetter, fValue);
+
+        EZ_TEST_BOOL(ezReflectionUtils::GetMemberPropertyValue(pMember, &objVariant) == ezReflectionUtils::GetMemberPropertyValue(pMember, &objSetter));
+      }
+    }
+
+    ezPropertyAnimTestObject obj;
+
+    EZ_TEST_BOOL(ezPropertyAnimNumberSetter::FindSetter(ezGetStaticRTTI<bool>()) != nullptr);
+
+    ezPropertyAnimNumberSetter::FindSetter(ezGetStaticRTTI<ezAngle>())(GetMember("Angle"), &obj, 90.0);
+    EZ_TEST_FLOAT(obj.m_Angle.GetDegree(), 90.0f, 0.0001f);
+
+    ezPropertyAnimNumberSetter::FindSetter(ezGetStaticRTTI<ezTime>())(GetMember("Time"), &obj, 1.5);
+    EZ_TEST_FLOAT(obj.m_Time.GetSeconds(), 1.5, 0.0);
+
+    // vectors are animated per component
+    EZ_TEST_BOOL(ezPropertyAnimNumberSetter::FindSetter(ezGetStaticRTTI<ezVec3>()) == nullptr);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Animate component properties")
+  {
+    ezWorldDesc worldDesc("PropertyAnimSetterTest");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    world.GetClock().SetFixedTimeStep(ezTime::Seconds(0.5));
+
+    ezGameObjectDesc rootDesc;
+    rootDesc.m_bDynamic = true;
+
+    ezGameObject* pRoot = nullptr;
+    world.CreateObject(rootDesc, pRoot);
+
+    ezPropertyAnimComponent* pAnimComponent = nullptr;
+    ezPropertyAnimComponent::CreateComponent(pRoot, pAnimComponent);
+    pAnimComponent->SetPropertyAnim(CreatePropertyAnimation());
+
+    ezPropertyAnimTestComponent* pTargets[2] = {};
+    for (ezPropertyAnimTestComponent*& pTarget : pTargets)
+    {
+      ezGameObjectDesc desc;
+      desc.m_bDynamic = true;
+      desc.m_hParent = pRoot->GetHandle();
+      desc.m_sName.Assign("Target");
+
+      ezGameObject* pObject = nullptr;
+      world.CreateObject(desc, pObject);
+
+      ezPropertyAnimTestComponent::CreateComponent(pObject, pTarget);
+      pTarget->m_vVector.y = 7.0f;
+      pTarget->m_fReadOnly = 1.0f;
+    }
+
+    world.Update();
+
+    // Float, Int and the two animated components of Vector end up in three bindings per target
+    auto componentBindings = ezPropertyAnimSetterTest::GetComponentFloatBindings(pAnimComponent);
+    if (EZ_TEST_INT(componentBindings.GetCount(), 6).Succeeded())
+    {
+      ezUInt32 uiNumVectorBindings = 0;
+
+      for (const auto& binding : componentBindings)
+      {
+        if (ezStringUtils::IsEqual(binding.m_pMemberProperty->GetPropertyName(), "Vector"))
+        {
+          ++uiNumVectorBindings;
+          EZ_TEST_BOOL(binding.m_NumberSetter == nullptr);
+          EZ_TEST_INT(binding.m_uiAnimation[0], 2);
+          EZ_TEST_INT(binding.m_uiAnimation[1], ezInvalidIndex);
+          EZ_TEST_INT(binding.m_uiAnimation[2], 3);
+          EZ_TEST_INT(binding.m_uiAnimation[3], ezInvalidIndex);
+        }
+        else
+        {
+          // the empty curve of animation 6 does not replace animation 0
+          EZ_TEST_BOOL(binding.m_NumberSetter != nullptr);
+          EZ_TEST_BOOL(binding.m_uiAnimation[0] <= 1);
+        }
+      }
+
+      EZ_TEST_INT(uiNumVectorBindings, 2);
+    }
+
+    EZ_TEST_INT(ezPropertyAnimSetterTest::GetGameObjectBindings(pAnimComponent).GetCount(), 2);
+
+    // the read-only property, the missing target and the empty curve are never evaluated
+    auto usedAnims = ezPropertyAnimSetterTest::GetUsedFloatAnims(pAnimComponent);
+    if (EZ_TEST_INT(usedAnims.GetCount(), 5).Succeeded())
+    {
+      EZ_TEST_INT(usedAnims[0], 0);
+      EZ_TEST_INT(usedAnims[1], 1);
+      EZ_TEST_INT(usedAnims[2], 2);
+      EZ_TEST_INT(usedAnims[3], 3);
+      EZ_TEST_INT(usedAnims[4], 7);
+    }
+
+    EZ_TEST_FLOAT(ezPropertyAnimSetterTest::GetFloatAnimValues(pAnimComponent)[0], 5.0f, 0.01f);
+    EZ_TEST_FLOAT(ezPropertyAnimSetterTest::GetFloatAnimValues(pAnimComponent)[5], 0.0f, 0.0f);
+
+    for (ezPropertyAnimTestComponent* pTarget : pTargets)
+    {
+      EZ_TEST_FLOAT(pTarget->m_fFloat, 5.0f, 0.01f);
+      EZ_TEST_INT(pTarget->m_iInt, 5);
+      EZ_TEST_VEC3(pTarget->m_vVector, ezVec3(0.5f, 7.0f, 1.5f), 0.01f);
+      EZ_TEST_FLOAT(pTarget->m_fReadOnly, 1.0f, 0.0f);
+      EZ_TEST_FLOAT(pTarget->GetOwner()->GetLocalPosition().y, 2.5f, 0.01f);
+    }
+
+    // bindings to deleted components are removed
+    ezPropertyAnimTestComponent::DeleteComponent(pTargets[1]);
+    world.Update();
+
+    EZ_TEST_INT(ezPropertyAnimSetterTest::GetComponentFloatBindings(pAnimComponent).GetCount(), 3);
+    EZ_TEST_FLOAT(pTargets[0]->m_fFloat, 10.0f, 0.01f);
+    EZ_TEST_VEC3(pTargets[0]->m_vVector, ezVec3(1.0f, 7.0f, 3.0f), 0.01f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Benchmark")
+  {
+    const ezUInt32 uiNumProperties = 10000;
+    const ezUInt32 uiNumFrames = 100;
+
+    ezDynamicArray<ezPropertyAnimTestObject> objects;
+    objects.SetCount(uiNumProperties);
+
+    ezAbstractMemberProperty* pMembers[] = {GetMember("Float"), GetMember("Int")};
+
+    for (ezAbstractMemberProperty* pMember : pMembers)
+    {
+      ezPropertyAnimNumberSetter::SetterFunc setter = ezPropertyAnimNumberSetter::FindSetter(pMember->GetSpecificType());
+
+      ezStopwatch sw;
+      for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+      {
+        for (ezUInt32 i = 0; i < uiNumProperties; ++i)
+        {
+          SetThroughVariant(pMember, &objects[i], uiFrame + i * 0.001);
+        }
+      }
+      const ezTime tVariant = sw.Checkpoint();
+
+      for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+      {
+        for (ezUInt32 i = 0; i < uiNumProperties; ++i)
+        {
+          setter(pMember, &objects[i], uiFrame + i * 0.001);
+        }
+      }
+      const ezTime tSetter = sw.Checkpoint();
+
+      EZ_TEST_FLOAT(objects[uiNumProperties - 1].m_fFloat, uiNumFrames - 1 + (uiNumProperties - 1) * 0.001f, 0.001f);
+
+      ezTestFramework::Output(ezTestOutput::Duration, "%u animated '%s' properties: %.3f ms per frame with ezVariant, %.3f ms with typed setters",
+        uiNumProperties, pMember->GetPropertyName(), tVariant.GetMilliseconds() / uiNumFrames, tSetter.GetMilliseconds() / uiNumFrames);
+    }
+  }
+}
@@ -0,0 +1,365 @@
+#include <GameEngineTestPCH.h>
+
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Utilities/DataStructures/DynamicOctree.h>
+#include <Utilities/DataStructures/LooseOctree.h>
+
+namespace LooseOctreeTestDetail
+{
+  static ezBoundingBox GetRandomBox(ezRandom& rng, float fWorldSize, float fMaxHalfExtent)
+  {
+    ezBoundingBox box;
+    box.SetCenterAndHalfExtents(
+      ezVec3(rng.FloatMinMax(-fWorldSize, fWorldSize), rng.FloatMinMax(-fWorldSize, fWorldSize), rng.FloatMinMax(-fWorldSize, fWorldSize)),
+      ezVec3(rng.FloatMinMax(0.0f, fMaxHalfExtent), rng.FloatMinMax(0.0f, fMaxHalfExtent), rng.FloatMinMax(0.0f, fMaxHalfExtent)));
+    return box;
+  }
+
+  static bool OverlapsSphere(const ezBoundingBox& box, const ezVec3& vCenter, float fRadius)
+  {
+    const ezVec3 vClosest = vCenter.CompMax(box.m_vMin).CompMin(box.m_vMax);
+    return (vClosest - vCenter).GetLengthSquared() <= fRadius * fRadius;
+  }
+
+  /// Compares the results of box and sphere queries with a brute force search.
+  static ezResult CompareQueries(ezRandom& rng, const ezLooseOctree& tree, const ezDynamicArray<ezBoundingBox>& bounds,
+    const ezDynamicArray<bool>& alive, float fWorldSize)
+  {
+    ezDynamicArray<ezUInt32> found;
+    ezDynamicArray<ezUInt32> expected;
+
+    for (ezUInt32 q = 0; q < 100; ++q)
+    {
+      const ezBoundingBox queryBox = GetRandomBox(rng, fWorldSize, fWorldSize * 0.3f);
+
+      found.Clear();
+      expected.Clear();
+      tree.FindObjectsInBox(queryBox, found);
+
+      for (ezUInt32 i = 0; i < bounds.GetCount(); ++i)
+      {
+        if (alive[i] && queryBox.Overlaps(bounds[i]))
+          expected.PushBack(i);
+      }
+
+      found.Sort();
+      if (found != expected)
+        return EZ_FAILURE;
+
+      const ezVec3 vCenter = queryBox.GetCenter();
+      const float fRadius = queryBox.GetHalfExtents().x;
+
+      found.Clear();
+      expected.Clear();
+      tree.FindObjectsInSphere(vCenter, fRadius, found);
+
+      for (ezUInt32 i = 0; i < bounds.GetCount(); ++i)
+      {
+        if (alive[i] && OverlapsSphere(bounds[i], vCenter, fRadius))
+          expected.PushBack(i);
+      }
+
+      found.Sort();
+      if (found != expected)
+        return EZ_FAILURE;
+    }
+
+    return EZ_SUCCESS;
+  }
+
+  static bool CountObject(void* pPassThrough, ezDynamicTreeObjectConst object)
+  {
+    ++*static_cast<ezUInt32*>(pPassThrough);
+    return true;
+  }
+} // namespace LooseOctreeTestDetail
+
+EZ_CREATE_SIMPLE_TEST(DataStructures, LooseOctree)
+{
+  using namespace LooseOctreeTestDetail;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "CreateTree / GetBoundingBox")
+  {
+    ezLooseOctree o;
+    o.CreateTree(ezVec3(100, 200, 300), ezVec3(300, 400, 500), 1.0f);
+
+    const ezBoundingBox& bb = o.GetBoundingBox();
+
+    EZ_TEST_VEC3(bb.GetCenter(), ezVec3(100, 200, 300), 0.01f);
+    EZ_TEST_VEC3(bb.GetHalfExtents(), ezVec3(500), 0.01f);
+    EZ_TEST_INT(o.GetMaxTreeDepth(), 10);
+    EZ_TEST_BOOL(o.IsEmpty());
+
+    o.CreateTree(ezVec3::ZeroVector(), ezVec3(64), 16.0f);
+    EZ_TEST_INT(o.GetMaxTreeDepth(), 3);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "InsertObject / RemoveObject / GetObjectBounds")
+  {
+    ezLooseOctree o;
+    o.CreateTree(ezVec3::ZeroVector(), ezVec3(100), 1.0f);
+
+    ezBoundingBox box0, box1, box2;
+    box0.SetCenterAndHalfExtents(ezVec3(10, 20, 30), ezVec3(1, 2, 3));
+    box1.SetCenterAndHalfExtents(ezVec3(-50, 0, 0), ezVec3(40, 1, 1));
+    // outside of the tree
+    box2.SetCenterAndHalfExtents(ezVec3(500, 0, 0), ezVec3(1));
+
+    const ezUInt32 uiObject0 = o.InsertObject(box0);
+    const ezUInt32 uiObject1 = o.InsertObject(box1);
+    const ezUInt32 uiObject2 = o.InsertObject(box2);
+
+    EZ_TEST_INT(o.GetCount(), 3);
+    EZ_TEST_BOOL(o.GetObjectBounds(uiObject0) == box0);
+    EZ_TEST_BOOL(o.GetObjectBounds(uiObject1) == box1);
+    EZ_TEST_BOOL(o.GetObjectBounds(uiObject2) == box2);
+
+    ezDynamicArray<ezUInt32> found;
+    o.FindObjectsInSphere(ezVec3(500, 0, 2), 1.5f, found);
+    EZ_TEST_INT(found.GetCount(), 1);
+    EZ_TEST_INT(found[0], uiObject2);
+
+    o.RemoveObject(uiObject1);
+    EZ_TEST_INT(o.GetCount(), 2);
+
+    found.Clear();
+    o.FindObjectsInBox(box1, found);
+    EZ_TEST_INT(found.GetCount(), 0);
+
+    // the index is reused
+    EZ_TEST_INT(o.InsertObject(box1), uiObject1);
+
+    found.Clear();
+    o.FindObjectsInBox(box1, found);
+    EZ_TEST_INT(found.GetCount(), 1);
+
+    o.RemoveAllObjects();
+    EZ_TEST_BOOL(o.IsEmpty());
+
+    found.Clear();
+    o.FindObjectsInBox(o.GetBoundingBox(), found);
+    EZ_TEST_INT(found.GetCount(), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Abort query")
+  {
+    ezLooseOctree o;
+    o.CreateTree(ezVec3::ZeroVector(), ezVec3(100), 1.0f);
+
+    ezBoundingBox box;
+    box.SetCenterAndHalfExtents(ezVec3::ZeroVector(), ezVec3(1));
+
+    for (ezUInt32 i = 0; i < 10; ++i)
+    {
+      o.InsertObject(box);
+    }
+
+    ezUInt32 uiCalls = 0;
+    o.FindObjectsInBox(box, [&](ezUInt32 uiObject) {
+      ++uiCalls;
+      return uiCalls < 3;
+    });
+
+    EZ_TEST_INT(uiCalls, 3);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Queries / MoveObjects")
+  {
+    const float fWorldSize = 100.0f;
+
+    ezRandom rng;
+    rng.Initialize(42);
+
+    ezLooseOctree o;
+    o.CreateTree(ezVec3::ZeroVector(), ezVec3(fWorldSize), 1.0f);
+
+    ezDynamicArray<ezBoundingBox> bounds;
+    ezDynamicArray<bool> alive;
+
+    for (ezUInt32 i = 0; i < 2000; ++i)
+    {
+      // a few objects are bigger than the tree or reach outside of it
+      bounds.PushBack(GetRandomBox(rng, fWorldSize * 1.1f, (i % 100 == 0) ? fWorldSize : 5.0f));
+      alive.PushBack(true);
+
+      EZ_TEST_INT(o.InsertObject(bounds[i]), i);
+    }
+
+    ezResult res = CompareQueries(rng, o, bounds, alive, fWorldSize);
+    EZ_TEST_BOOL(res.Succeeded());
+
+    for (ezUInt32 i = 0; i < bounds.GetCount(); i += 3)
+    {
+      o.RemoveObject(i);
+      alive[i] = false;
+    }
+
+    res = CompareQueries(rng, o, bounds, alive, fWorldSize);
+    EZ_TEST_BOOL(res.Succeeded());
+
+    ezDynamicArray<ezUInt32> moved;
+    ezDynamicArray<ezBoundingBox> newBounds;
+
+    for (ezUInt32 iteration = 0; iteration < 10; ++iteration)
+    {
+      moved.Clear();
+      newBounds.Clear();
+
+      for (ezUInt32 i = 0; i < bounds.GetCount(); ++i)
+      {
+        if (!alive[i])
+          continue;
+
+        // most objects move a little, some teleport
+        if (rng.UIntInRange(10) == 0)
+        {
+          bounds[i] = GetRandomBox(rng, fWorldSize * 1.1f, 5.0f);
+        }
+        else
+        {
+          bounds[i].Translate(ezVec3(rng.FloatMinMax(-1.0f, 1.0f), rng.FloatMinMax(-1.0f, 1.0f), rng.FloatMinMax(-1.0f, 1.0f)));
+        }
+
+        moved.PushBack(i);
+        newBounds.PushBack(bounds[i]);
+      }
+
+      if (iteration % 2 == 0)
+      {
+        o.MoveObjects(moved, newBounds);
+      }
+      else
+      {
+        for (ezUInt32 i = 0; i < moved.GetCount(); ++i)
+        {
+          o.MoveObject(moved[i], newBounds[i]);
+        }
+      }
+
+      res = CompareQueries(rng, o, bounds, alive, fWorldSize);
+      EZ_TEST_BOOL(res.Succeeded());
+    }
+
+    for (ezUInt32 i = 0; i < bounds.GetCount(); ++i)
+    {
+      if (alive[i])
+      {
+        EZ_TEST_BOOL(o.GetObjectBounds(i) == bounds[i]);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Benchmark")
+  {
+    // a gameplay scenario: many small objects spread over a large, rather flat level, proximity queries around them
+    const ezUInt32 uiNumObjects = 50000;
+    const ezUInt32 uiNumQueries = 10000;
+    const float fWorldSize = 500.0f;
+    const float fWorldHeight = 20.0f;
+    const float fQueryRadius = 10.0f;
+    // ezDynamicOctree cannot handle more nodes
+    const float fMinNodeSize = 10.0f;
+
+    ezRandom rng;
+    rng.Initialize(7);
+
+    ezDynamicArray<ezBoundingBox> bounds;
+    ezDynamicArray<ezBoundingBox> movedBounds;
+    ezDynamicArray<ezVec3> queryPositions;
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      ezBoundingBox& box = bounds.ExpandAndGetRef();
+      box.SetCenterAndHalfExtents(ezVec3(rng.FloatMinMax(-fWorldSize, fWorldSize), rng.FloatMinMax(-fWorldSize, fWorldSize),
+                                    rng.FloatMinMax(-fWorldHeight, fWorldHeight)),
+        ezVec3(rng.FloatMinMax(0.2f, 1.0f)));
+
+      // the typical distance covered in one frame
+      ezBoundingBox moved = box;
+      moved.Translate(ezVec3(rng.FloatMinMax(-0.2f, 0.2f), rng.FloatMinMax(-0.2f, 0.2f), 0.0f));
+      movedBounds.PushBack(moved);
+    }
+
+    for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+    {
+      queryPositions.PushBack(movedBounds[rng.UIntInRange(uiNumObjects)].GetCenter());
+    }
+
+    ezTime tInsert[2], tMove[2], tQuery[2];
+    ezUInt32 uiFound[2] = {0, 0};
+
+    {
+      ezDynamicOctree o;
+      o.CreateTree(ezVec3::ZeroVector(), ezVec3(fWorldSize), fMinNodeSize);
+
+      ezDynamicArray<ezDynamicTreeObject> objects;
+      objects.SetCount(uiNumObjects);
+
+      ezStopwatch sw;
+
+      for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+      {
+        o.InsertObject(bounds[i].GetCenter(), bounds[i].GetHalfExtents(), 0, i, &objects[i]);
+      }
+
+      tInsert[0] = sw.Checkpoint();
+
+      for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+      {
+        o.RemoveObject(objects[i]);
+        o.InsertObject(movedBounds[i].GetCenter(), movedBounds[i].GetHalfExtents(), 0, i, &objects[i]);
+      }
+
+      tMove[0] = sw.Checkpoint();
+
+      for (const ezVec3& vPos : queryPositions)
+      {
+        o.FindObjectsInRange(vPos, fQueryRadius, LooseOctreeTestDetail::CountObject, &uiFound[0]);
+      }
+
+      tQuery[0] = sw.Checkpoint();
+    }
+
+    {
+      ezLooseOctree o;
+      o.CreateTree(ezVec3::ZeroVector(), ezVec3(fWorldSize), fMinNodeSize);
+
+      ezDynamicArray<ezUInt32> objects;
+      objects.SetCount(uiNumObjects);
+
+      ezStopwatch sw;
+
+      for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+      {
+        objects[i] = o.InsertObject(bounds[i]);
+      }
+
+      tInsert[1] = sw.Checkpoint();
+
+      o.MoveObjects(objects, movedBounds);
+
+      tMove[1] = sw.Checkpoint();
+
+      for (const ezVec3& vPos : queryPositions)
+      {
+        o.FindObjectsInSphere(vPos, fQueryRadius, [&](ezUInt32 uiObject) {
+          ++uiFound[1];
+          return true;
+        });
+      }
+
+      tQuery[1] = sw.Checkpoint();
+    }
+
+    // ezDynamicOctree returns all objects in the overlapping nodes, ezLooseOctree only the ones that really overlap
+    EZ_TEST_BOOL(uiFound[1] <= uiFound[0]);
+
+    const char* szNames[2] = {"ezDynamicOctree", "ezLooseOctree"};
+    for (ezUInt32 i = 0; i < 2; ++i)
+    {
+      ezTestFramework::Output(ezTestOutput::Duration, "%s, %u objects: insert %.2fms, move %.2fms, %u queries %.2fms (%u results)", szNames[i],
+        uiNumObjects, tInsert[i].GetMilliseconds(), tMove[i].GetMilliseconds(), uiNumQueries, tQuery[i].GetMilliseconds(), uiFound[i]);
+    }
+  }
+}
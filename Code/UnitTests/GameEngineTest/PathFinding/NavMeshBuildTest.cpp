@@ -0,0 +1,435 @@
+#include <GameEngineTestPCH.h>
+
+#ifdef BUILDSYSTEM_ENABLE_RECAST_SUPPORT
+
+#  include <Core/World/World.h>
+#  include <Foundation/System/SystemInformation.h>
+#  include <Foundation/Threading/TaskSystem.h>
+#  include <Foundation/Time/Stopwatch.h>
+#  include <Foundation/Utilities/Progress.h>
+#  include <Recast/DetourNavMesh.h>
+#  include <Recast/DetourNavMeshQuery.h>
+#  include <RecastPlugin/NavMeshBuilder/NavMeshBuilder.h>
+#  include <RecastPlugin/Resources/RecastNavMeshResource.h>
+#  include <RecastPlugin/Utils/RcMath.h>
+#  include <RecastPlugin/WorldModule/PathQueryWorldModule.h>
+#  include <RecastPlugin/WorldModule/RecastWorldModule.h>
+
+namespace NavMeshBuildTestDetail
+{
+  static float GetTerrainHeight(float x, float y)
+  {
+    return 1.5f * ezMath::Sin(ezAngle::Radian(x * 0.1f)) * ezMath::Cos(ezAngle::Radian(y * 0.13f));
+  }
+
+  static void AddBox(ezWorldGeoExtractionUtil::Geometry& geo, float x, float y)
+  {
+    // always the same height, so that adding a box does not change the bounding box of the terrain
+    auto& box = geo.m_BoxShapes.ExpandAndGetRef();
+    box.m_vPosition.Set(x, y, 0.0f);
+    box.m_qRotation.SetIdentity();
+    box.m_vHalfExtents.Set(1.0f, 1.0f, 3.0f);
+  }
+
+  /// Rolling hills of the given size with a grid of boxes on top.
+  static void CreateTerrain(ezWorldGeoExtractionUtil::Geometry& geo, float fSize)
+  {
+    const ezUInt32 uiQuads = (ezUInt32)fSize;
+    const float fHalfSize = fSize * 0.5f;
+
+    for (ezUInt32 y = 0; y <= uiQuads; ++y)
+    {
+      for (ezUInt32 x = 0; x <= uiQuads; ++x)
+      {
+        const float fPosX = x - fHalfSize;
+        const float fPosY = y - fHalfSize;
+        geo.m_Vertices.ExpandAndGetRef().m_vPosition.Set(fPosX, fPosY, GetTerrainHeight(fPosX, fPosY));
+      }
+    }
+
+    for (ezUInt32 y = 0; y < uiQuads; ++y)
+    {
+      for (ezUInt32 x = 0; x < uiQuads; ++x)
+      {
+        const ezUInt32 i0 = y * (uiQuads + 1) + x;
+        const ezUInt32 i1 = i0 + 1;
+        const ezUInt32 i2 = i1 + uiQuads + 1;
+        const ezUInt32 i3 = i0 + uiQuads + 1;
+
+        auto& tri0 = geo.m_Triangles.ExpandAndGetRef();
+        tri0.m_uiVertexIndices[0] = i0;
+        tri0.m_uiVertexIndices[1] = i1;
+        tri0.m_uiVertexIndices[2] = i2;
+
+        auto& tri1 = geo.m_Triangles.ExpandAndGetRef();
+        tri1.m_uiVertexIndices[0] = i0;
+        tri1.m_uiVertexIndices[1] = i2;
+        tri1.m_uiVertexIndices[2] = i3;
+      }
+    }
+
+    for (float y = -fHalfSize + 6.0f; y < fHalfSize - 6.0f; y += 12.0f)
+    {
+      for (float x = -fHalfSize + 6.0f; x < fHalfSize - 6.0f; x += 12.0f)
+      {
+        AddBox(geo, x, y);
+      }
+    }
+  }
+
+  static bool IsTileEqual(const ezRecastNavMeshResourceDescriptor& a, const ezRecastNavMeshTile& tile)
+  {
+    const ezUInt32 uiTile = a.FindTile(tile.m_iTileX, tile.m_iTileY);
+    return uiTile != ezInvalidIndex && a.m_Tiles[uiTile].m_DetourTileData == tile.m_DetourTileData;
+  }
+
+  static ezUInt32 CountDifferentTiles(const ezRecastNavMeshResourceDescriptor& a, const ezRecastNavMeshResourceDescriptor& b)
+  {
+    ezUInt32 uiDifferent = 0;
+
+    for (const auto& tile : a.m_Tiles)
+    {
+      if (!IsTileEqual(b, tile))
+        ++uiDifferent;
+    }
+
+    for (const auto& tile : b.m_Tiles)
+    {
+      if (a.FindTile(tile.m_iTileX, tile.m_iTileY) == ezInvalidIndex)
+        ++uiDifferent;
+    }
+
+    return uiDifferent;
+  }
+
+  static bool FindPath(const dtNavMesh& navMesh, const ezVec3& vStart, const ezVec3& vEnd)
+  {
+    dtNavMeshQuery query;
+    query.init(&navMesh, 4096);
+
+    dtQueryFilter filter;
+    const ezVec3 vSize(1.0f, 5.0f, 1.0f);
+
+    dtPolyRef startPoly = 0;
+    dtPolyRef endPoly = 0;
+    ezRcPos rcStart, rcEnd;
+    query.findNearestPoly(ezRcPos(vStart), &vSize.x, &filter, &startPoly, rcStart);
+    query.findNearestPoly(ezRcPos(vEnd), &vSize.x, &filter, &endPoly, rcEnd);
+
+    if (startPoly == 0 || endPoly == 0)
+      return false;
+
+    dtPolyRef path[1024];
+    ezInt32 iPathLength = 0;
+    if (dtStatusFailed(query.findPath(startPoly, endPoly, rcStart, rcEnd, &filter, path, &iPathLength, EZ_ARRAY_SIZE(path))))
+      return false;
+
+    return iPathLength > 0 && path[iPathLength - 1] == endPoly;
+  }
+} // namespace NavMeshBuildTestDetail
+
+EZ_CREATE_SIMPLE_TEST(PathFinding, NavMeshBuild)
+{
+  using namespace NavMeshBuildTestDetail;
+
+  ezRecastConfig config;
+  config.m_fTileSize = 16.0f;
+
+  ezWorldGeoExtractionUtil::Geometry geo;
+  CreateTerrain(geo, 64.0f);
+
+  ezProgress progress;
+  ezRecastNavMeshBuilder builder;
+
+  ezRecastNavMeshResourceDescriptor navMeshDesc;
+  EZ_TEST_BOOL(builder.Build(config, geo, navMeshDesc, progress).Succeeded());
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Tiled build")
+  {
+    EZ_TEST_BOOL(navMeshDesc.m_uiNumTilesX >= 4);
+    EZ_TEST_BOOL(navMeshDesc.m_uiNumTilesY >= 4);
+    EZ_TEST_BOOL(navMeshDesc.m_Tiles.GetCount() >= 16);
+    EZ_TEST_BOOL(navMeshDesc.m_uiMaxTiles >= navMeshDesc.m_uiNumTilesX * navMeshDesc.m_uiNumTilesY);
+
+    dtNavMesh navMesh;
+    EZ_TEST_BOOL(navMeshDesc.InitializeNavMesh(navMesh).Succeeded());
+
+    // the path crosses many tile borders
+    EZ_TEST_BOOL(FindPath(navMesh, ezVec3(-29, -29, GetTerrainHeight(-29, -29)), ezVec3(29, 29, GetTerrainHeight(29, 29))));
+    EZ_TEST_BOOL(FindPath(navMesh, ezVec3(29, -29, GetTerrainHeight(29, -29)), ezVec3(-29, 29, GetTerrainHeight(-29, 29))));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Rebuild changed tiles")
+  {
+    ezWorldGeoExtractionUtil::Geometry changedGeo = geo;
+    AddBox(changedGeo, 9.0f, 3.0f);
+
+    ezBoundingBox changedArea;
+    changedArea.SetCenterAndHalfExtents(ezVec3(9.0f, 3.0f, 0.0f), ezVec3(1.0f, 1.0f, 3.0f));
+
+    ezRecastNavMeshResourceDescriptor fullBuild;
+    EZ_TEST_BOOL(builder.Build(config, changedGeo, fullBuild, progress).Succeeded());
+
+    // navMeshDesc was modified by the dtNavMesh, so build the unchanged navmesh again
+    ezRecastNavMeshResourceDescriptor originalBuild;
+    EZ_TEST_BOOL(builder.Build(config, geo, originalBuild, progress).Succeeded());
+
+    ezRecastNavMeshResourceDescriptor incrementalBuild;
+    EZ_TEST_BOOL(builder.Build(config, geo, incrementalBuild, progress).Succeeded());
+    EZ_TEST_INT(CountDifferentTiles(incrementalBuild, originalBuild), 0);
+
+    EZ_TEST_BOOL(builder.RebuildTiles(config, changedGeo, changedArea, incrementalBuild, progress).Succeeded());
+
+    // rebuilding the affected tiles gives exactly the same result as building everything
+    EZ_TEST_INT(CountDifferentTiles(incrementalBuild, fullBuild), 0);
+
+    // but only the tiles around the box have changed
+    const ezUInt32 uiChangedTiles = CountDifferentTiles(incrementalBuild, originalBuild);
+    EZ_TEST_BOOL(uiChangedTiles >= 1 && uiChangedTiles <= 4);
+
+    dtNavMesh navMesh;
+    EZ_TEST_BOOL(incrementalBuild.InitializeNavMesh(navMesh).Succeeded());
+    EZ_TEST_BOOL(FindPath(navMesh, ezVec3(-29, -29, GetTerrainHeight(-29, -29)), ezVec3(29, 29, GetTerrainHeight(29, 29))));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Rebuild above the previous geometry")
+  {
+    // a platform far above the terrain, outside of the vertical range of the previous build
+    ezWorldGeoExtractionUtil::Geometry changedGeo = geo;
+    auto& box = changedGeo.m_BoxShapes.ExpandAndGetRef();
+    box.m_vPosition.Set(-9.0f, -3.0f, 9.5f);
+    box.m_qRotation.SetIdentity();
+    box.m_vHalfExtents.Set(4.0f, 4.0f, 0.5f);
+
+    ezBoundingBox changedArea;
+    changedArea.SetCenterAndHalfExtents(box.m_vPosition, box.m_vHalfExtents);
+
+    ezRecastNavMeshResourceDescriptor incrementalBuild;
+    EZ_TEST_BOOL(builder.Build(config, geo, incrementalBuild, progress).Succeeded());
+    EZ_TEST_BOOL(incrementalBuild.m_Bounds.m_vMax.y < 5.0f);
+    EZ_TEST_BOOL(builder.RebuildTiles(config, changedGeo, changedArea, incrementalBuild, progress).Succeeded());
+
+    dtNavMesh navMesh;
+    EZ_TEST_BOOL(incrementalBuild.InitializeNavMesh(navMesh).Succeeded());
+
+    dtNavMeshQuery query;
+    query.init(&navMesh, 512);
+
+    dtQueryFilter filter;
+    const ezVec3 vSize(0.5f, 0.5f, 0.5f);
+    dtPolyRef poly = 0;
+    ezRcPos rcPos;
+    query.findNearestPoly(ezRcPos(ezVec3(-9.0f, -3.0f, 10.0f)), &vSize.x, &filter, &poly, rcPos);
+    EZ_TEST_BOOL(poly != 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Rebuild with a different config")
+  {
+    ezRecastConfig otherConfig = config;
+    otherConfig.m_fAgentRadius = 0.5f;
+
+    ezRecastNavMeshResourceDescriptor incrementalBuild;
+    EZ_TEST_BOOL(builder.Build(config, geo, incrementalBuild, progress).Succeeded());
+
+    ezBoundingBox changedArea;
+    changedArea.SetCenterAndHalfExtents(ezVec3(9.0f, 3.0f, 0.0f), ezVec3(1.0f, 1.0f, 3.0f));
+
+    // the tiles would not fit together anymore
+    EZ_TEST_BOOL(builder.RebuildTiles(otherConfig, geo, changedArea, incrementalBuild, progress).Failed());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Stream tiles")
+  {
+    const ezVec3 vStart(-29, -29, GetTerrainHeight(-29, -29));
+    const ezVec3 vEnd(29, 29, GetTerrainHeight(29, 29));
+
+    // start with an empty tile grid
+    ezRecastNavMeshResourceDescriptor streamedBuild;
+    EZ_TEST_BOOL(builder.Build(config, geo, streamedBuild, progress).Succeeded());
+
+    ezDynamicArray<ezRecastNavMeshTile> tiles = std::move(streamedBuild.m_Tiles);
+    streamedBuild.m_Tiles.Clear();
+
+    const ezUInt32 uiNumTilesX = streamedBuild.m_uiNumTilesX;
+    const ezUInt32 uiNumTilesY = streamedBuild.m_uiNumTilesY;
+
+    ezRecastNavMeshResourceHandle hNavMesh = ezResourceManager::CreateResource<ezRecastNavMeshResource>("NavMeshBuildTestStreaming", std::move(streamedBuild));
+    ezResourceLock<ezRecastNavMeshResource> pNavMesh(hNavMesh, ezResourceAcquireMode::BlockTillLoaded);
+    const dtNavMesh& navMesh = *pNavMesh->GetNavMesh();
+
+    EZ_TEST_BOOL(!FindPath(navMesh, vStart, vEnd));
+
+    for (ezRecastNavMeshTile& tile : tiles)
+    {
+      EZ_TEST_BOOL(pNavMesh->SetTile(std::move(tile)).Succeeded());
+    }
+
+    EZ_TEST_BOOL(FindPath(navMesh, vStart, vEnd));
+    EZ_TEST_BOOL(pNavMesh->GetNavMeshPolygons() != nullptr);
+
+    ezRecastNavMeshTile outsideTile;
+    outsideTile.m_iTileX = uiNumTilesX;
+    EZ_TEST_BOOL(pNavMesh->SetTile(std::move(outsideTile)).Failed());
+
+    // a column of missing tiles cuts the navmesh in two
+    for (ezUInt32 y = 0; y < uiNumTilesY; ++y)
+    {
+      pNavMesh->RemoveTile(1, y);
+      EZ_TEST_BOOL(navMesh.getTileAt(1, y, 0) == nullptr);
+    }
+
+    EZ_TEST_BOOL(!FindPath(navMesh, vStart, vEnd));
+
+    // swap in the tiles that change with an additional box
+    ezWorldGeoExtractionUtil::Geometry changedGeo = geo;
+    AddBox(changedGeo, 9.0f, 3.0f);
+
+    ezRecastNavMeshResourceDescriptor originalBuild;
+    EZ_TEST_BOOL(builder.Build(config, geo, originalBuild, progress).Succeeded());
+
+    ezRecastNavMeshResourceDescriptor changedBuild;
+    EZ_TEST_BOOL(builder.Build(config, changedGeo, changedBuild, progress).Succeeded());
+
+    ezUInt32 uiSwappedTiles = 0;
+    for (ezRecastNavMeshTile& tile : changedBuild.m_Tiles)
+    {
+      if (IsTileEqual(originalBuild, tile) && tile.m_iTileX != 1)
+        continue;
+
+      const ezInt32 iTileX = tile.m_iTileX;
+      const ezInt32 iTileY = tile.m_iTileY;
+      const ezUInt8* pTileData = tile.m_DetourTileData.GetData();
+
+      EZ_TEST_BOOL(pNavMesh->SetTile(std::move(tile)).Succeeded());
+      EZ_TEST_BOOL(navMesh.getTileAt(iTileX, iTileY, 0) != nullptr && navMesh.getTileAt(iTileX, iTileY, 0)->data == pTileData);
+      ++uiSwappedTiles;
+    }
+
+    EZ_TEST_BOOL(uiSwappedTiles > uiNumTilesY);
+    EZ_TEST_BOOL(FindPath(navMesh, vStart, vEnd));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Stream tiles in a running world")
+  {
+    const ezVec3 vStart(-29, -29, GetTerrainHeight(-29, -29));
+    const ezVec3 vEnd(29, 29, GetTerrainHeight(29, 29));
+
+    ezRecastNavMeshResourceDescriptor worldBuild;
+    EZ_TEST_BOOL(builder.Build(config, geo, worldBuild, progress).Succeeded());
+
+    ezRecastNavMeshResourceDescriptor tileSource;
+    EZ_TEST_BOOL(builder.Build(config, geo, tileSource, progress).Succeeded());
+
+    ezRecastNavMeshResourceHandle hNavMesh = ezResourceManager::CreateResource<ezRecastNavMeshResource>("NavMeshBuildTestWorldStreaming", std::move(worldBuild));
+
+    ezWorldDesc worldDesc("NavMeshStreaming");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezRecastWorldModule* pRecastModule = world.GetOrCreateModule<ezRecastWorldModule>();
+    ezRcPathQueryWorldModule* pPathQueryModule = world.GetOrCreateModule<ezRcPathQueryWorldModule>();
+    pRecastModule->SetNavMeshResource(hNavMesh);
+    world.Update();
+
+    EZ_TEST_BOOL(pRecastModule->GetDetourNavMesh() != nullptr && FindPath(*pRecastModule->GetDetourNavMesh(), vStart, vEnd));
+
+    // a path search that is in progress while the navmesh changes
+    ezRcPathQueryDesc request;
+    request.m_vStart = vStart;
+    request.m_vTarget = vEnd;
+    pPathQueryModule->RequestPath(request);
+
+    // the changes are only applied during the update
+    for (ezUInt32 y = 0; y < tileSource.m_uiNumTilesY; ++y)
+    {
+      pRecastModule->RemoveNavMeshTile(1, y);
+    }
+
+    EZ_TEST_BOOL(FindPath(*pRecastModule->GetDetourNavMesh(), vStart, vEnd));
+
+    world.Update();
+    EZ_TEST_BOOL(pRecastModule->GetDetourNavMesh() != nullptr && !FindPath(*pRecastModule->GetDetourNavMesh(), vStart, vEnd));
+
+    for (ezRecastNavMeshTile& tile : tileSource.m_Tiles)
+    {
+      if (tile.m_iTileX == 1)
+      {
+        pRecastModule->SetNavMeshTile(std::move(tile));
+      }
+    }
+
+    world.Update();
+    EZ_TEST_BOOL(pRecastModule->GetDetourNavMesh() != nullptr && FindPath(*pRecastModule->GetDetourNavMesh(), vStart, vEnd));
+    EZ_TEST_BOOL(pRecastModule->GetNavMeshPointsOfInterestGraph() != nullptr);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Too many tiles")
+  {
+    ezRecastConfig smallTiles;
+    smallTiles.m_fTileSize = 4.0f;
+
+    // a flat square that needs 150 x 150 tiles
+    ezWorldGeoExtractionUtil::Geometry plane;
+    const ezVec3 corners[4] = {ezVec3(-300, -300, 0), ezVec3(300, -300, 0), ezVec3(300, 300, 0), ezVec3(-300, 300, 0)};
+    for (const ezVec3& corner : corners)
+    {
+      plane.m_Vertices.ExpandAndGetRef().m_vPosition = corner;
+    }
+
+    const ezUInt32 indices[6] = {0, 1, 2, 0, 2, 3};
+    for (ezUInt32 t = 0; t < 2; ++t)
+    {
+      auto& tri = plane.m_Triangles.ExpandAndGetRef();
+      tri.m_uiVertexIndices[0] = indices[t * 3 + 0];
+      tri.m_uiVertexIndices[1] = indices[t * 3 + 1];
+      tri.m_uiVertexIndices[2] = indices[t * 3 + 2];
+    }
+
+    ezRecastNavMeshResourceDescriptor planeNavMesh;
+    EZ_TEST_BOOL(builder.Build(smallTiles, plane, planeNavMesh, progress).Failed());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Benchmark")
+  {
+    ezWorldGeoExtractionUtil::Geometry terrain;
+    CreateTerrain(terrain, 256.0f);
+
+    ezRecastConfig benchmarkConfig;
+
+    const ezUInt32 uiPrevShortTaskThreads = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks);
+    const ezUInt32 uiPrevLongTaskThreads = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::LongTasks);
+    const ezUInt32 uiMaxThreads = ezMath::Clamp(ezSystemInformation::Get().GetCPUCoreCount(), 1u, 64u);
+
+    ezUInt32 uiNumTiles = 0;
+    ezTime singleThreaded;
+
+    for (ezUInt32 uiThreads = 1; uiThreads <= uiMaxThreads; uiThreads *= 2)
+    {
+      ezTaskSystem::SetWorkerThreadCount((ezInt8)uiThreads, (ezInt8)uiPrevLongTaskThreads);
+
+      ezRecastNavMeshResourceDescriptor terrainNavMesh;
+
+      ezStopwatch sw;
+      EZ_TEST_BOOL(builder.Build(benchmarkConfig, terrain, terrainNavMesh, progress).Succeeded());
+      const ezTime duration = sw.GetRunningTotal();
+
+      if (uiThreads == 1)
+      {
+        singleThreaded = duration;
+        uiNumTiles = terrainNavMesh.m_Tiles.GetCount();
+      }
+      else
+      {
+        // the result must not depend on the number of threads
+        EZ_TEST_INT(terrainNavMesh.m_Tiles.GetCount(), uiNumTiles);
+      }
+
+      ezTestFramework::Output(ezTestOutput::Duration, "256m x 256m terrain, %u tiles, %u worker threads: %.1fms (speedup %.2f)", uiNumTiles, uiThreads,
+        duration.GetMilliseconds(), singleThreaded.GetSeconds() / duration.GetSeconds());
+    }
+
+    ezTaskSystem::SetWorkerThreadCount((ezInt8)uiPrevShortTaskThreads, (ezInt8)uiPrevLongTaskThreads);
+  }
+}
+
+#endif
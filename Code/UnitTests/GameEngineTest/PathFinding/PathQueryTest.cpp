@@ -0,0 +1,416 @@
+#include <GameEngineTestPCH.h>
+
+#ifdef BUILDSYSTEM_ENABLE_RECAST_SUPPORT
+
+#  include <Foundation/Math/Random.h>
+#  include <Foundation/Time/Stopwatch.h>
+#  include <Foundation/Utilities/Progress.h>
+#  include <Recast/DetourNavMesh.h>
+#  include <Recast/Recast.h>
+#  include <RecastPlugin/NavMeshBuilder/NavMeshBuilder.h>
+#  include <RecastPlugin/Resources/RecastNavMeshResource.h>
+#  include <RecastPlugin/Utils/RcMath.h>
+#  include <RecastPlugin/WorldModule/PathQueryScheduler.h>
+
+namespace PathQueryTestDetail
+{
+  static const float s_fHalfSize = 30.0f;
+
+  /// A flat square with rows of walls in between.
+  static void CreateGeometry(ezWorldGeoExtractionUtil::Geometry& geo)
+  {
+    const ezVec3 corners[4] = {
+      ezVec3(-s_fHalfSize, -s_fHalfSize, 0), ezVec3(s_fHalfSize, -s_fHalfSize, 0), ezVec3(s_fHalfSize, s_fHalfSize, 0), ezVec3(-s_fHalfSize, s_fHalfSize, 0)};
+
+    for (const ezVec3& corner : corners)
+    {
+      geo.m_Vertices.ExpandAndGetRef().m_vPosition = corner;
+    }
+
+    const ezUInt32 indices[6] = {0, 1, 2, 0, 2, 3};
+    for (ezUInt32 t = 0; t < 2; ++t)
+    {
+      auto& tri = geo.m_Triangles.ExpandAndGetRef();
+      tri.m_uiVertexIndices[0] = indices[t * 3 + 0];
+      tri.m_uiVertexIndices[1] = indices[t * 3 + 1];
+      tri.m_uiVertexIndices[2] = indices[t * 3 + 2];
+    }
+
+    for (ezInt32 x = -2; x <= 2; ++x)
+    {
+      for (ezInt32 y = -2; y <= 2; ++y)
+      {
+        auto& box = geo.m_BoxShapes.ExpandAndGetRef();
+        box.m_vPosition.Set(x * 10.0f + 5.0f, y * 10.0f + ((x & 1) ? 2.5f : -2.5f), 1.0f);
+        box.m_qRotation.SetIdentity();
+        box.m_vHalfExtents.Set(0.5f, 4.0f, 1.0f);
+      }
+    }
+  }
+
+  static ezVec3 GetRandomPosition(ezRandom& rng)
+  {
+    return ezVec3((float)rng.DoubleMinMax(-s_fHalfSize + 1.0, s_fHalfSize - 1.0), (float)rng.DoubleMinMax(-s_fHalfSize + 1.0, s_fHalfSize - 1.0), 0.0f);
+  }
+
+  static bool FindStartAndEndPoly(
+    dtNavMeshQuery& query, const dtQueryFilter& filter, const ezRcPathQueryDesc& desc, dtPolyRef& out_StartPoly, ezRcPos& out_rcStart, dtPolyRef& out_EndPoly, ezRcPathQueryStatus::Enum& out_Status)
+  {
+    const ezVec3 vSize(desc.m_fPlaneEpsilon, desc.m_fHeightEpsilon, desc.m_fPlaneEpsilon);
+
+    out_StartPoly = 0;
+    if (dtStatusFailed(query.findNearestPoly(ezRcPos(desc.m_vStart), &vSize.x, &filter, &out_StartPoly, out_rcStart)) || out_StartPoly == 0 ||
+        !ezMath::IsEqual(desc.m_vStart.x, out_rcStart.m_Pos[0], desc.m_fPlaneEpsilon) ||
+        !ezMath::IsEqual(desc.m_vStart.y, out_rcStart.m_Pos[2], desc.m_fPlaneEpsilon) ||
+        !ezMath::IsEqual(desc.m_vStart.z, out_rcStart.m_Pos[1], desc.m_fHeightEpsilon))
+    {
+      out_Status = ezRcPathQueryStatus::StartOutsideNavArea;
+      return false;
+    }
+
+    out_EndPoly = 0;
+    ezRcPos rcEnd;
+    if (dtStatusFailed(query.findNearestPoly(ezRcPos(desc.m_vTarget), &vSize.x, &filter, &out_EndPoly, rcEnd)) || out_EndPoly == 0 ||
+        !ezMath::IsEqual(desc.m_vTarget.x, rcEnd.m_Pos[0], desc.m_fPlaneEpsilon) ||
+        !ezMath::IsEqual(desc.m_vTarget.y, rcEnd.m_Pos[2], desc.m_fPlaneEpsilon) || !ezMath::IsEqual(desc.m_vTarget.z, rcEnd.m_Pos[1], desc.m_fHeightEpsilon))
+    {
+      out_Status = ezRcPathQueryStatus::TargetOutsideNavArea;
+      return false;
+    }
+
+    return true;
+  }
+
+  /// What ezRcAgentComponent used to do synchronously for every path request.
+  static ezRcPathQueryStatus::Enum FindPathSynchronous(
+    dtNavMeshQuery& query, const ezRcPathQueryDesc& desc, ezDynamicArray<dtPolyRef>& out_PathCorridor)
+  {
+    out_PathCorridor.Clear();
+
+    dtQueryFilter filter;
+    dtPolyRef startPoly, endPoly;
+    ezRcPos rcStart;
+    ezRcPathQueryStatus::Enum status;
+    if (!FindStartAndEndPoly(query, filter, desc, startPoly, rcStart, endPoly, status))
+      return status;
+
+    ezInt32 iPathCorridorLength = 0;
+    out_PathCorridor.SetCountUninitialized(256);
+    if (dtStatusFailed(query.findPath(startPoly, endPoly, rcStart, ezRcPos(desc.m_vTarget), &filter, out_PathCorridor.GetData(), &iPathCorridorLength,
+          (int)out_PathCorridor.GetCount())) ||
+        iPathCorridorLength <= 0)
+    {
+      out_PathCorridor.Clear();
+      return ezRcPathQueryStatus::NoPath;
+    }
+
+    out_PathCorridor.SetCountUninitialized(iPathCorridorLength);
+    return out_PathCorridor.PeekBack() == endPoly ? ezRcPathQueryStatus::Success : ezRcPathQueryStatus::PartialPath;
+  }
+
+  /// Runs the sliced search, that the scheduler uses, without interruption.
+  static ezRcPathQueryStatus::Enum FindPathSliced(dtNavMeshQuery& query, const ezRcPathQueryDesc& desc, ezDynamicArray<dtPolyRef>& out_PathCorridor)
+  {
+    out_PathCorridor.Clear();
+
+    dtQueryFilter filter;
+    dtPolyRef startPoly, endPoly;
+    ezRcPos rcStart;
+    ezRcPathQueryStatus::Enum status;
+    if (!FindStartAndEndPoly(query, filter, desc, startPoly, rcStart, endPoly, status))
+      return status;
+
+    ezInt32 iPathCorridorLength = 0;
+    out_PathCorridor.SetCountUninitialized(256);
+    if (dtStatusFailed(query.initSlicedFindPath(startPoly, endPoly, rcStart, ezRcPos(desc.m_vTarget), &filter)) ||
+        dtStatusFailed(query.updateSlicedFindPath(ezMath::MaxValue<int>(), nullptr)) ||
+        dtStatusFailed(query.finalizeSlicedFindPath(out_PathCorridor.GetData(), &iPathCorridorLength, (int)out_PathCorridor.GetCount())) ||
+        iPathCorridorLength <= 0)
+    {
+      out_PathCorridor.Clear();
+      return ezRcPathQueryStatus::NoPath;
+    }
+
+    out_PathCorridor.SetCountUninitialized(iPathCorridorLength);
+    return out_PathCorridor.PeekBack() == endPoly ? ezRcPathQueryStatus::Success : ezRcPathQueryStatus::PartialPath;
+  }
+
+  /// The length of the shortest path through the corridor.
+  static float GetStraightPathLength(dtNavMeshQuery& query, const ezVec3& vStart, const ezVec3& vTarget, const ezDynamicArray<dtPolyRef>& pathCorridor)
+  {
+    ezDynamicArray<ezVec3> straightPath;
+    straightPath.SetCountUninitialized(256);
+
+    ezInt32 iNumPoints = 0;
+    query.findStraightPath(ezRcPos(vStart), ezRcPos(vTarget), pathCorridor.GetData(), (int)pathCorridor.GetCount(), &straightPath[0].x, nullptr, nullptr,
+      &iNumPoints, (int)straightPath.GetCount());
+
+    float fLength = 0.0f;
+    for (ezInt32 i = 1; i < iNumPoints; ++i)
+    {
+      fLength += (straightPath[i] - straightPath[i - 1]).GetLength();
+    }
+
+    return fLength;
+  }
+
+  static double GetPercentile(ezDynamicArray<double>& values, double fPercentile)
+  {
+    values.Sort();
+    return values[ezMath::Min(values.GetCount() - 1, static_cast<ezUInt32>(values.GetCount() * fPercentile))];
+  }
+} // namespace PathQueryTestDetail
+
+EZ_CREATE_SIMPLE_TEST(PathFinding, PathQueryScheduler)
+{
+  using namespace PathQueryTestDetail;
+
+  ezRandom rng;
+  rng.Initialize(23);
+
+  ezRecastNavMeshResourceDescriptor navMeshDesc;
+
+  {
+    ezWorldGeoExtractionUtil::Geometry geo;
+    CreateGeometry(geo);
+
+    ezProgress progress;
+    ezRecastNavMeshBuilder builder;
+    EZ_TEST_BOOL(builder.Build(ezRecastConfig(), geo, navMeshDesc, progress).Succeeded());
+  }
+
+  dtNavMesh navMesh;
+  const ezResult navMeshResult = navMeshDesc.InitializeNavMesh(navMesh);
+  EZ_TEST_BOOL(navMeshResult.Succeeded());
+  if (navMeshResult.Failed())
+    return;
+
+  dtNavMeshQuery syncQuery;
+  syncQuery.init(&navMesh, 2048);
+
+  ezRcPathQueryScheduler scheduler;
+  scheduler.SetNavMesh(&navMesh, 4);
+
+  ezDynamicArray<ezRcPathQueryScheduler::Result> results;
+
+  auto UpdateUntilDone = [&]() {
+    while (!scheduler.GetActiveQueries().IsEmpty())
+    {
+      scheduler.Update(results);
+      scheduler.WaitForWorkers();
+    }
+
+    scheduler.Update(results);
+  };
+
+  ezDynamicArray<ezRcPathQueryDesc> requests;
+  ezHashTable<ezUInt32, ezUInt32> queryToRequest;
+
+  auto RequestRandomPaths = [&]() {
+    requests.Clear();
+    queryToRequest.Clear();
+
+    for (ezUInt32 i = 0; i < 200; ++i)
+    {
+      ezRcPathQueryDesc& desc = requests.ExpandAndGetRef();
+      desc.m_vStart = GetRandomPosition(rng);
+      desc.m_vTarget = GetRandomPosition(rng);
+      desc.m_fPlaneEpsilon = 0.5f;
+      desc.m_fPriority = (float)(i % 3);
+      desc.m_Timeout = ezTime::Seconds(60);
+
+      queryToRequest.Insert(scheduler.RequestPath(desc), i);
+    }
+
+    results.Clear();
+    UpdateUntilDone();
+
+    EZ_TEST_INT(results.GetCount(), requests.GetCount());
+  };
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Same results as synchronous queries")
+  {
+    // few iterations per update, so that most searches are sliced over multiple updates
+    scheduler.SetMaxIterationsPerUpdate(20);
+    RequestRandomPaths();
+
+    ezUInt32 uiNumPaths = 0;
+    ezDynamicArray<dtPolyRef> syncCorridor;
+    for (const auto& result : results)
+    {
+      ezUInt32 uiRequest = 0;
+      EZ_TEST_BOOL(queryToRequest.Remove(result.m_uiQueryId, &uiRequest));
+      const ezRcPathQueryDesc& desc = requests[uiRequest];
+
+      const ezRcPathQueryStatus::Enum syncStatus = FindPathSynchronous(syncQuery, desc, syncCorridor);
+      EZ_TEST_INT(result.m_Status, syncStatus);
+      EZ_TEST_INT(result.m_PathCorridor.GetCount() > 0, syncCorridor.GetCount() > 0);
+
+      if (!result.m_PathCorridor.IsEmpty() && !syncCorridor.IsEmpty())
+      {
+        EZ_TEST_INT(result.m_PathCorridor[0], syncCorridor[0]);
+        EZ_TEST_INT(result.m_PathCorridor.PeekBack(), syncCorridor.PeekBack());
+
+        // at tile borders findPath() keeps separate search nodes per side, the sliced search does not,
+        // so the corridors may take different polygons, but the paths have to be about equally long
+        const float fSyncLength = GetStraightPathLength(syncQuery, result.m_vStartOnNavMesh, desc.m_vTarget, syncCorridor);
+        const float fLength = GetStraightPathLength(syncQuery, result.m_vStartOnNavMesh, desc.m_vTarget, result.m_PathCorridor);
+        EZ_TEST_FLOAT(fLength, fSyncLength, 0.15f * fSyncLength);
+      }
+
+      if (result.m_Status == ezRcPathQueryStatus::Success)
+        ++uiNumPaths;
+    }
+
+    EZ_TEST_BOOL(uiNumPaths > requests.GetCount() / 2);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Sliced search")
+  {
+    // a single iteration per update, searches are interrupted as often as possible
+    scheduler.SetMaxIterationsPerUpdate(1);
+    RequestRandomPaths();
+
+    ezDynamicArray<dtPolyRef> slicedCorridor;
+    for (const auto& result : results)
+    {
+      ezUInt32 uiRequest = 0;
+      EZ_TEST_BOOL(queryToRequest.Remove(result.m_uiQueryId, &uiRequest));
+
+      // interrupting the search must not change its result
+      const ezRcPathQueryStatus::Enum slicedStatus = FindPathSliced(syncQuery, requests[uiRequest], slicedCorridor);
+      EZ_TEST_INT(result.m_Status, slicedStatus);
+      EZ_TEST_BOOL(result.m_PathCorridor == slicedCorridor);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Cancel and deadline")
+  {
+    scheduler.SetMaxIterationsPerUpdate(1000);
+
+    ezRcPathQueryDesc desc;
+    desc.m_vStart.Set(-25, -25, 0);
+    desc.m_vTarget.Set(25, 25, 0);
+
+    const ezUInt32 uiCancelled = scheduler.RequestPath(desc);
+    const ezUInt32 uiKept = scheduler.RequestPath(desc);
+    scheduler.CancelPath(uiCancelled);
+    EZ_TEST_BOOL(!scheduler.IsPathQueryActive(uiCancelled));
+
+    desc.m_Timeout = ezTime::Seconds(-1);
+    const ezUInt32 uiTooLate = scheduler.RequestPath(desc);
+
+    results.Clear();
+    UpdateUntilDone();
+
+    EZ_TEST_INT(results.GetCount(), 2);
+    for (const auto& result : results)
+    {
+      EZ_TEST_BOOL(result.m_uiQueryId != uiCancelled);
+
+      if (result.m_uiQueryId == uiKept)
+        EZ_TEST_INT(result.m_Status, ezRcPathQueryStatus::Success);
+      else
+        EZ_TEST_INT(result.m_Status, ezRcPathQueryStatus::DeadlineExceeded);
+    }
+
+    EZ_TEST_BOOL(!scheduler.IsPathQueryActive(uiKept));
+    EZ_TEST_BOOL(!scheduler.IsPathQueryActive(uiTooLate));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Navmesh change")
+  {
+    dtNavMesh navMesh2;
+    EZ_TEST_BOOL(navMeshDesc.InitializeNavMesh(navMesh2).Succeeded());
+
+    ezRcPathQueryDesc desc;
+    desc.m_vStart.Set(-25, -25, 0);
+    desc.m_vTarget.Set(25, 25, 0);
+
+    const ezUInt32 uiQuery = scheduler.RequestPath(desc);
+
+    // the result is finished, but not delivered yet
+    results.Clear();
+    scheduler.Update(results);
+    scheduler.WaitForWorkers();
+    EZ_TEST_INT(results.GetCount(), 0);
+
+    // the result references the old navmesh, so it has to be computed again
+    scheduler.SetNavMesh(&navMesh2, 4);
+    scheduler.Update(results);
+    EZ_TEST_INT(results.GetCount(), 0);
+    EZ_TEST_BOOL(scheduler.IsPathQueryActive(uiQuery));
+
+    UpdateUntilDone();
+
+    if (EZ_TEST_INT(results.GetCount(), 1).Succeeded())
+    {
+      EZ_TEST_INT(results[0].m_uiQueryId, uiQuery);
+      EZ_TEST_INT(results[0].m_Status, ezRcPathQueryStatus::Success);
+    }
+
+    scheduler.SetNavMesh(&navMesh, 4);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Benchmark")
+  {
+    // 1000 agents that each compute a new path once per second, at 60 frames per second
+    const ezUInt32 uiNumAgents = 1000;
+    const ezUInt32 uiFramesPerSecond = 60;
+    const ezUInt32 uiNumFrames = uiFramesPerSecond * 5;
+
+    ezDynamicArray<ezRcPathQueryDesc> agents;
+    agents.SetCount(uiNumAgents);
+    for (ezRcPathQueryDesc& agent : agents)
+    {
+      agent.m_vStart = GetRandomPosition(rng);
+      agent.m_fPlaneEpsilon = 0.5f;
+    }
+
+    ezDynamicArray<double> syncFrameTimes;
+    ezDynamicArray<double> asyncFrameTimes;
+    ezDynamicArray<dtPolyRef> syncCorridor;
+    ezUInt32 uiNumResults = 0;
+
+    ezStopwatch sw;
+
+    for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+    {
+      for (ezUInt32 i = uiFrame % uiFramesPerSecond; i < uiNumAgents; i += uiFramesPerSecond)
+      {
+        agents[i].m_vTarget = GetRandomPosition(rng);
+      }
+
+      sw.Checkpoint();
+
+      for (ezUInt32 i = uiFrame % uiFramesPerSecond; i < uiNumAgents; i += uiFramesPerSecond)
+      {
+        FindPathSynchronous(syncQuery, agents[i], syncCorridor);
+      }
+
+      syncFrameTimes.PushBack(sw.Checkpoint().GetMilliseconds());
+
+      for (ezUInt32 i = uiFrame % uiFramesPerSecond; i < uiNumAgents; i += uiFramesPerSecond)
+      {
+        scheduler.RequestPath(agents[i]);
+      }
+
+      results.Clear();
+      scheduler.Update(results);
+      uiNumResults += results.GetCount();
+
+      asyncFrameTimes.PushBack(sw.Checkpoint().GetMilliseconds());
+    }
+
+    results.Clear();
+    UpdateUntilDone();
+    uiNumResults += results.GetCount();
+
+    EZ_TEST_INT(uiNumResults, uiNumFrames * uiNumAgents / uiFramesPerSecond);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%u agents re-pathing every second, main thread time per frame: synchronous p50 %.3fms p99 %.3fms, async p50 %.3fms p99 %.3fms",
+      uiNumAgents, GetPercentile(syncFrameTimes, 0.5), GetPercentile(syncFrameTimes, 0.99), GetPercentile(asyncFrameTimes, 0.5), GetPercentile(asyncFrameTimes, 0.99));
+  }
+}
+
+#endif
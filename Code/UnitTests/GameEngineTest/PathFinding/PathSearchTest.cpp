@@ -0,0 +1,289 @@
+#include <GameEngineTestPCH.h>
+
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Utilities/PathFinding/GraphSearch.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(PathFinding);
+
+namespace PathSearchTestDetail
+{
+  /// A square grid with blocked cells, connected to the four direct neighbors.
+  class GridStateGenerator : public ezPathStateGenerator<ezPathState>
+  {
+  public:
+    GridStateGenerator(ezUInt32 uiSize, ezRandom& rng)
+      : m_uiSize(uiSize)
+    {
+      m_Blocked.SetCount(uiSize * uiSize);
+
+      for (ezUInt32 i = 0; i < m_Blocked.GetCount(); ++i)
+      {
+        m_Blocked[i] = rng.UIntInRange(100) < 25;
+      }
+
+      // keep the top row and the right column free, so that opposite corners are always connected
+      for (ezUInt32 i = 0; i < uiSize; ++i)
+      {
+        m_Blocked[i] = false;
+        m_Blocked[i * uiSize + uiSize - 1] = false;
+      }
+    }
+
+    virtual void StartSearch(ezInt64 iStartNodeIndex, const ezPathState* pStartState, ezInt64 iTargetNodeIndex) override
+    {
+      m_iTargetX = iTargetNodeIndex % m_uiSize;
+      m_iTargetY = iTargetNodeIndex / m_uiSize;
+    }
+
+    virtual ezUInt32 GetNodeIndexRange() const override { return m_bDenseNodeIndices ? m_uiSize * m_uiSize : 0; }
+
+    virtual void GenerateAdjacentStates(ezInt64 iNodeIndex, const ezPathState& StartState, ezPathSearch<ezPathState>* pPathSearch) override
+    {
+      ezInt64 neighbors[4];
+      const ezUInt32 uiNumNeighbors = GetNeighbors(iNodeIndex, neighbors);
+
+      for (ezUInt32 i = 0; i < uiNumNeighbors; ++i)
+      {
+        pPathSearch->AddPathNode(neighbors[i], MakeState(StartState, neighbors[i]));
+      }
+    }
+
+    ezUInt32 GetNeighbors(ezInt64 iNodeIndex, ezInt64* out_pNeighbors) const
+    {
+      const ezInt64 x = iNodeIndex % m_uiSize;
+      const ezInt64 y = iNodeIndex / m_uiSize;
+      ezUInt32 uiCount = 0;
+
+      auto Add = [&](ezInt64 nx, ezInt64 ny) {
+        if (nx < 0 || ny < 0 || nx >= m_uiSize || ny >= m_uiSize)
+          return;
+
+        const ezInt64 iNeighbor = ny * m_uiSize + nx;
+        if (!m_Blocked[static_cast<ezUInt32>(iNeighbor)])
+          out_pNeighbors[uiCount++] = iNeighbor;
+      };
+
+      Add(x - 1, y);
+      Add(x + 1, y);
+      Add(x, y - 1);
+      Add(x, y + 1);
+      return uiCount;
+    }
+
+    ezPathState MakeState(const ezPathState& prev, ezInt64 iNodeIndex) const
+    {
+      const ezInt64 x = iNodeIndex % m_uiSize;
+      const ezInt64 y = iNodeIndex / m_uiSize;
+
+      ezPathState state;
+      state.m_fCostToNode = prev.m_fCostToNode + 1.0f;
+      state.m_fEstimatedCostToTarget = state.m_fCostToNode + (float)(ezMath::Abs(x - m_iTargetX) + ezMath::Abs(y - m_iTargetY));
+      return state;
+    }
+
+    ezUInt32 m_uiSize;
+    ezDynamicArray<bool> m_Blocked;
+    bool m_bDenseNodeIndices = false;
+    ezInt64 m_iTargetX = 0;
+    ezInt64 m_iTargetY = 0;
+  };
+
+  /// The search as ezPathSearch did it before it used a heap: a hash table for all states and a linear scan over all open nodes.
+  static float FindPathCostLinearScan(GridStateGenerator& generator, ezInt64 iStartNodeIndex, ezInt64 iTargetNodeIndex)
+  {
+    ezHashTable<ezInt64, ezPathState> pathStates;
+    ezDeque<ezInt64> stateQueue;
+
+    pathStates.Reserve(10000);
+
+    generator.StartSearch(iStartNodeIndex, nullptr, iTargetNodeIndex);
+    pathStates[iStartNodeIndex] = ezPathState();
+    stateQueue.PushBack(iStartNodeIndex);
+
+    while (!stateQueue.IsEmpty())
+    {
+      ezUInt32 uiBestInQueue = 0;
+      float fLowestEstimation = ezMath::Infinity<float>();
+
+      for (ezUInt32 i = 0; i < stateQueue.GetCount(); ++i)
+      {
+        const float fEstimation = pathStates[stateQueue[i]].m_fEstimatedCostToTarget;
+        if (fEstimation < fLowestEstimation)
+        {
+          fLowestEstimation = fEstimation;
+          uiBestInQueue = i;
+        }
+      }
+
+      const ezInt64 iCurNodeIndex = stateQueue[uiBestInQueue];
+      stateQueue.RemoveAtAndSwap(uiBestInQueue);
+
+      const ezPathState curState = pathStates[iCurNodeIndex];
+
+      if (iCurNodeIndex == iTargetNodeIndex)
+        return curState.m_fCostToNode;
+
+      ezInt64 neighbors[4];
+      const ezUInt32 uiNumNeighbors = generator.GetNeighbors(iCurNodeIndex, neighbors);
+
+      for (ezUInt32 i = 0; i < uiNumNeighbors; ++i)
+      {
+        const ezPathState newState = generator.MakeState(curState, neighbors[i]);
+
+        ezPathState* pExistingState;
+        if (pathStates.TryGetValue(neighbors[i], pExistingState))
+        {
+          if (pExistingState->m_fCostToNode > newState.m_fCostToNode)
+            *pExistingState = newState;
+        }
+        else
+        {
+          pathStates[neighbors[i]] = newState;
+          stateQueue.PushBack(neighbors[i]);
+        }
+      }
+    }
+
+    return -1.0f;
+  }
+
+  static float FindPathCost(ezPathSearch<ezPathState>& search, ezInt64 iStartNodeIndex, ezInt64 iTargetNodeIndex)
+  {
+    ezDeque<ezPathSearch<ezPathState>::PathResultData> path;
+    if (search.FindPath(iStartNodeIndex, ezPathState(), iTargetNodeIndex, path).Failed())
+      return -1.0f;
+
+    return path.PeekBack().m_pPathState->m_fCostToNode;
+  }
+} // namespace PathSearchTestDetail
+
+EZ_CREATE_SIMPLE_TEST(PathFinding, PathSearch)
+{
+  using namespace PathSearchTestDetail;
+
+  ezRandom rng;
+  rng.Initialize(17);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindPath")
+  {
+    GridStateGenerator generator(64, rng);
+
+    ezPathSearch<ezPathState> search;
+    search.SetPathStateGenerator(&generator);
+
+    ezDeque<ezPathSearch<ezPathState>::PathResultData> path;
+    EZ_TEST_BOOL(search.FindPath(5, ezPathState(), 5, path).Succeeded());
+    EZ_TEST_INT(path.GetCount(), 1);
+
+    generator.m_Blocked.SetCount(0);
+    generator.m_Blocked.SetCount(64 * 64, false);
+
+    // without obstacles the path is as long as the manhattan distance
+    EZ_TEST_BOOL(search.FindPath(0, ezPathState(), 64 * 10 + 20, path).Succeeded());
+    EZ_TEST_INT(path.GetCount(), 31);
+    EZ_TEST_INT(path.PeekFront().m_iNodeIndex, 0);
+    EZ_TEST_INT(path.PeekBack().m_iNodeIndex, 64 * 10 + 20);
+    EZ_TEST_FLOAT(path.PeekBack().m_pPathState->m_fCostToNode, 30.0f, 0.0f);
+
+    for (ezUInt32 i = 1; i < path.GetCount(); ++i)
+    {
+      EZ_TEST_INT(path[i].m_pPathState->m_iReachedThroughNode, path[i - 1].m_iNodeIndex);
+    }
+
+    // a wall with a single gap
+    for (ezUInt32 y = 0; y < 63; ++y)
+    {
+      generator.m_Blocked[y * 64 + 32] = true;
+    }
+
+    EZ_TEST_BOOL(search.FindPath(0, ezPathState(), 31 * 64 + 40, path).Succeeded());
+    EZ_TEST_FLOAT(path.PeekBack().m_pPathState->m_fCostToNode, 135.0f, 0.0f);
+
+    // closing the gap makes the target unreachable
+    generator.m_Blocked[63 * 64 + 32] = true;
+    EZ_TEST_BOOL(search.FindPath(0, ezPathState(), 31 * 64 + 40, path).Failed());
+
+    // the maximum cost stops the search early
+    EZ_TEST_BOOL(search.FindPath(0, ezPathState(), 10 * 64 + 20, path, 20.0f).Failed());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Heap vs. linear scan")
+  {
+    GridStateGenerator generator(128, rng);
+
+    ezPathSearch<ezPathState> search;
+    search.SetPathStateGenerator(&generator);
+
+    for (ezUInt32 q = 0; q < 50; ++q)
+    {
+      const ezInt64 iStart = rng.UIntInRange(128 * 128);
+      const ezInt64 iTarget = rng.UIntInRange(128 * 128);
+
+      if (generator.m_Blocked[static_cast<ezUInt32>(iStart)] || generator.m_Blocked[static_cast<ezUInt32>(iTarget)] || iStart == iTarget)
+        continue;
+
+      const float fReference = FindPathCostLinearScan(generator, iStart, iTarget);
+
+      // the same search object is used for all queries and for both lookup modes
+      generator.m_bDenseNodeIndices = (q % 2) == 0;
+      EZ_TEST_FLOAT(FindPathCost(search, iStart, iTarget), fReference, 0.0f);
+
+      generator.m_bDenseNodeIndices = !generator.m_bDenseNodeIndices;
+      EZ_TEST_FLOAT(FindPathCost(search, iStart, iTarget), fReference, 0.0f);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Benchmark")
+  {
+    const ezUInt32 gridSizes[] = {256, 1024, 4096};
+
+    for (ezUInt32 uiSize : gridSizes)
+    {
+      GridStateGenerator generator(uiSize, rng);
+
+      ezPathSearch<ezPathState> search;
+      search.SetPathStateGenerator(&generator);
+
+      const ezInt64 iStart = 0;
+      const ezInt64 iTarget = (ezInt64)uiSize * uiSize - 1;
+
+      ezStopwatch sw;
+
+      // the linear scan over all open nodes is far too slow for the large grid
+      ezTime tLinearScan;
+      float fReference = -2.0f;
+      if (uiSize <= 256)
+      {
+        fReference = FindPathCostLinearScan(generator, iStart, iTarget);
+        tLinearScan = sw.Checkpoint();
+      }
+
+      generator.m_bDenseNodeIndices = false;
+      sw.Checkpoint();
+      const float fSparse = FindPathCost(search, iStart, iTarget);
+      const ezTime tSparse = sw.Checkpoint();
+
+      // second query on the same search object, without any allocations
+      generator.m_bDenseNodeIndices = true;
+      FindPathCost(search, iStart, iTarget);
+      sw.Checkpoint();
+      const float fDense = FindPathCost(search, iStart, iTarget);
+      const ezTime tDense = sw.Checkpoint();
+
+      EZ_TEST_FLOAT(fSparse, fDense, 0.0f);
+
+      if (fReference != -2.0f)
+      {
+        EZ_TEST_FLOAT(fSparse, fReference, 0.0f);
+        ezTestFramework::Output(ezTestOutput::Duration, "%ux%u grid: linear scan %.1fms, heap %.1fms, heap with dense nodes %.1fms (cost %.0f)", uiSize,
+          uiSize, tLinearScan.GetMilliseconds(), tSparse.GetMilliseconds(), tDense.GetMilliseconds(), fDense);
+      }
+      else
+      {
+        ezTestFramework::Output(ezTestOutput::Duration, "%ux%u grid: linear scan skipped, heap %.1fms, heap with dense nodes %.1fms (cost %.0f)", uiSize, uiSize,
+          tSparse.GetMilliseconds(), tDense.GetMilliseconds(), fDense);
+      }
+    }
+  }
+}
@@ -0,0 +1,291 @@
+#include <GameEngineTestPCH.h>
+
+#include <Foundation/Math/Intersection.h>
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <GameEngine/Interfaces/PhysicsWorldModule.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Physics);
+
+namespace PhysicsBatchQueryTestDetail
+{
+  /// \brief Brute force CPU reference implementation of the physics queries over a triangle soup.
+  ///
+  /// Only raycasts and sphere overlaps are implemented, which is enough to validate the batch code paths without a physics engine.
+  class ezTriangleSoupPhysicsModule : public ezPhysicsWorldModuleInterface
+  {
+  public:
+    ezTriangleSoupPhysicsModule()
+      : ezPhysicsWorldModuleInterface(nullptr)
+    {
+    }
+
+    void AddTriangle(const ezVec3& v0, const ezVec3& v1, const ezVec3& v2)
+    {
+      m_Vertices.PushBack(v0);
+      m_Vertices.PushBack(v1);
+      m_Vertices.PushBack(v2);
+    }
+
+    virtual bool Raycast(ezPhysicsCastResult& out_Result, const ezVec3& vStart, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const override
+    {
+      ++m_uiNumQueries;
+
+      bool bHit = false;
+      float fClosest = fDistance;
+
+      for (ezUInt32 t = 0; t < m_Vertices.GetCount(); t += 3)
+      {
+        float fTime;
+        ezVec3 vHit;
+        if (!ezIntersectionUtils::RayPolygonIntersection(vStart, vDir, &m_Vertices[t], 3, &fTime, &vHit) || fTime > fClosest)
+          continue;
+
+        ezVec3 vNormal = (m_Vertices[t + 1] - m_Vertices[t]).CrossRH(m_Vertices[t + 2] - m_Vertices[t]);
+        vNormal.NormalizeIfNotZero(ezVec3::UnitZAxis()).IgnoreResult();
+        if (vNormal.Dot(vDir) > 0)
+          vNormal = -vNormal;
+
+        bHit = true;
+        fClosest = fTime;
+        out_Result.m_vPosition = vHit;
+        out_Result.m_vNormal = vNormal;
+        out_Result.m_fDistance = fTime;
+        out_Result.m_uiShapeId = t / 3;
+
+        if (collection == ezPhysicsHitCollection::Any)
+          break;
+      }
+
+      return bHit;
+    }
+
+    virtual bool RaycastAll(ezPhysicsCastResultArray& out_Results, const ezVec3& vStart, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params) const override { return false; }
+    virtual bool SweepTestSphere(ezPhysicsCastResult& out_Result, float fSphereRadius, const ezVec3& vStart, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const override { return false; }
+    virtual bool SweepTestBox(ezPhysicsCastResult& out_Result, ezVec3 vBoxExtends, const ezTransform& transform, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const override { return false; }
+    virtual bool SweepTestCapsule(ezPhysicsCastResult& out_Result, float fCapsuleRadius, float fCapsuleHeight, const ezTransform& transform, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const override { return false; }
+
+    virtual bool OverlapTestSphere(float fSphereRadius, const ezVec3& vPosition, const ezPhysicsQueryParameters& params) const override
+    {
+      ++m_uiNumQueries;
+
+      for (ezUInt32 t = 0; t < m_Vertices.GetCount(); t += 3)
+      {
+        const ezVec3 vClosest = ClosestPointOnTriangle(vPosition, m_Vertices[t], m_Vertices[t + 1], m_Vertices[t + 2]);
+        if ((vClosest - vPosition).GetLengthSquared() <= ezMath::Square(fSphereRadius))
+          return true;
+      }
+
+      return false;
+    }
+
+    virtual bool OverlapTestCapsule(float fCapsuleRadius, float fCapsuleHeight, const ezTransform& transform, const ezPhysicsQueryParameters& params) const override { return false; }
+    virtual void QueryShapesInSphere(ezPhysicsOverlapResultArray& out_Results, float fSphereRadius, const ezVec3& vPosition, const ezPhysicsQueryParameters& params) const override {}
+    virtual ezVec3 GetGravity() const override { return ezVec3(0, 0, -10); }
+    virtual void* CreateRagdoll(const ezSkeletonResourceDescriptor& skeleton, const ezTransform& transform, const ezAnimationPose& initPose) override { return nullptr; }
+
+    mutable ezUInt32 m_uiNumQueries = 0;
+
+  private:
+    static ezVec3 ClosestPointOnTriangle(const ezVec3& p, const ezVec3& a, const ezVec3& b, const ezVec3& c)
+    {
+      const ezVec3 ab = b - a;
+      const ezVec3 ac = c - a;
+      const ezVec3 ap = p - a;
+
+      const float d1 = ab.Dot(ap);
+      const float d2 = ac.Dot(ap);
+      if (d1 <= 0.0f && d2 <= 0.0f)
+        return a;
+
+      const ezVec3 bp = p - b;
+      const float d3 = ab.Dot(bp);
+      const float d4 = ac.Dot(bp);
+      if (d3 >= 0.0f && d4 <= d3)
+        return b;
+
+      const float vc = d1 * d4 - d3 * d2;
+      if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+        return a + ab * (d1 / (d1 - d3));
+
+      const ezVec3 cp = p - c;
+      const float d5 = ab.Dot(cp);
+      const float d6 = ac.Dot(cp);
+      if (d6 >= 0.0f && d5 <= d6)
+        return c;
+
+      const float vb = d5 * d2 - d1 * d6;
+      if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+        return a + ac * (d2 / (d2 - d6));
+
+      const float va = d3 * d6 - d5 * d4;
+      if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+      const float denom = 1.0f / (va + vb + vc);
+      return a + ab * (vb * denom) + ac * (vc * denom);
+    }
+
+    ezDynamicArray<ezVec3> m_Vertices;
+  };
+
+  static void CreateTerrain(ezTriangleSoupPhysicsModule& module, ezUInt32 uiCellsPerSide, float fCellSize)
+  {
+    auto GetHeight = [](float x, float y) { return ezMath::Sin(ezAngle::Radian(x * 0.3f)) * ezMath::Cos(ezAngle::Radian(y * 0.2f)) * 2.0f; };
+
+    for (ezUInt32 y = 0; y < uiCellsPerSide; ++y)
+    {
+      for (ezUInt32 x = 0; x < uiCellsPerSide; ++x)
+      {
+        const float x0 = x * fCellSize;
+        const float y0 = y * fCellSize;
+        const float x1 = x0 + fCellSize;
+        const float y1 = y0 + fCellSize;
+
+        const ezVec3 v00(x0, y0, GetHeight(x0, y0));
+        const ezVec3 v10(x1, y0, GetHeight(x1, y0));
+        const ezVec3 v01(x0, y1, GetHeight(x0, y1));
+        const ezVec3 v11(x1, y1, GetHeight(x1, y1));
+
+        module.AddTriangle(v00, v10, v11);
+        module.AddTriangle(v00, v11, v01);
+      }
+    }
+  }
+} // namespace PhysicsBatchQueryTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Physics, BatchQueries)
+{
+  using namespace PhysicsBatchQueryTestDetail;
+
+  const ezUInt32 uiCellsPerSide = 16;
+  const float fCellSize = 1.0f;
+  const float fSize = uiCellsPerSide * fCellSize;
+
+  ezTriangleSoupPhysicsModule module;
+  CreateTerrain(module, uiCellsPerSide, fCellSize);
+
+  ezRandom rng;
+  rng.Initialize(42);
+
+  const ezUInt32 uiNumQueries = 512;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "RaycastBatch")
+  {
+    ezDynamicArray<ezVec3> starts;
+    ezDynamicArray<ezVec3> dirs;
+    ezDynamicArray<float> distances;
+
+    for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+    {
+      // some rays start outside the terrain and must miss
+      starts.PushBack(ezVec3(rng.FloatMinMax(-2.0f, fSize + 2.0f), rng.FloatMinMax(-2.0f, fSize + 2.0f), 10.0f));
+
+      ezVec3 vDir(rng.FloatMinMax(-0.3f, 0.3f), rng.FloatMinMax(-0.3f, 0.3f), -1.0f);
+      vDir.Normalize();
+      dirs.PushBack(vDir);
+
+      // some rays are too short to reach the ground
+      distances.PushBack(rng.FloatMinMax(5.0f, 20.0f));
+    }
+
+    const ezPhysicsQueryParameters params(0);
+
+    ezPhysicsRaycastBatch batch;
+    batch.m_Starts = starts;
+    batch.m_Directions = dirs;
+    batch.m_Distances = distances;
+    batch.m_Params = ezMakeArrayPtr(&params, 1);
+
+    ezDynamicArray<ezPhysicsCastResult> results;
+    results.SetCount(uiNumQueries);
+    ezDynamicArray<bool> hits;
+    hits.SetCount(uiNumQueries);
+
+    module.m_uiNumQueries = 0;
+    ezStopwatch sw;
+    const ezUInt32 uiNumHits = module.RaycastBatch(results, hits, batch);
+    const ezTime tBatch = sw.Checkpoint();
+
+    EZ_TEST_INT(module.m_uiNumQueries, uiNumQueries);
+    EZ_TEST_BOOL(uiNumHits > 0);
+    EZ_TEST_BOOL(uiNumHits < uiNumQueries);
+
+    ezUInt32 uiNumScalarHits = 0;
+    for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+    {
+      ezPhysicsCastResult res;
+      const bool bHit = module.Raycast(res, starts[i], dirs[i], distances[i], params);
+      EZ_TEST_BOOL(bHit == hits[i]);
+
+      if (bHit)
+      {
+        ++uiNumScalarHits;
+        EZ_TEST_VEC3(res.m_vPosition, results[i].m_vPosition, 0.0001f);
+        EZ_TEST_VEC3(res.m_vNormal, results[i].m_vNormal, 0.0001f);
+        EZ_TEST_FLOAT(res.m_fDistance, results[i].m_fDistance, 0.0001f);
+        EZ_TEST_INT(res.m_uiShapeId, results[i].m_uiShapeId);
+        EZ_TEST_BOOL(results[i].m_vNormal.z > 0.0f);
+      }
+    }
+
+    EZ_TEST_INT(uiNumScalarHits, uiNumHits);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "RaycastBatch: %u rays against %u triangles: %.2fms", uiNumQueries, uiCellsPerSide * uiCellsPerSide * 2, tBatch.GetMilliseconds());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "RaycastBatch - shared distance")
+  {
+    const ezVec3 vStart(fSize * 0.5f, fSize * 0.5f, 10.0f);
+    const ezVec3 vDown(0, 0, -1);
+    const float fShort = 1.0f;
+    const float fLong = 100.0f;
+    const ezPhysicsQueryParameters params(0);
+
+    ezPhysicsRaycastBatch batch;
+    batch.m_Starts = ezMakeArrayPtr(&vStart, 1);
+    batch.m_Directions = ezMakeArrayPtr(&vDown, 1);
+    batch.m_Params = ezMakeArrayPtr(&params, 1);
+
+    ezPhysicsCastResult result;
+    bool bHit = true;
+
+    batch.m_Distances = ezMakeArrayPtr(&fShort, 1);
+    EZ_TEST_INT(module.RaycastBatch(ezMakeArrayPtr(&result, 1), ezMakeArrayPtr(&bHit, 1), batch), 0);
+    EZ_TEST_BOOL(!bHit);
+
+    batch.m_Distances = ezMakeArrayPtr(&fLong, 1);
+    EZ_TEST_INT(module.RaycastBatch(ezMakeArrayPtr(&result, 1), ezMakeArrayPtr(&bHit, 1), batch, ezPhysicsHitCollection::Any), 1);
+    EZ_TEST_BOOL(bHit);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "OverlapBatch")
+  {
+    ezDynamicArray<ezTransform> transforms;
+    for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+    {
+      transforms.ExpandAndGetRef().SetIdentity();
+      transforms.PeekBack().m_vPosition.Set(rng.FloatMinMax(0.0f, fSize), rng.FloatMinMax(0.0f, fSize), rng.FloatMinMax(-4.0f, 4.0f));
+    }
+
+    const ezPhysicsQueryParameters params(0);
+
+    ezPhysicsOverlapBatch batch;
+    batch.m_Shape.m_Type = ezPhysicsBatchShape::Type::Sphere;
+    batch.m_Shape.m_fRadius = 0.75f;
+    batch.m_Transforms = transforms;
+    batch.m_Params = ezMakeArrayPtr(&params, 1);
+
+    ezDynamicArray<bool> overlaps;
+    overlaps.SetCount(uiNumQueries);
+
+    const ezUInt32 uiNumOverlaps = module.OverlapBatch(overlaps, batch);
+    EZ_TEST_BOOL(uiNumOverlaps > 0);
+    EZ_TEST_BOOL(uiNumOverlaps < uiNumQueries);
+
+    for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+    {
+      EZ_TEST_BOOL(module.OverlapTestSphere(batch.m_Shape.m_fRadius, transforms[i].m_vPosition, params) == overlaps[i]);
+    }
+  }
+}
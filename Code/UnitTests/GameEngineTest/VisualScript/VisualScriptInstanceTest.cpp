@@ -0,0 +1,190 @@
+#include <GameEngineTestPCH.h>
+
+#include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <GameEngine/VisualScript/Nodes/VisualScriptMathNodes.h>
+#include <GameEngine/VisualScript/Nodes/VisualScriptMessageNodes.h>
+#include <GameEngine/VisualScript/Nodes/VisualScriptVariableNodes.h>
+#include <GameEngine/VisualScript/VisualScriptInstance.h>
+#include <GameEngine/VisualScript/VisualScriptResource.h>
+
+namespace VisualScriptInstanceTestDetail
+{
+  static void AddNode(ezVisualScriptResourceDescriptor& desc, const ezRTTI* pType)
+  {
+    auto& node = desc.m_Nodes.ExpandAndGetRef();
+    node.m_pType = pType;
+    node.m_sTypeName = pType->GetTypeName();
+    node.m_uiFirstProperty = static_cast<ezUInt16>(desc.m_Properties.GetCount());
+  }
+
+  static void AddProperty(ezVisualScriptResourceDescriptor& desc, const char* szName, const ezVariant& value)
+  {
+    auto& prop = desc.m_Properties.ExpandAndGetRef();
+    prop.m_sName = szName;
+    prop.m_Value = value;
+
+    desc.m_Nodes.PeekBack().m_uiNumProperties++;
+  }
+
+  static void AddDataConnection(ezVisualScriptResourceDescriptor& desc, ezUInt16 uiSourceNode, ezUInt16 uiTargetNode, ezUInt8 uiInputPin)
+  {
+    auto& con = desc.m_DataPaths.ExpandAndGetRef();
+    con.m_uiSourceNode = uiSourceNode;
+    con.m_uiTargetNode = uiTargetNode;
+    con.m_uiOutputPin = 0;
+    con.m_uiOutputPinType = ezVisualScriptDataPinType::Number;
+    con.m_uiInputPin = uiInputPin;
+    con.m_uiInputPinType = ezVisualScriptDataPinType::Number;
+  }
+
+  /// Every update stores 'Counter * 1 + One * 1' in 'Counter', where 'One' is computed from 'Counter * 0 + 1 * 1'.
+  /// The 'Counter' node is a dependency of two nodes, but has to be executed only once.
+  static ezVisualScriptResourceHandle CreateCounterScript()
+  {
+    ezVisualScriptResourceHandle hScript = ezResourceManager::GetExistingResource<ezVisualScriptResource>("VisualScriptInstanceTest");
+    if (hScript.IsValid())
+      return hScript;
+
+    ezVisualScriptResourceDescriptor desc;
+
+    AddNode(desc, ezGetStaticRTTI<ezVisualScriptNode_ScriptUpdateEvent>()); // 0
+
+    AddNode(desc, ezGetStaticRTTI<ezVisualScriptNode_Number>()); // 1
+    AddProperty(desc, "Name", "Counter");
+
+    AddNode(desc, ezGetStaticRTTI<ezVisualScriptNode_MultiplyAdd>()); // 2
+
+    AddNode(desc, ezGetStaticRTTI<ezVisualScriptNode_MultiplyAdd>()); // 3
+    AddProperty(desc, "a2", 0.0);
+    AddProperty(desc, "b1", 1.0);
+
+    AddNode(desc, ezGetStaticRTTI<ezVisualScriptNode_StoreNumber>()); // 4
+    AddProperty(desc, "Name", "Counter");
+
+    auto& exec = desc.m_ExecutionPaths.ExpandAndGetRef();
+    exec.m_uiSourceNode = 0;
+    exec.m_uiOutputPin = 0;
+    exec.m_uiTargetNode = 4;
+    exec.m_uiInputPin = 0;
+
+    AddDataConnection(desc, 1, 2, 0);
+    AddDataConnection(desc, 1, 3, 0);
+    AddDataConnection(desc, 3, 2, 2);
+    AddDataConnection(desc, 2, 4, 0);
+
+    auto& param = desc.m_NumberParameters.ExpandAndGetRef();
+    param.m_sName.Assign("Counter");
+    param.m_Value = 0.0;
+
+    return ezResourceManager::CreateResource<ezVisualScriptResource>("VisualScriptInstanceTest", std::move(desc));
+  }
+
+  static double GetCounter(ezVisualScriptInstance& instance)
+  {
+    double fValue = -1.0;
+    instance.GetLocalVariables().RetrieveDouble("Counter", fValue, -1.0);
+    return fValue;
+  }
+} // namespace VisualScriptInstanceTestDetail
+
+EZ_CREATE_SIMPLE_TEST(VisualScript, VisualScriptInstance)
+{
+  using namespace VisualScriptInstanceTestDetail;
+
+  ezVisualScriptResourceHandle hScript = CreateCounterScript();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ExecutionProgram")
+  {
+    ezResourceLock<ezVisualScriptResource> pScript(hScript, ezResourceAcquireMode::BlockTillLoaded);
+    const auto& program = pScript->GetDescriptor().m_ExecutionProgram;
+
+    EZ_TEST_INT(program.m_Nodes.GetCount(), 5);
+
+    // the update event executes the store node
+    const auto& update = program.m_Nodes[0];
+    EZ_TEST_INT(update.m_uiNumExecutionPins, 1);
+    EZ_TEST_INT(program.m_ExecutionTargets[update.m_uiFirstExecutionPin].m_uiTargetNode, 4);
+
+    // the counter value goes to both math nodes
+    const auto& counter = program.m_Nodes[1];
+    EZ_TEST_INT(counter.m_uiNumOutputPins, 1);
+    EZ_TEST_INT(program.m_OutputPins[counter.m_uiFirstOutputPin].m_uiNumTargets, 2);
+
+    // all data nodes are evaluated once, each after its own inputs
+    const auto& store = program.m_Nodes[4];
+    EZ_TEST_INT(store.m_uiNumDependencies, 3);
+    EZ_TEST_INT(program.m_Dependencies[store.m_uiFirstDependency + 0], 1);
+    EZ_TEST_INT(program.m_Dependencies[store.m_uiFirstDependency + 1], 3);
+    EZ_TEST_INT(program.m_Dependencies[store.m_uiFirstDependency + 2], 2);
+
+    // manually stepped nodes are never dependencies
+    EZ_TEST_INT(update.m_uiNumDependencies, 0);
+
+    EZ_TEST_BOOL(ezVisualScriptNode::HasExecutionPins(ezGetStaticRTTI<ezVisualScriptNode_ScriptUpdateEvent>()));
+    EZ_TEST_BOOL(ezVisualScriptNode::HasExecutionPins(ezGetStaticRTTI<ezVisualScriptNode_StoreNumber>()));
+    EZ_TEST_BOOL(!ezVisualScriptNode::HasExecutionPins(ezGetStaticRTTI<ezVisualScriptNode_Number>()));
+    EZ_TEST_BOOL(!ezVisualScriptNode::HasExecutionPins(ezGetStaticRTTI<ezVisualScriptNode_MultiplyAdd>()));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ExecuteScript")
+  {
+    ezVisualScriptInstance instance;
+    instance.Configure(hScript, nullptr);
+
+    EZ_TEST_FLOAT(GetCounter(instance), 0.0, 0.0);
+
+    ezVisualScriptInstanceActivity activity;
+    instance.ExecuteScript(&activity);
+
+    EZ_TEST_FLOAT(GetCounter(instance), 1.0, 0.0);
+    EZ_TEST_INT(activity.m_ActiveExecutionConnections.GetCount(), 1);
+    EZ_TEST_INT(activity.m_ActiveExecutionConnections[0], (0 << 16) | 0);
+    EZ_TEST_BOOL(activity.m_ActiveDataConnections.Contains((1 << 16) | 0));
+    EZ_TEST_BOOL(activity.m_ActiveDataConnections.Contains((2 << 16) | 0));
+
+    for (ezUInt32 i = 1; i < 10; ++i)
+    {
+      instance.ExecuteScript();
+    }
+
+    EZ_TEST_FLOAT(GetCounter(instance), 10.0, 0.0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Benchmark")
+  {
+    const ezUInt32 uiNumInstances = 1000;
+    const ezUInt32 uiNumUpdates = 100;
+
+    ezDeque<ezVisualScriptInstance> instances;
+    instances.SetCount(uiNumInstances);
+
+    ezStopwatch sw;
+    for (auto& instance : instances)
+    {
+      instance.Configure(hScript, nullptr);
+    }
+    const ezTime tConfigure = sw.Checkpoint();
+
+    for (ezUInt32 u = 0; u < uiNumUpdates; ++u)
+    {
+      for (auto& instance : instances)
+      {
+        instance.ExecuteScript();
+      }
+    }
+    const ezTime tExecute = sw.Checkpoint();
+
+    bool bAllCorrect = true;
+    for (auto& instance : instances)
+    {
+      bAllCorrect &= GetCounter(instance) == uiNumUpdates;
+    }
+    EZ_TEST_BOOL(bAllCorrect);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Configuring %u visual script instances: %.2f ms", uiNumInstances, tConfigure.GetMilliseconds());
+    ezTestFramework::Output(ezTestOutput::Duration, "ExecuteScript for %u instances: %.3f ms per update", uiNumInstances,
+      tExecute.GetMilliseconds() / uiNumUpdates);
+  }
+}
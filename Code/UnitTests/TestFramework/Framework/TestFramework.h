@@ -309,6 +309,7 @@ struct ezTestBlock
     Enabled,           ///< The test block is enabled.
     Disabled,          ///< The test block will be skipped. The test framework will print a warning message, that some block is deactivated.
     DisabledNoWarning, ///< The test block will be skipped, but no warning printed. Used to deactivate 'on demand/optional' tests.
+    EnableInRelease,   ///< The test block is skipped without a warning in debug builds. Used for tests that take too long there, e.g. performance measurements.
   };
 };
 
@@ -319,17 +320,18 @@ struct ezTestBlock
 /// First parameter allows to quickly disable a block depending on a condition (e.g. platform).
 /// Second parameter just gives it a name for better error reporting.
 /// Also skipped tests are highlighted in the output, such that people can quickly see when a test is currently deactivated.
-#define EZ_TEST_BLOCK(enable, name)                                                  \
-  ezTestFramework::s_szTestBlockName = name;                                         \
-  if (enable == ezTestBlock::Disabled)                                               \
-  {                                                                                  \
-    ezTestFramework::s_szTestBlockName = "";                                         \
-    ezTestFramework::Output(ezTestOutput::Warning, "Skipped Test Block '%s'", name); \
-  }                                                                                  \
-  else if (enable == ezTestBlock::DisabledNoWarning)                                 \
-  {                                                                                  \
-    ezTestFramework::s_szTestBlockName = "";                                         \
-  }                                                                                  \
+#define EZ_TEST_BLOCK(enable, name)                                                      \
+  ezTestFramework::s_szTestBlockName = name;                                             \
+  if (enable == ezTestBlock::Disabled)                                                   \
+  {                                                                                      \
+    ezTestFramework::s_szTestBlockName = "";                                             \
+    ezTestFramework::Output(ezTestOutput::Warning, "Skipped Test Block '%s'", name);     \
+  }                                                                                      \
+  else if (enable == ezTestBlock::DisabledNoWarning ||                                   \
+           (enable == ezTestBlock::EnableInRelease && EZ_ENABLED(EZ_COMPILE_FOR_DEBUG))) \
+  {                                                                                      \
+    ezTestFramework::s_szTestBlockName = "";                                             \
+  }                                                                                      \
   else
 
 